@@ -18,12 +18,17 @@
 // Includes
 //-------------------------------------------------------------------
 #include "Client.h"
+#include "JMVC/H264Extension/src/test/H264AVCDecoderLibTest/H264AVCDecoderLibTest.h"
+#include "JMVC/H264Extension/src/test/H264AVCDecoderLibTest/H264AVCDecoderTest.h"
 //-------------------------------------------------------------------
 
 
 Client::Client(QObject* parent) : QObject(parent) {
 	socket = new QTcpSocket(parent);
 	packetSize = 0;
+	bitstream = NULL;
+	decoder = NULL;
+	pendingBytes = 0;
 	window = new ClientWindow();
 	window->show();
 
@@ -40,6 +45,9 @@ Client::Client(QObject* parent) : QObject(parent) {
 Client::Client(ClientWindow* w, QObject* parent) : QObject(parent) {
 	socket = new QTcpSocket(parent);
 	packetSize = 0;
+	bitstream = NULL;
+	decoder = NULL;
+	pendingBytes = 0;
 	window = w;
 	window->show();
 	
@@ -55,12 +63,78 @@ Client::Client(ClientWindow* w, QObject* parent) : QObject(parent) {
 
 Client::~Client() {
 	socket->deleteLater();
+
+	if (decoder != NULL) {
+		// No more files follow, the decoder returns after
+		// the NAL units that are in the bitstream
+		bitstream->endStream();
+		decoder->Wait();
+		delete decoder;
+	}
+	if (bitstream != NULL) {
+		bitstream->destroy();
+	}
 }
 
 QTcpSocket* Client::getSocket() const {
 	return socket;
 }
 
+bool Client::startDecoding() {
+	if (decoder != NULL) {
+		return true;
+	}
+
+	// The ring holds a few seconds of the stream
+	if (ReadBitstreamStream::create(bitstream) != Err::m_nOK) {
+		bitstream = NULL;
+		return false;
+	}
+	if (bitstream->init(1 << 22) != Err::m_nOK) {
+		bitstream->destroy();
+		bitstream = NULL;
+		return false;
+	}
+
+	decoder = new sf::Thread(&Client::decode, this);
+	decoder->Launch();
+	return true;
+}
+
+void Client::decode(void* data) {
+	Client* client = (Client*) data;
+
+	// Parameters of the JMVC decoder: the bitstream name is not
+	// used, the YUV files are named after "recieved.yuv"
+	char name[] = "3DWebcam";
+	char stream[] = "stream";
+	char yuv[] = "recieved.yuv";
+	char views[] = "2";
+	char* argv[] = { name, stream, yuv, views };
+
+	DecoderParameter	parameter;
+	WriteYuvIf*			writeYuv = NULL;
+	H264AVCDecoderTest*	h264Decoder = NULL;
+
+	if (parameter.init(4, argv) == Err::m_nOK
+		&& WriteYuvToFile::createMVC(writeYuv, parameter.cYuvFile, parameter.uiNumOfViews) == Err::m_nOK
+		&& H264AVCDecoderTest::create(h264Decoder) == Err::m_nOK
+		&& h264Decoder->init(&parameter, (WriteYuvToFile*)writeYuv, client->bitstream) == Err::m_nOK) {
+		h264Decoder->go();
+	}
+
+	// If the decoder stopped before the end of the stream,
+	// the GUI thread stops appending the received files
+	client->bitstream->endStream();
+
+	if (h264Decoder != NULL) {
+		h264Decoder->destroy();
+	}
+	if (writeYuv != NULL) {
+		writeYuv->destroy();
+	}
+}
+
 void Client::dataRecieved() {
 	// Store the packet in the data stream "in"
 	QDataStream in(socket);
@@ -110,13 +184,26 @@ void Client::dataRecieved() {
 
 		window->display("File recieved");
 
-		// Save the file in "recieved_file"
-		QFile file("recieved_file");
-		file.open(QIODevice::WriteOnly);
+		QByteArray nalUnits = socket->readAll().right(fileSize);
+
+		if (startDecoding()) {
+			// Append the file to the bitstream, the decoder thread gets its
+			// NAL units without waiting for the next file. If files are
+			// pending, the ring is full and feedBitstream() is scheduled.
+			pendingFiles.append(nalUnits);
+			if (pendingFiles.size() == 1) {
+				feedBitstream();
+			}
+		}
+		else {
+			// Save the file in "recieved_file"
+			QFile file("recieved_file");
+			file.open(QIODevice::WriteOnly);
 
-		file.write(socket->readAll().right(fileSize));
-		
-		file.close();
+			file.write(nalUnits);
+			
+			file.close();
+		}
 	}
 	else {
 		window->display("Message recieved with wrong format...");
@@ -126,6 +213,33 @@ void Client::dataRecieved() {
 	packetSize = 0;
 }
 
+void Client::feedBitstream() {
+	while (!pendingFiles.isEmpty()) {
+		const QByteArray& file = pendingFiles.first();
+
+		// The GUI thread never waits for the decoder
+		UInt appended = 0;
+		if (bitstream->tryAppend((const UChar*)file.constData() + pendingBytes, file.size() - pendingBytes, appended) != Err::m_nOK) {
+			// The decoder has stopped, the files are dropped
+			pendingFiles.clear();
+			pendingBytes = 0;
+			return;
+		}
+		pendingBytes += appended;
+
+		if (pendingBytes < file.size()) {
+			// The ring is full, try again when the decoder has read from it
+			QTimer::singleShot(20, this, SLOT(feedBitstream()));
+			return;
+		}
+
+		// The file ends the NAL unit that is being received
+		bitstream->endAccessUnit();
+		pendingFiles.removeFirst();
+		pendingBytes = 0;
+	}
+}
+
 void Client::connection(QString serverId, int port) {
 	// Disable the previous connections if there are some
 	socket->abort();
@@ -19,6 +19,8 @@
 #include <QtNetwork>
 
 #include "ClientWindow.h"
+#include "ReadBitstreamStream.h"
+#include "SFML/Thread.hpp"
 //-------------------------------------------------------------------
 
 
@@ -49,6 +51,10 @@ class Client : public QObject {
 		// Slot called when a packet (or sub-packet) has been recieved
         void dataRecieved();
 
+		// Slot that appends the received files to the bitstream of the decoder,
+		// as far as its ring has room, and tries again later otherwise
+		void feedBitstream();
+
 		// Slot called when the user wants to connect to the server
 		void connection(QString serverId, int port);
 
@@ -72,6 +78,29 @@ class Client : public QObject {
 
 		// The graphic user interface associated with the client
 		ClientWindow* window;
+		// The bitstream the received files are appended to
+		ReadBitstreamStream* bitstream;
+		// The thread that decodes the bitstream while it is received
+		sf::Thread* decoder;
+		// The received files that are not completely in the bitstream yet,
+		// and the number of bytes of the first one that are
+		QList<QByteArray> pendingFiles;
+		int pendingBytes;
+
+	// Private functions
+	private:
+		// Start the decoder thread at the first received file,
+		// returns false if the files have to be saved instead
+		bool startDecoding();
+
+		/**
+		 *	Decoder thread
+		 *
+		 *	Decodes the received files while they arrive, the views
+		 *	are written in "recieved_<view id>.yuv". It returns when
+		 *	the bitstream is ended by the destructor.
+		 */
+		static void decode(void* data);
 };
 
 #endif // CLIENT_H
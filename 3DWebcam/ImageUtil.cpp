@@ -39,6 +39,39 @@ void ycrcb2bgr(IplImage* img) {
 	cvReleaseImage(&tmp);
 }
 
+bool bgr2yuv420(const IplImage* img, unsigned char* lum, unsigned char* cb, unsigned char* cr, int width, int height) {
+	// The planes are only large enough for a frame of the given size
+	if(img == NULL || img->width != width || img->height != height) {
+		return false;
+	}
+
+	IplImage* tmp = cvCreateImage(cvGetSize(img), IPL_DEPTH_8U, 3);
+	cvCvtColor(img, tmp, CV_BGR2YCrCb);
+
+	// Luma at full resolution
+	for(int y(0) ; y < height ; y++) {
+		const unsigned char* src = (const unsigned char*)(tmp->imageData + y*tmp->widthStep);
+		for(int x(0) ; x < width ; x++) {
+			lum[y*width + x] = src[3*x];
+		}
+	}
+
+	// Chroma averaged over 2x2 blocks
+	for(int y(0) ; y < height/2 ; y++) {
+		const unsigned char* src0 = (const unsigned char*)(tmp->imageData + (2*y  )*tmp->widthStep);
+		const unsigned char* src1 = (const unsigned char*)(tmp->imageData + (2*y+1)*tmp->widthStep);
+		for(int x(0) ; x < width/2 ; x++) {
+			int i = 6*x;
+			cr[y*(width/2) + x] = (src0[i+1] + src0[i+4] + src1[i+1] + src1[i+4] + 2) >> 2;
+			cb[y*(width/2) + x] = (src0[i+2] + src0[i+5] + src1[i+2] + src1[i+5] + 2) >> 2;
+		}
+	}
+
+	cvReleaseImage(&tmp);
+
+	return true;
+}
+
 void extractLayer(IplImage* img, int mode) {
 	CvSize imageSize = cvGetSize(img);
 	IplImage* tmp = cvCloneImage(img);
@@ -41,6 +41,9 @@ using namespace cv;
 void bgr2ycrcb(IplImage* img);
 // Convert from YCrCb to BGR
 void ycrcb2bgr(IplImage* img);
+// Convert from BGR to planar YUV 4:2:0 (I420),
+// false if the image is not of the size of the planes
+bool bgr2yuv420(const IplImage* img, unsigned char* lum, unsigned char* cb, unsigned char* cr, int width, int height);
 
 // Remove the distortions with the calibration datas
 void removeDist(IplImage* img, const CvMat* mx, const CvMat* my);
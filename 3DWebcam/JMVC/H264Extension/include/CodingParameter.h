@@ -7,6 +7,7 @@
 #endif // _MSC_VER > 1000
 
 #include "YUVFileParams.h"
+#include "H264AVCCommonLib/CpuInfo.h"
 using namespace std;
 
 
@@ -42,7 +43,7 @@ protected:
 class H264AVCENCODERLIB_API MotionVectorSearchParams
 {
 public:
-  MotionVectorSearchParams() :  m_eSearchMode(FAST_SEARCH),  m_eFullPelDFunc(DF_SAD), m_eSubPelDFunc(DF_SAD), m_uiSearchRange(64), m_uiDirectMode(0) {}
+  MotionVectorSearchParams() :  m_eSearchMode(FAST_SEARCH),  m_eFullPelDFunc(DF_SAD), m_eSubPelDFunc(DF_SAD), m_uiSearchRange(64), m_uiDirectMode(0), m_uiDisparitySearchRows(0), m_uiPyramidSearch(0), m_uiPyramidSearchRange(64) {}
 
   ErrVal check() const;
 
@@ -53,6 +54,9 @@ public:
   UInt        getNumMaxIter     ()                const { return m_uiNumMaxIter; }
   UInt        getIterSearchRange()                const { return m_uiIterSearchRange; }
   const UInt getDirectMode()                      const { return m_uiDirectMode; }
+  UInt        getDisparitySearchRows()            const { return m_uiDisparitySearchRows; }
+  UInt        getPyramidSearch()                  const { return m_uiPyramidSearch; }
+  UInt        getPyramidSearchRange()             const { return m_uiPyramidSearchRange; }
 
   Void setSearchMode( UInt uiSearchMode )               { m_eSearchMode = SearchMode(uiSearchMode); }
   Void setFullPelDFunc( UInt uiFullPelDFunc )           { m_eFullPelDFunc = DFunc(uiFullPelDFunc); }
@@ -61,6 +65,9 @@ public:
   Void setNumMaxIter        ( UInt uiNumMaxIter      )  { m_uiNumMaxIter      = uiNumMaxIter;       }
   Void setIterSearchRange   ( UInt uiIterSearchRange )  { m_uiIterSearchRange = uiIterSearchRange;  }
   Void setDirectMode( UInt uiDirectMode)                { m_uiDirectMode = uiDirectMode; }
+  Void setDisparitySearchRows( UInt uiRows )            { m_uiDisparitySearchRows = uiRows; }
+  Void setPyramidSearch( UInt uiPyramidSearch )         { m_uiPyramidSearch = uiPyramidSearch; }
+  Void setPyramidSearchRange( UInt uiSearchRange )      { m_uiPyramidSearchRange = uiSearchRange; }
 
 public:
   SearchMode  m_eSearchMode;
@@ -70,6 +77,9 @@ public:
   UInt        m_uiNumMaxIter;
   UInt        m_uiIterSearchRange;
   UInt        m_uiDirectMode;    // 0 temporal, 1 spatial
+  UInt        m_uiDisparitySearchRows; // 0: inter-view references are searched like temporal ones, N: +-N rows around the global disparity
+  UInt        m_uiPyramidSearch;       // 0: off, 1: coarse pre-pass seeds the motion search, 2: as 1 and print how often the seed won
+  UInt        m_uiPyramidSearchRange;  // range of the coarse pre-pass (full pel)
 };
 
 
@@ -563,6 +573,7 @@ public:
     , m_dMaximumDelay                     ( 1e6 )
     , m_uiTotalFrames                     ( 0 )
     , m_uiGOPSize                         ( 0 )
+    , m_uiLowDelay                        ( 0 )
     , m_uiDecompositionStages             ( 0 )
     , m_uiIntraPeriod                     ( 0 )
     , m_uiIntraPeriodLowPass              ( 0 )
@@ -625,6 +636,20 @@ public:
 		, m_uiDPBConformanceCheck (1)
         ,m_uiMbAff (0)
         ,m_uiPAff(0)
+        , m_uiSIMD                ( SIMD_ALL )
+        , m_uiSIMDSelfCheck       ( 0 )
+        , m_uiWavefrontThreads    ( 1 )
+        , m_uiSliceMode           ( 0 )
+        , m_uiSliceArgument       ( 50 )
+        , m_uiSliceThreads        ( 1 )
+        , m_uiRateControl         ( 0 )
+        , m_dBitrate              ( 0 )
+        , m_dMaxBitrate           ( 0 )
+        , m_dVBVBufferSize        ( 0 )
+        , m_uiBaseViewBitrateShare( 60 )
+        , m_uiRateControlSliceQp  ( 0 )
+        , m_uiFastModeDecision    ( 0 )
+        , m_uiPicBufferHugePages  ( 0 )
 
 //~JVT-W080
 	{
@@ -689,6 +714,7 @@ public:
   Double                          getMaximumDelay         ()              const   { return m_dMaximumDelay; }
   UInt                            getTotalFrames          ()              const   { return m_uiTotalFrames; }
   UInt                            getGOPSize              ()              const   { return m_uiGOPSize; }  
+  UInt                            getLowDelay             ()              const   { return m_uiLowDelay; }
   UInt                            getDecompositionStages  ()              const   { return m_uiDecompositionStages; }
   UInt                            getIntraPeriod          ()              const   { return m_uiIntraPeriod; }
   UInt                            getIntraPeriodLowPass   ()              const   { return m_uiIntraPeriodLowPass; }
@@ -730,6 +756,20 @@ public:
   UInt                              getMbAff            ( )    const   { return m_uiMbAff; }
   UInt                              getPAff             ( )    const   { return m_uiPAff; }
   Bool                              isInterlaced        ( )    const   { return ( m_uiMbAff != 0 || m_uiPAff != 0 ); }
+  UInt                            getSIMD                 ()              const   { return m_uiSIMD; }
+  UInt                            getSIMDSelfCheck        ()              const   { return m_uiSIMDSelfCheck; }
+  UInt                            getWavefrontThreads     ()              const   { return m_uiWavefrontThreads; }
+  UInt                            getSliceMode            ()              const   { return m_uiSliceMode; }
+  UInt                            getSliceArgument        ()              const   { return m_uiSliceArgument; }
+  UInt                            getSliceThreads         ()              const   { return m_uiSliceThreads; }
+  UInt                            getRateControl          ()              const   { return m_uiRateControl; }
+  Double                          getBitrate              ()              const   { return m_dBitrate; }
+  Double                          getMaxBitrate           ()              const   { return m_dMaxBitrate; }
+  Double                          getVBVBufferSize        ()              const   { return m_dVBVBufferSize; }
+  UInt                            getBaseViewBitrateShare ()              const   { return m_uiBaseViewBitrateShare; }
+  UInt                            getRateControlSliceQp   ()              const   { return m_uiRateControlSliceQp; }
+  UInt                            getFastModeDecision     ()              const   { return m_uiFastModeDecision; }
+  UInt                            getPicBufferHugePages   ()              const   { return m_uiPicBufferHugePages; }
 //JVT-W080
 	UInt                            getPdsEnable            ()              const   { return m_uiPdsEnable; } 
 	UInt                            getPdsInitialDelayAnc   ()              const   { return m_uiPdsInitialDelayAnc; } 
@@ -1062,6 +1102,7 @@ protected:
   UInt                      m_uiTotalFrames;
 
   UInt                      m_uiGOPSize;
+  UInt                      m_uiLowDelay;             // IPPP in display order, the GOP size is 1
   UInt                      m_uiDecompositionStages;
   UInt                      m_uiIntraPeriod;
   UInt                      m_uiIntraPeriodLowPass;
@@ -1190,6 +1231,20 @@ protected:
    UInt                      m_uiPAff;
 /**********************/
    UInt		m_uiDPBConformanceCheck;
+   UInt   m_uiSIMD;           // allowed instruction sets of the distortion kernels (SIMDFlags)
+   UInt   m_uiSIMDSelfCheck;  // compare every SIMD kernel against the scalar one
+   UInt   m_uiWavefrontThreads; // threads of the macroblock analysis wavefront (1: serial)
+   UInt   m_uiSliceMode;        // 0: one slice per slice group, 1: slices of SliceArgument macroblocks
+   UInt   m_uiSliceArgument;
+   UInt   m_uiSliceThreads;     // slices of a picture encoded at the same time (1: one after another)
+   UInt   m_uiRateControl;      // 0: fixed QP, 1: CBR, 2: VBR capped at MaxBitrate (RateCtrlMode)
+   Double m_dBitrate;           // kbit/s of all views together
+   Double m_dMaxBitrate;        // kbit/s at which the VBV buffer drains in capped VBR (0: Bitrate)
+   Double m_dVBVBufferSize;     // kbit of all views together (0: half a second at the drain rate)
+   UInt   m_uiBaseViewBitrateShare; // percent of the rate given to the base view, the other views share the rest
+   UInt   m_uiRateControlSliceQp;   // adapt the QP from slice to slice within a picture
+   UInt   m_uiFastModeDecision; // 0: all macroblock modes, 1: fast, 2: faster (see MbEncoder::encodeMacroblock)
+   UInt   m_uiPicBufferHugePages; // back the picture buffers of the application with huge pages (Linux)
 public:
 	std::vector<YUVFileParams> m_MultiviewReferenceFileParams;
 
@@ -37,6 +37,7 @@ class ParameterSetMng;
 class PocCalculator;
 
 class ReconstructionBypass;
+class ViewWorker;
 
 
 H264AVC_NAMESPACE_BEGIN
@@ -126,6 +127,14 @@ public:
   Void	  RoiDecodeInit();
 
   Void    setCrop(UInt *uiCrop);
+  // parsing, reconstruction and deblocking of frames on three threads
+  Void    setPipelined( Bool bPipelined );
+  // reconstruction of the views on one thread each, called before init()
+  Void    setParallelViews( UInt uiNumViews );
+  // decoding of the target views and the views they reference, the other views are dropped after the NAL unit header
+  Void    setTargetViews( UInt uiNumViews, const UInt* puiViewId );
+  // decoding of the target views of an operation point of the view scalability info SEI
+  Void    setTargetOperationPoint( UInt uiOpId );
 
 protected:
   ErrVal xCreateDecoder();
@@ -155,6 +164,8 @@ protected:
   CabacReader*            m_pcCabacReader;
   SampleWeighting*        m_pcSampleWeighting;
   ReconstructionBypass*   m_pcReconstructionBypass;
+  UInt                    m_uiNumViewWorkers;
+  ViewWorker*             m_apcViewWorker           [MAX_WAVEFRONT_LANES];
 
   Bool					  UnitAVCFlag;    //JVT-S036 
 };
@@ -43,6 +43,10 @@ class XDistortion;
 class ControlMngH264AVCEncoder;
 class ReconstructionBypass;
 class PicEncoder;
+class MbAnalysisLane;
+class SliceWorker;
+class MultiviewReferenceStore;
+class NalUnitPool;
 
 
 
@@ -56,7 +60,8 @@ public:
   static ErrVal create  ( CreaterH264AVCEncoder*& rpcCreaterH264AVCEncoder );
   ErrVal        destroy ();
 
-  ErrVal init               ( CodingParameter*    pcCodingParameter);
+  ErrVal init               ( CodingParameter*    pcCodingParameter,
+                              MultiviewReferenceStore* pcMultiviewReferenceStore = NULL );
   ErrVal uninit             ();
   ErrVal writeParameterSets ( ExtBinDataAccessor* pcExtBinDataAccessor,
                               Bool&               rbMoreSets );
@@ -78,12 +83,22 @@ public:
                    PicBufferList*           apcPicBufferOutputList,
                    PicBufferList*           apcPicBufferUnusedList );
 
+  ErrVal flush  (  ExtBinDataAccessorList&  rcExtBinDataAccessorList, 
+                   PicBufferList*           apcPicBufferOutputList,
+                   PicBufferList*           apcPicBufferUnusedList,
+                   UInt                     uiNumFrames );
   ErrVal finish (  ExtBinDataAccessorList&  rcExtBinDataAccessorList, 
                    PicBufferList*           apcPicBufferOutputList,
                    PicBufferList*           apcPicBufferUnusedList,
                    UInt&                    ruiNumCodedFrames,
                    Double&                  rdHighestLayerOutputRate );
 
+  // returns a NAL unit of process(), flush() or finish() to the encoder once the application has written it
+  ErrVal releaseNalUnit( ExtBinDataAccessor* pcNalUnit );
+  // reconstructed pictures the encoder keeps, known once the parameter sets are written;
+  // each of them holds the PicBuffer of its original picture
+  UInt   getMaxFramesInDPB() const;
+
 
   //{{Quality level estimation and modified truncation- JVTO044 and m12007
   //France Telecom R&D-(nathalie.cammas@francetelecom.com)
@@ -140,6 +155,11 @@ protected:
   History*                  m_pcHistory;
   ReconstructionBypass*     m_pcReconstructionBypass;
   PicEncoder*               m_pcPicEncoder;
+  UInt                      m_uiNumMbAnalysisLanes;
+  MbAnalysisLane*           m_apcMbAnalysisLane       [MAX_WAVEFRONT_LANES];
+  UInt                      m_uiNumSliceWorkers;
+  SliceWorker*              m_apcSliceWorker          [MAX_WAVEFRONT_LANES];
+  NalUnitPool*              m_pcNalUnitPool;
   Bool                      m_bTraceEnable;
 };
 
@@ -105,6 +105,15 @@ const UChar g_aucACNextStateLPS64[64] =
 	 37,38,38,63
 };
 
+//===== number of renormalization shifts after a LPS, indexed by the LPS range >> 3 =====
+const UChar g_aucRenormTable32[32] =
+{
+	  6, 5, 4, 4, 3, 3, 3, 3, 2, 2,
+	  2, 2, 2, 2, 2, 2, 1, 1, 1, 1,
+	  1, 1, 1, 1, 1, 1, 1, 1, 1, 1,
+	  1, 1
+};
+
 
 
 H264AVC_NAMESPACE_END
@@ -226,6 +226,8 @@ H264AVC_NAMESPACE_END
 #define YUV_Y_MARGIN        128
 
 #define MAX_LAYERS          8
+#define MAX_WAVEFRONT_LANES 16  // analysis threads of a macroblock wavefront or workers of parallel slices
+#define MAX_PENDING_VIEW_PICTURES 8 // parsed pictures that wait for the view workers
 #define MAX_TEMP_LEVELS     8
 #define MAX_QUALITY_LEVELS  4
 #define MAX_FGS_LAYERS      3
@@ -38,6 +38,8 @@ public:
                                         UInt                        uiMbIndex )         = 0;
 
   virtual ErrVal initMbForDecoding    (MbDataAccess*& rpcMbDataAccess,UInt uiMbY, UInt uiMbX, Bool bMbAFF  )=0;
+  //===== as initMbForDecoding() for an access object built by the caller (pipelined decoding of frames without MBAFF) =====
+  virtual ErrVal initMbForReconstruction( MbDataAccess& rcMbDataAccess, UInt uiMbY, UInt uiMbX )=0;
   virtual ErrVal initMbForFiltering   ( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMbX, Bool bMbAFF )=0;
   virtual ErrVal initMbForFiltering   ( UInt uiMbY, UInt uiMbX, Bool bMbAFF )=0;
 
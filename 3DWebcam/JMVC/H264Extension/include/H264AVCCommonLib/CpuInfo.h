@@ -0,0 +1,59 @@
+#if !defined(AFX_CPUINFO_H__4B2F8E61_0C3A_4D57_9E1B_6A7D2C5F3E90__INCLUDED_)
+#define AFX_CPUINFO_H__4B2F8E61_0C3A_4D57_9E1B_6A7D2C5F3E90__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+
+//===== x86 SIMD kernels are compiled in for x86 / x64 targets only =====
+#if defined( _M_IX86 ) || defined( _M_X64 ) || defined( __i386__ ) || defined( __x86_64__ )
+#define H264AVC_X86_SIMD 1
+#endif
+
+//===== the AVX2 intrinsics (and _xgetbv) come with gcc and msvc 2012 or later, not with msvc 2010 =====
+#if defined( H264AVC_X86_SIMD ) && ( defined( __GNUC__ ) || ( defined( _MSC_VER ) && _MSC_VER >= 1700 ) )
+#define H264AVC_X86_AVX2 1
+#endif
+
+//===== gcc needs the instruction set of a kernel at the function, msvc does not =====
+#if defined( H264AVC_X86_SIMD ) && defined( __GNUC__ )
+#define SIMD_TARGET( isa ) __attribute__(( target( isa ) ))
+#else
+#define SIMD_TARGET( isa )
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+enum SIMDFlags
+{
+  SIMD_NONE   = 0x00,
+  SIMD_SSE2   = 0x01,
+  SIMD_SSSE3  = 0x02,
+  SIMD_AVX2   = 0x04,
+  SIMD_ALL    = 0x07
+};
+
+
+class H264AVCCOMMONLIB_API CpuInfo
+{
+public:
+  //===== instruction sets supported by the processor and the operating system (detected at startup) =====
+  static UInt getSIMDFlags()  { return m_uiSIMDFlags; }
+
+  //===== called by the self check of the kernel tables when a SIMD kernel differs from the scalar one =====
+  static Void reportMismatch( const Char* pcKernel );
+
+private:
+  static UInt xDetectSIMDFlags();
+
+  static UInt m_uiSIMDFlags;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_CPUINFO_H__4B2F8E61_0C3A_4D57_9E1B_6A7D2C5F3E90__INCLUDED_)
@@ -252,7 +252,8 @@ public:
 
           static  ErrVal  create          ( FrameMng*& rpcFrameMng );
           static  UInt    MaxRefFrames    ( UInt uiLevel, UInt uiNumMbs );
-          ErrVal storePicture( const SliceHeader& rcSH );
+          // without extension the margins are padded by the caller, e.g. a view worker that reconstructs the picture later
+          ErrVal storePicture( const SliceHeader& rcSH, Bool bExtendFrame = true );
 
 //  ErrVal storeFGSPicture( PicBuffer* pcPicBuffer );
   ErrVal setRefPicLists( SliceHeader& rcSH, Bool bDoNotRemap );
@@ -263,6 +264,10 @@ public:
   ErrVal  setPicBufferLists       ( PicBufferList& rcPicBufferOutputList, PicBufferList& rcPicBufferUnusedList );
   ErrVal  outputAll               ();
 
+  // while set, released frame units keep their buffers until releaseHeldFrameUnits(), they may still be referenced by pending pictures
+  Void    setHoldReleased         ( Bool bHold )  { m_bHoldReleased = bHold; }
+  ErrVal  releaseHeldFrameUnits   ();
+
   ErrVal  getRecYuvBuffer         ( YuvPicBuffer*& rpcRecYuvBuffer, PicType ePicType );
   FUList& getShortTermList        ()  { return m_cShortTermList; }
 
@@ -288,7 +293,7 @@ protected:
   ErrVal            xClearListsIDR              ( const SliceHeader& rcSH );
   ErrVal            xManageMemory               ( const SliceHeader& rcSH );
   ErrVal            xSlidingWindowUpdate        ();
-  ErrVal            xStoreCurrentPicture        ( const SliceHeader& rcSH );                // MMCO 6
+  ErrVal            xStoreCurrentPicture        ( const SliceHeader& rcSH, Bool bExtendFrame ); // MMCO 6
   ErrVal            xReferenceListRemapping     ( SliceHeader& rcSH, ListIdx eListIdx );
   ErrVal            xMmcoMarkShortTermAsUnused  ( const PicType eCurrPicType, const FrameUnit* pcCurrFrameUnit, UInt uiDiffOfPicNums );
   ErrVal            xMmcoMarkShortTermAsUnusedBase( const PicType eCurrPicType, const FrameUnit* pcCurrFrameUnit, UInt uiDiffOfPicNums ); //JVT-S036 
@@ -310,6 +315,7 @@ protected:
           __inline ErrVal   xRemoveFromRefList( FUList& rcFUList );
           __inline ErrVal   xRemove           ( FrameUnit* pcFrameUnit );
           __inline ErrVal   xAddToFreeList    ( FrameUnit* pcFrameUnit );
+          __inline ErrVal   xReleaseFrameUnit ( FrameUnit* pcFrameUnit );
           __inline ErrVal   xAddToFreeList    ( FUList& rcFUList );
           __inline Bool     xFindAndErase     ( FUList& rcFUList, FrameUnit* pcFrameUnit );
 
@@ -343,6 +349,8 @@ private:
   FUList            m_cShortTermList;
   FUList            m_cNonRefList;
   FUList            m_cOrderedPOCList;
+  FUList            m_cHeldList;
+  Bool              m_bHoldReleased;
 
   FrameUnitBuffer   m_cFrameUnitBuffer;
 
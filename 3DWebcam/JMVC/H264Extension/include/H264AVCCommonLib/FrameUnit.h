@@ -102,6 +102,10 @@ public:
     const IntFrame* getResidual()           const { return &m_cResidual; }
     IntFrame* getResidual()                       { return &m_cResidual; }
 
+    // macroblock rows of the frame that are reconstructed, deblocked and padded, set while the picture is decoded by a view worker
+    Void  setRowsDone   ( UInt uiRows )           { m_uiRowsDone = uiRows; }
+    UInt  getRowsDone   ()                  const { return m_uiRowsDone; }
+
 
 	ErrVal uninitBase(); //JVT-S036
 
@@ -124,6 +128,7 @@ private:
     Bool          m_bConstrainedIntraPred;
 
     UInt          m_uiFGSReconCount;
+    volatile UInt m_uiRowsDone;
     //MultiviewReferenceDirection     m_multiviewRefDirection;
 
 };
@@ -105,6 +105,15 @@ private:
 typedef MyList<DPBUnit*>  DPBUnitList;
 
 
+// encoder: coarse vector of a macroblock against a reference and how often the motion search started from it
+struct MotionSeed
+{
+  Mv    cMv;            // quarter pel
+  UInt  uiNumSearches;
+  UInt  uiNumWins;
+};
+
+
 
 class H264AVCCOMMONLIB_API IntFrame
 {
@@ -121,6 +130,10 @@ public:
 
   ErrVal  load            ( PicBuffer*        pcPicBuffer );
   ErrVal  store           ( PicBuffer*        pcPicBuffer );
+  // refer to the extended samples of pcSrcFrame instead of loading them, until giveBack() is called
+  ErrVal  borrow          ( IntFrame*         pcSrcFrame );
+  ErrVal  giveBack        ();
+  Bool    isBorrowed      ()  const { return m_bBorrowed; }
   ErrVal extendFrame( QuarterPelFilter* pcQuarterPelFilter, PicType ePicType, Bool bFrameMbsOnlyFlag );
   ErrVal  extendFrame     ( QuarterPelFilter* pcQuarterPelFilter );
 
@@ -375,6 +388,13 @@ public:
   UInt  getViewId()      const   { return m_uiViewId; }
   Void  setViewId( UInt uiViewId ) { m_uiViewId = uiViewId; }
 
+  // encoder: displacement of this inter-view reference against the picture that is coded (quarter pel)
+  const Mv& getGlobalDisparity()                    const { return m_cGlobalDisparity; }
+  Void      setGlobalDisparity( const Mv& rcDisparity )     { m_cGlobalDisparity = rcDisparity; }
+  // encoder: coarse vectors of the macroblocks of the picture that is coded against this reference, NULL without pre-pass
+  MotionSeed* getMotionSeeds()                      const { return m_pcMotionSeeds; }
+  Void        setMotionSeeds( MotionSeed* pcSeeds )       { m_pcMotionSeeds = pcSeeds; }
+
 
   // JVT-R057 LA-RDO{
   Void   initChannelDistortion();
@@ -398,6 +418,7 @@ protected:
   Int             m_iPOC;
   Bool            m_bHalfPel;
   Bool            m_bExtended;
+  Bool            m_bBorrowed;
 
   DPBUnit*        m_pcDPBUnit;
 
@@ -418,6 +439,8 @@ protected:
 
     Int			  m_iFrameNum; //JVT-S036 
   UInt            m_uiViewId;
+  Mv              m_cGlobalDisparity;
+  MotionSeed*     m_pcMotionSeeds;
 
 };
 
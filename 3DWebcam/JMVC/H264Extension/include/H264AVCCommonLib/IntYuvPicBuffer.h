@@ -31,15 +31,17 @@ public:
   const Int     getLStride    ()                const { return m_iStride;   }
   const Int     getCStride    ()                const { return m_iStride>>1;}
   
-  XPel*         getLumBlk     ()                      { return m_pPelCurrY; }
-  XPel*         getCbBlk      ()                      { return m_pPelCurrU; }
-  XPel*         getCrBlk      ()                      { return m_pPelCurrV; }
+  //===== the current block is kept for each analysis lane, as reference pictures are searched concurrently =====
+  XPel*         getLumBlk     ()                      { return m_apPelCurrY[ YuvBufferCtrl::getMbLane() ]; }
+  XPel*         getCbBlk      ()                      { return m_apPelCurrU[ YuvBufferCtrl::getMbLane() ]; }
+  XPel*         getCrBlk      ()                      { return m_apPelCurrV[ YuvBufferCtrl::getMbLane() ]; }
 
   Void          set4x4Block   ( LumaIdx cIdx )
   {
-    m_pPelCurrY = m_pucYuvBuffer + m_rcBufferParam.getYBlk( cIdx );
-    m_pPelCurrU = m_pucYuvBuffer + m_rcBufferParam.getUBlk( cIdx );
-    m_pPelCurrV = m_pucYuvBuffer + m_rcBufferParam.getVBlk( cIdx );
+    const UInt uiLane = YuvBufferCtrl::getMbLane();
+    m_apPelCurrY[uiLane] = m_pucYuvBuffer + m_rcBufferParam.getYBlk( cIdx );
+    m_apPelCurrU[uiLane] = m_pucYuvBuffer + m_rcBufferParam.getUBlk( cIdx );
+    m_apPelCurrV[uiLane] = m_pucYuvBuffer + m_rcBufferParam.getVBlk( cIdx );
   }
 
   // Hanke@RWTH
@@ -103,6 +105,9 @@ public:
 
   ErrVal        init                    ( XPel*&            rpucYuvBuffer );
   ErrVal        uninit                  ();
+  // use the samples of pcSrcYuvPicBuffer (same layout) without copying them until giveBack() is called
+  ErrVal        borrow                  ( IntYuvPicBuffer*  pcSrcYuvPicBuffer );
+  ErrVal        giveBack                ();
   Void          setZero                 ();
   ErrVal        clip                    ();
 
@@ -135,6 +140,7 @@ public:
 protected:
     Void xCopyFillPlaneMargin( XPel *pucSrc, XPel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin );//th
     Void xCopyPlane( XPel *pucSrc, XPel *pucDest, Int iHeight, Int iWidth, Int iStride );
+  Void xResetCurrBlk        ();
   Void xFillPlaneMargin     ( XPel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin );
 
 protected:
@@ -142,13 +148,17 @@ protected:
   YuvBufferCtrl&                            m_rcYuvBufferCtrl;
 
   Int             m_iStride;
-  XPel*           m_pPelCurrY;
-  XPel*           m_pPelCurrU;
-  XPel*           m_pPelCurrV;
+  XPel*           m_apPelCurrY[ MAX_WAVEFRONT_LANES ];
+  XPel*           m_apPelCurrU[ MAX_WAVEFRONT_LANES ];
+  XPel*           m_apPelCurrV[ MAX_WAVEFRONT_LANES ];
   
   XPel*           m_pucYuvBuffer;
   XPel*           m_pucOwnYuvBuffer;
   PicType         m_ePicType;
+
+  Bool            m_bBorrowed;
+  XPel*           m_pucSavedYuvBuffer;  // m_pucYuvBuffer before borrow()
+  Int             m_iSavedStride;
 };
 
 
@@ -5,6 +5,8 @@
 #pragma once
 #endif // _MSC_VER > 1000
 
+#include "H264AVCCommonLib/CpuInfo.h"
+
 
 H264AVC_NAMESPACE_BEGIN
 
@@ -14,6 +16,12 @@ class IntFrame;
 
 class ReconstructionBypass;
 
+
+//===== filters one macroblock edge, pFlt points to the first q0 sample =====
+//===== luma: 16 samples with 4 strengths, chroma: 8 samples with 4 strengths =====
+typedef Void (*EdgeFilterFunc) ( Pel*  pFlt, Int iStride, const UChar* pucBs, Int iIndexA, Int iIndexB );
+typedef Void (*XEdgeFilterFunc)( XPel* pFlt, Int iStride, const UChar* pucBs, Int iIndexA, Int iIndexB );
+
 class H264AVCCOMMONLIB_API LoopFilter
 {
     enum Dir
@@ -48,6 +56,12 @@ public:
         Bool bLum;
     }FilterParameter;
 
+    typedef struct
+    {
+        UChar aaaucBs   [2][4][4]; // [VER|HOR][edge][segment along the edge]
+        UChar aaaucIndex[2][3][2]; // [luma|chroma][left|top|inner edges][IndexA|IndexB]
+    }MbEdgeParameter;
+
     static const UChar g_aucBetaTab[52]; // leszek
     static const AlphaClip g_acAlphaClip[52]; // leszek
 
@@ -68,9 +82,15 @@ public:
         RefFrameList*       pcRefFrameList0,
         RefFrameList*       pcRefFrameList1,
         bool                spatial_scalable_flg);  // SSUN@SHARP
+    //===== pipelined decoding of frames without MBAFF: filters the MB rows [uiStartRow, uiStopRow) in order, while =====
+    //===== the picture is decoded; the macroblocks must be reconstructed up to the row below uiStopRow, as intra =====
+    //===== prediction of that row reads the unfiltered samples =====
+    ErrVal filterRows     ( SliceHeader& rcSH, MbDataCtrl* pcMbDataCtrl, UInt uiStartRow, UInt uiStopRow );
 
     ErrVal init( ControlMngIf*          pcControlMngIf,
-        ReconstructionBypass*  pcReconstructionBypass );
+        ReconstructionBypass*  pcReconstructionBypass,
+        UInt                   uiSIMDFlags = SIMD_ALL,
+        Bool                   bSelfCheck  = false );
     ErrVal uninit();
 
     Void setFilterMode( LFMode eLFMode = LFM_DEFAULT_FILTER ) { m_eLFMode = eLFMode; }
@@ -86,6 +106,23 @@ private:
 
     __inline ErrVal xFilterMb( const MbDataAccess& rcMbDataAccess );
     __inline ErrVal xFilterMbFast( const MbDataAccess& rcMbDataAccess );
+
+    //===== two pass filtering of pictures without MBAFF: strengths of all macroblocks first, then MB rows in parallel =====
+    ErrVal xAllocEdgeParameters  ( UInt uiMbInRow, UInt uiMbInCol );
+    Void   xDeleteEdgeParameters ();
+    ErrVal xGetEdgeParameterFast ( const MbDataAccess& rcMbDataAccess, MbEdgeParameter& rcParam );
+    Void   xSetEdgeParameter     ( const MbDataAccess& rcMbDataAccess, const DFP& rcDFP, MbEdgeParameter& rcParam );
+    template< typename TPel >
+    Void   xFilterPicture        ( TPel* pLum, TPel* pCb, TPel* pCr, Int iLStride, Int iCStride, UInt uiMbInRow, UInt uiMbInCol );
+    template< typename TPel >
+    Void   xFilterMbEdges        ( const MbEdgeParameter& rcParam, TPel* pLum, TPel* pCb, TPel* pCr, Int iLStride, Int iCStride );
+    template< typename TPel, typename TEdgeFilterFunc >
+    Void   xFilterEdge           ( TEdgeFilterFunc fpEdgeFilter, TPel* pFlt, Int iStride, Bool bVer, const UChar* pucBs, Int iIndexA, Int iIndexB, Bool bLum );
+    template< typename TPel >
+    Void   xFilterEdgeScalar     ( TPel* pFlt, Int iStep, Int iOffset, const UChar* pucBs, Int iIndexA, Int iIndexB, Bool bLum );
+    EdgeFilterFunc  xGetEdgeFilterFunc( const Pel*,  UInt uiComp, UInt uiDir ) const { return m_aafpEdgeFilterFunc [uiComp][uiDir]; }
+    XEdgeFilterFunc xGetEdgeFilterFunc( const XPel*, UInt uiComp, UInt uiDir ) const { return m_aafpXEdgeFilterFunc[uiComp][uiDir]; }
+    Void   xInitSIMDFunctions    ( UInt uiSIMDFlags );
     ErrVal xGetFilterStrengthFast( const MbDataAccess& rcMbDataAccess, const Int iFilterIdc );
     __inline UInt xGetHorFilterStrengthFast( const MbData& rcMbDataCurr,
         const MbData& rcMbDataAbove,
@@ -124,7 +161,8 @@ private:
         IntYuvPicBuffer*    pcYuvBuffer,
         RefFrameList*       pcRefFrameList0,
         RefFrameList*       pcRefFrameList1,
-        bool                spatial_scalable_flg);  // SSUN@SHARP
+        bool                spatial_scalable_flg,  // SSUN@SHARP
+        MbEdgeParameter*    pcEdgeParameter = NULL );
 
     __inline ErrVal xLumaHorFiltering             ( const MbDataAccess& rcMbDataAccessRes,
         const DFP&          rcDFP,
@@ -189,6 +227,15 @@ protected:
     Bool            m_bHorMixedMode;
     Bool            m_bAddEdge;
 
+    Bool            m_bSelfCheck;
+    EdgeFilterFunc  m_aafpEdgeFilterFunc [2][2]; // [luma|chroma][VER|HOR], NULL: scalar code
+    XEdgeFilterFunc m_aafpXEdgeFilterFunc[2][2];
+    MbEdgeParameter* m_pcMbEdgeParameter;       // all macroblocks of the picture in raster scan
+    volatile Int*   m_piRowProgress;            // number of filtered macroblocks per MB row
+    UInt            m_uiMaxMbInPic;
+    UInt            m_uiMaxMbInCol;
+    MbDataAccess*   m_pcMbDataAccess;           // storage of filterRows()
+
 protected:
 
     template <UInt uiLum> Void xFilterTempl( FilterParameter& rcFilterParameter )
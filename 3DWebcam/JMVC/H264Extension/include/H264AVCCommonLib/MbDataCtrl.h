@@ -29,6 +29,14 @@ public:
   ErrVal getBoundaryMask( Int iMbY, Int iMbX, UInt& ruiMask ) const ;
   ErrVal initMb( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMbX, const Int iForceQp = -1 );
   ErrVal initMb( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMbX, const Bool bFieldFlag, const Int iForceQp );
+  //===== for the analysis lanes of a wavefront: the access object is built in the caller's storage rpcMbDataAccess (allocated if NULL) =====
+  //===== and refers to the caller's copy of the slice header, which mode decision may modify temporarily; uiSliceId is the id =====
+  //===== that initSlice() assigned to the slice, as the slices of a picture may be encoded at the same time =====
+  ErrVal initMbForAnalysis( MbDataAccess*& rpcMbDataAccess, SliceHeader& rcSliceHeader, UInt uiSliceId, UInt uiMbY, UInt uiMbX );
+  //===== for the reconstruction and deblocking stages of the pipelined decoder: the access object to a macroblock that has =====
+  //===== been parsed is built in the caller's storage (allocated if NULL) while the next macroblocks are parsed, the state =====
+  //===== of the slice is not changed; with bLoopFilter the neighbours in other slices are available as for deblocking =====
+  ErrVal initMbForPipeline( MbDataAccess*& rpcMbDataAccess, SliceHeader& rcSliceHeader, UInt uiMbY, UInt uiMbX, UChar ucLastMbQp, Bool bLoopFilter );
   ErrVal init( const SequenceParameterSet& rcSPS );
 //	TMM_EC {{
   ErrVal initMbTDEnhance( MbDataAccess*& rpcMbDataAccess, MbDataCtrl *pcMbDataCtrl, MbDataCtrl *pcMbDataCtrlRef, UInt uiMbY, UInt uiMbX, const Int iForceQp = -1 );
@@ -105,6 +113,7 @@ protected:
   const MbData& xGetOutMbData()            const { return m_pcMbData[m_uiSize]; }
   const MbData& xGetRefMbData( UInt uiSliceId, Int uiCurrSliceID, Int iMbY, Int iMbX, Bool bLoopFilter ); 
   const MbData& xGetColMbData( UInt uiIndex );
+  ErrVal        xInitMbDataAccess( MbDataAccess*& rpcMbDataAccess, SliceHeader& rcSliceHeader, UInt uiMbY, UInt uiMbX, UChar ucLastMbQp, Bool bLoopFilter );
 
   ErrVal xCreateData( UInt uiSize );
   ErrVal xDeleteData();
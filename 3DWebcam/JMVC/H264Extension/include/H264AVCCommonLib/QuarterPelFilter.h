@@ -9,11 +9,16 @@
 #include "H264AVCCommonLib/YuvPicBuffer.h"
 #include "H264AVCCommonLib/IntYuvMbBuffer.h"
 #include "H264AVCCommonLib/IntYuvPicBuffer.h"
+#include "H264AVCCommonLib/CpuInfo.h"
 
 H264AVC_NAMESPACE_BEGIN
 
 typedef Void (*FilterBlockFunc)( Pel* pDes, Pel* pSrc, Int iSrcStride, UInt uiXSize, UInt uiYSize );
 typedef Void (*XFilterBlockFunc)( XPel* pDes, XPel* pSrc, Int iSrcStride, UInt uiXSize, UInt uiYSize );
+typedef Void   (*PredLumaFunc)    ( Pel*  pDes, Pel*  pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY );
+typedef Void   (*XPredLumaFunc)   ( XPel* pDes, XPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY );
+typedef ErrVal (*FilterFrameFunc) ( Pel*  pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iMargin, Pel*  pDesHP, Int iDesStrideHP );
+typedef ErrVal (*XFilterFrameFunc)( XPel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iMargin, XPel* pDesHP, Int iDesStrideHP );
 
 class H264AVCCOMMONLIB_API QuarterPelFilter
 {
@@ -24,7 +29,7 @@ protected:
 public:
   static ErrVal create( QuarterPelFilter*& rpcQuarterPelFilter );
   ErrVal destroy();
-  virtual ErrVal init();
+  virtual ErrVal init( UInt uiSIMDFlags = SIMD_ALL, Bool bSelfCheck = false );
   ErrVal uninit();
 
   Void predBlkBilinear( IntYuvMbBuffer*     pcDesBuffer, IntYuvPicBuffer*     pcSrcBuffer, LumaIdx cIdx, Mv cMv, Int iSizeY, Int iSizeX);
@@ -54,6 +59,11 @@ public:
   Void xUpdInterpChroma( Int* pucDest, Int iDestStride, XPel* pucSrc, Int iSrcStride, Mv cMv, Int iSizeY, Int iSizeX );
 
 protected:
+  ErrVal xFilterFrame( YuvPicBuffer* pcPelBuffer, YuvPicBuffer* pcHalfPelBuffer );
+  ErrVal xFilterFrame( IntYuvPicBuffer* pcPelBuffer, IntYuvPicBuffer* pcHalfPelBuffer );
+  Void xPredLuma( Pel*  pucDes, Pel*  pucSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY, Int iSizeX );
+  Void xPredLuma( XPel* pucDes, XPel* pucSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY, Int iSizeX );
+
   virtual Void xPredElse( Pel*  pucDest, Pel*  pucSrc, Int iDestStride, Int iSrcStride, Int iDx, Int iDy, UInt uiSizeY, UInt uiSizeX );
   virtual Void xPredDy2Dx13( Pel*  pucDest, Pel*  pucSrc, Int iDestStride, Int iSrcStride, Int iDx, Int iDy, UInt uiSizeY, UInt uiSizeX );
   virtual Void xPredDx2Dy13( Pel*  pucDest, Pel*  pucSrc, Int iDestStride, Int iSrcStride, Int iDx, Int iDy, UInt uiSizeY, UInt uiSizeX );
@@ -88,10 +98,19 @@ protected:
 
   Int xClip( Int iPel ) { return ( m_bClip ? gClip( iPel ) : iPel); }
 
+  //===== the SIMD kernels are specialized for blocks of 16, 8 and 4 samples width =====
+  static UInt xGetSizeIdx( Int iSizeX ) { return ( iSizeX == 16 ? 0 : iSizeX == 8 ? 1 : iSizeX == 4 ? 2 : 3 ); }
+  Void xInitSIMDFunctions( UInt uiSIMDFlags );
+
 protected:
   Bool m_bClip;
+  Bool m_bSelfCheck;
   FilterBlockFunc m_afpFilterBlockFunc[4];
   XFilterBlockFunc m_afpXFilterBlockFunc[4];
+  PredLumaFunc      m_aafpPredLumaFunc [4][16]; // [size][4*dy+dx], NULL: scalar code
+  XPredLumaFunc     m_aafpXPredLumaFunc[4][16];
+  FilterFrameFunc   m_fpFilterFrameFunc;
+  XFilterFrameFunc  m_fpXFilterFrameFunc;
 };
 
 #if AR_FGS_COMPENSATE_SIGNED_FRAME
@@ -659,8 +659,12 @@ public:
   public:
 
     static ErrVal create  ( ParallelDecodingSEI*&         rpcSeiMessage );
+    ErrVal        destroy ();
     ErrVal        write   ( HeaderSymbolWriteIf*  pcWriteIf );
     ErrVal        read    ( HeaderSymbolReadIf*   pcReadIf );
+    // the numbers of delays are those of the referenced (subset) SPS, the message is skipped when it is unknown
+    ErrVal        read    ( HeaderSymbolReadIf*   pcReadIf,
+                            ParameterSetMng*      pcParameterSetMng );
 		ErrVal        init    ( UInt uiSPSId
 			                    , UInt uiNumView
 													, UInt* num_refs_list0_anc
@@ -683,6 +687,8 @@ public:
 		UInt**        getPDIInitDelayMinus2L1Anc() const { return m_ppuiPDIInitDelayMinus2L1Anc; }
 		UInt**        getPDIInitDelayMinus2L0NonAnc() const { return m_ppuiPDIInitDelayMinus2L0NonAnc; }
 		UInt**        getPDIInitDelayMinus2L1NonAnc() const { return m_ppuiPDIInitDelayMinus2L1NonAnc; }
+    // initial delay in macroblock rows of the uiRef-th inter-view reference of a view (coding order index), 0 when not signalled
+    UInt          getPDIInitDelay( UInt uiViewIdx, Bool bAnchor, ListIdx eListIdx, UInt uiRef ) const;
 
 		Void          setSPSId( UInt uiSPSId )              { m_uiSPSId = uiSPSId; }
 		Void          setNumView( UInt uiNumView )          { m_uiNumView = uiNumView; }
@@ -1380,7 +1386,8 @@ class H264AVCCOMMONLIB_API MultiviewAcquisitionInfoSei : public SEIMessage // SE
  // static ErrVal read  ( HeaderSymbolReadIf*   pcReadIf,
  //                       MessageList&          rcSEIMessageList );
   static ErrVal read  ( HeaderSymbolReadIf*   pcReadIf,
-                        MessageList&          rcSEIMessageList /*, UInt NumViewsMinus1 =0 */ ); // SEI JVT-W060 Nov. 30
+                        MessageList&          rcSEIMessageList /*, UInt NumViewsMinus1 =0 */,  // SEI JVT-W060 Nov. 30
+                        ParameterSetMng*      pcParameterSetMng = NULL ); // parses the parallel decoding info
   static ErrVal write ( HeaderSymbolWriteIf*  pcWriteIf,
                         HeaderSymbolWriteIf*  pcWriteTestIf,
                         MessageList*          rpcSEIMessageList );
@@ -1389,7 +1396,8 @@ protected:
   //static ErrVal xRead               ( HeaderSymbolReadIf*   pcReadIf,
   //                                    SEIMessage*&          rpcSEIMessage ); 
   static ErrVal xRead               ( HeaderSymbolReadIf*   pcReadIf,
-                                      SEIMessage*&          rpcSEIMessage /*, UInt NumViewsMinus1*/ );  // SEI JVT-W060 Nov. 30
+                                      SEIMessage*&          rpcSEIMessage /*, UInt NumViewsMinus1*/,  // SEI JVT-W060 Nov. 30
+                                      ParameterSetMng*      pcParameterSetMng );
   static ErrVal xWrite              ( HeaderSymbolWriteIf*  pcWriteIf,
                                       HeaderSymbolWriteIf*  pcWriteTestIf,
                                       SEIMessage*           pcSEIMessage );
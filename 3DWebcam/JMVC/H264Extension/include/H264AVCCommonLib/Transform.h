@@ -8,10 +8,14 @@
 #include "H264AVCCommonLib/Quantizer.h"
 #include "H264AVCCommonLib/YuvMbBuffer.h"
 #include "H264AVCCommonLib/IntYuvMbBuffer.h"
+#include "H264AVCCommonLib/CpuInfo.h"
 
 H264AVC_NAMESPACE_BEGIN
 
 
+typedef UInt (*TransformMbFunc)( XPel* pOrg, XPel* pRec, Int iStride, TCoeff* piCoeff, const QpParameter& rcQp, UInt* puiAbsSum );
+
+
 class H264AVCCOMMONLIB_API Transform :
 public Quantizer
 {
@@ -22,6 +26,8 @@ protected:
 public:
   static ErrVal create( Transform*& rpcTransform );
   ErrVal destroy();
+  ErrVal init   ( UInt uiSIMDFlags = SIMD_ALL, Bool bSelfCheck = false );
+  ErrVal uninit ();
   Void setClipMode( Bool bEnableClip ) { m_bClip = bEnableClip; }
 
   Bool getClipMode()                   { return m_bClip; }
@@ -69,6 +75,8 @@ public:
 
   ErrVal        transform8x8Blk           ( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pcPelData, TCoeff* piCoeff, const UChar* pucScale, UInt& ruiAbsSum );
   ErrVal        transform4x4Blk           ( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pcPelData, TCoeff* piCoeff, const UChar* pucScale, UInt& ruiAbsSum );
+  ErrVal        transform8x8Mb            ( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pcPelData, TCoeff* piCoeff, const UChar* pucScale, UInt* puiAbsSum, UInt& ruiCbp );
+  ErrVal        transform4x4Mb            ( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pcPelData, TCoeff* piCoeff, const UChar* pucScale, UInt* puiAbsSum, UInt& ruiCbp );
   ErrVal        transformMb16x16          ( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pcPelData, TCoeff* piCoeff, const UChar* pucScale, UInt& ruiDcAbs,  UInt& ruiAcAbs );
   ErrVal        transformChromaBlocks     ( XPel* pucOrg, XPel* pucRec, Int iStride, TCoeff* piCoeff, TCoeff* piQuantCoeff, const UChar* pucScale, UInt& ruiDcAbs, UInt& ruiAcAbs );
 
@@ -118,6 +126,13 @@ public:
 
 
 private:
+  //===== all blocks of a macroblock, returns the extended luma cbp =====
+  UInt xTransform8x8Mb          ( XPel* pOrg, XPel* pRec, Int iStride, TCoeff* piCoeff, const UChar* pucScale, UInt* puiAbsSum );
+  UInt xTransform4x4Mb          ( XPel* pOrg, XPel* pRec, Int iStride, TCoeff* piCoeff, const UChar* pucScale, UInt* puiAbsSum );
+  Void xInitSIMDFunctions       ( UInt uiSIMDFlags );
+  static Bool xIsEqualMb        ( const XPel* psRecA, const TCoeff* piCoeffA, const UInt* puiAbsSumA,
+                                  const XPel* psRecB, Int iStrideB, const TCoeff* piCoeffB, const UInt* puiAbsSumB, UInt uiNumBlocks );
+
   Void xForTransform8x8Blk      ( XPel* pucOrg, XPel* pucRec, Int iStride, TCoeff* piPredCoeff );
   Void xForTransform4x4Blk      ( XPel* pucOrg, XPel* pucRec, Int iStride, TCoeff* piPredCoeff );
   
@@ -174,6 +189,9 @@ private:
 protected:
   const SliceHeader*  m_pcSliceHeader;
   Bool                m_bClip;
+  Bool                m_bSelfCheck;
+  TransformMbFunc     m_fpTransform8x8MbFunc; // NULL: scalar code
+  TransformMbFunc     m_fpTransform4x4MbFunc;
 };
 
 
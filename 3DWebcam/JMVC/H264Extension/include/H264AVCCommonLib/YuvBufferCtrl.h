@@ -6,6 +6,14 @@
 #endif // _MSC_VER > 1000
 
 
+//===== storage class of per-thread variables =====
+#if defined( _MSC_VER )
+#define H264AVC_THREAD_LOCAL __declspec( thread )
+#else
+#define H264AVC_THREAD_LOCAL __thread
+#endif
+
+
 H264AVC_NAMESPACE_BEGIN
 
 class H264AVCCOMMONLIB_API YuvBufferCtrl
@@ -15,21 +23,22 @@ public:
   {
   public:
     YuvBufferParameter() {}
-    const UInt getMbLum()   const { return m_uiLumOffset; }
-    const UInt getMbCb()    const { return m_uiCbOffset; }
-    const UInt getMbCr()    const { return m_uiCrOffset; }
+    const UInt getMbLum()   const { return m_auiLumOffset[ YuvBufferCtrl::getMbLane() ]; }
+    const UInt getMbCb()    const { return m_auiCbOffset [ YuvBufferCtrl::getMbLane() ]; }
+    const UInt getMbCr()    const { return m_auiCrOffset [ YuvBufferCtrl::getMbLane() ]; }
 
     const Int getStride()   const { return m_iStride; }
     const Int getHeight()   const { return m_iHeight; }
     const Int getWidth()    const { return m_iWidth; }
 
-    const UInt getYBlk( LumaIdx cIdx ) const    { return m_uiLumOffset +  ((cIdx.y() * m_iStride + cIdx.x())<<(2 + m_iResolution)); }
-    const UInt getUBlk( LumaIdx cIdx ) const    { return m_uiCbOffset  +  ((cIdx.y() * m_iStride + (cIdx.x()<<1)) << m_iResolution); }
-    const UInt getVBlk( LumaIdx cIdx ) const    { return m_uiCrOffset  +  ((cIdx.y() * m_iStride + (cIdx.x()<<1)) << m_iResolution); }
+    const UInt getYBlk( LumaIdx cIdx ) const    { return getMbLum() +  ((cIdx.y() * m_iStride + cIdx.x())<<(2 + m_iResolution)); }
+    const UInt getUBlk( LumaIdx cIdx ) const    { return getMbCb () +  ((cIdx.y() * m_iStride + (cIdx.x()<<1)) << m_iResolution); }
+    const UInt getVBlk( LumaIdx cIdx ) const    { return getMbCr () +  ((cIdx.y() * m_iStride + (cIdx.x()<<1)) << m_iResolution); }
 
-    UInt m_uiLumOffset;
-    UInt m_uiCbOffset;
-    UInt m_uiCrOffset;
+    //===== macroblock offsets, one set for each analysis lane of a wavefront =====
+    UInt m_auiLumOffset[ MAX_WAVEFRONT_LANES ];
+    UInt m_auiCbOffset [ MAX_WAVEFRONT_LANES ];
+    UInt m_auiCrOffset [ MAX_WAVEFRONT_LANES ];
     Int m_iStride;
     Int m_iResolution;
     Int m_iHeight;
@@ -55,6 +64,10 @@ public:
   const Int getXMargin()  const { return m_uiXMargin; }
   const Int getYMargin()  const { return m_uiYMargin; }
 
+  //===== the calling thread uses (initMb) and reads (getMbLum etc.) the macroblock offsets of this lane, default 0 =====
+  static Void setMbLane( UInt uiLane )  { m_uiMbLane = uiLane; }
+  static UInt getMbLane()               { return m_uiMbLane; }
+
   UInt getLumOrigin ( PicType ePicType ) const { return m_uiLumBaseOffset + (( ePicType == BOT_FIELD) ? m_acBufferParam[FRAME].m_iStride   : 0); }
   UInt getCbOrigin  ( PicType ePicType ) const { return m_uiCbBaseOffset  + (( ePicType == BOT_FIELD) ? m_acBufferParam[FRAME].m_iStride/2 : 0); }
   UInt getCrOrigin  ( PicType ePicType ) const { return m_uiCbBaseOffset  
@@ -69,6 +82,8 @@ protected:
   UInt m_uiXMargin;
   UInt m_uiYMargin;
   Bool m_bInitDone;
+
+  static H264AVC_THREAD_LOCAL UInt m_uiMbLane;
 };
 
 
@@ -65,6 +65,8 @@ public:
   ErrVal loadBuffer( YuvMbBuffer *pcYuvMbBuffer );
   ErrVal loadBuffer( IntYuvMbBuffer *pcYuvMbBuffer );
   ErrVal fillMargin();
+  // pads the lines of the macroblock rows [uiStartRow,uiStopRow) of a frame, the top and bottom margins with the first and last row
+  ErrVal fillMarginRows( UInt uiStartRow, UInt uiStopRow );
   ErrVal loadBufferAndFillMargin( YuvPicBuffer *pcSrcYuvPicBuffer );
 
   ErrVal init( Pel*& rpucYuvBuffer );
@@ -78,7 +80,7 @@ public:
 
   ErrVal copy( YuvPicBuffer* pcPicBuffer ); // HS: decoder robustness
 protected:
-    Void xFillPlaneMargin( Pel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin );
+    Void xFillPlaneMargin( Pel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin, Int iStartLine, Int iStopLine );
     Void xCopyFillPlaneMargin( Pel *pucSrc, Pel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin );
     Void xDump( FILE* hFile, Pel* pPel, Int iHeight, Int iWidth, Int iStride );
 
@@ -37,6 +37,8 @@ public:
 
 	ErrVal read( Void *pvBuffer, UInt32 uiCount, UInt32& ruiBytesRead );
 	ErrVal write( const Void *pvBuffer, UInt32 uiCount );
+	// both buffers in one system call where supported
+	ErrVal write( const Void *pvBuffer0, UInt32 uiCount0, const Void *pvBuffer1, UInt32 uiCount1 );
 
 	Int getFileHandle() { return m_iFileHandle; }
 
@@ -0,0 +1,87 @@
+#if !defined(AFX_MULTIVIEWREFERENCESTORE_H__6B1E2C47_3F0A_4D8E_9C55_2A7D10E4B913__INCLUDED_)
+#define AFX_MULTIVIEWREFERENCESTORE_H__6B1E2C47_3F0A_4D8E_9C55_2A7D10E4B913__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <map>
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+class IntFrame;
+
+
+// Hands the reconstructed pictures of a view over to the other views that
+// are encoded in the same process, instead of writing them to and reading
+// them back from the reconstructed YUV file. The PicEncoder of every view
+// publishes each picture of its RecPicBuffer as soon as it is reconstructed
+// and extended, the PicEncoder of a dependent view waits for the
+// (view_id, POC) pictures its anchor and non-anchor references point at and
+// borrows their samples, nothing is copied. A published picture is lent
+// until every dependent view has released it, the reference view must not
+// modify or reuse it before. The views are encoded by different threads.
+class H264AVCENCODERLIB_API MultiviewReferenceStore
+{
+protected:
+  MultiviewReferenceStore         ();
+  virtual ~MultiviewReferenceStore();
+
+public:
+  static ErrVal create            ( MultiviewReferenceStore*& rpcMultiviewReferenceStore );
+  ErrVal        destroy           ();
+
+  // called once per inter-view reference, before the encoding starts
+  Void          addDependentView  ( UInt                      uiRefViewId );
+
+  Bool          hasDependentViews ( UInt                      uiViewId );
+  ErrVal        publish           ( UInt                      uiViewId,
+                                    UInt                      uiPoc,
+                                    IntFrame*                 pcFrame );
+  ErrVal        wait              ( UInt                      uiViewId,
+                                    UInt                      uiPoc,
+                                    IntFrame*&                rpcFrame );
+  Void          release           ( UInt                      uiViewId,
+                                    UInt                      uiPoc );
+  // true while a dependent view may still read the samples of pcFrame
+  Bool          isLent            ( const IntFrame*           pcFrame );
+  // number of pictures released by all their dependent views so far
+  UInt          getNumRemoved     ();
+  // sleeps until more than uiNumRemoved pictures were released, fails when aborted
+  ErrVal        waitForRemoval    ( UInt                      uiNumRemoved );
+
+  // wakes up all waiting views, wait() fails from now on (e.g. the encoder of a view failed)
+  Void          abort             ();
+
+protected:
+  typedef std::pair<UInt,UInt>  PictureKey; // (view_id, POC)
+
+  class StoredPicture
+  {
+  public:
+    StoredPicture() : pcFrame( NULL ), uiPendingReleases( 0 ) {}
+
+    IntFrame*   pcFrame;            // NULL until published
+    UInt        uiPendingReleases;  // dependent views that did not release it yet
+  };
+  typedef std::map<PictureKey,StoredPicture> StoredPictureMap;
+
+  StoredPicture&  xGetEntry       ( UInt                      uiViewId,
+                                    UInt                      uiPoc );
+  Void            xRemoveEntry    ( StoredPictureMap::iterator iter );
+
+protected:
+  std::map<UInt,UInt> m_cNumDependentViews;
+  StoredPictureMap    m_cPictures;
+  Bool                m_bAborted;
+  UInt                m_uiNumRemoved;
+  Void*               m_pvSync;   // mutex and condition variable
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_MULTIVIEWREFERENCESTORE_H__6B1E2C47_3F0A_4D8E_9C55_2A7D10E4B913__INCLUDED_)
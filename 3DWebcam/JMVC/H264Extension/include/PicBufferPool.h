@@ -0,0 +1,81 @@
+#if !defined(AFX_PICBUFFERPOOL_H__2F7D4B18_9C3E_4A65_B0D1_E84A6C53F927__INCLUDED_)
+#define AFX_PICBUFFERPOOL_H__2F7D4B18_9C3E_4A65_B0D1_E84A6C53F927__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+
+// Picture buffers of the encoder and decoder applications. All buffers are
+// allocated by init() in one block, each buffer starts at a multiple of
+// ALIGNMENT bytes; on Linux the block may be backed by huge pages. The
+// PicBuffer objects are kept in an array, so that the index of a returned
+// buffer follows from its address, and the free and the acquired buffers are
+// linked through index arrays: acquire() and release() take constant time.
+// The acquired buffers are linked in acquisition order for reclaim().
+class H264AVCVIDEOIOLIB_API PicBufferPool
+{
+  enum { ALIGNMENT = 64 };
+
+protected:
+  PicBufferPool();
+  virtual ~PicBufferPool();
+
+public:
+  static ErrVal create  ( PicBufferPool*& rpcPicBufferPool );
+  ErrVal        destroy ();
+
+  ErrVal  init          ( UInt        uiCapacity,
+                          UInt        uiBufferSize,
+                          Bool        bHugePages = false );
+  ErrVal  uninit        ();
+  Bool    isInitDone    ()  const { return m_bInitDone; }
+
+  // fails when all buffers are acquired
+  ErrVal  acquire       ( PicBuffer*& rpcPicBuffer );
+  // releasing a buffer that is not acquired has no effect
+  ErrVal  release       ( PicBuffer*  pcPicBuffer );
+  ErrVal  release       ( PicBufferList& rcPicBufferList );
+  // releases the oldest acquired buffers the library does not use any more (PicBuffer::isUsed),
+  // until at most uiMaxAcquired buffers are acquired
+  Void    reclaim       ( UInt        uiMaxAcquired );
+
+  UInt    getCapacity       ()  const { return m_uiCapacity; }
+  UInt    getBufferSize     ()  const { return m_uiBufferSize; }
+  UInt    getNumAcquired    ()  const { return m_uiNumAcquired; }
+  UInt    getHighWaterMark  ()  const { return m_uiHighWaterMark; }
+  UInt    getNumAcquires    ()  const { return m_uiNumAcquires; }
+  UInt    getNumReclaimed   ()  const { return m_uiNumReclaimed; }
+  Bool    isHugePageBacked  ()  const { return m_bHugePages; }
+
+  Void    printStatistics   ( const Char* pcName ) const;
+
+protected:
+  Int     xGetIndex     ( const PicBuffer* pcPicBuffer ) const;
+  Void    xUnlink       ( Int iIndex );
+  ErrVal  xAllocMemory  ( UInt uiSize, Bool bHugePages );
+  Void    xFreeMemory   ();
+
+protected:
+  UChar*      m_pucMemory;
+  UInt        m_uiMemorySize;
+  Bool        m_bMapped;            // m_pucMemory is a memory mapping
+  Bool        m_bHugePages;
+  PicBuffer*  m_pcPicBuffers;
+  Int*        m_piNext;             // next free buffer, or next acquired buffer in acquisition order
+  Int*        m_piPrev;             // previous acquired buffer
+  Bool*       m_pbAcquired;
+  Int         m_iFirstFree;
+  Int         m_iFirstAcquired;     // oldest acquired buffer
+  Int         m_iLastAcquired;
+  UInt        m_uiCapacity;
+  UInt        m_uiBufferSize;
+  UInt        m_uiNumAcquired;
+  UInt        m_uiHighWaterMark;
+  UInt        m_uiNumAcquires;
+  UInt        m_uiNumReclaimed;
+  Bool        m_bInitDone;
+};
+
+
+#endif // !defined(AFX_PICBUFFERPOOL_H__2F7D4B18_9C3E_4A65_B0D1_E84A6C53F927__INCLUDED_)
@@ -8,6 +8,7 @@
 #endif // _MSC_VER > 1000 
 
 
+#include <vector>
 #include "H264AVCVideoIoLib.h"
 #include "LargeFile.h"
 #include "ReadBitstreamIf.h"
@@ -17,9 +18,20 @@
 # pragma warning( disable: 4251 )
 #endif
 
+// The bitstream file is mapped into memory (copy-on-write) and init() indexes
+// the start codes of all NAL units, so positions are NAL unit indices and
+// rewinds do not touch the file. A NAL unit is returned as a view into the
+// mapping the first time it is extracted; the decoder converts the payload in
+// place, so one extracted again after a rewind, or one without PADDING
+// mapped bytes behind it, is read from the file into a buffer of its own.
+// Where the file cannot be mapped (it does not fit the address space, or it
+// is empty) the NAL units are read from the file in chunks and positions are
+// file offsets.
 class H264AVCVIDEOIOLIB_API ReadBitstreamFile : 
   public ReadBitstreamIf 
 {
+  enum { PADDING = 64 }; // readable bytes after the stream, the bit reader fetches words ahead
+
 protected:
 	ReadBitstreamFile(); 
 	virtual ~ReadBitstreamFile();
@@ -37,10 +49,29 @@ public:
   virtual ErrVal getPosition( Int& iPos );
   virtual ErrVal setPosition( Int  iPos );
 
-  virtual Int64  getFilePos() { return m_cFile.tell(); }
+  virtual Int64  getFilePos();
+
+  UInt   getNumNalUnits() const { return (UInt)m_cNalUnitStart.size(); }
+
+protected:
+  ErrVal xMapFile   ();
+  Void   xUnmapFile ();
+  ErrVal xIndexNalUnits();
+  ErrVal xReadPacket( BinData* pcBinData, Bool& rbEOS );
+  Bool   xIsView    ( const UChar* puc ) const { return m_bMapped && puc >= m_pucStream && puc < m_pucStream + m_uiMemorySize; }
+  static const UChar* xFindStartCode( const UChar* puc, const UChar* pucEnd );
 
 protected:
-  LargeFile m_cFile;
+  LargeFile           m_cFile;
+  UChar*              m_pucStream;
+  Int64               m_iStreamSize;
+  size_t              m_uiMemorySize;     // mapped bytes, the stream and the padding where there is one
+  Void*               m_pvFileMapping;    // file mapping object (Windows)
+  Bool                m_bMapped;          // m_pucStream is a memory mapping, otherwise the file is read in chunks
+  std::vector<Int64>  m_cNalUnitStart;    // offset of the byte after each start code
+  UInt                m_uiNextNalUnit;
+  UInt                m_uiNumViewed;      // the NAL units before it were returned as views
+  std::vector<BinData*> m_cFreeBinData;
 };
 
 #if defined( WIN32 )
@@ -0,0 +1,105 @@
+#if !defined(AFX_READBITSTREAMSTREAM_H__4C2D8E61_9B37_4F1A_8E05_7D3A21C6F594__INCLUDED_)
+#define AFX_READBITSTREAMSTREAM_H__4C2D8E61_9B37_4F1A_8E05_7D3A21C6F594__INCLUDED_
+
+
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+
+#include <map>
+#include <vector>
+#include "H264AVCVideoIoLib.h"
+#include "ReadBitstreamIf.h"
+
+
+#if defined( WIN32 )
+# pragma warning( disable: 4251 )
+#endif
+
+// Reads the byte stream of a live source, e.g. a network connection. One
+// thread (the producer) appends the bytes as they are received, the decoder
+// thread extracts the NAL units. The bytes are passed through a ring buffer
+// with a single producer and a single consumer, the data path takes no lock.
+// A NAL unit is complete when the start code of the next one has been
+// appended, when the producer marks the end of an access unit or when it
+// ends the stream, so that the decoder lags behind the source by one NAL
+// unit at most. extractPacket() waits for a complete NAL unit and append()
+// waits while the ring is full; a producer that must not block (e.g. a GUI
+// thread) uses tryAppend() and retries later. A stream cannot be rewound,
+// setPosition() only accepts the current position.
+class H264AVCVIDEOIOLIB_API ReadBitstreamStream :
+  public ReadBitstreamIf
+{
+  enum { PADDING = 64 }; // readable bytes after a NAL unit, the bit reader fetches words ahead
+
+protected:
+	ReadBitstreamStream();
+	virtual ~ReadBitstreamStream();
+
+public:
+  virtual ErrVal extractPacket( BinData*& rpcBinData, Bool& rbEOS );
+  virtual ErrVal releasePacket( BinData* pcBinData );
+
+  static ErrVal create( ReadBitstreamStream*& rpcReadBitstreamStream );
+  virtual ErrVal destroy();
+
+  // the ring size is rounded up to a power of two
+  ErrVal init( UInt uiRingSize );
+  virtual ErrVal uninit();
+
+  virtual ErrVal getPosition( Int& iPos );
+  virtual ErrVal setPosition( Int  iPos );
+
+  virtual Int64  getFilePos();
+
+  //===== producer thread =====
+  ErrVal append         ( const UChar* pucData, UInt uiSize );
+  // appends as many bytes as the ring has room for without waiting, ruiAppended may be less than uiSize
+  ErrVal tryAppend      ( const UChar* pucData, UInt uiSize, UInt& ruiAppended );
+  // the bytes appended so far end the current NAL unit (e.g. a received packet holds complete access units)
+  Void   endAccessUnit  ();
+  // no more bytes follow, extractPacket() returns the remaining NAL units and then the end of the stream;
+  // a decoder that stops reading calls it as well, a waiting append() then returns with an error
+  Void   endStream      ();
+
+protected:
+  UInt   xFindStartCode ( UInt uiPos, UInt uiEnd ) const;
+  UInt   xCopyToRing    ( const UChar* pucData, UInt uiSize );
+  Void   xCopyFromRing  ( UChar* puc, UInt uiPos, UInt uiSize ) const;
+  Void   xRelease       ( UInt uiPos );
+  Void   xWaitForData   ( UInt uiHead, UInt uiMarker );
+  Void   xWakeUp        ( volatile Bool& rbWaiting );
+  UChar* xGetBuffer     ( UInt uiSize );
+
+protected:
+  UChar*              m_pucRing;
+  UInt                m_uiRingSize;
+  UInt                m_uiMask;
+  volatile UInt       m_uiHead;             // appended bytes, written by the producer
+  volatile UInt       m_uiTail;             // released bytes, written by the consumer
+  volatile UInt       m_uiMarker;           // position of the last end of an access unit
+  volatile Bool       m_bEndOfStream;
+  volatile Bool       m_bConsumerWaiting;
+  volatile Bool       m_bProducerWaiting;
+
+  //===== consumer state =====
+  Bool                m_bInNalUnit;         // the start code of the current NAL unit was found
+  UInt                m_uiNalUnitStart;     // position of the byte after its start code
+  UInt                m_uiScan;             // no start code starts between the NAL unit start and this position
+  UInt                m_uiNumNalUnits;      // extracted NAL units
+  Int64               m_iStreamPos;         // bytes released before the tail
+
+  std::map<UChar*,UInt> m_cBufferSize;      // the packet buffers and their sizes
+  std::vector<UChar*>   m_cFreeBuffer;
+  std::vector<BinData*> m_cFreeBinData;
+  Void*               m_pvSync;             // mutex and condition variable, used to sleep only
+};
+
+#if defined( WIN32 )
+# pragma warning( default: 4251 )
+#endif
+
+
+#endif // !defined(AFX_READBITSTREAMSTREAM_H__4C2D8E61_9B37_4F1A_8E05_7D3A21C6F594__INCLUDED_)
@@ -18,6 +18,8 @@ public:
   virtual ErrVal writePacket( BinDataAccessor* pcBinDataAccessor, Bool bNewAU = false ) = 0;
   virtual ErrVal writePacket( BinData* pcBinData, Bool bNewAU = false ) = 0;
   virtual ErrVal writePacket( Void* pBuffer, UInt uiLength ) = 0;
+  // start code and NAL unit in one write
+  virtual ErrVal writeNalUnit( BinDataAccessor* pcStartCode, BinDataAccessor* pcNalUnit ) = 0;
   virtual LargeFile&getFile()=0; // Dec. 1
   
 };
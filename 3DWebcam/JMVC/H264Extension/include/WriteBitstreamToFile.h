@@ -37,6 +37,7 @@ public:
   virtual ErrVal writePacket( BinData* pcBinData, Bool bNewAU = false );
 
   virtual ErrVal writePacket( Void* pBuffer, UInt uiLength );
+  virtual ErrVal writeNalUnit( BinDataAccessor* pcStartCode, BinDataAccessor* pcNalUnit );
 
 private:
   UInt m_uiNumber;
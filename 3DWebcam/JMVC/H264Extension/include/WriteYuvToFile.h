@@ -6,6 +6,7 @@
 #endif // _MSC_VER > 1000
 
 
+#include <vector>
 #include "WriteYuvIf.h"
 #include "LargeFile.h"
 
@@ -66,6 +67,7 @@ protected:
 protected:
   LargeFile m_cFile;
   LargeFile *m_cFileMVC;
+  std::vector<std::string> m_cFileNameMVC; // opened at the first frame of the view
 
   Bool  m_bInitDone;
   BinData m_cTempBuffer;
@@ -0,0 +1,107 @@
+#include "H264AVCCommonLib.h"
+#include "H264AVCCommonLib/CpuInfo.h"
+
+#include <stdio.h>
+
+#if defined( H264AVC_X86_SIMD )
+#if defined( _MSC_VER )
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+UInt CpuInfo::m_uiSIMDFlags = CpuInfo::xDetectSIMDFlags();
+
+
+Void
+CpuInfo::reportMismatch( const Char* pcKernel )
+{
+  fprintf( stderr, "\nSIMD self check: %s differs from the scalar kernel\n", pcKernel );
+  AF();
+}
+
+
+#if defined( H264AVC_X86_SIMD )
+
+static Void xCpuid( UInt uiLeaf, UInt auiRegs[4] )
+{
+#if defined( _MSC_VER )
+  Int aiRegs[4];
+  __cpuidex( aiRegs, (Int)uiLeaf, 0 );
+  auiRegs[0] = (UInt)aiRegs[0];
+  auiRegs[1] = (UInt)aiRegs[1];
+  auiRegs[2] = (UInt)aiRegs[2];
+  auiRegs[3] = (UInt)aiRegs[3];
+#else
+  unsigned int a, b, c, d;
+  __cpuid_count( uiLeaf, 0, a, b, c, d );
+  auiRegs[0] = a;
+  auiRegs[1] = b;
+  auiRegs[2] = c;
+  auiRegs[3] = d;
+#endif
+}
+
+#if defined( H264AVC_X86_AVX2 )
+static UInt xGetXCR0()
+{
+#if defined( _MSC_VER )
+  return (UInt)_xgetbv( 0 );
+#else
+  unsigned int uiLow, uiHigh;
+  __asm__ __volatile__( "xgetbv" : "=a" (uiLow), "=d" (uiHigh) : "c" (0) );
+  return uiLow;
+#endif
+}
+#endif
+
+#endif
+
+
+UInt
+CpuInfo::xDetectSIMDFlags()
+{
+  UInt uiFlags = SIMD_NONE;
+
+#if defined( H264AVC_X86_SIMD )
+  UInt auiRegs[4];
+
+  xCpuid( 0, auiRegs );
+  UInt uiMaxLeaf = auiRegs[0];
+  ROTRS( uiMaxLeaf < 1, uiFlags );
+
+  xCpuid( 1, auiRegs );
+  if( auiRegs[3] & ( 1 << 26 ) )
+  {
+    uiFlags |= SIMD_SSE2;
+  }
+  if( auiRegs[2] & ( 1 << 9 ) )
+  {
+    uiFlags |= SIMD_SSSE3;
+  }
+
+#if defined( H264AVC_X86_AVX2 )
+  //===== AVX2 also needs the operating system to save the ymm registers =====
+  Bool bOSXSave = ( auiRegs[2] & ( 1 << 27 ) ) != 0;
+  Bool bAVX     = ( auiRegs[2] & ( 1 << 28 ) ) != 0;
+  if( bOSXSave && bAVX && uiMaxLeaf >= 7 && ( xGetXCR0() & 0x6 ) == 0x6 )
+  {
+    xCpuid( 7, auiRegs );
+    if( auiRegs[1] & ( 1 << 5 ) )
+    {
+      uiFlags |= SIMD_AVX2;
+    }
+  }
+#endif
+#endif
+
+  return uiFlags;
+}
+
+
+H264AVC_NAMESPACE_END
@@ -80,6 +80,7 @@ FrameMng::FrameMng()
 , m_pcQuarterPelFilter      ( NULL )
 , m_pcOriginalFrameUnit     ( NULL )
 , m_pcCurrentFrameUnit      ( NULL )
+, m_bHoldReleased           ( false )
 , m_codeAsVFrame (false)
 , m_uiLastViewId (0)
 {
@@ -132,6 +133,24 @@ __inline Bool FrameMng::xFindAndErase( FUList& rcFUList, FrameUnit* pcFrameUnit
 
 
 __inline ErrVal FrameMng::xAddToFreeList( FrameUnit* pcFrameUnit )
+{
+  if( m_bHoldReleased )
+  {
+    m_cHeldList.push_back( pcFrameUnit );
+    m_iEntriesInDPB--;
+    AOT_DBG( m_iEntriesInDPB < 0 );
+    return Err::m_nOK;
+  }
+
+  RNOK( xReleaseFrameUnit( pcFrameUnit ) );
+
+  m_iEntriesInDPB--;
+  AOT_DBG( m_iEntriesInDPB < 0 );
+  return Err::m_nOK;
+}
+
+
+__inline ErrVal FrameMng::xReleaseFrameUnit( FrameUnit* pcFrameUnit )
 {
   if( pcFrameUnit->getPicBuffer() )
   {
@@ -145,9 +164,17 @@ __inline ErrVal FrameMng::xAddToFreeList( FrameUnit* pcFrameUnit )
 
   RNOK( pcFrameUnit->uninit() );
   RNOK( m_cFrameUnitBuffer.releaseFrameUnit( pcFrameUnit ) );
+  return Err::m_nOK;
+}
 
-  m_iEntriesInDPB--;
-  AOT_DBG( m_iEntriesInDPB < 0 );
+
+ErrVal FrameMng::releaseHeldFrameUnits()
+{
+  for( FUIter iter = m_cHeldList.begin(); iter != m_cHeldList.end(); iter++ )
+  {
+    RNOK( xReleaseFrameUnit( *iter ) );
+  }
+  m_cHeldList.clear();
   return Err::m_nOK;
 }
 
@@ -242,6 +269,9 @@ ErrVal FrameMng::init( YuvBufferCtrl* pcYuvFullPelBufferCtrl, YuvBufferCtrl* pcY
 
 ErrVal FrameMng::uninit()
 {
+  m_bHoldReleased = false;
+  RNOK( releaseHeldFrameUnits() );
+
   if( NULL != m_pcRefinementIntFrame )
   {
     m_pcRefinementIntFrame->uninit();
@@ -640,7 +670,7 @@ ErrVal FrameMng::setPicBufferLists( PicBufferList& rcPicBufferOutputList, PicBuf
 }
 
 
-ErrVal FrameMng::storePicture( const SliceHeader& rcSH )
+ErrVal FrameMng::storePicture( const SliceHeader& rcSH, Bool bExtendFrame )
 {
   //===== memory managment =====
 #if JM_MVC_COMPATIBLE
@@ -654,7 +684,7 @@ ErrVal FrameMng::storePicture( const SliceHeader& rcSH )
   RNOK( xManageMemory( rcSH ) );
 
   //===== store current picture =====
-  RNOK( xStoreCurrentPicture( rcSH ) );
+  RNOK( xStoreCurrentPicture( rcSH, bExtendFrame ) );
 
   //===== set pictures for output =====
   RNOK( xSetOutputListMVC( m_pcCurrentFrameUnit, rcSH) );
@@ -1092,7 +1122,7 @@ ErrVal FrameMng::storeFGSPicture( PicBuffer* pcPicBuffer )
 }
 */
 
-ErrVal FrameMng::xStoreCurrentPicture( const SliceHeader& rcSH )
+ErrVal FrameMng::xStoreCurrentPicture( const SliceHeader& rcSH, Bool bExtendFrame )
 {
 	// Frame& cBaseFrame = m_pcCurrentFrameUnit->getFrame();
 	Frame& cBaseFrame = m_pcCurrentFrameUnit->getPic( rcSH.getPicType() ); //th fix
@@ -1109,9 +1139,20 @@ ErrVal FrameMng::xStoreCurrentPicture( const SliceHeader& rcSH )
 
   m_pcCurrentFrameUnit->addPic( eCurrPicType, bFieldCoded, rcSH.getIdrPicId() );
 
+  if( ! bExtendFrame )
+  {
+    //===== the caller pads the frame, only progressive frames without half-pel planes =====
+    ROF( FRAME == eCurrPicType && NULL == m_pcQuarterPelFilter && rcSH.getSPS().getFrameMbsOnlyFlag() );
+    m_pcCurrentFrameUnit->getTopField().setViewId( rcSH.getViewId() );
+    m_pcCurrentFrameUnit->getBotField().setViewId( rcSH.getViewId() );
+  }
+
   if( rcSH.getNalRefIdc() )
   {
+    if( bExtendFrame )
+    {
       RNOK( m_pcCurrentFrameUnit->getPic( eCurrPicType ).extendFrame( m_pcQuarterPelFilter, rcSH.getSPS().getFrameMbsOnlyFlag(), false ) );
+    }
 
       //===== store as short term picture =====
       m_pcCurrentFrameUnit->setFrameNumber( rcSH.getFrameNum() );
@@ -1121,7 +1162,10 @@ ErrVal FrameMng::xStoreCurrentPicture( const SliceHeader& rcSH )
   }
   else
   {
-	  RNOK( m_pcCurrentFrameUnit->getPic( eCurrPicType ).extendFrame( m_pcQuarterPelFilter, rcSH.getSPS().getFrameMbsOnlyFlag(), false ) );
+    if( bExtendFrame )
+    {
+	    RNOK( m_pcCurrentFrameUnit->getPic( eCurrPicType ).extendFrame( m_pcQuarterPelFilter, rcSH.getSPS().getFrameMbsOnlyFlag(), false ) );
+    }
       RNOK( xStoreNonRef( m_pcCurrentFrameUnit ) );
   }
   return Err::m_nOK;
@@ -20,6 +20,7 @@ FrameUnit::FrameUnit( YuvBufferCtrl& rcYuvFullPelBufferCtrl, YuvBufferCtrl& rcYu
 , m_bOriginal      ( bOriginal )
 , m_bInitDone      ( false )
 , m_BaseRepresentation ( false )   //JVT-S036 lsj
+, m_uiRowsDone     ( MSYS_UINT_MAX )
 {
     m_uiStatus = 0;
 }
@@ -55,6 +56,7 @@ ErrVal FrameUnit::init( const SliceHeader& rcSH, PicBuffer *pcPicBuffer )
 
     m_pcPicBuffer   = pcPicBuffer;
     m_uiFrameNumber = rcSH.getFrameNum();
+    m_uiRowsDone    = MSYS_UINT_MAX;
 
     RNOK( m_cFrame.   init( m_pcPicBuffer->getBuffer(), this ) );
     RNOK( m_cTopField.init( m_pcPicBuffer->getBuffer(), this ) );
@@ -93,6 +95,7 @@ ErrVal FrameUnit::init( const SliceHeader& rcSH, FrameUnit& rcFrameUnit )
     ROT( NULL != m_pcPicBuffer );
 
     m_uiFrameNumber = rcSH.getFrameNum();
+    m_uiRowsDone    = MSYS_UINT_MAX;
 
     RNOK( m_cFrame.   init( NULL, this ) );
     m_cFrame.getFullPelYuvBuffer()->copy( rcFrameUnit.getFrame().getFullPelYuvBuffer() );
@@ -144,6 +147,7 @@ ErrVal FrameUnit::copyBase( const SliceHeader& rcSH, FrameUnit& rcFrameUnit )
     ROT( NULL != m_pcPicBuffer );
 
     m_uiFrameNumber = rcSH.getFrameNum();
+    m_uiRowsDone    = MSYS_UINT_MAX;
 
     RNOK( m_cFrame.   init( NULL, this ) );
     m_cFrame.getFullPelYuvBuffer()->copy( rcFrameUnit.getFrame().getFullPelYuvBuffer() );
@@ -201,6 +201,7 @@ IntFrame::IntFrame( YuvBufferCtrl& rcYuvFullPelBufferCtrl,
                    m_pcIntFrameBotField( NULL ),//th
   m_bHalfPel              ( false ),
   m_bExtended             ( false ),
+  m_bBorrowed             ( false ),
   m_pcDPBUnit             ( 0 )
   , m_bUnusedForRef       ( false) // JVT-Q065 EIDR
   ,m_piChannelDistortion   ( 0 )     // JVT-R057 LA-RDO
@@ -209,6 +210,7 @@ IntFrame::IntFrame( YuvBufferCtrl& rcYuvFullPelBufferCtrl,
   m_iTopFieldPoc = m_iPOC*2;
   m_iBotFieldPoc = m_iPOC*2 + 1;    // give some random numbers
   m_uiViewId = 0;
+  m_pcMotionSeeds = NULL;
   m_ePicStat = NOT_SPECIFIED;
 }
 
@@ -302,6 +304,34 @@ ErrVal IntFrame::store( PicBuffer* pcPicBuffer )
   return Err::m_nOK;
 }
 
+ErrVal IntFrame::borrow( IntFrame* pcSrcFrame )
+{
+  ROT( m_bBorrowed );
+  ROF( pcSrcFrame->isHalfPel() && pcSrcFrame->isExtended() );
+  ROT( m_pcIntFrameTopField || m_pcIntFrameBotField );
+
+  RNOK( m_cFullPelYuvBuffer.borrow( pcSrcFrame->getFullPelYuvBuffer() ) );
+  RNOK( m_cHalfPelYuvBuffer.borrow( pcSrcFrame->getHalfPelYuvBuffer() ) );
+  m_bBorrowed = true;
+  m_bHalfPel  = true;
+  m_bExtended = true;
+
+  return Err::m_nOK;
+}
+
+ErrVal IntFrame::giveBack()
+{
+  ROF( m_bBorrowed );
+
+  RNOK( m_cFullPelYuvBuffer.giveBack() );
+  RNOK( m_cHalfPelYuvBuffer.giveBack() );
+  m_bBorrowed = false;
+  m_bHalfPel  = m_cHalfPelYuvBuffer.isValid();
+  m_bExtended = false;
+
+  return Err::m_nOK;
+}
+
 IntFrame* IntFrame::getPic( PicType ePicType)//th
 {
     switch( ePicType )
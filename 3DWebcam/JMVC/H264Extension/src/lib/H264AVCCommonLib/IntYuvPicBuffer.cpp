@@ -17,15 +17,16 @@ IntYuvPicBuffer::IntYuvPicBuffer( YuvBufferCtrl& rcYuvBufferCtrl, PicType ePicTy
 m_ePicType        ( ePicType ),
 m_rcYuvBufferCtrl ( rcYuvBufferCtrl ),
 m_iStride         ( 0 ),
-m_pPelCurrY       ( NULL ),
-m_pPelCurrU       ( NULL ),
-m_pPelCurrV       ( NULL ),
 m_pucYuvBuffer    ( NULL ),
-m_pucOwnYuvBuffer ( NULL )
+m_pucOwnYuvBuffer ( NULL ),
+m_bBorrowed       ( false ),
+m_pucSavedYuvBuffer( NULL ),
+m_iSavedStride    ( 0 )
 {
 #ifdef EXT_CHECK_1_GOP
     m_bExtended =false;
 #endif
+  xResetCurrBlk();
 }
 
 
@@ -35,6 +36,17 @@ IntYuvPicBuffer::~IntYuvPicBuffer()
 }
 
 
+Void IntYuvPicBuffer::xResetCurrBlk()
+{
+  for( UInt uiLane = 0; uiLane < MAX_WAVEFRONT_LANES; uiLane++ )
+  {
+    m_apPelCurrY[uiLane] = NULL;
+    m_apPelCurrU[uiLane] = NULL;
+    m_apPelCurrV[uiLane] = NULL;
+  }
+}
+
+
 
 ErrVal
 IntYuvPicBuffer::init( XPel*& rpucYuvBuffer )
@@ -300,15 +312,44 @@ ErrVal IntYuvPicBuffer::uninit()
   }
   m_pucYuvBuffer    = NULL;
   m_pucOwnYuvBuffer = NULL;
-  m_pPelCurrY       = NULL;
-  m_pPelCurrU       = NULL;
-  m_pPelCurrV       = NULL;
+  xResetCurrBlk();
   m_iStride         = 0;
 
   return Err::m_nOK;
 }
 
 
+ErrVal IntYuvPicBuffer::borrow( IntYuvPicBuffer* pcSrcYuvPicBuffer )
+{
+  ROT( m_bBorrowed );
+  ROF( pcSrcYuvPicBuffer->m_pucYuvBuffer );
+  ROF( m_rcBufferParam.getStride() == pcSrcYuvPicBuffer->m_iStride );
+
+  m_bBorrowed         = true;
+  m_pucSavedYuvBuffer = m_pucYuvBuffer;
+  m_iSavedStride      = m_iStride;
+  m_pucYuvBuffer      = pcSrcYuvPicBuffer->m_pucYuvBuffer;
+  m_iStride           = pcSrcYuvPicBuffer->m_iStride;
+  xResetCurrBlk();
+
+  return Err::m_nOK;
+}
+
+
+ErrVal IntYuvPicBuffer::giveBack()
+{
+  ROF( m_bBorrowed );
+
+  m_bBorrowed         = false;
+  m_pucYuvBuffer      = m_pucSavedYuvBuffer;
+  m_iStride           = m_iSavedStride;
+  m_pucSavedYuvBuffer = NULL;
+  xResetCurrBlk();
+
+  return Err::m_nOK;
+}
+
+
 ErrVal IntYuvPicBuffer::loadBuffer( IntYuvMbBuffer *pcYuvMbBuffer )
 {
   XPel* pDes        = getMbLumAddr();
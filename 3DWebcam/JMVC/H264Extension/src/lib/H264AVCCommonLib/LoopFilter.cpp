@@ -88,14 +88,24 @@ const LoopFilter::AlphaClip LoopFilter::g_acAlphaClip[52] =
 
 LoopFilter::LoopFilter() :
 m_pcControlMngIf( NULL ),
-m_pcRecFrameUnit( NULL )
+m_pcRecFrameUnit( NULL ),
+m_bSelfCheck( false ),
+m_pcMbEdgeParameter( NULL ),
+m_piRowProgress( NULL ),
+m_uiMaxMbInPic( 0 ),
+m_uiMaxMbInCol( 0 ),
+m_pcMbDataAccess( NULL )
 {
     m_eLFMode  = LFM_DEFAULT_FILTER;
     m_apcIntYuvBuffer[0] = m_apcIntYuvBuffer[1] = m_apcIntYuvBuffer[2] = m_apcIntYuvBuffer[3] = NULL;
+    ::memset( m_aafpEdgeFilterFunc,  0x00, sizeof( m_aafpEdgeFilterFunc  ) );
+    ::memset( m_aafpXEdgeFilterFunc, 0x00, sizeof( m_aafpXEdgeFilterFunc ) );
 }
 
 LoopFilter::~LoopFilter()
 {
+    xDeleteEdgeParameters();
+    H264AVC_DELETE_CLASS( m_pcMbDataAccess );
 }
 
 ErrVal LoopFilter::create( LoopFilter*& rpcLoopFilter )
@@ -116,6 +126,8 @@ ErrVal LoopFilter::destroy()
 
 ErrVal LoopFilter::init(  ControlMngIf* pcControlMngIf
                         ,ReconstructionBypass*       pcReconstructionBypass
+                        ,UInt                        uiSIMDFlags
+                        ,Bool                        bSelfCheck
                         )
 {
     ROT( NULL == pcControlMngIf );
@@ -124,13 +136,65 @@ ErrVal LoopFilter::init(  ControlMngIf* pcControlMngIf
 
     m_pcControlMngIf  = pcControlMngIf;
     m_pcHighpassFrame = NULL; // Hanke@RWTH
+    m_bSelfCheck      = bSelfCheck;
 
+    xInitSIMDFunctions( uiSIMDFlags & CpuInfo::getSIMDFlags() );
     return Err::m_nOK;
 }
 
 ErrVal LoopFilter::uninit()
 {
     m_pcControlMngIf = NULL;
+    ::memset( m_aafpEdgeFilterFunc,  0x00, sizeof( m_aafpEdgeFilterFunc  ) );
+    ::memset( m_aafpXEdgeFilterFunc, 0x00, sizeof( m_aafpXEdgeFilterFunc ) );
+    xDeleteEdgeParameters();
+    H264AVC_DELETE_CLASS( m_pcMbDataAccess );
+    return Err::m_nOK;
+}
+
+ErrVal LoopFilter::filterRows( SliceHeader& rcSH, MbDataCtrl* pcMbDataCtrl, UInt uiStartRow, UInt uiStopRow )
+{
+    ROT( NULL == pcMbDataCtrl );
+    ROT( rcSH.isMbAff() || FRAME != rcSH.getPicType() );
+
+    const UInt uiMbInRow = rcSH.getSPS().getFrameWidthInMbs();
+    const UInt uiMbInCol = rcSH.getMbInPic() / uiMbInRow;
+    ROT( uiStopRow > uiMbInCol );
+    ROTRS( uiStartRow >= uiStopRow, Err::m_nOK );
+    RNOK( xAllocEdgeParameters( uiMbInRow, uiMbInCol ) );
+
+    m_pcRecFrameUnit = rcSH.getFrameUnit();
+    m_bVerMixedMode  = false;
+    m_bHorMixedMode  = false;
+
+    YuvPicBuffer* pcYuvBuffer = m_pcRecFrameUnit->getPic( FRAME ).getFullPelYuvBuffer();
+    Pel*          pLum        = pcYuvBuffer->getLumOrigin();
+    Pel*          pCb         = pcYuvBuffer->getCbOrigin ();
+    Pel*          pCr         = pcYuvBuffer->getCrOrigin ();
+    const Int     iLStride    = pcYuvBuffer->getLStride  ();
+    const Int     iCStride    = pcYuvBuffer->getCStride  ();
+
+    for( UInt uiMbY = uiStartRow; uiMbY < uiStopRow; uiMbY++ )
+    {
+        //===== strengths of the row, then its macroblocks from left to right as in process() =====
+        MbEdgeParameter* pcRowParam = m_pcMbEdgeParameter + uiMbY * uiMbInRow;
+        UInt             uiMbX;
+        for( uiMbX = 0; uiMbX < uiMbInRow; uiMbX++ )
+        {
+            const UChar ucQp = (UChar)pcMbDataCtrl->getMbData( uiMbX, uiMbY ).getQp();
+            RNOK( pcMbDataCtrl->initMbForPipeline( m_pcMbDataAccess, rcSH, uiMbY, uiMbX, ucQp, true ) );
+            RNOK( xGetEdgeParameterFast( *m_pcMbDataAccess, pcRowParam[uiMbX] ) );
+        }
+        for( uiMbX = 0; uiMbX < uiMbInRow; uiMbX++ )
+        {
+            xFilterMbEdges( pcRowParam[uiMbX],
+                            pLum + 16 * ( uiMbY * iLStride + uiMbX ),
+                            pCb  +  8 * ( uiMbY * iCStride + uiMbX ),
+                            pCr  +  8 * ( uiMbY * iCStride + uiMbX ),
+                            iLStride, iCStride );
+        }
+    }
+
     return Err::m_nOK;
 }
 
@@ -161,6 +225,39 @@ ErrVal LoopFilter::process( SliceHeader& rcSH, IntFrame* pcIntFrame )
     m_bHorMixedMode = false;
     const Bool bLF_INTERLACE = rcSH.isMbAff();
 
+    if( ! bLF_INTERLACE )
+    {
+        //===== strengths of all macroblocks in raster scan, then the MB rows in parallel =====
+        const UInt uiMbInRow = rcSH.getSPS().getFrameWidthInMbs();
+        const UInt uiMbInCol = uiMaxMbAddress / uiMbInRow;
+        RNOK( xAllocEdgeParameters( uiMbInRow, uiMbInCol ) );
+
+        for( UInt uiMbAddress = 0; uiMbAddress < uiMaxMbAddress; uiMbAddress++ )
+        {
+            MbDataAccess* pcMbDataAccess;
+            UInt uiMbX, uiMbY, uiMbIndex;
+            rcSH.getMbPositionFromAddress( uiMbY, uiMbX, uiMbIndex, uiMbAddress );
+            RNOK( m_pcControlMngIf->initMbForFiltering( pcMbDataAccess, uiMbY, uiMbX, bLF_INTERLACE ) );
+            RNOK( xGetEdgeParameterFast( *pcMbDataAccess, m_pcMbEdgeParameter[uiMbAddress] ) );
+        }
+
+        if( m_apcIntYuvBuffer[FRAME] )
+        {
+            IntYuvPicBuffer* pcYuvBuffer = m_apcIntYuvBuffer[FRAME];
+            xFilterPicture( pcYuvBuffer->getLumOrigin(), pcYuvBuffer->getCbOrigin(), pcYuvBuffer->getCrOrigin(),
+                            pcYuvBuffer->getLStride(), pcYuvBuffer->getCStride(), uiMbInRow, uiMbInCol );
+        }
+        else
+        {
+            YuvPicBuffer* pcYuvBuffer = m_pcRecFrameUnit->getPic( rcSH.getPicType() ).getFullPelYuvBuffer();
+            xFilterPicture( pcYuvBuffer->getLumOrigin(), pcYuvBuffer->getCbOrigin(), pcYuvBuffer->getCrOrigin(),
+                            pcYuvBuffer->getLStride(), pcYuvBuffer->getCStride(), uiMbInRow, uiMbInCol );
+        }
+
+        m_apcIntYuvBuffer[TOP_FIELD] = m_apcIntYuvBuffer[BOT_FIELD] = m_apcIntYuvBuffer[FRAME] = NULL;
+        return Err::m_nOK;
+    }
+
     //===== loop over macroblocks use raster scan =====
     for( UInt uiMbAddress = 0; uiMbAddress < uiMaxMbAddress; uiMbAddress++ )
     {
@@ -213,6 +310,224 @@ ErrVal LoopFilter::xFilterMbFast( const MbDataAccess& rcMbDataAccess )
     return Err::m_nOK;
 }
 
+ErrVal LoopFilter::xAllocEdgeParameters( UInt uiMbInRow, UInt uiMbInCol )
+{
+    ROTRS( uiMbInRow * uiMbInCol <= m_uiMaxMbInPic && uiMbInCol <= m_uiMaxMbInCol, Err::m_nOK );
+
+    xDeleteEdgeParameters();
+
+    m_pcMbEdgeParameter = new MbEdgeParameter[ uiMbInRow * uiMbInCol ];
+    m_piRowProgress     = new Int            [ uiMbInCol ];
+    ROT( NULL == m_pcMbEdgeParameter );
+    ROT( NULL == m_piRowProgress );
+
+    m_uiMaxMbInPic = uiMbInRow * uiMbInCol;
+    m_uiMaxMbInCol = uiMbInCol;
+    return Err::m_nOK;
+}
+
+Void LoopFilter::xDeleteEdgeParameters()
+{
+    delete [] m_pcMbEdgeParameter;
+    delete [] const_cast<Int*>( m_piRowProgress );
+    m_pcMbEdgeParameter = NULL;
+    m_piRowProgress     = NULL;
+    m_uiMaxMbInPic      = 0;
+    m_uiMaxMbInCol      = 0;
+}
+
+ErrVal LoopFilter::xGetEdgeParameterFast( const MbDataAccess& rcMbDataAccess, MbEdgeParameter& rcParam )
+{
+    const DFP& rcDFP      = rcMbDataAccess.getDeblockingFilterParameter();
+    const Int iFilterIdc  = rcDFP.getDisableDeblockingFilterIdc();
+
+    ::memset( &rcParam, 0x00, sizeof( MbEdgeParameter ) );
+    ROTRS( iFilterIdc == 1, Err::m_nOK );
+
+    xGetFilterStrengthFast( rcMbDataAccess, iFilterIdc );
+    xSetEdgeParameter( rcMbDataAccess, rcDFP, rcParam );
+
+    return Err::m_nOK;
+}
+
+Void LoopFilter::xSetEdgeParameter( const MbDataAccess& rcMbDataAccess, const DFP& rcDFP, MbEdgeParameter& rcParam )
+{
+    //===== strengths are stored along the edges =====
+    for( Int iEdge = 0; iEdge < 4; iEdge++ )
+    {
+        for( Int iSeg = 0; iSeg < 4; iSeg++ )
+        {
+            rcParam.aaaucBs[VER][iEdge][iSeg] = m_aaaucBs[VER][iEdge][iSeg];
+            rcParam.aaaucBs[HOR][iEdge][iSeg] = m_aaaucBs[HOR][iSeg][iEdge];
+        }
+    }
+
+    //===== same QPs as in x{Luma,Chroma}{Ver,Hor}Filtering without mixed mode =====
+    const Int iCurrQp  = rcMbDataAccess.getMbDataCurr().getQpLF();
+    const Int iLeftQp  = rcMbDataAccess.getMbDataLeft().getQpLF();
+    const Int iAboveQp = rcMbDataAccess.getMbData().getFieldFlag() && (!rcMbDataAccess.isTopMb()||rcMbDataAccess.getMbDataAboveAbove().getFieldFlag()) ?
+        rcMbDataAccess.getMbDataAboveAbove().getQpLF():
+    rcMbDataAccess.getMbDataAbove().getQpLF();
+    const Int iCurrQpC = rcMbDataAccess.getSH().getChromaQp( iCurrQp );
+
+    const Int aaiQp[2][3] =
+    {
+        { ( iLeftQp + iCurrQp + 1 ) >> 1, ( iAboveQp + iCurrQp + 1 ) >> 1, iCurrQp },
+        { ( rcMbDataAccess.getSH().getChromaQp( iLeftQp  ) + iCurrQpC + 1 ) >> 1,
+          ( rcMbDataAccess.getSH().getChromaQp( iAboveQp ) + iCurrQpC + 1 ) >> 1, iCurrQpC }
+    };
+    for( Int iComp = 0; iComp < 2; iComp++ )
+    {
+        for( Int iKind = 0; iKind < 3; iKind++ )
+        {
+            rcParam.aaaucIndex[iComp][iKind][0] = gClipMinMax( rcDFP.getSliceAlphaC0Offset() + aaiQp[iComp][iKind], 0, 51 );
+            rcParam.aaaucIndex[iComp][iKind][1] = gClipMinMax( rcDFP.getSliceBetaOffset()    + aaiQp[iComp][iKind], 0, 51 );
+        }
+    }
+}
+
+template< typename TPel >
+Void LoopFilter::xFilterPicture( TPel* pLum, TPel* pCb, TPel* pCr, Int iLStride, Int iCStride, UInt uiMbInRow, UInt uiMbInCol )
+{
+    const Int iMbInRow = (Int)uiMbInRow;
+    const Int iMbInCol = (Int)uiMbInCol;
+
+    for( Int iMbY = 0; iMbY < iMbInCol; iMbY++ )
+    {
+        m_piRowProgress[iMbY] = 0;
+    }
+
+    //===== the left edge of a macroblock modifies the right columns of its left neighbour, so that =====
+    //===== a macroblock is filtered when the row above is finished up to the macroblock above right =====
+#pragma omp parallel for schedule( dynamic, 1 )
+    for( Int iMbY = 0; iMbY < iMbInCol; iMbY++ )
+    {
+        for( Int iMbX = 0; iMbX < iMbInRow; iMbX++ )
+        {
+            if( iMbY > 0 )
+            {
+                const Int iRequired = min( iMbX + 2, iMbInRow );
+                while( m_piRowProgress[iMbY-1] < iRequired )
+                {
+#pragma omp flush
+                }
+            }
+
+            xFilterMbEdges( m_pcMbEdgeParameter[iMbY*iMbInRow+iMbX],
+                            pLum + 16 * ( iMbY * iLStride + iMbX ),
+                            pCb  +  8 * ( iMbY * iCStride + iMbX ),
+                            pCr  +  8 * ( iMbY * iCStride + iMbX ),
+                            iLStride, iCStride );
+#pragma omp flush
+            m_piRowProgress[iMbY] = iMbX + 1;
+#pragma omp flush
+        }
+    }
+}
+
+template< typename TPel >
+Void LoopFilter::xFilterMbEdges( const MbEdgeParameter& rcParam, TPel* pLum, TPel* pCb, TPel* pCr, Int iLStride, Int iCStride )
+{
+    UInt uiEdge;
+
+    //===== luma: vertical edges, then horizontal edges =====
+    for( uiEdge = 0; uiEdge < 4; uiEdge++ )
+    {
+        const UChar* pucIndex = rcParam.aaaucIndex[0][ uiEdge ? 2 : 0 ];
+        xFilterEdge( xGetEdgeFilterFunc( pLum, 0, VER ), pLum + 4*uiEdge, iLStride, true,
+                     rcParam.aaaucBs[VER][uiEdge], pucIndex[0], pucIndex[1], true );
+    }
+    for( uiEdge = 0; uiEdge < 4; uiEdge++ )
+    {
+        const UChar* pucIndex = rcParam.aaaucIndex[0][ uiEdge ? 2 : 1 ];
+        xFilterEdge( xGetEdgeFilterFunc( pLum, 0, HOR ), pLum + 4*uiEdge*iLStride, iLStride, false,
+                     rcParam.aaaucBs[HOR][uiEdge], pucIndex[0], pucIndex[1], true );
+    }
+
+    //===== chroma: the luma strengths of the edges 0 and 2 =====
+    for( uiEdge = 0; uiEdge < 4; uiEdge += 2 )
+    {
+        const UChar* pucIndex = rcParam.aaaucIndex[1][ uiEdge ? 2 : 0 ];
+        xFilterEdge( xGetEdgeFilterFunc( pCb, 1, VER ), pCb + 2*uiEdge, iCStride, true,
+                     rcParam.aaaucBs[VER][uiEdge], pucIndex[0], pucIndex[1], false );
+        xFilterEdge( xGetEdgeFilterFunc( pCr, 1, VER ), pCr + 2*uiEdge, iCStride, true,
+                     rcParam.aaaucBs[VER][uiEdge], pucIndex[0], pucIndex[1], false );
+    }
+    for( uiEdge = 0; uiEdge < 4; uiEdge += 2 )
+    {
+        const UChar* pucIndex = rcParam.aaaucIndex[1][ uiEdge ? 2 : 1 ];
+        xFilterEdge( xGetEdgeFilterFunc( pCb, 1, HOR ), pCb + 2*uiEdge*iCStride, iCStride, false,
+                     rcParam.aaaucBs[HOR][uiEdge], pucIndex[0], pucIndex[1], false );
+        xFilterEdge( xGetEdgeFilterFunc( pCr, 1, HOR ), pCr + 2*uiEdge*iCStride, iCStride, false,
+                     rcParam.aaaucBs[HOR][uiEdge], pucIndex[0], pucIndex[1], false );
+    }
+}
+
+template< typename TPel, typename TEdgeFilterFunc >
+Void LoopFilter::xFilterEdge( TEdgeFilterFunc fpEdgeFilter, TPel* pFlt, Int iStride, Bool bVer, const UChar* pucBs, Int iIndexA, Int iIndexB, Bool bLum )
+{
+    ROFVS( pucBs[0] | pucBs[1] | pucBs[2] | pucBs[3] );
+
+    const Int iStep   = ( bVer ? iStride : 1 );
+    const Int iOffset = ( bVer ? 1 : iStride );
+
+    if( NULL == fpEdgeFilter )
+    {
+        xFilterEdgeScalar( pFlt, iStep, iOffset, pucBs, iIndexA, iIndexB, bLum );
+        return;
+    }
+    if( ! m_bSelfCheck )
+    {
+        fpEdgeFilter( pFlt, iStride, pucBs, iIndexA, iIndexB );
+        return;
+    }
+
+    //===== self check against the scalar filter on a copy of the 8 samples across the edge =====
+    const Int iLength = ( bLum ? 16 : 8 );
+    TPel      aRef[16*8];
+    Int       i, k;
+    for( i = 0; i < iLength; i++ )
+    {
+        for( k = -4; k < 4; k++ )
+        {
+            aRef[8*i+4+k] = pFlt[i*iStep+k*iOffset];
+        }
+    }
+    xFilterEdgeScalar( aRef + 4, 8, 1, pucBs, iIndexA, iIndexB, bLum );
+    fpEdgeFilter( pFlt, iStride, pucBs, iIndexA, iIndexB );
+
+    for( i = 0; i < iLength; i++ )
+    {
+        for( k = -4; k < 4; k++ )
+        {
+            if( aRef[8*i+4+k] != pFlt[i*iStep+k*iOffset] )
+            {
+                CpuInfo::reportMismatch( "LoopFilter::xFilterEdge" );
+                pFlt[i*iStep+k*iOffset] = aRef[8*i+4+k];
+            }
+        }
+    }
+}
+
+template< typename TPel >
+Void LoopFilter::xFilterEdgeScalar( TPel* pFlt, Int iStep, Int iOffset, const UChar* pucBs, Int iIndexA, Int iIndexB, Bool bLum )
+{
+    const Int iSegLength = ( bLum ? 4 : 2 );
+
+    for( Int iSeg = 0; iSeg < 4; iSeg++ )
+    {
+        const UChar ucBs = pucBs[iSeg];
+        if( 0 != ucBs )
+        {
+            for( Int i = 0; i < iSegLength; i++ )
+            {
+                xFilter( pFlt + i*iStep, iOffset, iIndexA, iIndexB, ucBs, bLum );
+            }
+        }
+        pFlt += iSegLength*iStep;
+    }
+}
+
 ErrVal LoopFilter::xGetFilterStrengthFast( const MbDataAccess& rcMbDataAccess, const Int iFilterIdc )
 {
     const MbData& rcMbData = rcMbDataAccess.getMbData();
@@ -1443,6 +1758,16 @@ ErrVal LoopFilter::process( SliceHeader&  rcSH,
 
 
     Bool bLF_INTERLACE = rcSH.isMbAff();
+
+    //===== frames without MBAFF: strengths of all macroblocks in raster scan, then the MB rows in parallel =====
+    const Bool bTwoPass  = ( ! bLF_INTERLACE && FRAME == rcSH.getPicType() &&
+                             0 == ( m_eLFMode & ( LFM_NO_FILTER | LFM_EXTEND_INTRA_SUR ) ) );
+    const UInt uiMbInCol = uiMaxMbAddress / rcSH.getSPS().getFrameWidthInMbs();
+    if( bTwoPass )
+    {
+        RNOK( xAllocEdgeParameters( rcSH.getSPS().getFrameWidthInMbs(), uiMbInCol ) );
+    }
+
     //===== loop over macroblocks use raster scan =====
     for( UInt uiMbAddress = 0; uiMbAddress < uiMaxMbAddress; uiMbAddress++ )
     {
@@ -1479,7 +1804,8 @@ ErrVal LoopFilter::process( SliceHeader&  rcSH,
                 apcFrame[eMbPicType]->getFullPelYuvBuffer(),
                 apcRefFrameList0[eMbPicType],
                 apcRefFrameList1[eMbPicType],
-                spatial_scalable_flg ) );  // SSUN@SHARP
+                spatial_scalable_flg,  // SSUN@SHARP
+                bTwoPass ? &m_pcMbEdgeParameter[uiMbAddress] : NULL ) );
         }
 
         if( m_eLFMode & LFM_EXTEND_INTRA_SUR )
@@ -1505,6 +1831,13 @@ ErrVal LoopFilter::process( SliceHeader&  rcSH,
 
     }
 
+    if( bTwoPass )
+    {
+        IntYuvPicBuffer* pcYuvBuffer = pcFrame->getFullPelYuvBuffer();
+        xFilterPicture( pcYuvBuffer->getLumOrigin(), pcYuvBuffer->getCbOrigin(), pcYuvBuffer->getCrOrigin(),
+                        pcYuvBuffer->getLStride(), pcYuvBuffer->getCStride(), rcSH.getSPS().getFrameWidthInMbs(), uiMbInCol );
+    }
+
     // Hanke@RWTH: Reset pointer
     setHighpassFramePointer();
 
@@ -1546,11 +1879,16 @@ __inline ErrVal LoopFilter::xFilterMb( MbDataAccess*  pcMbDataAccessMot,
                                       IntYuvPicBuffer*     pcYuvBuffer,
                                       RefFrameList*        pcRefFrameList0,
                                       RefFrameList*        pcRefFrameList1,
-                                      bool                 spatial_scalable_flg)  // SSUN@SHARP
+                                      bool                 spatial_scalable_flg,  // SSUN@SHARP
+                                      MbEdgeParameter*     pcEdgeParameter )
 {
     const DFP& rcDFP      = pcMbDataAccessRes->getDeblockingFilterParameter();
     const Int iFilterIdc  = rcDFP.getDisableDeblockingFilterIdc();
 
+    if( pcEdgeParameter )
+    {
+        ::memset( pcEdgeParameter, 0x00, sizeof( MbEdgeParameter ) );
+    }
     ROTRS( iFilterIdc == 1, Err::m_nOK );
 
     ROTRS( (m_eLFMode & LFM_NO_INTER_FILTER) && ! pcMbDataAccessRes->getMbData().isIntra(), Err::m_nOK );
@@ -1642,6 +1980,15 @@ __inline ErrVal LoopFilter::xFilterMb( MbDataAccess*  pcMbDataAccessMot,
         }
     }
     m_bHorMixedMode  = m_bHorMixedMode && bCurrFrame;
+
+    if( pcEdgeParameter )
+    {
+        //===== filtered later by xFilterPicture =====
+        AOT_DBG( m_bVerMixedMode || m_bHorMixedMode );
+        xSetEdgeParameter( *pcMbDataAccessRes, rcDFP, *pcEdgeParameter );
+        return Err::m_nOK;
+    }
+
     RNOK( xLumaVerFiltering(   *pcMbDataAccessRes, rcDFP, pcYuvBuffer ) );
     RNOK( xLumaHorFiltering(   *pcMbDataAccessRes, rcDFP, pcYuvBuffer ) );
     RNOK( xChromaVerFiltering( *pcMbDataAccessRes, rcDFP, pcYuvBuffer ) );
@@ -0,0 +1,369 @@
+#include "H264AVCCommonLib.h"
+#include "H264AVCCommonLib/MbDataCtrl.h"
+#include "H264AVCCommonLib/LoopFilter.h"
+
+#if defined( H264AVC_X86_SIMD )
+#include <emmintrin.h>
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+// The SIMD edge filters give the same results as LoopFilter::xFilter for
+// 8 bit samples, which is what the scalar code assumes as well ( gClip ):
+//
+// - Every sample across an edge is a 16 bit lane, 8 samples along the edge
+//   are filtered at once. The largest intermediate value is the sum of the
+//   strong luma filter, 8 * 255 + 4, so 16 bit lanes do not overflow.
+// - The filter decisions ( alpha, beta, bS ) are made per lane and select
+//   between the unfiltered, the normal and the strong result, the same
+//   way the early returns of the scalar code do.
+// - Vertical edges are transposed in registers. Luma rows are loaded and
+//   stored with the 4 samples on both sides of the edge, of which the scalar
+//   code reads all and modifies 3. Chroma rows use 2 samples on both sides.
+
+
+#if defined( H264AVC_X86_SIMD )
+
+//===== loads and stores of 8 or 4 samples as 16 bit lanes =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad8( const Pel* p )
+{
+    return _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i*)p ), _mm_setzero_si128() );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad8( const XPel* p )
+{
+    return _mm_loadu_si128( (const __m128i*)p );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad4( const Pel* p )
+{
+    Int i;
+    ::memcpy( &i, p, sizeof( i ) );
+    return _mm_unpacklo_epi8( _mm_cvtsi32_si128( i ), _mm_setzero_si128() );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad4( const XPel* p )
+{
+    return _mm_loadl_epi64( (const __m128i*)p );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore8( Pel* p, __m128i v )
+{
+    _mm_storel_epi64( (__m128i*)p, _mm_packus_epi16( v, v ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore8( XPel* p, __m128i v )
+{
+    _mm_storeu_si128( (__m128i*)p, v );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore4( Pel* p, __m128i v )
+{
+    Int i = _mm_cvtsi128_si32( _mm_packus_epi16( v, v ) );
+    ::memcpy( p, &i, sizeof( i ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore4( XPel* p, __m128i v )
+{
+    _mm_storel_epi64( (__m128i*)p, v );
+}
+
+//===== rows <-> columns of 8x8 16 bit samples =====
+SIMD_TARGET( "sse2" )
+static inline Void xTranspose8x8( __m128i ai[8] )
+{
+    const __m128i a0 = _mm_unpacklo_epi16( ai[0], ai[1] );
+    const __m128i a1 = _mm_unpackhi_epi16( ai[0], ai[1] );
+    const __m128i a2 = _mm_unpacklo_epi16( ai[2], ai[3] );
+    const __m128i a3 = _mm_unpackhi_epi16( ai[2], ai[3] );
+    const __m128i a4 = _mm_unpacklo_epi16( ai[4], ai[5] );
+    const __m128i a5 = _mm_unpackhi_epi16( ai[4], ai[5] );
+    const __m128i a6 = _mm_unpacklo_epi16( ai[6], ai[7] );
+    const __m128i a7 = _mm_unpackhi_epi16( ai[6], ai[7] );
+    const __m128i b0 = _mm_unpacklo_epi32( a0, a2 );
+    const __m128i b1 = _mm_unpackhi_epi32( a0, a2 );
+    const __m128i b2 = _mm_unpacklo_epi32( a1, a3 );
+    const __m128i b3 = _mm_unpackhi_epi32( a1, a3 );
+    const __m128i b4 = _mm_unpacklo_epi32( a4, a6 );
+    const __m128i b5 = _mm_unpackhi_epi32( a4, a6 );
+    const __m128i b6 = _mm_unpacklo_epi32( a5, a7 );
+    const __m128i b7 = _mm_unpackhi_epi32( a5, a7 );
+    ai[0] = _mm_unpacklo_epi64( b0, b4 );
+    ai[1] = _mm_unpackhi_epi64( b0, b4 );
+    ai[2] = _mm_unpacklo_epi64( b1, b5 );
+    ai[3] = _mm_unpackhi_epi64( b1, b5 );
+    ai[4] = _mm_unpacklo_epi64( b2, b6 );
+    ai[5] = _mm_unpackhi_epi64( b2, b6 );
+    ai[6] = _mm_unpacklo_epi64( b3, b7 );
+    ai[7] = _mm_unpackhi_epi64( b3, b7 );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xAbsDiff( __m128i a, __m128i b )
+{
+    return _mm_max_epi16( _mm_sub_epi16( a, b ), _mm_sub_epi16( b, a ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xClip3( __m128i v, __m128i vMin, __m128i vMax )
+{
+    return _mm_min_epi16( _mm_max_epi16( v, vMin ), vMax );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xSelect( __m128i vMask, __m128i a, __m128i b )
+{
+    return _mm_or_si128( _mm_and_si128( vMask, a ), _mm_andnot_si128( vMask, b ) );
+}
+
+//===== strengths and clipping values of 8 lanes, iSegLength lanes per strength =====
+SIMD_TARGET( "sse2" )
+static inline Void xGetLaneParameters( const UChar* pucBs, Int iSegLength, Int iIndexA, __m128i& rvBs, __m128i& rvTc0 )
+{
+    const UChar* pucClip = LoopFilter::g_acAlphaClip[ iIndexA ].aucClip;
+    Short asBs[8], asTc0[8];
+    for( Int i = 0; i < 8; i++ )
+    {
+        asBs [i] = pucBs[ i / iSegLength ];
+        asTc0[i] = pucClip[ asBs[i] ];
+    }
+    rvBs  = _mm_loadu_si128( (const __m128i*)asBs  );
+    rvTc0 = _mm_loadu_si128( (const __m128i*)asTc0 );
+}
+
+//===== filters 8 lanes of p3 ... q3, chroma uses p1 ... q1 only =====
+template< Bool bLum >
+SIMD_TARGET( "sse2" )
+static inline Void xFilterLanes( __m128i& p3, __m128i& p2, __m128i& p1, __m128i& p0,
+                                 __m128i& q0, __m128i& q1, __m128i& q2, __m128i& q3,
+                                 __m128i vBs, __m128i vTc0, Int iAlpha, Int iBeta )
+{
+    const __m128i vZero   = _mm_setzero_si128();
+    const __m128i vAlpha  = _mm_set1_epi16( (Short)iAlpha );
+    const __m128i vBeta   = _mm_set1_epi16( (Short)iBeta );
+    const __m128i vAbsPQ  = xAbsDiff( p0, q0 );
+
+    __m128i vFilter = _mm_and_si128( _mm_cmplt_epi16( vAbsPQ, vAlpha ),
+                                     _mm_and_si128( _mm_cmplt_epi16( xAbsDiff( p1, p0 ), vBeta ),
+                                                    _mm_cmplt_epi16( xAbsDiff( q1, q0 ), vBeta ) ) );
+    vFilter = _mm_andnot_si128( _mm_cmpeq_epi16( vBs, vZero ), vFilter );
+    if( 0 == _mm_movemask_epi8( vFilter ) )
+    {
+        return;
+    }
+
+    const __m128i vStrong = _mm_and_si128( vFilter, _mm_cmpeq_epi16( vBs, _mm_set1_epi16( 4 ) ) );
+    const __m128i vNormal = _mm_andnot_si128( vStrong, vFilter );
+    const __m128i vOne    = _mm_set1_epi16( 1 );
+    const __m128i vTwo    = _mm_set1_epi16( 2 );
+    const __m128i vFour   = _mm_set1_epi16( 4 );
+
+    __m128i vP0 = p0, vP1 = p1, vP2 = p2;
+    __m128i vQ0 = q0, vQ1 = q1, vQ2 = q2;
+    __m128i vAp = vZero, vAq = vZero;
+    if( bLum )
+    {
+        vAp = _mm_cmplt_epi16( xAbsDiff( p2, p0 ), vBeta );
+        vAq = _mm_cmplt_epi16( xAbsDiff( q2, q0 ), vBeta );
+    }
+
+    //===== bS < 4 =====
+    if( _mm_movemask_epi8( vNormal ) )
+    {
+        const __m128i vMinTc0 = _mm_sub_epi16( vZero, vTc0 );
+        __m128i       vTc     = _mm_add_epi16( vTc0, vOne );
+        if( bLum )
+        {
+            const __m128i vAvg = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( p0, q0 ), vOne ), 1 );
+            const __m128i vDP1 = xClip3( _mm_srai_epi16( _mm_sub_epi16( _mm_add_epi16( p2, vAvg ), _mm_slli_epi16( p1, 1 ) ), 1 ), vMinTc0, vTc0 );
+            const __m128i vDQ1 = xClip3( _mm_srai_epi16( _mm_sub_epi16( _mm_add_epi16( q2, vAvg ), _mm_slli_epi16( q1, 1 ) ), 1 ), vMinTc0, vTc0 );
+            vP1 = xSelect( _mm_and_si128( vNormal, vAp ), _mm_add_epi16( p1, vDP1 ), vP1 );
+            vQ1 = xSelect( _mm_and_si128( vNormal, vAq ), _mm_add_epi16( q1, vDQ1 ), vQ1 );
+            vTc = _mm_sub_epi16( _mm_sub_epi16( vTc0, vAp ), vAq );
+        }
+        const __m128i v255   = _mm_set1_epi16( 255 );
+        const __m128i vDelta = xClip3( _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( _mm_sub_epi16( q0, p0 ), 2 ),
+                                                                                     _mm_sub_epi16( p1, q1 ) ), vFour ), 3 ),
+                                       _mm_sub_epi16( vZero, vTc ), vTc );
+        vP0 = xSelect( vNormal, xClip3( _mm_add_epi16( p0, vDelta ), vZero, v255 ), vP0 );
+        vQ0 = xSelect( vNormal, xClip3( _mm_sub_epi16( q0, vDelta ), vZero, v255 ), vQ0 );
+    }
+
+    //===== bS == 4 =====
+    if( _mm_movemask_epi8( vStrong ) )
+    {
+        const __m128i vP0b = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( p1, 1 ), p0 ), _mm_add_epi16( q1, vTwo ) ), 2 );
+        const __m128i vQ0b = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( q1, 1 ), q0 ), _mm_add_epi16( p1, vTwo ) ), 2 );
+        if( bLum )
+        {
+            const __m128i vEnable = _mm_cmplt_epi16( vAbsPQ, _mm_set1_epi16( (Short)( ( iAlpha >> 2 ) + 2 ) ) );
+            const __m128i vApS    = _mm_and_si128( vStrong, _mm_and_si128( vEnable, vAp ) );
+            const __m128i vAqS    = _mm_and_si128( vStrong, _mm_and_si128( vEnable, vAq ) );
+            const __m128i vPQ0    = _mm_add_epi16( p0, q0 );
+
+            const __m128i vP0a = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( q1, _mm_slli_epi16( _mm_add_epi16( p1, vPQ0 ), 1 ) ), _mm_add_epi16( p2, vFour ) ), 3 );
+            const __m128i vP1a = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( vPQ0, p1 ), _mm_add_epi16( p2, vTwo ) ), 2 );
+            const __m128i vP2a = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( _mm_add_epi16( p3, p2 ), 1 ), p2 ),
+                                                                _mm_add_epi16( _mm_add_epi16( p1, vPQ0 ), vFour ) ), 3 );
+            const __m128i vQ0a = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( p1, _mm_slli_epi16( _mm_add_epi16( q1, vPQ0 ), 1 ) ), _mm_add_epi16( q2, vFour ) ), 3 );
+            const __m128i vQ1a = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( vPQ0, q1 ), _mm_add_epi16( q2, vTwo ) ), 2 );
+            const __m128i vQ2a = _mm_srai_epi16( _mm_add_epi16( _mm_add_epi16( _mm_slli_epi16( _mm_add_epi16( q3, q2 ), 1 ), q2 ),
+                                                                _mm_add_epi16( _mm_add_epi16( q1, vPQ0 ), vFour ) ), 3 );
+
+            vP0 = xSelect( vStrong, xSelect( vApS, vP0a, vP0b ), vP0 );
+            vQ0 = xSelect( vStrong, xSelect( vAqS, vQ0a, vQ0b ), vQ0 );
+            vP1 = xSelect( vApS, vP1a, vP1 );
+            vQ1 = xSelect( vAqS, vQ1a, vQ1 );
+            vP2 = xSelect( vApS, vP2a, vP2 );
+            vQ2 = xSelect( vAqS, vQ2a, vQ2 );
+        }
+        else
+        {
+            vP0 = xSelect( vStrong, vP0b, vP0 );
+            vQ0 = xSelect( vStrong, vQ0b, vQ0 );
+        }
+    }
+
+    if( bLum )
+    {
+        p2 = vP2;
+        q2 = vQ2;
+    }
+    p1 = vP1;  p0 = vP0;
+    q0 = vQ0;  q1 = vQ1;
+}
+
+//===== luma edges: 16 samples in two halves of 8 =====
+template< typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xFilterLumaVerEdgeSSE2( TPel* pFlt, Int iStride, const UChar* pucBs, Int iIndexA, Int iIndexB )
+{
+    const Int iAlpha = LoopFilter::g_acAlphaClip[ iIndexA ].ucAlpha;
+    const Int iBeta  = LoopFilter::g_aucBetaTab [ iIndexB ];
+
+    for( Int iHalf = 0; iHalf < 2; iHalf++, pFlt += 8*iStride, pucBs += 2 )
+    {
+        if( 0 == ( pucBs[0] | pucBs[1] ) )
+        {
+            continue;
+        }
+        __m128i vBs, vTc0, ai[8];
+        Int     i;
+        xGetLaneParameters( pucBs, 4, iIndexA, vBs, vTc0 );
+        for( i = 0; i < 8; i++ )
+        {
+            ai[i] = xLoad8( pFlt + i*iStride - 4 );
+        }
+        xTranspose8x8( ai );
+        xFilterLanes<true>( ai[0], ai[1], ai[2], ai[3], ai[4], ai[5], ai[6], ai[7], vBs, vTc0, iAlpha, iBeta );
+        xTranspose8x8( ai );
+        for( i = 0; i < 8; i++ )
+        {
+            xStore8( pFlt + i*iStride - 4, ai[i] );
+        }
+    }
+}
+
+template< typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xFilterLumaHorEdgeSSE2( TPel* pFlt, Int iStride, const UChar* pucBs, Int iIndexA, Int iIndexB )
+{
+    const Int iAlpha = LoopFilter::g_acAlphaClip[ iIndexA ].ucAlpha;
+    const Int iBeta  = LoopFilter::g_aucBetaTab [ iIndexB ];
+
+    for( Int iHalf = 0; iHalf < 2; iHalf++, pFlt += 8, pucBs += 2 )
+    {
+        if( 0 == ( pucBs[0] | pucBs[1] ) )
+        {
+            continue;
+        }
+        __m128i vBs, vTc0, ai[8];
+        Int     i;
+        xGetLaneParameters( pucBs, 4, iIndexA, vBs, vTc0 );
+        for( i = 0; i < 8; i++ )
+        {
+            ai[i] = xLoad8( pFlt + ( i - 4 )*iStride );
+        }
+        xFilterLanes<true>( ai[0], ai[1], ai[2], ai[3], ai[4], ai[5], ai[6], ai[7], vBs, vTc0, iAlpha, iBeta );
+        for( i = 1; i < 7; i++ )
+        {
+            xStore8( pFlt + ( i - 4 )*iStride, ai[i] );
+        }
+    }
+}
+
+//===== chroma edges: 8 samples, 2 per strength =====
+template< typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xFilterChromaVerEdgeSSE2( TPel* pFlt, Int iStride, const UChar* pucBs, Int iIndexA, Int iIndexB )
+{
+    const Int iAlpha = LoopFilter::g_acAlphaClip[ iIndexA ].ucAlpha;
+    const Int iBeta  = LoopFilter::g_aucBetaTab [ iIndexB ];
+    __m128i   vBs, vTc0, ai[8];
+    Int       i;
+
+    xGetLaneParameters( pucBs, 2, iIndexA, vBs, vTc0 );
+    for( i = 0; i < 8; i++ )
+    {
+        ai[i] = xLoad4( pFlt + i*iStride - 2 );
+    }
+    xTranspose8x8( ai );
+    xFilterLanes<false>( ai[4], ai[4], ai[0], ai[1], ai[2], ai[3], ai[5], ai[5], vBs, vTc0, iAlpha, iBeta );
+    ai[4] = ai[5] = ai[6] = ai[7] = _mm_setzero_si128();
+    xTranspose8x8( ai );
+    for( i = 0; i < 8; i++ )
+    {
+        xStore4( pFlt + i*iStride - 2, ai[i] );
+    }
+}
+
+template< typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xFilterChromaHorEdgeSSE2( TPel* pFlt, Int iStride, const UChar* pucBs, Int iIndexA, Int iIndexB )
+{
+    const Int iAlpha = LoopFilter::g_acAlphaClip[ iIndexA ].ucAlpha;
+    const Int iBeta  = LoopFilter::g_aucBetaTab [ iIndexB ];
+    __m128i   vBs, vTc0, vUnused = _mm_setzero_si128();
+
+    xGetLaneParameters( pucBs, 2, iIndexA, vBs, vTc0 );
+    __m128i p1 = xLoad8( pFlt - 2*iStride );
+    __m128i p0 = xLoad8( pFlt -   iStride );
+    __m128i q0 = xLoad8( pFlt );
+    __m128i q1 = xLoad8( pFlt +   iStride );
+    xFilterLanes<false>( vUnused, vUnused, p1, p0, q0, q1, vUnused, vUnused, vBs, vTc0, iAlpha, iBeta );
+    xStore8( pFlt - iStride, p0 );
+    xStore8( pFlt,           q0 );
+}
+
+#endif
+
+
+Void LoopFilter::xInitSIMDFunctions( UInt uiSIMDFlags )
+{
+#if defined( H264AVC_X86_SIMD )
+    if( uiSIMDFlags & SIMD_SSE2 )
+    {
+        m_aafpEdgeFilterFunc [0][VER] = xFilterLumaVerEdgeSSE2  <Pel >;
+        m_aafpEdgeFilterFunc [0][HOR] = xFilterLumaHorEdgeSSE2  <Pel >;
+        m_aafpEdgeFilterFunc [1][VER] = xFilterChromaVerEdgeSSE2<Pel >;
+        m_aafpEdgeFilterFunc [1][HOR] = xFilterChromaHorEdgeSSE2<Pel >;
+        m_aafpXEdgeFilterFunc[0][VER] = xFilterLumaVerEdgeSSE2  <XPel>;
+        m_aafpXEdgeFilterFunc[0][HOR] = xFilterLumaHorEdgeSSE2  <XPel>;
+        m_aafpXEdgeFilterFunc[1][VER] = xFilterChromaVerEdgeSSE2<XPel>;
+        m_aafpXEdgeFilterFunc[1][HOR] = xFilterChromaHorEdgeSSE2<XPel>;
+    }
+#endif
+}
+
+
+H264AVC_NAMESPACE_END
@@ -530,41 +530,9 @@ ErrVal MbDataCtrl::initMb( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMb
 
     AOT_DBG( uiMbY * m_uiMbStride + uiMbX + m_uiMbOffset >= m_uiSize );
 
-    Bool     bLf          = (m_eProcessingState == POST_PROCESS);
-    Bool     bMbaff       = m_pcSliceHeader->isMbAff();
-    Bool     bTopMb       = ((bMbaff && (uiMbY % 2)) ? false : true);
-    UInt     uiMbYComp    = ( bMbaff ? ( bTopMb ? uiMbY+1 : uiMbY-1 ) : uiMbY );
     UInt     uiCurrIdx    = uiMbY * m_uiMbStride + uiMbX + m_uiMbOffset;
-    UInt     uiCompIdx    = uiMbYComp    * m_uiMbStride + uiMbX + m_uiMbOffset;
-    ROT( uiCompIdx >= m_uiSize );
     ROT( uiCurrIdx >= m_uiSize );
     MbData&  rcMbDataCurr = m_pcMbData[ uiCurrIdx ];
-    MbData&  rcMbDataComp = m_pcMbData[ uiCompIdx ];
-
-    //----- get co-located MbIndex -----
-    UInt     uiIdxColTop;
-    UInt     uiIdxColBot;
-    if( ! m_pcSliceHeader->getFieldPicFlag() )
-    {
-        UInt  uiMbYColTop = 2 * ( uiMbY / 2 );
-        uiIdxColTop       = uiMbYColTop * m_uiMbStride + uiMbX + m_uiMbOffset;
-        uiIdxColBot       = uiIdxColTop + m_uiMbStride;
-        //    if( uiIdxColBot >= m_uiSize ) //th bug
-        if( uiIdxColBot >= m_pcSliceHeader->getMbInPic() ) //th bug
-        {
-            uiIdxColBot = uiIdxColTop;
-        }
-    }
-    else if( ! m_pcSliceHeader->getBottomFieldFlag() )
-    {
-        uiIdxColTop       = uiCurrIdx   + m_iColocatedOffset;
-        uiIdxColBot       = uiIdxColTop - m_iColocatedOffset + m_iMbPerLine;
-    }
-    else
-    {
-        uiIdxColBot       = uiCurrIdx   - m_iColocatedOffset;
-        uiIdxColTop       = uiIdxColBot + m_iColocatedOffset - m_iMbPerLine;
-    }
 
     if( m_pcMbDataAccess )
     {
@@ -600,10 +568,90 @@ ErrVal MbDataCtrl::initMb( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMb
         }
     }
 
+    RNOK( xInitMbDataAccess( m_pcMbDataAccess, *m_pcSliceHeader, uiMbY, uiMbX, m_ucLastMbQp, POST_PROCESS == m_eProcessingState ) );
+
+    rpcMbDataAccess = m_pcMbDataAccess;
+
+    return Err::m_nOK;
+}
+
+ErrVal MbDataCtrl::initMbForAnalysis( MbDataAccess*& rpcMbDataAccess, SliceHeader& rcSliceHeader, UInt uiSliceId, UInt uiMbY, UInt uiMbX )
+{
+    ROF( m_bInitDone );
+    ROF( ENCODE_PROCESS == m_eProcessingState );
+    ROF( uiSliceId && uiSliceId <= m_uiSliceId );
+
+    UInt     uiCurrIdx    = uiMbY * m_uiMbStride + uiMbX + m_uiMbOffset;
+    ROT( uiCurrIdx >= m_uiSize );
+    MbData&  rcMbDataCurr = m_pcMbData[ uiCurrIdx ];
+
+    //----- the last QP is not advanced here: the macroblocks of a slice encoded by SliceEncoder all keep the slice QP -----
+    if( 0 == rcMbDataCurr.getSliceId() )
+    {
+        rcMbDataCurr.getMbTCoeffs().clear();
+        rcMbDataCurr.initMbData( m_ucLastMbQp, uiSliceId );
+        rcMbDataCurr.clear();
+#pragma omp atomic
+        m_uiMbProcessed++;
+    }
+
+    return xInitMbDataAccess( rpcMbDataAccess, rcSliceHeader, uiMbY, uiMbX, m_ucLastMbQp, false );
+}
+
+ErrVal MbDataCtrl::initMbForPipeline( MbDataAccess*& rpcMbDataAccess, SliceHeader& rcSliceHeader, UInt uiMbY, UInt uiMbX, UChar ucLastMbQp, Bool bLoopFilter )
+{
+    ROF( m_bInitDone );
+
+    UInt     uiCurrIdx    = uiMbY * m_uiMbStride + uiMbX + m_uiMbOffset;
+    ROT( uiCurrIdx >= m_uiSize );
+    ROT( 0 == m_pcMbData[ uiCurrIdx ].getSliceId() );
+
+    return xInitMbDataAccess( rpcMbDataAccess, rcSliceHeader, uiMbY, uiMbX, ucLastMbQp, bLoopFilter );
+}
+
+ErrVal MbDataCtrl::xInitMbDataAccess( MbDataAccess*& rpcMbDataAccess, SliceHeader& rcSliceHeader, UInt uiMbY, UInt uiMbX, UChar ucLastMbQp, Bool bLoopFilter )
+{
+    Bool     bLf          = bLoopFilter;
+    Bool     bMbaff       = m_pcSliceHeader->isMbAff();
+    Bool     bTopMb       = ((bMbaff && (uiMbY % 2)) ? false : true);
+    UInt     uiMbYComp    = ( bMbaff ? ( bTopMb ? uiMbY+1 : uiMbY-1 ) : uiMbY );
+    UInt     uiCurrIdx    = uiMbY * m_uiMbStride + uiMbX + m_uiMbOffset;
+    UInt     uiCompIdx    = uiMbYComp    * m_uiMbStride + uiMbX + m_uiMbOffset;
+    ROT( uiCompIdx >= m_uiSize );
+    ROT( uiCurrIdx >= m_uiSize );
+    MbData&  rcMbDataCurr = m_pcMbData[ uiCurrIdx ];
+    MbData&  rcMbDataComp = m_pcMbData[ uiCompIdx ];
+
+    //----- get co-located MbIndex -----
+    UInt     uiIdxColTop;
+    UInt     uiIdxColBot;
+    if( ! m_pcSliceHeader->getFieldPicFlag() )
+    {
+        UInt  uiMbYColTop = 2 * ( uiMbY / 2 );
+        uiIdxColTop       = uiMbYColTop * m_uiMbStride + uiMbX + m_uiMbOffset;
+        uiIdxColBot       = uiIdxColTop + m_uiMbStride;
+        //    if( uiIdxColBot >= m_uiSize ) //th bug
+        if( uiIdxColBot >= m_pcSliceHeader->getMbInPic() ) //th bug
+        {
+            uiIdxColBot = uiIdxColTop;
+        }
+    }
+    else if( ! m_pcSliceHeader->getBottomFieldFlag() )
+    {
+        uiIdxColTop       = uiCurrIdx   + m_iColocatedOffset;
+        uiIdxColBot       = uiIdxColTop - m_iColocatedOffset + m_iMbPerLine;
+    }
+    else
+    {
+        uiIdxColBot       = uiCurrIdx   - m_iColocatedOffset;
+        uiIdxColTop       = uiIdxColBot + m_iColocatedOffset - m_iMbPerLine;
+    }
+
+    UInt uiSliceId = rcMbDataCurr.getSliceId();
 
   Int icurrSliceGroupID = getSliceGroupIDofMb(uiMbY * (m_uiMbStride>>(UInt)m_pcSliceHeader->getFieldPicFlag()) + uiMbX ); 
         Bool bColocatedField = ( m_pcMbDataCtrl0L1 == NULL) ? true : m_pcMbDataCtrl0L1->isPicCodedField();
-    m_pcMbDataAccess = new (m_pcMbDataAccess) MbDataAccess(
+    rpcMbDataAccess = new (rpcMbDataAccess) MbDataAccess(
         rcMbDataCurr,                                      // current
         rcMbDataComp,                                      // complementary
         xGetRefMbData( uiSliceId,icurrSliceGroupID, uiMbY,   uiMbX-1, bLf ), // left
@@ -617,18 +665,16 @@ ErrVal MbDataCtrl::initMb( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMb
         xGetOutMbData(),                                   // unvalid
         xGetColMbData( uiIdxColTop ),
         xGetColMbData( uiIdxColBot ),
-        *m_pcSliceHeader,
+        rcSliceHeader,
         *m_cpDFPBuffer.get( uiSliceId ),
         uiMbX,
         uiMbY,
         bTopMb,
         m_bUseTopField,
         bColocatedField,
-        m_ucLastMbQp );
+        ucLastMbQp );
 
-    ROT( NULL == m_pcMbDataAccess );
-
-    rpcMbDataAccess = m_pcMbDataAccess;
+    ROT( NULL == rpcMbDataAccess );
 
     return Err::m_nOK;
 }
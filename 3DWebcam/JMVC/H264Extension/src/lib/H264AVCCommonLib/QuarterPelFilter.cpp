@@ -5,7 +5,8 @@ H264AVC_NAMESPACE_BEGIN
 
 
 QuarterPelFilter::QuarterPelFilter()
-:m_bClip ( true )
+:m_bClip      ( true )
+,m_bSelfCheck ( false )
 {
   uninit();
 }
@@ -36,9 +37,10 @@ ErrVal QuarterPelFilter::destroy()
 }
 
 
-ErrVal QuarterPelFilter::init()
+ErrVal QuarterPelFilter::init( UInt uiSIMDFlags, Bool bSelfCheck )
 {
   m_bClip = true;
+  m_bSelfCheck = bSelfCheck;
   m_afpFilterBlockFunc[0] = QuarterPelFilter::xFilter1;
   m_afpFilterBlockFunc[1] = QuarterPelFilter::xFilter2;
   m_afpFilterBlockFunc[2] = QuarterPelFilter::xFilter3;
@@ -48,6 +50,8 @@ ErrVal QuarterPelFilter::init()
   m_afpXFilterBlockFunc[1] = QuarterPelFilter::xXFilter2;
   m_afpXFilterBlockFunc[2] = QuarterPelFilter::xXFilter3;
   m_afpXFilterBlockFunc[3] = QuarterPelFilter::xXFilter4;
+
+  xInitSIMDFunctions( uiSIMDFlags & CpuInfo::getSIMDFlags() );
   return Err::m_nOK;
 }
 
@@ -62,6 +66,11 @@ ErrVal QuarterPelFilter::uninit()
   m_afpXFilterBlockFunc[1] = NULL;
   m_afpXFilterBlockFunc[2] = NULL;
   m_afpXFilterBlockFunc[3] = NULL;
+
+  ::memset( m_aafpPredLumaFunc,  0x00, sizeof( m_aafpPredLumaFunc  ) );
+  ::memset( m_aafpXPredLumaFunc, 0x00, sizeof( m_aafpXPredLumaFunc ) );
+  m_fpFilterFrameFunc  = NULL;
+  m_fpXFilterFrameFunc = NULL;
   return Err::m_nOK;
 }
 
@@ -69,6 +78,17 @@ ErrVal QuarterPelFilter::uninit()
 const Int g_aiTapCoeff[6] = { 1, -5,20,20,-5, 1};
 
 
+template< typename TPel >
+static Bool xIsEqual( const TPel* pA, Int iStrideA, const TPel* pB, Int iStrideB, Int iWidth, Int iHeight )
+{
+  for( Int y = 0; y < iHeight; y++, pA += iStrideA, pB += iStrideB )
+  {
+    ROTRS( ::memcmp( pA, pB, iWidth * sizeof( TPel ) ), false );
+  }
+  return true;
+}
+
+
 extern Int  giInterpolationType;
 
 
@@ -131,6 +151,32 @@ Void QuarterPelFilter::predBlk( YuvMbBuffer* pcDesBuffer, YuvPicBuffer* pcSrcBuf
 
   Int iDx = cMv.getHor() & 3;
   Int iDy = cMv.getVer() & 3;
+
+  PredLumaFunc fpPredLuma = m_aafpPredLumaFunc[ xGetSizeIdx( iSizeX ) ][ ( iDy << 2 ) + iDx ];
+  if( NULL == fpPredLuma )
+  {
+    xPredLuma( pucDes, pucSrc, iDesStride, iSrcStride, iDx, iDy, iSizeY, iSizeX );
+    return;
+  }
+  if( ! m_bSelfCheck )
+  {
+    fpPredLuma( pucDes, pucSrc, iDesStride, iSrcStride, iDx, iDy, iSizeY );
+    return;
+  }
+
+  //===== self check: compare with the scalar prediction, which is kept =====
+  Pel aucSIMD[16*16];
+  fpPredLuma( aucSIMD, pucSrc, 16, iSrcStride, iDx, iDy, iSizeY );
+  xPredLuma ( pucDes,  pucSrc, iDesStride, iSrcStride, iDx, iDy, iSizeY, iSizeX );
+  if( ! xIsEqual( aucSIMD, 16, pucDes, iDesStride, iSizeX, iSizeY ) )
+  {
+    CpuInfo::reportMismatch( "QuarterPelFilter::predBlk" );
+  }
+}
+
+
+Void QuarterPelFilter::xPredLuma( Pel* pucDes, Pel* pucSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY, Int iSizeX )
+{
   if( iDy == 0)
   {
     if( iDx == 0 )
@@ -470,6 +516,49 @@ Void QuarterPelFilter::xPredElse( Pel* pucDest, Pel* pucSrc, Int iDestStride, In
 
 
 ErrVal QuarterPelFilter::filterFrame( YuvPicBuffer *pcPelBuffer, YuvPicBuffer *pcHalfPelBuffer )
+{
+  ROT( NULL == pcPelBuffer );
+  ROT( NULL == pcHalfPelBuffer );
+
+  if( NULL == m_fpFilterFrameFunc )
+  {
+    return xFilterFrame( pcPelBuffer, pcHalfPelBuffer );
+  }
+
+  Pel*    pucSrc      = pcPelBuffer->getMbLumAddr ();
+  Int     iHeight     = pcPelBuffer->getLHeight   ();
+  Int     iWidth      = pcPelBuffer->getLWidth    ();
+  Int     iStride     = pcPelBuffer->getLStride   ();
+  Int     iMarginNew  = pcPelBuffer->getLXMargin  () - 4;
+  Int     iDesStrideHP= pcHalfPelBuffer->getLStride();
+  Pel*    pucDesHP    = pcHalfPelBuffer->getMbLumAddr();
+
+  if( ! m_bSelfCheck )
+  {
+    return m_fpFilterFrameFunc( pucSrc, iStride, iWidth, iHeight, iMarginNew, pucDesHP, iDesStrideHP );
+  }
+
+  //===== self check: compare with the scalar half-pel planes, which are kept =====
+  RNOK( xFilterFrame( pcPelBuffer, pcHalfPelBuffer ) );
+
+  Int     iSIMDWidth  = 2 * ( iWidth  + 2 * iMarginNew );
+  Int     iSIMDHeight = 2 * ( iHeight + 2 * iMarginNew );
+  Int     iSIMDOffset = 2 * iMarginNew * ( iSIMDWidth + 1 );
+  Int     iDesOffset  = 2 * iMarginNew * ( iDesStrideHP + 1 );
+  Pel*    pucSIMD     = new Pel[ iSIMDWidth * iSIMDHeight ];
+  ROT( NULL == pucSIMD );
+
+  ErrVal  nRet        = m_fpFilterFrameFunc( pucSrc, iStride, iWidth, iHeight, iMarginNew, pucSIMD + iSIMDOffset, iSIMDWidth );
+  if( nRet == Err::m_nOK && ! xIsEqual( pucSIMD, iSIMDWidth, pucDesHP - iDesOffset, iDesStrideHP, iSIMDWidth, iSIMDHeight ) )
+  {
+    CpuInfo::reportMismatch( "QuarterPelFilter::filterFrame" );
+  }
+  delete [] pucSIMD;
+  return nRet;
+}
+
+
+ErrVal QuarterPelFilter::xFilterFrame( YuvPicBuffer *pcPelBuffer, YuvPicBuffer *pcHalfPelBuffer )
 {
     ROT( NULL == pcPelBuffer );
     ROT( NULL == pcHalfPelBuffer );
@@ -564,6 +653,49 @@ ErrVal QuarterPelFilter::filterFrame( IntYuvPicBuffer *pcPelBuffer, IntYuvPicBuf
   ROT( NULL == pcPelBuffer );
   ROT( NULL == pcHalfPelBuffer );
 
+  if( NULL == m_fpXFilterFrameFunc || ! m_bClip )
+  {
+    return xFilterFrame( pcPelBuffer, pcHalfPelBuffer );
+  }
+
+  XPel*   pucSrc      = pcPelBuffer->getMbLumAddr ();
+  Int     iHeight     = pcPelBuffer->getLHeight   ();
+  Int     iWidth      = pcPelBuffer->getLWidth    ();
+  Int     iStride     = pcPelBuffer->getLStride   ();
+  Int     iMarginNew  = pcPelBuffer->getLXMargin  () - 4;
+  Int     iDesStrideHP= pcHalfPelBuffer->getLStride();
+  XPel*   pucDesHP    = pcHalfPelBuffer->getMbLumAddr();
+
+  if( ! m_bSelfCheck )
+  {
+    return m_fpXFilterFrameFunc( pucSrc, iStride, iWidth, iHeight, iMarginNew, pucDesHP, iDesStrideHP );
+  }
+
+  //===== self check: compare with the scalar half-pel planes, which are kept =====
+  RNOK( xFilterFrame( pcPelBuffer, pcHalfPelBuffer ) );
+
+  Int     iSIMDWidth  = 2 * ( iWidth  + 2 * iMarginNew );
+  Int     iSIMDHeight = 2 * ( iHeight + 2 * iMarginNew );
+  Int     iSIMDOffset = 2 * iMarginNew * ( iSIMDWidth + 1 );
+  Int     iDesOffset  = 2 * iMarginNew * ( iDesStrideHP + 1 );
+  XPel*   psSIMD      = new XPel[ iSIMDWidth * iSIMDHeight ];
+  ROT( NULL == psSIMD );
+
+  ErrVal  nRet        = m_fpXFilterFrameFunc( pucSrc, iStride, iWidth, iHeight, iMarginNew, psSIMD + iSIMDOffset, iSIMDWidth );
+  if( nRet == Err::m_nOK && ! xIsEqual( psSIMD, iSIMDWidth, pucDesHP - iDesOffset, iDesStrideHP, iSIMDWidth, iSIMDHeight ) )
+  {
+    CpuInfo::reportMismatch( "QuarterPelFilter::filterFrame" );
+  }
+  delete [] psSIMD;
+  return nRet;
+}
+
+
+ErrVal QuarterPelFilter::xFilterFrame( IntYuvPicBuffer *pcPelBuffer, IntYuvPicBuffer *pcHalfPelBuffer )
+{
+  ROT( NULL == pcPelBuffer );
+  ROT( NULL == pcHalfPelBuffer );
+
   XPel*   pucSrc      = pcPelBuffer->getMbLumAddr ();
   Int     iHeight     = pcPelBuffer->getLHeight   ();
   Int     iWidth      = pcPelBuffer->getLWidth    ();
@@ -993,6 +1125,33 @@ Void QuarterPelFilter::predBlk( IntYuvMbBuffer* pcDesBuffer, IntYuvPicBuffer* pc
 
   Int iDx = cMv.getHor() & 3;
   Int iDy = cMv.getVer() & 3;
+
+  //===== the SIMD kernels always clip =====
+  XPredLumaFunc fpPredLuma = ( m_bClip ? m_aafpXPredLumaFunc[ xGetSizeIdx( iSizeX ) ][ ( iDy << 2 ) + iDx ] : NULL );
+  if( NULL == fpPredLuma )
+  {
+    xPredLuma( pucDes, pucSrc, iDesStride, iSrcStride, iDx, iDy, iSizeY, iSizeX );
+    return;
+  }
+  if( ! m_bSelfCheck )
+  {
+    fpPredLuma( pucDes, pucSrc, iDesStride, iSrcStride, iDx, iDy, iSizeY );
+    return;
+  }
+
+  //===== self check: compare with the scalar prediction, which is kept =====
+  XPel asSIMD[16*16];
+  fpPredLuma( asSIMD, pucSrc, 16, iSrcStride, iDx, iDy, iSizeY );
+  xPredLuma ( pucDes, pucSrc, iDesStride, iSrcStride, iDx, iDy, iSizeY, iSizeX );
+  if( ! xIsEqual( asSIMD, 16, pucDes, iDesStride, iSizeX, iSizeY ) )
+  {
+    CpuInfo::reportMismatch( "QuarterPelFilter::predBlk" );
+  }
+}
+
+
+Void QuarterPelFilter::xPredLuma( XPel* pucDes, XPel* pucSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY, Int iSizeX )
+{
   if( iDy == 0)
   {
     if( iDx == 0 )
@@ -0,0 +1,403 @@
+#include "H264AVCCommonLib.h"
+#include "H264AVCCommonLib/QuarterPelFilter.h"
+
+#if defined( H264AVC_X86_SIMD )
+#include <emmintrin.h>
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+// The SIMD kernels give the same results as the scalar code in
+// QuarterPelFilter.cpp for 8 bit reference pictures with clipping enabled:
+//
+// - The six-tap sums of 8 bit samples (-2550 ... 10710) fit into 16 bit
+//   lanes. Only the second filter stage of the centre positions needs 32 bit
+//   lanes, its taps are applied with pmaddwd on interleaved rows.
+// - ( x + 16 ) / 32 rounds towards zero and >> 5 rounds down. Both differ for
+//   negative values only, which are clipped to zero afterwards anyway.
+// - The quarter-pel positions average two clipped values with pavgw, i.e.
+//   ( a + b + 1 ) >> 1 like the scalar code does.
+//
+// The block kernels are specialized for block widths of 16, 8 and 4 samples
+// and never read outside the area that is read by the scalar code.
+
+
+#if defined( H264AVC_X86_SIMD )
+
+//===== loads and stores of 8 ( or 4 for iW == 4 ) samples as 16 bit lanes =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad8( const Pel* p )
+{
+  return _mm_unpacklo_epi8( _mm_loadl_epi64( (const __m128i*)p ), _mm_setzero_si128() );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad8( const XPel* p )
+{
+  return _mm_loadu_si128( (const __m128i*)p );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad4( const Pel* p )
+{
+  Int i;
+  ::memcpy( &i, p, sizeof( i ) );
+  return _mm_unpacklo_epi8( _mm_cvtsi32_si128( i ), _mm_setzero_si128() );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad4( const XPel* p )
+{
+  return _mm_loadl_epi64( (const __m128i*)p );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore8( Pel* p, __m128i v )
+{
+  _mm_storel_epi64( (__m128i*)p, _mm_packus_epi16( v, v ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore8( XPel* p, __m128i v )
+{
+  _mm_storeu_si128( (__m128i*)p, v );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore4( Pel* p, __m128i v )
+{
+  Int i = _mm_cvtsi128_si32( _mm_packus_epi16( v, v ) );
+  ::memcpy( p, &i, sizeof( i ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xStore4( XPel* p, __m128i v )
+{
+  _mm_storel_epi64( (__m128i*)p, v );
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad( const TPel* p )
+{
+  return ( iW == 4 ? xLoad4( p ) : xLoad8( p ) );
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static inline Void xStore( TPel* p, __m128i v )
+{
+  if( iW == 4 )
+  {
+    xStore4( p, v );
+  }
+  else
+  {
+    xStore8( p, v );
+  }
+}
+
+
+//===== filter arithmetic =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xClip8( __m128i v )
+{
+  return _mm_min_epi16( _mm_max_epi16( v, _mm_setzero_si128() ), _mm_set1_epi16( 255 ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i x6Tap( __m128i a, __m128i b, __m128i c, __m128i d, __m128i e, __m128i f )
+{
+  __m128i iCD = _mm_mullo_epi16( _mm_add_epi16( c, d ), _mm_set1_epi16( 20 ) );
+  __m128i iBE = _mm_mullo_epi16( _mm_add_epi16( b, e ), _mm_set1_epi16(  5 ) );
+  return _mm_add_epi16( _mm_sub_epi16( iCD, iBE ), _mm_add_epi16( a, f ) );
+}
+
+//----- six-tap filter of 16 bit intermediate values with 32 bit sums, returns clip( ( sum + 512 ) >> 10 ) -----
+SIMD_TARGET( "sse2" )
+static inline __m128i x6Tap2( __m128i a, __m128i b, __m128i c, __m128i d, __m128i e, __m128i f )
+{
+  const __m128i c1  = _mm_set1_epi16(  1 );
+  const __m128i c5  = _mm_set1_epi16( -5 );
+  const __m128i c20 = _mm_set1_epi16( 20 );
+  const __m128i cR  = _mm_set1_epi32( 512 );
+
+  __m128i iLo = _mm_add_epi32( _mm_madd_epi16( _mm_unpacklo_epi16( a, f ), c1 ), _mm_madd_epi16( _mm_unpacklo_epi16( b, e ), c5 ) );
+  __m128i iHi = _mm_add_epi32( _mm_madd_epi16( _mm_unpackhi_epi16( a, f ), c1 ), _mm_madd_epi16( _mm_unpackhi_epi16( b, e ), c5 ) );
+  iLo = _mm_add_epi32( iLo, _mm_madd_epi16( _mm_unpacklo_epi16( c, d ), c20 ) );
+  iHi = _mm_add_epi32( iHi, _mm_madd_epi16( _mm_unpackhi_epi16( c, d ), c20 ) );
+  iLo = _mm_srai_epi32( _mm_add_epi32( iLo, cR ), 10 );
+  iHi = _mm_srai_epi32( _mm_add_epi32( iHi, cR ), 10 );
+  return xClip8( _mm_packs_epi32( iLo, iHi ) );
+}
+
+//----- returns clip( ( v + 16 ) >> 5 ) -----
+SIMD_TARGET( "sse2" )
+static inline __m128i xRound( __m128i v )
+{
+  return xClip8( _mm_srai_epi16( _mm_add_epi16( v, _mm_set1_epi16( 16 ) ), 5 ) );
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static inline __m128i xTapHor( const TPel* p )
+{
+  return x6Tap( xLoad<iW>( p - 2 ), xLoad<iW>( p - 1 ), xLoad<iW>( p ), xLoad<iW>( p + 1 ), xLoad<iW>( p + 2 ), xLoad<iW>( p + 3 ) );
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static inline __m128i xTapVer( const TPel* p, Int iStride )
+{
+  return x6Tap( xLoad<iW>( p - 2*iStride ), xLoad<iW>( p - iStride ), xLoad<iW>( p ),
+                xLoad<iW>( p + iStride ), xLoad<iW>( p + 2*iStride ), xLoad<iW>( p + 3*iStride ) );
+}
+
+
+//===== block prediction, specialized for the block width iW =====
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredDy0Dx2SSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  for( Int y = 0; y < iSizeY; y++, pDes += iDesStride, pSrc += iSrcStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      xStore<iW>( pDes + x, xRound( xTapHor<iW>( pSrc + x ) ) );
+    }
+  }
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredDy0Dx13SSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  Int iOff = iDx >> 1;
+  for( Int y = 0; y < iSizeY; y++, pDes += iDesStride, pSrc += iSrcStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      __m128i iHalf = xRound( xTapHor<iW>( pSrc + x ) );
+      xStore<iW>( pDes + x, _mm_avg_epu16( iHalf, xLoad<iW>( pSrc + x + iOff ) ) );
+    }
+  }
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredDx0Dy2SSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  for( Int y = 0; y < iSizeY; y++, pDes += iDesStride, pSrc += iSrcStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      xStore<iW>( pDes + x, xRound( xTapVer<iW>( pSrc + x, iSrcStride ) ) );
+    }
+  }
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredDx0Dy13SSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  Int iOff = ( iDy >> 1 ) * iSrcStride;
+  for( Int y = 0; y < iSizeY; y++, pDes += iDesStride, pSrc += iSrcStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      __m128i iHalf = xRound( xTapVer<iW>( pSrc + x, iSrcStride ) );
+      xStore<iW>( pDes + x, _mm_avg_epu16( iHalf, xLoad<iW>( pSrc + x + iOff ) ) );
+    }
+  }
+}
+
+//----- centre column ( dx == 2 ): horizontal filter of the rows -2 ... iSizeY+2 first -----
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredDx2SSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  Short  asTemp[16*(16+5)];
+  Short* psTemp = asTemp;
+  TPel*  pRow   = pSrc - 2*iSrcStride;
+
+  for( Int y = 0; y < iSizeY + 5; y++, psTemp += 16, pRow += iSrcStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      xStore<iW>( psTemp + x, xTapHor<iW>( pRow + x ) );
+    }
+  }
+
+  //----- dy == 1 and dy == 3 average with the half-pel row above or below -----
+  Int iOff = ( iDy == 3 ? 3*16 : 2*16 );
+  psTemp   = asTemp;
+  for( Int y = 0; y < iSizeY; y++, psTemp += 16, pDes += iDesStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      const Short* ps = psTemp + x;
+      __m128i iCentre = x6Tap2( xLoad<iW>( ps ), xLoad<iW>( ps + 16 ), xLoad<iW>( ps + 32 ),
+                                xLoad<iW>( ps + 48 ), xLoad<iW>( ps + 64 ), xLoad<iW>( ps + 80 ) );
+      if( iDy != 2 )
+      {
+        iCentre = _mm_avg_epu16( iCentre, xRound( xLoad<iW>( psTemp + x + iOff ) ) );
+      }
+      xStore<iW>( pDes + x, iCentre );
+    }
+  }
+}
+
+//----- centre row ( dy == 2 ): vertical filter of the columns -2 ... iW+2 first -----
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredDy2Dx13SSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  Short asTemp[24];
+  Int   iOff = ( iDx == 1 ? 2 : 3 );
+
+  for( Int y = 0; y < iSizeY; y++, pDes += iDesStride, pSrc += iSrcStride )
+  {
+    //----- the last chunk is moved left so that it ends at column iW+2 -----
+    for( Int n = -2; n < iW + 3; n += 8 )
+    {
+      Int m = ( n + 8 > iW + 3 ? iW + 3 - 8 : n );
+      xStore8( asTemp + m + 2, xTapVer<8>( pSrc + m, iSrcStride ) );
+    }
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      const Short* ps = asTemp + x;
+      __m128i iCentre = x6Tap2( xLoad<iW>( ps ), xLoad<iW>( ps + 1 ), xLoad<iW>( ps + 2 ),
+                                xLoad<iW>( ps + 3 ), xLoad<iW>( ps + 4 ), xLoad<iW>( ps + 5 ) );
+      iCentre = _mm_avg_epu16( iCentre, xRound( xLoad<iW>( ps + iOff ) ) );
+      xStore<iW>( pDes + x, iCentre );
+    }
+  }
+}
+
+template< Int iW, typename TPel >
+SIMD_TARGET( "sse2" )
+static Void xPredElseSSE2( TPel* pDes, TPel* pSrc, Int iDesStride, Int iSrcStride, Int iDx, Int iDy, Int iSizeY )
+{
+  TPel* pSrcX = pSrc + ( iDy == 1 ? 0 : iSrcStride );
+  TPel* pSrcY = pSrc + ( iDx == 1 ? 0 : 1 );
+
+  for( Int y = 0; y < iSizeY; y++, pDes += iDesStride, pSrcX += iSrcStride, pSrcY += iSrcStride )
+  {
+    for( Int x = 0; x < iW; x += 8 )
+    {
+      __m128i iHor = xRound( xTapHor<iW>( pSrcX + x ) );
+      __m128i iVer = xRound( xTapVer<iW>( pSrcY + x, iSrcStride ) );
+      xStore<iW>( pDes + x, _mm_avg_epu16( iHor, iVer ) );
+    }
+  }
+}
+
+
+template< Int iW, typename TPel, typename TFunc >
+static Void xSetPredLumaKernels( TFunc* pafpFunc )
+{
+  for( Int iDy = 0; iDy < 4; iDy++ )
+  for( Int iDx = 0; iDx < 4; iDx++ )
+  {
+    TFunc fpFunc = xPredElseSSE2<iW,TPel>;
+    if( iDx == 0 && iDy == 0 )  fpFunc = NULL; // copy
+    else if( iDy == 0 )         fpFunc = ( iDx == 2 ? xPredDy0Dx2SSE2<iW,TPel> : xPredDy0Dx13SSE2<iW,TPel> );
+    else if( iDx == 0 )         fpFunc = ( iDy == 2 ? xPredDx0Dy2SSE2<iW,TPel> : xPredDx0Dy13SSE2<iW,TPel> );
+    else if( iDx == 2 )         fpFunc = xPredDx2SSE2<iW,TPel>;
+    else if( iDy == 2 )         fpFunc = xPredDy2Dx13SSE2<iW,TPel>;
+    pafpFunc[ ( iDy << 2 ) + iDx ] = fpFunc;
+  }
+}
+
+
+//===== half-pel planes =====
+// Same output as QuarterPelFilter::xFilterFrame(): the horizontally filtered
+// rows are interleaved with the full-pel samples ( 32 times the sample ) and
+// the vertical filter is applied to both of them. The replication of the top
+// and the bottom row is done by clamping the row index.
+template< typename TPel >
+SIMD_TARGET( "sse2" )
+static ErrVal xFilterFrameSSE2( TPel* pSrc, Int iSrcStride, Int iWidth, Int iHeight, Int iMargin, TPel* pDesHP, Int iDesStrideHP )
+{
+  Int     iStart      = -iMargin;
+  Int     iEnd        = iWidth + iMargin;
+  Int     iTmpStride  = 2 * ( iEnd - iStart );
+  Short*  psTemp      = new Short[ iTmpStride * iHeight ];
+  ROT( NULL == psTemp );
+
+  //----- horizontal -----
+  Short*  ps          = psTemp - 2*iStart;
+  for( Int y = 0; y < iHeight; y++, ps += iTmpStride, pSrc += iSrcStride )
+  {
+    Int x = iStart;
+    for( ; x + 8 <= iEnd; x += 8 )
+    {
+      __m128i iFull = _mm_slli_epi16( xLoad8( pSrc + x ), 5 );
+      __m128i iHalf = xTapHor<8>( pSrc + x );
+      _mm_storeu_si128( (__m128i*)( ps + 2*x     ), _mm_unpacklo_epi16( iFull, iHalf ) );
+      _mm_storeu_si128( (__m128i*)( ps + 2*x + 8 ), _mm_unpackhi_epi16( iFull, iHalf ) );
+    }
+    for( ; x < iEnd; x++ )
+    {
+      Int iTemp = 20 * ( pSrc[x] + pSrc[x+1] ) - 5 * ( pSrc[x-1] + pSrc[x+2] ) + pSrc[x-2] + pSrc[x+3];
+      ps[2*x]   = pSrc[x] << 5;
+      ps[2*x+1] = iTemp;
+    }
+  }
+
+  //----- vertical -----
+  pDesHP -= 2*iMargin*iDesStrideHP;
+  for( Int y = -iMargin; y < iHeight + iMargin; y++, pDesHP += 2*iDesStrideHP )
+  {
+    const Short* apsRow[6];
+    for( Int n = 0; n < 6; n++ )
+    {
+      apsRow[n] = psTemp - 2*iStart + gClipMinMax( y + n - 2, 0, iHeight - 1 ) * iTmpStride;
+    }
+    TPel* pFull = pDesHP;
+    TPel* pHalf = pDesHP + iDesStrideHP;
+
+    Int x = 2*iStart;
+    for( ; x + 8 <= 2*iEnd; x += 8 )
+    {
+      __m128i iRow2 = xLoad8( apsRow[2] + x );
+      xStore8( pFull + x, xRound( iRow2 ) );
+      xStore8( pHalf + x, x6Tap2( xLoad8( apsRow[0] + x ), xLoad8( apsRow[1] + x ), iRow2,
+                                  xLoad8( apsRow[3] + x ), xLoad8( apsRow[4] + x ), xLoad8( apsRow[5] + x ) ) );
+    }
+    for( ; x < 2*iEnd; x++ )
+    {
+      Int iTemp = 20 * ( apsRow[2][x] + apsRow[3][x] ) - 5 * ( apsRow[1][x] + apsRow[4][x] ) + apsRow[0][x] + apsRow[5][x];
+      pFull[x]  = gClip( ( apsRow[2][x] + 16 ) >> 5 );
+      pHalf[x]  = gClip( ( iTemp + 512 ) >> 10 );
+    }
+  }
+
+  delete [] psTemp;
+  return Err::m_nOK;
+}
+
+#endif
+
+
+Void QuarterPelFilter::xInitSIMDFunctions( UInt uiSIMDFlags )
+{
+#if defined( H264AVC_X86_SIMD )
+  if( uiSIMDFlags & SIMD_SSE2 )
+  {
+    xSetPredLumaKernels<16,Pel >( m_aafpPredLumaFunc [0] );
+    xSetPredLumaKernels< 8,Pel >( m_aafpPredLumaFunc [1] );
+    xSetPredLumaKernels< 4,Pel >( m_aafpPredLumaFunc [2] );
+    xSetPredLumaKernels<16,XPel>( m_aafpXPredLumaFunc[0] );
+    xSetPredLumaKernels< 8,XPel>( m_aafpXPredLumaFunc[1] );
+    xSetPredLumaKernels< 4,XPel>( m_aafpXPredLumaFunc[2] );
+    m_fpFilterFrameFunc  = xFilterFrameSSE2<Pel >;
+    m_fpXFilterFrameFunc = xFilterFrameSSE2<XPel>;
+  }
+#endif
+}
+
+
+H264AVC_NAMESPACE_END
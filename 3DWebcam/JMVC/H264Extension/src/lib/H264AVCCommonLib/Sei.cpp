@@ -14,7 +14,8 @@ ErrVal
 //SEI::read( HeaderSymbolReadIf* pcReadIf,
 //           MessageList&        rcSEIMessageList ) 
 SEI::read( HeaderSymbolReadIf* pcReadIf,
-           MessageList&        rcSEIMessageList /*, UInt NumViewsMinus1*/ )  // SEI JVT-W060 Nov. 30
+           MessageList&        rcSEIMessageList /*, UInt NumViewsMinus1*/,  // SEI JVT-W060 Nov. 30
+           ParameterSetMng*    pcParameterSetMng )
 {
   ROT( NULL == pcReadIf);
 
@@ -23,7 +24,7 @@ SEI::read( HeaderSymbolReadIf* pcReadIf,
     SEIMessage* pcActualSEIMessage = NULL;
 	
 	//    RNOK( xRead( pcReadIf, pcActualSEIMessage ));
-	RNOK( xRead( pcReadIf, pcActualSEIMessage /*, NumViewsMinus1 */)); // SEI JVT-W060 Nov. 30
+	RNOK( xRead( pcReadIf, pcActualSEIMessage /*, NumViewsMinus1 */, pcParameterSetMng )); // SEI JVT-W060 Nov. 30
 
 
     rcSEIMessageList.push_back( pcActualSEIMessage );
@@ -822,7 +823,8 @@ ErrVal
 //SEI::xRead( HeaderSymbolReadIf* pcReadIf,
 //            SEIMessage*&        rpcSEIMessage) 
 SEI::xRead( HeaderSymbolReadIf* pcReadIf,
-            SEIMessage*&        rpcSEIMessage /*, UInt NumViewsMinus1 */) // SEI JVT-W060 Nov. 30
+            SEIMessage*&        rpcSEIMessage /*, UInt NumViewsMinus1 */, // SEI JVT-W060 Nov. 30
+            ParameterSetMng*    pcParameterSetMng )
 {
   MessageType eMessageType = RESERVED_SEI;
   UInt        uiSize       = 0;
@@ -838,12 +840,13 @@ if( eMessageType == VIEW_DEPENDENCY_STRUCTURE_SEI )
 	return Err::m_nOK;
 }
 //JVT-AB025 }}
-//JVT-W080, omit parsing
+//JVT-W080, omit parsing when the SPS is not known to the caller
   if( eMessageType == PARALLEL_DEC_SEI )
 	{
-//		ParallelDecodingSEI* pcPdSEI = (ParallelDecodingSEI*)rpcSEIMessage;
-// fix for Liu Hui, Ying
-
+    if( pcParameterSetMng )
+    {
+      RNOK( ((ParallelDecodingSEI*)rpcSEIMessage)->read( pcReadIf, pcParameterSetMng ) );
+    }
 		return Err::m_nOK;   
 	}
 //~JVT-W080
@@ -2114,6 +2117,13 @@ SEI::ParallelDecodingSEI::create( ParallelDecodingSEI*& rpcSeiMessage )
 	return Err::m_nOK;
 }
 
+ErrVal
+SEI::ParallelDecodingSEI::destroy()
+{
+	delete this;
+	return Err::m_nOK;
+}
+
 ErrVal       
 SEI::ParallelDecodingSEI::init( UInt uiSPSId
 															, UInt uiNumView
@@ -2152,18 +2162,18 @@ SEI::ParallelDecodingSEI::init( UInt uiSPSId
 		{
       m_ppuiPDIInitDelayMinus2L1Anc[i] = new UInt [num_refs_list1_anc[i]];
       for( UInt j = 0; j < num_refs_list1_anc[i]; j++ )
-				m_ppuiPDIInitDelayMinus2L1Anc[i][j] = PDSInitialDelayNonAnc-2;
+				m_ppuiPDIInitDelayMinus2L1Anc[i][j] = PDSInitialDelayAnc-2;
 		}	
 		if( num_refs_list0_nonanc[i] )
 		{
       m_ppuiPDIInitDelayMinus2L0NonAnc[i] = new UInt [num_refs_list0_nonanc[i]];
-			for( UInt j = 0; j < num_refs_list0_anc[i]; j++ )
+			for( UInt j = 0; j < num_refs_list0_nonanc[i]; j++ )
 				m_ppuiPDIInitDelayMinus2L0NonAnc[i][j] = PDSInitialDelayNonAnc-2;
 		}
 		if( num_refs_list1_nonanc[i] )
 		{
       m_ppuiPDIInitDelayMinus2L1NonAnc[i] = new UInt [num_refs_list1_nonanc[i]];
-			for( UInt j = 0; j < num_refs_list1_anc[i]; j++ )
+			for( UInt j = 0; j < num_refs_list1_nonanc[i]; j++ )
 				m_ppuiPDIInitDelayMinus2L1NonAnc[i][j] = PDSInitialDelayNonAnc-2;
 		}
 	}
@@ -2180,7 +2190,7 @@ SEI::ParallelDecodingSEI::write( HeaderSymbolWriteIf *pcWriteIf )
 	pcWriteIf->writeUvlc( m_uiSPSId, "SEI:PDSEI: PdsSeqParameterSetId");
 	for( UInt uiNumView = 0; uiNumView <= uiNumViewMinus1; uiNumView++ )
 	{
-		for( j = 1; j < m_puiNumRefAnchorFramesL0[uiNumView]; j++ )//SEI JJ
+		for( j = 0; j < m_puiNumRefAnchorFramesL0[uiNumView]; j++ )//SEI JJ
 	  {
 			pcWriteIf->writeUvlc( m_ppuiPDIInitDelayMinus2L0Anc[uiNumView][j], "SEI:PDSEI: PdsInitialDelayMinus2L0Anc");
 		}
@@ -2207,6 +2217,83 @@ SEI::ParallelDecodingSEI::read ( HeaderSymbolReadIf *pcReadIf )
 */
 	return Err::m_nOK;
 }
+
+ErrVal
+SEI::ParallelDecodingSEI::read ( HeaderSymbolReadIf *pcReadIf, ParameterSetMng* pcParameterSetMng )
+{
+  ROT( NULL == pcParameterSetMng );
+  ROT( m_uiNumView );
+
+  RNOK( pcReadIf->getUvlc( m_uiSPSId, "SEI:PDSEI: PdsSeqParameterSetId" ) );
+
+  //===== the numbers of delays follow the view dependencies of the subset SPS =====
+  SequenceParameterSet* pcSPS = NULL;
+  ROTRS( ! pcParameterSetMng->isValidSPS( m_uiSPSId ), Err::m_nOK );
+  RNOK ( pcParameterSetMng->get( pcSPS, m_uiSPSId ) );
+  ROTRS( pcSPS->getProfileIdc() != MULTI_VIEW_PROFILE && pcSPS->getProfileIdc() != STEREO_HIGH_PROFILE, Err::m_nOK );
+  ROTRS( NULL == pcSPS->getSpsMVC(), Err::m_nOK );
+
+  SpsMvcExtension&       rcSpsMVC  = *pcSPS->getSpsMVC();
+  UInt                   uiNumView = rcSpsMVC.getNumViewMinus1() + 1;
+
+  m_puiNumRefAnchorFramesL0        = new UInt [uiNumView];
+  m_puiNumRefAnchorFramesL1        = new UInt [uiNumView];
+  m_puiNumNonRefAnchorFramesL0     = new UInt [uiNumView];
+  m_puiNumNonRefAnchorFramesL1     = new UInt [uiNumView];
+  m_ppuiPDIInitDelayMinus2L0Anc    = new UInt*[uiNumView];
+  m_ppuiPDIInitDelayMinus2L1Anc    = new UInt*[uiNumView];
+  m_ppuiPDIInitDelayMinus2L0NonAnc = new UInt*[uiNumView];
+  m_ppuiPDIInitDelayMinus2L1NonAnc = new UInt*[uiNumView];
+  m_uiNumView                      = uiNumView;
+
+  for( UInt i = 0; i < uiNumView; i++ )
+  {
+    UInt uiViewId = rcSpsMVC.getViewCodingOrder()[i];
+    m_puiNumRefAnchorFramesL0   [i] = rcSpsMVC.getNumAnchorRefsForListX   ( uiViewId, LIST_0 );
+    m_puiNumRefAnchorFramesL1   [i] = rcSpsMVC.getNumAnchorRefsForListX   ( uiViewId, LIST_1 );
+    m_puiNumNonRefAnchorFramesL0[i] = rcSpsMVC.getNumNonAnchorRefsForListX( uiViewId, LIST_0 );
+    m_puiNumNonRefAnchorFramesL1[i] = rcSpsMVC.getNumNonAnchorRefsForListX( uiViewId, LIST_1 );
+    m_ppuiPDIInitDelayMinus2L0Anc   [i] = ( m_puiNumRefAnchorFramesL0   [i] ? new UInt[m_puiNumRefAnchorFramesL0   [i]] : NULL );
+    m_ppuiPDIInitDelayMinus2L1Anc   [i] = ( m_puiNumRefAnchorFramesL1   [i] ? new UInt[m_puiNumRefAnchorFramesL1   [i]] : NULL );
+    m_ppuiPDIInitDelayMinus2L0NonAnc[i] = ( m_puiNumNonRefAnchorFramesL0[i] ? new UInt[m_puiNumNonRefAnchorFramesL0[i]] : NULL );
+    m_ppuiPDIInitDelayMinus2L1NonAnc[i] = ( m_puiNumNonRefAnchorFramesL1[i] ? new UInt[m_puiNumNonRefAnchorFramesL1[i]] : NULL );
+  }
+
+  UInt j;
+  for( UInt uiView = 0; uiView < uiNumView; uiView++ )
+  {
+    for( j = 0; j < m_puiNumRefAnchorFramesL0[uiView]; j++ )
+    {
+      RNOK( pcReadIf->getUvlc( m_ppuiPDIInitDelayMinus2L0Anc[uiView][j], "SEI:PDSEI: PdsInitialDelayMinus2L0Anc" ) );
+    }
+    for( j = 0; j < m_puiNumRefAnchorFramesL1[uiView]; j++ )
+    {
+      RNOK( pcReadIf->getUvlc( m_ppuiPDIInitDelayMinus2L1Anc[uiView][j], "SEI:PDSEI: PdsInitialDelayMinus2L1Anc" ) );
+    }
+    for( j = 0; j < m_puiNumNonRefAnchorFramesL0[uiView]; j++ )
+    {
+      RNOK( pcReadIf->getUvlc( m_ppuiPDIInitDelayMinus2L0NonAnc[uiView][j], "SEI:PDSEI: PdsInitialDelayMinus2L0NonAnc" ) );
+    }
+    for( j = 0; j < m_puiNumNonRefAnchorFramesL1[uiView]; j++ )
+    {
+      RNOK( pcReadIf->getUvlc( m_ppuiPDIInitDelayMinus2L1NonAnc[uiView][j], "SEI:PDSEI: PdsInitialDelayMinus2L1NonAnc" ) );
+    }
+  }
+  return Err::m_nOK;
+}
+
+UInt
+SEI::ParallelDecodingSEI::getPDIInitDelay( UInt uiViewIdx, Bool bAnchor, ListIdx eListIdx, UInt uiRef ) const
+{
+  ROTRS( uiViewIdx >= m_uiNumView, 0 );
+
+  UInt*  puiNum   = ( bAnchor ? ( eListIdx == LIST_0 ? m_puiNumRefAnchorFramesL0     : m_puiNumRefAnchorFramesL1     )
+                              : ( eListIdx == LIST_0 ? m_puiNumNonRefAnchorFramesL0  : m_puiNumNonRefAnchorFramesL1  ) );
+  UInt** ppuiDelay = ( bAnchor ? ( eListIdx == LIST_0 ? m_ppuiPDIInitDelayMinus2L0Anc    : m_ppuiPDIInitDelayMinus2L1Anc    )
+                               : ( eListIdx == LIST_0 ? m_ppuiPDIInitDelayMinus2L0NonAnc : m_ppuiPDIInitDelayMinus2L1NonAnc ) );
+  ROTRS( uiRef >= puiNum[uiViewIdx], 0 );
+  return ppuiDelay[uiViewIdx][uiRef] + 2;
+}
 //~JVT-W080
 
 
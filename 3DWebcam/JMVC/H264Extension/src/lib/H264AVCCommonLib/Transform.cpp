@@ -8,7 +8,10 @@ H264AVC_NAMESPACE_BEGIN
 
 
 Transform::Transform()
-: m_bClip( true )
+: m_bClip                 ( true )
+, m_bSelfCheck            ( false )
+, m_fpTransform8x8MbFunc  ( NULL )
+, m_fpTransform4x4MbFunc  ( NULL )
 {
 }
 
@@ -34,6 +37,23 @@ ErrVal Transform::destroy()
   return Err::m_nOK;
 }
 
+
+ErrVal Transform::init( UInt uiSIMDFlags, Bool bSelfCheck )
+{
+  m_bSelfCheck = bSelfCheck;
+
+  xInitSIMDFunctions( uiSIMDFlags & CpuInfo::getSIMDFlags() );
+  return Err::m_nOK;
+}
+
+
+ErrVal Transform::uninit()
+{
+  m_fpTransform8x8MbFunc = NULL;
+  m_fpTransform4x4MbFunc = NULL;
+  return Err::m_nOK;
+}
+
 ErrVal Transform::invTransform4x4Blk( Pel* puc, Int iStride, TCoeff* piCoeff )
 {
   xInvTransform4x4Blk( puc, iStride, piCoeff );
@@ -569,6 +589,87 @@ ErrVal Transform::transform4x4Blk( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pc
 
 
 
+ErrVal Transform::transform4x4Mb( IntYuvMbBuffer* pcOrgData, IntYuvMbBuffer* pcPelData, TCoeff* piCoeff, const UChar* pucScale, UInt* puiAbsSum, UInt& ruiCbp )
+{
+  XPel* pOrg    = pcOrgData->getMbLumAddr();
+  XPel* pRec    = pcPelData->getMbLumAddr();
+  Int   iStride = pcPelData->getLStride();
+
+  //===== the SIMD kernels always clip and support flat quantization only =====
+  if( NULL == m_fpTransform4x4MbFunc || NULL != pucScale || ! m_bClip )
+  {
+    ruiCbp = xTransform4x4Mb( pOrg, pRec, iStride, piCoeff, pucScale, puiAbsSum );
+    return Err::m_nOK;
+  }
+  if( ! m_bSelfCheck )
+  {
+    ruiCbp = m_fpTransform4x4MbFunc( pOrg, pRec, iStride, piCoeff, m_cLumaQp, puiAbsSum );
+    return Err::m_nOK;
+  }
+
+  //===== self check: compare with the scalar results, which are kept =====
+  XPel    asPred  [16*16];
+  XPel    asRec   [16*16];
+  TCoeff  aiCoeff [16*16];
+  UInt    auiAbsSum[16];
+  Int     y;
+  for( y = 0; y < 16; y++ )
+  {
+    ::memcpy( asPred + 16*y, pRec + y*iStride, 16*sizeof(XPel) );
+  }
+  UInt uiCbp  = m_fpTransform4x4MbFunc( pOrg, pRec, iStride, aiCoeff, m_cLumaQp, auiAbsSum );
+  for( y = 0; y < 16; y++ )
+  {
+    ::memcpy( asRec + 16*y, pRec + y*iStride, 16*sizeof(XPel) );
+    ::memcpy( pRec + y*iStride, asPred + 16*y, 16*sizeof(XPel) );
+  }
+  ruiCbp      = xTransform4x4Mb( pOrg, pRec, iStride, piCoeff, pucScale, puiAbsSum );
+
+  if( uiCbp != ruiCbp || ! xIsEqualMb( asRec, aiCoeff, auiAbsSum, pRec, iStride, piCoeff, puiAbsSum, 16 ) )
+  {
+    CpuInfo::reportMismatch( "Transform::transform4x4Mb" );
+  }
+  return Err::m_nOK;
+}
+
+
+UInt Transform::xTransform4x4Mb( XPel* pOrg, XPel* pRec, Int iStride, TCoeff* piCoeff, const UChar* pucScale, UInt* puiAbsSum )
+{
+  UInt uiCbp = 0;
+
+  for( B4x4Idx cIdx; cIdx.isLegal(); cIdx++ )
+  {
+    TCoeff  aiTemp[16];
+    Int     iOffset = 4 * ( cIdx.x() + cIdx.y() * iStride );
+
+    xForTransform4x4Blk( pOrg + iOffset, pRec + iOffset, iStride, aiTemp );
+    xQuantDequantUniform4x4( piCoeff + 16*cIdx.b4x4(), aiTemp, m_cLumaQp, pucScale, puiAbsSum[cIdx.b4x4()] );
+
+    if( puiAbsSum[cIdx.b4x4()] )
+    {
+      xInvTransform4x4Blk( pRec + iOffset, iStride, aiTemp );
+      uiCbp |= 1 << cIdx.b4x4();
+    }
+  }
+
+  return uiCbp;
+}
+
+
+Bool Transform::xIsEqualMb( const XPel* psRecA, const TCoeff* piCoeffA, const UInt* puiAbsSumA,
+                            const XPel* psRecB, Int iStrideB, const TCoeff* piCoeffB, const UInt* puiAbsSumB, UInt uiNumBlocks )
+{
+  for( Int y = 0; y < 16; y++ )
+  {
+    ROFRS( 0 == ::memcmp( psRecA + 16*y, psRecB + y*iStrideB, 16*sizeof(XPel) ), false );
+  }
+  ROFRS( 0 == ::memcmp( piCoeffA,   piCoeffB,   16*16      *sizeof(TCoeff) ), false );
+  ROFRS( 0 == ::memcmp( puiAbsSumA, puiAbsSumB, uiNumBlocks*sizeof(UInt)   ), false );
+  return true;
+}
+
+
+
 ErrVal
 Transform::requant4x4Block( IntYuvMbBuffer& rcResData,
                             TCoeff*         piCoeff,
@@ -908,6 +1009,87 @@ Transform::transform8x8Blk( IntYuvMbBuffer* pcOrgData,
 
 
 
+ErrVal
+Transform::transform8x8Mb( IntYuvMbBuffer* pcOrgData,
+                           IntYuvMbBuffer* pcPelData,
+                           TCoeff*         piCoeff,
+                           const UChar*    pucScale,
+                           UInt*           puiAbsSum,
+                           UInt&           ruiCbp )
+{
+  XPel* pOrg    = pcOrgData->getMbLumAddr();
+  XPel* pRec    = pcPelData->getMbLumAddr();
+  Int   iStride = pcPelData->getLStride();
+
+  //===== the SIMD kernels always clip and support flat quantization only =====
+  if( NULL == m_fpTransform8x8MbFunc || NULL != pucScale || ! m_bClip )
+  {
+    ruiCbp = xTransform8x8Mb( pOrg, pRec, iStride, piCoeff, pucScale, puiAbsSum );
+    return Err::m_nOK;
+  }
+  if( ! m_bSelfCheck )
+  {
+    ruiCbp = m_fpTransform8x8MbFunc( pOrg, pRec, iStride, piCoeff, m_cLumaQp, puiAbsSum );
+    return Err::m_nOK;
+  }
+
+  //===== self check: compare with the scalar results, which are kept =====
+  XPel    asPred  [16*16];
+  XPel    asRec   [16*16];
+  TCoeff  aiCoeff [16*16];
+  UInt    auiAbsSum[4];
+  Int     y;
+  for( y = 0; y < 16; y++ )
+  {
+    ::memcpy( asPred + 16*y, pRec + y*iStride, 16*sizeof(XPel) );
+  }
+  UInt uiCbp  = m_fpTransform8x8MbFunc( pOrg, pRec, iStride, aiCoeff, m_cLumaQp, auiAbsSum );
+  for( y = 0; y < 16; y++ )
+  {
+    ::memcpy( asRec + 16*y, pRec + y*iStride, 16*sizeof(XPel) );
+    ::memcpy( pRec + y*iStride, asPred + 16*y, 16*sizeof(XPel) );
+  }
+  ruiCbp      = xTransform8x8Mb( pOrg, pRec, iStride, piCoeff, pucScale, puiAbsSum );
+
+  if( uiCbp != ruiCbp || ! xIsEqualMb( asRec, aiCoeff, auiAbsSum, pRec, iStride, piCoeff, puiAbsSum, 4 ) )
+  {
+    CpuInfo::reportMismatch( "Transform::transform8x8Mb" );
+  }
+  return Err::m_nOK;
+}
+
+
+UInt
+Transform::xTransform8x8Mb( XPel*         pOrg,
+                            XPel*         pRec,
+                            Int           iStride,
+                            TCoeff*       piCoeff,
+                            const UChar*  pucScale,
+                            UInt*         puiAbsSum )
+{
+  UInt uiCbp = 0;
+
+  for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
+  {
+    TCoeff  aiTemp[64];
+    UInt    uiBlk   = c8x8Idx.b8x8Index();
+    Int     iOffset = 8 * ( ( uiBlk & 1 ) + ( uiBlk >> 1 ) * iStride );
+
+    xForTransform8x8Blk     ( pOrg + iOffset, pRec + iOffset, iStride, aiTemp );
+    xQuantDequantUniform8x8 ( piCoeff + 64*uiBlk, aiTemp, m_cLumaQp, pucScale, puiAbsSum[uiBlk] );
+    invTransform8x8Blk      ( pRec + iOffset, iStride, aiTemp );
+
+    if( puiAbsSum[uiBlk] )
+    {
+      uiCbp |= 0x33 << c8x8Idx.b4x4();
+    }
+  }
+
+  return uiCbp;
+}
+
+
+
 ErrVal
 Transform::invTransform8x8Blk( XPel*    puc,
                                Int      iStride, 
@@ -0,0 +1,411 @@
+#include "H264AVCCommonLib.h"
+
+#include "H264AVCCommonLib/Tables.h"
+#include "H264AVCCommonLib/Transform.h"
+
+#if defined( H264AVC_X86_SIMD )
+#include <emmintrin.h>
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+// The SIMD kernels give the same results as the scalar code in Transform.cpp
+// for flat quantization ( no scaling matrix ) with clipping enabled:
+//
+// - The butterflies work on 32 bit lanes in the same order as the scalar
+//   code ( horizontal first, then vertical ), so that the >> 1 and >> 2 of
+//   intermediate values are identical. Stores to TCoeff truncate like the
+//   scalar assignments do.
+// - The quantization products | c | * q are below 2^31 and are computed
+//   exactly from pmullw / pmulhuw. The dequantized values of the 4x4 blocks
+//   are truncated to 16 bit, which is exactly what pmullw / psllw return.
+// - Blocks without levels are not inverse transformed. The scalar 8x8 code
+//   adds a zero residual in this case, which does not change the already
+//   clipped prediction.
+
+
+#if defined( H264AVC_X86_SIMD )
+
+//===== sign extended 32 bit lanes of 4 samples =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad4( const XPel* p )
+{
+  __m128i i = _mm_loadl_epi64( (const __m128i*)p );
+  return _mm_srai_epi32( _mm_unpacklo_epi16( i, i ), 16 );
+}
+
+//===== packs 8 lanes to 16 bit with the truncation of an assignment to Short =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xPackTrunc( __m128i iLo, __m128i iHi )
+{
+  iLo = _mm_srai_epi32( _mm_slli_epi32( iLo, 16 ), 16 );
+  iHi = _mm_srai_epi32( _mm_slli_epi32( iHi, 16 ), 16 );
+  return _mm_packs_epi32( iLo, iHi );
+}
+
+//===== sign extension of 16 bit lanes =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xExtendLo( __m128i i )
+{
+  return _mm_srai_epi32( _mm_unpacklo_epi16( i, i ), 16 );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xExtendHi( __m128i i )
+{
+  return _mm_srai_epi32( _mm_unpackhi_epi16( i, i ), 16 );
+}
+
+SIMD_TARGET( "sse2" )
+static inline UInt xHorSum( __m128i i )
+{
+  i = _mm_add_epi32( i, _mm_shuffle_epi32( i, 0x4e ) );
+  i = _mm_add_epi32( i, _mm_shuffle_epi32( i, 0xb1 ) );
+  return (UInt)_mm_cvtsi128_si32( i );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xTranspose4x4( __m128i* p )
+{
+  __m128i i0 = _mm_unpacklo_epi32( p[0], p[1] );
+  __m128i i1 = _mm_unpacklo_epi32( p[2], p[3] );
+  __m128i i2 = _mm_unpackhi_epi32( p[0], p[1] );
+  __m128i i3 = _mm_unpackhi_epi32( p[2], p[3] );
+  p[0] = _mm_unpacklo_epi64( i0, i1 );
+  p[1] = _mm_unpackhi_epi64( i0, i1 );
+  p[2] = _mm_unpacklo_epi64( i2, i3 );
+  p[3] = _mm_unpackhi_epi64( i2, i3 );
+}
+
+//===== aai[h][r] holds the columns 4*h ... 4*h+3 of row r =====
+SIMD_TARGET( "sse2" )
+static inline Void xTranspose8x8( __m128i aai[2][8] )
+{
+  xTranspose4x4( aai[0]     );
+  xTranspose4x4( aai[0] + 4 );
+  xTranspose4x4( aai[1]     );
+  xTranspose4x4( aai[1] + 4 );
+  for( Int n = 0; n < 4; n++ )
+  {
+    __m128i i     = aai[0][4+n];
+    aai[0][4+n]   = aai[1][n];
+    aai[1][n]     = i;
+  }
+}
+
+
+//===== one dimensional transforms applied across the registers p[0] ... p[N-1] =====
+SIMD_TARGET( "sse2" )
+static inline Void xForward4( __m128i* p )
+{
+  __m128i iSum0 = _mm_add_epi32( p[0], p[3] );
+  __m128i iSum1 = _mm_add_epi32( p[1], p[2] );
+  __m128i iDif0 = _mm_sub_epi32( p[0], p[3] );
+  __m128i iDif1 = _mm_sub_epi32( p[1], p[2] );
+
+  p[0] = _mm_add_epi32( iSum0, iSum1 );
+  p[2] = _mm_sub_epi32( iSum0, iSum1 );
+  p[1] = _mm_add_epi32( _mm_add_epi32( iDif0, iDif0 ), iDif1 );
+  p[3] = _mm_sub_epi32( iDif0, _mm_add_epi32( iDif1, iDif1 ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xInverse4( __m128i* p )
+{
+  __m128i iTmp1 = _mm_add_epi32( p[0], p[2] );
+  __m128i iTmp2 = _mm_add_epi32( _mm_srai_epi32( p[3], 1 ), p[1] );
+  __m128i iTmp3 = _mm_sub_epi32( p[0], p[2] );
+  __m128i iTmp4 = _mm_sub_epi32( _mm_srai_epi32( p[1], 1 ), p[3] );
+
+  p[0] = _mm_add_epi32( iTmp1, iTmp2 );
+  p[3] = _mm_sub_epi32( iTmp1, iTmp2 );
+  p[1] = _mm_add_epi32( iTmp3, iTmp4 );
+  p[2] = _mm_sub_epi32( iTmp3, iTmp4 );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xForward8( __m128i* p )
+{
+  __m128i ai1[8];
+  __m128i ai2[8];
+
+  ai1[0] = _mm_add_epi32( p[0], p[7] );
+  ai1[1] = _mm_add_epi32( p[1], p[6] );
+  ai1[2] = _mm_add_epi32( p[2], p[5] );
+  ai1[3] = _mm_add_epi32( p[3], p[4] );
+  ai1[4] = _mm_sub_epi32( p[0], p[7] );
+  ai1[5] = _mm_sub_epi32( p[1], p[6] );
+  ai1[6] = _mm_sub_epi32( p[2], p[5] );
+  ai1[7] = _mm_sub_epi32( p[3], p[4] );
+
+  ai2[0] = _mm_add_epi32( ai1[0], ai1[3] );
+  ai2[1] = _mm_add_epi32( ai1[1], ai1[2] );
+  ai2[2] = _mm_sub_epi32( ai1[0], ai1[3] );
+  ai2[3] = _mm_sub_epi32( ai1[1], ai1[2] );
+  ai2[4] = _mm_add_epi32( _mm_add_epi32( ai1[5], ai1[6] ), _mm_add_epi32( _mm_srai_epi32( ai1[4], 1 ), ai1[4] ) );
+  ai2[5] = _mm_sub_epi32( _mm_sub_epi32( ai1[4], ai1[7] ), _mm_add_epi32( _mm_srai_epi32( ai1[6], 1 ), ai1[6] ) );
+  ai2[6] = _mm_sub_epi32( _mm_add_epi32( ai1[4], ai1[7] ), _mm_add_epi32( _mm_srai_epi32( ai1[5], 1 ), ai1[5] ) );
+  ai2[7] = _mm_add_epi32( _mm_sub_epi32( ai1[5], ai1[6] ), _mm_add_epi32( _mm_srai_epi32( ai1[7], 1 ), ai1[7] ) );
+
+  p[0] = _mm_add_epi32( ai2[0], ai2[1] );
+  p[2] = _mm_add_epi32( ai2[2], _mm_srai_epi32( ai2[3], 1 ) );
+  p[4] = _mm_sub_epi32( ai2[0], ai2[1] );
+  p[6] = _mm_sub_epi32( _mm_srai_epi32( ai2[2], 1 ), ai2[3] );
+  p[1] = _mm_add_epi32( ai2[4], _mm_srai_epi32( ai2[7], 2 ) );
+  p[3] = _mm_add_epi32( ai2[5], _mm_srai_epi32( ai2[6], 2 ) );
+  p[5] = _mm_sub_epi32( ai2[6], _mm_srai_epi32( ai2[5], 2 ) );
+  p[7] = _mm_sub_epi32( _mm_srai_epi32( ai2[4], 2 ), ai2[7] );
+}
+
+SIMD_TARGET( "sse2" )
+static inline Void xInverse8( __m128i* p )
+{
+  __m128i ai1[8];
+  __m128i ai2[8];
+
+  ai1[0] = _mm_add_epi32( p[0], p[4] );
+  ai1[2] = _mm_sub_epi32( p[0], p[4] );
+  ai1[4] = _mm_sub_epi32( _mm_srai_epi32( p[2], 1 ), p[6] );
+  ai1[6] = _mm_add_epi32( p[2], _mm_srai_epi32( p[6], 1 ) );
+  ai1[1] = _mm_sub_epi32( _mm_sub_epi32( p[5], p[3] ), _mm_add_epi32( p[7], _mm_srai_epi32( p[7], 1 ) ) );
+  ai1[3] = _mm_sub_epi32( _mm_add_epi32( p[1], p[7] ), _mm_add_epi32( p[3], _mm_srai_epi32( p[3], 1 ) ) );
+  ai1[5] = _mm_add_epi32( _mm_sub_epi32( p[7], p[1] ), _mm_add_epi32( p[5], _mm_srai_epi32( p[5], 1 ) ) );
+  ai1[7] = _mm_add_epi32( _mm_add_epi32( p[3], p[5] ), _mm_add_epi32( p[1], _mm_srai_epi32( p[1], 1 ) ) );
+
+  ai2[0] = _mm_add_epi32( ai1[0], ai1[6] );
+  ai2[6] = _mm_sub_epi32( ai1[0], ai1[6] );
+  ai2[2] = _mm_add_epi32( ai1[2], ai1[4] );
+  ai2[4] = _mm_sub_epi32( ai1[2], ai1[4] );
+  ai2[1] = _mm_add_epi32( ai1[1], _mm_srai_epi32( ai1[7], 2 ) );
+  ai2[7] = _mm_sub_epi32( ai1[7], _mm_srai_epi32( ai1[1], 2 ) );
+  ai2[3] = _mm_add_epi32( ai1[3], _mm_srai_epi32( ai1[5], 2 ) );
+  ai2[5] = _mm_sub_epi32( _mm_srai_epi32( ai1[3], 2 ), ai1[5] );
+
+  p[0] = _mm_add_epi32( ai2[0], ai2[7] );
+  p[1] = _mm_add_epi32( ai2[2], ai2[5] );
+  p[2] = _mm_add_epi32( ai2[4], ai2[3] );
+  p[3] = _mm_add_epi32( ai2[6], ai2[1] );
+  p[4] = _mm_sub_epi32( ai2[6], ai2[1] );
+  p[5] = _mm_sub_epi32( ai2[4], ai2[3] );
+  p[6] = _mm_sub_epi32( ai2[2], ai2[5] );
+  p[7] = _mm_sub_epi32( ai2[0], ai2[7] );
+}
+
+
+//===== quantization of 8 coefficients, returns the signed levels and accumulates their absolute sum =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xQuant( __m128i iCoeff, __m128i iQuant, __m128i iAdd, __m128i iShift, __m128i& riAbsSum )
+{
+  __m128i iSign   = _mm_srai_epi16( iCoeff, 15 );
+  __m128i iAbs    = _mm_sub_epi16( _mm_xor_si128( iCoeff, iSign ), iSign );
+  __m128i iLo     = _mm_mullo_epi16( iAbs, iQuant );
+  __m128i iHi     = _mm_mulhi_epu16( iAbs, iQuant );
+  __m128i iLevel0 = _mm_srl_epi32( _mm_add_epi32( _mm_unpacklo_epi16( iLo, iHi ), iAdd ), iShift );
+  __m128i iLevel1 = _mm_srl_epi32( _mm_add_epi32( _mm_unpackhi_epi16( iLo, iHi ), iAdd ), iShift );
+  __m128i iLevel  = _mm_packs_epi32( iLevel0, iLevel1 );
+
+  riAbsSum = _mm_add_epi32( riAbsSum, _mm_madd_epi16( iLevel, _mm_set1_epi16( 1 ) ) );
+  return _mm_sub_epi16( _mm_xor_si128( iLevel, iSign ), iSign );
+}
+
+//===== ( ( level * scale + add ) << per ) >> 6 of 8 levels, zero for zero levels =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xDequant8x8( __m128i iLevel, __m128i iDequant, __m128i iAdd, __m128i iPer )
+{
+  __m128i iLo     = _mm_mullo_epi16( iLevel, iDequant );
+  __m128i iHi     = _mm_mulhi_epi16( iLevel, iDequant );
+  __m128i iCoeff0 = _mm_srai_epi32( _mm_sll_epi32( _mm_add_epi32( _mm_unpacklo_epi16( iLo, iHi ), iAdd ), iPer ), 6 );
+  __m128i iCoeff1 = _mm_srai_epi32( _mm_sll_epi32( _mm_add_epi32( _mm_unpackhi_epi16( iLo, iHi ), iAdd ), iPer ), 6 );
+
+  return _mm_andnot_si128( _mm_cmpeq_epi16( iLevel, _mm_setzero_si128() ), xPackTrunc( iCoeff0, iCoeff1 ) );
+}
+
+//===== rounds the residual of 4 samples, adds the prediction and clips =====
+SIMD_TARGET( "sse2" )
+static inline __m128i xReconstruct( __m128i iRes, const XPel* pPred )
+{
+  iRes = _mm_srai_epi32( _mm_add_epi32( iRes, _mm_set1_epi32( 32 ) ), 6 );
+  return _mm_add_epi32( iRes, xLoad4( pPred ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xClip( __m128i iLo, __m128i iHi )
+{
+  __m128i iRec = _mm_packs_epi32( iLo, iHi );
+  return _mm_min_epi16( _mm_max_epi16( iRec, _mm_setzero_si128() ), _mm_set1_epi16( 255 ) );
+}
+
+
+SIMD_TARGET( "sse2" )
+static UInt xTransform4x4MbSSE2( XPel* pOrg, XPel* pRec, Int iStride, TCoeff* piCoeff, const QpParameter& rcQp, UInt* puiAbsSum )
+{
+  const Int*  piQuant   = g_aaiQuantCoef  [ rcQp.rem() ];
+  const Int*  piDequant = g_aaiDequantCoef[ rcQp.rem() ];
+  __m128i     aiQuant   [2];
+  __m128i     aiDequant [2];
+  __m128i     iAdd      = _mm_set1_epi32   ( rcQp.add () );
+  __m128i     iShift    = _mm_cvtsi32_si128( rcQp.bits() );
+  __m128i     iPer      = _mm_cvtsi32_si128( rcQp.per () );
+  UInt        uiCbp     = 0;
+
+  for( Int n = 0; n < 2; n++ )
+  {
+    aiQuant  [n] = _mm_packs_epi32( _mm_loadu_si128( (const __m128i*)( piQuant   + 8*n ) ), _mm_loadu_si128( (const __m128i*)( piQuant   + 8*n + 4 ) ) );
+    aiDequant[n] = _mm_packs_epi32( _mm_loadu_si128( (const __m128i*)( piDequant + 8*n ) ), _mm_loadu_si128( (const __m128i*)( piDequant + 8*n + 4 ) ) );
+  }
+
+  for( UInt uiBlk = 0; uiBlk < 16; uiBlk++, piCoeff += 16 )
+  {
+    Int     iOffset = 4 * ( ( uiBlk & 3 ) + ( uiBlk >> 2 ) * iStride );
+    XPel*   pO      = pOrg + iOffset;
+    XPel*   pR      = pRec + iOffset;
+    __m128i ai[4];
+    Int     y;
+
+    //===== forward transform =====
+    for( y = 0; y < 4; y++ )
+    {
+      ai[y] = _mm_sub_epi32( xLoad4( pO + y*iStride ), xLoad4( pR + y*iStride ) );
+    }
+    xTranspose4x4( ai );
+    xForward4    ( ai );
+    xTranspose4x4( ai );
+    xForward4    ( ai );
+
+    //===== quantization and dequantization =====
+    __m128i iAbsSum   = _mm_setzero_si128();
+    __m128i iLevel0   = xQuant( xPackTrunc( ai[0], ai[1] ), aiQuant[0], iAdd, iShift, iAbsSum );
+    __m128i iLevel1   = xQuant( xPackTrunc( ai[2], ai[3] ), aiQuant[1], iAdd, iShift, iAbsSum );
+    _mm_storeu_si128( (__m128i*)( piCoeff     ), iLevel0 );
+    _mm_storeu_si128( (__m128i*)( piCoeff + 8 ), iLevel1 );
+
+    puiAbsSum[uiBlk]  = xHorSum( iAbsSum );
+    if( 0 == puiAbsSum[uiBlk] )
+    {
+      continue;
+    }
+    uiCbp            |= 1 << uiBlk;
+
+    //===== inverse transform and reconstruction =====
+    __m128i iCoeff0   = _mm_sll_epi16( _mm_mullo_epi16( iLevel0, aiDequant[0] ), iPer );
+    __m128i iCoeff1   = _mm_sll_epi16( _mm_mullo_epi16( iLevel1, aiDequant[1] ), iPer );
+    ai[0] = xExtendLo( iCoeff0 );
+    ai[1] = xExtendHi( iCoeff0 );
+    ai[2] = xExtendLo( iCoeff1 );
+    ai[3] = xExtendHi( iCoeff1 );
+    xTranspose4x4( ai );
+    xInverse4    ( ai );
+    xTranspose4x4( ai );
+    xInverse4    ( ai );
+
+    for( y = 0; y < 4; y++ )
+    {
+      __m128i iRec = xReconstruct( ai[y], pR + y*iStride );
+      _mm_storel_epi64( (__m128i*)( pR + y*iStride ), xClip( iRec, iRec ) );
+    }
+  }
+
+  return uiCbp;
+}
+
+
+SIMD_TARGET( "sse2" )
+static UInt xTransform8x8MbSSE2( XPel* pOrg, XPel* pRec, Int iStride, TCoeff* piCoeff, const QpParameter& rcQp, UInt* puiAbsSum )
+{
+  const Int*  piQuant   = g_aaiQuantCoef64  [ rcQp.rem() ];
+  const Int*  piDequant = g_aaiDequantCoef64[ rcQp.rem() ];
+  __m128i     aiQuant   [8];
+  __m128i     aiDequant [8];
+  __m128i     iAdd      = _mm_set1_epi32   ( 2*rcQp.add() );
+  __m128i     iShift    = _mm_cvtsi32_si128( rcQp.bits() + 1 );
+  __m128i     iDeqAdd   = _mm_set1_epi32   ( ( 1 << 5 ) >> rcQp.per() );
+  __m128i     iPer      = _mm_cvtsi32_si128( rcQp.per () );
+  UInt        uiCbp     = 0;
+
+  for( Int n = 0; n < 8; n++ )
+  {
+    aiQuant  [n] = _mm_packs_epi32( _mm_loadu_si128( (const __m128i*)( piQuant + 8*n ) ), _mm_loadu_si128( (const __m128i*)( piQuant + 8*n + 4 ) ) );
+    aiDequant[n] = _mm_packs_epi32( _mm_slli_epi32( _mm_loadu_si128( (const __m128i*)( piDequant + 8*n     ) ), 4 ),
+                                    _mm_slli_epi32( _mm_loadu_si128( (const __m128i*)( piDequant + 8*n + 4 ) ), 4 ) );
+  }
+
+  for( UInt uiBlk = 0; uiBlk < 4; uiBlk++, piCoeff += 64 )
+  {
+    Int     iOffset = 8 * ( ( uiBlk & 1 ) + ( uiBlk >> 1 ) * iStride );
+    XPel*   pO      = pOrg + iOffset;
+    XPel*   pR      = pRec + iOffset;
+    __m128i aai[2][8];
+    __m128i aiLevel[8];
+    Int     n;
+
+    //===== forward transform =====
+    for( n = 0; n < 8; n++ )
+    {
+      aai[0][n] = _mm_sub_epi32( xLoad4( pO + n*iStride     ), xLoad4( pR + n*iStride     ) );
+      aai[1][n] = _mm_sub_epi32( xLoad4( pO + n*iStride + 4 ), xLoad4( pR + n*iStride + 4 ) );
+    }
+    xTranspose8x8( aai );
+    xForward8    ( aai[0] );
+    xForward8    ( aai[1] );
+    xTranspose8x8( aai );
+    xForward8    ( aai[0] );
+    xForward8    ( aai[1] );
+
+    //===== quantization =====
+    __m128i iAbsSum = _mm_setzero_si128();
+    for( n = 0; n < 8; n++ )
+    {
+      aiLevel[n] = xQuant( xPackTrunc( aai[0][n], aai[1][n] ), aiQuant[n], iAdd, iShift, iAbsSum );
+      _mm_storeu_si128( (__m128i*)( piCoeff + 8*n ), aiLevel[n] );
+    }
+
+    puiAbsSum[uiBlk]  = xHorSum( iAbsSum );
+    if( 0 == puiAbsSum[uiBlk] )
+    {
+      continue;
+    }
+    uiCbp            |= 0x33 << ( 2 * ( uiBlk & 1 ) + 8 * ( uiBlk >> 1 ) );
+
+    //===== dequantization, inverse transform and reconstruction =====
+    for( n = 0; n < 8; n++ )
+    {
+      __m128i iCoeff = xDequant8x8( aiLevel[n], aiDequant[n], iDeqAdd, iPer );
+      aai[0][n] = xExtendLo( iCoeff );
+      aai[1][n] = xExtendHi( iCoeff );
+    }
+    xTranspose8x8( aai );
+    xInverse8    ( aai[0] );
+    xInverse8    ( aai[1] );
+    xTranspose8x8( aai );
+    xInverse8    ( aai[0] );
+    xInverse8    ( aai[1] );
+
+    for( n = 0; n < 8; n++ )
+    {
+      __m128i iRecLo = xReconstruct( aai[0][n], pR + n*iStride     );
+      __m128i iRecHi = xReconstruct( aai[1][n], pR + n*iStride + 4 );
+      _mm_storeu_si128( (__m128i*)( pR + n*iStride ), xClip( iRecLo, iRecHi ) );
+    }
+  }
+
+  return uiCbp;
+}
+
+#endif
+
+
+Void Transform::xInitSIMDFunctions( UInt uiSIMDFlags )
+{
+#if defined( H264AVC_X86_SIMD )
+  if( uiSIMDFlags & SIMD_SSE2 )
+  {
+    m_fpTransform8x8MbFunc = xTransform8x8MbSSE2;
+    m_fpTransform4x4MbFunc = xTransform4x4MbSSE2;
+  }
+#endif
+}
+
+
+H264AVC_NAMESPACE_END
@@ -3,6 +3,8 @@
 
 H264AVC_NAMESPACE_BEGIN
 
+H264AVC_THREAD_LOCAL UInt YuvBufferCtrl::m_uiMbLane = 0;
+
 YuvBufferCtrl::YuvBufferCtrl() :
   m_uiChromaSize  ( 0 ),
   m_iResolution   ( 0 ),
@@ -52,22 +54,23 @@ ErrVal YuvBufferCtrl::initMb( UInt uiMbY, UInt uiMbX, Bool bMbAff )
     }
     UInt uiYPosFld  = (uiMbY<<3) << m_iResolution;
     Int  iStride    = m_acBufferParam[FRAME].m_iStride;
+    UInt uiLane     = m_uiMbLane;
 
-    m_acBufferParam[FRAME]    .m_uiCbOffset = m_uiCbBaseOffset + uiXPos + uiYPos    * iStride / 2;
-    m_acBufferParam[TOP_FIELD].m_uiCbOffset = m_uiCbBaseOffset + uiXPos + uiYPosFld * iStride;
+    m_acBufferParam[FRAME]    .m_auiCbOffset[uiLane] = m_uiCbBaseOffset + uiXPos + uiYPos    * iStride / 2;
+    m_acBufferParam[TOP_FIELD].m_auiCbOffset[uiLane] = m_uiCbBaseOffset + uiXPos + uiYPosFld * iStride;
 
-    m_acBufferParam[FRAME]    .m_uiCrOffset = m_acBufferParam[FRAME]    .m_uiCbOffset + m_uiChromaSize;
-    m_acBufferParam[TOP_FIELD].m_uiCrOffset = m_acBufferParam[TOP_FIELD].m_uiCbOffset + m_uiChromaSize;
+    m_acBufferParam[FRAME]    .m_auiCrOffset[uiLane] = m_acBufferParam[FRAME]    .m_auiCbOffset[uiLane] + m_uiChromaSize;
+    m_acBufferParam[TOP_FIELD].m_auiCrOffset[uiLane] = m_acBufferParam[TOP_FIELD].m_auiCbOffset[uiLane] + m_uiChromaSize;
     uiXPos    <<= 1;
     uiYPos    <<= 1;
     uiYPosFld <<= 1;
 
-    m_acBufferParam[FRAME]    .m_uiLumOffset  = m_uiLumBaseOffset + uiXPos + uiYPos    * iStride;
-    m_acBufferParam[TOP_FIELD].m_uiLumOffset  = m_uiLumBaseOffset + uiXPos + uiYPosFld * iStride * 2;
+    m_acBufferParam[FRAME]    .m_auiLumOffset[uiLane]  = m_uiLumBaseOffset + uiXPos + uiYPos    * iStride;
+    m_acBufferParam[TOP_FIELD].m_auiLumOffset[uiLane]  = m_uiLumBaseOffset + uiXPos + uiYPosFld * iStride * 2;
 
-    m_acBufferParam[BOT_FIELD].m_uiLumOffset  = m_acBufferParam[TOP_FIELD].m_uiLumOffset + iStride;
-    m_acBufferParam[BOT_FIELD].m_uiCbOffset   = m_acBufferParam[TOP_FIELD].m_uiCbOffset  + iStride / 2;
-    m_acBufferParam[BOT_FIELD].m_uiCrOffset   = m_acBufferParam[TOP_FIELD].m_uiCrOffset  + iStride / 2;
+    m_acBufferParam[BOT_FIELD].m_auiLumOffset[uiLane]  = m_acBufferParam[TOP_FIELD].m_auiLumOffset[uiLane] + iStride;
+    m_acBufferParam[BOT_FIELD].m_auiCbOffset[uiLane]   = m_acBufferParam[TOP_FIELD].m_auiCbOffset[uiLane]  + iStride / 2;
+    m_acBufferParam[BOT_FIELD].m_auiCrOffset[uiLane]   = m_acBufferParam[TOP_FIELD].m_auiCrOffset[uiLane]  + iStride / 2;
 
     return Err::m_nOK;
 }
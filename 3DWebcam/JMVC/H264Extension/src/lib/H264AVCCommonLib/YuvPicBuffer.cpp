@@ -155,22 +155,38 @@ ErrVal YuvPicBuffer::fillMargin()
 {
   m_rcYuvBufferCtrl.initMb();
 
-  xFillPlaneMargin( getMbLumAddr(), getLHeight(), getLWidth(), getLStride(), getLXMargin(), getLYMargin() );
-  xFillPlaneMargin( getMbCbAddr(),  getCHeight(), getCWidth(), getCStride(), getCXMargin(), getCYMargin() );
-  xFillPlaneMargin( getMbCrAddr(),  getCHeight(), getCWidth(), getCStride(), getCXMargin(), getCYMargin() );
+  xFillPlaneMargin( getMbLumAddr(), getLHeight(), getLWidth(), getLStride(), getLXMargin(), getLYMargin(), 0, getLHeight() );
+  xFillPlaneMargin( getMbCbAddr(),  getCHeight(), getCWidth(), getCStride(), getCXMargin(), getCYMargin(), 0, getCHeight() );
+  xFillPlaneMargin( getMbCrAddr(),  getCHeight(), getCWidth(), getCStride(), getCXMargin(), getCYMargin(), 0, getCHeight() );
 
   return Err::m_nOK;
 }
 
+ErrVal YuvPicBuffer::fillMarginRows( UInt uiStartRow, UInt uiStopRow )
+{
+  ROF( uiStartRow <= uiStopRow );
+  ROTRS( uiStartRow == uiStopRow, Err::m_nOK );
+
+  m_rcYuvBufferCtrl.initMb();
 
-Void YuvPicBuffer::xFillPlaneMargin( Pel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin )
+  Int iLStart = min( (Int)uiStartRow << 4, getLHeight() ), iLStop = min( (Int)uiStopRow << 4, getLHeight() );
+  Int iCStart = min( (Int)uiStartRow << 3, getCHeight() ), iCStop = min( (Int)uiStopRow << 3, getCHeight() );
+  xFillPlaneMargin( getMbLumAddr(), getLHeight(), getLWidth(), getLStride(), getLXMargin(), getLYMargin(), iLStart, iLStop );
+  xFillPlaneMargin( getMbCbAddr(),  getCHeight(), getCWidth(), getCStride(), getCXMargin(), getCYMargin(), iCStart, iCStop );
+  xFillPlaneMargin( getMbCrAddr(),  getCHeight(), getCWidth(), getCStride(), getCXMargin(), getCYMargin(), iCStart, iCStop );
+
+  return Err::m_nOK;
+}
+
+
+Void YuvPicBuffer::xFillPlaneMargin( Pel *pucDest, Int iHeight, Int iWidth, Int iStride, Int iXMargin, Int iYMargin, Int iStartLine, Int iStopLine )
 {
   Pel* puc;
   Int n;
 
   // left and right borders at once
-  puc = pucDest;
-  for( n = 0; n < iHeight; n++)
+  puc = pucDest + iStride * iStartLine;
+  for( n = iStartLine; n < iStopLine; n++)
   {
     // left border lum
     ::memset( puc - iXMargin, puc[0],         iXMargin );
@@ -180,20 +196,26 @@ Void YuvPicBuffer::xFillPlaneMargin( Pel *pucDest, Int iHeight, Int iWidth, Int
   }
 
   // bot border lum
-  puc = pucDest - iXMargin + iStride * iHeight;
   UInt uiSize = iWidth + 2*iXMargin;
-  for( n = 0; n < iYMargin; n++)
+  if( iStopLine == iHeight )
   {
-    ::memcpy( puc, puc - iStride, uiSize );
-    puc += iStride;
+    puc = pucDest - iXMargin + iStride * iHeight;
+    for( n = 0; n < iYMargin; n++)
+    {
+      ::memcpy( puc, puc - iStride, uiSize );
+      puc += iStride;
+    }
   }
 
   // top border lum
-  puc = pucDest - iXMargin;
-  for( n = 0; n < iYMargin; n++)
+  if( iStartLine == 0 )
   {
-    ::memcpy( puc - iStride, puc, uiSize );
-    puc -= iStride;
+    puc = pucDest - iXMargin;
+    for( n = 0; n < iYMargin; n++)
+    {
+      ::memcpy( puc - iStride, puc, uiSize );
+      puc -= iStride;
+    }
   }
 }
 
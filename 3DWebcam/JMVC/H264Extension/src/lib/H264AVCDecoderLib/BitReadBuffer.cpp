@@ -6,13 +6,17 @@
 
 H264AVC_NAMESPACE_BEGIN
 
+static const UInt s_uiNoEscapeOffset = MSYS_UINT_MAX;
+
 BitReadBuffer::BitReadBuffer():
   m_uiDWordsLeft( 0 ),
   m_uiBitsLeft( 0 ),
   m_iValidBits( 0 ),
   m_ulCurrentBits( 0xdeaddead ),
   m_uiNextBits( 0xdeaddead ),
-  m_pulStreamPacket( 0 )
+  m_pucStreamPacket( 0 ),
+  m_uiReadOffset( 0 ),
+  m_puiEscapeOffset( &s_uiNoEscapeOffset )
 {
 }
 
@@ -44,9 +48,18 @@ ErrVal BitReadBuffer::destroy()
 
 
 ErrVal BitReadBuffer::initPacket( UInt32* puiBits, UInt uiBitsInPacket )
+{
+  return initPacket( (const UChar*)puiBits, uiBitsInPacket, &s_uiNoEscapeOffset );
+}
+
+
+
+ErrVal BitReadBuffer::initPacket( const UChar* pucPayload, UInt uiBitsInPacket, const UInt* puiEscapeOffset )
 {
   // invalidate all members if something is wrong
-  m_pulStreamPacket    = NULL;
+  m_pucStreamPacket    = NULL;
+  m_uiReadOffset       = 0;
+  m_puiEscapeOffset    = &s_uiNoEscapeOffset;
   m_ulCurrentBits      = 0xdeaddead;
   m_uiNextBits         = 0xdeaddead;
   m_uiBitsLeft         = 0;
@@ -56,10 +69,12 @@ ErrVal BitReadBuffer::initPacket( UInt32* puiBits, UInt uiBitsInPacket )
 
   // check the parameter
   ROT( uiBitsInPacket < 1);
-  ROT( NULL == puiBits );
+  ROT( NULL == pucPayload );
+  ROT( NULL == puiEscapeOffset );
 
   // now init the Bitstream object
-  m_pulStreamPacket  = puiBits;
+  m_pucStreamPacket  = pucPayload;
+  m_puiEscapeOffset  = puiEscapeOffset;
 
   m_uiBitsLeft = uiBitsInPacket;
 
@@ -240,27 +255,48 @@ __inline Void BitReadBuffer::xReadNextWord()
   // chech if there are bytes left in the packet
   if( m_uiDWordsLeft )
   {
-    // read 32 bit from the packet
-    m_uiNextBits = xSwap( *m_pulStreamPacket++ );
+    // read 32 bit from the packet, byte by byte when an emulation prevention byte is among them
+    if( m_uiReadOffset + 4 <= *m_puiEscapeOffset )
+    {
+      UInt32 ul;
+      ::memcpy( &ul, m_pucStreamPacket + m_uiReadOffset, sizeof( ul ) );
+      m_uiNextBits    = xSwap( ul );
+      m_uiReadOffset += 4;
+    }
+    else
+    {
+      m_uiNextBits = xReadBytes( 4 );
+    }
     m_uiDWordsLeft--;
   }
   else
   {
     Int iBytesLeft  = ((Int)m_uiBitsLeft - m_iValidBits+7) >> 3;
-    UChar* puc      = (UChar*) m_pulStreamPacket;
     m_uiNextBits  = 0;
 
     if( iBytesLeft > 0)
     {
-      for( Int iByte = 0; iByte < iBytesLeft; iByte++ )
-      {
-        m_uiNextBits <<= 8;
-        m_uiNextBits += puc[iByte];
-      }
+      m_uiNextBits  = xReadBytes( iBytesLeft );
       m_uiNextBits <<= (4-iBytesLeft)<<3;
     }
   }
 }
 
+UInt32 BitReadBuffer::xReadBytes( Int iNumBytes )
+{
+  UInt32 ul = 0;
+  for( Int iByte = 0; iByte < iNumBytes; iByte++, m_uiReadOffset++ )
+  {
+    if( m_uiReadOffset == *m_puiEscapeOffset )
+    {
+      m_uiReadOffset++;
+      m_puiEscapeOffset++;
+    }
+    ul <<= 8;
+    ul  += m_pucStreamPacket[m_uiReadOffset];
+  }
+  return ul;
+}
+
 
 H264AVC_NAMESPACE_END
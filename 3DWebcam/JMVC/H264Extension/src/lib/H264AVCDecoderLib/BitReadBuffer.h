@@ -29,6 +29,9 @@ public:
   ErrVal uninit() { return Err::m_nOK; }
 
   ErrVal initPacket( UInt32* puiBits, UInt uiBitsInPacket);
+  //===== reads the NAL unit payload as it is: the emulation prevention bytes at the ascending offsets are skipped, =====
+  //===== the list ends with MSYS_UINT_MAX and uiBitsInPacket does not count the skipped bytes                   =====
+  ErrVal initPacket( const UChar* pucPayload, UInt uiBitsInPacket, const UInt* puiEscapeOffset );
 
   ErrVal get  ( UInt& ruiBits, UInt uiNumberOfBits );
   ErrVal get  ( UInt& ruiBits);
@@ -47,6 +50,7 @@ public:
 
 private:
   __inline Void xReadNextWord();
+  UInt32 xReadBytes( Int iNumBytes );
 
   UInt32 xSwap( UInt32 ul )
   {
@@ -71,7 +75,9 @@ protected:
   Int    m_iValidBits;
   UInt32 m_ulCurrentBits;    // Dong: Use 32-bit fixed length
   UInt   m_uiNextBits;
-  UInt32* m_pulStreamPacket; // Dong: Use 32-bit fixed length
+  const UChar* m_pucStreamPacket;
+  UInt        m_uiReadOffset;     // of the next byte in the packet
+  const UInt* m_puiEscapeOffset;  // the next emulation prevention byte
 };
 
 
@@ -25,8 +25,7 @@ CabaDecoder::CabaDecoder() :
   m_pcBitReadBuffer( NULL ),
   m_uiRange( 0 ),
   m_uiValue( 0 ),
-  m_uiWord( 0 ),
-  m_uiBitsLeft( 0 )
+  m_iBitsNeeded( 0 )
 {
 }
 
@@ -47,15 +46,11 @@ ErrVal CabaDecoder::init( BitReadBuffer* pcBitReadBuffer )
 
 
 
-__inline Void CabaDecoder::xReadBit( UInt& ruiValue )
+__inline Void CabaDecoder::xReadByte( UInt& ruiValue, Int iShift )
 {
-  if( 0 == m_uiBitsLeft-- )
-  {
-    m_pcBitReadBuffer->get( m_uiWord, 8 );
-    m_uiBitsLeft = 7;
-  }
-  ruiValue += ruiValue + ((m_uiWord >> 7)&1);
-  m_uiWord <<= 1;
+  UInt uiByte;
+  m_pcBitReadBuffer->get( uiByte, 8 );
+  ruiValue += uiByte << iShift;
 }
 
 
@@ -69,28 +64,15 @@ ErrVal CabaDecoder::start()
 {
   m_uiRange     = HALF-2;
   m_uiValue     = 0;
-  m_uiWord      = 0;
-  m_uiBitsLeft  = 0;
+  m_iBitsNeeded = -8;
 
 
   RNOK( m_pcBitReadBuffer->flush( m_pcBitReadBuffer->getBitsUntilByteAligned() ) );
   m_pcBitReadBuffer->setModeCabac();
 
-  while( ! m_pcBitReadBuffer->isWordAligned() && ( 8 > m_uiBitsLeft) )
-  {
-    UInt uiByte;
-    m_pcBitReadBuffer->get( uiByte, 8 );
-    m_uiWord <<= 8;
-    m_uiWord += uiByte;
-    m_uiBitsLeft += 8;
-  }
-
-  m_uiWord <<= 8-m_uiBitsLeft;
-
-  for( UInt n = 0; n < B_BITS-1; n++ )
-  {
-    xReadBit( m_uiValue );
-  }
+  //===== the 9 bits of the offset and 7 bits ahead, as many bytes as bit-wise reading takes =====
+  xReadByte( m_uiValue, 8 );
+  xReadByte( m_uiValue, 0 );
 
   return Err::m_nOK;
 }
@@ -100,14 +82,13 @@ ErrVal CabaDecoder::start()
 ErrVal CabaDecoder::getTerminateBufferBit( UInt& ruiBit )
 {
   UInt uiRange = m_uiRange-2;
-  UInt uiValue = m_uiValue;
 
   DTRACE_V (g_nSymbolCounter[g_nLayer]++);
   DTRACE_T ("  ");
   DTRACE_X (m_uiRange);
 
 
-  if( uiValue >= uiRange )
+  if( m_uiValue >= ( uiRange << 7 ) )
   {
     ruiBit = 1;
   }
@@ -115,14 +96,18 @@ ErrVal CabaDecoder::getTerminateBufferBit( UInt& ruiBit )
   {
     ruiBit = 0;
 
-	  while( uiRange < QUARTER )
+	  if( uiRange < QUARTER )
 	  {
-		  uiRange += uiRange;
-      xReadBit( uiValue );
+		  uiRange     += uiRange;
+      m_uiValue   += m_uiValue;
+      if( ++m_iBitsNeeded == 0 )
+      {
+        m_iBitsNeeded = -8;
+        xReadByte( m_uiValue, 0 );
+      }
 	  }
 
     m_uiRange = uiRange;
-    m_uiValue = uiValue;
   }
 
   DTRACE_T ("  -  ");
@@ -137,6 +122,7 @@ ErrVal CabaDecoder::uninit()
   m_pcBitReadBuffer = NULL;
   m_uiRange = 0;
   m_uiValue = 0;
+  m_iBitsNeeded = 0;
   return Err::m_nOK;
 }
 
@@ -163,15 +149,35 @@ ErrVal CabaDecoder::getSymbol( UInt& ruiSymbol, CabacContextModel& rcCCModel )
     uiLPS = g_aucLPSTable64x4[rcCCModel.getState()][(uiRange>>6) & 0x03];
 		uiRange -= uiLPS;
 
-		if( uiValue < uiRange )
+		if( uiValue < ( uiRange << 7 ) )
     {
 			ruiSymbol = rcCCModel.getMps();
   		rcCCModel.setState( g_aucACNextStateMPS64[ rcCCModel.getState() ] );
+
+      //----- at most one shift after a MPS -----
+      if( uiRange < QUARTER )
+      {
+        uiRange += uiRange;
+        uiValue += uiValue;
+        if( ++m_iBitsNeeded == 0 )
+        {
+          m_iBitsNeeded = -8;
+          xReadByte( uiValue, 0 );
+        }
+      }
     }
     else
     {
-      uiValue -= uiRange;
-      uiRange  = uiLPS;
+      //----- renormalize in one step, the shifts never need more than one byte -----
+      UInt uiNumBits  = g_aucRenormTable32[uiLPS >> 3];
+      uiValue         = ( uiValue - ( uiRange << 7 ) ) << uiNumBits;
+      uiRange         = uiLPS << uiNumBits;
+      m_iBitsNeeded  += uiNumBits;
+      if( m_iBitsNeeded >= 0 )
+      {
+        xReadByte( uiValue, m_iBitsNeeded );
+        m_iBitsNeeded -= 8;
+      }
 
 			ruiSymbol = 1 - rcCCModel.getMps();
 
@@ -188,12 +194,6 @@ ErrVal CabaDecoder::getSymbol( UInt& ruiSymbol, CabacContextModel& rcCCModel )
   DTRACE_V (ruiSymbol);
   DTRACE_N;
 
-  while( uiRange < QUARTER )
-  {
-    uiRange += uiRange;
-    xReadBit( uiValue );
-  }
-
   m_uiRange = uiRange;
   m_uiValue = uiValue;
 
@@ -207,14 +207,18 @@ ErrVal CabaDecoder::getEpSymbol( UInt& ruiSymbol )
   DTRACE_T ("  ");
   DTRACE_X (m_uiRange);
 
-  UInt uiValue = m_uiValue;
-
-  xReadBit( uiValue );
+  m_uiValue += m_uiValue;
+  if( ++m_iBitsNeeded == 0 )
+  {
+    m_iBitsNeeded = -8;
+    xReadByte( m_uiValue, 0 );
+  }
 
-	if( uiValue >= m_uiRange )
+  UInt uiScaledRange = m_uiRange << 7;
+	if( m_uiValue >= uiScaledRange )
 	{
 		ruiSymbol = 1;
-		uiValue -= m_uiRange;
+		m_uiValue -= uiScaledRange;
 	}
 	else
   {
@@ -225,8 +229,65 @@ ErrVal CabaDecoder::getEpSymbol( UInt& ruiSymbol )
   DTRACE_V (ruiSymbol);
   DTRACE_N;
 
-  m_uiValue = uiValue;
+  return Err::m_nOK;
+}
+
 
+ErrVal CabaDecoder::getEpSymbols( UInt& ruiSymbols, UInt uiNumBins )
+{
+  UInt uiSymbols = 0;
+
+#if DECODER_TRACE
+  //----- bin by bin, so that the trace lists every bin -----
+  while( uiNumBins-- )
+  {
+    UInt uiBit;
+    RNOKCABAC( getEpSymbol( uiBit ) );
+    uiSymbols += uiSymbols + uiBit;
+  }
+#else
+  //===== a byte of bins at a time: the value is shifted by 8 and compared with the range scaled down bit by bit =====
+  while( uiNumBins > 8 )
+  {
+    m_uiValue = ( m_uiValue << 8 );
+    xReadByte( m_uiValue, 8 + m_iBitsNeeded );
+
+    UInt uiScaledRange = m_uiRange << 15;
+    for( UInt ui = 0; ui < 8; ui++ )
+    {
+      uiSymbols     += uiSymbols;
+      uiScaledRange >>= 1;
+      if( m_uiValue >= uiScaledRange )
+      {
+        uiSymbols++;
+        m_uiValue -= uiScaledRange;
+      }
+    }
+    uiNumBins -= 8;
+  }
+
+  m_iBitsNeeded += uiNumBins;
+  m_uiValue    <<= uiNumBins;
+  if( m_iBitsNeeded >= 0 )
+  {
+    xReadByte( m_uiValue, m_iBitsNeeded );
+    m_iBitsNeeded -= 8;
+  }
+
+  UInt uiScaledRange = m_uiRange << ( uiNumBins + 7 );
+  for( UInt ui = 0; ui < uiNumBins; ui++ )
+  {
+    uiSymbols     += uiSymbols;
+    uiScaledRange >>= 1;
+    if( m_uiValue >= uiScaledRange )
+    {
+      uiSymbols++;
+      m_uiValue -= uiScaledRange;
+    }
+  }
+#endif
+
+  ruiSymbols = uiSymbols;
   return Err::m_nOK;
 }
 
@@ -309,14 +370,11 @@ ErrVal CabaDecoder::getEpExGolomb( UInt& ruiSymbol, UInt uiCount )
     uiSymbol += uiBit << uiCount++;
   }
 
-  uiCount--;
-	while( uiCount-- )
-  {
-    RNOKCABAC( getEpSymbol( uiBit ) );
-  	uiSymbol += uiBit << uiCount;
-  }
+  //===== the suffix at once =====
+  UInt uiSuffix;
+  RNOKCABAC( getEpSymbols( uiSuffix, --uiCount ) );
 
-  ruiSymbol = uiSymbol;
+  ruiSymbol = uiSymbol + uiSuffix;
   return Err::m_nOK;
 }
 
@@ -25,6 +25,8 @@ public:
 
   ErrVal getSymbol( UInt& ruiSymbol, CabacContextModel& rcCCModel );
   ErrVal getEpSymbol( UInt& ruiSymbol );
+  //===== reads uiNumBins bypass bins, the first one becomes the most significant bit =====
+  ErrVal getEpSymbols( UInt& ruiSymbols, UInt uiNumBins );
   ErrVal getEpExGolomb( UInt& ruiSymbol, UInt uiCount );
   ErrVal getExGolombLevel( UInt& ruiSymbol, CabacContextModel& rcCCModel  );
   ErrVal getExGolombMvd( UInt& ruiSymbol, CabacContextModel* pcCCModel, UInt uiMaxBin );
@@ -33,15 +35,16 @@ public:
   ErrVal getUnarySymbol( UInt& ruiSymbol, CabacContextModel* pcCCModel, Int iOffset );
 
 private:
-  __inline Void xReadBit( UInt& ruiValue );
+  __inline Void xReadByte( UInt& ruiValue, Int iShift );
 
 protected:
+  //===== m_uiValue holds the offset in the coding interval with 7 more bits than the range, and -m_iBitsNeeded  =====
+  //===== further bits below them; a byte is read when these are used up, at the position the bits are needed   =====
   BitReadBuffer* m_pcBitReadBuffer;
 
   UInt m_uiRange;
   UInt m_uiValue;
-  UInt m_uiWord;
-  UInt m_uiBitsLeft;
+  Int  m_iBitsNeeded;
 };
 
 H264AVC_NAMESPACE_END
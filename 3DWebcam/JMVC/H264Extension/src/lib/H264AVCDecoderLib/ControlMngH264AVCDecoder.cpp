@@ -181,6 +181,14 @@ ErrVal ControlMngH264AVCDecoder::initMbForDecoding( MbDataAccess*& rpcMbDataAcce
   return Err::m_nOK;
 }
 
+ErrVal ControlMngH264AVCDecoder::initMbForReconstruction( MbDataAccess& rcMbDataAccess, UInt uiMbY, UInt uiMbX )
+{
+  ROF( m_uiCurrLayer < MAX_LAYERS );
+  RNOK( m_apcYuvFullPelBufferCtrl[m_uiCurrLayer]->initMb(                  uiMbY, uiMbX, false ) );
+  RNOK( m_pcMotionCompensation                  ->initMb(                  uiMbY, uiMbX, rcMbDataAccess ) ) ;
+  return Err::m_nOK;
+}
+
 ErrVal ControlMngH264AVCDecoder::initMbForFiltering( MbDataAccess*& rpcMbDataAccess,UInt uiMbY, UInt uiMbX, Bool bMbAFF  )
 {
   ROF( m_uiCurrLayer < MAX_LAYERS );
@@ -69,6 +69,7 @@ public:
 
   ErrVal initMbForParsing     ( MbDataAccess*& rpcMbDataAccess, UInt uiMbIndex );
   ErrVal initMbForDecoding    (MbDataAccess*& rpcMbDataAccess,UInt uiMbY, UInt uiMbX, Bool bMbAFF  );
+  ErrVal initMbForReconstruction( MbDataAccess& rcMbDataAccess, UInt uiMbY, UInt uiMbX );
     ErrVal initMbForFiltering   ( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMbX, Bool bMbAFF );
     ErrVal initMbForFiltering   ( UInt uiMbY, UInt uiMbX, Bool bMbAFF );
 
@@ -13,6 +13,7 @@
 #include "BitReadBuffer.h"
 #include "CabacReader.h"
 #include "CabaDecoder.h"
+#include "ViewWorker.h"
 //#include "FGSSubbandDecoder.h"
 
 #include "H264AVCCommonLib/MbData.h"
@@ -56,12 +57,14 @@ CreaterH264AVCDecoder::CreaterH264AVCDecoder():
   m_pcMotionCompensation  ( NULL ),
   m_pcQuarterPelFilter    ( NULL ),
   m_pcCabacReader         ( NULL ),
-  m_pcSampleWeighting     ( NULL )
+  m_pcSampleWeighting     ( NULL ),
+  m_uiNumViewWorkers      ( 0 )
 {
   //::memset( m_apcDecodedPicBuffer,     0x00, MAX_LAYERS * sizeof( Void* ) );
   //::memset( m_apcMCTFDecoder,          0x00, MAX_LAYERS * sizeof( Void* ) );
   ::memset( m_apcPocCalculator,        0x00, MAX_LAYERS * sizeof( Void* ) );
   ::memset( m_apcYuvFullPelBufferCtrl, 0x00, MAX_LAYERS * sizeof( Void* ) );
+  ::memset( m_apcViewWorker,           0x00, MAX_WAVEFRONT_LANES * sizeof( Void* ) );
 }
 
 
@@ -226,6 +229,31 @@ CreaterH264AVCDecoder::setCrop(UInt* uiCrop)
 		*(uiCrop+i)=m_pcH264AVCDecoder->getCrop(i);
 }
 
+Void
+CreaterH264AVCDecoder::setPipelined( Bool bPipelined )
+{
+  m_pcH264AVCDecoder->setPipelined( bPipelined );
+}
+
+Void
+CreaterH264AVCDecoder::setParallelViews( UInt uiNumViews )
+{
+  //----- lane 0 of the macroblock offsets is used by the thread that parses -----
+  m_uiNumViewWorkers = min( uiNumViews, (UInt)MAX_WAVEFRONT_LANES - 1 );
+}
+
+Void
+CreaterH264AVCDecoder::setTargetViews( UInt uiNumViews, const UInt* puiViewId )
+{
+  m_pcH264AVCDecoder->setTargetViews( uiNumViews, puiViewId );
+}
+
+Void
+CreaterH264AVCDecoder::setTargetOperationPoint( UInt uiOpId )
+{
+  m_pcH264AVCDecoder->setTargetOperationPoint( uiOpId );
+}
+
 //JVT-V054
 UInt*
 CreaterH264AVCDecoder::getViewCodingOrder()
@@ -319,6 +347,14 @@ ErrVal CreaterH264AVCDecoder::destroy()
     RNOK( m_apcYuvFullPelBufferCtrl[uiLayer]->destroy() );
   }
 
+  for( UInt uiWorker = 0; uiWorker < MAX_WAVEFRONT_LANES; uiWorker++ )
+  {
+    if( NULL != m_apcViewWorker[uiWorker] )
+    {
+      RNOK( m_apcViewWorker[uiWorker]->destroy() );
+    }
+  }
+
   delete this;
   return Err::m_nOK;
 }
@@ -375,6 +411,24 @@ ErrVal CreaterH264AVCDecoder::init( Bool bOpenTrace, DecoderParameter *Dec_Param
 
   RNOK( m_pcReconstructionBypass  ->init() );
 
+  //===== workers of the parallel view decoding =====
+  if( m_uiNumViewWorkers > 1 )
+  {
+    for( UInt uiWorker = 0; uiWorker < m_uiNumViewWorkers; uiWorker++ )
+    {
+      if( NULL == m_apcViewWorker[uiWorker] )
+      {
+        RNOK( ViewWorker::create( m_apcViewWorker[uiWorker] ) );
+      }
+      RNOK( m_apcViewWorker[uiWorker]->init( m_apcYuvFullPelBufferCtrl[0],
+                                             m_pcQuarterPelFilter,
+                                             m_pcFrameMng,
+                                             m_pcControlMng,
+                                             m_pcReconstructionBypass ) );
+    }
+    m_pcH264AVCDecoder->setViewWorkers( m_apcViewWorker, m_uiNumViewWorkers );
+  }
+
   for( UInt uiLayer = 0; uiLayer < MAX_LAYERS; uiLayer++ )
   {
     
@@ -410,6 +464,15 @@ ErrVal CreaterH264AVCDecoder::init( Bool bOpenTrace, DecoderParameter *Dec_Param
 
 ErrVal CreaterH264AVCDecoder::uninit( Bool bCloseTrace )
 {
+  if( m_uiNumViewWorkers > 1 )
+  {
+    for( UInt uiWorker = 0; uiWorker < m_uiNumViewWorkers; uiWorker++ )
+    {
+      RNOK( m_apcViewWorker[uiWorker]->uninit() );
+    }
+  }
+  m_uiNumViewWorkers = 0;
+
   RNOK( m_pcSampleWeighting       ->uninit() );
   RNOK( m_pcQuarterPelFilter      ->uninit() );
   RNOK( m_pcFrameMng              ->uninit() );
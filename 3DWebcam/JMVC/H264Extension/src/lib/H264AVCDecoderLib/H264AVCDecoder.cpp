@@ -5,9 +5,13 @@
 #include "H264AVCCommonLib/FrameMng.h"
 #include "H264AVCCommonLib/LoopFilter.h"
 #include "H264AVCCommonLib/TraceFile.h"
+#include "H264AVCCommonLib/YuvBufferCtrl.h"
 
 #include "SliceReader.h"
 #include "SliceDecoder.h"
+#include "ViewWorker.h"
+
+#include <omp.h>
 
 #include "CreaterH264AVCDecoder.h"
 #include "ControlMngH264AVCDecoder.h"
@@ -39,6 +43,16 @@ H264AVCDecoder::H264AVCDecoder()
 , m_bInitDone                     ( false )
 , m_bLastFrame                    ( false )
 , m_bFrameDone                    ( true  )
+, m_bPipelined                    ( false )
+, m_bPipelinedPic                 ( false )
+, m_uiPipelineNextMb              ( 0 )
+, m_uiPipelineRowsFiltered        ( 0 )
+, m_papcViewWorker                ( NULL )
+, m_uiNumViewWorkers              ( 0 )
+, m_bParallelViewPic              ( false )
+, m_uiNumPendingViewPics          ( 0 )
+, m_pcParallelDecodingSei         ( NULL )
+, m_bInterViewRefsKnown           ( false )
 , m_bEnhancementLayer             ( false )
 , m_bBaseLayerIsAVCCompatible     ( false )
 , m_bNewSPS                       ( false )
@@ -257,6 +271,26 @@ ErrVal H264AVCDecoder::uninit()
   m_bFrameDone            = true;
   m_pcMotionCompensation  = NULL;
 
+  //===== slices that have not been reconstructed =====
+  for( UInt uiSlice = 0; uiSlice < m_cViewSliceList.size(); uiSlice++ )
+  {
+    if( m_cViewSliceList[uiSlice].bOwnSliceHeader )
+    {
+      delete m_cViewSliceList[uiSlice].pcSliceHeader;
+    }
+  }
+  m_cViewSliceList.clear();
+  m_cViewIdList   .clear();
+  m_uiNumPendingViewPics  = 0;
+  m_bParallelViewPic      = false;
+  if( m_pcParallelDecodingSei )
+  {
+    RNOK( m_pcParallelDecodingSei->destroy() );
+  }
+  m_pcParallelDecodingSei = NULL;
+  m_papcViewWorker        = NULL;
+  m_uiNumViewWorkers      = 0;
+
   delete m_pcSliceHeader;
   delete m_pcPrevSliceHeader;
   delete m_pcSliceHeader_backup;  // JVT-Q054 Red. Pic
@@ -1103,7 +1137,7 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
 
 
     m_bLastFrame = true;
-    delete m_pcSliceHeader;
+    xDeleteSliceHeader( m_pcSliceHeader );
     m_pcSliceHeader = 0;
     rbStartDecoding = true; //JVT-P031
     return Err::m_nOK;
@@ -1124,6 +1158,24 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
   UInt uiBitsLeft = m_pcNalUnitParser->getBitsLeft(); //JVT-P031
 
   ruiNalUnitType = m_pcNalUnitParser->getNalUnitType();
+
+  //===== slices of views outside of the decoded view subset are skipped like unknown NAL units =====
+  if( m_pcNalUnitParser->isDroppedView() )
+  {
+    ruiEndPos     = 0;
+    bDiscardable  = false;
+    bSkip         = true;
+    return Err::m_nOK;
+  }
+
+  //===== an operation point (-op) is resolved by a view scalability info SEI ahead of the first slice =====
+  if( m_bOpPresentFlag && m_cTargetViewIdList.empty() &&
+      ( ruiNalUnitType == NAL_UNIT_CODED_SLICE          || ruiNalUnitType == NAL_UNIT_CODED_SLICE_IDR ||
+        ruiNalUnitType == NAL_UNIT_CODED_SLICE_SCALABLE || ruiNalUnitType == NAL_UNIT_CODED_SLICE_IDR_SCALABLE ) )
+  {
+    fprintf( stderr, "\nno view scalability info SEI lists the operation point %d\n", m_uiOperationPointId );
+    return Err::m_nERR;
+  }
   
   //TMM_EC {{
   if(!bPreParseHeader && ruiNalUnitType==NAL_UNIT_END_OF_STREAM)
@@ -1139,7 +1191,7 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
 			if (m_pauiTempLevelInGOP[i]) delete	[] m_pauiTempLevelInGOP[i];
 		}
     m_bLastFrame = true;
-    delete m_pcSliceHeader;
+    xDeleteSliceHeader( m_pcSliceHeader );
     m_pcSliceHeader = 0;
     return Err::m_nOK;
   }
@@ -1289,6 +1341,10 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
 	
 	  m_bNewSPS = true;
       RNOK( m_pcParameterSetMng ->store   ( pcSPS   ) );
+      if( m_pcNalUnitParser->getNalUnitType() == NAL_UNIT_SUBSET_SPS )
+      {
+        xSetViewSubset( pcSPS->getSpsMVC() );
+      }
 
       // Copy simple priority ID mapping from SPS to NAL unit parser
 
@@ -1517,7 +1573,7 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
       //===== just for trace file =====
       SEI::MessageList  cMessageList;
 	  UInt	i;
-       RNOK( SEI::read( m_pcHeaderSymbolReadIf, cMessageList  ) );
+       RNOK( SEI::read( m_pcHeaderSymbolReadIf, cMessageList, m_pcParameterSetMng ) );
 	  
       while( ! cMessageList.empty() )
       {
@@ -1531,7 +1587,13 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
 		  else if( pcSEIMessage->getMessageType() == SEI::PARALLEL_DEC_SEI )
 		  {
 		    printf("\n Parallel SEI message received. \tParallel Decoding Enable.\n\n");
-			  delete pcSEIMessage;
+        //----- the initial delays synchronize the view workers, the pending pictures were parsed under the previous message -----
+        RNOK( xFinishViews() );
+        if( m_pcParallelDecodingSei )
+        {
+          RNOK( m_pcParallelDecodingSei->destroy() );
+        }
+        m_pcParallelDecodingSei = (SEI::ParallelDecodingSEI*) pcSEIMessage;
 		  }
 //~JVT-W080	
 			else
@@ -1603,6 +1665,24 @@ H264AVCDecoder::initPacket( BinDataAccessor*  pcBinDataAccessor,
 					 
 					}
 					printf("\n View Scalability Info SEI message received. \n");
+
+					//----- the target views of the selected operation point -----
+					Bool bOpFound = false;
+					for( UInt uiOp = 0; m_bOpPresentFlag && uiOp <= m_uiNumOpMinus1; uiOp++ )
+					{
+					  if( ((SEI::ViewScalabilityInfoSei*)pcSEIMessage)->getOperationPointId( uiOp ) == m_uiOperationPointId )
+					  {
+						setTargetViews( m_uiNumViews[uiOp], m_OpViewId[uiOp] );
+						xSetViewSubset( NULL );
+						bOpFound = true;
+					  }
+					}
+					if( m_bOpPresentFlag && ! bOpFound )
+					{
+					  fprintf( stderr, "\noperation point %d is not in the view scalability info SEI\n", m_uiOperationPointId );
+					  delete pcSEIMessage;
+					  return Err::m_nERR;
+					}
 			
 				  }
 //SEI }
@@ -1903,7 +1983,7 @@ H264AVCDecoder::initPacketPrefix( BinDataAccessor*  pcBinDataAccessor,
 
 
     m_bLastFrame = true;
-    delete m_pcSliceHeader;
+    xDeleteSliceHeader( m_pcSliceHeader );
     m_pcSliceHeader = 0;
     rbStartDecoding = true; //JVT-P031
 
@@ -2072,6 +2152,7 @@ H264AVCDecoder::process( PicBuffer*       pcPicBuffer,
 
   if( m_bLastFrame )
   {
+    RNOK( xFinishViews() );
       if( (m_uiRecLayerId > 0 || !m_bBaseLayerIsAVCCompatible) && m_pcNalUnitParser->getSvcMvcFlag())
     {
       PicBufferList cDummyList;
@@ -2195,7 +2276,7 @@ H264AVCDecoder::process( PicBuffer*       pcPicBuffer,
         PicBufferList   cDummyList;
         PicBufferList&  rcOutputList  = ( m_uiRecLayerId == 0 ? rcPicBufferOutputList : cDummyList );
 
-        RNOK( m_pcFrameMng->setPicBufferLists( rcOutputList, rcPicBufferReleaseList ) );        
+        RNOK( xSetPicBufferLists( rcOutputList, rcPicBufferReleaseList ) );
 //JVT-T054{
         m_bAVCBased = true;
 //JVT-T054}
@@ -2271,7 +2352,7 @@ H264AVCDecoder::process( PicBuffer*       pcPicBuffer,
       PicBufferList   cDummyList;
       PicBufferList&  rcOutputList  = ( (m_uiRecLayerId == 0) ? rcPicBufferOutputList : cDummyList ); //JVT-T054
 
-      RNOK( m_pcFrameMng->setPicBufferLists( rcOutputList, rcPicBufferReleaseList ) );
+      RNOK( xSetPicBufferLists( rcOutputList, rcPicBufferReleaseList ) );
       m_bAVCBased = true;
     }
     break;
@@ -2403,12 +2484,12 @@ ErrVal H264AVCDecoder::xStartSlice(Bool& bPreParseHeader, Bool& bLastFragment, B
 // JVT-Q054 Red. Picture {
         if ( isRedundantPic() )
         {
-          delete m_pcSliceHeader;
+          xDeleteSliceHeader( m_pcSliceHeader );
           m_pcSliceHeader = pSliceHeader;
         }
         else
         {
-          delete m_pcPrevSliceHeader;
+          xDeleteSliceHeader( m_pcPrevSliceHeader );
           m_pcPrevSliceHeader = m_pcSliceHeader;
           m_pcSliceHeader     = pSliceHeader;
         }
@@ -2493,6 +2574,9 @@ H264AVCDecoder::xProcessSliceVirtual( SliceHeader&    rcSH,
                                       SliceHeader*    pcPrevSH,
                                       PicBuffer* &    rpcPicBuffer)
 {
+  //===== the concealment copies reference pictures, which must be reconstructed =====
+  RNOK( xFinishViews() );
+
     //===== calculate POC =====
     if( rcSH.getLayerId() == 0 )
     {
@@ -2683,6 +2767,18 @@ H264AVCDecoder::xProcessSlice( SliceHeader& rcSH,
   //===== check if new pictures and initialization =====
   rcSH.compare( pcPrevSH, bNewPic, bNewFrame );
 
+  //===== frames are parsed at once and reconstructed by the workers of their views later, =====
+  //===== the other pictures may reference the pending ones and wait for them =====
+  if( bNewPic )
+  {
+    m_bParallelViewPic  = m_uiNumViewWorkers > 0 && FRAME == rcSH.getPicType() && ! rcSH.isMbAff() &&
+                          0 == rcSH.getPPS().getNumSliceGroupsMinus1() && rcSH.getSPS().getFrameMbsOnlyFlag();
+    if( ! m_bParallelViewPic )
+    {
+      RNOK( xFinishViews() );
+    }
+  }
+
   if(!bNewFrame)
   {
 	  if(rcSH.getFieldPicFlag())
@@ -2704,6 +2800,11 @@ H264AVCDecoder::xProcessSlice( SliceHeader& rcSH,
   if( bNewPic )
   {
     RNOK( m_pcFrameMng->initPic  ( rcSH ) );
+
+    m_bPipelinedPic           = m_bPipelined && FRAME == rcSH.getPicType() && ! rcSH.isMbAff() &&
+                                0 == rcSH.getPPS().getNumSliceGroupsMinus1() && ! m_bParallelViewPic;
+    m_uiPipelineNextMb        = 0;
+    m_uiPipelineRowsFiltered  = 0;
   }
   else
   {
@@ -2723,14 +2824,6 @@ H264AVCDecoder::xProcessSlice( SliceHeader& rcSH,
     rcSH.setList1FirstShortTerm ( bList1ShortTerm );
   }
 
-  //===== parse slice =====
-  RNOK( m_pcControlMng  ->initSlice ( rcSH, PARSE_PROCESS ) );
-
-  RNOK( m_pcSliceReader ->process   ( rcSH, uiMbRead ) );
-
-  //===== decode slice =====
-
-
   Bool  bKeyPicture     = rcSH.getKeyPictureFlag();
   Bool  bConstrainedIP  = rcSH.getPPS().getConstrainedIntraPredFlag();
   Bool  bReconstruct    = (m_uiRecLayerId == 0) || ! bConstrainedIP || bHighestLayer; //JVT-T054
@@ -2738,20 +2831,57 @@ H264AVCDecoder::xProcessSlice( SliceHeader& rcSH,
   //***** NOTE: Motion-compensated prediction for non-key pictures is done in xReconstructLastFGS()
   bReconstruct    = (bReconstruct && bKeyPicture) || ! bConstrainedIP;
 
-  RNOK( m_pcControlMng  ->initSlice ( rcSH, DECODE_PROCESS ) );
+  //===== parse slice =====
+  RNOK( m_pcControlMng  ->initSlice ( rcSH, PARSE_PROCESS ) );
 
-  RNOK( m_pcSliceDecoder->process   ( rcSH, bReconstruct, uiMbRead ) );
+  if( m_bParallelViewPic )
+  {
+    //===== parse slice, the worker of the view decodes it =====
+    RNOK( m_pcSliceReader ->process   ( rcSH, uiMbRead ) );
+    RNOK( xQueueViewSlice( rcSH, bReconstruct, uiMbRead ) );
+  }
+  else if( m_bPipelinedPic )
+  {
+    //===== parse, decode and deblock slice on three threads =====
+    RNOK( xProcessSlicePipelined( rcSH, bReconstruct, uiMbRead ) );
+  }
+  else
+  {
+    RNOK( m_pcSliceReader ->process   ( rcSH, uiMbRead ) );
+
+    //===== decode slice =====
+    RNOK( m_pcControlMng  ->initSlice ( rcSH, DECODE_PROCESS ) );
+
+    RNOK( m_pcSliceDecoder->process   ( rcSH, bReconstruct, uiMbRead ) );
+  }
 
   Bool bPicDone;
   RNOK( m_pcControlMng->finishSlice( rcSH, bPicDone, m_bFrameDone )  );
 
-  if( bPicDone )
+  if( bPicDone && m_bParallelViewPic )
+  {
+    //===== deblocking and padding are left to the worker, the picture may be referenced while it is decoded =====
+    m_cViewSliceList.back().bLastSliceOfPic = true;
+    m_uiNumPendingViewPics++;
+    RNOK( m_pcFrameMng->storePicture( rcSH, false ) );
+  }
+  else if( bPicDone )
   {
     
     RNOK( m_pcControlMng->initSlice( rcSH, POST_PROCESS));
     
     //===== deblocking of base representation =====
-    RNOK( m_pcLoopFilter->process( rcSH ) );
+    if( m_bPipelinedPic )
+    {
+      //----- the rows that have not been deblocked while the slices were decoded -----
+      const UInt uiMbInCol = rcSH.getMbInPic() / rcSH.getSPS().getFrameWidthInMbs();
+      RNOK( m_pcLoopFilter->filterRows( rcSH, m_pcControlMng->getMbDataCtrl(), m_uiPipelineRowsFiltered, uiMbInCol ) );
+      m_uiPipelineRowsFiltered = uiMbInCol;
+    }
+    else
+    {
+      RNOK( m_pcLoopFilter->process( rcSH ) );
+    }
     
 	RNOK( m_pcFrameMng->storePicture( rcSH ) );
     
@@ -2769,6 +2899,279 @@ H264AVCDecoder::xProcessSlice( SliceHeader& rcSH,
 }
 
 
+ErrVal
+H264AVCDecoder::xProcessSlicePipelined( SliceHeader& rcSH, Bool bReconstruct, UInt& ruiMbRead )
+{
+  MbDataCtrl* pcMbDataCtrl  = m_pcControlMng->getMbDataCtrl();
+  ROT( NULL == pcMbDataCtrl );
+  RNOK( m_pcControlMng->initSliceForDecoding( rcSH ) );
+
+  const UInt    uiMbInRow   = rcSH.getSPS().getFrameWidthInMbs();
+  const UInt    uiFirstMb   = rcSH.getFirstMbInSlice();
+  //----- the rows above the slice are complete when the slices arrive in raster order -----
+  const Bool    bDeblock    = ( uiFirstMb == m_uiPipelineNextMb );
+  volatile Int  iMbParsed   = 0;
+  volatile Int  iMbDecoded  = 0;
+  volatile Bool bParsed     = false;
+  volatile Bool bDecoded    = false;
+  volatile Bool bAbort      = false;
+  ErrVal        nParse      = Err::m_nOK;
+  ErrVal        nDecode     = Err::m_nOK;
+  ErrVal        nDeblock    = Err::m_nOK;
+  UInt          uiMbRead    = 0;
+
+  //===== the stages are connected by the counters of the parsed and the reconstructed macroblocks, whose data are kept =====
+  //===== in the MbDataCtrl of the picture: a macroblock is reconstructed when the macroblock below its left neighbour =====
+  //===== has been parsed (parsing reads the neighbours as they are before reconstruction derives their motion), and a =====
+  //===== MB row is deblocked when the row below it has been reconstructed (intra prediction reads unfiltered samples) =====
+#pragma omp parallel sections num_threads( 3 )
+  {
+#pragma omp section
+    {
+      nParse = m_pcSliceReader->process( rcSH, uiMbRead, &iMbParsed );
+      if( Err::m_nOK != nParse )
+      {
+        bAbort = true;
+      }
+#pragma omp flush
+      bParsed = true;
+#pragma omp flush
+    }
+
+#pragma omp section
+    {
+      YuvBufferCtrl::setMbLane( 1 );
+      UChar ucLastMbQp = (UChar)rcSH.getPicQp();
+      for( UInt uiMb = 0; ; uiMb++ )
+      {
+        while( ! bParsed && iMbParsed <= (Int)( uiMb + uiMbInRow + 1 ) )
+        {
+#pragma omp flush
+        }
+        if( bAbort || ( bParsed && uiMb >= uiMbRead ) )
+        {
+          break;
+        }
+        nDecode = m_pcSliceDecoder->decodeMb( rcSH, pcMbDataCtrl, uiFirstMb + uiMb, ucLastMbQp, bReconstruct );
+        if( Err::m_nOK != nDecode )
+        {
+          bAbort = true;
+          break;
+        }
+#pragma omp flush
+        iMbDecoded = (Int)uiMb + 1;
+#pragma omp flush
+      }
+      YuvBufferCtrl::setMbLane( 0 );
+#pragma omp flush
+      bDecoded = true;
+#pragma omp flush
+    }
+
+#pragma omp section
+    {
+      while( bDeblock && ! bAbort )
+      {
+#pragma omp flush
+        const Bool bDone  = bDecoded;
+#pragma omp flush
+        const UInt uiRows = ( uiFirstMb + (UInt)iMbDecoded ) / uiMbInRow;
+        if( uiRows > m_uiPipelineRowsFiltered + 1 )
+        {
+          nDeblock = m_pcLoopFilter->filterRows( rcSH, pcMbDataCtrl, m_uiPipelineRowsFiltered, uiRows - 1 );
+          if( Err::m_nOK != nDeblock )
+          {
+            bAbort = true;
+            break;
+          }
+          m_uiPipelineRowsFiltered = uiRows - 1;
+        }
+        if( bDone )
+        {
+          break;
+        }
+      }
+    }
+  }
+
+  RNOK( nParse );
+  RNOK( nDecode );
+  RNOK( nDeblock );
+
+  ruiMbRead           = uiMbRead;
+  m_uiPipelineNextMb  = ( bDeblock ? uiFirstMb + uiMbRead : MSYS_UINT_MAX );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCDecoder::xQueueViewSlice( SliceHeader& rcSH, Bool bReconstruct, UInt uiMbRead )
+{
+  ROF( m_uiNumViewWorkers );
+
+  //===== the worker of the view, views are distributed in the order of their first slice =====
+  UInt uiView;
+  for( uiView = 0; uiView < m_cViewIdList.size() && m_cViewIdList[uiView] != rcSH.getViewId(); uiView++ );
+  if( uiView == m_cViewIdList.size() )
+  {
+    m_cViewIdList.push_back( rcSH.getViewId() );
+  }
+
+  ViewSlice cViewSlice;
+  cViewSlice.pcSliceHeader    = &rcSH;
+  cViewSlice.uiMbRead         = uiMbRead;
+  cViewSlice.uiWorker         = uiView % m_uiNumViewWorkers;
+  cViewSlice.bReconstruct     = bReconstruct;
+  cViewSlice.bLastSliceOfPic  = false;
+  cViewSlice.bOwnSliceHeader  = false;
+  m_cViewSliceList.push_back( cViewSlice );
+
+  //===== pictures that reference it wait for its rows, frame units released meanwhile may still be referenced =====
+  rcSH.getFrameUnit()->setRowsDone( 0 );
+  m_pcFrameMng->setHoldReleased( true );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCDecoder::xFinishViews()
+{
+  ROTRS( m_cViewSliceList.empty(), Err::m_nOK );
+
+  //----- a picture with missing slices is completed, otherwise the pictures that reference it would wait forever -----
+  m_cViewSliceList.back().bLastSliceOfPic = true;
+
+  //===== every thread takes the slices of its workers in decoding order, so the slices it waits for are taken earlier =====
+  const Int     iNumThreads = (Int)min( m_uiNumViewWorkers, (UInt)m_cViewIdList.size() );
+  const UInt    uiNumSlices = (UInt)m_cViewSliceList.size();
+  volatile Bool bAbort      = false;
+  ErrVal        nRet        = Err::m_nOK;
+
+#pragma omp parallel num_threads( iNumThreads )
+  {
+    const Int iThread   = omp_get_thread_num();
+    const Int iThreads  = omp_get_num_threads();
+    YuvBufferCtrl::setMbLane( 1 + iThread );
+
+    for( UInt uiSlice = 0; uiSlice < uiNumSlices && ! bAbort; uiSlice++ )
+    {
+      const ViewSlice& rcViewSlice = m_cViewSliceList[uiSlice];
+      if( (Int)rcViewSlice.uiWorker % iThreads != iThread )
+      {
+        continue;
+      }
+      ErrVal nWorker = m_papcViewWorker[rcViewSlice.uiWorker]->decodeSlice( rcViewSlice, m_pcParallelDecodingSei, bAbort );
+      if( Err::m_nOK != nWorker )
+      {
+#pragma omp critical
+        {
+          nRet    = nWorker;
+          bAbort  = true;
+        }
+#pragma omp flush
+      }
+    }
+
+    YuvBufferCtrl::setMbLane( 0 );
+  }
+
+  //===== slice headers that the decoder has dropped meanwhile, then the held frame units can be reused =====
+  for( UInt uiSlice = 0; uiSlice < uiNumSlices; uiSlice++ )
+  {
+    if( m_cViewSliceList[uiSlice].bOwnSliceHeader )
+    {
+      delete m_cViewSliceList[uiSlice].pcSliceHeader;
+    }
+  }
+  m_cViewSliceList.clear();
+  m_uiNumPendingViewPics = 0;
+  m_pcFrameMng->setHoldReleased( false );
+  RNOK( m_pcFrameMng->releaseHeldFrameUnits() );
+
+  return nRet;
+}
+
+
+ErrVal
+H264AVCDecoder::xSetPicBufferLists( PicBufferList& rcPicBufferOutputList, PicBufferList& rcPicBufferReleaseList )
+{
+  //===== the output pictures are written and the released buffers reused, so the pending pictures are reconstructed first =====
+  if( ! m_cViewSliceList.empty() )
+  {
+    ROTRS( m_uiNumPendingViewPics < MAX_PENDING_VIEW_PICTURES, Err::m_nOK );
+    RNOK( xFinishViews() );
+  }
+  RNOK( m_pcFrameMng->setPicBufferLists( rcPicBufferOutputList, rcPicBufferReleaseList ) );
+  return Err::m_nOK;
+}
+
+
+Void
+H264AVCDecoder::xDeleteSliceHeader( SliceHeader* pcSliceHeader )
+{
+  //===== a slice header of a pending slice is deleted after its reconstruction =====
+  for( UInt uiSlice = 0; uiSlice < m_cViewSliceList.size(); uiSlice++ )
+  {
+    if( m_cViewSliceList[uiSlice].pcSliceHeader == pcSliceHeader )
+    {
+      m_cViewSliceList[uiSlice].bOwnSliceHeader = true;
+      return;
+    }
+  }
+  delete pcSliceHeader;
+}
+
+
+Void
+H264AVCDecoder::xSetViewSubset( SpsMvcExtension* pcSpsMvc )
+{
+  //===== the inter-view references of all views, as signalled in the subset SPS =====
+  if( pcSpsMvc )
+  {
+    m_cInterViewRefList.clear();
+    for( UInt uiIdx = 0; uiIdx <= (UInt)pcSpsMvc->getNumViewMinus1(); uiIdx++ )
+    {
+      UInt uiViewId = pcSpsMvc->getViewCodingOrder()[uiIdx];
+      for( UInt uiList = 0; uiList < 2; uiList++ )
+      {
+        UInt uiRef;
+        for( uiRef = 0; uiRef < pcSpsMvc->getNumAnchorRefsForListX( uiViewId, uiList ); uiRef++ )
+        {
+          m_cInterViewRefList.push_back( uiViewId );
+          m_cInterViewRefList.push_back( pcSpsMvc->getAnchorRefForListX( uiViewId, uiRef, uiList ) );
+        }
+        for( uiRef = 0; uiRef < pcSpsMvc->getNumNonAnchorRefsForListX( uiViewId, uiList ); uiRef++ )
+        {
+          m_cInterViewRefList.push_back( uiViewId );
+          m_cInterViewRefList.push_back( pcSpsMvc->getNonAnchorRefForListX( uiViewId, uiRef, uiList ) );
+        }
+      }
+    }
+    m_bInterViewRefsKnown = true;
+  }
+
+  //===== nothing is dropped before the views the target views depend on are known =====
+  m_pcNalUnitParser->resetViewSubset();
+  ROFVS( m_bInterViewRefsKnown && ! m_cTargetViewIdList.empty() );
+
+  //===== the target views and, transitively, the views they reference =====
+  std::vector<UInt> cViewIdList( m_cTargetViewIdList );
+  for( UInt uiView = 0; uiView < cViewIdList.size(); uiView++ )
+  {
+    for( UInt uiRef = 0; uiRef < m_cInterViewRefList.size(); uiRef += 2 )
+    {
+      if( m_cInterViewRefList[uiRef] == cViewIdList[uiView] &&
+          std::find( cViewIdList.begin(), cViewIdList.end(), m_cInterViewRefList[uiRef+1] ) == cViewIdList.end() )
+      {
+        cViewIdList.push_back( m_cInterViewRefList[uiRef+1] );
+      }
+    }
+    m_pcNalUnitParser->addSubsetView( cViewIdList[uiView], uiView < m_cTargetViewIdList.size() );
+  }
+}
+
+
 ErrVal
 H264AVCDecoder::xInitSlice( SliceHeader* pcSliceHeader )
 {
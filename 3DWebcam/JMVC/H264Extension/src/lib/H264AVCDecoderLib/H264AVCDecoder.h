@@ -13,6 +13,9 @@
 
 // TMM_ESS 
 #include "ResizeParameters.h"
+#include "ViewWorker.h"
+#include <vector>
+#include <algorithm>
 
 
 H264AVC_NAMESPACE_BEGIN
@@ -185,6 +188,10 @@ public:
   Bool isRedundantPic()             { return m_bRedundantPic; }  // JVT-Q054 Red. Picture
   ErrVal  checkRedundantPic();  // JVT-Q054 Red. Picture
   Void    setFGSRefInAU(Bool &b); //JVT-T054
+  Void    setPipelined( Bool bPipelined ) { m_bPipelined = bPipelined; }
+  Void    setViewWorkers( ViewWorker** papcViewWorker, UInt uiNumViewWorkers ) { m_papcViewWorker = papcViewWorker; m_uiNumViewWorkers = uiNumViewWorkers; }
+  Void    setTargetViews( UInt uiNumViews, const UInt* puiViewId ) { m_cTargetViewIdList.assign( puiViewId, puiViewId + uiNumViews ); }
+  Void    setTargetOperationPoint( UInt uiOpId )                    { m_bOpPresentFlag = true; m_uiOperationPointId = uiOpId; }
 protected:
 
   ErrVal  xInitSlice                ( SliceHeader*    pcSliceHeader );
@@ -200,6 +207,17 @@ protected:
                                       PicBufferList&   rcPicBufferOutputList,
                                       PicBufferList&   rcPicBufferUnusedList,
                                       Bool            bHighestLayer); //JVT-T054
+  ErrVal  xProcessSlicePipelined    ( SliceHeader&    rcSH,
+                                      Bool            bReconstruct,
+                                      UInt&           ruiMbRead );
+  ErrVal  xQueueViewSlice           ( SliceHeader&    rcSH,
+                                      Bool            bReconstruct,
+                                      UInt            uiMbRead );
+  ErrVal  xFinishViews              ();
+  ErrVal  xSetPicBufferLists        ( PicBufferList&  rcPicBufferOutputList,
+                                      PicBufferList&  rcPicBufferReleaseList );
+  Void    xDeleteSliceHeader        ( SliceHeader*    pcSliceHeader );
+  Void    xSetViewSubset            ( SpsMvcExtension* pcSpsMvc );
 
   ErrVal  xZeroIntraMacroblocks     ( IntFrame*       pcFrame,
                                       MbDataCtrl*     pcMbDataCtrl,
@@ -227,6 +245,26 @@ protected:
   Bool                          m_bFrameDone;
   MotionCompensation*           m_pcMotionCompensation;
 
+  //===== pipelined decoding =====
+  Bool                          m_bPipelined;
+  Bool                          m_bPipelinedPic;            // the current picture is a frame without MBAFF and slice groups
+  UInt                          m_uiPipelineNextMb;         // the macroblocks before it are reconstructed, MSYS_UINT_MAX: slices out of order
+  UInt                          m_uiPipelineRowsFiltered;   // deblocked MB rows of the current picture
+
+  //===== parallel view decoding =====
+  ViewWorker**                  m_papcViewWorker;
+  UInt                          m_uiNumViewWorkers;
+  Bool                          m_bParallelViewPic;         // the current picture is parsed now and reconstructed by the worker of its view
+  UInt                          m_uiNumPendingViewPics;     // parsed pictures that wait for their reconstruction
+  std::vector<ViewSlice>        m_cViewSliceList;           // parsed slices in decoding order
+  std::vector<UInt>             m_cViewIdList;              // view ids in the order of their first slice, the worker is the index modulo the number of workers
+  SEI::ParallelDecodingSEI*     m_pcParallelDecodingSei;
+
+  //===== decoding of a view subset =====
+  std::vector<UInt>             m_cTargetViewIdList;        // output views, empty: all views are decoded
+  std::vector<UInt>             m_cInterViewRefList;        // pairs of a view id and one of its inter-view references
+  Bool                          m_bInterViewRefsKnown;      // a subset SPS has been read
+
 
   PicBuffer*                    m_pcFGSPicBuffer;
 
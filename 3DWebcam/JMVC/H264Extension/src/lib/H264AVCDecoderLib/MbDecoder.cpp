@@ -301,8 +301,9 @@ ErrVal MbDecoder::process( MbDataAccess& rcMbDataAccess,
 
   RNOK( xScaleTCoeffs( rcMbDataAccess ) );
 
-  YuvPicBuffer *pcRecYuvBuffer;
-  RNOK( m_pcFrameMng->getRecYuvBuffer( pcRecYuvBuffer, rcMbDataAccess.getMbPicType() ) );
+  //===== the picture of the slice, it is not the current one of the frame manager when a view worker decodes it =====
+  ROF( rcMbDataAccess.getSH().getFrameUnit() );
+  YuvPicBuffer *pcRecYuvBuffer = rcMbDataAccess.getSH().getFrameUnit()->getPic( rcMbDataAccess.getMbPicType() ).getFullPelYuvBuffer();
 
   IntYuvMbBuffer  cPredIntYuvMbBuffer;
   IntYuvMbBuffer  cResIntYuvMbBuffer;
@@ -8,6 +8,19 @@
 H264AVC_NAMESPACE_BEGIN
 
 
+//===== scalar search for 0x000003, the SIMD version checks 16 positions at once =====
+static Void xFindEscapesScalar( const UChar* pucPayload, UInt uiSize, std::vector<UInt>& rcEscapeOffsetList )
+{
+  for( UInt uiPos = 2; uiPos < uiSize; uiPos++ )
+  {
+    if( 0x03 == pucPayload[uiPos] && 0x00 == pucPayload[uiPos-1] && 0x00 == pucPayload[uiPos-2] )
+    {
+      rcEscapeOffsetList.push_back( uiPos );
+    }
+  }
+}
+
+
 NalUnitParser::NalUnitParser()
 : m_pcBitReadBuffer     ( 0 )
 , m_pucBuffer           ( 0 )
@@ -28,8 +41,14 @@ NalUnitParser::NalUnitParser()
 , m_reserved_zero_bits                (0)
 , m_reserved_one_bit    (1) // bug fix: prefix NAL (NTT)
 , m_inter_view_flag                 (false) //JVT-W056
+, m_bViewSubset         ( false )
+, m_bDroppedView        ( false )
+, m_fpFindEscapes       ( xFindEscapesScalar )
 
 {
+  resetViewSubset();
+  m_cEscapeOffsetList.reserve( 256 );
+  m_cEscapeOffsetList.push_back( MSYS_UINT_MAX );
   /*for ( UInt uiLoop = 0; uiLoop < (1 << PRI_ID_BITS); uiLoop++ )
   {
     m_uiTemporalLevelList[uiLoop] = 0;
@@ -57,11 +76,13 @@ NalUnitParser::create( NalUnitParser*& rpcNalUnitParser )
 
 
 ErrVal
-NalUnitParser::init( BitReadBuffer *pcBitReadBuffer )
+NalUnitParser::init( BitReadBuffer *pcBitReadBuffer, UInt uiSIMDFlags )
 {
   ROT(NULL == pcBitReadBuffer);
 
   m_pcBitReadBuffer = pcBitReadBuffer;
+  m_fpFindEscapes   = xFindEscapesScalar;
+  xInitSIMDFunctions( uiSIMDFlags & CpuInfo::getSIMDFlags() );
 
   return Err::m_nOK;
 }
@@ -75,6 +96,25 @@ NalUnitParser::destroy()
 }
 
 
+Void
+NalUnitParser::resetViewSubset()
+{
+  m_bViewSubset = false;
+  ::memset( m_auiTargetViewMask, 0x00, sizeof( m_auiTargetViewMask ) );
+  ::memset( m_auiRefViewMask,    0x00, sizeof( m_auiRefViewMask    ) );
+}
+
+
+Void
+NalUnitParser::addSubsetView( UInt uiViewId, Bool bTargetView )
+{
+  ROTVS( uiViewId >= ( VIEW_MASK_WORDS << 5 ) );
+
+  m_bViewSubset = true;
+  ( bTargetView ? m_auiTargetViewMask : m_auiRefViewMask )[uiViewId >> 5] |= ( 1 << ( uiViewId & 31 ) );
+}
+
+
 Void
 NalUnitParser::xTrace( Bool bDDIPresent )
 {
@@ -291,6 +331,7 @@ NalUnitParser::initSODBNalUnit( BinDataAccessor* pcBinDataAccessor )
   UInt uiPacketLength = pcBinDataAccessor->size();
 
   UInt uiBits;
+  xFindEscapes( uiPacketLength, false );
   xConvertRBSPToSODB(uiPacketLength, uiBits);
 
   RNOK( m_pcBitReadBuffer->initPacket( (UInt32*)(m_pucBuffer), uiBits) );
@@ -324,6 +365,7 @@ NalUnitParser::initNalUnit( BinDataAccessor* pcBinDataAccessor, Bool* KeyPicFlag
   UChar ucByte          = pcBinDataAccessor->data()[0];
 
   m_svc_mvc_flag = false;
+  m_bDroppedView = false;
 
   //===== NAL unit header =====
   ROT( ucByte & 0x80 );                                     // forbidden_zero_bit ( &10000000b)
@@ -404,6 +446,21 @@ NalUnitParser::initNalUnit( BinDataAccessor* pcBinDataAccessor, Bool* KeyPicFlag
   m_pucBuffer         = pcBinDataAccessor->data() + uiHeaderLength;
   UInt uiPacketLength = pcBinDataAccessor->size() - uiHeaderLength;
 
+  //===== coded slice extensions of views outside of the decoded subset are dropped without touching the payload; =====
+  //===== pictures of referenced views are dropped when they are neither temporal nor inter-view references      =====
+  if( m_bViewSubset && ! m_svc_mvc_flag &&
+      ( m_eNalUnitType == NAL_UNIT_CODED_SLICE_SCALABLE || m_eNalUnitType == NAL_UNIT_CODED_SLICE_IDR_SCALABLE ) &&
+      ! ( m_auiTargetViewMask[m_view_id >> 5] & ( 1 << ( m_view_id & 31 ) ) ) )
+  {
+    Bool bReferenced  = ( m_auiRefViewMask[m_view_id >> 5] & ( 1 << ( m_view_id & 31 ) ) ) != 0;
+    m_bDroppedView    = ! bReferenced || ( m_eNalRefIdc == NAL_REF_IDC_PRIORITY_LOWEST && ! m_inter_view_flag );
+    if( m_bDroppedView )
+    {
+      uiNumBytesRemoved = 0;
+      return Err::m_nOK;
+    }
+  }
+
   //JVT-P031
   if(m_bDiscardableFlag == true && m_uiDecodedLayer > m_uiLayerId && !m_bCheckAllNALUs)
   {
@@ -418,20 +475,9 @@ NalUnitParser::initNalUnit( BinDataAccessor* pcBinDataAccessor, Bool* KeyPicFlag
          NAL_UNIT_CODED_SLICE_PREFIX  == m_eNalUnitType,    Err::m_nOK ); // bug fix: no trailing bit for prefix NAL (NTT)
 
 
-  uiNumBytesRemoved = uiPacketLength;//FIX_FRAG_CAVLC
-	if ( !bCheckGap)
-	{
-		// Unit->RBSP
-		if(bPreParseHeader) //FRAG_FIX
-		{//FIX_FRAG_CAVLC
-				RNOK( xConvertPayloadToRBSP ( uiPacketLength ) );
-				uiNumBytesRemoved -= uiPacketLength; //FIX_FRAG_CAVLC
-		}//FIX_FRAG_CAVLC
-	}
-	else //TMM_EC
-	{
-		uiNumBytesRemoved	=	0;
-	}
+  // Unit->RBSP: the payload stays as it is, both parsing passes skip its emulation prevention bytes while reading
+  uiNumBytesRemoved = 0;//FIX_FRAG_CAVLC
+  xFindEscapes( uiPacketLength, !bCheckGap ); //TMM_EC
   UInt uiBitsInPacket;
   // RBSP->SODB
   RNOK( xConvertRBSPToSODB    ( uiPacketLength, uiBitsInPacket ) );
@@ -449,7 +495,7 @@ NalUnitParser::initNalUnit( BinDataAccessor* pcBinDataAccessor, Bool* KeyPicFlag
   {
 	  if(uiBitsInPacket<1)return Err::m_nOK;//lufeng: empty packet
 
-      RNOK( m_pcBitReadBuffer->initPacket( (UInt32*)(m_pucBuffer), uiBitsInPacket) );
+      RNOK( m_pcBitReadBuffer->initPacket( m_pucBuffer, uiBitsInPacket, &m_cEscapeOffsetList[0] ) );
   }
   return Err::m_nOK;
 }
@@ -471,36 +517,15 @@ NalUnitParser::closeNalUnit()
 
 
 
-ErrVal
-NalUnitParser::xConvertPayloadToRBSP( UInt& ruiPacketLength )
+Void
+NalUnitParser::xFindEscapes( UInt uiPacketLength, Bool bEscaped )
 {
-  UInt uiZeroCount    = 0;
-  UInt uiWriteOffset  = 0;
-  UInt uiReadOffset   = 0;
-
-  for( ; uiReadOffset < ruiPacketLength; uiReadOffset++, uiWriteOffset++ )
+  m_cEscapeOffsetList.clear();
+  if( bEscaped )
   {
-    if( 2 == uiZeroCount && 0x03 == m_pucBuffer[uiReadOffset] )
-    {
-      uiReadOffset++;
-      uiZeroCount = 0;
-    }
-
-    m_pucBuffer[uiWriteOffset] = m_pucBuffer[uiReadOffset];
-
-    if( 0x00 == m_pucBuffer[uiReadOffset] )
-    {
-      uiZeroCount++;
-    }
-    else
-    {
-      uiZeroCount = 0;
-    }
+    m_fpFindEscapes( m_pucBuffer, uiPacketLength, m_cEscapeOffsetList );
   }
-
-  ruiPacketLength = uiWriteOffset;
-
-  return Err::m_nOK;
+  m_cEscapeOffsetList.push_back( MSYS_UINT_MAX );
 }
 
 
@@ -511,9 +536,11 @@ NalUnitParser::xConvertRBSPToSODB( UInt  uiPacketLength,
   uiPacketLength--;
   UChar *puc = m_pucBuffer;
 
-  //remove zero bytes at the end of the stream
-  while (puc[uiPacketLength] == 0x00)
+  //remove zero bytes at the end of the stream, and the emulation prevention bytes of cabac_zero_words among them
+  UInt uiNumEscapes = (UInt)m_cEscapeOffsetList.size() - 1;
+  while (puc[uiPacketLength] == 0x00 || ( uiNumEscapes && m_cEscapeOffsetList[uiNumEscapes-1] == uiPacketLength ))
   {
+    uiNumEscapes   -= ( puc[uiPacketLength] != 0x00 );
     uiPacketLength-=1;
   }
 
@@ -526,7 +553,8 @@ NalUnitParser::xConvertRBSPToSODB( UInt  uiPacketLength,
     AOT_DBG( i > 7 );
   }
 
-  ruiBitsInPacket = (uiPacketLength << 3) + 8 - i;
+  //the bit reader skips the remaining emulation prevention bytes
+  ruiBitsInPacket = ((uiPacketLength - uiNumEscapes) << 3) + 8 - i;
   return Err::m_nOK;
 }
 
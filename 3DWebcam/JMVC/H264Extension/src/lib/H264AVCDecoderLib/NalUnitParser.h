@@ -5,6 +5,8 @@
 #pragma once
 #endif // _MSC_VER > 1000
 
+#include <vector>
+#include "H264AVCCommonLib/CpuInfo.h"
 
 
 H264AVC_NAMESPACE_BEGIN
@@ -15,13 +17,19 @@ class BitReadBuffer;
 
 class NalUnitParser
 {
+  enum { VIEW_MASK_WORDS = ( 1 << 10 ) >> 5 };  // view_id is u(10)
+
+  //===== appends the offsets of the emulation prevention bytes ( 0x03 of 0x000003 ) of a payload =====
+  typedef Void (*FindEscapesFunc)( const UChar* pucPayload, UInt uiSize, std::vector<UInt>& rcEscapeOffsetList );
+
 public:
 	NalUnitParser                 ();
 	virtual ~NalUnitParser        ();
 
   static ErrVal create          ( NalUnitParser*&   rpcNalUnitParser  );
   
-  ErrVal        init            ( BitReadBuffer*    pcBitReadBuffer   );
+  ErrVal        init            ( BitReadBuffer*    pcBitReadBuffer,
+                                  UInt              uiSIMDFlags = SIMD_ALL );
   ErrVal        destroy         ();
 
   ErrVal        initNalUnit     ( BinDataAccessor*  pcBinDataAccessor, Bool* KeyPicFlag, 
@@ -82,15 +90,22 @@ JVT-S036 lsj */
   Void setCheckAllNALUs(Bool b) { m_bCheckAllNALUs = b;}
   Void setDecodedLayer( UInt uiLayer) { m_uiDecodedLayer = uiLayer;}
   //~JVT-P031
+
+  //===== decoding of a view subset: the coded slice extensions of the other views are dropped after the NAL unit header =====
+  Void    resetViewSubset ();                                   // all views are decoded
+  Void    addSubsetView   ( UInt uiViewId, Bool bTargetView );  // a target view or a view referenced by them
+  Bool    isDroppedView   ()    { return m_bDroppedView; }      // the last NAL unit has been dropped, its payload is untouched
+
 	ErrVal	readAUDelimiter       ();
   ErrVal  readEndOfSeqence      ();
   ErrVal  readEndOfStream       ();
 
 protected:
   Void    xTrace                ( Bool  bDDIPresent     );
-  ErrVal  xConvertPayloadToRBSP ( UInt& ruiPacketLength );
+  Void    xFindEscapes          ( UInt  uiPacketLength, Bool bEscaped );
   ErrVal  xConvertRBSPToSODB    ( UInt  iPacketLength,
                                   UInt& ruiBitsInPacket );
+  Void    xInitSIMDFunctions    ( UInt  uiSIMDFlags );
 
 protected:
   BitReadBuffer *m_pcBitReadBuffer;
@@ -127,6 +142,15 @@ protected:
   UInt          m_uiDecodedLayer;
   //~JVT-P031
   UInt          m_uiBitsInPacketSaved; //FRAG_FIX
+
+  Bool          m_bViewSubset;
+  Bool          m_bDroppedView;
+  UInt          m_auiTargetViewMask [VIEW_MASK_WORDS];
+  UInt          m_auiRefViewMask    [VIEW_MASK_WORDS];  // views that are not output but referenced by the target views
+
+  //===== the payload is read in place, its emulation prevention bytes are skipped by the bit reader =====
+  FindEscapesFunc   m_fpFindEscapes;
+  std::vector<UInt> m_cEscapeOffsetList;  // ascending offsets in the payload, terminated by MSYS_UINT_MAX
 };
 
 
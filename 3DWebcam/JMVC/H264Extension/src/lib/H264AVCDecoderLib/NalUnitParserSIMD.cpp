@@ -0,0 +1,70 @@
+#include "H264AVCDecoderLib.h"
+#include "NalUnitParser.h"
+
+#if defined( H264AVC_X86_SIMD )
+#include <emmintrin.h>
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+// The SIMD search finds the same emulation prevention bytes as the scalar
+// one: a 0x03 byte preceded by two zero bytes. Every lane of a 16 byte block
+// is the first byte of a candidate 0x000003, the loads at +1 and +2 supply
+// the other two bytes, so a block costs three compares no matter how many
+// zero bytes it holds. Lanes are only visited for the rare matches.
+
+
+#if defined( H264AVC_X86_SIMD )
+
+SIMD_TARGET( "sse2" )
+static Void xFindEscapesSSE2( const UChar* pucPayload, UInt uiSize, std::vector<UInt>& rcEscapeOffsetList )
+{
+  const __m128i vZero   = _mm_setzero_si128();
+  const __m128i vThree  = _mm_set1_epi8( 0x03 );
+  UInt          uiPos   = 0;
+
+  for( ; uiPos + 18 <= uiSize; uiPos += 16 )
+  {
+    __m128i v0    = _mm_loadu_si128( (const __m128i*)( pucPayload + uiPos     ) );
+    __m128i v1    = _mm_loadu_si128( (const __m128i*)( pucPayload + uiPos + 1 ) );
+    __m128i v2    = _mm_loadu_si128( (const __m128i*)( pucPayload + uiPos + 2 ) );
+    __m128i vHit  = _mm_and_si128( _mm_and_si128( _mm_cmpeq_epi8( v0, vZero ), _mm_cmpeq_epi8( v1, vZero ) ),
+                                   _mm_cmpeq_epi8( v2, vThree ) );
+    UInt    uiHit = (UInt)_mm_movemask_epi8( vHit );
+
+    for( UInt uiLane = uiPos + 2; uiHit; uiHit >>= 1, uiLane++ )
+    {
+      if( uiHit & 1 )
+      {
+        rcEscapeOffsetList.push_back( uiLane );
+      }
+    }
+  }
+
+  //===== the last bytes =====
+  for( uiPos += 2; uiPos < uiSize; uiPos++ )
+  {
+    if( 0x03 == pucPayload[uiPos] && 0x00 == pucPayload[uiPos-1] && 0x00 == pucPayload[uiPos-2] )
+    {
+      rcEscapeOffsetList.push_back( uiPos );
+    }
+  }
+}
+
+#endif
+
+
+Void NalUnitParser::xInitSIMDFunctions( UInt uiSIMDFlags )
+{
+#if defined( H264AVC_X86_SIMD )
+  if( uiSIMDFlags & SIMD_SSE2 )
+  {
+    m_fpFindEscapes = xFindEscapesSSE2;
+  }
+#endif
+}
+
+
+H264AVC_NAMESPACE_END
@@ -17,6 +17,7 @@ SliceDecoder::SliceDecoder():
   m_pcMbDecoder ( NULL ),
   m_pcControlMng( NULL ),
   m_pcTransform ( NULL ),
+  m_pcMbDataAccess( NULL ),
   m_bInitDone   ( false)
 {
 }
@@ -67,6 +68,7 @@ SliceDecoder::uninit()
   ROF( m_bInitDone );
   m_pcMbDecoder   =  NULL;
   m_pcControlMng  =  NULL;
+  H264AVC_DELETE_CLASS( m_pcMbDataAccess );
   m_bInitDone     = false;
   return Err::m_nOK;
 }
@@ -232,4 +234,26 @@ SliceDecoder::compensatePrediction( SliceHeader&   rcSH )
 }
 
 
+ErrVal
+SliceDecoder::decodeMb( const SliceHeader& rcSH,
+                        MbDataCtrl*        pcMbDataCtrl,
+                        UInt               uiMbAddress,
+                        UChar&             rucLastMbQp,
+                        Bool               bReconstructAll )
+{
+  ROF( m_bInitDone );
+  ROT( NULL == pcMbDataCtrl );
+
+  UInt uiMbY, uiMbX, uiMbIndex;
+  rcSH.getMbPositionFromAddress( uiMbY, uiMbX, uiMbIndex, uiMbAddress );
+
+  RNOK( pcMbDataCtrl->initMbForPipeline( m_pcMbDataAccess, const_cast<SliceHeader&>( rcSH ), uiMbY, uiMbX, rucLastMbQp, false ) );
+  RNOK( m_pcControlMng->initMbForReconstruction( *m_pcMbDataAccess, uiMbY, uiMbX ) );
+  RNOK( m_pcMbDecoder ->process( *m_pcMbDataAccess, bReconstructAll ) );
+
+  rucLastMbQp = m_pcMbDataAccess->getMbData().getQp();
+  return Err::m_nOK;
+}
+
+
 H264AVC_NAMESPACE_END
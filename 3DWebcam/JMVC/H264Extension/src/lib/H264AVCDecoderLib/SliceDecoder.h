@@ -50,11 +50,20 @@ public:
                         UInt                uiMbInRow,
                         UInt                uiMbRead );
   ErrVal compensatePrediction( SliceHeader& rcSH );
+  //===== reconstruction stage of the pipelined decoder: decodes one macroblock of a frame without MBAFF that has been =====
+  //===== parsed while the next ones are parsed; rucLastMbQp is the QP of the previous macroblock of the slice (the =====
+  //===== picture QP for the first one) and is advanced =====
+  ErrVal decodeMb     ( const SliceHeader&  rcSH,
+                        MbDataCtrl*         pcMbDataCtrl,
+                        UInt                uiMbAddress,
+                        UChar&              rucLastMbQp,
+                        Bool                bReconstructAll );
 
 protected:
   MbDecoder*    m_pcMbDecoder;
   ControlMngIf* m_pcControlMng;
   Transform*    m_pcTransform;
+  MbDataAccess* m_pcMbDataAccess; // storage of decodeMb()
   Bool          m_bInitDone;
 
 };
@@ -82,7 +82,7 @@ ErrVal SliceReader::uninit()
 
 // JVT-S054 (2) (REPLACE)
 //ErrVal SliceReader::process( const SliceHeader& rcSH, UInt& ruiMbRead )
-ErrVal SliceReader::process( SliceHeader& rcSH, UInt& ruiMbRead )
+ErrVal SliceReader::process( SliceHeader& rcSH, UInt& ruiMbRead, volatile Int* piMbParsed )
 {
   int sgId = rcSH.getFMO()->getSliceGroupId(rcSH.getFirstMbInSlice());  
   int pocOrder = rcSH.getPicOrderCntLsb();
@@ -121,6 +121,12 @@ ErrVal SliceReader::process( SliceHeader& rcSH, UInt& ruiMbRead )
     //--ICU/ETRI FMO Implementation
     uiMbAddress  = rcSH.getFMO()->getNextMBNr(uiMbAddress ); 
 
+    if( piMbParsed )
+    {
+#pragma omp flush
+      *piMbParsed = (Int)ruiMbRead + 1;
+#pragma omp flush
+    }
   }
   // JVT-S054 (2) (ADD)
   rcSH.setNumMbsInSlice(ruiMbRead);
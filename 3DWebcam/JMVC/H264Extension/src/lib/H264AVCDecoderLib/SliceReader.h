@@ -31,7 +31,8 @@ public:
   // JVT-S054 (2) (REPLACE)
   //ErrVal process( const SliceHeader& rcSH, UInt& ruiMbRead );
 
-  ErrVal process( SliceHeader& rcSH, UInt& ruiMbRead );
+  // piMbParsed: number of parsed macroblocks, published after each one for the reconstruction stage of the pipelined decoder
+  ErrVal process( SliceHeader& rcSH, UInt& ruiMbRead, volatile Int* piMbParsed = NULL );
 
   
   ErrVal readSliceHeader  ( NalUnitType   eNalUnitType,
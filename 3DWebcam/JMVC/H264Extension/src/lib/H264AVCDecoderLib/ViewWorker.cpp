@@ -0,0 +1,314 @@
+#include "H264AVCDecoderLib.h"
+#include "ViewWorker.h"
+#include "MbDecoder.h"
+
+#include "H264AVCCommonLib/MbDataCtrl.h"
+#include "H264AVCCommonLib/Frame.h"
+#include "H264AVCCommonLib/FrameUnit.h"
+#include "H264AVCCommonLib/LoopFilter.h"
+#include "H264AVCCommonLib/Transform.h"
+#include "H264AVCCommonLib/IntraPrediction.h"
+#include "H264AVCCommonLib/MotionCompensation.h"
+#include "H264AVCCommonLib/SampleWeighting.h"
+#include "H264AVCCommonLib/YuvBufferCtrl.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+ViewWorker::ViewWorker():
+  m_pcTransform             ( NULL ),
+  m_pcIntraPrediction       ( NULL ),
+  m_pcMotionCompensation    ( NULL ),
+  m_pcSampleWeighting       ( NULL ),
+  m_pcMbDecoder             ( NULL ),
+  m_pcLoopFilter            ( NULL ),
+  m_pcYuvFullPelBufferCtrl  ( NULL ),
+  m_pcMbDataAccess          ( NULL ),
+  m_uiNumRefFrameUnits      ( 0 ),
+  m_pcFrameUnit             ( NULL ),
+  m_uiNextMb                ( 0 ),
+  m_uiRowsFiltered          ( 0 ),
+  m_uiRowsPadded            ( 0 ),
+  m_bInitDone               ( false )
+{
+}
+
+
+ViewWorker::~ViewWorker()
+{
+}
+
+
+ErrVal
+ViewWorker::create( ViewWorker*& rpcViewWorker )
+{
+  rpcViewWorker = new ViewWorker;
+  ROT( NULL == rpcViewWorker );
+
+  ViewWorker* p = rpcViewWorker;
+  RNOK( Transform           ::create( p->m_pcTransform ) );
+  RNOK( IntraPrediction     ::create( p->m_pcIntraPrediction ) );
+  RNOK( MotionCompensation  ::create( p->m_pcMotionCompensation ) );
+  RNOK( SampleWeighting     ::create( p->m_pcSampleWeighting ) );
+  RNOK( MbDecoder           ::create( p->m_pcMbDecoder ) );
+  RNOK( LoopFilter          ::create( p->m_pcLoopFilter ) );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+ViewWorker::destroy()
+{
+  RNOK( m_pcTransform           ->destroy() );
+  RNOK( m_pcIntraPrediction     ->destroy() );
+  RNOK( m_pcMotionCompensation  ->destroy() );
+  RNOK( m_pcSampleWeighting     ->destroy() );
+  RNOK( m_pcMbDecoder           ->destroy() );
+  RNOK( m_pcLoopFilter          ->destroy() );
+
+  delete this;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+ViewWorker::init( YuvBufferCtrl*        pcYuvFullPelBufferCtrl,
+                  QuarterPelFilter*     pcQuarterPelFilter,
+                  FrameMng*             pcFrameMng,
+                  ControlMngIf*         pcControlMng,
+                  ReconstructionBypass* pcReconstructionBypass )
+{
+  ROT( m_bInitDone );
+  ROF( pcYuvFullPelBufferCtrl );
+
+  //===== same set-up as the shared modules in CreaterH264AVCDecoder::init() =====
+  RNOK( m_pcSampleWeighting     ->init() );
+  RNOK( m_pcIntraPrediction     ->init() );
+  RNOK( m_pcLoopFilter          ->init( pcControlMng, pcReconstructionBypass ) );
+  RNOK( m_pcMotionCompensation  ->init( pcQuarterPelFilter,
+                                        m_pcTransform,
+                                        m_pcSampleWeighting ) );
+  RNOK( m_pcMbDecoder           ->init( m_pcTransform,
+                                        m_pcIntraPrediction,
+                                        m_pcMotionCompensation,
+                                        pcFrameMng ) );
+  m_pcYuvFullPelBufferCtrl  = pcYuvFullPelBufferCtrl;
+  m_pcFrameUnit             = NULL;
+
+  m_bInitDone = true;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+ViewWorker::uninit()
+{
+  ROF( m_bInitDone );
+
+  RNOK( m_pcSampleWeighting     ->uninit() );
+  RNOK( m_pcIntraPrediction     ->uninit() );
+  RNOK( m_pcLoopFilter          ->uninit() );
+  RNOK( m_pcMotionCompensation  ->uninit() );
+  RNOK( m_pcMbDecoder           ->uninit() );
+  H264AVC_DELETE_CLASS( m_pcMbDataAccess );
+  m_pcYuvFullPelBufferCtrl  = NULL;
+  m_pcFrameUnit             = NULL;
+
+  m_bInitDone = false;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+ViewWorker::decodeSlice( const ViewSlice&                 rcViewSlice,
+                         const SEI::ParallelDecodingSEI*  pcParallelDecodingSei,
+                         volatile Bool&                   rbAbort )
+{
+  ROF( m_bInitDone );
+  ROF( rcViewSlice.pcSliceHeader );
+
+  SliceHeader&  rcSH          = *rcViewSlice.pcSliceHeader;
+  FrameUnit*    pcFrameUnit   = rcSH.getFrameUnit();
+  ROF( pcFrameUnit );
+  MbDataCtrl*   pcMbDataCtrl  = pcFrameUnit->getMbDataCtrl();
+
+  if( pcFrameUnit != m_pcFrameUnit )
+  {
+    m_pcFrameUnit     = pcFrameUnit;
+    m_uiNextMb        = 0;
+    m_uiRowsFiltered  = 0;
+    m_uiRowsPadded    = 0;
+  }
+
+  //===== as ControlMngH264AVCDecoder::initSlice( DECODE_PROCESS ), with the modules of the worker =====
+  RNOK( pcMbDataCtrl            ->initSlice( rcSH, DECODE_PROCESS, true, NULL ) );
+  RNOK( m_pcMotionCompensation  ->initSlice( rcSH ) );
+  RNOK( m_pcSampleWeighting     ->initSlice( rcSH ) );
+  RNOK( xInitRefFrameUnits( rcSH, pcParallelDecodingSei ) );
+
+  const UInt  uiMbInRow   = rcSH.getSPS().getFrameWidthInMbs();
+  const UInt  uiFirstMb   = rcSH.getFirstMbInSlice();
+  //----- the rows above the slice are complete when the slices arrive in raster order -----
+  const Bool  bInOrder    = ( uiFirstMb == m_uiNextMb );
+  UChar       ucLastMbQp  = (UChar)rcSH.getPicQp();
+  UInt        uiWaitedRow = MSYS_UINT_MAX;
+
+  for( UInt uiMb = 0; uiMb < rcViewSlice.uiMbRead; uiMb++ )
+  {
+    UInt uiMbY, uiMbX, uiMbIndex;
+    rcSH.getMbPositionFromAddress( uiMbY, uiMbX, uiMbIndex, uiFirstMb + uiMb );
+    if( uiMbY != uiWaitedRow )
+    {
+      ROFRS( xWaitForRefs( uiMbY, rbAbort ), Err::m_nERR );
+      uiWaitedRow = uiMbY;
+    }
+
+    //===== as SliceDecoder::decodeMb() =====
+    RNOK( pcMbDataCtrl            ->initMbForPipeline( m_pcMbDataAccess, rcSH, uiMbY, uiMbX, ucLastMbQp, false ) );
+    RNOK( m_pcYuvFullPelBufferCtrl->initMb( uiMbY, uiMbX, false ) );
+    RNOK( m_pcMotionCompensation  ->initMb( uiMbY, uiMbX, *m_pcMbDataAccess ) );
+    RNOK( m_pcMbDecoder           ->process( *m_pcMbDataAccess, rcViewSlice.bReconstruct ) );
+    ucLastMbQp = m_pcMbDataAccess->getMbData().getQp();
+
+    if( bInOrder && uiMbX == uiMbInRow - 1 )
+    {
+      RNOK( xFinishRows( rcSH, uiMbY + 1, false ) );
+    }
+  }
+  m_uiNextMb = ( bInOrder ? uiFirstMb + rcViewSlice.uiMbRead : MSYS_UINT_MAX );
+
+  ROFRS( rcViewSlice.bLastSliceOfPic, Err::m_nOK );
+
+  //===== the rows that have not been deblocked while the slices were decoded, then the picture is complete =====
+  RNOK( xFinishRows( rcSH, rcSH.getMbInPic() / uiMbInRow, true ) );
+  RNOK( pcMbDataCtrl->initSlice( rcSH, POST_PROCESS, true, NULL ) );
+  m_pcFrameUnit = NULL;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+ViewWorker::xInitRefFrameUnits( SliceHeader& rcSH, const SEI::ParallelDecodingSEI* pcParallelDecodingSei )
+{
+  const UInt uiMbInCol  = rcSH.getMbInPic() / rcSH.getSPS().getFrameWidthInMbs();
+  m_uiNumRefFrameUnits  = 0;
+
+  for( UInt uiList = 0; uiList < 2; uiList++ )
+  {
+    const ListIdx             eListIdx  = ListIdx( uiList );
+    const RefPicList<RefPic>& rcList    = rcSH.getRefPicList( FRAME, eListIdx );
+
+    for( UInt uiIdx = 0; uiIdx < rcList.size(); uiIdx++ )
+    {
+      const Frame* pcFrame = rcList.get( uiIdx ).getFrame();
+      if( NULL == pcFrame || NULL == pcFrame->getFrameUnit() )
+      {
+        continue;
+      }
+
+      //----- pictures of the same view have been completed by this worker, inter-view references may be in progress -----
+      const FrameUnit*  pcRefFrameUnit  = pcFrame->getFrameUnit();
+      const UInt        uiRowDelay      = ( pcFrame->getViewId() == rcSH.getViewId() ? uiMbInCol :
+                                            xGetInterViewDelay( rcSH, pcParallelDecodingSei, eListIdx, pcFrame->getViewId() ) );
+      UInt              uiRef;
+      for( uiRef = 0; uiRef < m_uiNumRefFrameUnits && m_apcRefFrameUnit[uiRef] != pcRefFrameUnit; uiRef++ );
+      if( uiRef == m_uiNumRefFrameUnits )
+      {
+        ROT( m_uiNumRefFrameUnits == MAX_REF_FRAME_UNITS );
+        m_apcRefFrameUnit[uiRef]  = pcRefFrameUnit;
+        m_auiRefRowDelay [uiRef]  = uiRowDelay;
+        m_uiNumRefFrameUnits++;
+      }
+      else
+      {
+        m_auiRefRowDelay [uiRef]  = max( m_auiRefRowDelay[uiRef], uiRowDelay );
+      }
+    }
+  }
+
+  return Err::m_nOK;
+}
+
+
+UInt
+ViewWorker::xGetInterViewDelay( SliceHeader& rcSH, const SEI::ParallelDecodingSEI* pcParallelDecodingSei, ListIdx eListIdx, UInt uiRefViewId )
+{
+  const UInt uiMbInCol = rcSH.getMbInPic() / rcSH.getSPS().getFrameWidthInMbs();
+
+  //===== the SEI applies to the view dependencies of the SPS it refers to =====
+  ROTRS( NULL == pcParallelDecodingSei || 0 == pcParallelDecodingSei->getNumView(),             uiMbInCol );
+  ROTRS( pcParallelDecodingSei->getSPSId() != rcSH.getSPS().getSeqParameterSetId(),             uiMbInCol );
+  ROTRS( NULL == rcSH.getSPS().getSpsMVC(),                                                      uiMbInCol );
+
+  SpsMvcExtension&  rcSpsMVC  = *rcSH.getSPS().getSpsMVC();
+  const UInt        uiViewId  = rcSH.getViewId();
+  const Bool        bAnchor   = rcSH.getAnchorPicFlag();
+  const UInt        uiNumRefs = rcSpsMVC.getNumRefsForListX( uiViewId, eListIdx, bAnchor );
+
+  for( UInt uiRef = 0; uiRef < uiNumRefs; uiRef++ )
+  {
+    if( rcSpsMVC.getViewIDByViewIndex( uiViewId, uiRef, eListIdx, bAnchor ) == uiRefViewId )
+    {
+      UInt uiDelay = pcParallelDecodingSei->getPDIInitDelay( rcSpsMVC.getViewCodingOrderIdxFromAViewId( uiViewId ), bAnchor, eListIdx, uiRef );
+      return ( uiDelay ? min( uiDelay, uiMbInCol ) : uiMbInCol );
+    }
+  }
+  return uiMbInCol;
+}
+
+
+Bool
+ViewWorker::xWaitForRefs( UInt uiMbY, volatile Bool& rbAbort )
+{
+  //===== the rows of the references that MB row uiMbY may access, the picture is complete at MSYS_UINT_MAX =====
+  for( UInt uiRef = 0; uiRef < m_uiNumRefFrameUnits; uiRef++ )
+  {
+    const UInt uiRows = uiMbY + m_auiRefRowDelay[uiRef];
+    while( m_apcRefFrameUnit[uiRef]->getRowsDone() < uiRows )
+    {
+#pragma omp flush
+      if( rbAbort )
+      {
+        return false;
+      }
+    }
+  }
+#pragma omp flush
+  return true;
+}
+
+
+ErrVal
+ViewWorker::xFinishRows( SliceHeader& rcSH, UInt uiRowsDecoded, Bool bLastSliceOfPic )
+{
+  const UInt  uiMbInCol     = rcSH.getMbInPic() / rcSH.getSPS().getFrameWidthInMbs();
+  MbDataCtrl* pcMbDataCtrl  = m_pcFrameUnit->getMbDataCtrl();
+
+  //===== a MB row is deblocked when the row below it has been reconstructed (intra prediction reads unfiltered samples), =====
+  //===== and it is final when the row below it has been deblocked =====
+  const UInt  uiFiltered    = ( bLastSliceOfPic ? uiMbInCol : ( uiRowsDecoded ? uiRowsDecoded - 1 : 0 ) );
+  if( uiFiltered > m_uiRowsFiltered )
+  {
+    RNOK( m_pcLoopFilter->filterRows( rcSH, pcMbDataCtrl, m_uiRowsFiltered, uiFiltered ) );
+    m_uiRowsFiltered = uiFiltered;
+  }
+
+  const UInt  uiFinal       = ( bLastSliceOfPic ? uiMbInCol : ( m_uiRowsFiltered ? m_uiRowsFiltered - 1 : 0 ) );
+  ROTRS( uiFinal <= m_uiRowsPadded && ! bLastSliceOfPic, Err::m_nOK );
+  RNOK( m_pcFrameUnit->getPic( FRAME ).getFullPelYuvBuffer()->fillMarginRows( m_uiRowsPadded, uiFinal ) );
+  m_uiRowsPadded = uiFinal;
+
+#pragma omp flush
+  m_pcFrameUnit->setRowsDone( bLastSliceOfPic ? MSYS_UINT_MAX : uiFinal );
+#pragma omp flush
+  return Err::m_nOK;
+}
+
+
+H264AVC_NAMESPACE_END
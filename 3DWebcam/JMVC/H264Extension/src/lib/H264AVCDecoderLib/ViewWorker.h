@@ -0,0 +1,99 @@
+#if !defined(AFX_VIEWWORKER_H__7A3E5C92_1D4B_4F86_9C20_B5E8F3D61A47__INCLUDED_)
+#define AFX_VIEWWORKER_H__7A3E5C92_1D4B_4F86_9C20_B5E8F3D61A47__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "H264AVCCommonLib/Sei.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+class Transform;
+class IntraPrediction;
+class MotionCompensation;
+class SampleWeighting;
+class MbDecoder;
+class LoopFilter;
+class YuvBufferCtrl;
+class QuarterPelFilter;
+class FrameMng;
+class ControlMngIf;
+class ReconstructionBypass;
+class FrameUnit;
+
+
+//===== a slice that has been parsed and waits for its reconstruction by the worker of its view =====
+struct ViewSlice
+{
+  SliceHeader*  pcSliceHeader;
+  UInt          uiMbRead;
+  UInt          uiWorker;
+  Bool          bReconstruct;
+  Bool          bLastSliceOfPic;
+  Bool          bOwnSliceHeader;    // the decoder has dropped the slice header, it is deleted after the reconstruction
+};
+
+
+//===== reconstructs, deblocks and pads the parsed slices of one view while the workers of the other views do the same; =====
+//===== the progress of a picture is published in its FrameUnit, inter-view references are waited for per MB row =====
+class ViewWorker
+{
+  enum { MAX_REF_FRAME_UNITS = 64 };
+
+protected:
+  ViewWorker();
+  virtual ~ViewWorker();
+
+public:
+  static ErrVal create( ViewWorker*& rpcViewWorker );
+  ErrVal destroy();
+  ErrVal init( YuvBufferCtrl*        pcYuvFullPelBufferCtrl,
+               QuarterPelFilter*     pcQuarterPelFilter,
+               FrameMng*             pcFrameMng,
+               ControlMngIf*         pcControlMng,
+               ReconstructionBypass* pcReconstructionBypass );
+  ErrVal uninit();
+
+  //===== the slices of a picture are passed in decoding order and the calling thread must have selected the macroblock =====
+  //===== offsets of this worker (YuvBufferCtrl::setMbLane); the initial delays of the parallel decoding info SEI limit =====
+  //===== the rows of an inter-view reference that are waited for, without it the complete picture is waited for =====
+  ErrVal decodeSlice( const ViewSlice&                  rcViewSlice,
+                      const SEI::ParallelDecodingSEI*   pcParallelDecodingSei,
+                      volatile Bool&                    rbAbort );
+
+protected:
+  ErrVal xInitRefFrameUnits ( SliceHeader& rcSH, const SEI::ParallelDecodingSEI* pcParallelDecodingSei );
+  UInt   xGetInterViewDelay ( SliceHeader& rcSH, const SEI::ParallelDecodingSEI* pcParallelDecodingSei, ListIdx eListIdx, UInt uiRefViewId );
+  Bool   xWaitForRefs       ( UInt uiMbY, volatile Bool& rbAbort );
+  ErrVal xFinishRows        ( SliceHeader& rcSH, UInt uiRowsDecoded, Bool bLastSliceOfPic );
+
+protected:
+  Transform*            m_pcTransform;
+  IntraPrediction*      m_pcIntraPrediction;
+  MotionCompensation*   m_pcMotionCompensation;
+  SampleWeighting*      m_pcSampleWeighting;
+  MbDecoder*            m_pcMbDecoder;
+  LoopFilter*           m_pcLoopFilter;
+  YuvBufferCtrl*        m_pcYuvFullPelBufferCtrl;
+  MbDataAccess*         m_pcMbDataAccess;   // storage of decodeSlice()
+
+  //===== references of the current slice and the MB rows they must have completed, relative to the current row =====
+  UInt                  m_uiNumRefFrameUnits;
+  const FrameUnit*      m_apcRefFrameUnit[MAX_REF_FRAME_UNITS];
+  UInt                  m_auiRefRowDelay [MAX_REF_FRAME_UNITS];
+
+  //===== the picture in progress =====
+  FrameUnit*            m_pcFrameUnit;
+  UInt                  m_uiNextMb;         // the macroblocks before it are reconstructed, MSYS_UINT_MAX: slices out of order
+  UInt                  m_uiRowsFiltered;   // deblocked MB rows
+  UInt                  m_uiRowsPadded;     // MB rows whose margins are filled
+  Bool                  m_bInitDone;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_VIEWWORKER_H__7A3E5C92_1D4B_4F86_9C20_B5E8F3D61A47__INCLUDED_)
@@ -13,9 +13,9 @@ CabaEncoder::CabaEncoder() :
   m_pcBitWriteBufferIf( NULL ),
   m_uiRange( 0 ),
   m_uiLow( 0 ),
-  m_uiByte( 0 ),
   m_uiBitsLeft( 0 ),
-  m_uiBitsToFollow( 0 ),
+  m_uiBufferedByte( 0 ),
+  m_uiNumBufferedBytes( 0 ),
   m_bTraceEnable(true)
 {
 }
@@ -25,32 +25,46 @@ CabaEncoder::~CabaEncoder()
 }
 
 
-__inline ErrVal CabaEncoder::xWriteBit( UInt uiBit)
+__inline ErrVal CabaEncoder::xWriteOut()
 {
-  m_uiByte += m_uiByte + uiBit;
-  if( ! --m_uiBitsLeft )
+  //===== the lead byte may carry into the bytes held back =====
+  UInt uiLeadByte = m_uiLow >> ( LOW_BITS + 1 - m_uiBitsLeft );
+  m_uiBitsLeft   += 8;
+  m_uiLow        &= 0xffffffff >> m_uiBitsLeft;
+
+  if( uiLeadByte == 0xff )
   {
-    const UInt uiByte = m_uiByte;
-    m_uiBitsLeft = 8;
-    m_uiByte     = 0;
-    return m_pcBitWriteBufferIf->write( uiByte, 8);
+    m_uiNumBufferedBytes++;
+    return Err::m_nOK;
+  }
+
+  if( m_uiNumBufferedBytes > 0 )
+  {
+    UInt uiCarry      = uiLeadByte >> 8;
+    UInt uiByte       = m_uiBufferedByte + uiCarry;
+    m_uiBufferedByte  = uiLeadByte & 0xff;
+    RNOK( m_pcBitWriteBufferIf->write( uiByte, 8 ) );
+
+    uiByte = ( 0xff + uiCarry ) & 0xff;
+    while( m_uiNumBufferedBytes > 1 )
+    {
+      RNOK( m_pcBitWriteBufferIf->write( uiByte, 8 ) );
+      m_uiNumBufferedBytes--;
+    }
+  }
+  else
+  {
+    m_uiNumBufferedBytes  = 1;
+    m_uiBufferedByte      = uiLeadByte;
   }
   return Err::m_nOK;
 }
 
 
-__inline ErrVal CabaEncoder::xWriteBitAndBitsToFollow( UInt uiBit)
+__inline ErrVal CabaEncoder::xTestAndWriteOut()
 {
-  RNOK( xWriteBit( uiBit ) );
-  // invert bit
-  uiBit = 1-uiBit;
-
-	while( m_uiBitsToFollow > 0)
-	{
-		m_uiBitsToFollow--;
-    RNOK( xWriteBit( uiBit ) );
-	}
-  return Err::m_nOK;
+  ROTRS( m_uiBitsLeft >= 12, Err::m_nOK );
+  return xWriteOut();
 }
 
 
@@ -68,9 +82,9 @@ ErrVal CabaEncoder::start()
 {
   m_uiRange = HALF-2;
   m_uiLow = 0;
-  m_uiBitsToFollow = 0;
-  m_uiByte = 0;
-  m_uiBitsLeft = 9;
+  m_uiBitsLeft = LOW_BITS;
+  m_uiBufferedByte = 0xff;
+  m_uiNumBufferedBytes = 0;
 
   RNOK( m_pcBitWriteBufferIf->writeAlignOne() );
   return Err::m_nOK;
@@ -156,17 +170,18 @@ ErrVal CabaEncoder::writeExGolombLevel( UInt uiSymbol, CabacContextModel& rcCCMo
 
 ErrVal CabaEncoder::writeEpExGolomb( UInt uiSymbol, UInt uiCount )
 {
+  //===== prefix of ones terminated by a zero, then uiCount bits of suffix =====
+  UInt uiPrefix     = 0;
+  UInt uiNumPrefix  = 0;
   while( uiSymbol >= (UInt)(1<<uiCount) )
   {
-    writeEPSymbol( 1 );
+    uiPrefix = ( uiPrefix << 1 ) + 1;
+    uiNumPrefix++;
     uiSymbol -= 1<<uiCount;
     uiCount  ++;
   }
-  writeEPSymbol( 0 );
-  while( uiCount-- )
-  {
-    writeEPSymbol( (uiSymbol>>uiCount) & 1 );
-  }
+  RNOK( writeEPSymbols( uiPrefix << 1, uiNumPrefix + 1 ) );
+  RNOK( writeEPSymbols( uiSymbol, uiCount ) );
 
   return Err::m_nOK;
 }
@@ -229,10 +244,35 @@ ErrVal CabaEncoder::writeUnarySymbol( UInt uiSymbol, CabacContextModel* pcCCMode
 
 ErrVal CabaEncoder::finish()
 {
-  RNOK( xWriteBitAndBitsToFollow( (m_uiLow >> (B_BITS-1)) & 1 ) );
-  RNOK( xWriteBit(                (m_uiLow >> (B_BITS-2)) & 1 ) );
+  //===== resolve the bytes held back, then output the bits down to the second bit of the coding interval =====
+  if( m_uiLow >> ( 32 - m_uiBitsLeft ) )
+  {
+    RNOK( m_pcBitWriteBufferIf->write( m_uiBufferedByte + 1, 8 ) );
+    while( m_uiNumBufferedBytes > 1 )
+    {
+      RNOK( m_pcBitWriteBufferIf->write( 0x00, 8 ) );
+      m_uiNumBufferedBytes--;
+    }
+    m_uiLow -= 1 << ( 32 - m_uiBitsLeft );
+  }
+  else
+  {
+    if( m_uiNumBufferedBytes > 0 )
+    {
+      RNOK( m_pcBitWriteBufferIf->write( m_uiBufferedByte, 8 ) );
+    }
+    while( m_uiNumBufferedBytes > 1 )
+    {
+      RNOK( m_pcBitWriteBufferIf->write( 0xff, 8 ) );
+      m_uiNumBufferedBytes--;
+    }
+  }
+  m_uiNumBufferedBytes = 0;
 
-  RNOK( m_pcBitWriteBufferIf->write( m_uiByte, 8 - m_uiBitsLeft ) );
+  if( LOW_BITS + 1 > m_uiBitsLeft )
+  {
+    RNOK( m_pcBitWriteBufferIf->write( m_uiLow >> ( B_BITS-2 ), LOW_BITS + 1 - m_uiBitsLeft ) );
+  }
 
   return Err::m_nOK;
 }
@@ -262,8 +302,11 @@ ErrVal CabaEncoder::writeSymbol( UInt uiSymbol, CabacContextModel& rcCCModel )
   uiRange -= uiLPS;
   if( uiSymbol != rcCCModel.getMps() )
   {
-    uiLow += uiRange;
-    uiRange = uiLPS;
+    //----- renormalize in one step -----
+    UInt uiNumBits = g_aucRenormTable32[uiLPS >> 3];
+    uiLow          = ( uiLow + uiRange ) << uiNumBits;
+    uiRange        = uiLPS << uiNumBits;
+    m_uiBitsLeft  -= uiNumBits;
 
     if( ! rcCCModel.getState() )
     {
@@ -274,32 +317,19 @@ ErrVal CabaEncoder::writeSymbol( UInt uiSymbol, CabacContextModel& rcCCModel )
   else
   {
     rcCCModel.setState( g_aucACNextStateMPS64[rcCCModel.getState()] );
-  }
 
-	while( uiRange < QUARTER )
-  {
-		if( uiLow >= HALF )
-    {
-      RNOK( xWriteBitAndBitsToFollow( 1 ) );
-      uiLow -= HALF;
-		}
-    else if( uiLow < QUARTER )
-    {
-      RNOK( xWriteBitAndBitsToFollow( 0 ) );
-    }
-    else
+    if( uiRange < QUARTER )
     {
-			m_uiBitsToFollow++;
-      uiLow -= QUARTER;
+      uiLow   <<= 1;
+      uiRange <<= 1;
+      m_uiBitsLeft--;
     }
-    uiLow   <<= 1;
-    uiRange <<= 1;
   }
 
   m_uiLow   = uiLow;
   m_uiRange = uiRange;
 
-  return Err::m_nOK;
+  return xTestAndWriteOut();
 }
 
 
@@ -312,31 +342,43 @@ ErrVal CabaEncoder::writeEPSymbol( UInt uiSymbol )
   ETRACE_V (uiSymbol);
   ETRACE_N;
 
-  UInt uiLow = m_uiLow<<1;
-
+  m_uiLow <<= 1;
   if( uiSymbol != 0 )
   {
-    uiLow += m_uiRange;
+    m_uiLow += m_uiRange;
   }
+  m_uiBitsLeft--;
+
+  return xTestAndWriteOut();
+}
 
-	if (uiLow >= ONE)
-	{
-    RNOK( xWriteBitAndBitsToFollow( 1 ) );
-    uiLow -= ONE;
-	}
-	else if (uiLow < HALF)
-	{
-    RNOK( xWriteBitAndBitsToFollow( 0 ) );
-	}
-	else
-	{
-		m_uiBitsToFollow++;
-		uiLow -= HALF;
-	}
-
-  m_uiLow = uiLow;
 
+ErrVal CabaEncoder::writeEPSymbols( UInt uiSymbols, UInt uiNumBins )
+{
+#if ENCODER_TRACE
+  //----- bin by bin, so that the trace lists every bin -----
+  while( uiNumBins-- )
+  {
+    RNOK( writeEPSymbol( ( uiSymbols >> uiNumBins ) & 1 ) );
+  }
   return Err::m_nOK;
+#else
+  //===== a byte of bins at a time: the range stays the same, so the bins scale it like a binary number =====
+  while( uiNumBins > 8 )
+  {
+    uiNumBins    -= 8;
+    UInt uiByte   = uiSymbols >> uiNumBins;
+    uiSymbols    -= uiByte << uiNumBins;
+    m_uiLow       = ( m_uiLow << 8 ) + m_uiRange * uiByte;
+    m_uiBitsLeft -= 8;
+    RNOK( xTestAndWriteOut() );
+  }
+
+  m_uiLow       = ( m_uiLow << uiNumBins ) + m_uiRange * uiSymbols;
+  m_uiBitsLeft -= uiNumBins;
+
+  return xTestAndWriteOut();
+#endif
 }
 
 
@@ -354,34 +396,22 @@ ErrVal CabaEncoder::writeTerminatingBit( UInt uiBit )
 
   if( uiBit )
   {
- 		uiLow += uiRange;
-    uiRange = 2;
+    //----- a range of 2 is renormalized by 7 shifts -----
+ 		uiLow         = ( uiLow + uiRange ) << 7;
+    uiRange       = 2 << 7;
+    m_uiBitsLeft -= 7;
   }
-
-	while( uiRange < QUARTER )
+  else if( uiRange < QUARTER )
   {
-		if( uiLow >= HALF )
-    {
-      RNOK( xWriteBitAndBitsToFollow( 1 ) );
-      uiLow -= HALF;
-		}
-    else if( uiLow < QUARTER )
-		{
-      RNOK( xWriteBitAndBitsToFollow( 0 ) );
-		}
-		else
-		{
-      m_uiBitsToFollow++;
-			uiLow -= QUARTER;
-		}
     uiLow   <<= 1;
     uiRange <<= 1;
+    m_uiBitsLeft--;
   }
 
   m_uiRange = uiRange;
 	m_uiLow   = uiLow;
 
-  return Err::m_nOK;
+  return xTestAndWriteOut();
 }
 
 
@@ -28,6 +28,8 @@ public:
   ErrVal uninit();
 
   ErrVal writeEPSymbol( UInt uiSymbol );
+  //===== writes the uiNumBins least significant bits of uiSymbols as bypass bins, most significant first =====
+  ErrVal writeEPSymbols( UInt uiSymbols, UInt uiNumBins );
   ErrVal writeSymbol( UInt uiSymbol, CabacContextModel& rcCCModel );
   ErrVal writeUnaryMaxSymbol( UInt uiSymbol, CabacContextModel* pcCCModel, Int iOffset, UInt uiMaxSymbol );
   ErrVal writeUnarySymbol( UInt uiSymbol, CabacContextModel* pcCCModel, Int iOffset );
@@ -38,20 +40,24 @@ public:
 
   ErrVal writeTerminatingBit( UInt uiBit );
   ErrVal finish();
-  UInt   getWrittenBits()  { return m_pcBitWriteBufferIf->getNumberOfWrittenBits() + 8 + m_uiBitsToFollow - m_uiBitsLeft + 1; } //JVT-P031
+  UInt   getWrittenBits()  { return m_pcBitWriteBufferIf->getNumberOfWrittenBits() + 8 * m_uiNumBufferedBytes + LOW_BITS - m_uiBitsLeft; } //JVT-P031
 
 private:
-  __inline ErrVal xWriteBit( UInt uiBit);
-  __inline ErrVal xWriteBitAndBitsToFollow( UInt uiBit);
+  __inline ErrVal xTestAndWriteOut();
+  __inline ErrVal xWriteOut();
 
 protected:
+  //===== the low register collects the renormalization shifts, m_uiBitsLeft counts down from LOW_BITS; when it is below  =====
+  //===== 12 a byte is taken out, bytes of 0xff are held back until it is known whether a carry reaches them            =====
+  enum { LOW_BITS = 23 };
+
   BitWriteBufferIf* m_pcBitWriteBufferIf;
 
   UInt m_uiRange;
   UInt m_uiLow;
-  UInt m_uiByte;
   UInt m_uiBitsLeft;
-  UInt m_uiBitsToFollow;
+  UInt m_uiBufferedByte;
+  UInt m_uiNumBufferedBytes;
   Bool m_bTraceEnable;
 };
 
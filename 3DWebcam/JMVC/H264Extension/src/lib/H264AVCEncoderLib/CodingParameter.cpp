@@ -21,6 +21,9 @@ ErrVal MotionVectorSearchParams::check() const
   ROTREPORT( 3 == m_eFullPelDFunc && (m_eSearchMode==2 || m_eSearchMode==3), "Log and Fast search not possible in comb. with distortion measure 3" )
   ROTREPORT( 2 < m_eSubPelDFunc,  "No Such Search Func (Sub Pel) 0==SAD,1==SSE,2==Hadamard" )
   ROTREPORT( 1 < m_uiDirectMode,  "Direct Mode Exceeds Supported Range 0==Temporal, 1==Spatial");
+  ROTREPORT( m_uiDisparitySearchRows > m_uiSearchRange, "Disparity search band exceeds the search range" );
+  ROTREPORT( 2 < m_uiPyramidSearch,  "Pyramid Search Exceeds Supported Range 0==Off, 1==Seeds, 2==Seeds+Statistics" );
+  ROTREPORT( m_uiPyramidSearch && ( m_uiPyramidSearchRange < 4 || m_uiPyramidSearchRange > 256 ), "Pyramid search range must be within 4 and 256" );
 
   return Err::m_nOK;
 }
@@ -270,6 +273,14 @@ ErrVal CodingParameter::check()
   ROTREPORT( getMaximumDelay    ()  < 0.0,              "Maximum delay must be greater than or equal to 0" );
   ROTREPORT( getTotalFrames     () == 0,                "Total Number Of Frames must be greater than 0" );
 
+  ROTREPORT( getLowDelay        ()  > 1,                "Low delay mode not supported" );
+  if( getLowDelay() )
+  {
+    //===== every picture is coded when it arrives and only references pictures that precede it =====
+    setGOPSize      ( 1 );
+    setMaximumDelay ( 0.0 );
+  }
+
   ROTREPORT( getGOPSize         ()  < 1  ||
              getGOPSize         ()  > 64,               "GOP Size not supported" );
   UInt uiDecStages = getLogFactor( 1.0, getGOPSize() );
@@ -294,6 +305,19 @@ ErrVal CodingParameter::check()
 
   ROTREPORT( getNumRefFrames    ()  < 1  ||
              getNumRefFrames    ()  > 15,               "Number of reference frames not supported" );
+  ROTREPORT( getSliceMode       ()  > 1,                "Slice mode not supported" );
+  ROTREPORT( getSliceMode       () == 1 &&
+             getSliceArgument   () == 0,                "Slice argument must be greater than 0" );
+  ROTREPORT( getRateControl     ()  > 2,                "Rate control mode not supported" );
+  ROTREPORT( getRateControl     ()  &&
+             getBitrate         () <= 0,                "Rate control requires a bit rate" );
+  ROTREPORT( getRateControl     () == 2 &&
+             getMaxBitrate      ()  > 0 &&
+             getMaxBitrate      ()  < getBitrate(),     "Maximum bit rate must not be below the bit rate" );
+  ROTREPORT( getBaseViewBitrateShare() < 1 ||
+             getBaseViewBitrateShare() > 99,            "Base view bit rate share must be between 1 and 99 percent" );
+  ROTREPORT( getFastModeDecision() > 2,                 "Fast mode decision level not supported" );
+  ROTREPORT( getPicBufferHugePages() > 1,               "PicBufferHugePages must be 0 or 1" );
 
     return Err::m_nOK;
   }
@@ -104,6 +104,7 @@ public:
   ErrVal initMbForFiltering   ( MbDataAccess*& rpcMbDataAccess, UInt uiMbY, UInt uiMbX, Bool bMbAFF );
   ErrVal initMbForFiltering   ( UInt uiMbY, UInt uiMbX, Bool bMbAFF ){ return Err::m_nERR; };
   ErrVal initMbForDecoding    (MbDataAccess*& rpcMbDataAccess,UInt uiMbY, UInt uiMbX, Bool bMbAFF  ){ return Err::m_nERR; }
+  ErrVal initMbForReconstruction( MbDataAccess& rcMbDataAccess, UInt uiMbY, UInt uiMbX ) { return Err::m_nERR; }
 
 
   UvlcWriter*  getUvlcWriter()  { return m_pcUvlcWriter;  };
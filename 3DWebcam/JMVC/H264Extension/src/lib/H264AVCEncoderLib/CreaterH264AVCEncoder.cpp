@@ -29,6 +29,9 @@
 #include "H264AVCCommonLib/TraceFile.h"
 #include "PicEncoder.h"
 #include "Multiview.h"
+#include "MbAnalysisLane.h"
+#include "SliceWorker.h"
+#include "NalUnitPool.h"
 
 
 
@@ -58,11 +61,16 @@ CreaterH264AVCEncoder::CreaterH264AVCEncoder():
   m_pcRateDistortion      ( NULL ),
   m_pcHistory             ( NULL ),
   m_pcPicEncoder          ( NULL ),
+  m_uiNumMbAnalysisLanes  ( 0 ),
+  m_uiNumSliceWorkers     ( 0 ),
+  m_pcNalUnitPool         ( NULL ),
   m_bTraceEnable          ( true )
 {
   ::memset( m_apcYuvFullPelBufferCtrl, 0x00, MAX_LAYERS*sizeof(Void*) );
   ::memset( m_apcYuvHalfPelBufferCtrl, 0x00, MAX_LAYERS*sizeof(Void*) );
   ::memset( m_apcPocCalculator,        0x00, MAX_LAYERS*sizeof(Void*) );
+  ::memset( m_apcMbAnalysisLane,       0x00, MAX_WAVEFRONT_LANES*sizeof(Void*) );
+  ::memset( m_apcSliceWorker,          0x00, MAX_WAVEFRONT_LANES*sizeof(Void*) );
   m_pcReconstructionBypass = NULL;
 }
 
@@ -184,6 +192,24 @@ CreaterH264AVCEncoder::process( ExtBinDataAccessorList&  rcExtBinDataAccessorLis
 }
 
 
+// ends the sequence after uiNumFrames input pictures, which may be fewer than
+// FramesToBeEncoded; the pictures still waiting for their GOP are encoded
+ErrVal
+CreaterH264AVCEncoder::flush ( ExtBinDataAccessorList&  rcExtBinDataAccessorList, 
+                               PicBufferList*           apcPicBufferOutputList,
+                               PicBufferList*           apcPicBufferUnusedList,
+                               UInt                     uiNumFrames )
+{
+  ROF( m_pcCodingParameter->getMVCmode() );
+
+  RNOK( m_pcPicEncoder->flush( uiNumFrames,
+                              *apcPicBufferOutputList,
+                              *apcPicBufferUnusedList,
+                               rcExtBinDataAccessorList ) );
+  return Err::m_nOK;
+}
+
+
 ErrVal
 CreaterH264AVCEncoder::finish ( ExtBinDataAccessorList&  rcExtBinDataAccessorList, 
                                 PicBufferList*           apcPicBufferOutputList,
@@ -207,6 +233,21 @@ CreaterH264AVCEncoder::finish ( ExtBinDataAccessorList&  rcExtBinDataAccessorLis
 }
 
 
+ErrVal
+CreaterH264AVCEncoder::releaseNalUnit( ExtBinDataAccessor* pcNalUnit )
+{
+  RNOK( m_pcNalUnitPool->releaseNalUnit( pcNalUnit ) );
+  return Err::m_nOK;
+}
+
+
+UInt
+CreaterH264AVCEncoder::getMaxFramesInDPB() const
+{
+  return m_pcPicEncoder->getMaxFramesInDPB();
+}
+
+
 ErrVal
 CreaterH264AVCEncoder::create( CreaterH264AVCEncoder*& rpcCreaterH264AVCEncoder )
 {
@@ -244,6 +285,7 @@ CreaterH264AVCEncoder::xCreateEncoder()
   RNOK( SampleWeighting             ::create( m_pcSampleWeighting ) );
   RNOK( XDistortion                 ::create( m_pcXDistortion ) );
   RNOK( PicEncoder                  ::create( m_pcPicEncoder ) );
+  RNOK( NalUnitPool                 ::create( m_pcNalUnitPool ) );
 
   for( UInt uiLayer = 0; uiLayer < MAX_LAYERS; uiLayer++ )
   {
@@ -281,12 +323,25 @@ CreaterH264AVCEncoder::destroy()
   RNOK( m_pcControlMng            ->destroy() );
   RNOK( m_pcReconstructionBypass  ->destroy() );
   RNOK( m_pcPicEncoder            ->destroy() );
+  RNOK( m_pcNalUnitPool           ->destroy() );
 
   if( NULL != m_pcRateDistortion )
   {
     RNOK( m_pcRateDistortion      ->destroy() );
   }
 
+  for( UInt uiLane = 0; uiLane < MAX_WAVEFRONT_LANES; uiLane++ )
+  {
+    if( NULL != m_apcMbAnalysisLane[uiLane] )
+    {
+      RNOK( m_apcMbAnalysisLane[uiLane]->destroy() );
+    }
+    if( NULL != m_apcSliceWorker[uiLane] )
+    {
+      RNOK( m_apcSliceWorker[uiLane]->destroy() );
+    }
+  }
+
   for( UInt uiLayer = 0; uiLayer < MAX_LAYERS; uiLayer++ )
   {
     RNOK( m_apcYuvFullPelBufferCtrl [uiLayer] ->destroy() );
@@ -301,7 +356,8 @@ CreaterH264AVCEncoder::destroy()
 
 
 ErrVal
-CreaterH264AVCEncoder::init( CodingParameter* pcCodingParameter )
+CreaterH264AVCEncoder::init( CodingParameter*          pcCodingParameter,
+                             MultiviewReferenceStore*  pcMultiviewReferenceStore )
 {
   INIT_ETRACE(1, pcCodingParameter->SpsMVC.getNumViewMinus1()+1);
   OPEN_ETRACE(pcCodingParameter->getCurentViewId());
@@ -313,7 +369,7 @@ CreaterH264AVCEncoder::init( CodingParameter* pcCodingParameter )
 
   RNOK( m_pcBitWriteBuffer          ->init() );
   RNOK( m_pcBitCounter              ->init() );
-  RNOK( m_pcXDistortion             ->init() );
+  RNOK( m_pcXDistortion             ->init( pcCodingParameter->getSIMD(), pcCodingParameter->getSIMDSelfCheck() != 0 ) );
   RNOK( m_pcSampleWeighting         ->init() );
   RNOK( m_pcNalUnitEncoder          ->init( m_pcBitWriteBuffer,
                                             m_pcUvlcWriter,
@@ -326,16 +382,59 @@ CreaterH264AVCEncoder::init( CodingParameter* pcCodingParameter )
                                             m_apcYuvHalfPelBufferCtrl[0],
                                             m_pcQuarterPelFilter ) );
 
+  //===== analysis lanes of the macroblock wavefront (the lanes are created once, their tools on init) =====
+  m_uiNumMbAnalysisLanes = min( pcCodingParameter->getWavefrontThreads(), (UInt)MAX_WAVEFRONT_LANES );
+  if( m_uiNumMbAnalysisLanes > 1 )
+  {
+    for( UInt uiLane = 0; uiLane < m_uiNumMbAnalysisLanes; uiLane++ )
+    {
+      if( NULL == m_apcMbAnalysisLane[uiLane] )
+      {
+        RNOK( MbAnalysisLane::create( m_apcMbAnalysisLane[uiLane] ) );
+      }
+      RNOK( m_apcMbAnalysisLane[uiLane]->init( m_pcCodingParameter,
+                                               m_pcQuarterPelFilter,
+                                               m_apcYuvFullPelBufferCtrl[0],
+                                               m_apcYuvHalfPelBufferCtrl[0] ) );
+    }
+  }
+
+  //===== workers of the slice-parallel mode =====
+  m_uiNumSliceWorkers = min( pcCodingParameter->getSliceThreads(), (UInt)MAX_WAVEFRONT_LANES );
+  if( m_uiNumSliceWorkers > 1 )
+  {
+    for( UInt uiWorker = 0; uiWorker < m_uiNumSliceWorkers; uiWorker++ )
+    {
+      if( NULL == m_apcSliceWorker[uiWorker] )
+      {
+        RNOK( SliceWorker::create( m_apcSliceWorker[uiWorker] ) );
+      }
+      RNOK( m_apcSliceWorker[uiWorker]->init( m_pcCodingParameter,
+                                              m_pcQuarterPelFilter,
+                                              m_apcYuvFullPelBufferCtrl[0],
+                                              m_apcYuvHalfPelBufferCtrl[0],
+                                              m_pcNalUnitPool ) );
+    }
+  }
+
   RNOK( m_pcSliceEncoder            ->init( m_pcMbEncoder,
                                             m_pcMbCoder,
                                             m_pcControlMng,
                                             m_pcCodingParameter,
                                             m_apcPocCalculator[0],
-                                            m_pcTransform ) );
+                                            m_pcTransform,
+                                            m_uiNumMbAnalysisLanes > 1 ? m_uiNumMbAnalysisLanes : 0,
+                                            m_apcMbAnalysisLane,
+                                            m_uiNumSliceWorkers > 1 ? m_uiNumSliceWorkers : 0,
+                                            m_apcSliceWorker,
+                                            m_pcNalUnitPool ) );
   RNOK( m_pcReconstructionBypass    ->init() );
   RNOK( m_pcLoopFilter              ->init( m_pcControlMng,
-                                            m_pcReconstructionBypass ) );
-  RNOK( m_pcQuarterPelFilter        ->init() );
+                                            m_pcReconstructionBypass,
+                                            pcCodingParameter->getSIMD(),
+                                            pcCodingParameter->getSIMDSelfCheck() != 0 ) );
+  RNOK( m_pcQuarterPelFilter        ->init( pcCodingParameter->getSIMD(), pcCodingParameter->getSIMDSelfCheck() != 0 ) );
+  RNOK( m_pcTransform               ->init( pcCodingParameter->getSIMD(), pcCodingParameter->getSIMDSelfCheck() != 0 ) );
 
   RNOK( m_pcMbEncoder               ->init( m_pcTransform,
                                             m_pcIntraPrediction,
@@ -384,11 +483,23 @@ CreaterH264AVCEncoder::init( CodingParameter* pcCodingParameter )
                                             m_apcYuvFullPelBufferCtrl  [0],
                                             m_apcYuvHalfPelBufferCtrl  [0],
                                             m_pcQuarterPelFilter,
-                                            m_pcMotionEstimation) );
+                                            m_pcMotionEstimation,
+                                            m_pcNalUnitPool ) );
   
-  m_pcPicEncoder->m_MultiviewRefPicManager.
-    AddVectorOfFilesToUseAsReference
-    (m_pcCodingParameter->m_MultiviewReferenceFileParams);
+  //===== inter-view references from the reconstructed files or, when all views are encoded in this process, from the store =====
+  if( pcMultiviewReferenceStore )
+  {
+    m_pcPicEncoder->setMultiviewReferenceStore( pcMultiviewReferenceStore );
+    m_pcPicEncoder->m_MultiviewRefPicManager.
+      AddVectorOfViewsToUseAsReference
+      (m_pcCodingParameter->m_MultiviewReferenceFileParams, pcMultiviewReferenceStore);
+  }
+  else
+  {
+    m_pcPicEncoder->m_MultiviewRefPicManager.
+      AddVectorOfFilesToUseAsReference
+      (m_pcCodingParameter->m_MultiviewReferenceFileParams);
+  }
 
   RNOK( m_pcH264AVCEncoder          ->init( 
                                             m_pcParameterSetMng,
@@ -407,6 +518,7 @@ ErrVal
 CreaterH264AVCEncoder::uninit()
 {
   RNOK( m_pcQuarterPelFilter      ->uninit() );
+  RNOK( m_pcTransform             ->uninit() );
   RNOK( m_pcSampleWeighting       ->uninit() );
   RNOK( m_pcFrameMng              ->uninit() );
   RNOK( m_pcParameterSetMng       ->uninit() );
@@ -429,6 +541,24 @@ CreaterH264AVCEncoder::uninit()
   RNOK( m_pcReconstructionBypass  ->uninit() );
   RNOK( m_pcPicEncoder            ->uninit() );
 
+  if( m_uiNumMbAnalysisLanes > 1 )
+  {
+    for( UInt uiLane = 0; uiLane < m_uiNumMbAnalysisLanes; uiLane++ )
+    {
+      RNOK( m_apcMbAnalysisLane[uiLane]->uninit() );
+    }
+  }
+  m_uiNumMbAnalysisLanes = 0;
+
+  if( m_uiNumSliceWorkers > 1 )
+  {
+    for( UInt uiWorker = 0; uiWorker < m_uiNumSliceWorkers; uiWorker++ )
+    {
+      RNOK( m_apcSliceWorker[uiWorker]->uninit() );
+    }
+  }
+  m_uiNumSliceWorkers = 0;
+
   for( UInt uiLayer = 0; uiLayer < m_pcCodingParameter->getNumberOfLayers(); uiLayer++ )
   {
     RNOK( m_apcYuvFullPelBufferCtrl[uiLayer] ->uninit() );
@@ -4,6 +4,7 @@
 #include "H264AVCCommonLib/IntYuvPicBuffer.h"
 
 #include <math.h>
+#include <string.h>
 
 #define Abs(x) abs(x)
 
@@ -11,6 +12,7 @@ H264AVC_NAMESPACE_BEGIN
 
 
 XDistortion::XDistortion()
+: m_bSelfCheck( false )
 {
 
 }
@@ -44,7 +46,7 @@ Void XDistortion::loadOrgMbPelData( IntYuvPicBuffer* pcOrgYuvBuffer, IntYuvMbBuf
 }
 
 
-ErrVal XDistortion::init()
+ErrVal XDistortion::init( UInt uiSIMDFlags, Bool bSelfCheck )
 {
   m_aiRows[0x0] =  0;
   m_aiRows[0x1] = 16;
@@ -178,11 +180,44 @@ ErrVal XDistortion::init()
   m_aaafpDistortionFunc[1][3][10] = XDistortion::xGetBiYuvSAD4x;
   m_aaafpDistortionFunc[1][3][11] = XDistortion::xGetBiYuvSAD4x;
 
+  //===== replace the scalar kernels by the fastest ones the processor supports =====
+  ::memcpy( m_aaafpScalarFunc, m_aaafpDistortionFunc, sizeof( m_aaafpScalarFunc ) );
+  xInitSIMDFunctions( uiSIMDFlags & CpuInfo::getSIMDFlags() );
+  ::memcpy( m_aaafpSIMDFunc, m_aaafpDistortionFunc, sizeof( m_aaafpSIMDFunc ) );
+
+  m_bSelfCheck = bSelfCheck;
+  if( m_bSelfCheck )
+  {
+    for( UInt uiBi = 0; uiBi < 2; uiBi++ )
+    for( UInt uiDF = 0; uiDF < 4; uiDF++ )
+    for( UInt uiBM = 0; uiBM < 12; uiBM++ )
+    {
+      if( m_aaafpSIMDFunc[uiBi][uiDF][uiBM] != m_aaafpScalarFunc[uiBi][uiDF][uiBM] )
+      {
+        m_aaafpDistortionFunc[uiBi][uiDF][uiBM] = XDistortion::xSelfCheck;
+      }
+    }
+  }
+
   return Err::m_nOK;
 }
 
 
 
+UInt XDistortion::xSelfCheck( XDistSearchStruct* pcDSS )
+{
+  UInt uiSIMD   = pcDSS->SIMDFunc  ( pcDSS );
+  UInt uiScalar = pcDSS->ScalarFunc( pcDSS );
+
+  if( uiSIMD != uiScalar )
+  {
+    CpuInfo::reportMismatch( "XDistortion" );
+  }
+  return uiScalar;
+}
+
+
+
 UInt XDistortion::get8x8Cb( XPel *pPel, Int iStride, DFunc eDFunc )
 {
   XDistSearchStruct cDSS;
@@ -8,6 +8,7 @@
 #include "DistortionIf.h"
 #include "H264AVCCommonLib/YuvMbBuffer.h"
 #include "H264AVCCommonLib/IntYuvMbBuffer.h"
+#include "H264AVCCommonLib/CpuInfo.h"
 
 
 #define Abs(x) abs(x)
@@ -35,7 +36,7 @@ public:
   static  ErrVal  create ( XDistortion*& rpcDistortion );
   virtual ErrVal  destroy();
 
-  virtual ErrVal  init   ();
+  virtual ErrVal  init   ( UInt uiSIMDFlags = SIMD_ALL, Bool bSelfCheck = false );
   virtual ErrVal  uninit () { return Err::m_nOK; }
 
 
@@ -59,6 +60,11 @@ public:
   Void getDistStruct( UInt uiBlkMode, DFunc eDFunc, Bool bBiDirectional, XDistSearchStruct& rDistSearchStruct )
   {
     rDistSearchStruct.Func    = m_aaafpDistortionFunc[(bBiDirectional?1:0)][eDFunc][uiBlkMode];
+    if( m_bSelfCheck )
+    {
+      rDistSearchStruct.SIMDFunc    = m_aaafpSIMDFunc  [(bBiDirectional?1:0)][eDFunc][uiBlkMode];
+      rDistSearchStruct.ScalarFunc  = m_aaafpScalarFunc[(bBiDirectional?1:0)][eDFunc][uiBlkMode];
+    }
     rDistSearchStruct.iRows   = m_aiRows[uiBlkMode];
     rDistSearchStruct.pYOrg   = m_cOrgData.getLumBlk();
     rDistSearchStruct.pUOrg   = m_cOrgData.getCbBlk ();
@@ -116,6 +122,50 @@ private:
   static UInt xCalcHadamard4x4    ( XPel *pucOrg, XPel *pPel,                Int iStride );
   static UInt xCalcBiHadamard4x4  ( XPel *pucOrg, XPel *pPelFix, XPel *pPel, Int iStride );
 
+  static UInt xSelfCheck          ( XDistSearchStruct* pcDSS );
+
+  Void        xInitSIMDFunctions  ( UInt uiSIMDFlags );
+
+#if defined( H264AVC_X86_SIMD )
+  //===== DistortionSIMD.cpp, bit-exact with the scalar kernels for 8 bit samples =====
+  static UInt xGetSAD16xSSE2      ( XDistSearchStruct* pcDSS );
+  static UInt xGetSAD8xSSE2       ( XDistSearchStruct* pcDSS );
+  static UInt xGetSAD4xSSE2       ( XDistSearchStruct* pcDSS );
+  static UInt xGetSSE16xSSE2      ( XDistSearchStruct* pcDSS );
+  static UInt xGetSSE8xSSE2       ( XDistSearchStruct* pcDSS );
+  static UInt xGetSSE4xSSE2       ( XDistSearchStruct* pcDSS );
+  static UInt xGetYuvSAD16xSSE2   ( XDistSearchStruct* pcDSS );
+  static UInt xGetYuvSAD8xSSE2    ( XDistSearchStruct* pcDSS );
+  static UInt xGetYuvSAD4xSSE2    ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSAD16xSSE2    ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSAD8xSSE2     ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSAD4xSSE2     ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSSE16xSSE2    ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSSE8xSSE2     ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSSE4xSSE2     ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiYuvSAD16xSSE2 ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiYuvSAD8xSSE2  ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiYuvSAD4xSSE2  ( XDistSearchStruct* pcDSS );
+
+  static UInt xGetHAD16xSSSE3     ( XDistSearchStruct* pcDSS );
+  static UInt xGetHAD8xSSSE3      ( XDistSearchStruct* pcDSS );
+  static UInt xGetHAD4xSSSE3      ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiHAD16xSSSE3   ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiHAD8xSSSE3    ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiHAD4xSSSE3    ( XDistSearchStruct* pcDSS );
+
+#if defined( H264AVC_X86_AVX2 )
+  static UInt xGetSAD16xAVX2      ( XDistSearchStruct* pcDSS );
+  static UInt xGetSSE16xAVX2      ( XDistSearchStruct* pcDSS );
+  static UInt xGetYuvSAD16xAVX2   ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSAD16xAVX2    ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiSSE16xAVX2    ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiYuvSAD16xAVX2 ( XDistSearchStruct* pcDSS );
+  static UInt xGetHAD16xAVX2      ( XDistSearchStruct* pcDSS );
+  static UInt xGetBiHAD16xAVX2    ( XDistSearchStruct* pcDSS );
+#endif
+#endif
+
 //TMM_WP
   Void xGetWeight(XPel *pucRef, XPel *pucOrg, const UInt uiStride,
                   const UInt uiHeight, const UInt uiWidth, 
@@ -125,6 +175,9 @@ private:
 protected:
   IntYuvMbBuffer  m_cOrgData;
   XDistortionFunc m_aaafpDistortionFunc[2][4][12];
+  XDistortionFunc m_aaafpSIMDFunc[2][4][12];
+  XDistortionFunc m_aaafpScalarFunc[2][4][12];
+  Bool            m_bSelfCheck;
   Int             m_aiRows[12];
   Int             m_aiCols[12];
 };
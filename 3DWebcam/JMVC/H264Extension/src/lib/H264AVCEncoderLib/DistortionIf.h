@@ -34,6 +34,8 @@ public:
   Int             iCStride;
   Int             iRows;
   XDistortionFunc Func;
+  XDistortionFunc SIMDFunc;   // only set in self check mode
+  XDistortionFunc ScalarFunc; // only set in self check mode
 
 };
 
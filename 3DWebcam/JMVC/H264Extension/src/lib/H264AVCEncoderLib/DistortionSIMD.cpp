@@ -0,0 +1,500 @@
+#include "H264AVCEncoderLib.h"
+#include "Distortion.h"
+
+#if defined( H264AVC_X86_SIMD )
+#include <emmintrin.h>
+#include <tmmintrin.h>
+#endif
+#if defined( H264AVC_X86_AVX2 )
+#include <immintrin.h>
+#endif
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+// The SIMD kernels work on 16 bit lanes. They give the same results as the
+// scalar kernels in Distortion.cpp as long as the samples are 8 bit values,
+// which holds for all original and reconstructed pictures of the encoder.
+// The predictions of bi-directional blocks are rounded with pavgw, i.e.
+// ( a + b + 1 ) >> 1 like the scalar kernels do.
+//
+// The Hadamard kernels sum up the absolute coefficients of several 4x4
+// blocks before dividing by two. All 16 coefficients of a 4x4 block have the
+// same parity, so the sum of one block is even and the result is the same as
+// summing up the halved sums of the single blocks.
+
+
+static Void xSetKernels( XDistortionFunc* pafpFunc, XDistortionFunc pf16x, XDistortionFunc pf8x, XDistortionFunc pf4x )
+{
+  if( pf16x )
+  {
+    pafpFunc[0x1] = pf16x;
+    pafpFunc[0x2] = pf16x;
+  }
+  if( pf8x )
+  {
+    pafpFunc[0x3] = pf8x;
+    pafpFunc[0x4] = pf8x;
+    pafpFunc[0x8] = pf8x;
+    pafpFunc[0x9] = pf8x;
+  }
+  if( pf4x )
+  {
+    pafpFunc[0xa] = pf4x;
+    pafpFunc[0xb] = pf4x;
+  }
+}
+
+
+Void XDistortion::xInitSIMDFunctions( UInt uiSIMDFlags )
+{
+#if defined( H264AVC_X86_SIMD )
+  if( uiSIMDFlags & SIMD_SSE2 )
+  {
+    xSetKernels( m_aaafpDistortionFunc[0][DF_SAD    ], xGetSAD16xSSE2,      xGetSAD8xSSE2,      xGetSAD4xSSE2      );
+    xSetKernels( m_aaafpDistortionFunc[0][DF_SSD    ], xGetSSE16xSSE2,      xGetSSE8xSSE2,      xGetSSE4xSSE2      );
+    xSetKernels( m_aaafpDistortionFunc[0][DF_YUV_SAD], xGetYuvSAD16xSSE2,   xGetYuvSAD8xSSE2,   xGetYuvSAD4xSSE2   );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_SAD    ], xGetBiSAD16xSSE2,    xGetBiSAD8xSSE2,    xGetBiSAD4xSSE2    );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_SSD    ], xGetBiSSE16xSSE2,    xGetBiSSE8xSSE2,    xGetBiSSE4xSSE2    );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_YUV_SAD], xGetBiYuvSAD16xSSE2, xGetBiYuvSAD8xSSE2, xGetBiYuvSAD4xSSE2 );
+  }
+  if( uiSIMDFlags & SIMD_SSSE3 )
+  {
+    xSetKernels( m_aaafpDistortionFunc[0][DF_HADAMARD], xGetHAD16xSSSE3,    xGetHAD8xSSSE3,     xGetHAD4xSSSE3     );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_HADAMARD], xGetBiHAD16xSSSE3,  xGetBiHAD8xSSSE3,   xGetBiHAD4xSSSE3   );
+  }
+#if defined( H264AVC_X86_AVX2 )
+  if( uiSIMDFlags & SIMD_AVX2 )
+  {
+    xSetKernels( m_aaafpDistortionFunc[0][DF_SAD     ], xGetSAD16xAVX2,      NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[0][DF_SSD     ], xGetSSE16xAVX2,      NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[0][DF_YUV_SAD ], xGetYuvSAD16xAVX2,   NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[0][DF_HADAMARD], xGetHAD16xAVX2,      NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_SAD     ], xGetBiSAD16xAVX2,    NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_SSD     ], xGetBiSSE16xAVX2,    NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_YUV_SAD ], xGetBiYuvSAD16xAVX2, NULL, NULL );
+    xSetKernels( m_aaafpDistortionFunc[1][DF_HADAMARD], xGetBiHAD16xAVX2,    NULL, NULL );
+  }
+#endif
+#endif
+}
+
+
+
+#if defined( H264AVC_X86_SIMD )
+
+//====================================================================================
+//  SSE2
+//====================================================================================
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad8( const XPel* pPel )
+{
+  return _mm_loadu_si128( (const __m128i*)pPel );
+}
+
+SIMD_TARGET( "sse2" )
+static inline __m128i xLoad4x2( const XPel* pPel0, const XPel* pPel1 )
+{
+  return _mm_unpacklo_epi64( _mm_loadl_epi64( (const __m128i*)pPel0 ), _mm_loadl_epi64( (const __m128i*)pPel1 ) );
+}
+
+SIMD_TARGET( "sse2" )
+static inline UInt xHorSum( __m128i cSum )
+{
+  cSum = _mm_add_epi32( cSum, _mm_shuffle_epi32( cSum, 0x4e ) );
+  cSum = _mm_add_epi32( cSum, _mm_shuffle_epi32( cSum, 0xb1 ) );
+  return (UInt)_mm_cvtsi128_si32( cSum );
+}
+
+//----- the fixed prediction is only set for bi-directional blocks, the others get a valid pointer with the same stride -----
+template< Bool bBi >
+static inline const XPel* xGetYFix( XDistSearchStruct* pcDSS )
+{
+  return ( bBi ? pcDSS->pYFix : pcDSS->pYOrg );
+}
+
+//----- sums of |org - pred| or ( org - pred )^2 as 32 bit lanes -----
+template< Bool bSSE >
+SIMD_TARGET( "sse2" )
+static inline __m128i xDist( __m128i cOrg, __m128i cPred )
+{
+  __m128i cDiff = _mm_sub_epi16( cOrg, cPred );
+  if( bSSE )
+  {
+    return _mm_madd_epi16( cDiff, cDiff );
+  }
+  cDiff = _mm_max_epi16( cDiff, _mm_sub_epi16( _mm_setzero_si128(), cDiff ) );
+  return _mm_madd_epi16( cDiff, _mm_set1_epi16( 1 ) );
+}
+
+//----- distortion of an iWidth x iRows block, the original and the fixed prediction have a stride of MB_BUFFER_WIDTH -----
+template< Bool bBi, Bool bSSE >
+SIMD_TARGET( "sse2" )
+static inline UInt xGetDistSSE2( const XPel* pOrg, const XPel* pFix, const XPel* pCur, Int iStride, Int iWidth, Int iRows )
+{
+  if( iWidth < 4 )
+  {
+    UInt uiSum = 0;
+    for( ; iRows != 0; iRows-- )
+    {
+      for( Int x = 0; x < iWidth; x++ )
+      {
+        Int iPred = ( bBi ? ( ( pCur[x] + pFix[x] + 1 ) >> 1 ) : pCur[x] );
+        Int iDiff = pOrg[x] - iPred;
+        uiSum    += ( bSSE ? iDiff * iDiff : Abs( iDiff ) );
+      }
+      pOrg += MB_BUFFER_WIDTH;
+      pCur += iStride;
+      if( bBi )
+      {
+        pFix += MB_BUFFER_WIDTH;
+      }
+    }
+    return uiSum;
+  }
+
+  __m128i cSum = _mm_setzero_si128();
+
+  if( iWidth == 4 )
+  {
+    for( ; iRows > 0; iRows -= 2 )
+    {
+      __m128i cPred = xLoad4x2( pCur, pCur + iStride );
+      if( bBi )
+      {
+        cPred = _mm_avg_epu16( cPred, xLoad4x2( pFix, pFix + MB_BUFFER_WIDTH ) );
+        pFix += 2 * MB_BUFFER_WIDTH;
+      }
+      cSum  = _mm_add_epi32( cSum, xDist<bSSE>( xLoad4x2( pOrg, pOrg + MB_BUFFER_WIDTH ), cPred ) );
+      pOrg += 2 * MB_BUFFER_WIDTH;
+      pCur += 2 * iStride;
+    }
+    return xHorSum( cSum );
+  }
+
+  for( ; iRows != 0; iRows-- )
+  {
+    for( Int x = 0; x < iWidth; x += 8 )
+    {
+      __m128i cPred = xLoad8( pCur + x );
+      if( bBi )
+      {
+        cPred = _mm_avg_epu16( cPred, xLoad8( pFix + x ) );
+      }
+      cSum = _mm_add_epi32( cSum, xDist<bSSE>( xLoad8( pOrg + x ), cPred ) );
+    }
+    pOrg += MB_BUFFER_WIDTH;
+    pCur += iStride;
+    if( bBi )
+    {
+      pFix += MB_BUFFER_WIDTH;
+    }
+  }
+  return xHorSum( cSum );
+}
+
+template< Bool bBi >
+SIMD_TARGET( "sse2" )
+static inline UInt xGetChromaSADSSE2( XDistSearchStruct* pcDSS, Int iWidth )
+{
+  Int iRows = pcDSS->iRows / 2;
+  return xGetDistSSE2<bBi,false>( pcDSS->pUOrg, ( bBi ? pcDSS->pUFix : pcDSS->pUOrg ), pcDSS->pUSearch, pcDSS->iCStride, iWidth, iRows )
+       + xGetDistSSE2<bBi,false>( pcDSS->pVOrg, ( bBi ? pcDSS->pVFix : pcDSS->pVOrg ), pcDSS->pVSearch, pcDSS->iCStride, iWidth, iRows );
+}
+
+
+#define SSE2_DIST_KERNEL( name, bBi, bSSE, iWidth )                                                                  \
+SIMD_TARGET( "sse2" )                                                                                                \
+UInt XDistortion::name( XDistSearchStruct* pcDSS )                                                                   \
+{                                                                                                                    \
+  return xGetDistSSE2<bBi,bSSE>( pcDSS->pYOrg, xGetYFix<bBi>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, iWidth, pcDSS->iRows ); \
+}
+
+#define SSE2_YUV_KERNEL( name, bBi, iWidth )                                                                         \
+SIMD_TARGET( "sse2" )                                                                                                \
+UInt XDistortion::name( XDistSearchStruct* pcDSS )                                                                   \
+{                                                                                                                    \
+  return xGetDistSSE2<bBi,false>( pcDSS->pYOrg, xGetYFix<bBi>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, iWidth, pcDSS->iRows ) \
+       + xGetChromaSADSSE2<bBi>( pcDSS, iWidth / 2 );                                                                \
+}
+
+SSE2_DIST_KERNEL( xGetSAD16xSSE2,  false, false, 16 )
+SSE2_DIST_KERNEL( xGetSAD8xSSE2,   false, false,  8 )
+SSE2_DIST_KERNEL( xGetSAD4xSSE2,   false, false,  4 )
+SSE2_DIST_KERNEL( xGetSSE16xSSE2,  false, true,  16 )
+SSE2_DIST_KERNEL( xGetSSE8xSSE2,   false, true,   8 )
+SSE2_DIST_KERNEL( xGetSSE4xSSE2,   false, true,   4 )
+SSE2_DIST_KERNEL( xGetBiSAD16xSSE2, true, false, 16 )
+SSE2_DIST_KERNEL( xGetBiSAD8xSSE2,  true, false,  8 )
+SSE2_DIST_KERNEL( xGetBiSAD4xSSE2,  true, false,  4 )
+SSE2_DIST_KERNEL( xGetBiSSE16xSSE2, true, true,  16 )
+SSE2_DIST_KERNEL( xGetBiSSE8xSSE2,  true, true,   8 )
+SSE2_DIST_KERNEL( xGetBiSSE4xSSE2,  true, true,   4 )
+
+SSE2_YUV_KERNEL ( xGetYuvSAD16xSSE2,   false, 16 )
+SSE2_YUV_KERNEL ( xGetYuvSAD8xSSE2,    false,  8 )
+SSE2_YUV_KERNEL ( xGetYuvSAD4xSSE2,    false,  4 )
+SSE2_YUV_KERNEL ( xGetBiYuvSAD16xSSE2, true,  16 )
+SSE2_YUV_KERNEL ( xGetBiYuvSAD8xSSE2,  true,   8 )
+SSE2_YUV_KERNEL ( xGetBiYuvSAD4xSSE2,  true,   4 )
+
+#undef SSE2_DIST_KERNEL
+#undef SSE2_YUV_KERNEL
+
+
+
+//====================================================================================
+//  SSSE3
+//====================================================================================
+
+//----- sum of the absolute Hadamard coefficients of the two 4x4 blocks of 4 rows of 8 differences -----
+SIMD_TARGET( "ssse3" )
+static inline __m128i xHadamard8x4( __m128i cRow0, __m128i cRow1, __m128i cRow2, __m128i cRow3 )
+{
+  //===== vertical =====
+  __m128i cA0 = _mm_add_epi16( cRow0, cRow3 );
+  __m128i cA1 = _mm_add_epi16( cRow1, cRow2 );
+  __m128i cA2 = _mm_sub_epi16( cRow1, cRow2 );
+  __m128i cA3 = _mm_sub_epi16( cRow0, cRow3 );
+  __m128i cV0 = _mm_add_epi16( cA0, cA1 );
+  __m128i cV1 = _mm_add_epi16( cA3, cA2 );
+  __m128i cV2 = _mm_sub_epi16( cA0, cA1 );
+  __m128i cV3 = _mm_sub_epi16( cA3, cA2 );
+
+  //===== transpose both blocks, cC<n> holds column n of the left and of the right block =====
+  __m128i cT0 = _mm_unpacklo_epi16( cV0, cV1 );
+  __m128i cT1 = _mm_unpacklo_epi16( cV2, cV3 );
+  __m128i cT2 = _mm_unpackhi_epi16( cV0, cV1 );
+  __m128i cT3 = _mm_unpackhi_epi16( cV2, cV3 );
+  __m128i cU0 = _mm_unpacklo_epi32( cT0, cT1 );
+  __m128i cU1 = _mm_unpackhi_epi32( cT0, cT1 );
+  __m128i cU2 = _mm_unpacklo_epi32( cT2, cT3 );
+  __m128i cU3 = _mm_unpackhi_epi32( cT2, cT3 );
+  __m128i cC0 = _mm_unpacklo_epi64( cU0, cU2 );
+  __m128i cC1 = _mm_unpackhi_epi64( cU0, cU2 );
+  __m128i cC2 = _mm_unpacklo_epi64( cU1, cU3 );
+  __m128i cC3 = _mm_unpackhi_epi64( cU1, cU3 );
+
+  //===== horizontal =====
+  __m128i cB0 = _mm_add_epi16( cC0, cC3 );
+  __m128i cB1 = _mm_add_epi16( cC1, cC2 );
+  __m128i cB2 = _mm_sub_epi16( cC1, cC2 );
+  __m128i cB3 = _mm_sub_epi16( cC0, cC3 );
+
+  __m128i cSum = _mm_add_epi16( _mm_abs_epi16( _mm_add_epi16( cB0, cB1 ) ), _mm_abs_epi16( _mm_sub_epi16( cB0, cB1 ) ) );
+  cSum         = _mm_add_epi16( cSum, _mm_abs_epi16( _mm_add_epi16( cB3, cB2 ) ) );
+  cSum         = _mm_add_epi16( cSum, _mm_abs_epi16( _mm_sub_epi16( cB3, cB2 ) ) );
+  return _mm_madd_epi16( cSum, _mm_set1_epi16( 1 ) );
+}
+
+template< Bool bBi >
+SIMD_TARGET( "ssse3" )
+static inline __m128i xLoadDiff( const XPel* pOrg, const XPel* pFix, const XPel* pCur, Bool bHalf )
+{
+  __m128i cOrg  = ( bHalf ? _mm_loadl_epi64( (const __m128i*)pOrg ) : xLoad8( pOrg ) );
+  __m128i cPred = ( bHalf ? _mm_loadl_epi64( (const __m128i*)pCur ) : xLoad8( pCur ) );
+  if( bBi )
+  {
+    cPred = _mm_avg_epu16( cPred, ( bHalf ? _mm_loadl_epi64( (const __m128i*)pFix ) : xLoad8( pFix ) ) );
+  }
+  return _mm_sub_epi16( cOrg, cPred );
+}
+
+template< Bool bBi >
+SIMD_TARGET( "ssse3" )
+static inline UInt xGetHadSSSE3( XDistSearchStruct* pcDSS, Int iWidth )
+{
+  const XPel* pOrg    = pcDSS->pYOrg;
+  const XPel* pFix    = xGetYFix<bBi>( pcDSS );
+  const XPel* pCur    = pcDSS->pYSearch;
+  Int         iStride = pcDSS->iYStride;
+  Bool        bHalf   = ( iWidth == 4 );
+  __m128i     cSum    = _mm_setzero_si128();
+
+  for( Int iRows = pcDSS->iRows; iRows > 0; iRows -= 4 )
+  {
+    for( Int x = 0; x < iWidth; x += 8 )
+    {
+      __m128i cRow0 = xLoadDiff<bBi>( pOrg + x,                     pFix + x,                     pCur + x,             bHalf );
+      __m128i cRow1 = xLoadDiff<bBi>( pOrg + x + MB_BUFFER_WIDTH,   pFix + x + MB_BUFFER_WIDTH,   pCur + x + iStride,   bHalf );
+      __m128i cRow2 = xLoadDiff<bBi>( pOrg + x + 2*MB_BUFFER_WIDTH, pFix + x + 2*MB_BUFFER_WIDTH, pCur + x + 2*iStride, bHalf );
+      __m128i cRow3 = xLoadDiff<bBi>( pOrg + x + 3*MB_BUFFER_WIDTH, pFix + x + 3*MB_BUFFER_WIDTH, pCur + x + 3*iStride, bHalf );
+      cSum = _mm_add_epi32( cSum, xHadamard8x4( cRow0, cRow1, cRow2, cRow3 ) );
+    }
+    pOrg += 4*MB_BUFFER_WIDTH;
+    pFix += 4*MB_BUFFER_WIDTH;
+    pCur += 4*iStride;
+  }
+  return xHorSum( cSum ) / 2;
+}
+
+SIMD_TARGET( "ssse3" ) UInt XDistortion::xGetHAD16xSSSE3  ( XDistSearchStruct* pcDSS ) { return xGetHadSSSE3<false>( pcDSS, 16 ); }
+SIMD_TARGET( "ssse3" ) UInt XDistortion::xGetHAD8xSSSE3   ( XDistSearchStruct* pcDSS ) { return xGetHadSSSE3<false>( pcDSS,  8 ); }
+SIMD_TARGET( "ssse3" ) UInt XDistortion::xGetHAD4xSSSE3   ( XDistSearchStruct* pcDSS ) { return xGetHadSSSE3<false>( pcDSS,  4 ); }
+SIMD_TARGET( "ssse3" ) UInt XDistortion::xGetBiHAD16xSSSE3( XDistSearchStruct* pcDSS ) { return xGetHadSSSE3<true >( pcDSS, 16 ); }
+SIMD_TARGET( "ssse3" ) UInt XDistortion::xGetBiHAD8xSSSE3 ( XDistSearchStruct* pcDSS ) { return xGetHadSSSE3<true >( pcDSS,  8 ); }
+SIMD_TARGET( "ssse3" ) UInt XDistortion::xGetBiHAD4xSSSE3 ( XDistSearchStruct* pcDSS ) { return xGetHadSSSE3<true >( pcDSS,  4 ); }
+
+
+
+#if defined( H264AVC_X86_AVX2 )
+
+//====================================================================================
+//  AVX2, one row of a 16 pel wide block per register
+//====================================================================================
+
+SIMD_TARGET( "avx2" )
+static inline __m256i xLoad16( const XPel* pPel )
+{
+  return _mm256_loadu_si256( (const __m256i*)pPel );
+}
+
+SIMD_TARGET( "avx2" )
+static inline UInt xHorSum( __m256i cSum )
+{
+  return xHorSum( _mm_add_epi32( _mm256_castsi256_si128( cSum ), _mm256_extracti128_si256( cSum, 1 ) ) );
+}
+
+template< Bool bBi >
+SIMD_TARGET( "avx2" )
+static inline __m256i xLoadDiff16( const XPel* pOrg, const XPel* pFix, const XPel* pCur )
+{
+  __m256i cPred = xLoad16( pCur );
+  if( bBi )
+  {
+    cPred = _mm256_avg_epu16( cPred, xLoad16( pFix ) );
+  }
+  return _mm256_sub_epi16( xLoad16( pOrg ), cPred );
+}
+
+template< Bool bBi, Bool bSSE >
+SIMD_TARGET( "avx2" )
+static inline UInt xGetDist16xAVX2( const XPel* pOrg, const XPel* pFix, const XPel* pCur, Int iStride, Int iRows )
+{
+  const __m256i cOne = _mm256_set1_epi16( 1 );
+  __m256i       cSum = _mm256_setzero_si256();
+
+  for( ; iRows != 0; iRows-- )
+  {
+    __m256i cDiff = xLoadDiff16<bBi>( pOrg, pFix, pCur );
+    cSum  = _mm256_add_epi32( cSum, ( bSSE ? _mm256_madd_epi16( cDiff, cDiff ) : _mm256_madd_epi16( _mm256_abs_epi16( cDiff ), cOne ) ) );
+    pOrg += MB_BUFFER_WIDTH;
+    pCur += iStride;
+    if( bBi )
+    {
+      pFix += MB_BUFFER_WIDTH;
+    }
+  }
+  return xHorSum( cSum );
+}
+
+//----- as xHadamard8x4, the unpack instructions work within the two 128 bit lanes -----
+SIMD_TARGET( "avx2" )
+static inline __m256i xHadamard16x4( __m256i cRow0, __m256i cRow1, __m256i cRow2, __m256i cRow3 )
+{
+  __m256i cA0 = _mm256_add_epi16( cRow0, cRow3 );
+  __m256i cA1 = _mm256_add_epi16( cRow1, cRow2 );
+  __m256i cA2 = _mm256_sub_epi16( cRow1, cRow2 );
+  __m256i cA3 = _mm256_sub_epi16( cRow0, cRow3 );
+  __m256i cV0 = _mm256_add_epi16( cA0, cA1 );
+  __m256i cV1 = _mm256_add_epi16( cA3, cA2 );
+  __m256i cV2 = _mm256_sub_epi16( cA0, cA1 );
+  __m256i cV3 = _mm256_sub_epi16( cA3, cA2 );
+
+  __m256i cT0 = _mm256_unpacklo_epi16( cV0, cV1 );
+  __m256i cT1 = _mm256_unpacklo_epi16( cV2, cV3 );
+  __m256i cT2 = _mm256_unpackhi_epi16( cV0, cV1 );
+  __m256i cT3 = _mm256_unpackhi_epi16( cV2, cV3 );
+  __m256i cU0 = _mm256_unpacklo_epi32( cT0, cT1 );
+  __m256i cU1 = _mm256_unpackhi_epi32( cT0, cT1 );
+  __m256i cU2 = _mm256_unpacklo_epi32( cT2, cT3 );
+  __m256i cU3 = _mm256_unpackhi_epi32( cT2, cT3 );
+  __m256i cC0 = _mm256_unpacklo_epi64( cU0, cU2 );
+  __m256i cC1 = _mm256_unpackhi_epi64( cU0, cU2 );
+  __m256i cC2 = _mm256_unpacklo_epi64( cU1, cU3 );
+  __m256i cC3 = _mm256_unpackhi_epi64( cU1, cU3 );
+
+  __m256i cB0 = _mm256_add_epi16( cC0, cC3 );
+  __m256i cB1 = _mm256_add_epi16( cC1, cC2 );
+  __m256i cB2 = _mm256_sub_epi16( cC1, cC2 );
+  __m256i cB3 = _mm256_sub_epi16( cC0, cC3 );
+
+  __m256i cSum = _mm256_add_epi16( _mm256_abs_epi16( _mm256_add_epi16( cB0, cB1 ) ), _mm256_abs_epi16( _mm256_sub_epi16( cB0, cB1 ) ) );
+  cSum         = _mm256_add_epi16( cSum, _mm256_abs_epi16( _mm256_add_epi16( cB3, cB2 ) ) );
+  cSum         = _mm256_add_epi16( cSum, _mm256_abs_epi16( _mm256_sub_epi16( cB3, cB2 ) ) );
+  return _mm256_madd_epi16( cSum, _mm256_set1_epi16( 1 ) );
+}
+
+template< Bool bBi >
+SIMD_TARGET( "avx2" )
+static inline UInt xGetHad16xAVX2( XDistSearchStruct* pcDSS )
+{
+  const XPel* pOrg    = pcDSS->pYOrg;
+  const XPel* pFix    = xGetYFix<bBi>( pcDSS );
+  const XPel* pCur    = pcDSS->pYSearch;
+  Int         iStride = pcDSS->iYStride;
+  __m256i     cSum    = _mm256_setzero_si256();
+
+  for( Int iRows = pcDSS->iRows; iRows > 0; iRows -= 4 )
+  {
+    __m256i cRow0 = xLoadDiff16<bBi>( pOrg,                     pFix,                     pCur             );
+    __m256i cRow1 = xLoadDiff16<bBi>( pOrg +   MB_BUFFER_WIDTH, pFix +   MB_BUFFER_WIDTH, pCur +   iStride );
+    __m256i cRow2 = xLoadDiff16<bBi>( pOrg + 2*MB_BUFFER_WIDTH, pFix + 2*MB_BUFFER_WIDTH, pCur + 2*iStride );
+    __m256i cRow3 = xLoadDiff16<bBi>( pOrg + 3*MB_BUFFER_WIDTH, pFix + 3*MB_BUFFER_WIDTH, pCur + 3*iStride );
+    cSum  = _mm256_add_epi32( cSum, xHadamard16x4( cRow0, cRow1, cRow2, cRow3 ) );
+    pOrg += 4*MB_BUFFER_WIDTH;
+    pFix += 4*MB_BUFFER_WIDTH;
+    pCur += 4*iStride;
+  }
+  return xHorSum( cSum ) / 2;
+}
+
+SIMD_TARGET( "avx2" )
+UInt XDistortion::xGetSAD16xAVX2( XDistSearchStruct* pcDSS )
+{
+  return xGetDist16xAVX2<false,false>( pcDSS->pYOrg, xGetYFix<false>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, pcDSS->iRows );
+}
+
+SIMD_TARGET( "avx2" )
+UInt XDistortion::xGetSSE16xAVX2( XDistSearchStruct* pcDSS )
+{
+  return xGetDist16xAVX2<false,true>( pcDSS->pYOrg, xGetYFix<false>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, pcDSS->iRows );
+}
+
+SIMD_TARGET( "avx2" )
+UInt XDistortion::xGetYuvSAD16xAVX2( XDistSearchStruct* pcDSS )
+{
+  return xGetDist16xAVX2<false,false>( pcDSS->pYOrg, xGetYFix<false>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, pcDSS->iRows )
+       + xGetChromaSADSSE2<false>( pcDSS, 8 );
+}
+
+SIMD_TARGET( "avx2" )
+UInt XDistortion::xGetBiSAD16xAVX2( XDistSearchStruct* pcDSS )
+{
+  return xGetDist16xAVX2<true,false>( pcDSS->pYOrg, xGetYFix<true>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, pcDSS->iRows );
+}
+
+SIMD_TARGET( "avx2" )
+UInt XDistortion::xGetBiSSE16xAVX2( XDistSearchStruct* pcDSS )
+{
+  return xGetDist16xAVX2<true,true>( pcDSS->pYOrg, xGetYFix<true>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, pcDSS->iRows );
+}
+
+SIMD_TARGET( "avx2" )
+UInt XDistortion::xGetBiYuvSAD16xAVX2( XDistSearchStruct* pcDSS )
+{
+  return xGetDist16xAVX2<true,false>( pcDSS->pYOrg, xGetYFix<true>( pcDSS ), pcDSS->pYSearch, pcDSS->iYStride, pcDSS->iRows )
+       + xGetChromaSADSSE2<true>( pcDSS, 8 );
+}
+
+SIMD_TARGET( "avx2" ) UInt XDistortion::xGetHAD16xAVX2  ( XDistSearchStruct* pcDSS ) { return xGetHad16xAVX2<false>( pcDSS ); }
+SIMD_TARGET( "avx2" ) UInt XDistortion::xGetBiHAD16xAVX2( XDistSearchStruct* pcDSS ) { return xGetHad16xAVX2<true >( pcDSS ); }
+
+#endif // H264AVC_X86_AVX2
+
+#endif // H264AVC_X86_SIMD
+
+
+H264AVC_NAMESPACE_END
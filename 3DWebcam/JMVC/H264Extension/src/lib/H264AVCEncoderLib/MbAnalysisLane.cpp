@@ -0,0 +1,257 @@
+#include "H264AVCEncoderLib.h"
+#include "MbAnalysisLane.h"
+#include "CodingParameter.h"
+#include "IntraPredictionSearch.h"
+#include "Distortion.h"
+#include "MotionEstimationQuarterPel.h"
+#include "RateDistortion.h"
+#include "H264AVCCommonLib/Transform.h"
+#include "H264AVCCommonLib/YuvBufferCtrl.h"
+#include "H264AVCCommonLib/SampleWeighting.h"
+
+#include <new>
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+MbAnalysisLane::MbAnalysisLane():
+  m_pcCodingParameter     ( NULL ),
+  m_pcYuvFullPelBufferCtrl( NULL ),
+  m_pcYuvHalfPelBufferCtrl( NULL ),
+  m_pcMbEncoder           ( NULL ),
+  m_pcMotionEstimation    ( NULL ),
+  m_pcTransform           ( NULL ),
+  m_pcIntraPrediction     ( NULL ),
+  m_pcXDistortion         ( NULL ),
+  m_pcRateDistortion      ( NULL ),
+  m_pcSampleWeighting     ( NULL ),
+  m_pcMbCoder             ( NULL ),
+  m_pcUvlcTester          ( NULL ),
+  m_pcBitCounter          ( NULL ),
+  m_pcMbDataAccess        ( NULL ),
+  m_pvSliceHeaderMem      ( NULL ),
+  m_pcSliceHeader         ( NULL ),
+  m_uiSliceId             ( 0 ),
+  m_bCavlc                ( false ),
+  m_bCodeMbs              ( false ),
+  m_bInitDone             ( false )
+{
+}
+
+
+MbAnalysisLane::~MbAnalysisLane()
+{
+}
+
+
+ErrVal
+MbAnalysisLane::create( MbAnalysisLane*& rpcMbAnalysisLane )
+{
+  rpcMbAnalysisLane = new MbAnalysisLane;
+  ROT( NULL == rpcMbAnalysisLane );
+
+  MbAnalysisLane* p = rpcMbAnalysisLane;
+  RNOK( MbEncoder                   ::create( p->m_pcMbEncoder ) );
+  RNOK( MotionEstimationQuarterPel  ::create( p->m_pcMotionEstimation ) );
+  RNOK( Transform                   ::create( p->m_pcTransform ) );
+  RNOK( IntraPredictionSearch       ::create( p->m_pcIntraPrediction ) );
+  RNOK( XDistortion                 ::create( p->m_pcXDistortion ) );
+  RNOK( RateDistortion              ::create( p->m_pcRateDistortion ) );
+  RNOK( SampleWeighting             ::create( p->m_pcSampleWeighting ) );
+  RNOK( MbCoder                     ::create( p->m_pcMbCoder ) );
+  RNOK( UvlcWriter                  ::create( p->m_pcUvlcTester, false ) );
+  RNOK( BitCounter                  ::create( p->m_pcBitCounter ) );
+
+  p->m_pvSliceHeaderMem = ::operator new( sizeof( SliceHeader ) );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MbAnalysisLane::destroy()
+{
+  RNOK( m_pcMbEncoder         ->destroy() );
+  RNOK( m_pcMotionEstimation  ->destroy() );
+  RNOK( m_pcTransform         ->destroy() );
+  RNOK( m_pcIntraPrediction   ->destroy() );
+  RNOK( m_pcXDistortion       ->destroy() );
+  RNOK( m_pcRateDistortion    ->destroy() );
+  RNOK( m_pcSampleWeighting   ->destroy() );
+  RNOK( m_pcMbCoder           ->destroy() );
+  RNOK( m_pcUvlcTester        ->destroy() );
+  RNOK( m_pcBitCounter        ->destroy() );
+  H264AVC_DELETE_CLASS( m_pcMbDataAccess );
+  ::operator delete( m_pvSliceHeaderMem );
+
+  delete this;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MbAnalysisLane::init( CodingParameter*  pcCodingParameter,
+                      QuarterPelFilter* pcQuarterPelFilter,
+                      YuvBufferCtrl*    pcYuvFullPelBufferCtrl,
+                      YuvBufferCtrl*    pcYuvHalfPelBufferCtrl )
+{
+  ROT( m_bInitDone );
+  ROT( NULL == pcCodingParameter );
+  ROT( NULL == pcQuarterPelFilter );
+  ROT( NULL == pcYuvFullPelBufferCtrl );
+  ROT( NULL == pcYuvHalfPelBufferCtrl );
+
+  m_pcCodingParameter       = pcCodingParameter;
+  m_pcYuvFullPelBufferCtrl  = pcYuvFullPelBufferCtrl;
+  m_pcYuvHalfPelBufferCtrl  = pcYuvHalfPelBufferCtrl;
+
+  //===== same set-up as the shared tools in CreaterH264AVCEncoder::init() =====
+  RNOK( m_pcXDistortion       ->init( pcCodingParameter->getSIMD(), pcCodingParameter->getSIMDSelfCheck() != 0 ) );
+  RNOK( m_pcSampleWeighting   ->init() );
+  RNOK( m_pcTransform         ->init( pcCodingParameter->getSIMD(), pcCodingParameter->getSIMDSelfCheck() != 0 ) );
+  RNOK( m_pcBitCounter        ->init() );
+  RNOK( m_pcUvlcTester        ->init( m_pcBitCounter ) );
+  RNOK( m_pcMbEncoder         ->init( m_pcTransform,
+                                      m_pcIntraPrediction,
+                                      m_pcMotionEstimation,
+                                      pcCodingParameter,
+                                      m_pcRateDistortion,
+                                      m_pcXDistortion ) );
+  RNOK( m_pcMotionEstimation  ->init( m_pcXDistortion,
+                                      pcCodingParameter,
+                                      m_pcRateDistortion,
+                                      pcQuarterPelFilter,
+                                      m_pcTransform,
+                                      m_pcSampleWeighting ) );
+
+  m_bInitDone = true;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MbAnalysisLane::uninit()
+{
+  ROF( m_bInitDone );
+
+  RNOK( m_pcMbEncoder         ->uninit() );
+  RNOK( m_pcMotionEstimation  ->uninit() );
+  RNOK( m_pcTransform         ->uninit() );
+  RNOK( m_pcIntraPrediction   ->uninit() );
+  RNOK( m_pcXDistortion       ->uninit() );
+  RNOK( m_pcSampleWeighting   ->uninit() );
+  RNOK( m_pcMbCoder           ->uninit() );
+  RNOK( m_pcUvlcTester        ->uninit() );
+  RNOK( m_pcBitCounter        ->uninit() );
+
+  m_bInitDone = false;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MbAnalysisLane::initSlice( const SliceHeader& rcSH,
+                           UInt               uiSliceId,
+                           MbSymbolWriteIf*   pcMbSymbolWriteIf )
+{
+  ROF( m_bInitDone );
+
+  //===== the rate estimation of MbEncoder switches the slice type of the header for a while, so every lane works on =====
+  //===== its own member-wise copy; the copy shares FMO map and weight tables with rcSH and is therefore never destructed =====
+  m_pcSliceHeader = new ( m_pvSliceHeaderMem ) SliceHeader( rcSH );
+
+  //===== as ControlMngH264AVCEncoder::initSliceForCoding() =====
+  m_uiSliceId = uiSliceId;
+  m_bCavlc    = ! m_pcSliceHeader->getPPS().getEntropyCodingModeFlag();
+  m_bCodeMbs  = ( NULL != pcMbSymbolWriteIf );
+
+  RNOK( m_pcMbEncoder         ->initSlice( *m_pcSliceHeader ) );
+  RNOK( m_pcMotionEstimation  ->initSlice( *m_pcSliceHeader ) );
+  RNOK( m_pcSampleWeighting   ->initSlice( *m_pcSliceHeader ) );
+
+  if( m_bCodeMbs )
+  {
+    RNOK( pcMbSymbolWriteIf   ->startSlice( *m_pcSliceHeader ) );
+    RNOK( m_pcMbCoder         ->initSlice( *m_pcSliceHeader, pcMbSymbolWriteIf, m_pcRateDistortion ) );
+  }
+  else if( m_bCavlc )
+  {
+    RNOK( m_pcBitCounter      ->init() );
+    RNOK( m_pcUvlcTester      ->startSlice( *m_pcSliceHeader ) );
+    RNOK( m_pcMbCoder         ->initSlice( *m_pcSliceHeader, m_pcUvlcTester, m_pcRateDistortion ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MbAnalysisLane::analyseMb( MbDataCtrl*   pcMbDataCtrl,
+                           IntFrame*     pcFrame,
+                           RefFrameList& rcList0,
+                           RefFrameList& rcList1,
+                           UInt          uiMbY,
+                           UInt          uiMbX,
+                           Double        dLambda )
+{
+  ROF( m_bInitDone );
+  ROF( m_pcSliceHeader );
+
+  RNOK( pcMbDataCtrl->initMbForAnalysis( m_pcMbDataAccess, *m_pcSliceHeader, m_uiSliceId, uiMbY, uiMbX ) );
+
+  //===== as ControlMngH264AVCEncoder::initMbForCoding() for frame macroblocks =====
+  m_pcMbDataAccess->getMbMotionData( LIST_0 ).setFieldMode( false );
+  m_pcMbDataAccess->getMbMotionData( LIST_1 ).setFieldMode( false );
+
+  RNOK( m_pcYuvFullPelBufferCtrl->initMb( uiMbY, uiMbX, false ) );
+  RNOK( m_pcYuvHalfPelBufferCtrl->initMb( uiMbY, uiMbX, false ) );
+  RNOK( m_pcMotionEstimation    ->initMb( uiMbY, uiMbX, *m_pcMbDataAccess ) );
+
+  Double dCost;
+  RNOK( m_pcMbEncoder->encodeMacroblock( *m_pcMbDataAccess,
+                                          pcFrame,
+                                          pcFrame,
+                                          rcList0,
+                                          rcList1,
+                                          m_pcCodingParameter->getMotionVectorSearchParams().getNumMaxIter(),
+                                          m_pcCodingParameter->getMotionVectorSearchParams().getIterSearchRange(),
+                                          dLambda,
+                                          dCost,
+                                          true ) );
+
+  //===== the CAVLC writer leaves coefficient counts in the macroblock that the rate estimation of the =====
+  //===== following macroblocks reads; a counting run sets the same values before the real entropy coding =====
+  if( m_bCavlc && ! m_bCodeMbs )
+  {
+    if( m_pcMbDataAccess->getMbData().isPCM() )
+    {
+      m_pcMbDataAccess->getMbData  ().setSkipFlag( false );
+      m_pcMbDataAccess->getMbTCoeffs().setAllCoeffCount( 16 );
+    }
+    else
+    {
+      RNOK( m_pcMbCoder->encode( *m_pcMbDataAccess, NULL, SST_RATIO_1, false, true ) );
+    }
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MbAnalysisLane::codeMb( Bool bTerminateSlice )
+{
+  ROF( m_bCodeMbs );
+  ROF( m_pcMbDataAccess );
+
+  RNOK( m_pcMbCoder->encode( *m_pcMbDataAccess, NULL, SST_RATIO_1, bTerminateSlice, true ) );
+
+  return Err::m_nOK;
+}
+
+
+H264AVC_NAMESPACE_END
@@ -0,0 +1,81 @@
+#if !defined(AFX_MBANALYSISLANE_H__B603E731_BBA0_4110_86B4_56067DDEFCD7__INCLUDED_)
+#define AFX_MBANALYSISLANE_H__B603E731_BBA0_4110_86B4_56067DDEFCD7__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "MbEncoder.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+class CodingParameter;
+class QuarterPelFilter;
+class YuvBufferCtrl;
+class SampleWeighting;
+class IntraPredictionSearch;
+class XDistortion;
+class RateDistortion;
+
+
+//===== mode decision and motion estimation for one thread of the macroblock wavefront of SliceEncoder or of a SliceWorker =====
+//===== every tool that keeps per-macroblock state is owned by the lane, so that lanes run concurrently =====
+class MbAnalysisLane
+{
+protected:
+  MbAnalysisLane();
+  virtual ~MbAnalysisLane();
+
+public:
+  static ErrVal create( MbAnalysisLane*& rpcMbAnalysisLane );
+  ErrVal destroy();
+  ErrVal init( CodingParameter*  pcCodingParameter,
+               QuarterPelFilter* pcQuarterPelFilter,
+               YuvBufferCtrl*    pcYuvFullPelBufferCtrl,
+               YuvBufferCtrl*    pcYuvHalfPelBufferCtrl );
+  ErrVal uninit();
+
+  //===== without pcMbSymbolWriteIf the lane only analyses the macroblocks, otherwise codeMb() writes them to pcMbSymbolWriteIf =====
+  ErrVal initSlice( const SliceHeader& rcSH,
+                    UInt               uiSliceId,
+                    MbSymbolWriteIf*   pcMbSymbolWriteIf = NULL );
+
+  //===== the calling thread must have selected the macroblock offsets of this lane (YuvBufferCtrl::setMbLane) =====
+  ErrVal analyseMb( MbDataCtrl*   pcMbDataCtrl,
+                    IntFrame*     pcFrame,
+                    RefFrameList& rcList0,
+                    RefFrameList& rcList1,
+                    UInt          uiMbY,
+                    UInt          uiMbX,
+                    Double        dLambda );
+  ErrVal codeMb   ( Bool          bTerminateSlice );
+
+protected:
+  CodingParameter*        m_pcCodingParameter;
+  YuvBufferCtrl*          m_pcYuvFullPelBufferCtrl;
+  YuvBufferCtrl*          m_pcYuvHalfPelBufferCtrl;
+  MbEncoder*              m_pcMbEncoder;
+  MotionEstimation*       m_pcMotionEstimation;
+  Transform*              m_pcTransform;
+  IntraPredictionSearch*  m_pcIntraPrediction;
+  XDistortion*            m_pcXDistortion;
+  RateDistortion*         m_pcRateDistortion;
+  SampleWeighting*        m_pcSampleWeighting;
+  MbCoder*                m_pcMbCoder;
+  UvlcWriter*             m_pcUvlcTester;
+  BitCounter*             m_pcBitCounter;
+  MbDataAccess*           m_pcMbDataAccess;
+  Void*                   m_pvSliceHeaderMem;
+  SliceHeader*            m_pcSliceHeader;    // copy of the slice header in m_pvSliceHeaderMem, see initSlice()
+  UInt                    m_uiSliceId;
+  Bool                    m_bCavlc;
+  Bool                    m_bCodeMbs;
+  Bool                    m_bInitDone;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_MBANALYSISLANE_H__B603E731_BBA0_4110_86B4_56067DDEFCD7__INCLUDED_)
@@ -74,6 +74,8 @@ MbEncoder::MbEncoder():
   ,	m_puiPdsInitialDelayMinus2L1 ( 0 )
   , m_uiPdsBlockSize             ( 0 )
 //~JVT-W080
+  , m_uiFastModeDecision         ( 0 )
+  , m_bSubMb8x8Pruned            ( false )
 {
   m_uiMaxRefFrames[LIST_0] = m_uiMaxRefFrames[LIST_1] = 0;
   m_uiMaxRefPics  [LIST_0] = m_uiMaxRefPics  [LIST_1] = 0;
@@ -117,6 +119,7 @@ MbEncoder::initSlice( const SliceHeader& rcSH )
   m_uiMaxRefFrames[LIST_0]  = rcSH.getNumRefIdxActive( LIST_0 );
   m_uiMaxRefFrames[LIST_1]  = rcSH.getNumRefIdxActive( LIST_1 );
   m_uiMaxRefPics  [LIST_0]  = m_uiMaxRefPics  [LIST_1] = 0;
+  m_uiFastModeDecision      = m_pcCodingParameter->getFastModeDecision();
   RNOK( MbCoder::initSlice( rcSH, this, MbEncoder::m_pcRateDistortionIf ) );
 
   m_BitCounter            = (BitWriteBufferIf*)this;
@@ -463,6 +466,10 @@ MbEncoder::encodeMacroblock( MbDataAccess&  rcMbDataAccess,
 
 
   //====== evaluate macroblock modes ======
+  Bool    bInter        = rcMbDataAccess.getSH().isInterP() || rcMbDataAccess.getSH().isInterB();
+  Bool    bModeDecided  = false;
+  Double  dQuantNoise   = xGetQuantNoise( uiQp );
+
   if( rcMbDataAccess.getSH().isInterP() && bSkipModeAllowed  )
   {
     RNOK( xEstimateMbSkip     ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1 ) );
@@ -473,19 +480,41 @@ MbEncoder::encodeMacroblock( MbDataAccess&  rcMbDataAccess,
 
 
   }
-  if( rcMbDataAccess.getSH().isInterP() || rcMbDataAccess.getSH().isInterB() )
+  //----- fast mode decision: other modes can hardly improve a skipped macroblock whose cost is a small fraction of the quantization noise -----
+  if( m_uiFastModeDecision && bInter )
+  {
+    bModeDecided  = ( m_pcIntMbBestData->getMbMode() == MODE_SKIP && m_pcIntMbBestData->cbp() == 0 &&
+                      m_pcIntMbBestData->rdCost () <  ( m_uiFastModeDecision > 1 ? 0.10 : 0.05 ) * dQuantNoise );
+  }
+  if( bInter && ! bModeDecided )
   {
     RNOK( xEstimateMb16x16    ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
     RNOK( xEstimateMb16x8     ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
     RNOK( xEstimateMb8x16     ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
 
-    RNOK( xEstimateMb8x8      ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
-    RNOK( xEstimateMb8x8Frext ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
+    //----- fast mode decision: partitions below 8x8 are only tested when the 16x8 or 8x16 partitions paid off, level 2 drops 8x8 as well -----
+    m_bSubMb8x8Pruned = ( m_uiFastModeDecision &&
+                          ( m_pcIntMbBestData->getMbMode() == MODE_SKIP || m_pcIntMbBestData->getMbMode() == MODE_16x16 ) );
+    if( ! m_bSubMb8x8Pruned || m_uiFastModeDecision < 2 )
+    {
+      RNOK( xEstimateMb8x8      ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
+      RNOK( xEstimateMb8x8Frext ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcList0,  rcList1,  false,  uiNumMaxIter, uiIterSearchRange,  false,  NULL, false ) );
+    }
+    m_bSubMb8x8Pruned = false;
+
+    //----- fast mode decision: intra modes are only tested when the best inter mode costs more than a fraction of the quantization noise -----
+    if( m_uiFastModeDecision )
+    {
+      bModeDecided  = ( m_pcIntMbBestData->rdCost() < ( m_uiFastModeDecision > 1 ? 0.20 : 0.10 ) * dQuantNoise );
+    }
+  }
+  if( ! bModeDecided )
+  {
+    RNOK( xEstimateMbIntra16  ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
+    RNOK( xEstimateMbIntra8   ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
+    RNOK( xEstimateMbIntra4   ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
+    RNOK( xEstimateMbPCM      ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
   }
-  RNOK(   xEstimateMbIntra16  ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
-  RNOK(   xEstimateMbIntra8   ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
-  RNOK(   xEstimateMbIntra4   ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
-  RNOK(   xEstimateMbPCM      ( m_pcIntMbTempData,  m_pcIntMbBestData,  rcMbDataAccess.getSH().isInterB() ) );
 
 
   //===== fix estimation =====
@@ -638,13 +667,16 @@ MbEncoder::encodeResidual( MbDataAccess&  rcMbDataAccess,
 
         if( uiTrafo8x8 )
         {
+          UInt auiAbsSum[4];
+          RNOK( xTransformLumaInter( *m_pcIntMbTempData, true, auiAbsSum ) );
+
           for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
           {
             xSetCoeffCost( 0 );
             UInt uiBits = 0;
             UInt uiCbp  = 0;
             
-            RNOK( xEncode8x8InterBlock( *m_pcIntMbTempData, c8x8Idx, uiBits, uiCbp ) );
+            RNOK( xEncode8x8InterBlock( *m_pcIntMbTempData, c8x8Idx, auiAbsSum[c8x8Idx.b8x8Index()], uiBits, uiCbp ) );
             if( uiCbp )
             {
 							//-- JVT-R091
@@ -667,6 +699,9 @@ MbEncoder::encodeResidual( MbDataAccess&  rcMbDataAccess,
         }
         else
         {
+          UInt auiAbsSum[16];
+          RNOK( xTransformLumaInter( *m_pcIntMbTempData, false, auiAbsSum ) );
+
           for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
           {
             xSetCoeffCost( 0 );
@@ -674,7 +709,7 @@ MbEncoder::encodeResidual( MbDataAccess&  rcMbDataAccess,
             UInt uiCbp  = 0;
             for( S4x4Idx cIdx( c8x8Idx ); cIdx.isLegal( c8x8Idx ); cIdx++ )
             {
-              RNOK( xEncode4x4InterBlock( *m_pcIntMbTempData, cIdx, uiBits, uiCbp ) );
+              RNOK( xEncode4x4InterBlock( *m_pcIntMbTempData, cIdx, auiAbsSum[cIdx], uiBits, uiCbp ) );
             }
             if( uiCbp )
             {
@@ -845,13 +880,16 @@ MbEncoder::encodeResidual( MbDataAccess&  rcMbDataAccess,
       }
       else if( uiTrafo8x8 )
       {
+        UInt auiAbsSum[4];
+        RNOK( xTransformLumaInter( *m_pcIntMbTempData, true, auiAbsSum ) );
+
         for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
         {
           xSetCoeffCost( 0 );
           UInt uiBits = 0;
           UInt uiCbp  = 0;
           
-          RNOK( xEncode8x8InterBlock( *m_pcIntMbTempData, c8x8Idx, uiBits, uiCbp ) );
+          RNOK( xEncode8x8InterBlock( *m_pcIntMbTempData, c8x8Idx, auiAbsSum[c8x8Idx.b8x8Index()], uiBits, uiCbp ) );
           if( uiCbp )
           {
             if( xGetCoeffCost() <= uiB8Thres && ! rcMbDataAccess.getSH().isIntra() && ! bLowPass && ! bIntra )
@@ -871,6 +909,9 @@ MbEncoder::encodeResidual( MbDataAccess&  rcMbDataAccess,
       }
       else
       {
+        UInt auiAbsSum[16];
+        RNOK( xTransformLumaInter( *m_pcIntMbTempData, false, auiAbsSum ) );
+
         for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
         {
           xSetCoeffCost( 0 );
@@ -878,7 +919,7 @@ MbEncoder::encodeResidual( MbDataAccess&  rcMbDataAccess,
           UInt uiCbp  = 0;
           for( S4x4Idx cIdx( c8x8Idx ); cIdx.isLegal( c8x8Idx ); cIdx++ )
           {
-            RNOK( xEncode4x4InterBlock( *m_pcIntMbTempData, cIdx, uiBits, uiCbp ) );
+            RNOK( xEncode4x4InterBlock( *m_pcIntMbTempData, cIdx, auiAbsSum[cIdx], uiBits, uiCbp ) );
           }
           if( uiCbp )
           {
@@ -1070,6 +1111,9 @@ MbEncoder::xEstimateMbIntraBL( IntMbTempData*&  rpcMbTempData,
   UInt  uiCoeffCost = 0;
   UInt  uiExtCbp    = 0;
   //--- LUMA ---
+  UInt auiAbsSum[16];
+  RNOK( xTransformLumaInter( *rpcMbTempData, false, auiAbsSum ) );
+
   for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
   {
     xSetCoeffCost( 0 );
@@ -1078,7 +1122,7 @@ MbEncoder::xEstimateMbIntraBL( IntMbTempData*&  rpcMbTempData,
 
     for( S4x4Idx cIdx( c8x8Idx ); cIdx.isLegal( c8x8Idx ); cIdx++ )
     {
-      RNOK( xEncode4x4InterBlock( *rpcMbTempData, cIdx, uiBits, uiCbp ) );
+      RNOK( xEncode4x4InterBlock( *rpcMbTempData, cIdx, auiAbsSum[cIdx], uiBits, uiCbp ) );
     }
     if( uiCbp )
     {
@@ -1164,13 +1208,16 @@ MbEncoder::xEstimateMbIntraBL8x8( IntMbTempData*&  rpcMbTempData,
   UInt  uiCoeffCost = 0;
   UInt  uiExtCbp    = 0;
   //--- LUMA ---
+  UInt auiAbsSum[4];
+  RNOK( xTransformLumaInter( *rpcMbTempData, true, auiAbsSum ) );
+
   for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
   {
     xSetCoeffCost( 0 );
     UInt  uiBits = 0;
     UInt  uiCbp  = 0;
 
-    RNOK( xEncode8x8InterBlock( *rpcMbTempData, c8x8Idx, uiBits, uiCbp ) );
+    RNOK( xEncode8x8InterBlock( *rpcMbTempData, c8x8Idx, auiAbsSum[c8x8Idx.b8x8Index()], uiBits, uiCbp ) );
     if( uiCbp )
     {
       uiCoeffCost += xGetCoeffCost();
@@ -1563,6 +1610,14 @@ UInt MbEncoder::xCalcMbCbp( UInt uiExtCbp )
 }
 
 
+Double MbEncoder::xGetQuantNoise( UInt uiQp ) const
+{
+  //===== squared error of a uniform quantizer over the 384 samples of a macroblock, Qstep = 0.625 * 2^(QP/6) =====
+  Double dQStep = 0.625 * pow( 2.0, (Double)uiQp / 6.0 );
+  return 384.0 * dQStep * dQStep / 12.0;
+}
+
+
 
 
 
@@ -1623,6 +1678,30 @@ __inline Void MbEncoder::xUpDateBest( IntMbTempData& rcMbTempData )
 
 
 
+ErrVal
+MbEncoder::xTransformLumaInter( IntMbTempData& rcMbTempData,
+                                Bool           bTrafo8x8,
+                                UInt*          puiAbsSum )
+{
+  //===== all luma blocks at once, the blocks do not depend on each other =====
+  UInt          uiCbp     = 0;
+  Int           iScalMat  = ( bTrafo8x8 ? ( rcMbTempData.isIntra() ? 6 : 7 ) : ( rcMbTempData.isIntra() ? 0 : 3 ) );
+  const UChar*  pucScale  = ( rcMbTempData.getSH().isScalingMatrixPresent(iScalMat) ? rcMbTempData.getSH().getScalingMatrix(iScalMat) : NULL );
+
+  if( bTrafo8x8 )
+  {
+    RNOK( m_pcTransform->transform8x8Mb( m_pcIntOrgMbPelData, rcMbTempData, rcMbTempData.get8x8( B8x8Idx() ), pucScale, puiAbsSum, uiCbp ) );
+  }
+  else
+  {
+    RNOK( m_pcTransform->transform4x4Mb( m_pcIntOrgMbPelData, rcMbTempData, rcMbTempData.get( B4x4Idx() ), pucScale, puiAbsSum, uiCbp ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+
 ErrVal
 MbEncoder::xEncode4x4InterBlock( IntMbTempData& rcMbTempData,
                                  LumaIdx        cIdx,
@@ -1632,7 +1711,6 @@ MbEncoder::xEncode4x4InterBlock( IntMbTempData& rcMbTempData,
   rcMbTempData.set4x4Block( cIdx );
   m_pcIntOrgMbPelData->set4x4Block( cIdx );
 
-  UInt uiBits = 0;
   UInt uiAbsSum = 0;
 
   Int           iScalMat  = ( rcMbTempData.isIntra() ? 0 : 3 );
@@ -1640,6 +1718,20 @@ MbEncoder::xEncode4x4InterBlock( IntMbTempData& rcMbTempData,
 
   RNOK( m_pcTransform->transform4x4Blk( m_pcIntOrgMbPelData, rcMbTempData, rcMbTempData.get( cIdx ), pucScale, uiAbsSum ) );
 
+  return xEncode4x4InterBlock( rcMbTempData, cIdx, uiAbsSum, ruiBits, ruiExtCbp );
+}
+
+
+
+ErrVal
+MbEncoder::xEncode4x4InterBlock( IntMbTempData& rcMbTempData,
+                                 LumaIdx        cIdx,
+                                 UInt           uiAbsSum,
+                                 UInt&          ruiBits,
+                                 UInt&          ruiExtCbp )
+{
+  UInt uiBits = 0;
+
   if( 0 == uiAbsSum )
   {
     ruiBits += 1;
@@ -1668,7 +1760,6 @@ MbEncoder::xEncode8x8InterBlock( IntMbTempData& rcMbTempData,
   rcMbTempData.set4x4Block( c8x8Idx );
   m_pcIntOrgMbPelData->set4x4Block( c8x8Idx );
 
-  UInt uiBits     = 0;
   UInt uiAbsSum   = 0;
 
   Int           iScalMat  = ( rcMbTempData.isIntra() ? 6 : 7 );
@@ -1676,6 +1767,20 @@ MbEncoder::xEncode8x8InterBlock( IntMbTempData& rcMbTempData,
 
   RNOK( m_pcTransform->transform8x8Blk( m_pcIntOrgMbPelData, rcMbTempData, rcMbTempData.get8x8( c8x8Idx ), pucScale, uiAbsSum ) );
 
+  return xEncode8x8InterBlock( rcMbTempData, c8x8Idx, uiAbsSum, ruiBits, ruiExtCbp );
+}
+
+
+
+ErrVal
+MbEncoder::xEncode8x8InterBlock( IntMbTempData& rcMbTempData,
+                                 B8x8Idx        c8x8Idx,
+                                 UInt           uiAbsSum,
+                                 UInt&          ruiBits,
+                                 UInt&          ruiExtCbp )
+{
+  UInt uiBits     = 0;
+
   if( 0 == uiAbsSum )
   {
     ruiBits += 1;
@@ -2543,6 +2648,9 @@ MbEncoder::xSetRdCostInterMb( IntMbTempData&  rcMbTempData,
   if( ! bSkipMode )
   {
     //--- LUMA ---
+    UInt auiAbsSum[16];
+    RNOK( xTransformLumaInter( rcMbTempData, false, auiAbsSum ) );
+
     for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
     {
       xSetCoeffCost( 0 );
@@ -2551,7 +2659,7 @@ MbEncoder::xSetRdCostInterMb( IntMbTempData&  rcMbTempData,
 
       for( S4x4Idx cIdx( c8x8Idx ); cIdx.isLegal( c8x8Idx ); cIdx++ )
       {
-        RNOK( xEncode4x4InterBlock( rcMbTempData, cIdx, uiBits, uiCbp ) );
+        RNOK( xEncode4x4InterBlock( rcMbTempData, cIdx, auiAbsSum[cIdx], uiBits, uiCbp ) );
       }
       if( uiCbp )
       {
@@ -2769,6 +2877,9 @@ MbEncoder::xSetRdCostInterMbSR( IntMbTempData&  rcMbTempData,
   if( ! bSkipMode )
   {
     //--- LUMA ---
+    UInt auiAbsSum[16];
+    RNOK( xTransformLumaInter( rcMbTempData, false, auiAbsSum ) );
+
     for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
     {
       xSetCoeffCost( 0 );
@@ -2777,7 +2888,7 @@ MbEncoder::xSetRdCostInterMbSR( IntMbTempData&  rcMbTempData,
 
       for( S4x4Idx cIdx( c8x8Idx ); cIdx.isLegal( c8x8Idx ); cIdx++ )
       {
-        RNOK( xEncode4x4InterBlock( rcMbTempData, cIdx, uiBits, uiCbp ) );
+        RNOK( xEncode4x4InterBlock( rcMbTempData, cIdx, auiAbsSum[cIdx], uiBits, uiCbp ) );
       }
       if( uiCbp )
       {
@@ -2990,13 +3101,16 @@ MbEncoder::xSetRdCost8x8InterMbSR ( IntMbTempData&  rcMbTempData,
   rcMbTempData.setTransformSize8x8( true );
 
   //--- LUMA ---
+  UInt auiAbsSum[4];
+  RNOK( xTransformLumaInter( rcMbTempData, true, auiAbsSum ) );
+
   for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
   {
     xSetCoeffCost( 0 );
     UInt  uiBits = 0;
     UInt  uiCbp  = 0;
 
-    RNOK( xEncode8x8InterBlock( rcMbTempData, c8x8Idx, uiBits, uiCbp ) );
+    RNOK( xEncode8x8InterBlock( rcMbTempData, c8x8Idx, auiAbsSum[c8x8Idx.b8x8Index()], uiBits, uiCbp ) );
     if( uiCbp )
     {
       if( xGetCoeffCost() <= 4 )
@@ -3172,13 +3286,16 @@ MbEncoder::xSetRdCost8x8InterMb ( IntMbTempData&  rcMbTempData,
   rcMbTempData.setTransformSize8x8( true );
 
   //--- LUMA ---
+  UInt auiAbsSum[4];
+  RNOK( xTransformLumaInter( rcMbTempData, true, auiAbsSum ) );
+
   for( B8x8Idx c8x8Idx; c8x8Idx.isLegal(); c8x8Idx++ )
   {
     xSetCoeffCost( 0 );
     UInt  uiBits = 0;
     UInt  uiCbp  = 0;
 
-    RNOK( xEncode8x8InterBlock( rcMbTempData, c8x8Idx, uiBits, uiCbp ) );
+    RNOK( xEncode8x8InterBlock( rcMbTempData, c8x8Idx, auiAbsSum[c8x8Idx.b8x8Index()], uiBits, uiCbp ) );
     if( uiCbp )
     {
       if( xGetCoeffCost() <= 4 && rcMbDataAccess.getSH().getQualityLevel() != 0 &&
@@ -5019,9 +5136,12 @@ MbEncoder::xEstimateMb8x8 ( IntMbTempData*&   rpcMbTempData,
 	if(m_bUseBDir)
     RNOK( xEstimateSubMbDirect  ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1, false,                                               uiBits,                      pcMbDataAccessBase ) );
     RNOK( xEstimateSubMb8x8     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1, false, bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
-    RNOK( xEstimateSubMb8x4     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1,        bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
-    RNOK( xEstimateSubMb4x8     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1,        bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
-    RNOK( xEstimateSubMb4x4     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1,        bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
+    if( ! m_bSubMb8x8Pruned )
+    {
+      RNOK( xEstimateSubMb8x4     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1,        bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
+      RNOK( xEstimateSubMb4x8     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1,        bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
+      RNOK( xEstimateSubMb4x4     ( ePar8x8, m_pcIntMbTemp8x8Data, m_pcIntMbBest8x8Data, rcRefFrameList0, rcRefFrameList1,        bBiPredOnly, uiNumMaxIter, uiIterSearchRange, uiBits, bQPelRefinementOnly, pcMbDataAccessBase ) );
+    }
 
     //----- store parameters in MbTempData -----
     rpcMbTempData->rdCost()  += m_pcIntMbBest8x8Data->rdCost    ();
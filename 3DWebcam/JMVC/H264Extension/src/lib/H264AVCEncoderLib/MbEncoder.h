@@ -263,8 +263,11 @@ protected:
   ErrVal  xEncodeChromaIntra        ( IntMbTempData& rcMbTempData, UInt& ruiExtCbp, UInt& ruiBits );
 
   ErrVal  xEncode4x4IntraBlock      ( IntMbTempData& rcMbTempData, LumaIdx cIdx,     UInt& ruiBits, UInt& ruiExtCbp );
+  ErrVal  xTransformLumaInter       ( IntMbTempData& rcMbTempData, Bool bTrafo8x8,   UInt* puiAbsSum );
   ErrVal  xEncode4x4InterBlock      ( IntMbTempData& rcMbTempData, LumaIdx cIdx,     UInt& ruiBits, UInt& ruiExtCbp );
+  ErrVal  xEncode4x4InterBlock      ( IntMbTempData& rcMbTempData, LumaIdx cIdx,     UInt uiAbsSum, UInt& ruiBits, UInt& ruiExtCbp );
   ErrVal  xEncode8x8InterBlock      ( IntMbTempData& rcMbTempData, B8x8Idx c8x8Idx,  UInt& ruiBits, UInt& ruiExtCbp );
+  ErrVal  xEncode8x8InterBlock      ( IntMbTempData& rcMbTempData, B8x8Idx c8x8Idx,  UInt uiAbsSum, UInt& ruiBits, UInt& ruiExtCbp );
   ErrVal  xEncode8x8IntraBlock      ( IntMbTempData& rcMbTempData, B8x8Idx cIdx,     UInt& ruiBits, UInt& ruiExtCbp );
   ErrVal  xEncodeChromaTexture      ( IntMbTempData& rcMbTempData, UInt& ruiExtCbp, UInt& ruiBits );
 
@@ -473,6 +476,7 @@ protected:
 
 
   UInt  xCalcMbCbp    ( UInt uiExtCbp );
+  Double  xGetQuantNoise( UInt uiQp ) const;
 
 private:
   UChar xGetFrameBits ( ListIdx eLstIdx, Int iRefPic );
@@ -529,6 +533,9 @@ protected:
   Bool		m_bUseBDir;
   //S051}
 
+  UInt    m_uiFastModeDecision;   // level of CodingParameter::getFastModeDecision()
+  Bool    m_bSubMb8x8Pruned;      // xEstimateMb8x8() only tests 8x8 sub-macroblocks
+
 };
 
 
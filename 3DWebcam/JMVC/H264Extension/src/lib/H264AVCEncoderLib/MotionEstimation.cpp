@@ -278,14 +278,29 @@ MotionEstimation::estimateBlockWithStart( const MbDataAccess&  rcMbDataAccess,
   xSetPredictor( rcMvPred );
   xSetCostScale( 2 );
 
+  //===== inter-view references of rectified views are only searched along the rows of the global disparity =====
+  Bool bEpipolarSearch = ( m_cParams.getDisparitySearchRows() && rcRefFrame.getViewId() != rcMbDataAccess.getSH().getViewId() );
+
   if( ! bQPelRefinementOnly )
   {
-    if( uiSearchRange )
+    if( bEpipolarSearch )
+    {
+      rcMbDataAccess.getMvPredictors( m_acMvPredictors );
+      xPelEpipolarSearch  ( pcRefPelData[0], cMv, uiMinSAD, rcRefFrame.getGlobalDisparity(), uiSearchRange );
+    }
+    else if( uiSearchRange )
     {
       xPelBlockSearch     ( pcRefPelData[0], cMv, uiMinSAD, uiSearchRange );
     }
     else
     {
+      //===== the coarse vector of the pyramid pre-pass replaces the start vector when it is better =====
+      if( rcRefFrame.getMotionSeeds() )
+      {
+        UInt uiMbIdx = rcMbDataAccess.getMbY() * rcMbDataAccess.getSH().getSPS().getFrameWidthInMbs() + rcMbDataAccess.getMbX();
+        xPelSeedStart( pcRefPelData[0], cMv, rcRefFrame.getMotionSeeds()[uiMbIdx] );
+      }
+
       switch( m_cParams.getSearchMode() )
       {
       case 0:
@@ -796,6 +811,131 @@ Void MotionEstimation::xPelLogSearch( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt
 
 
 
+Void MotionEstimation::xPelEpipolarSearch( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt& ruiSAD, const Mv& rcGlobalDisparity, UInt uiSearchRange )
+{
+  //===== uiSearchRange is given for the refinement of an iterative bi-predictive search, the start vector is close then =====
+  Bool bRefinement = ( 0 != uiSearchRange );
+  if( ! bRefinement ) { uiSearchRange = m_cParams.getSearchRange(); }
+
+  rcMv.limitComponents( m_cMin, m_cMax );
+  rcMv >>= 2;
+  SearchRect cSearchRect;
+  cSearchRect.init( uiSearchRange, rcMv, m_cMin, m_cMax );
+
+  //===== search band: all columns of the search window, DisparitySearchRows rows above and below the global disparity =====
+  Int iRows = (Int)m_cParams.getDisparitySearchRows();
+  Int iMinX = -cSearchRect.iNegHorLimit;
+  Int iMaxX =  cSearchRect.iPosHorLimit;
+  Int iMinY = max( -cSearchRect.iNegVerLimit, ( rcGlobalDisparity.getVer() >> 2 ) - iRows );
+  Int iMaxY = min(  cSearchRect.iPosVerLimit, ( rcGlobalDisparity.getVer() >> 2 ) + iRows );
+  if( iMinY > iMaxY )
+  {
+    // start vector far off the band, stay on its row
+    iMinY = iMaxY = rcMv.getVer();
+  }
+
+  IntTZSearchStrukt cStrukt;
+  cStrukt.iYStride    = pcPelData->getLStride();
+  cStrukt.iCStride    = pcPelData->getCStride();
+  m_cXDSS.iYStride    = cStrukt.iYStride;
+  m_cXDSS.iCStride    = cStrukt.iCStride;
+  cStrukt.pucYRef     = pcPelData->getLumBlk();
+  cStrukt.pucURef     = pcPelData->getCbBlk ();
+  cStrukt.pucVRef     = pcPelData->getCrBlk ();
+  cStrukt.uiBestSad   = MSYS_UINT_MAX;
+  cStrukt.iBestX      = min( max( rcMv.getHor(), iMinX ), iMaxX );
+  cStrukt.iBestY      = min( max( rcMv.getVer(), iMinY ), iMaxY );
+
+  //===== start points: start vector, neighbouring vectors and global disparity, moved into the band =====
+  xTZSearchHelp( cStrukt, cStrukt.iBestX, cStrukt.iBestY, 0, 0 );
+  if( ! bRefinement )
+  {
+    Mv acStart[4] = { m_acMvPredictors[0], m_acMvPredictors[1], m_acMvPredictors[2], rcGlobalDisparity };
+    for( UInt uiIndex = 0; uiIndex < 4; uiIndex++ )
+    {
+      acStart[uiIndex].limitComponents( m_cMin, m_cMax );
+      acStart[uiIndex] >>= 2;
+      xTZSearchHelp( cStrukt, min( max( (Int)acStart[uiIndex].getHor(), iMinX ), iMaxX ),
+                              min( max( (Int)acStart[uiIndex].getVer(), iMinY ), iMaxY ), 0, 0 );
+    }
+  }
+
+  //===== horizontal line search on the row of the best start point =====
+  for( Int iStep = ( bRefinement ? (Int)uiSearchRange >> 1 : 16 ); iStep > 0; iStep >>= 1 )
+  {
+    Int iStartX;
+    do
+    {
+      iStartX = cStrukt.iBestX;
+      if( iStartX - iStep >= iMinX ) { xTZSearchHelp( cStrukt, iStartX - iStep, cStrukt.iBestY, 0, 0 ); }
+      if( iStartX + iStep <= iMaxX ) { xTZSearchHelp( cStrukt, iStartX + iStep, cStrukt.iBestY, 0, 0 ); }
+    }
+    while( cStrukt.iBestX != iStartX );
+  }
+
+  //===== refinement over the rows of the band =====
+  Int iCenterX = cStrukt.iBestX;
+  Int iCenterY = cStrukt.iBestY;
+  for( Int y = iMinY; y <= iMaxY; y++ )
+  {
+    for( Int x = max( iCenterX - 1, iMinX ); x <= min( iCenterX + 1, iMaxX ); x++ )
+    {
+      if( x != iCenterX || y != iCenterY )
+      {
+        xTZSearchHelp( cStrukt, x, y, 0, 0 );
+      }
+    }
+  }
+
+  ruiSAD = cStrukt.uiBestSad - MotionEstimationCost::xGetCost( cStrukt.iBestX, cStrukt.iBestY );
+  rcMv.setHor( cStrukt.iBestX );
+  rcMv.setVer( cStrukt.iBestY );
+
+  DO_DBG( m_cXDSS.pYSearch = cStrukt.pucYRef + cStrukt.iBestY * cStrukt.iYStride + cStrukt.iBestX );
+  DO_DBG( m_cXDSS.pUSearch = cStrukt.pucURef + (cStrukt.iBestY>>1) * cStrukt.iCStride + (cStrukt.iBestX>>1) );
+  DO_DBG( m_cXDSS.pVSearch = cStrukt.pucVRef + (cStrukt.iBestY>>1) * cStrukt.iCStride + (cStrukt.iBestX>>1) );
+  AOF_DBG( ruiSAD == ( m_cXDSS.Func( &m_cXDSS ) ) );
+}
+
+
+Void MotionEstimation::xPelSeedStart( IntYuvPicBuffer *pcPelData, Mv& rcMv, MotionSeed& rcSeed )
+{
+  Mv cStart = rcMv;
+  Mv cSeed  = rcSeed.cMv;
+  cStart.limitComponents( m_cMin, m_cMax );
+  cSeed .limitComponents( m_cMin, m_cMax );
+  cStart >>= 2;
+  cSeed  >>= 2;
+
+  rcSeed.uiNumSearches++;
+  ROTVS( cStart == cSeed );
+
+  IntTZSearchStrukt cStrukt;
+  cStrukt.iYStride    = pcPelData->getLStride();
+  cStrukt.iCStride    = pcPelData->getCStride();
+  m_cXDSS.iYStride    = cStrukt.iYStride;
+  m_cXDSS.iCStride    = cStrukt.iCStride;
+  cStrukt.pucYRef     = pcPelData->getLumBlk();
+  cStrukt.pucURef     = pcPelData->getCbBlk ();
+  cStrukt.pucVRef     = pcPelData->getCrBlk ();
+  cStrukt.uiBestSad   = MSYS_UINT_MAX;
+  cStrukt.iBestX      = cStart.getHor();
+  cStrukt.iBestY      = cStart.getVer();
+
+  //===== the start vector is checked first and wins ties =====
+  xTZSearchHelp( cStrukt, cStart.getHor(), cStart.getVer(), 0, 0 );
+  xTZSearchHelp( cStrukt, cSeed .getHor(), cSeed .getVer(), 0, 0 );
+
+  if( cStrukt.iBestX == cSeed.getHor() && cStrukt.iBestY == cSeed.getVer() )
+  {
+    rcMv = cSeed << 2;
+    rcSeed.uiNumWins++;
+  }
+}
+
+
+
+
 #define TZ_SEARCH_CONFIGURATION                                                                                 \
   const Int  iRaster                  = 3;  /* TZ soll von aussen bergeben werden */                           \
   const Bool bTestOtherPredictedMV    = 1;                                                                      \
@@ -146,6 +146,8 @@ protected:
   Void          xPelBlockSearch ( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt& ruiSAD,                              UInt uiSearchRange = 0 );
   Void          xPelSpiralSearch( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt& ruiSAD,                              UInt uiSearchRange = 0 );
   Void          xPelLogSearch   ( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt& ruiSAD, Bool bFme,  UInt uiStep = 4, UInt uiSearchRange = 0 );
+  Void          xPelEpipolarSearch( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt& ruiSAD, const Mv& rcGlobalDisparity, UInt uiSearchRange = 0 );
+  Void          xPelSeedStart   ( IntYuvPicBuffer *pcPelData, Mv& rcMv, MotionSeed& rcSeed );
   virtual Void  xSubPelSearch   ( IntYuvPicBuffer *pcPelData, Mv& rcMv, UInt& ruiSAD, UInt uiBlk, UInt uiMode,     Bool bQPelOnly ) = 0;
 
 //TMM_WP
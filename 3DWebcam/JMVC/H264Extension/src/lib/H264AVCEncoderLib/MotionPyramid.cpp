@@ -0,0 +1,313 @@
+#include "H264AVCEncoderLib.h"
+#include "MotionPyramid.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+//===== downsampling filter of the DownConvert tool (FILTER_DOWN), 15 taps and their sum =====
+static const Int g_aiDownFilter[16] = { 0, 2, 0, -4, -3, 5, 19, 26, 19, 5, -3, -4, 0, 2, 0, 64 };
+
+
+MotionPyramid::MotionPyramid():
+  m_uiWidthInMbs  ( 0 ),
+  m_uiHeightInMbs ( 0 ),
+  m_iSearchRange  ( 0 ),
+  m_piTmpBuffer   ( NULL ),
+  m_uiNumRefs     ( 0 ),
+  m_uiNumSearches ( 0 ),
+  m_uiNumSeedWins ( 0 ),
+  m_bInitDone     ( false )
+{
+  m_apOrg[0] = m_apOrg[1] = NULL;
+  for( UInt uiRef = 0; uiRef < MAX_REFS; uiRef++ )
+  {
+    m_aapRef    [uiRef][0]  = m_aapRef[uiRef][1] = NULL;
+    m_apcRefFrame[uiRef]    = NULL;
+    m_apcSeeds  [uiRef]     = NULL;
+  }
+}
+
+
+MotionPyramid::~MotionPyramid()
+{
+}
+
+
+ErrVal
+MotionPyramid::create( MotionPyramid*& rpcMotionPyramid )
+{
+  rpcMotionPyramid = new MotionPyramid;
+  ROT( NULL == rpcMotionPyramid );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MotionPyramid::destroy()
+{
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MotionPyramid::init( UInt uiFrameWidthInMbs,
+                     UInt uiFrameHeightInMbs,
+                     UInt uiSearchRange )
+{
+  ROT( m_bInitDone );
+  ROF( uiFrameWidthInMbs && uiFrameHeightInMbs );
+
+  m_uiWidthInMbs  = uiFrameWidthInMbs;
+  m_uiHeightInMbs = uiFrameHeightInMbs;
+  m_iSearchRange  = max( 4, (Int)uiSearchRange );
+  m_uiNumRefs     = 0;
+  m_uiNumSearches = 0;
+  m_uiNumSeedWins = 0;
+
+  UInt uiWidth    = 16 * m_uiWidthInMbs;
+  UInt uiHeight   = 16 * m_uiHeightInMbs;
+  ROFS( ( m_piTmpBuffer = new Int   [ ( uiWidth / 2 ) * uiHeight ] ) );
+  ROFS( ( m_apOrg[0]    = new XPel  [ ( uiWidth / 2 ) * ( uiHeight / 2 ) ] ) );
+  ROFS( ( m_apOrg[1]    = new XPel  [ ( uiWidth / 4 ) * ( uiHeight / 4 ) ] ) );
+
+  m_bInitDone = true;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MotionPyramid::uninit()
+{
+  ROF( m_bInitDone );
+
+  RNOK( finishPicture() );
+
+  for( UInt uiRef = 0; uiRef < MAX_REFS; uiRef++ )
+  {
+    delete [] m_aapRef[uiRef][0];
+    delete [] m_aapRef[uiRef][1];
+    delete [] m_apcSeeds[uiRef];
+    m_aapRef  [uiRef][0]  = m_aapRef[uiRef][1] = NULL;
+    m_apcSeeds[uiRef]     = NULL;
+  }
+  delete [] m_apOrg[0];
+  delete [] m_apOrg[1];
+  delete [] m_piTmpBuffer;
+  m_apOrg[0]    = m_apOrg[1] = NULL;
+  m_piTmpBuffer = NULL;
+
+  m_bInitDone = false;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MotionPyramid::initPicture( IntFrame*     pcFrame,
+                            RefFrameList& rcList0,
+                            RefFrameList& rcList1 )
+{
+  ROF( m_bInitDone );
+  ROF( pcFrame );
+  RNOK( finishPicture() );
+
+  //===== original picture =====
+  IntYuvPicBuffer* pcOrgBuffer  = pcFrame->getFullPelYuvBuffer();
+  Int              iWidth       = 16 * m_uiWidthInMbs;
+  Int              iHeight      = 16 * m_uiHeightInMbs;
+  xDownsample( pcOrgBuffer->getLumOrigin(), pcOrgBuffer->getLStride(), iWidth,     iHeight,     m_apOrg[0] );
+  xDownsample( m_apOrg[0],                  iWidth / 2,                iWidth / 2, iHeight / 2, m_apOrg[1] );
+
+  //===== references, a picture that is in both lists is searched once =====
+  UInt uiPos;
+  for( uiPos = 0; uiPos < rcList0.getActive(); uiPos++ )
+  {
+    RNOK( xAddReference( rcList0.getEntry( uiPos ) ) );
+  }
+  for( uiPos = 0; uiPos < rcList1.getActive(); uiPos++ )
+  {
+    RNOK( xAddReference( rcList1.getEntry( uiPos ) ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MotionPyramid::finishPicture()
+{
+  for( UInt uiRef = 0; uiRef < m_uiNumRefs; uiRef++ )
+  {
+    //----- statistics of MotionEstimation -----
+    for( UInt uiMb = 0; uiMb < m_uiWidthInMbs * m_uiHeightInMbs; uiMb++ )
+    {
+      m_uiNumSearches += m_apcSeeds[uiRef][uiMb].uiNumSearches;
+      m_uiNumSeedWins += m_apcSeeds[uiRef][uiMb].uiNumWins;
+    }
+    m_apcRefFrame[uiRef]->setMotionSeeds( NULL );
+    m_apcRefFrame[uiRef] = NULL;
+  }
+  m_uiNumRefs = 0;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+MotionPyramid::xAddReference( IntFrame* pcRefFrame )
+{
+  ROF( pcRefFrame );
+  for( UInt uiRef = 0; uiRef < m_uiNumRefs; uiRef++ )
+  {
+    ROTRS( m_apcRefFrame[uiRef] == pcRefFrame, Err::m_nOK );
+  }
+  ROT( m_uiNumRefs == MAX_REFS );
+
+  UInt  uiRef   = m_uiNumRefs++;
+  Int   iWidth  = 16 * m_uiWidthInMbs;
+  Int   iHeight = 16 * m_uiHeightInMbs;
+  if( NULL == m_apcSeeds[uiRef] )
+  {
+    ROFS( ( m_aapRef[uiRef][0]  = new XPel        [ ( iWidth / 2 ) * ( iHeight / 2 ) ] ) );
+    ROFS( ( m_aapRef[uiRef][1]  = new XPel        [ ( iWidth / 4 ) * ( iHeight / 4 ) ] ) );
+    ROFS( ( m_apcSeeds[uiRef]   = new MotionSeed  [ m_uiWidthInMbs * m_uiHeightInMbs ] ) );
+  }
+  m_apcRefFrame[uiRef] = pcRefFrame;
+
+  IntYuvPicBuffer* pcRefBuffer = pcRefFrame->getFullPelYuvBuffer();
+  xDownsample( pcRefBuffer->getLumOrigin(), pcRefBuffer->getLStride(), iWidth,     iHeight,     m_aapRef[uiRef][0] );
+  xDownsample( m_aapRef[uiRef][0],          iWidth / 2,                iWidth / 2, iHeight / 2, m_aapRef[uiRef][1] );
+  xSearchMbs ( uiRef );
+
+  pcRefFrame->setMotionSeeds( m_apcSeeds[uiRef] );
+
+  return Err::m_nOK;
+}
+
+
+Void
+MotionPyramid::xDownsample( const XPel* pSrc,
+                            Int         iSrcStride,
+                            Int         iSrcWidth,
+                            Int         iSrcHeight,
+                            XPel*       pDes )
+{
+  //===== separable 2:1 decimation as DownConvert::xDownsampling(), samples outside the picture repeat the border =====
+  Int iDesWidth   = iSrcWidth  / 2;
+  Int iDesHeight  = iSrcHeight / 2;
+  Int iDiv        = g_aiDownFilter[15] * g_aiDownFilter[15];
+  Int x, y, k;
+
+  for( y = 0; y < iSrcHeight; y++, pSrc += iSrcStride )
+  {
+    Int* piTmp = m_piTmpBuffer + y * iDesWidth;
+    for( x = 0; x < iDesWidth; x++ )
+    {
+      Int iSum = 0;
+      for( k = 0; k < 15; k++ )
+      {
+        iSum += g_aiDownFilter[k] * pSrc[ max( 0, min( iSrcWidth - 1, 2 * x + k - 7 ) ) ];
+      }
+      piTmp[x] = iSum;
+    }
+  }
+
+  for( y = 0; y < iDesHeight; y++, pDes += iDesWidth )
+  {
+    for( x = 0; x < iDesWidth; x++ )
+    {
+      Int iSum = 0;
+      for( k = 0; k < 15; k++ )
+      {
+        iSum += g_aiDownFilter[k] * m_piTmpBuffer[ max( 0, min( iSrcHeight - 1, 2 * y + k - 7 ) ) * iDesWidth + x ];
+      }
+      pDes[x] = (XPel)max( 0, min( 255, ( iSum + iDiv / 2 ) / iDiv ) );
+    }
+  }
+}
+
+
+UInt
+MotionPyramid::xGetSad( const XPel* pOrg,
+                        const XPel* pRef,
+                        Int         iStride,
+                        Int         iSize )
+{
+  UInt uiSad = 0;
+  for( Int y = 0; y < iSize; y++, pOrg += iStride, pRef += iStride )
+  {
+    for( Int x = 0; x < iSize; x++ )
+    {
+      uiSad += abs( pOrg[x] - pRef[x] );
+    }
+  }
+  return uiSad;
+}
+
+
+Void
+MotionPyramid::xSearchMbs( UInt uiRef )
+{
+  Int iWidth2   = 4 * m_uiWidthInMbs;
+  Int iHeight2  = 4 * m_uiHeightInMbs;
+  Int iRange2   = m_iSearchRange / 4;
+
+  for( UInt uiMbY = 0; uiMbY < m_uiHeightInMbs; uiMbY++ )
+  for( UInt uiMbX = 0; uiMbX < m_uiWidthInMbs;  uiMbX++ )
+  {
+    //===== full search of the 4x4 block at quarter resolution, a small penalty on the vector length prefers short vectors =====
+    Int         iX        = 4 * uiMbX;
+    Int         iY        = 4 * uiMbY;
+    const XPel* pOrg      = m_apOrg[1] + iY * iWidth2 + iX;
+    UInt        uiBestSad = MSYS_UINT_MAX;
+    Int         iBestX    = 0;
+    Int         iBestY    = 0;
+    Int         iDX, iDY;
+
+    for( iDY = max( -iRange2, -iY ); iDY <= min( iRange2, iHeight2 - 4 - iY ); iDY++ )
+    for( iDX = max( -iRange2, -iX ); iDX <= min( iRange2, iWidth2  - 4 - iX ); iDX++ )
+    {
+      UInt uiSad = xGetSad( pOrg, m_aapRef[uiRef][1] + ( iY + iDY ) * iWidth2 + iX + iDX, iWidth2, 4 )
+                 + abs( iDX ) + abs( iDY );
+      if( uiSad < uiBestSad )
+      {
+        uiBestSad = uiSad;
+        iBestX    = iDX;
+        iBestY    = iDY;
+      }
+    }
+
+    //===== refinement of the 8x8 block at half resolution =====
+    Int iWidth1   = 2 * iWidth2;
+    Int iHeight1  = 2 * iHeight2;
+    Int iCenterX  = 2 * iBestX;
+    Int iCenterY  = 2 * iBestY;
+    iX            = 8 * uiMbX;
+    iY            = 8 * uiMbY;
+    pOrg          = m_apOrg[0] + iY * iWidth1 + iX;
+    uiBestSad     = MSYS_UINT_MAX;
+
+    for( iDY = max( iCenterY - 2, -iY ); iDY <= min( iCenterY + 2, iHeight1 - 8 - iY ); iDY++ )
+    for( iDX = max( iCenterX - 2, -iX ); iDX <= min( iCenterX + 2, iWidth1  - 8 - iX ); iDX++ )
+    {
+      UInt uiSad = xGetSad( pOrg, m_aapRef[uiRef][0] + ( iY + iDY ) * iWidth1 + iX + iDX, iWidth1, 8 );
+      if( uiSad < uiBestSad )
+      {
+        uiBestSad = uiSad;
+        iBestX    = iDX;
+        iBestY    = iDY;
+      }
+    }
+
+    MotionSeed& rcSeed  = m_apcSeeds[uiRef][ uiMbY * m_uiWidthInMbs + uiMbX ];
+    rcSeed.cMv          = Mv( (Short)( 8 * iBestX ), (Short)( 8 * iBestY ) );
+    rcSeed.uiNumSearches = 0;
+    rcSeed.uiNumWins    = 0;
+  }
+}
+
+
+H264AVC_NAMESPACE_END
@@ -0,0 +1,76 @@
+#if !defined(AFX_MOTIONPYRAMID_H__8C2A4F1E_6D3B_4E97_B5A0_1F7E92C4D863__INCLUDED_)
+#define AFX_MOTIONPYRAMID_H__8C2A4F1E_6D3B_4E97_B5A0_1F7E92C4D863__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "H264AVCCommonLib/IntFrame.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+//===== hierarchical motion search pre-pass: the original picture and its references are downsampled by 2 and 4, a full    =====
+//===== search of every macroblock at quarter resolution is refined at half resolution, and the resulting coarse vectors   =====
+//===== are attached to the references (IntFrame::getMotionSeeds) as start candidates of MotionEstimation                   =====
+class MotionPyramid
+{
+  enum { MAX_REFS = 32 };   // distinct reference pictures of one picture
+
+protected:
+  MotionPyramid();
+  virtual ~MotionPyramid();
+
+public:
+  static ErrVal create( MotionPyramid*& rpcMotionPyramid );
+  ErrVal destroy();
+
+  //===== uiSearchRange is the range of the coarse search in full resolution samples =====
+  ErrVal init( UInt uiFrameWidthInMbs,
+               UInt uiFrameHeightInMbs,
+               UInt uiSearchRange );
+  ErrVal uninit();
+
+  //===== pcFrame must still hold the original picture; the references must stay in the lists until finishPicture() =====
+  ErrVal initPicture  ( IntFrame*     pcFrame,
+                        RefFrameList& rcList0,
+                        RefFrameList& rcList1 );
+  ErrVal finishPicture();
+
+  UInt   getNumSearches ()  const { return m_uiNumSearches; }
+  UInt   getNumSeedWins ()  const { return m_uiNumSeedWins; }
+
+protected:
+  ErrVal xAddReference  ( IntFrame*     pcRefFrame );
+  Void   xDownsample    ( const XPel*   pSrc,
+                          Int           iSrcStride,
+                          Int           iSrcWidth,
+                          Int           iSrcHeight,
+                          XPel*         pDes );
+  Void   xSearchMbs     ( UInt          uiRef );
+  UInt   xGetSad        ( const XPel*   pOrg,
+                          const XPel*   pRef,
+                          Int           iStride,
+                          Int           iSize );
+
+protected:
+  UInt          m_uiWidthInMbs;
+  UInt          m_uiHeightInMbs;
+  Int           m_iSearchRange;
+  Int*          m_piTmpBuffer;                  // rows of the horizontal filter pass
+  XPel*         m_apOrg     [2];                // original picture at half and quarter resolution
+  XPel*         m_aapRef    [MAX_REFS][2];      // references at half and quarter resolution
+  IntFrame*     m_apcRefFrame[MAX_REFS];
+  MotionSeed*   m_apcSeeds  [MAX_REFS];
+  UInt          m_uiNumRefs;
+  UInt          m_uiNumSearches;
+  UInt          m_uiNumSeedWins;
+  Bool          m_bInitDone;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_MOTIONPYRAMID_H__8C2A4F1E_6D3B_4E97_B5A0_1F7E92C4D863__INCLUDED_)
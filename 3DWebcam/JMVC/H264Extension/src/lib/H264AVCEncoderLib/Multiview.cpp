@@ -42,12 +42,32 @@ static void ShowFrameInfo(ostream & outputStream, const char*const msg,
 MultiviewReferencePictureManager::MultiviewReferenceInfo::MultiviewReferenceInfo(
  const YUVFileParams& fileParams, ReadYuvFile*const reader) 
   : _fileParams(fileParams), 
-    _fileReader(reader) {
+    _fileReader(reader),
+    _readBuffer(NULL),
+    _store(NULL) {
+}
+
+MultiviewReferencePictureManager::MultiviewReferenceInfo::MultiviewReferenceInfo(
+ const YUVFileParams& fileParams, MultiviewReferenceStore*const store) 
+  : _fileParams(fileParams), 
+    _fileReader(NULL),
+    _readBuffer(NULL),
+    _store(store) {
 }
 
 MultiviewReferencePictureManager::MultiviewReferenceInfo::~MultiviewReferenceInfo() {
-  _fileReader->uninit();
-  _fileReader->destroy();
+  if (_fileReader) {
+    _fileReader->uninit();
+    _fileReader->destroy();
+  }
+  if (_readBuffer) {
+    delete [] _readBuffer->getBuffer();
+    delete _readBuffer;
+  }
+  while (! _picturesToRelease.empty()) {
+    _store->release(_fileParams._view_id, _picturesToRelease.back());
+    _picturesToRelease.pop_back();
+  }
 
   while (! _referencePicsToRemove.empty()) {
     _referencePicsToRemove.back()->uninit();
@@ -71,11 +91,13 @@ MultiviewReferencePictureManager::MultiviewReferenceInfo::~MultiviewReferenceInf
 //
 //		verbose: A flag indicating whether to print debug info.
 //
-// RETURNS:	A new'ly allocated PicBuffer object containing the
-//		desired frame.  It is the caller's responsibility to
-//		delete the PicBuffer when finished.
+//		picture: The PicBuffer to read into, NULL the first
+//			 time.  It is allocated once and then reused,
+//			 the caller deletes it when finished.
+//
+// RETURNS:	The PicBuffer object containing the desired frame.
 //
-// PURPOSE:	Read a frame from a YUV file into a new PicBuffer.
+// PURPOSE:	Read a frame from a YUV file into a PicBuffer.
 //
 // MODIFIED:	Tue Mar 14, 2006
 //
@@ -84,13 +106,15 @@ MultiviewReferencePictureManager::MultiviewReferenceInfo::~MultiviewReferenceInf
 
 PicBuffer* ReadMultiviewReferencePictureFromStreamIntoPicBuffer
 (ReadYuvFile* reader, const YUVFileParams& fileParams, 
- const int pictureOrderCount, const bool verbose) {
+ const int pictureOrderCount, const bool verbose, PicBuffer* picture) {
 
 //  if (verbose) 
  //   cout << "Going to read frame "<< pictureOrderCount <<" for multivew ref\n";
 
-  UChar* buffer = new UChar[ fileParams._bufSize ];
-  PicBuffer* newPicture = new PicBuffer(buffer);
+  PicBuffer* newPicture = picture;
+  if (! newPicture)
+    newPicture = new PicBuffer(new UChar[ fileParams._bufSize ]);
+  UChar* buffer = newPicture->getBuffer();
 
   reader->GoToFrame(pictureOrderCount);
   if( ERR_CLASS::m_nOK != 
@@ -207,6 +231,48 @@ void MultiviewReferencePictureManager::AddVectorOfFilesToUseAsReference
     AddViewFileToUseAsReference(vectorOfReferenceFiles[i]);
 }
 
+// ----------------------------------------------------------------------
+//
+// FUNCTION:	AddViewToUseAsReference
+//
+// INPUTS:	paramsForMultiviewReference:  A YUVFileParams object
+//					      describing the reference view.
+//					      Only _view_id is used, the
+//					      file is never opened.
+//
+//		referenceStore:  The MultiviewReferenceStore the encoder
+//				 of the reference view publishes its
+//				 reconstructed pictures to.
+//
+// PURPOSE:	Same as AddViewFileToUseAsReference when all views are
+//		encoded in the same process: the reference pictures are
+//		taken from referenceStore instead of the reconstructed
+//		YUV file of the reference view.
+//
+// ----------------------------------------------------------------------
+
+
+void MultiviewReferencePictureManager::AddViewToUseAsReference
+(const YUVFileParams& paramsForMultiviewReference,
+ MultiviewReferenceStore* referenceStore) {
+
+  referenceStore->addDependentView(paramsForMultiviewReference._view_id);
+
+  _references.push_back(new MultiviewReferenceInfo
+			(paramsForMultiviewReference,
+			 referenceStore));
+}
+
+void MultiviewReferencePictureManager::AddVectorOfViewsToUseAsReference
+(const vector<YUVFileParams>& vectorOfReferenceViews,
+ MultiviewReferenceStore* referenceStore) {
+  
+  UInt i;
+  
+  for (i=0; i < vectorOfReferenceViews.size(); i++) 
+    AddViewToUseAsReference(vectorOfReferenceViews[i], referenceStore);
+}
+
 
 // ----------------------------------------------------------------------
 //
@@ -228,14 +294,20 @@ void MultiviewReferencePictureManager::AddVectorOfFilesToUseAsReference
 // PURPOSE:	This method goes through each file that has been
 //		registered via AddViewFileToUseAsReference, reads in
 //		frame number pictureOrderCount, and inserts that into
-//		the prediction buffer.
+//		the prediction buffer.  Views registered via
+//		AddViewToUseAsReference are taken from their
+//		MultiviewReferenceStore, waiting until the picture has
+//		been reconstructed.  Their samples are borrowed, not
+//		copied, and the picture is released again when it is
+//		removed from the buffer or when it is not used by the
+//		current picture.
 //
 // MODIFIED:	Wed Mar 15, 2006
 //
 // ----------------------------------------------------------------------
 
 
-void MultiviewReferencePictureManager::AddMultiviewReferencesPicturesToBuffer
+ErrVal MultiviewReferencePictureManager::AddMultiviewReferencesPicturesToBuffer
 (RecPicBuffer* pcRecPicBuffer,  SliceHeader* pcSliceHeader,
  PicBufferList& rcOutputList, PicBufferList& rcUnusedList, 
  const SequenceParameterSet & pcSPS, const int pictureOrderCount, const Bool IsAnchor) {
@@ -279,21 +351,36 @@ void MultiviewReferencePictureManager::AddMultiviewReferencesPicturesToBuffer
 				_references[i]->_referenceDirection = BACKWARD;		
 			}
 	}
+	MultiviewReferenceStore* store = _references[i]->_store;
 	if (used_for_ref == false)
+	{
+		if (store)
+			store->release(_references[i]->_fileParams._view_id, pictureOrderCount);
 		continue;
+	}
 
     RecPicBufUnit* newRecPicBufUnit;
     
-    PicBuffer* newPic=ReadMultiviewReferencePictureFromStreamIntoPicBuffer
-      (_references[i]->_fileReader, _references[i]->_fileParams, 
-       pictureOrderCount, _verbose);
-    
     pcSliceHeader->setNalUnitType(NAL_UNIT_CODED_SLICE);
     pcSliceHeader->setNalRefIdc(NAL_REF_IDC_PRIORITY_LOW);
     pcSliceHeader->setInterViewRef(true);
-    pcRecPicBuffer->initCurrRecPicBufUnit
-      ( newRecPicBufUnit, newPic, pcSliceHeader, rcOutputList, rcUnusedList,
-	_references[i]->_referenceDirection);
+
+    if (store) {
+      IntFrame* refViewFrame=NULL;
+      RNOK( store->wait(_references[i]->_fileParams._view_id, pictureOrderCount, refViewFrame) );
+      _references[i]->_picturesToRelease.push_back(pictureOrderCount);
+      RNOK( pcRecPicBuffer->initCurrRecPicBufUnit
+        ( newRecPicBufUnit, refViewFrame, pcSliceHeader,
+          _references[i]->_referenceDirection) );
+    }
+    else {
+      _references[i]->_readBuffer=ReadMultiviewReferencePictureFromStreamIntoPicBuffer
+        (_references[i]->_fileReader, _references[i]->_fileParams, 
+         pictureOrderCount, _verbose, _references[i]->_readBuffer);
+      pcRecPicBuffer->initCurrRecPicBufUnit
+        ( newRecPicBufUnit, _references[i]->_readBuffer, pcSliceHeader, rcOutputList, rcUnusedList,
+	  _references[i]->_referenceDirection);
+    }
     
     pcRecPicBuffer->store( newRecPicBufUnit, pcSliceHeader, 
 			   rcOutputList, rcUnusedList, 
@@ -307,13 +394,9 @@ void MultiviewReferencePictureManager::AddMultiviewReferencesPicturesToBuffer
     _references[i]->_referencePicsToRemove.push_back(newRecPicBufUnit);
     
 //    if (_verbose) ShowFrameInfo(cout,"Added frame", newRecPicBufUnit);
-    
-	delete [] newPic->getBuffer();
-	delete newPic;
   }
 
-  
-
+  return Err::m_nOK;
  }
 
 int MultiviewReferencePictureManager::CountNumMultiviewReferenceStreams()const
@@ -332,7 +415,8 @@ int MultiviewReferencePictureManager::CountNumMultiviewReferenceStreams()const
 // FUNCTION:	RemoveMultiviewReferencesPicturesFromBuffer
 //
 // PURPOSE:	Remove the multiview reference pictures we have
-//		inserted.
+//		inserted and release the borrowed ones to their
+//		MultiviewReferenceStore.
 //
 // MODIFIED:	Wed Mar 15, 2006
 //
@@ -357,6 +441,12 @@ void MultiviewReferencePictureManager::RemoveMultiviewReferencesPicturesFromBuff
       pcRecPicBuffer->RemoveMultiviewRef(unitToRemove);
       _references[i]->_referencePicsToRemove.pop_back();
     }
+    //----- the reference view may reuse the pictures from now on -----
+    while (! _references[i]->_picturesToRelease.empty()) {
+      _references[i]->_store->release(_references[i]->_fileParams._view_id,
+				      _references[i]->_picturesToRelease.back());
+      _references[i]->_picturesToRelease.pop_back();
+    }
   }
 }
 
@@ -8,6 +8,7 @@
 //#undef min
 #include <vector>
 #include <string>
+#include <map>
 
 #include "H264AVCVideoIoLib.h"
 #include "H264AVCEncoderLib.h"
@@ -19,6 +20,7 @@
 #include "WriteBitstreamToFile.h"
 #include "YUVFileParams.h"
 #include "RecPicBuffer.h"
+#include "MultiviewReferenceStore.h"
 
 using namespace std;
 
@@ -60,8 +62,16 @@ public:
 
   void AddVectorOfFilesToUseAsReference
   (const vector<YUVFileParams>& vectorOfReferenceFiles);
+
+  void AddViewToUseAsReference
+  (const YUVFileParams& paramsForMultiviewReference,
+   MultiviewReferenceStore* referenceStore);
+
+  void AddVectorOfViewsToUseAsReference
+  (const vector<YUVFileParams>& vectorOfReferenceViews,
+   MultiviewReferenceStore* referenceStore);
   
-  void AddMultiviewReferencesPicturesToBuffer
+  ErrVal AddMultiviewReferencesPicturesToBuffer
   (RecPicBuffer* m_pcRecPicBuffer, SliceHeader* pcSliceHeader,
    PicBufferList& rcOutputList, PicBufferList& rcUnusedList, 
    const SequenceParameterSet & pcSPS, const int pictureOrderCount, const Bool IsAnchor);
@@ -104,6 +114,9 @@ public:
   
   MultiviewReferenceInfo
   (const YUVFileParams& fileParams, ReadYuvFile*const reader);
+
+  MultiviewReferenceInfo
+  (const YUVFileParams& fileParams, MultiviewReferenceStore*const store);
   
   ~MultiviewReferenceInfo();
 
@@ -112,7 +125,10 @@ public:
   MultiviewReferenceDirection _referenceDirection;
   YUVFileParams               _fileParams;
   ReadYuvFile*                _fileReader;
+  PicBuffer*                  _readBuffer;        // reused for every frame read from _fileReader
+  MultiviewReferenceStore*    _store;
   vector<RecPicBufUnit*>      _referencePicsToRemove;
+  vector<int>                 _picturesToRelease; // borrowed from _store until removed
   
 };
 
@@ -0,0 +1,231 @@
+#if defined( WIN32 )
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include <cstdio>
+#include "H264AVCEncoderLib.h"
+#include "H264AVCCommonLib.h"
+#include "H264AVCCommonLib/IntFrame.h"
+#include "MultiviewReferenceStore.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+//===== the views waiting for a picture sleep until publish(), release() or abort() signal them =====
+#if defined( WIN32 )
+struct MultiviewReferenceStoreSync {
+  MultiviewReferenceStoreSync()  { InitializeCriticalSection( &cMutex ); InitializeConditionVariable( &cCondition ); }
+  ~MultiviewReferenceStoreSync() { DeleteCriticalSection( &cMutex ); }
+  Void lock       () { EnterCriticalSection( &cMutex ); }
+  Void unlock     () { LeaveCriticalSection( &cMutex ); }
+  Void sleep      () { SleepConditionVariableCS( &cCondition, &cMutex, INFINITE ); }
+  Void wakeAll    () { WakeAllConditionVariable( &cCondition ); }
+
+  CRITICAL_SECTION    cMutex;
+  CONDITION_VARIABLE  cCondition;
+};
+#else
+struct MultiviewReferenceStoreSync {
+  MultiviewReferenceStoreSync()  { pthread_mutex_init( &cMutex, NULL ); pthread_cond_init( &cCondition, NULL ); }
+  ~MultiviewReferenceStoreSync() { pthread_cond_destroy( &cCondition ); pthread_mutex_destroy( &cMutex ); }
+  Void lock       () { pthread_mutex_lock( &cMutex ); }
+  Void unlock     () { pthread_mutex_unlock( &cMutex ); }
+  Void sleep      () { pthread_cond_wait( &cCondition, &cMutex ); }
+  Void wakeAll    () { pthread_cond_broadcast( &cCondition ); }
+
+  pthread_mutex_t     cMutex;
+  pthread_cond_t      cCondition;
+};
+#endif
+
+#define SYNC ( (MultiviewReferenceStoreSync*) m_pvSync )
+
+
+MultiviewReferenceStore::MultiviewReferenceStore()
+: m_bAborted    ( false )
+, m_uiNumRemoved( 0 )
+, m_pvSync    ( new MultiviewReferenceStoreSync )
+{
+}
+
+MultiviewReferenceStore::~MultiviewReferenceStore()
+{
+  delete SYNC;
+}
+
+ErrVal
+MultiviewReferenceStore::create( MultiviewReferenceStore*& rpcMultiviewReferenceStore )
+{
+  rpcMultiviewReferenceStore = new MultiviewReferenceStore;
+  ROT( NULL == rpcMultiviewReferenceStore );
+  return Err::m_nOK;
+}
+
+ErrVal
+MultiviewReferenceStore::destroy()
+{
+  delete this;
+  return Err::m_nOK;
+}
+
+Void
+MultiviewReferenceStore::addDependentView( UInt uiRefViewId )
+{
+  SYNC->lock();
+  m_cNumDependentViews[uiRefViewId]++;
+  SYNC->unlock();
+}
+
+Bool
+MultiviewReferenceStore::hasDependentViews( UInt uiViewId )
+{
+  SYNC->lock();
+  Bool bDependentViews = ( m_cNumDependentViews.find( uiViewId ) != m_cNumDependentViews.end() );
+  SYNC->unlock();
+  return bDependentViews;
+}
+
+ErrVal
+MultiviewReferenceStore::publish( UInt uiViewId, UInt uiPoc, IntFrame* pcFrame )
+{
+  ROF( pcFrame );
+
+  SYNC->lock();
+  //===== nothing to do when no other view predicts from this one =====
+  if( m_cNumDependentViews.find( uiViewId ) == m_cNumDependentViews.end() )
+  {
+    SYNC->unlock();
+    return Err::m_nOK;
+  }
+
+  StoredPicture& rcEntry          = xGetEntry( uiViewId, uiPoc );
+  Bool           bPublishedTwice  = ( NULL != rcEntry.pcFrame );
+  if( ! bPublishedTwice )
+  {
+    rcEntry.pcFrame = pcFrame;
+  }
+  //===== already released by all dependent views, the picture is not lent =====
+  if( ! rcEntry.uiPendingReleases )
+  {
+    xRemoveEntry( m_cPictures.find( PictureKey( uiViewId, uiPoc ) ) );
+  }
+  SYNC->wakeAll();
+  SYNC->unlock();
+
+  ROT( bPublishedTwice );
+  return Err::m_nOK;
+}
+
+ErrVal
+MultiviewReferenceStore::wait( UInt uiViewId, UInt uiPoc, IntFrame*& rpcFrame )
+{
+  SYNC->lock();
+  while( ! m_bAborted && NULL == xGetEntry( uiViewId, uiPoc ).pcFrame )
+  {
+    SYNC->sleep();
+  }
+  rpcFrame = ( m_bAborted ? NULL : xGetEntry( uiViewId, uiPoc ).pcFrame );
+  SYNC->unlock();
+
+  ROF( rpcFrame );
+  return Err::m_nOK;
+}
+
+Void
+MultiviewReferenceStore::release( UInt uiViewId, UInt uiPoc )
+{
+  SYNC->lock();
+  StoredPicture& rcEntry = xGetEntry( uiViewId, uiPoc );
+  if( rcEntry.uiPendingReleases )
+  {
+    rcEntry.uiPendingReleases--;
+  }
+  //===== a picture released before it was published is removed by publish =====
+  if( ! rcEntry.uiPendingReleases && rcEntry.pcFrame )
+  {
+    xRemoveEntry( m_cPictures.find( PictureKey( uiViewId, uiPoc ) ) );
+  }
+  SYNC->unlock();
+}
+
+Bool
+MultiviewReferenceStore::isLent( const IntFrame* pcFrame )
+{
+  Bool bLent = false;
+
+  SYNC->lock();
+  //===== only the pictures the dependent views did not reach yet are stored =====
+  for( StoredPictureMap::const_iterator iter = m_cPictures.begin(); iter != m_cPictures.end() && ! bLent; iter++ )
+  {
+    bLent = ( iter->second.pcFrame == pcFrame );
+  }
+  SYNC->unlock();
+
+  return bLent;
+}
+
+UInt
+MultiviewReferenceStore::getNumRemoved()
+{
+  SYNC->lock();
+  UInt uiNumRemoved = m_uiNumRemoved;
+  SYNC->unlock();
+  return uiNumRemoved;
+}
+
+ErrVal
+MultiviewReferenceStore::waitForRemoval( UInt uiNumRemoved )
+{
+  SYNC->lock();
+  while( ! m_bAborted && m_uiNumRemoved == uiNumRemoved )
+  {
+    SYNC->sleep();
+  }
+  Bool bAborted = m_bAborted;
+  SYNC->unlock();
+
+  ROTRS( bAborted, Err::m_nERR );
+  return Err::m_nOK;
+}
+
+Void
+MultiviewReferenceStore::abort()
+{
+  SYNC->lock();
+  m_bAborted = true;
+  SYNC->wakeAll();
+  SYNC->unlock();
+}
+
+MultiviewReferenceStore::StoredPicture&
+MultiviewReferenceStore::xGetEntry( UInt uiViewId, UInt uiPoc )
+{
+  StoredPictureMap::iterator iter = m_cPictures.find( PictureKey( uiViewId, uiPoc ) );
+  if( iter == m_cPictures.end() )
+  {
+    std::map<UInt,UInt>::const_iterator cViews = m_cNumDependentViews.find( uiViewId );
+    StoredPicture cEntry;
+    cEntry.uiPendingReleases = ( cViews == m_cNumDependentViews.end() ? 0 : cViews->second );
+    iter = m_cPictures.insert( std::make_pair( PictureKey( uiViewId, uiPoc ), cEntry ) ).first;
+  }
+  return iter->second;
+}
+
+Void
+MultiviewReferenceStore::xRemoveEntry( StoredPictureMap::iterator iter )
+{
+  //===== the pictures belong to the RecPicBuffer of their view, which may wait for one of them =====
+  m_cPictures.erase( iter );
+  m_uiNumRemoved++;
+  SYNC->wakeAll();
+}
+
+#undef SYNC
+
+
+H264AVC_NAMESPACE_END
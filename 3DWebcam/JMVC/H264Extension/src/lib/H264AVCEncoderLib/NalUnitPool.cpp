@@ -0,0 +1,166 @@
+#if defined( WIN32 )
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include "H264AVCEncoderLib.h"
+#include "NalUnitPool.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+//===== the slice workers take buffers concurrently =====
+#if defined( WIN32 )
+struct NalUnitPoolSync {
+  NalUnitPoolSync()  { InitializeCriticalSection( &cMutex ); }
+  ~NalUnitPoolSync() { DeleteCriticalSection( &cMutex ); }
+  Void lock       () { EnterCriticalSection( &cMutex ); }
+  Void unlock     () { LeaveCriticalSection( &cMutex ); }
+
+  CRITICAL_SECTION    cMutex;
+};
+#else
+struct NalUnitPoolSync {
+  NalUnitPoolSync()  { pthread_mutex_init( &cMutex, NULL ); }
+  ~NalUnitPoolSync() { pthread_mutex_destroy( &cMutex ); }
+  Void lock       () { pthread_mutex_lock( &cMutex ); }
+  Void unlock     () { pthread_mutex_unlock( &cMutex ); }
+
+  pthread_mutex_t     cMutex;
+};
+#endif
+
+#define SYNC ( (NalUnitPoolSync*) m_pvSync )
+
+
+NalUnitPool::NalUnitPool():
+  m_uiNumAllocations  ( 0 ),
+  m_uiNumReuses       ( 0 ),
+  m_pvSync            ( new NalUnitPoolSync )
+{
+}
+
+
+NalUnitPool::~NalUnitPool()
+{
+  delete SYNC;
+}
+
+
+ErrVal
+NalUnitPool::create( NalUnitPool*& rpcNalUnitPool )
+{
+  rpcNalUnitPool = new NalUnitPool;
+  ROT( NULL == rpcNalUnitPool );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+NalUnitPool::destroy()
+{
+  //===== NAL units the application did not release are its own =====
+  for( UInt uiClass = 0; uiClass < NUM_SIZE_CLASSES; uiClass++ )
+  {
+    for( UInt ui = 0; ui < m_acFreeBuffers[uiClass].size(); ui++ )
+    {
+      delete [] m_acFreeBuffers[uiClass][ui];
+    }
+  }
+  for( UInt ui = 0; ui < m_cFreeNalUnits.size(); ui++ )
+  {
+    delete m_cFreeNalUnits[ui];
+  }
+
+  delete this;
+  return Err::m_nOK;
+}
+
+
+UInt
+NalUnitPool::xGetSizeClass( UInt uiSize ) const
+{
+  UInt uiClass = 0;
+  while( uiClass < NUM_SIZE_CLASSES - 1 && ( 1u << ( MIN_SIZE_LOG2 + uiClass ) ) < uiSize )
+  {
+    uiClass++;
+  }
+  return uiClass;
+}
+
+
+ErrVal
+NalUnitPool::getNalUnit( ExtBinDataAccessor*&   rpcNalUnit,
+                         const BinDataAccessor& rcSource )
+{
+  ROF( rcSource.data() );
+
+  const UInt uiSize     = rcSource.size();
+  const UInt uiClass    = xGetSizeClass( uiSize );
+  const UInt uiCapacity = 1u << ( MIN_SIZE_LOG2 + uiClass );
+  ROT( uiSize > uiCapacity );
+
+  UChar* pucBuffer  = NULL;
+  rpcNalUnit        = NULL;
+
+  SYNC->lock();
+  if( ! m_acFreeBuffers[uiClass].empty() )
+  {
+    pucBuffer = m_acFreeBuffers[uiClass].back();
+    m_acFreeBuffers[uiClass].pop_back();
+  }
+  if( ! m_cFreeNalUnits.empty() )
+  {
+    rpcNalUnit = m_cFreeNalUnits.back();
+    m_cFreeNalUnits.pop_back();
+  }
+  m_uiNumReuses       += ( pucBuffer  ? 1 : 0 ) + ( rpcNalUnit ? 1 : 0 );
+  m_uiNumAllocations  += ( pucBuffer  ? 0 : 1 ) + ( rpcNalUnit ? 0 : 1 );
+  SYNC->unlock();
+
+  //===== the buffers are allocated as before, so an application may still delete them itself =====
+  if( NULL == pucBuffer )
+  {
+    pucBuffer = new UChar [ uiCapacity ];
+    ROF( pucBuffer );
+  }
+  if( NULL == rpcNalUnit )
+  {
+    rpcNalUnit = new ExtBinDataAccessor;
+    ROF( rpcNalUnit );
+  }
+
+  ::memcpy( pucBuffer, rcSource.data(), uiSize * sizeof( UChar ) );
+  rpcNalUnit->set( pucBuffer, uiSize, pucBuffer, uiCapacity );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+NalUnitPool::releaseNalUnit( ExtBinDataAccessor* pcNalUnit )
+{
+  ROF( pcNalUnit );
+  ROF( pcNalUnit->origData() );
+
+  //===== the usable size is the capacity of the size class =====
+  const UInt uiClass = xGetSizeClass( pcNalUnit->usableSize() );
+  ROF( pcNalUnit->usableSize() == ( 1u << ( MIN_SIZE_LOG2 + uiClass ) ) );
+
+  UChar* pucBuffer = pcNalUnit->origData();
+  pcNalUnit->clear();
+
+  SYNC->lock();
+  m_acFreeBuffers[uiClass].push_back( pucBuffer );
+  m_cFreeNalUnits         .push_back( pcNalUnit );
+  SYNC->unlock();
+
+  return Err::m_nOK;
+}
+
+
+H264AVC_NAMESPACE_END
@@ -0,0 +1,56 @@
+#if !defined(AFX_NALUNITPOOL_H__A41C7D52_0E96_4B3F_8F2D_6C1B93E5A720__INCLUDED_)
+#define AFX_NALUNITPOOL_H__A41C7D52_0E96_4B3F_8F2D_6C1B93E5A720__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include <vector>
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+//===== payload buffers of the NAL units handed to the application, in power-of-two size classes; a buffer released   =====
+//===== by the application (CreaterH264AVCEncoder::releaseNalUnit) is reused for the next NAL unit of its class, so   =====
+//===== the encoder does not allocate once the free lists hold as many buffers as are pending at a time              =====
+class NalUnitPool
+{
+  enum
+  {
+    MIN_SIZE_LOG2     = 8,    // smallest buffer of 256 bytes
+    NUM_SIZE_CLASSES  = 24    // largest buffer of 2 GB
+  };
+
+protected:
+  NalUnitPool();
+  virtual ~NalUnitPool();
+
+public:
+  static ErrVal create( NalUnitPool*& rpcNalUnitPool );
+  ErrVal destroy();
+
+  //===== copies the data of rcSource, the slice workers call it on several threads =====
+  ErrVal getNalUnit     ( ExtBinDataAccessor*&    rpcNalUnit,
+                          const BinDataAccessor&  rcSource );
+  ErrVal releaseNalUnit ( ExtBinDataAccessor*     pcNalUnit );
+
+  UInt   getNumAllocations  ()  const { return m_uiNumAllocations; }
+  UInt   getNumReuses       ()  const { return m_uiNumReuses; }
+
+protected:
+  UInt   xGetSizeClass  ( UInt uiSize ) const;
+
+protected:
+  std::vector<UChar*>               m_acFreeBuffers [NUM_SIZE_CLASSES];
+  std::vector<ExtBinDataAccessor*>  m_cFreeNalUnits;
+  UInt                              m_uiNumAllocations;
+  UInt                              m_uiNumReuses;
+  Void*                             m_pvSync;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_NALUNITPOOL_H__A41C7D52_0E96_4B3F_8F2D_6C1B93E5A720__INCLUDED_)
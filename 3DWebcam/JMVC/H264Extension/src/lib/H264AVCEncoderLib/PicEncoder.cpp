@@ -11,6 +11,10 @@
 #include "RecPicBuffer.h"
 #include "NalUnitEncoder.h"
 #include "SliceEncoder.h"
+#include "RateCtrl.h"
+#include "MotionPyramid.h"
+#include "RefPlaneCache.h"
+#include "NalUnitPool.h"
 
 
 H264AVC_NAMESPACE_BEGIN
@@ -36,6 +40,10 @@ PicEncoder::PicEncoder()
 , m_pcYuvBufferCtrlHalfPel  ( NULL )
 , m_pcQuarterPelFilter      ( NULL )
 , m_pcMotionEstimation      ( NULL )
+, m_pcMultiviewReferenceStore( NULL )
+, m_pcRateCtrl              ( NULL )
+, m_pcMotionPyramid         ( NULL )
+, m_pcNalUnitPool           ( NULL )
 //JVT-W080
 , m_uiPdsEnable                ( 0 )
 , m_uiPdsBlockSize             ( 0 )
@@ -91,7 +99,8 @@ PicEncoder::init( CodingParameter*    pcCodingParameter,
                   YuvBufferCtrl*      pcYuvBufferCtrlFullPel,
                   YuvBufferCtrl*      pcYuvBufferCtrlHalfPel,
                   QuarterPelFilter*   pcQuarterPelFilter,
-                  MotionEstimation*   pcMotionEstimation )
+                  MotionEstimation*   pcMotionEstimation,
+                  NalUnitPool*        pcNalUnitPool )
 {
   ROF( pcCodingParameter      );
   ROF( pcControlMng           );
@@ -103,6 +112,7 @@ PicEncoder::init( CodingParameter*    pcCodingParameter,
   ROF( pcYuvBufferCtrlHalfPel );
   ROF( pcQuarterPelFilter     );
   ROF( pcMotionEstimation     );
+  ROF( pcNalUnitPool          );
 
   m_pcCodingParameter       = pcCodingParameter;
   m_pcControlMng            = pcControlMng;
@@ -114,6 +124,7 @@ PicEncoder::init( CodingParameter*    pcCodingParameter,
   m_pcYuvBufferCtrlHalfPel  = pcYuvBufferCtrlHalfPel;
   m_pcQuarterPelFilter      = pcQuarterPelFilter;
   m_pcMotionEstimation      = pcMotionEstimation;
+  m_pcNalUnitPool           = pcNalUnitPool;
 
   //----- create objects -----
   RNOK( RecPicBuffer      ::create( m_pcRecPicBuffer ) );
@@ -129,6 +140,7 @@ PicEncoder::init( CodingParameter*    pcCodingParameter,
 //~JVT-W080
 
   RNOK( xInitFrameSpec());
+  RNOK( xInitRateCtrl () );
   //----- init parameters -----
   m_uiWrittenBytes          = 0;
   m_uiCodedFrames           = 0;
@@ -196,10 +208,16 @@ PicEncoder::uninit()
     RNOK( m_pcInputPicBuffer->uninit  () );
     RNOK( m_pcInputPicBuffer->destroy () );
   }
+  if( m_pcRateCtrl )
+  {
+    RNOK( m_pcRateCtrl->uninit  () );
+    RNOK( m_pcRateCtrl->destroy () );
+  }
 
   m_pcRecPicBuffer      = NULL;
   m_pcSequenceStructure = NULL;
   m_pcInputPicBuffer    = NULL;
+  m_pcRateCtrl          = NULL;
   m_pcSPS               = NULL;
   m_pcSPSBase           = NULL;
   m_pcPPS               = NULL;
@@ -435,7 +453,9 @@ PicEncoder::xInitFrameSpec()
   }
  
   m_uiMinTempLevelLastGOP =0; // to save dpb a fix here March 20
-  for(UInt uiFrame = 0 ; uiFrame <= m_uiGOPSize; uiFrame++ )
+  RNOK( xInitReordering( 0 ) );
+  m_cLPFrameNumListGOPStart = m_cLPFrameNumList;
+  for(UInt uiFrame = 1 ; uiFrame <= m_uiGOPSize; uiFrame++ )
   {
     RNOK( xInitReordering( uiFrame ) );
   }
@@ -544,13 +564,8 @@ PicEncoder::xGetNextFrameSpec()
 }
 
 ErrVal
-PicEncoder::xUpdateFrameSepNextGOPFinish()
+PicEncoder::xUpdateFrameSepNextGOPFinish( UInt uiFrameNumStart, UInt uiContFrameNumStart )
 {
-  UInt uiFrameNumStart     = m_acFrameSpecification[1].getFrameNum();
-  // bug fix
-  // assume that the [1] frame is the highest temporal level frame and always has the 
-  // lagest frame_num of the previous GOP. Or we can search the largets frame_num
-  UInt uiContFrameNumStart = m_acFrameSpecification[m_uiGOPSize].getContFrameNumber();
   m_uiGOPSize=m_uiTotalFrames-m_uiAnchorFrameNumber-1;
   
   if ( m_uiGOPSize==0) return Err::m_nOK;
@@ -606,7 +621,11 @@ PicEncoder::xUpdateFrameSepNextGOP()
   if( m_uiAnchorFrameNumber+m_uiGOPSize+1 > m_uiTotalFrames)
 //reach the uncomplete GOP
   {
-    return xUpdateFrameSepNextGOPFinish();
+    // bug fix
+    // assume that the [1] frame is the highest temporal level frame and always has the 
+    // lagest frame_num of the previous GOP. Or we can search the largets frame_num
+    return xUpdateFrameSepNextGOPFinish( m_acFrameSpecification[1].getFrameNum(),
+                                         m_acFrameSpecification[m_uiGOPSize].getContFrameNumber() );
   }
 
 // usually periodic GOP
@@ -639,6 +658,7 @@ PicEncoder::xUpdateFrameSepNextGOP()
   m_acFrameSpecification[m_uiGOPSize].setNumRefIdxActive( LIST_0, auiPredListSize[0]);
   m_acFrameSpecification[m_uiGOPSize].setNumRefIdxActive( LIST_1, auiPredListSize[1]);
   
+  m_cLPFrameNumListGOPStart = m_cLPFrameNumList;
   for(UInt uiFrame = 1 ; uiFrame <= m_uiGOPSize; uiFrame++ )
   {
     RNOK( xInitReordering( uiFrame ) );
@@ -658,6 +678,41 @@ PicEncoder::process( PicBuffer*               pcInputPicBuffer,
     //===== add picture to input picture buffer =====
     RNOK( m_pcInputPicBuffer->add( pcInputPicBuffer ) );
 
+    return xEncodeInputAccessUnits( rcOutputList, rcUnusedList, rcExtBinDataAccessorList );
+}
+
+ErrVal
+PicEncoder::flush( UInt                     uiNumFrames,
+                   PicBufferList&           rcOutputList,
+                   PicBufferList&           rcUnusedList,
+                   ExtBinDataAccessorList&  rcExtBinDataAccessorList )
+{
+  ROF( m_bInitParameterSets );
+  ROT( uiNumFrames > m_uiTotalFrames );
+  ROTRS( m_pcInputPicBuffer->empty(), Err::m_nOK );
+
+  //===== the buffered pictures are waiting for the key picture of the current GOP =====
+  ROF( uiNumFrames >  m_uiAnchorFrameNumber + 1 );
+  ROT( uiNumFrames >  m_uiAnchorFrameNumber + m_uiGOPSize );
+
+  //===== end the sequence with an uncompleted GOP, as if uiNumFrames had been configured =====
+  // the key picture is coded first in a GOP, so it carries the first frame_num of the GOP
+  UInt uiFrameNumStart     = m_acFrameSpecification[m_uiGOPSize].getFrameNum();
+  UInt uiContFrameNumStart = m_uiAnchorFrameNumber;
+  m_uiTotalFrames          = uiNumFrames;
+  m_cLPFrameNumList        = m_cLPFrameNumListGOPStart;
+  RNOK( xUpdateFrameSepNextGOPFinish( uiFrameNumStart, uiContFrameNumStart ) );
+  m_uiProcessingPocInGOP   = 0;
+  RNOK( xGetNextFrameSpec() );
+
+  return xEncodeInputAccessUnits( rcOutputList, rcUnusedList, rcExtBinDataAccessorList );
+}
+
+ErrVal
+PicEncoder::xEncodeInputAccessUnits( PicBufferList&           rcOutputList,
+                                     PicBufferList&           rcUnusedList,
+                                     ExtBinDataAccessorList&  rcExtBinDataAccessorList )
+{
     //===== encode following access units that are stored in input picture buffer =====
     while( true )
     {
@@ -700,10 +755,11 @@ PicEncoder::process( PicBuffer*               pcInputPicBuffer,
                     dLambdaForMVC, /* fakeHeader = */ true ,bFieldCoded?TOP_FIELD:FRAME ) );//init frame/field SH
 
 
-                m_MultiviewRefPicManager.AddMultiviewReferencesPicturesToBuffer
+                ErrVal nRet = m_MultiviewRefPicManager.AddMultiviewReferencesPicturesToBuffer
                     (m_pcRecPicBuffer, pcSliceHeaderForMVC, rcOutputList, 
                     rcUnusedList, *m_pcSPS, poc , this->TimeForVFrameP(poc));
                 delete pcSliceHeaderForMVC;
+                RNOK( nRet );
         }
 
 		RNOK( m_pcRecPicBuffer->initCurrRecPicBufUnit( pcRecPicBufUnit, pcOrigPicBuffer, pcSliceHeaderTemp, rcOutputList, rcUnusedList ) );//init pcRecPicBufUnit
@@ -725,6 +781,10 @@ PicEncoder::process( PicBuffer*               pcInputPicBuffer,
             uiPictureBits   = 0;
 
             RNOK( xInitSliceHeader( pcSliceHeader, m_cFrameSpecification, dLambda, false, ePicType ) );
+            if( m_pcRateCtrl )
+            {
+              RNOK( xInitRateCtrlPicture( *pcSliceHeader, dLambda ) );
+            }
 			if(uiPicType == 1)pcSliceHeader->setPoc(uiFirstPicPoc,eFirstPicType);//set first field poc 
             pcRecPicBufUnit->getRecFrame()->setPoc( *pcSliceHeader );//update poc for frame/field
             
@@ -748,6 +808,10 @@ PicEncoder::process( PicBuffer*               pcInputPicBuffer,
 			//----- encoding -----
             RNOK( xEncodePicture( rcExtBinDataAccessorList, *pcRecPicBufUnit, *pcSliceHeader, dLambda, uiPictureBits ) );
             m_uiWrittenBytes += ( uiPictureBits >> 3 );
+            if( m_pcRateCtrl )
+            {
+              RNOK( m_pcRateCtrl->finishPicture( uiPictureBits ) );
+            }
 
             //SEI {
             m_adMVCSeqBits[pcSliceHeader->getTemporalLevel()] += uiPictureBits;
@@ -767,6 +831,14 @@ PicEncoder::process( PicBuffer*               pcInputPicBuffer,
 
 		 m_MultiviewRefPicManager.RemoveMultiviewReferencesPicturesFromBuffer(m_pcRecPicBuffer);
 
+         //----- lend the reconstructed picture to the views predicting from it, extended once for all of them -----
+         if( m_pcMultiviewReferenceStore && m_pcMultiviewReferenceStore->hasDependentViews( getViewId() ) )
+         {
+           IntFrame* pcRecFrame = pcRecPicBufUnit->getRecFrame();
+           RNOK( m_pcRecPicBuffer->getRefPlaneCache()->extendFrame( pcRecFrame, m_pcQuarterPelFilter, pcSliceHeaderTemp->getSPS().getFrameMbsOnlyFlag() ) );
+           RNOK( m_pcMultiviewReferenceStore->publish( getViewId(), m_cFrameSpecification.getContFrameNumber(), pcRecFrame ) );
+         }
+
          //----- store picture -----
          RNOK( m_pcRecPicBuffer->store( pcRecPicBufUnit, pcSliceHeaderTemp, rcOutputList, rcUnusedList ) );
 		 delete pcSliceHeaderTemp;
@@ -796,6 +868,26 @@ PicEncoder::finish( PicBufferList&  rcOutputList,
     m_uiWrittenBytes,
     (Double)m_uiCodedFrames/m_pcCodingParameter->getMaximumFrameRate() 
     );
+  if( m_pcRateCtrl )
+  {
+    printf("        rate control:  max picture %d bit, VBV buffer peak %.1lf %%, %d overflows\n\n",
+      m_pcRateCtrl->getMaxPictureBits(),
+      100.0 * m_pcRateCtrl->getPeakVBVFullness(),
+      m_pcRateCtrl->getNumVBVOverflows() );
+  }
+  if( m_pcMotionPyramid && m_pcCodingParameter->getMotionVectorSearchParams().getPyramidSearch() == 2 )
+  {
+    printf("      pyramid search:  coarse seed won %d of %d searches (%.1lf %%)\n\n",
+      m_pcMotionPyramid->getNumSeedWins(),
+      m_pcMotionPyramid->getNumSearches(),
+      100.0 * m_pcMotionPyramid->getNumSeedWins() / max( 1, m_pcMotionPyramid->getNumSearches() ) );
+  }
+  printf("    reference planes:  %d computed, %d reused\n\n",
+    m_pcRecPicBuffer->getRefPlaneCache()->getNumComputations(),
+    m_pcRecPicBuffer->getRefPlaneCache()->getNumHits() );
+  printf("    NAL unit buffers:  %d allocated, %d reused\n\n",
+    m_pcNalUnitPool->getNumAllocations(),
+    m_pcNalUnitPool->getNumReuses() );
 //SEI {
   UInt ui;
   for( ui = 1; ui <= MAX_DSTAGES_MVC; ui++ )
@@ -1059,6 +1151,14 @@ PicEncoder::xCreateData()
   m_uiWriteBufferSize         = 3 * ( uiNum4x4Blocks * 4 * 4 );
   ROFS( ( m_pucWriteBuffer   = new UChar [ m_uiWriteBufferSize ] ) );
 
+  //===== downsampled pictures of the motion search pre-pass =====
+  if( m_pcCodingParameter->getMotionVectorSearchParams().getPyramidSearch() )
+  {
+    RNOK( MotionPyramid::create( m_pcMotionPyramid ) );
+    RNOK( m_pcMotionPyramid->init( m_uiFrameWidthInMb, m_uiFrameHeightInMb,
+                                   m_pcCodingParameter->getMotionVectorSearchParams().getPyramidSearchRange() ) );
+  }
+
   return Err::m_nOK;
 }
 
@@ -1071,6 +1171,14 @@ PicEncoder::xDeleteData()
   m_pucWriteBuffer    = 0;
   m_uiWriteBufferSize = 0;
 
+  //===== motion search pre-pass =====
+  if( m_pcMotionPyramid )
+  {
+    RNOK( m_pcMotionPyramid->uninit  () );
+    RNOK( m_pcMotionPyramid->destroy () );
+    m_pcMotionPyramid = NULL;
+  }
+
   return Err::m_nOK;
 }
 // rplr and mmco:  {{
@@ -1426,6 +1534,12 @@ PicEncoder::xGetListSizes ( UInt  uiTemporalLevel,
   
   UInt  uiCurrFrame   = (   m_uiAnchorFrameNumber) + uiFrameIdInGOP;
 	UInt  uiIntraPeriod = m_vFramePeriod;
+  if( m_pcCodingParameter->getLowDelay() )
+  {
+    //----- P pictures of the low delay mode reference the preceding pictures up to the last anchor picture -----
+    auiPredListSize[0] = min( m_uiMaxNumRefFrames, uiCurrFrame % uiIntraPeriod );
+    auiPredListSize[1] = 0;
+  }
   if( ( uiCurrFrame % uiIntraPeriod ) == 0 )
 	{
 	  auiPredListSize[0] = 0;
@@ -1748,18 +1862,10 @@ PicEncoder::xAppendNewExtBinDataAccessor( ExtBinDataAccessorList& rcExtBinDataAc
   ROF( pcExtBinDataAccessor );
   ROF( pcExtBinDataAccessor->data() );
 
-  UInt    uiNewSize     = pcExtBinDataAccessor->size();
-  UChar*  pucNewBuffer  = new UChar [ uiNewSize ];
-  ROF( pucNewBuffer );
-  ::memcpy( pucNewBuffer, pcExtBinDataAccessor->data(), uiNewSize * sizeof( UChar ) );
-
-  ExtBinDataAccessor* pcNewExtBinDataAccessor = new ExtBinDataAccessor;
-  ROF( pcNewExtBinDataAccessor );
-
-  m_cBinData              .reset          ();
-  m_cBinData              .set            (  pucNewBuffer, uiNewSize );
-  m_cBinData              .setMemAccessor ( *pcNewExtBinDataAccessor );
-  rcExtBinDataAccessorList.push_back      (  pcNewExtBinDataAccessor );
+  //===== the copy is returned to the pool by the application, see CreaterH264AVCEncoder::releaseNalUnit() =====
+  ExtBinDataAccessor* pcNewExtBinDataAccessor = NULL;
+  RNOK( m_pcNalUnitPool->getNalUnit( pcNewExtBinDataAccessor, *pcExtBinDataAccessor ) );
+  rcExtBinDataAccessorList.push_back( pcNewExtBinDataAccessor );
 
   m_cBinData              .reset          ();
   m_cBinData              .setMemAccessor ( *pcExtBinDataAccessor );
@@ -1805,6 +1911,19 @@ PicEncoder::xEncodePicture( ExtBinDataAccessorList& rcExtBinDataAccessorList,
   RNOK( xStartPicture( rcRecPicBufUnit, rcSliceHeader, cList0, cList1 ) );
 //  bug fix for TD March 19
   xSetRefPictures(rcSliceHeader, cList0, cList1);
+
+  //===== predictor of the disparity search =====
+  if( m_pcCodingParameter->getMotionVectorSearchParams().getDisparitySearchRows() && rcSliceHeader.getPicType() == FRAME )
+  {
+    RNOK( xEstimateGlobalDisparity( rcRecPicBufUnit.getRecFrame(), cList0 ) );
+    RNOK( xEstimateGlobalDisparity( rcRecPicBufUnit.getRecFrame(), cList1 ) );
+  }
+
+  //===== coarse motion vectors of the pyramid pre-pass, the reconstructed frame still holds the original =====
+  if( m_pcMotionPyramid && rcSliceHeader.getPicType() == FRAME && ! rcSliceHeader.isMbAff() )
+  {
+    RNOK( m_pcMotionPyramid->initPicture( rcRecPicBufUnit.getRecFrame(), cList0, cList1 ) );
+  }
 //TMM_WP
   if(rcSliceHeader.getSliceType() == P_SLICE)
       m_pcSliceEncoder->xSetPredWeights( rcSliceHeader, 
@@ -1822,80 +1941,203 @@ PicEncoder::xEncodePicture( ExtBinDataAccessorList& rcExtBinDataAccessorList,
   //===== encoding of slice groups =====
   for( Int iSliceGroupID = 0; ! rcSliceHeader.getFMO()->SliceGroupCompletelyCoded( iSliceGroupID ); iSliceGroupID++ )
   {
-    UInt  uiBitsSlice = 0;
+    UInt  uiFirstMbInSliceGroup = rcSliceHeader.getFMO()->getFirstMacroblockInSlice( iSliceGroupID );
+    UInt  uiLastMbInSliceGroup  = rcSliceHeader.getFMO()->getLastMBInSliceGroup    ( iSliceGroupID );
 
-    //----- init slice size -----
-    rcSliceHeader.setFirstMbInSlice( rcSliceHeader.getFMO()->getFirstMacroblockInSlice( iSliceGroupID ) );
-    rcSliceHeader.setLastMbInSlice ( rcSliceHeader.getFMO()->getLastMBInSliceGroup    ( iSliceGroupID ) );
+    //----- slices of SliceArgument macroblocks on the slice workers -----
+    if( xGetLastMbInSlice( rcSliceHeader, uiFirstMbInSliceGroup, uiLastMbInSliceGroup ) != uiLastMbInSliceGroup &&
+        m_pcSliceEncoder->isSliceParallel( rcSliceHeader ) )
+    {
+      rcSliceHeader.setFirstMbInSlice( uiFirstMbInSliceGroup );
+      rcSliceHeader.setLastMbInSlice ( uiLastMbInSliceGroup );
+
+      ExtBinDataAccessorList cSliceNalUnitList;
+      ErrVal nRet = m_pcSliceEncoder->encodeSlicesParallel( rcSliceHeader,
+                                                            m_pcCodingParameter->getSliceArgument(),
+                                                            rcRecPicBufUnit.getRecFrame  ()->getPic( FRAME ),
+                                                            rcRecPicBufUnit.getMbDataCtrl(),
+                                                            cList0,
+                                                            cList1,
+                                                            m_uiFrameWidthInMb,
+                                                            dLambda,
+                                                            cSliceNalUnitList,
+                                                            uiBits );
+      while( ! cSliceNalUnitList.empty() )
+      {
+        ExtBinDataAccessor* pcSliceNalUnit = cSliceNalUnitList.popFront();
+        if( Err::m_nOK == nRet && ( rcSliceHeader.getNalUnitType() == NAL_UNIT_CODED_SLICE || rcSliceHeader.getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR ) && rcSliceHeader.getAVCFlag() )
+        {
+          nRet = xWritePrefixUnit( rcExtBinDataAccessorList, rcSliceHeader, uiBits );
+        }
+        if( Err::m_nOK != nRet )
+        {
+          m_pcNalUnitPool->releaseNalUnit( pcSliceNalUnit );
+          continue;
+        }
+        rcExtBinDataAccessorList.push_back( pcSliceNalUnit );
+      }
+      RNOK( nRet );
+      continue;
+    }
 
-    
-// JVT-W035 {{
-	if ( (rcSliceHeader.getNalUnitType() == NAL_UNIT_CODED_SLICE|| rcSliceHeader.getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR ) && (rcSliceHeader.getAVCFlag()) )
+    //----- slices one after another -----
+    UInt  uiFirstMbInSlice      = uiFirstMbInSliceGroup;
+    Bool  bSliceGroupDone       = false;
+    while( ! bSliceGroupDone )
     {
-          RNOK( xWritePrefixUnit( rcExtBinDataAccessorList, rcSliceHeader, uiBits ) );
+      UInt  uiBitsSlice = 0;
+
+      //----- init slice size -----
+      UInt  uiLastMbInSlice = xGetLastMbInSlice( rcSliceHeader, uiFirstMbInSlice, uiLastMbInSliceGroup );
+      rcSliceHeader.setFirstMbInSlice( uiFirstMbInSlice );
+      rcSliceHeader.setLastMbInSlice ( uiLastMbInSlice );
+      bSliceGroupDone   = ( uiLastMbInSlice == uiLastMbInSliceGroup );
+      uiFirstMbInSlice  = rcSliceHeader.getFMO()->getNextMBNr( uiLastMbInSlice );
+
+      //----- rate control: the slices of a raster picture follow the bits spent so far -----
+      if( m_pcRateCtrl && m_pcCodingParameter->getRateControlSliceQp() &&
+          rcSliceHeader.getPPS().getNumSliceGroupsMinus1() == 0 && rcSliceHeader.getFirstMbInSlice() > 0 )
+      {
+        Int iQp   = m_pcRateCtrl->getSliceQp( uiBits, rcSliceHeader.getFirstMbInSlice(), rcSliceHeader.getMbInPic() );
+        rcSliceHeader.setSliceHeaderQp( iQp );
+        dLambda   = 0.85 * pow( 2.0, min( 52.0, (Double)iQp ) / 3.0 - 4.0 );
+      }
+
+    
+  // JVT-W035 {{
+  	if ( (rcSliceHeader.getNalUnitType() == NAL_UNIT_CODED_SLICE|| rcSliceHeader.getNalUnitType() == NAL_UNIT_CODED_SLICE_IDR ) && (rcSliceHeader.getAVCFlag()) )
+      {
+            RNOK( xWritePrefixUnit( rcExtBinDataAccessorList, rcSliceHeader, uiBits ) );
+      }
+  // JVT-W035 }}
+      //----- init NAL unit -----
+      RNOK( xInitExtBinDataAccessor        (  m_cExtBinDataAccessor ) );
+      RNOK( m_pcNalUnitEncoder->initNalUnit( &m_cExtBinDataAccessor ) );
+
+      //----- write slice header -----
+      ETRACE_NEWSLICE;
+
+      RNOK( m_pcNalUnitEncoder->write ( rcSliceHeader ) );
+  //JVT-W080
+  		if( getPdsEnable() )
+  		{
+  			m_pcSliceEncoder->setPdsEnable( getPdsEnable() );
+  		  m_pcSliceEncoder->setPdsInitialDelayMinus2L0( getPdsInitialDelayMinus2L0() );
+  		  m_pcSliceEncoder->setPdsInitialDelayMinus2L1( getPdsInitialDelayMinus2L1() );
+  		  m_pcSliceEncoder->setPdsBlockSize( getPdsBlockSize() );
+  			//re-set PdsBlockSize to be one row
+  			UInt uiPdsBlockSize = rcSliceHeader.getSPS().getFrameWidthInMbs();
+  			m_pcSliceEncoder->setPdsBlockSize( uiPdsBlockSize );
+  		}
+  //~JVT-W080
+
+      //----- real coding -----
+
+          //lufeng: add mbaff here
+  		if (rcSliceHeader.isMbAff()&&!rcSliceHeader.getFieldPicFlag())
+  	{
+  		RNOK( m_pcSliceEncoder->encodeSliceMbAff( rcSliceHeader,
+  			rcRecPicBufUnit.getRecFrame  (),
+  			rcRecPicBufUnit.getMbDataCtrl(),
+  			cList0,
+  			cList1,
+  			m_uiFrameWidthInMb,
+  			dLambda ) );
+  	}
+  	else
+  	{
+  		RNOK( m_pcSliceEncoder->encodeSlice( rcSliceHeader,
+  			rcRecPicBufUnit.getRecFrame  ()->getPic(rcSliceHeader.getPicType()),
+  			rcRecPicBufUnit.getMbDataCtrl(),
+  			cList0,
+  			cList1,
+  			m_uiFrameWidthInMb,
+  			dLambda ) );
+  	}
+
+
+      //----- close NAL unit -----
+      RNOK( m_pcNalUnitEncoder->closeNalUnit( uiBitsSlice ) );
+      RNOK( xAppendNewExtBinDataAccessor( rcExtBinDataAccessorList, &m_cExtBinDataAccessor ) );
+      uiBitsSlice += 4*8;
+      uiBits      += uiBitsSlice;
     }
-// JVT-W035 }}
-    //----- init NAL unit -----
-    RNOK( xInitExtBinDataAccessor        (  m_cExtBinDataAccessor ) );
-    RNOK( m_pcNalUnitEncoder->initNalUnit( &m_cExtBinDataAccessor ) );
+  }
 
-    //----- write slice header -----
-    ETRACE_NEWSLICE;
+  //===== finish =====
+  if( m_pcMotionPyramid )
+  {
+    RNOK( m_pcMotionPyramid->finishPicture() );
+  }
+  RNOK( xFinishPicture( rcRecPicBufUnit, rcSliceHeader, cList0, cList1, uiBits ) );
+  ruiBits += uiBits;
 
-    RNOK( m_pcNalUnitEncoder->write ( rcSliceHeader ) );
-//JVT-W080
-		if( getPdsEnable() )
-		{
-			m_pcSliceEncoder->setPdsEnable( getPdsEnable() );
-		  m_pcSliceEncoder->setPdsInitialDelayMinus2L0( getPdsInitialDelayMinus2L0() );
-		  m_pcSliceEncoder->setPdsInitialDelayMinus2L1( getPdsInitialDelayMinus2L1() );
-		  m_pcSliceEncoder->setPdsBlockSize( getPdsBlockSize() );
-			//re-set PdsBlockSize to be one row
-			UInt uiPdsBlockSize = rcSliceHeader.getSPS().getFrameWidthInMbs();
-			m_pcSliceEncoder->setPdsBlockSize( uiPdsBlockSize );
-		}
-//~JVT-W080
+  return Err::m_nOK;
+}
 
-    //----- real coding -----
 
-        //lufeng: add mbaff here
-		if (rcSliceHeader.isMbAff()&&!rcSliceHeader.getFieldPicFlag())
-	{
-		RNOK( m_pcSliceEncoder->encodeSliceMbAff( rcSliceHeader,
-			rcRecPicBufUnit.getRecFrame  (),
-			rcRecPicBufUnit.getMbDataCtrl(),
-			cList0,
-			cList1,
-			m_uiFrameWidthInMb,
-			dLambda ) );
-	}
-	else
-	{
-		RNOK( m_pcSliceEncoder->encodeSlice( rcSliceHeader,
-			rcRecPicBufUnit.getRecFrame  ()->getPic(rcSliceHeader.getPicType()),
-			rcRecPicBufUnit.getMbDataCtrl(),
-			cList0,
-			cList1,
-			m_uiFrameWidthInMb,
-			dLambda ) );
-	}
+ErrVal
+PicEncoder::xInitRateCtrl()
+{
+  ROTRS( RC_FIXED_QP == m_pcCodingParameter->getRateControl(), Err::m_nOK );
+
+  //===== the base view gets its share of the rates and of the VBV buffer, the other views split the rest =====
+  UInt    uiNumViews  = m_pcCodingParameter->getSpsMVC()->getNumViewMinus1() + 1;
+  Double  dBaseShare  = m_pcCodingParameter->getBaseViewBitrateShare() / 100.0;
+  Double  dShare      = ( uiNumViews == 1                   ? 1.0        :
+                          m_pcCodingParameter->getAVCFlag() ? dBaseShare : ( 1.0 - dBaseShare ) / ( uiNumViews - 1 ) );
+  Double  dBitrate    = m_pcCodingParameter->getBitrate();
+  Double  dMaxBitrate = ( m_pcCodingParameter->getMaxBitrate() > 0 ? m_pcCodingParameter->getMaxBitrate() : dBitrate );
+
+  RNOK( RateCtrl::create( m_pcRateCtrl ) );
+  RNOK( m_pcRateCtrl->init( (RateCtrlMode)m_pcCodingParameter->getRateControl(),
+                            1000.0 * dShare * dBitrate,
+                            1000.0 * dShare * dMaxBitrate,
+                            1000.0 * dShare * m_pcCodingParameter->getVBVBufferSize(),
+                            m_pcCodingParameter->getMaximumFrameRate(),
+                            m_pcCodingParameter->getFrameWidth() * m_pcCodingParameter->getFrameHeight() ) );
 
+  return Err::m_nOK;
+}
 
-    //----- close NAL unit -----
-    RNOK( m_pcNalUnitEncoder->closeNalUnit( uiBitsSlice ) );
-    RNOK( xAppendNewExtBinDataAccessor( rcExtBinDataAccessorList, &m_cExtBinDataAccessor ) );
-    uiBitsSlice += 4*8;
-    uiBits      += uiBitsSlice;
-  }
 
-  //===== finish =====
-  RNOK( xFinishPicture( rcRecPicBufUnit, rcSliceHeader, cList0, cList1, uiBits ) );
-  ruiBits += uiBits;
+ErrVal
+PicEncoder::xInitRateCtrlPicture( SliceHeader& rcSliceHeader, Double& rdLambda )
+{
+  ROF( m_pcRateCtrl );
+
+  //===== the rate control replaces BasisQp; DeltaLayerNQuant stays the start offset of the temporal levels =====
+  UInt  uiTemporalLevel = rcSliceHeader.getTemporalLevel();
+  Int   iDeltaQp        = (Int)floor( m_pcCodingParameter->getDeltaQpLayer( uiTemporalLevel ) + 0.5 );
+  Int   iQp             = 0;
+  Bool  bAnchor         = rcSliceHeader.isIntra() || m_cFrameSpecification.isAnchor();
+  RNOK( m_pcRateCtrl->initPicture( uiTemporalLevel, bAnchor, iDeltaQp, iQp ) );
+
+  rcSliceHeader.setSliceHeaderQp( iQp );
+  rdLambda              = 0.85 * pow( 2.0, min( 52.0, (Double)iQp ) / 3.0 - 4.0 );
 
   return Err::m_nOK;
 }
 
 
+UInt
+PicEncoder::xGetLastMbInSlice( SliceHeader& rcSliceHeader, UInt uiFirstMbInSlice, UInt uiLastMbInSliceGroup )
+{
+  //===== slices of SliceArgument macroblocks are only formed in frame pictures without MBAFF =====
+  if( m_pcCodingParameter->getSliceMode() != 1 || rcSliceHeader.getPicType() != FRAME || rcSliceHeader.isMbAff() )
+  {
+    return uiLastMbInSliceGroup;
+  }
+
+  UInt uiLastMbInSlice = uiFirstMbInSlice;
+  for( UInt uiMb = 1; uiMb < m_pcCodingParameter->getSliceArgument() && uiLastMbInSlice != uiLastMbInSliceGroup; uiMb++ )
+  {
+    uiLastMbInSlice = rcSliceHeader.getFMO()->getNextMBNr( uiLastMbInSlice );
+  }
+  return uiLastMbInSlice;
+}
+
+
 ErrVal
 PicEncoder::xWritePrefixUnit( ExtBinDataAccessorList& rcExtBinDataAccessorList, SliceHeader& rcSH, UInt& ruiBit ) //JVT-W035
 {
@@ -2021,6 +2263,72 @@ PicEncoder::xStartPicture( RecPicBufUnit& rcRecPicBufUnit,
 }
 
 
+ErrVal
+PicEncoder::xEstimateGlobalDisparity( IntFrame*     pcFrame,
+                                      RefFrameList& rcList )
+{
+  //===== pcFrame still holds the original picture; the views are rectified, so only horizontal shifts are tested =====
+  IntYuvPicBuffer*  pcOrgBuffer = pcFrame->getFullPelYuvBuffer();
+  const Int         iWidth      = pcOrgBuffer->getLWidth  ();
+  const Int         iHeight     = pcOrgBuffer->getLHeight ();
+  const Int         iRange      = min( (Int)m_pcCodingParameter->getMotionVectorSearchParams().getSearchRange(), iWidth / 2 );
+
+  for( UInt uiPos = 0; uiPos < rcList.getActive(); uiPos++ )
+  {
+    IntFrame* pcRefFrame = rcList.getEntry( uiPos );
+    if( pcRefFrame->getViewId() == getViewId() )
+    {
+      continue;
+    }
+
+    //----- mean absolute difference over the overlap of both pictures, every 4th row and every 2nd sample -----
+    IntYuvPicBuffer*  pcRefBuffer     = pcRefFrame->getFullPelYuvBuffer();
+    Int               iBestDisparity  = 0;
+    Double            dBestCost       = DOUBLE_MAX;
+
+    for( Int iDisparity = -iRange; iDisparity <= iRange; iDisparity++ )
+    {
+      Int   iStartX = max( 0, -iDisparity );
+      Int   iEndX   = min( iWidth, iWidth - iDisparity );
+      XPel* pOrg    = pcOrgBuffer->getLumOrigin();
+      XPel* pRef    = pcRefBuffer->getLumOrigin() + iDisparity;
+      UInt  uiSum   = 0;
+      UInt  uiNum   = 0;
+
+      for( Int y = 0; y < iHeight; y += 4 )
+      {
+        for( Int x = iStartX; x < iEndX; x += 2 )
+        {
+          uiSum += abs( pOrg[x] - pRef[x] );
+          uiNum ++;
+        }
+        pOrg += 4 * pcOrgBuffer->getLStride();
+        pRef += 4 * pcRefBuffer->getLStride();
+      }
+
+      Double dCost = (Double)uiSum / (Double)max( uiNum, 1u );
+      if( dCost < dBestCost || ( dCost == dBestCost && abs( iDisparity ) < abs( iBestDisparity ) ) )
+      {
+        dBestCost       = dCost;
+        iBestDisparity  = iDisparity;
+      }
+    }
+
+    pcRefFrame->setGlobalDisparity( Mv( iBestDisparity << 2, 0 ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+Bool
+PicEncoder::xIsSharedWithOtherViews( IntFrame* pcFrame )
+{
+  ROTRS( pcFrame->isBorrowed(), true );
+  return ( m_pcMultiviewReferenceStore && m_pcMultiviewReferenceStore->isLent( pcFrame ) );
+}
+
+
 ErrVal
 PicEncoder::xFinishPicture( RecPicBufUnit&  rcRecPicBufUnit,
                             SliceHeader&    rcSliceHeader,
@@ -2028,11 +2336,15 @@ PicEncoder::xFinishPicture( RecPicBufUnit&  rcRecPicBufUnit,
                             RefFrameList&   rcList1,
                             UInt            uiBits )
 {
-  //===== uninit half-pel data =====
+  //===== uninit half-pel data (not of pictures shared with other views or kept by the reference plane cache) =====
   UInt uiPos;
   for( uiPos = 0; uiPos < rcList0.getActive(); uiPos++ )
   {
     IntFrame* pcRefFrame = rcList0.getEntry( uiPos );
+    if( xIsSharedWithOtherViews( pcRefFrame ) || m_pcRecPicBuffer->getRefPlaneCache()->isValid( pcRefFrame ) )
+    {
+      continue;
+    }
     if( pcRefFrame->isExtended() )
     {
       pcRefFrame->clearExtended();
@@ -2045,6 +2357,10 @@ PicEncoder::xFinishPicture( RecPicBufUnit&  rcRecPicBufUnit,
   for( uiPos = 0; uiPos < rcList1.getActive(); uiPos++ )
   {
     IntFrame* pcRefFrame = rcList1.getEntry( uiPos );
+    if( xIsSharedWithOtherViews( pcRefFrame ) || m_pcRecPicBuffer->getRefPlaneCache()->isValid( pcRefFrame ) )
+    {
+      continue;
+    }
     if( pcRefFrame->isExtended() )
     {
       pcRefFrame->clearExtended();
@@ -23,6 +23,9 @@ class YuvBufferCtrl;
 class QuarterPelFilter;
 class MotionEstimation;
 class ControlMngIf;
+class RateCtrl;
+class MotionPyramid;
+class NalUnitPool;
 
 
 class PicEncoder
@@ -43,7 +46,8 @@ public:
                                                   YuvBufferCtrl*              pcYuvBufferCtrlFullPel,
                                                   YuvBufferCtrl*              pcYuvBufferCtrlHalfPel,
                                                   QuarterPelFilter*           pcQuarterPelFilter,
-                                                  MotionEstimation*           pcMotionEstimation );
+                                                  MotionEstimation*           pcMotionEstimation,
+                                                  NalUnitPool*                pcNalUnitPool );
   ErrVal          uninit                        ();
   
   ErrVal          writeAndInitParameterSets     ( ExtBinDataAccessor*         pcExtBinDataAccessor,
@@ -53,6 +57,10 @@ public:
                                                   PicBufferList&              rcOutputList,
                                                   PicBufferList&              rcUnusedList,
                                                   ExtBinDataAccessorList&     rcExtBinDataAccessorList );
+  ErrVal          flush                         ( UInt                        uiNumFrames,
+                                                  PicBufferList&              rcOutputList,
+                                                  PicBufferList&              rcUnusedList,
+                                                  ExtBinDataAccessorList&     rcExtBinDataAccessorList );
   ErrVal          finish                        ( PicBufferList&              rcOutputList,
                                                   PicBufferList&              rcUnusedList );
 
@@ -64,6 +72,10 @@ public:
   UInt		getViewId()       const { return m_CurrentViewId; } // u(10) 
   
   bool TimeForVFrameP (const int currentFrameNum) const;
+
+  // reconstructed pictures are published to, and inter-view references taken from, pcStore
+  Void    setMultiviewReferenceStore( MultiviewReferenceStore* pcStore ) { m_pcMultiviewReferenceStore = pcStore; m_pcRecPicBuffer->setMultiviewReferenceStore( pcStore ); }
+  UInt    getMaxFramesInDPB         ()  const { return m_pcRecPicBuffer->getMaxFramesInDPB(); }
   ErrVal		xWritePrefixUnit    ( ExtBinDataAccessorList& rcExtBinDataAccessorList, SliceHeader& rcSH, UInt& ruiBit );//JVT-W035
 
   //SEI LSJ{
@@ -115,6 +127,7 @@ private:
 									  PicType                     ePicType=FRAME);
 
   UIntList                      m_cLPFrameNumList;                    
+  UIntList                      m_cLPFrameNumListGOPStart;  // m_cLPFrameNumList before the reordering of the current GOP
 //  }}
   ErrVal          xInitPredWeights              ( SliceHeader&                rcSliceHeader );
 
@@ -128,20 +141,32 @@ private:
                                                   ExtBinDataAccessor*         pcExtBinDataAccessor );
 
   //===== encoding =====
+  ErrVal          xEncodeInputAccessUnits       ( PicBufferList&              rcOutputList,
+                                                  PicBufferList&              rcUnusedList,
+                                                  ExtBinDataAccessorList&     rcExtBinDataAccessorList );
   ErrVal          xStartPicture                 ( RecPicBufUnit&              rcRecPicBufUnit,
                                                   SliceHeader&                rcSliceHeader,
                                                   RefFrameList&               rcList0,
                                                   RefFrameList&               rcList1 );
+  ErrVal          xEstimateGlobalDisparity      ( IntFrame*                   pcFrame,
+                                                  RefFrameList&               rcList );
   ErrVal          xEncodePicture                ( ExtBinDataAccessorList&     rcExtBinDataAccessorList,
                                                   RecPicBufUnit&              rcRecPicBufUnit,
                                                   SliceHeader&                rcSliceHeader,
                                                   Double                      dLambda,
                                                   UInt&                       ruiBits);
+  ErrVal          xInitRateCtrl                 ();
+  ErrVal          xInitRateCtrlPicture          ( SliceHeader&                rcSliceHeader,
+                                                  Double&                     rdLambda );
+  UInt            xGetLastMbInSlice             ( SliceHeader&                rcSliceHeader,
+                                                  UInt                        uiFirstMbInSlice,
+                                                  UInt                        uiLastMbInSliceGroup );
   ErrVal          xFinishPicture                ( RecPicBufUnit&              rcRecPicBufUnit,
                                                   SliceHeader&                rcSliceHeader,
                                                   RefFrameList&               rcList0,
                                                   RefFrameList&               rcList1,
                                                   UInt                        uiBits );
+  Bool            xIsSharedWithOtherViews       ( IntFrame*                   pcFrame );
   ErrVal          xGetPSNR                      ( RecPicBufUnit&              rcRecPicBufUnit,
                                                   Double*                     adPSNR );
 
@@ -154,7 +179,7 @@ xFieldList(    SliceHeader&   rcSliceHeader,
   ErrVal          xInitFrameSpec               ();
   ErrVal          xGetNextFrameSpec            ();
   ErrVal          xUpdateFrameSepNextGOP       ();
-  ErrVal          xUpdateFrameSepNextGOPFinish ();
+  ErrVal          xUpdateFrameSepNextGOPFinish ( UInt uiFrameNumStart, UInt uiContFrameNumStart );
   ErrVal          xInitFrameSpecSpecial        ();
   ErrVal          xInitFrameSpecHierarchical   ();
   ErrVal          xGetNextFrameSpecSpecial     ();
@@ -216,6 +241,10 @@ private:
   YuvBufferCtrl*              m_pcYuvBufferCtrlHalfPel;
   QuarterPelFilter*           m_pcQuarterPelFilter;
   MotionEstimation*           m_pcMotionEstimation;
+  MultiviewReferenceStore*    m_pcMultiviewReferenceStore;
+  RateCtrl*                   m_pcRateCtrl;
+  MotionPyramid*              m_pcMotionPyramid;
+  NalUnitPool*                m_pcNalUnitPool;
 	PicEncoder*									m_picEncoder; //JVT-W056
 
   //===== fixed coding parameters =====
@@ -0,0 +1,259 @@
+#include "H264AVCEncoderLib.h"
+#include "RateCtrl.h"
+
+#include <math.h>
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+#define RC_MIN_QP           10
+#define RC_MAX_QP_STEP       3  // QP change of a picture class between two of its pictures, unless the VBV buffer is nearly full
+#define RC_MAX_SLICE_QP_STEP 3
+
+
+RateCtrl::RateCtrl():
+  m_eMode               ( RC_FIXED_QP ),
+  m_dBitsPerPic         ( 0 ),
+  m_dDrainPerPic        ( 0 ),
+  m_dVBVBufferSize      ( 0 ),
+  m_dFrameRate          ( 0 ),
+  m_dFullness           ( 0 ),
+  m_dPeakFullness       ( 0 ),
+  m_dBudget             ( 0 ),
+  m_iBaseQp             ( 0 ),
+  m_uiPicClass          ( 0 ),
+  m_iQp                 ( 0 ),
+  m_dTarget             ( 0 ),
+  m_dMaxBits            ( 0 ),
+  m_uiNumPics           ( 0 ),
+  m_uiMaxPictureBits    ( 0 ),
+  m_uiNumVBVOverflows   ( 0 ),
+  m_bInitDone           ( false )
+{
+}
+
+
+RateCtrl::~RateCtrl()
+{
+}
+
+
+ErrVal
+RateCtrl::create( RateCtrl*& rpcRateCtrl )
+{
+  rpcRateCtrl = new RateCtrl;
+  ROT( NULL == rpcRateCtrl );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+RateCtrl::destroy()
+{
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+RateCtrl::init( RateCtrlMode eMode,
+                Double       dBitrate,
+                Double       dMaxBitrate,
+                Double       dVBVBufferSize,
+                Double       dFrameRate,
+                UInt         uiPelsInPic )
+{
+  ROT( m_bInitDone );
+  ROT( RC_FIXED_QP == eMode );
+  ROF( dBitrate   > 0 );
+  ROF( dFrameRate > 0 );
+  ROF( uiPelsInPic );
+
+  m_eMode           = eMode;
+  m_dFrameRate      = dFrameRate;
+  m_dBitsPerPic     = dBitrate / dFrameRate;
+  m_dDrainPerPic    = ( RC_CAPPED_VBR == eMode && dMaxBitrate > dBitrate ? dMaxBitrate : dBitrate ) / dFrameRate;
+  m_dVBVBufferSize  = ( dVBVBufferSize > 0 ? dVBVBufferSize : 0.5 * m_dDrainPerPic * dFrameRate );
+  m_dVBVBufferSize  = max( m_dVBVBufferSize, 2 * m_dDrainPerPic );
+  m_dFullness       = 0;
+  m_dPeakFullness   = 0;
+  m_dBudget         = 0;
+
+  //===== start QP from the bits per sample (the first anchor picture is coded with it) =====
+  Double dBitsPerPel  = m_dBitsPerPic / (Double)uiPelsInPic;
+  m_iBaseQp           = ( dBitsPerPel > 0.6  ? 20 :
+                          dBitsPerPel > 0.3  ? 26 :
+                          dBitsPerPel > 0.1  ? 32 :
+                          dBitsPerPel > 0.04 ? 38 : 44 );
+
+  ::memset( m_adComplexity, 0x00, sizeof( m_adComplexity ) );
+  ::memset( m_adAvgBits,    0x00, sizeof( m_adAvgBits ) );
+  ::memset( m_auiNumPics,   0x00, sizeof( m_auiNumPics ) );
+  ::memset( m_aiLastQp,     0x00, sizeof( m_aiLastQp ) );
+
+  m_uiPicClass        = 0;
+  m_iQp               = m_iBaseQp;
+  m_dTarget           = m_dBitsPerPic;
+  m_dMaxBits          = m_dVBVBufferSize;
+  m_uiNumPics         = 0;
+  m_uiMaxPictureBits  = 0;
+  m_uiNumVBVOverflows = 0;
+  m_bInitDone         = true;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+RateCtrl::uninit()
+{
+  m_bInitDone = false;
+  return Err::m_nOK;
+}
+
+
+UInt
+RateCtrl::xGetPicClass( UInt uiTemporalLevel, Bool bAnchor ) const
+{
+  return ( bAnchor ? 0 : 1 + min( uiTemporalLevel, (UInt)MAX_DSTAGES_MVC ) );
+}
+
+
+Double
+RateCtrl::xGetAvgBits() const
+{
+  //===== average picture size over the classes in the proportion they have been coded =====
+  Double  dBits = 0;
+  UInt    uiNum = 0;
+  for( UInt uiClass = 0; uiClass < MAX_DSTAGES_MVC+2; uiClass++ )
+  {
+    dBits += m_adAvgBits[uiClass] * m_auiNumPics[uiClass];
+    uiNum += m_auiNumPics[uiClass];
+  }
+  return ( uiNum ? dBits / uiNum : 0 );
+}
+
+
+ErrVal
+RateCtrl::initPicture( UInt uiTemporalLevel, Bool bAnchor, Int iDeltaQp, Int& riQp )
+{
+  ROF( m_bInitDone );
+
+  UInt    uiClass = xGetPicClass( uiTemporalLevel, bAnchor );
+
+  //===== bit target: the class keeps its share of the average picture =====
+  Double  dAvgBits  = xGetAvgBits();
+  Double  dWeight   = ( bAnchor ? 4.0 : 1.0 );
+  if( m_auiNumPics[uiClass] && dAvgBits > 0 )
+  {
+    dWeight = m_adAvgBits[uiClass] / dAvgBits;
+  }
+  Double  dTarget   = m_dBitsPerPic * dWeight;
+
+  //----- deviations from the budget are evened out within about a second -----
+  dTarget          += m_dBudget * dWeight / m_dFrameRate;
+
+  //----- the picture must fit into the VBV buffer, which should not stay more than half full -----
+  Double  dFullness = m_dFullness / m_dVBVBufferSize;
+  if( dFullness > 0.5 )
+  {
+    dTarget        *= max( 0.5, 1.5 - dFullness );
+  }
+  m_dMaxBits        = m_dVBVBufferSize - m_dFullness;
+  dTarget           = min( dTarget, 0.9 * m_dMaxBits );
+  dTarget           = max( dTarget, 0.1 * m_dBitsPerPic );
+
+  //===== QP for the target with the complexity of the last picture of the class =====
+  Int     iQp       = m_iBaseQp + ( bAnchor ? 0 : iDeltaQp );
+  if( m_adComplexity[uiClass] > 0 )
+  {
+    Double  dQStep  = m_adComplexity[uiClass] / dTarget;
+    iQp             = (Int)floor( 4.0 + 6.0 * log( dQStep ) / log( 2.0 ) + 0.5 );
+    if( dFullness < 0.8 )
+    {
+      iQp           = max( m_aiLastQp[uiClass] - RC_MAX_QP_STEP, min( m_aiLastQp[uiClass] + RC_MAX_QP_STEP, iQp ) );
+    }
+    //----- the step limit must not let the picture overflow the buffer -----
+    Double  dMinQStep = m_adComplexity[uiClass] / ( 0.9 * max( m_dMaxBits, 1.0 ) );
+    iQp             = max( iQp, (Int)ceil( 4.0 + 6.0 * log( dMinQStep ) / log( 2.0 ) ) );
+  }
+  iQp               = max( RC_MIN_QP, min( MAX_QP, iQp ) );
+
+  m_iBaseQp         = iQp - ( bAnchor ? 0 : iDeltaQp );
+  m_uiPicClass      = uiClass;
+  m_iQp             = iQp;
+  m_dTarget         = dTarget;
+  riQp              = iQp;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+RateCtrl::finishPicture( UInt uiBits )
+{
+  ROF( m_bInitDone );
+
+  Double  dBits       = (Double)uiBits;
+  Double  dComplexity = dBits * pow( 2.0, ( m_iQp - 4 ) / 6.0 );
+
+  //===== update the model of the class =====
+  if( m_auiNumPics[m_uiPicClass] )
+  {
+    m_adComplexity[m_uiPicClass]  = 0.5 * m_adComplexity[m_uiPicClass] + 0.5 * dComplexity;
+    m_adAvgBits   [m_uiPicClass]  = 0.8 * m_adAvgBits   [m_uiPicClass] + 0.2 * dBits;
+  }
+  else
+  {
+    m_adComplexity[m_uiPicClass]  = dComplexity;
+    m_adAvgBits   [m_uiPicClass]  = dBits;
+  }
+  m_auiNumPics[m_uiPicClass]++;
+  m_aiLastQp  [m_uiPicClass]      = m_iQp;
+
+  //===== budget; in capped VBR the savings of easy scenes are not kept for more than a buffer size =====
+  m_dBudget += m_dBitsPerPic - dBits;
+  if( RC_CAPPED_VBR == m_eMode )
+  {
+    m_dBudget = min( m_dBudget, m_dVBVBufferSize );
+  }
+
+  //===== VBV buffer: the picture enters at once and drains at the channel rate =====
+  m_dFullness    += dBits;
+  m_dPeakFullness = max( m_dPeakFullness, m_dFullness );
+  if( m_dFullness > m_dVBVBufferSize )
+  {
+    m_uiNumVBVOverflows++;
+  }
+  m_dFullness     = max( 0.0, m_dFullness - m_dDrainPerPic );
+
+  m_uiMaxPictureBits = max( m_uiMaxPictureBits, uiBits );
+  m_uiNumPics++;
+
+  return Err::m_nOK;
+}
+
+
+Int
+RateCtrl::getSliceQp( UInt uiBitsInPic, UInt uiMbsCoded, UInt uiMbsInPic ) const
+{
+  ROTRS( ! m_bInitDone,                             m_iQp );
+  ROTRS( ! uiMbsCoded || uiMbsCoded >= uiMbsInPic,  m_iQp );
+
+  //===== compare the bits projected for the whole picture with the target =====
+  Double  dProjected  = (Double)uiBitsInPic * uiMbsInPic / uiMbsCoded;
+  Int     iDeltaQp    = (Int)floor( 6.0 * log( dProjected / m_dTarget ) / log( 2.0 ) + 0.5 );
+  iDeltaQp            = max( -RC_MAX_SLICE_QP_STEP, min( RC_MAX_SLICE_QP_STEP, iDeltaQp ) );
+
+  //----- the rest of the picture must still fit into the VBV buffer -----
+  if( dProjected > m_dMaxBits )
+  {
+    iDeltaQp          = max( iDeltaQp, 2 * RC_MAX_SLICE_QP_STEP );
+  }
+
+  return max( RC_MIN_QP, min( MAX_QP, m_iQp + iDeltaQp ) );
+}
+
+
+H264AVC_NAMESPACE_END
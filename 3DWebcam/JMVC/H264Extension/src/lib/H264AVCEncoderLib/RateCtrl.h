@@ -0,0 +1,90 @@
+#if !defined(AFX_RATECTRL_H__0B6E3D52_9A41_4F7C_8E15_C37A2D64F1B9__INCLUDED_)
+#define AFX_RATECTRL_H__0B6E3D52_9A41_4F7C_8E15_C37A2D64F1B9__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+enum RateCtrlMode
+{
+  RC_FIXED_QP   = 0,  // BasisQp and DeltaLayerNQuant
+  RC_CBR        = 1,  // the VBV buffer drains at the bit rate
+  RC_CAPPED_VBR = 2   // average bit rate, the VBV buffer drains at the maximum bit rate
+};
+
+
+//===== rate control of one view: the QP of every picture is chosen for a bit target derived from the average =====
+//===== bits of its picture class (intra or temporal level) and limited by a VBV buffer model, so that pictures  =====
+//===== never take longer than the buffer size to transmit at the drain rate                                     =====
+class RateCtrl
+{
+protected:
+  RateCtrl();
+  virtual ~RateCtrl();
+
+public:
+  static ErrVal create( RateCtrl*& rpcRateCtrl );
+  ErrVal destroy();
+
+  //===== rates in bit/s and buffer size in bit, for this view only =====
+  ErrVal init( RateCtrlMode eMode,
+               Double       dBitrate,
+               Double       dMaxBitrate,
+               Double       dVBVBufferSize,
+               Double       dFrameRate,
+               UInt         uiPelsInPic );
+  ErrVal uninit();
+
+  //===== pictures without temporal prediction (intra and anchor pictures) form one class, the other pictures one class per =====
+  //===== temporal level; iDeltaQp is the DeltaLayerNQuant offset of the picture, used until the class has been coded once  =====
+  ErrVal initPicture  ( UInt uiTemporalLevel, Bool bAnchor, Int iDeltaQp, Int& riQp );
+  ErrVal finishPicture( UInt uiBits );
+
+  //===== QP of the next slice of the current picture, from the bits of the uiMbsCoded macroblocks coded so far =====
+  Int    getSliceQp   ( UInt uiBitsInPic, UInt uiMbsCoded, UInt uiMbsInPic ) const;
+
+  UInt   getNumPics         ()  const { return m_uiNumPics; }
+  UInt   getMaxPictureBits  ()  const { return m_uiMaxPictureBits; }
+  UInt   getNumVBVOverflows ()  const { return m_uiNumVBVOverflows; }
+  Double getPeakVBVFullness ()  const { return m_dPeakFullness / m_dVBVBufferSize; }
+
+protected:
+  UInt   xGetPicClass( UInt uiTemporalLevel, Bool bAnchor ) const;
+  Double xGetAvgBits () const;
+
+protected:
+  RateCtrlMode  m_eMode;
+  Double        m_dBitsPerPic;
+  Double        m_dDrainPerPic;
+  Double        m_dVBVBufferSize;
+  Double        m_dFrameRate;
+  Double        m_dFullness;        // bits in the VBV buffer after the last picture was drained
+  Double        m_dPeakFullness;
+  Double        m_dBudget;          // bits not yet spent of the target so far (negative when overspent)
+  Int           m_iBaseQp;          // QP of the last picture without its DeltaLayerNQuant offset
+  //----- per picture class: 0 anchor pictures, 1 + temporal level for the other pictures -----
+  Double        m_adComplexity[MAX_DSTAGES_MVC+2];  // bits times quantizer step size
+  Double        m_adAvgBits   [MAX_DSTAGES_MVC+2];
+  UInt          m_auiNumPics  [MAX_DSTAGES_MVC+2];
+  Int           m_aiLastQp    [MAX_DSTAGES_MVC+2];
+  //----- current picture -----
+  UInt          m_uiPicClass;
+  Int           m_iQp;
+  Double        m_dTarget;
+  Double        m_dMaxBits;
+  //----- statistics -----
+  UInt          m_uiNumPics;
+  UInt          m_uiMaxPictureBits;
+  UInt          m_uiNumVBVOverflows;
+  Bool          m_bInitDone;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_RATECTRL_H__0B6E3D52_9A41_4F7C_8E15_C37A2D64F1B9__INCLUDED_)
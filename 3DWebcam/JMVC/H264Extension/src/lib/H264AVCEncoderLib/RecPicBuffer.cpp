@@ -3,6 +3,8 @@
 #include "H264AVCCommonLib.h"
 #include "RecPicBuffer.h"
 #include "PicEncoder.h"  //JVT-W056  Samsung
+#include "MultiviewReferenceStore.h"
+#include "RefPlaneCache.h"
 
 H264AVC_NAMESPACE_BEGIN
 
@@ -157,9 +159,15 @@ RecPicBuffer::RecPicBuffer()
 , m_pcYuvBufferCtrlHalfPel  ( NULL )
 , m_uiNumRefFrames          ( 0 )
 , m_uiMaxFrameNum           ( 0 )
+, m_uiMaxFramesInDPB        ( 0 )
+, m_uiNumExtraUnits         ( 0 )
 , m_uiLastRefFrameNum       ( MSYS_UINT_MAX )
 , m_pcCurrRecPicBufUnit     ( NULL )
+, m_pcPicEncoder            ( NULL )
 , m_codeAsVFrame          ( false )
+, m_pcSPS                   ( NULL )
+, m_pcMultiviewReferenceStore( NULL )
+, m_pcRefPlaneCache         ( NULL )
 
 {
 }
@@ -173,6 +181,7 @@ RecPicBuffer::create( RecPicBuffer*& rpcRecPicBuffer )
 {
   rpcRecPicBuffer = new RecPicBuffer();
   ROF( rpcRecPicBuffer );
+  RNOK( RefPlaneCache::create( rpcRecPicBuffer->m_pcRefPlaneCache ) );
   return Err::m_nOK;
 }
 
@@ -180,6 +189,7 @@ ErrVal
 RecPicBuffer::destroy()
 {
   ROT( m_bInitDone );
+  RNOK( m_pcRefPlaneCache->destroy() );
   delete this;
   return Err::m_nOK;
 }
@@ -197,6 +207,7 @@ RecPicBuffer::init( YuvBufferCtrl*  pcYuvBufferCtrlFullPel,
   m_pcYuvBufferCtrlHalfPel  = pcYuvBufferCtrlHalfPel;
   m_uiNumRefFrames          = 0;
   m_uiMaxFrameNum           = 0;
+  m_uiNumExtraUnits         = 0;
   m_uiLastRefFrameNum       = MSYS_UINT_MAX;
   m_pcCurrRecPicBufUnit     = NULL;
   m_bInitDone               = true;
@@ -221,8 +232,10 @@ RecPicBuffer::initSPS( const SequenceParameterSet& rcSPS )
   uiMaxFramesInDPB = min ( uiMaxFramesInDPB , (max(1,(UInt)ceil((double)log((double)Num_Views)/log(2.)))*16) );
 
   RNOK( xCreateData( uiMaxFramesInDPB, rcSPS ) );
+  m_pcSPS               = &rcSPS;
   m_uiNumRefFrames      = rcSPS.getNumRefFrames();
   m_uiMaxFrameNum       = ( 1 << ( rcSPS.getLog2MaxFrameNum() ) );
+  m_uiMaxFramesInDPB    = uiMaxFramesInDPB;
 
   return Err::m_nOK;
 }
@@ -242,6 +255,7 @@ RecPicBuffer::uninit()
   m_uiLastRefFrameNum       = MSYS_UINT_MAX;
   m_bInitDone               = false;
   m_codeAsVFrame            = false;
+  m_pcSPS                   = NULL;
 
   return Err::m_nOK;
 }
@@ -327,6 +341,29 @@ RecPicBuffer::initCurrRecPicBufUnit( RecPicBufUnit*&  rpcCurrRecPicBufUnit,
   return Err::m_nOK;
 }
 
+ErrVal
+RecPicBuffer::initCurrRecPicBufUnit( RecPicBufUnit*&              rpcCurrRecPicBufUnit,
+                                     IntFrame*                    pcRefViewFrame,
+                                     SliceHeader*                 pcSliceHeader,
+                                     MultiviewReferenceDirection  refDirection )
+{
+  ROF( m_bInitDone );
+  ROF( pcRefViewFrame );
+  ROF( pcSliceHeader );
+  ROT( NOT_MULTIVIEW == refDirection );
+
+  //===== initialize current DPB unit, there is no picture buffer to output =====
+  RNOK( m_pcCurrRecPicBufUnit->init( pcSliceHeader, NULL ) );
+
+  //===== the samples stay in the DPB of the reference view =====
+  RNOK( m_pcCurrRecPicBufUnit->getRecFrame()->borrow( pcRefViewFrame ) );
+
+  m_pcCurrRecPicBufUnit->SetMultiviewReferenceDirection(refDirection);
+  rpcCurrRecPicBufUnit = m_pcCurrRecPicBufUnit;
+
+  return Err::m_nOK;
+}
+
 // Dong: Bug fix for sliding window with interlace mode
 ErrVal
 RecPicBuffer::store2(Bool isRef)
@@ -408,14 +445,11 @@ RecPicBuffer::ProcessRef(SliceHeader&   rcSliceHeader, RefFrameList&  rcList ,Re
   for( uiPos = 0; uiPos < rcListTemp.getSize() ; uiPos++ )
   {
     IntFrame* pcRefFrame = rcListTemp.getEntry( uiPos );
-	if( 1)//! ( pcRefFrame->isHalfPel() && pcRefFrame->isPicReady(FRAME) ) )
-    {
-      RNOK( pcRefFrame->initHalfPel() );
-    }
-    if( ! pcRefFrame->isExtended() )
+    if( ! m_pcRefPlaneCache->isValid( pcRefFrame ) && xIsLent( pcRefFrame ) )
     {
-		RNOK( pcRefFrame->extendFrame( pcQuarterPelFilter, FRAME, rcSliceHeader.getSPS().getFrameMbsOnlyFlag() ));
+      continue; // already extended, other views are reading it
     }
+    RNOK( m_pcRefPlaneCache->extendFrame( pcRefFrame, pcQuarterPelFilter, rcSliceHeader.getSPS().getFrameMbsOnlyFlag() ) );
   }
 
   if(bFieldPic)//lufeng
@@ -424,6 +458,7 @@ RecPicBuffer::ProcessRef(SliceHeader&   rcSliceHeader, RefFrameList&  rcList ,Re
   {
 	   for( uiPos = 0; uiPos < rcListTemp.getSize() ; uiPos++ )
 	   {
+		   if( ! m_pcRefPlaneCache->isValid( rcListTemp[uiPos+1] ) && ! xIsLent( rcListTemp[uiPos+1] ) )
 		   rcListTemp[uiPos+1]->getFullPelYuvBuffer()->fillMargin();//lufeng: for frame ref
 		 rcList.add(rcListTemp[uiPos+1]);
 	   }
@@ -547,6 +582,7 @@ RecPicBuffer::xDeleteData()
 
   m_cFreeRecPicBufUnitList += m_cUsedRecPicBufUnitList;
   m_cUsedRecPicBufUnitList.clear();
+  m_pcRefPlaneCache->clear();
 
   while( m_cFreeRecPicBufUnitList.size() )
   {
@@ -558,6 +594,7 @@ RecPicBuffer::xDeleteData()
     m_pcCurrRecPicBufUnit->destroy();
     m_pcCurrRecPicBufUnit = NULL;
   }
+  m_uiNumExtraUnits = 0;
   return Err::m_nOK;
 }
 
@@ -618,12 +655,59 @@ RecPicBuffer::xStorePicture( RecPicBufUnit* pcRecPicBufUnit,
   }
   RNOK( xDumpRecPicBuffer() );
 
-  m_pcCurrRecPicBufUnit = m_cFreeRecPicBufUnitList.popFront();
+  RNOK( xGetFreeRecPicBufUnit( m_pcCurrRecPicBufUnit ) );
 
   return Err::m_nOK;
 }
 
 
+ErrVal
+RecPicBuffer::xGetFreeRecPicBufUnit( RecPicBufUnit*& rpcRecPicBufUnit )
+{
+  while( true )
+  {
+    //===== a release after this point wakes up the wait below =====
+    UInt uiNumRemoved = ( m_pcMultiviewReferenceStore ? m_pcMultiviewReferenceStore->getNumRemoved() : 0 );
+
+    //===== first free unit whose picture is not lent to another view =====
+    RecPicBufUnitList::iterator iter  = m_cFreeRecPicBufUnitList.begin();
+    RecPicBufUnitList::iterator end   = m_cFreeRecPicBufUnitList.end  ();
+    for( ; iter != end; iter++ )
+    {
+      if( ! xIsLent( (*iter)->getRecFrame() ) )
+      {
+        rpcRecPicBufUnit = *iter;
+        m_cFreeRecPicBufUnitList.erase( iter );
+        m_pcRefPlaneCache->invalidate( rpcRecPicBufUnit->getRecFrame() );
+        return Err::m_nOK;
+      }
+    }
+
+    //===== the dependent views lag behind, the buffer grows by one unit, at most by the DPB size =====
+    if( m_uiNumExtraUnits < m_uiMaxFramesInDPB )
+    {
+      ROF( m_pcSPS );
+      RNOK( RecPicBufUnit::create( rpcRecPicBufUnit, *m_pcYuvBufferCtrlFullPel, *m_pcYuvBufferCtrlHalfPel, *m_pcSPS ) );
+      RNOK( rpcRecPicBufUnit->uninit() );
+      m_uiNumExtraUnits++;
+      return Err::m_nOK;
+    }
+
+    //===== then wait until a dependent view releases a picture, only lent units can become free =====
+    ROTRS( m_cFreeRecPicBufUnitList.empty(), Err::m_nERR );
+    ROTRS( NULL == m_pcMultiviewReferenceStore, Err::m_nERR );
+    RNOK( m_pcMultiviewReferenceStore->waitForRemoval( uiNumRemoved ) );
+  }
+}
+
+
+Bool
+RecPicBuffer::xIsLent( IntFrame* pcFrame )
+{
+  return ( m_pcMultiviewReferenceStore && m_pcMultiviewReferenceStore->isLent( pcFrame ) );
+}
+
+
 // ----------------------------------------------------------------------
 //
 // FUNCTION:	RemoveMultiviewRef
@@ -645,6 +729,8 @@ RecPicBuffer::xStorePicture( RecPicBufUnit* pcRecPicBufUnit,
 
 void RecPicBuffer::RemoveMultiviewRef
 (RecPicBufUnit* pcRecPicBufUnitToRemove)  {
+  if (pcRecPicBufUnitToRemove->getRecFrame()->isBorrowed())
+    pcRecPicBufUnitToRemove->getRecFrame()->giveBack();
   pcRecPicBufUnitToRemove->uninit();
   m_cUsedRecPicBufUnitList.remove   ( pcRecPicBufUnitToRemove );
   m_cFreeRecPicBufUnitList.push_back( pcRecPicBufUnitToRemove );
@@ -655,7 +741,9 @@ ErrVal
 RecPicBuffer::xOutput( PicBufferList& rcOutputList,
                        PicBufferList& rcUnusedList )
 {
-  ROTRS( m_cFreeRecPicBufUnitList.size(), Err::m_nOK );
+  //===== the buffer is full when it holds the DPB size and the current picture, =====
+  //===== the free units lent to the dependent views must not enlarge it         =====
+  ROTRS( m_cUsedRecPicBufUnitList.size() <= m_uiMaxFramesInDPB, Err::m_nOK );
 
   //===== smallest non-ref/output poc value =====
   Int                         iMinOutputPoc   = MSYS_INT_MAX;
@@ -727,7 +815,7 @@ RecPicBuffer::xOutput( PicBufferList& rcOutputList,
   RNOK( xClearBuffer() );
 
   //===== check =====
-  ROT( m_cFreeRecPicBufUnitList.empty() ); // this should never happen
+  ROT( m_cUsedRecPicBufUnitList.size() > m_uiMaxFramesInDPB ); // this should never happen
 
   return Err::m_nOK;
 }
@@ -1003,14 +1091,8 @@ RecPicBuffer::AddMultiviewRef( RecPicBufUnitList& recPicBufUnitList,
     if ( refDirection == (*iter)->GetMultiviewReferenceDirection() ) {
 			if(m_pcPicEncoder->derivation_Inter_View_Flag((*iter)->getViewId(), rcSliceheader)){                        //JVT-W056  Samsung
 				RecPicBufUnit* bufUnitToAdd = (*iter);   
-				if( 1)
-				{
-					RNOK( bufUnitToAdd->getRecFrame()->initHalfPel() );
-				}
-				if( ! bufUnitToAdd->getRecFrame()->isExtended() )
-				{
-					RNOK( bufUnitToAdd->getRecFrame()->extendFrame( pcQuarterPelFilter, FRAME, rcSliceheader.getSPS().getFrameMbsOnlyFlag() ));
-				}
+				// borrowed samples were extended by the reference view before it was published
+				RNOK( m_pcRefPlaneCache->extendFrame( bufUnitToAdd->getRecFrame(), pcQuarterPelFilter, rcSliceheader.getSPS().getFrameMbsOnlyFlag() ) );
 				rcList.add( bufUnitToAdd->getRecFrame()->getPic(rcSliceheader.getPicType()) );
 			}
     }
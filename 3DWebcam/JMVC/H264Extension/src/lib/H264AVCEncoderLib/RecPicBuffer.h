@@ -23,6 +23,8 @@ H264AVC_NAMESPACE_BEGIN
 enum MultiviewReferenceDirection { NOT_MULTIVIEW=0, FORWARD, BACKWARD };
 
 class PicEncoder;//JVT-W056
+class MultiviewReferenceStore;
+class RefPlaneCache;
 
 
 class RecPicBufUnit
@@ -126,6 +128,11 @@ public:
                                           PicBufferList&              rcUnusedList 
 					  ,MultiviewReferenceDirection refDirection = NOT_MULTIVIEW							  
 										  );
+  // inter-view reference that refers to the samples of pcRefViewFrame (see MultiviewReferenceStore)
+  ErrVal          initCurrRecPicBufUnit ( RecPicBufUnit*&             rpcCurrRecPicBufUnit,
+                                          IntFrame*                   pcRefViewFrame,
+                                          SliceHeader*                pcSliceHeader,
+                                          MultiviewReferenceDirection refDirection );
   ErrVal          store2                ( Bool isRef );       // just in order to trigger sliding window. -Dong
   ErrVal          store                 ( RecPicBufUnit*              pcRecPicBufUnit,
                                           SliceHeader*                pcSliceHeader,
@@ -167,11 +174,19 @@ ErrVal
   void    SetCodeAsVFrameFlag(const bool flag) { m_codeAsVFrame = flag; }
   bool    CodeAsVFrameP() const {return m_codeAsVFrame; }
   void		SetPictureEncoder(PicEncoder * picencoder) { m_pcPicEncoder = picencoder;}  //JVT-W056  Samsung
+  // pictures lent to other views through pcStore are neither modified nor reused
+  Void    setMultiviewReferenceStore( MultiviewReferenceStore* pcStore ) { m_pcMultiviewReferenceStore = pcStore; }
+  // margins and sub-pel planes of the reference pictures, kept until a picture buffer is reused
+  RefPlaneCache*  getRefPlaneCache() { return m_pcRefPlaneCache; }
+  // pictures kept for reference or output, each holds the PicBuffer of its original
+  UInt            getMaxFramesInDPB()  const { return m_uiMaxFramesInDPB; }
 
 private:
   ErrVal          xCreateData           ( UInt                        uiMaxFramesInDPB,
                                           const SequenceParameterSet& rcSPS );
   ErrVal          xDeleteData           ();
+  ErrVal          xGetFreeRecPicBufUnit ( RecPicBufUnit*&             rpcRecPicBufUnit );
+  Bool            xIsLent               ( IntFrame*                   pcFrame );
 
 
   //===== memory management =====
@@ -220,12 +235,17 @@ private:
   Bool                m_bInitDone;
   UInt                m_uiNumRefFrames;
   UInt                m_uiMaxFrameNum;
+  UInt                m_uiMaxFramesInDPB;
+  UInt                m_uiNumExtraUnits;  // units created for pictures lent to the dependent views
   UInt                m_uiLastRefFrameNum;
   RecPicBufUnitList   m_cUsedRecPicBufUnitList;
   RecPicBufUnitList   m_cFreeRecPicBufUnitList;
   RecPicBufUnit*      m_pcCurrRecPicBufUnit;
   PicEncoder*					m_pcPicEncoder;
   Bool                m_codeAsVFrame;
+  const SequenceParameterSet* m_pcSPS;
+  MultiviewReferenceStore*    m_pcMultiviewReferenceStore;
+  RefPlaneCache*              m_pcRefPlaneCache;
 
 };
 
@@ -0,0 +1,90 @@
+#include "H264AVCEncoderLib.h"
+#include "H264AVCCommonLib.h"
+#include "H264AVCCommonLib/QuarterPelFilter.h"
+#include "RefPlaneCache.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+RefPlaneCache::RefPlaneCache():
+  m_uiNumHits         ( 0 ),
+  m_uiNumComputations ( 0 )
+{
+}
+
+
+RefPlaneCache::~RefPlaneCache()
+{
+}
+
+
+ErrVal
+RefPlaneCache::create( RefPlaneCache*& rpcRefPlaneCache )
+{
+  rpcRefPlaneCache = new RefPlaneCache;
+  ROT( NULL == rpcRefPlaneCache );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+RefPlaneCache::destroy()
+{
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+RefPlaneCache::extendFrame( IntFrame*         pcFrame,
+                            QuarterPelFilter* pcQuarterPelFilter,
+                            Bool              bFrameMbsOnly )
+{
+  ROF( pcFrame );
+
+  //===== borrowed samples were extended by the reference view before they were published =====
+  if( pcFrame->isBorrowed() || isValid( pcFrame ) )
+  {
+    m_uiNumHits++;
+    return Err::m_nOK;
+  }
+
+  //===== a new half-pel buffer, the sub-pel search also reads samples outside the interpolated area =====
+  RNOK( pcFrame->initHalfPel() );
+  RNOK( pcFrame->extendFrame( pcQuarterPelFilter, FRAME, bFrameMbsOnly ) );
+  m_uiNumComputations++;
+
+  //===== the field buffers of interlaced sequences share the frame samples and their margins, they are not kept =====
+  if( bFrameMbsOnly )
+  {
+    m_cValidFrames.insert( pcFrame );
+  }
+
+  return Err::m_nOK;
+}
+
+
+Void
+RefPlaneCache::invalidate( IntFrame* pcFrame )
+{
+  ROFVS( m_cValidFrames.erase( pcFrame ) );
+  pcFrame->clearExtended();
+}
+
+
+Void
+RefPlaneCache::clear()
+{
+  m_cValidFrames.clear();
+}
+
+
+Bool
+RefPlaneCache::isValid( IntFrame* pcFrame ) const
+{
+  return ( m_cValidFrames.find( pcFrame ) != m_cValidFrames.end() && pcFrame->isExtended() );
+}
+
+
+H264AVC_NAMESPACE_END
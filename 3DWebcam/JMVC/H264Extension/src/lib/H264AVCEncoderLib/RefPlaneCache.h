@@ -0,0 +1,53 @@
+#if !defined(AFX_REFPLANECACHE_H__3D6E0B9A_71C4_4F25_A8E3_5C2B94D07F16__INCLUDED_)
+#define AFX_REFPLANECACHE_H__3D6E0B9A_71C4_4F25_A8E3_5C2B94D07F16__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "H264AVCCommonLib/IntFrame.h"
+#include <set>
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+class QuarterPelFilter;
+
+
+//===== padded margins and sub-pel planes of the reconstructed pictures of a view, computed when a picture is first =====
+//===== used as reference and kept for all slices, both lists, the following pictures and (through the              =====
+//===== MultiviewReferenceStore) the views predicting from it, until the RecPicBuffer reuses the picture buffer     =====
+class RefPlaneCache
+{
+protected:
+  RefPlaneCache();
+  virtual ~RefPlaneCache();
+
+public:
+  static ErrVal create( RefPlaneCache*& rpcRefPlaneCache );
+  ErrVal destroy();
+
+  //===== pads and interpolates pcFrame unless its planes are still valid =====
+  ErrVal extendFrame  ( IntFrame*         pcFrame,
+                        QuarterPelFilter* pcQuarterPelFilter,
+                        Bool              bFrameMbsOnly );
+  //===== the samples of pcFrame are about to change =====
+  Void   invalidate   ( IntFrame*         pcFrame );
+  Void   clear        ();
+  Bool   isValid      ( IntFrame*         pcFrame ) const;
+
+  UInt   getNumHits         ()  const { return m_uiNumHits; }
+  UInt   getNumComputations ()  const { return m_uiNumComputations; }
+
+protected:
+  std::set<const IntFrame*> m_cValidFrames;
+  UInt                      m_uiNumHits;
+  UInt                      m_uiNumComputations;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_REFPLANECACHE_H__3D6E0B9A_71C4_4F25_A8E3_5C2B94D07F16__INCLUDED_)
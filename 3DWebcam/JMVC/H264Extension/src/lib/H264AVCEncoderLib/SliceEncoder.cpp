@@ -9,6 +9,12 @@
 #include "H264AVCCommonLib/Transform.h"
 
 #include "H264AVCCommonLib/CFMO.h"
+#include "H264AVCCommonLib/YuvBufferCtrl.h"
+#include "MbAnalysisLane.h"
+#include "SliceWorker.h"
+#include "NalUnitPool.h"
+
+#include <omp.h>
 
 H264AVC_NAMESPACE_BEGIN
 
@@ -30,7 +36,17 @@ SliceEncoder::SliceEncoder():
 , m_ppuiPdsInitialDelayMinus2L0(0)
 , m_ppuiPdsInitialDelayMinus2L1(0)
 //~JVT-W080
+, m_uiNumMbAnalysisLanes      (0)
+, m_piRowProgress             (NULL)
+, m_uiMaxMbInCol              (0)
+, m_uiNumSliceWorkers         (0)
+, m_ppcSliceNalUnit           (NULL)
+, m_puiSliceBits              (NULL)
+, m_uiMaxNumSlices            (0)
+, m_pcNalUnitPool             (NULL)
 {
+  ::memset( m_apcMbAnalysisLane, 0x00, sizeof( m_apcMbAnalysisLane ) );
+  ::memset( m_apcSliceWorker,    0x00, sizeof( m_apcSliceWorker ) );
 }
 
 
@@ -50,6 +66,9 @@ ErrVal SliceEncoder::create( SliceEncoder*& rpcSliceEncoder )
 
 ErrVal SliceEncoder::destroy()
 {
+  delete [] const_cast<Int*>( m_piRowProgress );
+  delete [] m_ppcSliceNalUnit;
+  delete [] m_puiSliceBits;
   delete this;
   return Err::m_nOK;
 }
@@ -61,7 +80,12 @@ ErrVal SliceEncoder::init( MbEncoder* pcMbEncoder,
                            ControlMngIf* pcControlMng,
                            CodingParameter* pcCodingParameter,
                            PocCalculator* pcPocCalculator,
-                           Transform* pcTransform)
+                           Transform* pcTransform,
+                           UInt uiNumMbAnalysisLanes,
+                           MbAnalysisLane** ppcMbAnalysisLane,
+                           UInt uiNumSliceWorkers,
+                           SliceWorker** ppcSliceWorker,
+                           NalUnitPool* pcNalUnitPool )
 {
   ROT( m_bInitDone );
   ROT( NULL == pcMbEncoder );
@@ -69,6 +93,23 @@ ErrVal SliceEncoder::init( MbEncoder* pcMbEncoder,
   ROT( NULL == pcControlMng );
   ROT( NULL == pcPocCalculator );
   ROT( NULL == pcTransform );
+  ROT( uiNumMbAnalysisLanes > MAX_WAVEFRONT_LANES );
+  ROT( uiNumMbAnalysisLanes && NULL == ppcMbAnalysisLane );
+  ROT( uiNumSliceWorkers > MAX_WAVEFRONT_LANES );
+  ROT( uiNumSliceWorkers && NULL == ppcSliceWorker );
+  ROT( uiNumSliceWorkers && NULL == pcNalUnitPool );
+
+  m_uiNumMbAnalysisLanes = uiNumMbAnalysisLanes;
+  for( UInt uiLane = 0; uiLane < uiNumMbAnalysisLanes; uiLane++ )
+  {
+    m_apcMbAnalysisLane[uiLane] = ppcMbAnalysisLane[uiLane];
+  }
+  m_uiNumSliceWorkers = uiNumSliceWorkers;
+  for( UInt uiWorker = 0; uiWorker < uiNumSliceWorkers; uiWorker++ )
+  {
+    m_apcSliceWorker[uiWorker] = ppcSliceWorker[uiWorker];
+  }
+  m_pcNalUnitPool = pcNalUnitPool;
 
   m_pcTransform = pcTransform;
   m_pcMbEncoder = pcMbEncoder;
@@ -94,6 +135,11 @@ ErrVal SliceEncoder::uninit()
   m_pcMbEncoder =  NULL;
   m_pcMbCoder =  NULL;
   m_pcControlMng =  NULL;
+  m_uiNumMbAnalysisLanes = 0;
+  ::memset( m_apcMbAnalysisLane, 0x00, sizeof( m_apcMbAnalysisLane ) );
+  m_uiNumSliceWorkers = 0;
+  ::memset( m_apcSliceWorker,    0x00, sizeof( m_apcSliceWorker ) );
+  m_pcNalUnitPool = NULL;
   m_bInitDone = false;
 
   m_uiFrameCount = 0;
@@ -126,18 +172,7 @@ SliceEncoder::encodeSlice( SliceHeader&  rcSliceHeader,
   //===== initialization =====
   RNOK( pcMbDataCtrl  ->initSlice         ( rcSliceHeader, ENCODE_PROCESS, false, pcMbDataCtrlL1 ) );
   RNOK( m_pcControlMng->initSliceForCoding( rcSliceHeader ) );
-
-	UInt uiPos;
-	for( uiPos = 0; uiPos < rcList0.getActive(); uiPos++ )
-    {
-	  IntFrame* pcRefFrame = rcList0.getEntry(uiPos);
-	  pcRefFrame->getFullPelYuvBuffer()->fillMargin();
-	}
-	for( uiPos = 0; uiPos < rcList1.getActive(); uiPos++ )
-    {
-	  IntFrame* pcRefFrame = rcList1.getEntry(uiPos);
-	  pcRefFrame->getFullPelYuvBuffer()->fillMargin();
-	}
+  RNOK( fillRefFrameMargins( rcList0, rcList1 ) );
 	//lufeng:frame/field margin
 
 //JVT-W080
@@ -152,6 +187,11 @@ SliceEncoder::encodeSlice( SliceHeader&  rcSliceHeader,
 		m_pcMbEncoder->setPdsInitialDelayMinus2L1( ppuiPdsInitialDelayMinus2L1[rcSliceHeader.getViewId()] );
 	}
 //~JVT-W080
+  if( xUseWavefront( rcSliceHeader ) )
+  {
+    return xEncodeSliceWavefront( rcSliceHeader, pcFrame, pcMbDataCtrl, rcList0, rcList1, uiMbInRow, dlambda );
+  }
+
   //===== loop over macroblocks =====
   for( UInt uiMbAddress = rcSliceHeader.getFirstMbInSlice(); uiMbAddress <= rcSliceHeader.getLastMbInSlice(); uiMbAddress = rcSliceHeader.getFMO()->getNextMBNr( uiMbAddress ) )
   {
@@ -193,6 +233,275 @@ SliceEncoder::encodeSlice( SliceHeader&  rcSliceHeader,
 }
 
 
+ErrVal
+SliceEncoder::fillRefFrameMargins( RefFrameList& rcList0, RefFrameList& rcList1 )
+{
+	//----- extended frames are already padded (and may be read by other views at the same time) -----
+	UInt uiPos;
+	for( uiPos = 0; uiPos < rcList0.getActive(); uiPos++ )
+    {
+	  IntFrame* pcRefFrame = rcList0.getEntry(uiPos);
+	  if( ! pcRefFrame->isExtended() )
+	  {
+	    pcRefFrame->getFullPelYuvBuffer()->fillMargin();
+	  }
+	}
+	for( uiPos = 0; uiPos < rcList1.getActive(); uiPos++ )
+    {
+	  IntFrame* pcRefFrame = rcList1.getEntry(uiPos);
+	  if( ! pcRefFrame->isExtended() )
+	  {
+	    pcRefFrame->getFullPelYuvBuffer()->fillMargin();
+	  }
+	}
+
+  return Err::m_nOK;
+}
+
+
+Bool
+SliceEncoder::xUseWavefront( const SliceHeader& rcSliceHeader ) const
+{
+  //===== the lanes work on frame macroblocks of the base layer in raster order =====
+  return m_uiNumMbAnalysisLanes > 1                         &&
+         ! getPdsEnable()                                   &&
+         rcSliceHeader.getPicType() == FRAME                &&
+         rcSliceHeader.getSPS().getLayerId() == 0           &&
+         rcSliceHeader.getPPS().getNumSliceGroupsMinus1() == 0;
+}
+
+
+ErrVal
+SliceEncoder::xCreateRowProgress( UInt uiMbInCol )
+{
+  ROTRS( uiMbInCol <= m_uiMaxMbInCol, Err::m_nOK );
+
+  delete [] const_cast<Int*>( m_piRowProgress );
+  m_piRowProgress = new Int[ uiMbInCol ];
+  ROT( NULL == m_piRowProgress );
+
+  m_uiMaxMbInCol = uiMbInCol;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceEncoder::xEncodeSliceWavefront( SliceHeader&  rcSliceHeader,
+                                     IntFrame*     pcFrame,
+                                     MbDataCtrl*   pcMbDataCtrl,
+                                     RefFrameList& rcList0,
+                                     RefFrameList& rcList1,
+                                     UInt          uiMbInRow,
+                                     Double        dlambda )
+{
+  const Int iMbInRow  = (Int)uiMbInRow;
+  const Int iFirstMb  = (Int)rcSliceHeader.getFirstMbInSlice();
+  const Int iLastMb   = (Int)rcSliceHeader.getLastMbInSlice();
+  const Int iFirstRow = iFirstMb / iMbInRow;
+  const Int iLastRow  = iLastMb  / iMbInRow;
+  const Int iNumLanes = (Int)m_uiNumMbAnalysisLanes;
+
+  RNOK( xCreateRowProgress( iLastRow + 1 ) );
+
+  for( Int iLane = 0; iLane < iNumLanes; iLane++ )
+  {
+    RNOK( m_apcMbAnalysisLane[iLane]->initSlice( rcSliceHeader, pcMbDataCtrl->getSliceId() ) );
+  }
+  for( Int iMbY = iFirstRow; iMbY <= iLastRow; iMbY++ )
+  {
+    m_piRowProgress[iMbY] = ( iMbY == iFirstRow ? iFirstMb % iMbInRow : 0 );
+  }
+
+  //===== mode decision: a macroblock is analysed when the row above is finished up to the macroblock =====
+  //===== above right, so that intra prediction and motion vector prediction see their final neighbours =====
+  Bool bError = false;
+#pragma omp parallel num_threads( iNumLanes )
+  {
+    const Int iLane = omp_get_thread_num();
+    YuvBufferCtrl::setMbLane( iLane );
+
+#pragma omp for schedule( dynamic, 1 )
+    for( Int iMbY = iFirstRow; iMbY <= iLastRow; iMbY++ )
+    {
+      const Int iStartX = ( iMbY == iFirstRow ? iFirstMb % iMbInRow     : 0        );
+      const Int iStopX  = ( iMbY == iLastRow  ? iLastMb  % iMbInRow + 1 : iMbInRow );
+
+      for( Int iMbX = iStartX; iMbX < iStopX; iMbX++ )
+      {
+        if( iMbY > iFirstRow )
+        {
+          const Int iRequired = min( iMbX + 2, iMbInRow );
+          while( m_piRowProgress[iMbY-1] < iRequired )
+          {
+#pragma omp flush
+          }
+        }
+
+        //----- after an error the rows are only marked as done, so that no lane waits forever -----
+        if( ! bError &&
+            Err::m_nOK != m_apcMbAnalysisLane[iLane]->analyseMb( pcMbDataCtrl, pcFrame, rcList0, rcList1,
+                                                                 (UInt)iMbY, (UInt)iMbX, dlambda ) )
+        {
+          bError = true;
+        }
+#pragma omp flush
+        m_piRowProgress[iMbY] = iMbX + 1;
+#pragma omp flush
+      }
+    }
+
+    YuvBufferCtrl::setMbLane( 0 );
+  }
+  ROT( bError );
+
+  //===== entropy coding in raster order =====
+  for( UInt uiMbAddress = rcSliceHeader.getFirstMbInSlice(); uiMbAddress <= rcSliceHeader.getLastMbInSlice(); uiMbAddress++ )
+  {
+    ETRACE_NEWMB( uiMbAddress );
+
+    UInt          uiMbY           = uiMbAddress / uiMbInRow;
+    UInt          uiMbX           = uiMbAddress % uiMbInRow;
+    MbDataAccess* pcMbDataAccess  = 0;
+
+    RNOK( pcMbDataCtrl    ->initMb          (  pcMbDataAccess, uiMbY, uiMbX ) );
+    RNOK( m_pcControlMng  ->initMbForCoding ( *pcMbDataAccess, uiMbY, uiMbX, 0, 0 ) );
+
+    RNOK( m_pcMbCoder     ->encode          ( *pcMbDataAccess, NULL, SST_RATIO_1,
+                                               ( uiMbAddress == rcSliceHeader.getLastMbInSlice() ), true ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+Bool
+SliceEncoder::isSliceParallel( const SliceHeader& rcSliceHeader ) const
+{
+  //===== the workers encode frame macroblocks of the base layer, slice by slice in raster order =====
+  return m_uiNumSliceWorkers > 1                            &&
+         ! getPdsEnable()                                   &&
+         rcSliceHeader.getPicType() == FRAME                &&
+         ! rcSliceHeader.isMbAff()                          &&
+         rcSliceHeader.getSPS().getLayerId() == 0           &&
+         rcSliceHeader.getPPS().getNumSliceGroupsMinus1() == 0;
+}
+
+
+ErrVal
+SliceEncoder::xCreateSliceBuffers( UInt uiNumSlices )
+{
+  ROTRS( uiNumSlices <= m_uiMaxNumSlices, Err::m_nOK );
+
+  delete [] m_ppcSliceNalUnit;
+  delete [] m_puiSliceBits;
+  m_ppcSliceNalUnit = new ExtBinDataAccessor* [ uiNumSlices ];
+  m_puiSliceBits    = new UInt                [ uiNumSlices ];
+  ROT( NULL == m_ppcSliceNalUnit );
+  ROT( NULL == m_puiSliceBits );
+
+  m_uiMaxNumSlices = uiNumSlices;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceEncoder::encodeSlicesParallel( SliceHeader&            rcSliceHeader,
+                                    UInt                    uiMbsPerSlice,
+                                    IntFrame*               pcFrame,
+                                    MbDataCtrl*             pcMbDataCtrl,
+                                    RefFrameList&           rcList0,
+                                    RefFrameList&           rcList1,
+                                    UInt                    uiMbInRow,
+                                    Double                  dlambda,
+                                    ExtBinDataAccessorList& rcNalUnitList,
+                                    UInt&                   ruiBits )
+{
+  ROF( pcFrame );
+  ROF( pcMbDataCtrl );
+  ROF( uiMbsPerSlice );
+  ROF( isSliceParallel( rcSliceHeader ) );
+
+  const UInt uiFirstMb    = rcSliceHeader.getFirstMbInSlice();
+  const UInt uiLastMb     = rcSliceHeader.getLastMbInSlice ();
+  const Int  iNumSlices   = (Int)( ( uiLastMb - uiFirstMb ) / uiMbsPerSlice + 1 );
+  const Int  iNumWorkers  = (Int)min( m_uiNumSliceWorkers, (UInt)iNumSlices );
+
+  RNOK( xCreateSliceBuffers( iNumSlices ) );
+
+  //===== get co-located picture =====
+  MbDataCtrl* pcMbDataCtrlL1 = NULL;
+  if( rcList1.getActive() && rcList1.getEntry( 0 )->getRecPicBufUnit() )
+  {
+    pcMbDataCtrlL1 = rcList1.getEntry( 0 )->getRecPicBufUnit()->getMbDataCtrl();
+  }
+  ROT( rcSliceHeader.isInterB() && ! pcMbDataCtrlL1 );
+
+  //===== the slices are registered one after another, so they get consecutive slice ids as in serial encoding =====
+  UInt uiFirstSliceId = 0;
+  for( Int iSlice = 0; iSlice < iNumSlices; iSlice++ )
+  {
+    UInt uiSliceFirstMb = uiFirstMb + iSlice * uiMbsPerSlice;
+    rcSliceHeader.setFirstMbInSlice( uiSliceFirstMb );
+    rcSliceHeader.setLastMbInSlice ( min( uiSliceFirstMb + uiMbsPerSlice - 1, uiLastMb ) );
+    RNOK( pcMbDataCtrl->initSlice( rcSliceHeader, ENCODE_PROCESS, false, pcMbDataCtrlL1 ) );
+    if( 0 == iSlice )
+    {
+      uiFirstSliceId = pcMbDataCtrl->getSliceId();
+    }
+    m_ppcSliceNalUnit [iSlice] = NULL;
+    m_puiSliceBits    [iSlice] = 0;
+  }
+  RNOK( fillRefFrameMargins( rcList0, rcList1 ) );
+
+  //===== neighbours in other slices are unavailable, so the slices do not depend on each other =====
+  Bool bError = false;
+#pragma omp parallel num_threads( iNumWorkers )
+  {
+    const Int iWorker = omp_get_thread_num();
+    YuvBufferCtrl::setMbLane( iWorker );
+
+#pragma omp for schedule( dynamic, 1 )
+    for( Int iSlice = 0; iSlice < iNumSlices; iSlice++ )
+    {
+      UInt uiSliceFirstMb = uiFirstMb + iSlice * uiMbsPerSlice;
+      UInt uiSliceLastMb  = min( uiSliceFirstMb + uiMbsPerSlice - 1, uiLastMb );
+
+      if( ! bError &&
+          Err::m_nOK != m_apcSliceWorker[iWorker]->encodeSlice( rcSliceHeader, uiFirstSliceId + iSlice,
+                                                                uiSliceFirstMb, uiSliceLastMb,
+                                                                pcFrame, pcMbDataCtrl, rcList0, rcList1,
+                                                                uiMbInRow, dlambda,
+                                                                m_ppcSliceNalUnit[iSlice], m_puiSliceBits[iSlice] ) )
+      {
+        bError = true;
+      }
+    }
+
+    YuvBufferCtrl::setMbLane( 0 );
+  }
+
+  //===== hand over the NAL units in slice order =====
+  for( Int iSlice = 0; iSlice < iNumSlices; iSlice++ )
+  {
+    ExtBinDataAccessor* pcNalUnit = m_ppcSliceNalUnit[iSlice];
+    if( NULL == pcNalUnit )
+    {
+      continue;
+    }
+    if( bError )
+    {
+      m_pcNalUnitPool->releaseNalUnit( pcNalUnit );
+      continue;
+    }
+    rcNalUnitList.push_back( pcNalUnit );
+    ruiBits += m_puiSliceBits[iSlice];
+  }
+  ROT( bError );
+
+  return Err::m_nOK;
+}
+
+
 /*
 * lufeng: MbAff Slice encoding
 */
@@ -16,6 +16,9 @@ H264AVC_NAMESPACE_BEGIN
 class CodingParameter;
 class MbCoder;
 class PocCalculator;
+class MbAnalysisLane;
+class SliceWorker;
+class NalUnitPool;
 
 
 class SliceEncoder
@@ -32,7 +35,12 @@ public:
                ControlMngIf* pcControlMng,
                CodingParameter* pcCodingParameter,
                PocCalculator* pcPocCalculator,
-               Transform* pcTransform);
+               Transform* pcTransform,
+               UInt uiNumMbAnalysisLanes = 0,
+               MbAnalysisLane** ppcMbAnalysisLane = NULL,
+               UInt uiNumSliceWorkers = 0,
+               SliceWorker** ppcSliceWorker = NULL,
+               NalUnitPool* pcNalUnitPool = NULL );
 
   ErrVal uninit();
 
@@ -47,6 +55,21 @@ public:
                                         RefFrameList& rcList1,
                                         UInt          uiMbInRow,
                                         Double        dlambda	);
+  ErrVal      fillRefFrameMargins     ( RefFrameList& rcList0,
+                                        RefFrameList& rcList1 );
+
+  //===== slices of uiMbsPerSlice macroblocks, encoded by the slice workers; the NAL units are appended in slice order =====
+  Bool        isSliceParallel         ( const SliceHeader& rcSliceHeader ) const;
+  ErrVal      encodeSlicesParallel    ( SliceHeader&            rcSliceHeader,
+                                        UInt                    uiMbsPerSlice,
+                                        IntFrame*               pcFrame,
+                                        MbDataCtrl*             pcMbDataCtrl,
+                                        RefFrameList&           rcList0,
+                                        RefFrameList&           rcList1,
+                                        UInt                    uiMbInRow,
+                                        Double                  dlambda,
+                                        ExtBinDataAccessorList& rcNalUnitList,
+                                        UInt&                   ruiBits );
   ErrVal      encodeSliceMbAff             ( SliceHeader&  rcSliceHeader,
                                       IntFrame*     pcFrame,
                                       MbDataCtrl*   pcMbDataCtrl,
@@ -54,6 +77,20 @@ public:
                                       RefFrameList& rcList1,
                                       UInt          uiMbInRow,
                                       Double        dlambda	);
+protected:
+  //===== mode decision in a wavefront over the macroblock rows, entropy coding afterwards in raster order =====
+  Bool        xUseWavefront           ( const SliceHeader& rcSliceHeader ) const;
+  ErrVal      xEncodeSliceWavefront   ( SliceHeader&  rcSliceHeader,
+                                        IntFrame*     pcFrame,
+                                        MbDataCtrl*   pcMbDataCtrl,
+                                        RefFrameList& rcList0,
+                                        RefFrameList& rcList1,
+                                        UInt          uiMbInRow,
+                                        Double        dlambda	);
+  ErrVal      xCreateRowProgress      ( UInt uiMbInCol );
+  ErrVal      xCreateSliceBuffers     ( UInt uiNumSlices );
+
+public:
 //TMM_WP
   ErrVal xSetPredWeights( SliceHeader& rcSliceHeader, 
                           IntFrame* pOrgFrame,
@@ -97,6 +134,16 @@ protected:
 	UInt** m_ppuiPdsInitialDelayMinus2L0;
 	UInt** m_ppuiPdsInitialDelayMinus2L1;
 //~JVT-W080
+  UInt            m_uiNumMbAnalysisLanes;
+  MbAnalysisLane* m_apcMbAnalysisLane[MAX_WAVEFRONT_LANES];
+  volatile Int*   m_piRowProgress;    // analysed macroblocks per row, read by the row below
+  UInt            m_uiMaxMbInCol;
+  UInt                  m_uiNumSliceWorkers;
+  SliceWorker*          m_apcSliceWorker[MAX_WAVEFRONT_LANES];
+  ExtBinDataAccessor**  m_ppcSliceNalUnit;    // NAL units of the slices of the current picture, in slice order
+  UInt*                 m_puiSliceBits;
+  UInt                  m_uiMaxNumSlices;
+  NalUnitPool*          m_pcNalUnitPool;
 
 };
 
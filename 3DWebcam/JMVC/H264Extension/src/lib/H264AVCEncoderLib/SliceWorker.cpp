@@ -0,0 +1,206 @@
+#include "H264AVCEncoderLib.h"
+#include "SliceWorker.h"
+#include "MbAnalysisLane.h"
+#include "BitWriteBuffer.h"
+#include "BitCounter.h"
+#include "UvlcWriter.h"
+#include "CabacWriter.h"
+#include "NalUnitEncoder.h"
+#include "NalUnitPool.h"
+
+#include <new>
+
+
+H264AVC_NAMESPACE_BEGIN
+
+
+SliceWorker::SliceWorker():
+  m_pcMbAnalysisLane      ( NULL ),
+  m_pcBitWriteBuffer      ( NULL ),
+  m_pcBitCounter          ( NULL ),
+  m_pcUvlcWriter          ( NULL ),
+  m_pcUvlcTester          ( NULL ),
+  m_pcCabacWriter         ( NULL ),
+  m_pcNalUnitEncoder      ( NULL ),
+  m_pcNalUnitPool         ( NULL ),
+  m_pucWriteBuffer        ( NULL ),
+  m_uiWriteBufferSize     ( 0 ),
+  m_pvSliceHeaderMem      ( NULL ),
+  m_pcSliceHeader         ( NULL ),
+  m_bInitDone             ( false )
+{
+}
+
+
+SliceWorker::~SliceWorker()
+{
+}
+
+
+ErrVal
+SliceWorker::create( SliceWorker*& rpcSliceWorker )
+{
+  rpcSliceWorker = new SliceWorker;
+  ROT( NULL == rpcSliceWorker );
+
+  SliceWorker* p = rpcSliceWorker;
+  RNOK( MbAnalysisLane  ::create( p->m_pcMbAnalysisLane ) );
+  RNOK( BitWriteBuffer  ::create( p->m_pcBitWriteBuffer ) );
+  RNOK( BitCounter      ::create( p->m_pcBitCounter ) );
+  RNOK( UvlcWriter      ::create( p->m_pcUvlcWriter, false ) );
+  RNOK( UvlcWriter      ::create( p->m_pcUvlcTester, false ) );
+  RNOK( CabacWriter     ::create( p->m_pcCabacWriter ) );
+  RNOK( NalUnitEncoder  ::create( p->m_pcNalUnitEncoder ) );
+
+  p->m_pvSliceHeaderMem = ::operator new( sizeof( SliceHeader ) );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceWorker::destroy()
+{
+  RNOK( m_pcMbAnalysisLane  ->destroy() );
+  RNOK( m_pcBitWriteBuffer  ->destroy() );
+  RNOK( m_pcBitCounter      ->destroy() );
+  RNOK( m_pcUvlcWriter      ->destroy() );
+  RNOK( m_pcUvlcTester      ->destroy() );
+  RNOK( m_pcCabacWriter     ->destroy() );
+  RNOK( m_pcNalUnitEncoder  ->destroy() );
+  ::operator delete( m_pvSliceHeaderMem );
+
+  m_cBinData.reset();
+  delete [] m_pucWriteBuffer;
+
+  delete this;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceWorker::init( CodingParameter*  pcCodingParameter,
+                   QuarterPelFilter* pcQuarterPelFilter,
+                   YuvBufferCtrl*    pcYuvFullPelBufferCtrl,
+                   YuvBufferCtrl*    pcYuvHalfPelBufferCtrl,
+                   NalUnitPool*      pcNalUnitPool )
+{
+  ROT( m_bInitDone );
+  ROF( pcNalUnitPool );
+
+  //===== same set-up as the shared writers in CreaterH264AVCEncoder::init() =====
+  RNOK( m_pcBitWriteBuffer  ->init() );
+  RNOK( m_pcBitCounter      ->init() );
+  RNOK( m_pcNalUnitEncoder  ->init( m_pcBitWriteBuffer, m_pcUvlcWriter, m_pcUvlcTester ) );
+  RNOK( m_pcUvlcWriter      ->init( m_pcBitWriteBuffer ) );
+  RNOK( m_pcUvlcTester      ->init( m_pcBitCounter ) );
+  RNOK( m_pcCabacWriter     ->init( m_pcBitWriteBuffer ) );
+  RNOK( m_pcMbAnalysisLane  ->init( pcCodingParameter,
+                                    pcQuarterPelFilter,
+                                    pcYuvFullPelBufferCtrl,
+                                    pcYuvHalfPelBufferCtrl ) );
+  m_pcNalUnitPool = pcNalUnitPool;
+
+  m_bInitDone = true;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceWorker::uninit()
+{
+  ROF( m_bInitDone );
+
+  RNOK( m_pcMbAnalysisLane  ->uninit() );
+  RNOK( m_pcNalUnitEncoder  ->uninit() );
+  RNOK( m_pcBitWriteBuffer  ->uninit() );
+  RNOK( m_pcBitCounter      ->uninit() );
+  RNOK( m_pcUvlcWriter      ->uninit() );
+  RNOK( m_pcUvlcTester      ->uninit() );
+  RNOK( m_pcCabacWriter     ->uninit() );
+
+  m_bInitDone = false;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceWorker::xCreateWriteBuffer( UInt uiMbInPic )
+{
+  //===== as PicEncoder::xCreateData(), a slice never needs more than the whole picture =====
+  UInt uiWriteBufferSize = 3 * ( uiMbInPic * 16 * 16 );
+  ROTRS( uiWriteBufferSize <= m_uiWriteBufferSize, Err::m_nOK );
+
+  m_cBinData.reset();
+  delete [] m_pucWriteBuffer;
+  ROFS( ( m_pucWriteBuffer = new UChar [ uiWriteBufferSize ] ) );
+
+  m_uiWriteBufferSize = uiWriteBufferSize;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+SliceWorker::encodeSlice( const SliceHeader&   rcSH,
+                          UInt                 uiSliceId,
+                          UInt                 uiFirstMb,
+                          UInt                 uiLastMb,
+                          IntFrame*            pcFrame,
+                          MbDataCtrl*          pcMbDataCtrl,
+                          RefFrameList&        rcList0,
+                          RefFrameList&        rcList1,
+                          UInt                 uiMbInRow,
+                          Double               dLambda,
+                          ExtBinDataAccessor*& rpcNalUnit,
+                          UInt&                ruiBits )
+{
+  ROF( m_bInitDone );
+  ROF( pcFrame );
+  ROF( pcMbDataCtrl );
+  ROT( uiFirstMb > uiLastMb );
+
+  rpcNalUnit  = NULL;
+  ruiBits     = 0;
+
+  //===== the other workers code slices of the same picture, so the slice range is set in a member-wise copy (see MbAnalysisLane) =====
+  m_pcSliceHeader = new ( m_pvSliceHeaderMem ) SliceHeader( rcSH );
+  m_pcSliceHeader->setFirstMbInSlice( uiFirstMb );
+  m_pcSliceHeader->setLastMbInSlice ( uiLastMb );
+
+  //===== init NAL unit and write slice header, as PicEncoder::xEncodePicture() =====
+  RNOK( xCreateWriteBuffer( m_pcSliceHeader->getMbInPic() ) );
+  m_cBinData.reset          ();
+  m_cBinData.set            ( m_pucWriteBuffer, m_uiWriteBufferSize );
+  m_cBinData.setMemAccessor ( m_cExtBinDataAccessor );
+
+  RNOK( m_pcNalUnitEncoder->initNalUnit( &m_cExtBinDataAccessor ) );
+  RNOK( m_pcNalUnitEncoder->write      ( *m_pcSliceHeader ) );
+
+  //===== loop over macroblocks =====
+  MbSymbolWriteIf* pcMbSymbolWriteIf = ( m_pcSliceHeader->getPPS().getEntropyCodingModeFlag() ?
+                                         (MbSymbolWriteIf*)m_pcCabacWriter : (MbSymbolWriteIf*)m_pcUvlcWriter );
+  RNOK( m_pcMbAnalysisLane->initSlice( *m_pcSliceHeader, uiSliceId, pcMbSymbolWriteIf ) );
+
+  for( UInt uiMbAddress = uiFirstMb; uiMbAddress <= uiLastMb; uiMbAddress++ )
+  {
+    RNOK( m_pcMbAnalysisLane->analyseMb( pcMbDataCtrl, pcFrame, rcList0, rcList1,
+                                         uiMbAddress / uiMbInRow, uiMbAddress % uiMbInRow, dLambda ) );
+    RNOK( m_pcMbAnalysisLane->codeMb   ( uiMbAddress == uiLastMb ) );
+  }
+
+  //===== close NAL unit and hand a copy of it to the caller, as PicEncoder::xAppendNewExtBinDataAccessor() =====
+  UInt uiBits = 0;
+  RNOK( m_pcNalUnitEncoder->closeNalUnit( uiBits ) );
+  RNOK( m_pcNalUnitPool   ->getNalUnit  ( rpcNalUnit, m_cExtBinDataAccessor ) );
+  m_cBinData.reset();
+
+  ruiBits = uiBits + 4*8;
+
+  return Err::m_nOK;
+}
+
+
+H264AVC_NAMESPACE_END
@@ -0,0 +1,83 @@
+#if !defined(AFX_SLICEWORKER_H__5E0C1F47_2B8D_4C61_A3F2_8D17B4C9E206__INCLUDED_)
+#define AFX_SLICEWORKER_H__5E0C1F47_2B8D_4C61_A3F2_8D17B4C9E206__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+#include "MbEncoder.h"
+
+
+H264AVC_NAMESPACE_BEGIN
+
+class CodingParameter;
+class QuarterPelFilter;
+class YuvBufferCtrl;
+class BitWriteBuffer;
+class BitCounter;
+class UvlcWriter;
+class CabacWriter;
+class NalUnitEncoder;
+class MbAnalysisLane;
+class NalUnitPool;
+
+
+//===== encodes complete slices into NAL units of its own, so that the slices of a picture are encoded on several threads =====
+//===== the worker has its own analysis lane and entropy coders; macroblock data and pictures are shared with the other workers =====
+class SliceWorker
+{
+protected:
+  SliceWorker();
+  virtual ~SliceWorker();
+
+public:
+  static ErrVal create( SliceWorker*& rpcSliceWorker );
+  ErrVal destroy();
+  ErrVal init( CodingParameter*  pcCodingParameter,
+               QuarterPelFilter* pcQuarterPelFilter,
+               YuvBufferCtrl*    pcYuvFullPelBufferCtrl,
+               YuvBufferCtrl*    pcYuvHalfPelBufferCtrl,
+               NalUnitPool*      pcNalUnitPool );
+  ErrVal uninit();
+
+  //===== the slice must have been initialized in pcMbDataCtrl (uiSliceId) and the calling thread must have selected =====
+  //===== the macroblock offsets of this worker (YuvBufferCtrl::setMbLane); rpcNalUnit is taken from the NalUnitPool =====
+  ErrVal encodeSlice( const SliceHeader&   rcSH,
+                      UInt                 uiSliceId,
+                      UInt                 uiFirstMb,
+                      UInt                 uiLastMb,
+                      IntFrame*            pcFrame,
+                      MbDataCtrl*          pcMbDataCtrl,
+                      RefFrameList&        rcList0,
+                      RefFrameList&        rcList1,
+                      UInt                 uiMbInRow,
+                      Double               dLambda,
+                      ExtBinDataAccessor*& rpcNalUnit,
+                      UInt&                ruiBits );
+
+protected:
+  ErrVal xCreateWriteBuffer( UInt uiMbInPic );
+
+protected:
+  MbAnalysisLane*         m_pcMbAnalysisLane;
+  BitWriteBuffer*         m_pcBitWriteBuffer;
+  BitCounter*             m_pcBitCounter;
+  UvlcWriter*             m_pcUvlcWriter;
+  UvlcWriter*             m_pcUvlcTester;
+  CabacWriter*            m_pcCabacWriter;
+  NalUnitEncoder*         m_pcNalUnitEncoder;
+  NalUnitPool*            m_pcNalUnitPool;
+  UChar*                  m_pucWriteBuffer;
+  UInt                    m_uiWriteBufferSize;
+  BinData                 m_cBinData;
+  ExtBinDataAccessor      m_cExtBinDataAccessor;
+  Void*                   m_pvSliceHeaderMem;
+  SliceHeader*            m_pcSliceHeader;    // copy of the slice header in m_pvSliceHeaderMem, see encodeSlice()
+  Bool                    m_bInitDone;
+};
+
+
+H264AVC_NAMESPACE_END
+
+
+#endif // !defined(AFX_SLICEWORKER_H__5E0C1F47_2B8D_4C61_A3F2_8D17B4C9E206__INCLUDED_)
@@ -20,6 +20,7 @@
 # include <dlfcn.h>
 # include <cerrno>
 # include <unistd.h>
+# include <sys/uio.h>
 #endif
 
 
@@ -224,3 +225,31 @@ ErrVal LargeFile::write( const Void *pvBuffer, UInt32 uiCount )
 }
 
 
+ErrVal LargeFile::write( const Void *pvBuffer0, UInt32 uiCount0, const Void *pvBuffer1, UInt32 uiCount1 )
+{
+	ROT( -1 == m_iFileHandle );
+
+#if defined( MSYS_WIN32 )
+	if( uiCount0 )
+	{
+		RNOK( write( pvBuffer0, uiCount0 ) );
+	}
+	if( uiCount1 )
+	{
+		RNOK( write( pvBuffer1, uiCount1 ) );
+	}
+#else
+	struct iovec acIov[2];
+	acIov[0].iov_base = (Void*)pvBuffer0;
+	acIov[0].iov_len  = uiCount0;
+	acIov[1].iov_base = (Void*)pvBuffer1;
+	acIov[1].iov_len  = uiCount1;
+
+	ssize_t iRetv = ::writev( m_iFileHandle, acIov, 2 );
+	ROF( iRetv == (ssize_t)( uiCount0 + uiCount1 ) );
+#endif
+
+	return Err::m_nOK;
+}
+
+
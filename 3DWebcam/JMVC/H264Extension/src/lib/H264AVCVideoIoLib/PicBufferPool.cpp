@@ -0,0 +1,301 @@
+#include <cstdio>
+#include "H264AVCVideoIoLib.h"
+#include "PicBufferPool.h"
+
+#if defined( MSYS_WIN32 )
+# include <malloc.h>
+#else
+# include <sys/mman.h>
+#endif
+
+
+PicBufferPool::PicBufferPool() :
+  m_pucMemory       ( NULL ),
+  m_uiMemorySize    ( 0 ),
+  m_bMapped         ( false ),
+  m_bHugePages      ( false ),
+  m_pcPicBuffers    ( NULL ),
+  m_piNext          ( NULL ),
+  m_piPrev          ( NULL ),
+  m_pbAcquired      ( NULL ),
+  m_iFirstFree      ( -1 ),
+  m_iFirstAcquired  ( -1 ),
+  m_iLastAcquired   ( -1 ),
+  m_uiCapacity      ( 0 ),
+  m_uiBufferSize    ( 0 ),
+  m_uiNumAcquired   ( 0 ),
+  m_uiHighWaterMark ( 0 ),
+  m_uiNumAcquires   ( 0 ),
+  m_uiNumReclaimed  ( 0 ),
+  m_bInitDone       ( false )
+{
+}
+
+
+PicBufferPool::~PicBufferPool()
+{
+}
+
+
+ErrVal
+PicBufferPool::create( PicBufferPool*& rpcPicBufferPool )
+{
+  rpcPicBufferPool = new PicBufferPool;
+  ROT( NULL == rpcPicBufferPool );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+PicBufferPool::destroy()
+{
+  if( m_bInitDone )
+  {
+    RNOK( uninit() );
+  }
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+PicBufferPool::init( UInt uiCapacity,
+                     UInt uiBufferSize,
+                     Bool bHugePages )
+{
+  ROT( m_bInitDone );
+  ROF( uiCapacity );
+  ROF( uiBufferSize );
+
+  //===== every buffer starts at a multiple of ALIGNMENT bytes =====
+  UInt uiStride = ( uiBufferSize + ALIGNMENT - 1 ) / ALIGNMENT * ALIGNMENT;
+  RNOK( xAllocMemory( uiCapacity * uiStride, bHugePages ) );
+
+  m_pcPicBuffers  = new PicBuffer [ uiCapacity ];
+  m_piNext        = new Int       [ uiCapacity ];
+  m_piPrev        = new Int       [ uiCapacity ];
+  m_pbAcquired    = new Bool      [ uiCapacity ];
+  ROF( m_pcPicBuffers && m_piNext && m_piPrev && m_pbAcquired );
+
+  for( UInt ui = 0; ui < uiCapacity; ui++ )
+  {
+    m_pcPicBuffers[ui]  = PicBuffer( m_pucMemory + ui * uiStride );
+    m_piNext      [ui]  = ( ui + 1 < uiCapacity ? (Int)ui + 1 : -1 );
+    m_piPrev      [ui]  = -1;
+    m_pbAcquired  [ui]  = false;
+  }
+  m_iFirstFree      = 0;
+  m_iFirstAcquired  = -1;
+  m_iLastAcquired   = -1;
+  m_uiCapacity      = uiCapacity;
+  m_uiBufferSize    = uiBufferSize;
+  m_uiNumAcquired   = 0;
+  m_uiHighWaterMark = 0;
+  m_uiNumAcquires   = 0;
+  m_uiNumReclaimed  = 0;
+  m_bInitDone       = true;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+PicBufferPool::uninit()
+{
+  ROF( m_bInitDone );
+
+  delete [] m_pcPicBuffers;
+  delete [] m_piNext;
+  delete [] m_piPrev;
+  delete [] m_pbAcquired;
+  m_pcPicBuffers  = NULL;
+  m_piNext        = NULL;
+  m_piPrev        = NULL;
+  m_pbAcquired    = NULL;
+  xFreeMemory();
+
+  m_uiCapacity    = 0;
+  m_uiNumAcquired = 0;
+  m_bInitDone     = false;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+PicBufferPool::xAllocMemory( UInt uiSize, Bool bHugePages )
+{
+  m_bMapped     = false;
+  m_bHugePages  = false;
+
+#if defined( MSYS_WIN32 )
+  //===== large pages require a privilege on Windows, they are not used =====
+  m_pucMemory = (UChar*)_aligned_malloc( uiSize, ALIGNMENT );
+#else
+  //===== explicit huge pages when the system has reserved some, transparent huge pages otherwise =====
+  Void* pvMemory = MAP_FAILED;
+# if defined( MAP_HUGETLB )
+  if( bHugePages )
+  {
+    const UInt uiHugePageSize = 2 * 1024 * 1024;
+    UInt       uiMapSize      = ( uiSize + uiHugePageSize - 1 ) / uiHugePageSize * uiHugePageSize;
+    pvMemory = ::mmap( NULL, uiMapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0 );
+    if( MAP_FAILED != pvMemory )
+    {
+      uiSize        = uiMapSize;
+      m_bHugePages  = true;
+    }
+  }
+# endif
+  if( MAP_FAILED == pvMemory )
+  {
+    pvMemory = ::mmap( NULL, uiSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+    ROT( MAP_FAILED == pvMemory );
+# if defined( MADV_HUGEPAGE )
+    if( bHugePages )
+    {
+      m_bHugePages = ( 0 == ::madvise( pvMemory, uiSize, MADV_HUGEPAGE ) );
+    }
+# endif
+  }
+  m_pucMemory = (UChar*)pvMemory;
+  m_bMapped   = true;
+#endif
+  ROF( m_pucMemory );
+
+  m_uiMemorySize = uiSize;
+  return Err::m_nOK;
+}
+
+
+Void
+PicBufferPool::xFreeMemory()
+{
+  ROFVS( m_pucMemory );
+#if defined( MSYS_WIN32 )
+  _aligned_free( m_pucMemory );
+#else
+  if( m_bMapped )
+  {
+    ::munmap( m_pucMemory, m_uiMemorySize );
+  }
+#endif
+  m_pucMemory     = NULL;
+  m_uiMemorySize  = 0;
+  m_bMapped       = false;
+  m_bHugePages    = false;
+}
+
+
+Int
+PicBufferPool::xGetIndex( const PicBuffer* pcPicBuffer ) const
+{
+  if( pcPicBuffer < m_pcPicBuffers || pcPicBuffer >= m_pcPicBuffers + m_uiCapacity )
+  {
+    return -1;
+  }
+  return (Int)( pcPicBuffer - m_pcPicBuffers );
+}
+
+
+Void
+PicBufferPool::xUnlink( Int iIndex )
+{
+  //===== remove from the acquired buffers and put in front of the free buffers =====
+  if( m_piPrev[iIndex] >= 0 )   m_piNext[ m_piPrev[iIndex] ] = m_piNext[iIndex];
+  else                          m_iFirstAcquired             = m_piNext[iIndex];
+  if( m_piNext[iIndex] >= 0 )   m_piPrev[ m_piNext[iIndex] ] = m_piPrev[iIndex];
+  else                          m_iLastAcquired              = m_piPrev[iIndex];
+
+  m_piPrev    [iIndex]  = -1;
+  m_piNext    [iIndex]  = m_iFirstFree;
+  m_pbAcquired[iIndex]  = false;
+  m_iFirstFree          = iIndex;
+  m_uiNumAcquired--;
+}
+
+
+ErrVal
+PicBufferPool::acquire( PicBuffer*& rpcPicBuffer )
+{
+  ROF( m_bInitDone );
+  if( m_iFirstFree < 0 )
+  {
+    printf( "\nall %d picture buffers are in use\n", m_uiCapacity );
+    return Err::m_nERR;
+  }
+
+  Int iIndex    = m_iFirstFree;
+  m_iFirstFree  = m_piNext[iIndex];
+
+  //===== append to the acquired buffers =====
+  m_piPrev[iIndex] = m_iLastAcquired;
+  m_piNext[iIndex] = -1;
+  if( m_iLastAcquired >= 0 )  m_piNext[ m_iLastAcquired ] = iIndex;
+  else                        m_iFirstAcquired            = iIndex;
+  m_iLastAcquired       = iIndex;
+  m_pbAcquired[iIndex]  = true;
+
+  m_uiNumAcquired++;
+  m_uiNumAcquires++;
+  m_uiHighWaterMark = max( m_uiHighWaterMark, m_uiNumAcquired );
+
+  rpcPicBuffer = &m_pcPicBuffers[iIndex];
+  return Err::m_nOK;
+}
+
+
+ErrVal
+PicBufferPool::release( PicBuffer* pcPicBuffer )
+{
+  ROF( m_bInitDone );
+  ROTRS( NULL == pcPicBuffer, Err::m_nOK );
+
+  Int iIndex = xGetIndex( pcPicBuffer );
+  ROT( iIndex < 0 ); // not a buffer of this pool
+  ROTRS( ! m_pbAcquired[iIndex], Err::m_nOK );
+
+  xUnlink( iIndex );
+  return Err::m_nOK;
+}
+
+
+ErrVal
+PicBufferPool::release( PicBufferList& rcPicBufferList )
+{
+  while( ! rcPicBufferList.empty() )
+  {
+    RNOK( release( rcPicBufferList.popFront() ) );
+  }
+  return Err::m_nOK;
+}
+
+
+Void
+PicBufferPool::reclaim( UInt uiMaxAcquired )
+{
+  Int iIndex = m_iFirstAcquired;
+  while( m_uiNumAcquired > uiMaxAcquired && iIndex >= 0 )
+  {
+    Int iNext = m_piNext[iIndex];
+    if( ! m_pcPicBuffers[iIndex].isUsed() )
+    {
+      xUnlink( iIndex );
+      m_uiNumReclaimed++;
+    }
+    iIndex = iNext;
+  }
+}
+
+
+Void
+PicBufferPool::printStatistics( const Char* pcName ) const
+{
+  printf( "%s picture buffers: %d of %d used at most, %d acquired, %d reclaimed (%d bytes each%s)\n",
+          pcName,
+          m_uiHighWaterMark,
+          m_uiCapacity,
+          m_uiNumAcquires,
+          m_uiNumReclaimed,
+          m_uiBufferSize,
+          m_bHugePages ? ", huge pages" : "" );
+}
@@ -1,7 +1,25 @@
+#include <cstring>
 #include "ReadBitstreamFile.h"
 
-
-ReadBitstreamFile::ReadBitstreamFile()
+#if defined( MSYS_WIN32 )
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+# include <io.h>
+#else
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+
+ReadBitstreamFile::ReadBitstreamFile() :
+  m_pucStream     ( NULL ),
+  m_iStreamSize   ( 0 ),
+  m_uiMemorySize  ( 0 ),
+  m_pvFileMapping ( NULL ),
+  m_bMapped       ( false ),
+  m_uiNextNalUnit ( 0 ),
+  m_uiNumViewed   ( 0 )
 {
 }
 
@@ -13,12 +31,81 @@ ReadBitstreamFile::~ReadBitstreamFile()
 ErrVal ReadBitstreamFile::releasePacket( BinData* pcBinData )
 {
   ROFRS( pcBinData, Err::m_nOK );
-  pcBinData->deleteData();
-  delete pcBinData;
+  if( xIsView( pcBinData->origData() ) )
+  {
+    pcBinData->reset();
+  }
+  else
+  {
+    pcBinData->deleteData();
+  }
+  m_cFreeBinData.push_back( pcBinData );
   return Err::m_nOK;
 }
 
 ErrVal ReadBitstreamFile::extractPacket( BinData*& rpcBinData, Bool& rbEOS )
+{
+  if( m_cFreeBinData.empty() )
+  {
+    ROT( NULL == ( rpcBinData = new BinData ) );
+  }
+  else
+  {
+    rpcBinData = m_cFreeBinData.back();
+    m_cFreeBinData.pop_back();
+  }
+
+  rbEOS     = false;
+  // exit if there's no bitstream
+  ROFS( m_cFile.is_open());
+
+  if( ! m_bMapped )
+  {
+    return xReadPacket( rpcBinData, rbEOS );
+  }
+
+  if( m_uiNextNalUnit >= getNumNalUnits() )
+  {
+    rbEOS = true;
+    return Err::m_nOK;
+  }
+
+  //===== the NAL unit ends at the next start code, trailing zeros included =====
+  Int64 iStart    = m_cNalUnitStart[m_uiNextNalUnit];
+  Int64 iEnd      = ( m_uiNextNalUnit + 1 < getNumNalUnits() ? m_cNalUnitStart[m_uiNextNalUnit+1] - 3 : m_iStreamSize );
+  ROT( iEnd - iStart > (Int64)( 0xffffffffu - PADDING ) );
+  UInt  dwLength  = (UInt)( iEnd - iStart );
+
+  if( 0 == dwLength )
+  {
+    rbEOS = true;
+    return Err::m_nOK;
+  }
+
+  if( m_uiNextNalUnit >= m_uiNumViewed && iEnd + PADDING <= (Int64)m_uiMemorySize )
+  {
+    rpcBinData->set( m_pucStream + iStart, dwLength );
+    m_uiNumViewed = m_uiNextNalUnit + 1;
+  }
+  else
+  {
+    UInt dwBytesRead;
+    rpcBinData->set( new UChar[dwLength + PADDING], dwLength );
+    ROT( NULL == rpcBinData->data() );
+    ::memset( rpcBinData->data() + dwLength, 0, PADDING );
+
+    // read the NAL unit from the file, the one in the mapping may have been converted
+    RNOK( m_cFile.seek( iStart, SEEK_SET ) );
+    RNOK( m_cFile.read( rpcBinData->data(), dwLength, dwBytesRead ) );
+    ROF ( dwLength == dwBytesRead );
+  }
+  m_uiNextNalUnit++;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamFile::xReadPacket( BinData* pcBinData, Bool& rbEOS )
 {
 	UInt	 dwBytesRead;
 	UInt	 dwLength = 0;
@@ -29,12 +116,6 @@ ErrVal ReadBitstreamFile::extractPacket( BinData*& rpcBinData, Bool& rbEOS )
   UInt   uiCond;
   UInt  uiZeros;
 
-  ROT( NULL == ( rpcBinData = new BinData ) );
-
-  rbEOS     = false;
-  // exit if there's no bitstream
-  ROFS( m_cFile.is_open());
-
   // we max read any number of zeros
   uiZeros = 0;
   do
@@ -114,19 +195,140 @@ ErrVal ReadBitstreamFile::extractPacket( BinData*& rpcBinData, Bool& rbEOS )
     return Err::m_nOK;
   }
 
-  rpcBinData->set( new UChar[dwLength], dwLength );
-  ROT( NULL == rpcBinData->data() );
+  pcBinData->set( new UChar[dwLength + PADDING], dwLength );
+  ROT( NULL == pcBinData->data() );
+  ::memset( pcBinData->data() + dwLength, 0, PADDING );
   
   // seek the bitstream to the prev start position
   RNOK( m_cFile.seek( iPos, SEEK_SET ) );
 
   // read the access unit into the transport buffer
-  RNOK( m_cFile.read( rpcBinData->data(), dwLength, dwBytesRead ) );
+  RNOK( m_cFile.read( pcBinData->data(), dwLength, dwBytesRead ) );
+
+  return Err::m_nOK;
+}
+
+
+const UChar* ReadBitstreamFile::xFindStartCode( const UChar* puc, const UChar* pucEnd )
+{
+  //===== memchr looks for the 0x01 of 0x000001, a miss moves on by 3 bytes, as the 0x01 cannot be one of the zeros =====
+  const UChar* pucOne = puc + 2;
+  while( pucOne < pucEnd )
+  {
+    pucOne = (const UChar*)::memchr( pucOne, 0x01, pucEnd - pucOne );
+    if( NULL == pucOne )
+    {
+      break;
+    }
+    if( 0 == pucOne[-1] && 0 == pucOne[-2] )
+    {
+      return pucOne - 2;
+    }
+    pucOne += 3;
+  }
+  return pucEnd;
+}
+
+
+ErrVal ReadBitstreamFile::xIndexNalUnits()
+{
+  const UChar* pucEnd = m_pucStream + m_iStreamSize;
+  const UChar* puc    = xFindStartCode( m_pucStream, pucEnd );
+
+  // only zeros may precede the first start code
+  for( const UChar* pucLead = m_pucStream; pucLead < puc; pucLead++ )
+  {
+    if( *pucLead )
+    {
+      std::cerr << "input bitstream does not start with a start code" << std::endl;
+      return Err::m_nERR;
+    }
+  }
+
+  m_cNalUnitStart.clear();
+  while( puc < pucEnd )
+  {
+    puc += 3;
+    m_cNalUnitStart.push_back( (Int64)( puc - m_pucStream ) );
+    puc  = xFindStartCode( puc, pucEnd );
+  }
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamFile::xMapFile()
+{
+  RNOK( m_cFile.seek( 0, SEEK_END ) );
+  m_iStreamSize = m_cFile.tell();
+  RNOK( m_cFile.seek( 0, SEEK_SET ) );
+  ROT( m_iStreamSize < 0 );
+  m_bMapped     = false;
+
+  //===== a file that does not fit the address space is read in chunks =====
+  if( 0 == m_iStreamSize || (UInt64)m_iStreamSize > (UInt64)( ~(size_t)0 >> 1 ) )
+  {
+    return Err::m_nOK;
+  }
+
+#if defined( MSYS_WIN32 )
+  //===== copy-on-write view of the file, the NAL units at its end have no padding and are read into buffers =====
+  HANDLE hFileMapping = ::CreateFileMapping( (HANDLE)::_get_osfhandle( m_cFile.getFileHandle() ), NULL, PAGE_WRITECOPY, 0, 0, NULL );
+  if( NULL != hFileMapping )
+  {
+    Void* pvMemory = ::MapViewOfFile( hFileMapping, FILE_MAP_COPY, 0, 0, (SIZE_T)m_iStreamSize );
+    if( NULL != pvMemory )
+    {
+      m_pucStream     = (UChar*)pvMemory;
+      m_uiMemorySize  = (size_t)m_iStreamSize;
+      m_pvFileMapping = hFileMapping;
+      m_bMapped       = true;
+      return Err::m_nOK;
+    }
+    ::CloseHandle( hFileMapping );
+  }
+#else
+  //===== the file is mapped over anonymous zero pages that provide the padding =====
+  size_t  uiStreamSize  = (size_t)m_iStreamSize;
+  size_t  uiPageSize    = (size_t)::sysconf( _SC_PAGESIZE );
+  size_t  uiMapSize     = ( uiStreamSize + uiPageSize - 1 ) / uiPageSize * uiPageSize + uiPageSize;
+  Void*   pvMemory      = ::mmap( NULL, uiMapSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0 );
+  if( MAP_FAILED != pvMemory )
+  {
+    if( pvMemory == ::mmap( pvMemory, uiStreamSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_FIXED, m_cFile.getFileHandle(), 0 ) )
+    {
+      ::madvise( pvMemory, uiMapSize, MADV_SEQUENTIAL );
+      m_pucStream     = (UChar*)pvMemory;
+      m_uiMemorySize  = uiMapSize;
+      m_bMapped       = true;
+      return Err::m_nOK;
+    }
+    ::munmap( pvMemory, uiMapSize );
+  }
+#endif
 
   return Err::m_nOK;
 }
 
 
+Void ReadBitstreamFile::xUnmapFile()
+{
+  if( m_bMapped )
+  {
+#if defined( MSYS_WIN32 )
+    ::UnmapViewOfFile( m_pucStream );
+    ::CloseHandle( (HANDLE)m_pvFileMapping );
+#else
+    ::munmap( m_pucStream, m_uiMemorySize );
+#endif
+  }
+  m_pucStream     = NULL;
+  m_iStreamSize   = 0;
+  m_uiMemorySize  = 0;
+  m_pvFileMapping = NULL;
+  m_bMapped       = false;
+}
+
+
 ErrVal ReadBitstreamFile::init( const std::string& rcFileName )
 {
 	// try to open the bitstream binary
@@ -136,11 +338,23 @@ ErrVal ReadBitstreamFile::init( const std::string& rcFileName )
     return Err::m_nERR;
   }
 
+  RNOK( xMapFile() );
+
+  m_uiNextNalUnit = 0;
+  m_uiNumViewed   = 0;
+
+  if( m_bMapped )
+  {
+    RNOK( xIndexNalUnits() );
+    return Err::m_nOK;
+  }
+
+  //===== chunks: skip the first zero of a three byte start code =====
   UChar  aucBuffer[0x4];
   UInt uiBytesRead;
   RNOK( m_cFile.read( aucBuffer, 4, uiBytesRead ) );
 
-  UInt uiStartPos = (aucBuffer[0] == 0 && aucBuffer[1] == 0 && aucBuffer[2] == 1) ? 1 : 0;
+  UInt uiStartPos = (uiBytesRead >= 3 && aucBuffer[0] == 0 && aucBuffer[1] == 0 && aucBuffer[2] == 1) ? 1 : 0;
   
   RNOK( m_cFile.seek( uiStartPos, SEEK_SET ) );
 
@@ -159,7 +373,7 @@ ErrVal ReadBitstreamFile::getPosition( Int& iPos )
 {
   ROFS( m_cFile.is_open());
 
-  iPos = (Int)m_cFile.tell(); 
+  iPos = ( m_bMapped ? (Int)m_uiNextNalUnit : (Int)m_cFile.tell() );
 
   return Err::m_nOK;
 }
@@ -169,15 +383,41 @@ ErrVal ReadBitstreamFile::setPosition( Int  iPos )
 {
   ROFS( m_cFile.is_open());
 
-  // seek the bitstream to the prev start position
-  RNOK( m_cFile.seek( iPos, SEEK_SET ) );
+  if( ! m_bMapped )
+  {
+    // seek the bitstream to the prev start position
+    RNOK( m_cFile.seek( iPos, SEEK_SET ) );
+    return Err::m_nOK;
+  }
+
+  ROT ( iPos < 0 || iPos > (Int)getNumNalUnits() );
+  m_uiNextNalUnit = (UInt)iPos;
 
   return Err::m_nOK;
 }
 
 
+Int64 ReadBitstreamFile::getFilePos()
+{
+  ROTR( ! m_cFile.is_open(), -1 );
+  ROTRS( ! m_bMapped, m_cFile.tell() );
+
+  //===== position of the start code of the next NAL unit =====
+  return ( m_uiNextNalUnit < getNumNalUnits() ? m_cNalUnitStart[m_uiNextNalUnit] - 3 : m_iStreamSize );
+}
+
+
 ErrVal ReadBitstreamFile::uninit()
 {
+  //===== packets the application did not release are its own =====
+  for( UInt ui = 0; ui < m_cFreeBinData.size(); ui++ )
+  {
+    delete m_cFreeBinData[ui];
+  }
+  m_cFreeBinData.clear();
+  m_cNalUnitStart.clear();
+  xUnmapFile();
+
   if( m_cFile.is_open() )
   { 
     RNOK( m_cFile.close() );
@@ -0,0 +1,473 @@
+#if defined( WIN32 )
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <windows.h>
+#else
+# include <pthread.h>
+#endif
+
+#include <cstring>
+#include "ReadBitstreamStream.h"
+
+
+//===== the positions are published through volatile members, a full barrier orders them with the ring data =====
+#if defined( WIN32 )
+# define MEMORY_BARRIER() MemoryBarrier()
+#else
+# define MEMORY_BARRIER() __sync_synchronize()
+#endif
+
+
+//===== a thread that finds the ring empty (decoder) or full (producer) sleeps until the other one signals it =====
+#if defined( WIN32 )
+struct ReadBitstreamStreamSync {
+  ReadBitstreamStreamSync()  { InitializeCriticalSection( &cMutex ); InitializeConditionVariable( &cCondition ); }
+  ~ReadBitstreamStreamSync() { DeleteCriticalSection( &cMutex ); }
+  Void lock       () { EnterCriticalSection( &cMutex ); }
+  Void unlock     () { LeaveCriticalSection( &cMutex ); }
+  Void sleep      () { SleepConditionVariableCS( &cCondition, &cMutex, INFINITE ); }
+  Void wakeAll    () { WakeAllConditionVariable( &cCondition ); }
+
+  CRITICAL_SECTION    cMutex;
+  CONDITION_VARIABLE  cCondition;
+};
+#else
+struct ReadBitstreamStreamSync {
+  ReadBitstreamStreamSync()  { pthread_mutex_init( &cMutex, NULL ); pthread_cond_init( &cCondition, NULL ); }
+  ~ReadBitstreamStreamSync() { pthread_cond_destroy( &cCondition ); pthread_mutex_destroy( &cMutex ); }
+  Void lock       () { pthread_mutex_lock( &cMutex ); }
+  Void unlock     () { pthread_mutex_unlock( &cMutex ); }
+  Void sleep      () { pthread_cond_wait( &cCondition, &cMutex ); }
+  Void wakeAll    () { pthread_cond_broadcast( &cCondition ); }
+
+  pthread_mutex_t     cMutex;
+  pthread_cond_t      cCondition;
+};
+#endif
+
+#define SYNC ( (ReadBitstreamStreamSync*) m_pvSync )
+
+
+ReadBitstreamStream::ReadBitstreamStream() :
+  m_pucRing           ( NULL ),
+  m_uiRingSize        ( 0 ),
+  m_uiMask            ( 0 ),
+  m_uiHead            ( 0 ),
+  m_uiTail            ( 0 ),
+  m_uiMarker          ( 0 ),
+  m_bEndOfStream      ( false ),
+  m_bConsumerWaiting  ( false ),
+  m_bProducerWaiting  ( false ),
+  m_bInNalUnit        ( false ),
+  m_uiNalUnitStart    ( 0 ),
+  m_uiScan            ( 0 ),
+  m_uiNumNalUnits     ( 0 ),
+  m_iStreamPos        ( 0 ),
+  m_pvSync            ( new ReadBitstreamStreamSync )
+{
+}
+
+
+ReadBitstreamStream::~ReadBitstreamStream()
+{
+  delete SYNC;
+}
+
+
+ErrVal ReadBitstreamStream::create( ReadBitstreamStream*& rpcReadBitstreamStream )
+{
+  rpcReadBitstreamStream = new ReadBitstreamStream;
+  ROT( NULL == rpcReadBitstreamStream );
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::destroy()
+{
+  RNOK( uninit() );
+
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::init( UInt uiRingSize )
+{
+  RNOK( uninit() );
+  ROT ( uiRingSize > 0x80000000u );
+
+  m_uiRingSize = 4096;
+  while( m_uiRingSize < uiRingSize )
+  {
+    m_uiRingSize <<= 1;
+  }
+  m_uiMask  = m_uiRingSize - 1;
+  m_pucRing = new UChar[m_uiRingSize];
+  ROF( m_pucRing );
+
+  m_uiHead            = 0;
+  m_uiTail            = 0;
+  m_uiMarker          = 0;
+  m_bEndOfStream      = false;
+  m_bConsumerWaiting  = false;
+  m_bProducerWaiting  = false;
+  m_bInNalUnit        = false;
+  m_uiNalUnitStart    = 0;
+  m_uiScan            = 0;
+  m_uiNumNalUnits     = 0;
+  m_iStreamPos        = 0;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::uninit()
+{
+  //===== packets the application did not release are its own =====
+  for( UInt uiBuffer = 0; uiBuffer < m_cFreeBuffer.size(); uiBuffer++ )
+  {
+    delete [] m_cFreeBuffer[uiBuffer];
+  }
+  for( UInt uiBinData = 0; uiBinData < m_cFreeBinData.size(); uiBinData++ )
+  {
+    delete m_cFreeBinData[uiBinData];
+  }
+  m_cFreeBuffer .clear();
+  m_cFreeBinData.clear();
+  m_cBufferSize .clear();
+
+  delete [] m_pucRing;
+  m_pucRing     = NULL;
+  m_uiRingSize  = 0;
+  m_uiMask      = 0;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::append( const UChar* pucData, UInt uiSize )
+{
+  ROF( m_pucRing );
+
+  while( uiSize )
+  {
+    // the stream was ended, e.g. by a decoder that stopped reading
+    ROTRS( m_bEndOfStream, Err::m_nERR );
+
+    UInt uiHead = m_uiHead;
+
+    if( m_uiRingSize == uiHead - m_uiTail )
+    {
+      //===== sleep until the decoder has released bytes =====
+      SYNC->lock();
+      m_bProducerWaiting = true;
+      MEMORY_BARRIER();
+      while( m_uiRingSize == uiHead - m_uiTail && ! m_bEndOfStream )
+      {
+        SYNC->sleep();
+      }
+      m_bProducerWaiting = false;
+      SYNC->unlock();
+      continue;
+    }
+
+    UInt uiCopy = xCopyToRing( pucData, uiSize );
+    pucData    += uiCopy;
+    uiSize     -= uiCopy;
+  }
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::tryAppend( const UChar* pucData, UInt uiSize, UInt& ruiAppended )
+{
+  ROF( m_pucRing );
+
+  ruiAppended = 0;
+  ROTRS( m_bEndOfStream, Err::m_nERR );
+
+  ruiAppended = xCopyToRing( pucData, uiSize );
+  return Err::m_nOK;
+}
+
+
+UInt ReadBitstreamStream::xCopyToRing( const UChar* pucData, UInt uiSize )
+{
+  UInt uiHead   = m_uiHead;
+  UInt uiCopy   = min( uiSize, m_uiRingSize - ( uiHead - m_uiTail ) );
+  UInt uiOffset = uiHead & m_uiMask;
+  UInt uiFirst  = min( uiCopy, m_uiRingSize - uiOffset );
+  ROTRS( 0 == uiCopy, 0 );
+
+  ::memcpy( m_pucRing + uiOffset, pucData,           uiFirst );
+  ::memcpy( m_pucRing,            pucData + uiFirst, uiCopy - uiFirst );
+
+  MEMORY_BARRIER();
+  m_uiHead = uiHead + uiCopy;
+  xWakeUp( m_bConsumerWaiting );
+  return uiCopy;
+}
+
+
+Void ReadBitstreamStream::endAccessUnit()
+{
+  MEMORY_BARRIER();
+  m_uiMarker = m_uiHead;
+  xWakeUp( m_bConsumerWaiting );
+}
+
+
+Void ReadBitstreamStream::endStream()
+{
+  MEMORY_BARRIER();
+  m_bEndOfStream = true;
+  xWakeUp( m_bConsumerWaiting );
+  xWakeUp( m_bProducerWaiting );
+}
+
+
+ErrVal ReadBitstreamStream::releasePacket( BinData* pcBinData )
+{
+  ROFRS( pcBinData, Err::m_nOK );
+  if( m_cBufferSize.find( pcBinData->origData() ) != m_cBufferSize.end() )
+  {
+    m_cFreeBuffer.push_back( pcBinData->origData() );
+    pcBinData->reset();
+  }
+  else
+  {
+    pcBinData->deleteData();
+  }
+  m_cFreeBinData.push_back( pcBinData );
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::extractPacket( BinData*& rpcBinData, Bool& rbEOS )
+{
+  if( m_cFreeBinData.empty() )
+  {
+    ROT( NULL == ( rpcBinData = new BinData ) );
+  }
+  else
+  {
+    rpcBinData = m_cFreeBinData.back();
+    m_cFreeBinData.pop_back();
+  }
+
+  rbEOS = false;
+  ROF( m_pucRing );
+
+  //===== find the start code of the NAL unit, the bytes before it are skipped =====
+  while( ! m_bInNalUnit )
+  {
+    Bool bEndOfStream = m_bEndOfStream;
+    MEMORY_BARRIER();
+    UInt uiHead       = m_uiHead;
+    UInt uiMarker     = m_uiMarker;
+    UInt uiStartCode  = xFindStartCode( m_uiScan, uiHead );
+
+    if( uiStartCode != uiHead )
+    {
+      m_bInNalUnit      = true;
+      m_uiNalUnitStart  = uiStartCode + 3;
+      m_uiScan          = m_uiNalUnitStart;
+      xRelease( uiStartCode );
+      break;
+    }
+
+    // the last two bytes may begin a start code
+    m_uiScan = ( uiHead - m_uiTail > 2 ? uiHead - 2 : m_uiTail );
+    xRelease( m_uiScan );
+    if( bEndOfStream )
+    {
+      rbEOS = true;
+      return Err::m_nOK;
+    }
+    xWaitForData( uiHead, uiMarker );
+  }
+
+  //===== the NAL unit ends at the next start code (trailing zeros included), at the end of the access unit or of the stream =====
+  UInt uiEnd;
+  while( true )
+  {
+    Bool bEndOfStream = m_bEndOfStream;
+    MEMORY_BARRIER();
+    UInt uiHead       = m_uiHead;
+    UInt uiMarker     = m_uiMarker;
+
+    uiEnd = xFindStartCode( m_uiScan, uiHead );
+    if( uiEnd != uiHead || bEndOfStream )
+    {
+      break;
+    }
+    if( uiMarker - m_uiNalUnitStart - 1 < uiHead - m_uiNalUnitStart )
+    {
+      uiEnd = uiMarker;
+      break;
+    }
+    if( uiHead - m_uiTail == m_uiRingSize )
+    {
+      std::cerr << "NAL unit exceeds the bitstream ring of " << m_uiRingSize << " bytes" << std::endl;
+      m_bEndOfStream = true;
+      xWakeUp( m_bProducerWaiting );
+      return Err::m_nERR;
+    }
+
+    m_uiScan = ( uiHead - m_uiNalUnitStart > 2 ? uiHead - 2 : m_uiNalUnitStart );
+    xWaitForData( uiHead, uiMarker );
+  }
+
+  UInt uiSize   = uiEnd - m_uiNalUnitStart;
+  m_bInNalUnit  = false;
+  m_uiScan      = uiEnd;
+
+  if( 0 == uiSize )
+  {
+    xRelease( uiEnd );
+    rbEOS = true;
+    return Err::m_nOK;
+  }
+
+  //===== the decoder converts the payload in place, it is copied out of the ring =====
+  UChar* pucBuffer = xGetBuffer( uiSize + PADDING );
+  ROF( pucBuffer );
+  xCopyFromRing( pucBuffer, m_uiNalUnitStart, uiSize );
+  ::memset( pucBuffer + uiSize, 0, PADDING );
+  rpcBinData->set( pucBuffer, uiSize );
+
+  xRelease( uiEnd );
+  m_uiNumNalUnits++;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::getPosition( Int& iPos )
+{
+  ROF( m_pucRing );
+
+  iPos = (Int)m_uiNumNalUnits;
+
+  return Err::m_nOK;
+}
+
+
+ErrVal ReadBitstreamStream::setPosition( Int iPos )
+{
+  ROF( m_pucRing );
+  ROF( iPos == (Int)m_uiNumNalUnits );
+
+  return Err::m_nOK;
+}
+
+
+Int64 ReadBitstreamStream::getFilePos()
+{
+  ROTR( NULL == m_pucRing, -1 );
+
+  //===== position of the start code of the next NAL unit, once it has been found =====
+  return m_iStreamPos;
+}
+
+
+UInt ReadBitstreamStream::xFindStartCode( UInt uiPos, UInt uiEnd ) const
+{
+  ROTRS( uiEnd - uiPos < 3, uiEnd );
+
+  //===== memchr looks for the 0x01 of 0x000001 in the contiguous parts of the ring, a miss moves on by 3 bytes =====
+  UInt uiOne = uiPos + 2;
+  while( uiOne != uiEnd )
+  {
+    UInt          uiOffset  = uiOne & m_uiMask;
+    UInt          uiRun     = min( uiEnd - uiOne, m_uiRingSize - uiOffset );
+    const UChar*  puc       = m_pucRing + uiOffset;
+    const UChar*  pucOne    = (const UChar*)::memchr( puc, 0x01, uiRun );
+    if( NULL == pucOne )
+    {
+      uiOne += uiRun;
+      continue;
+    }
+    uiOne += (UInt)( pucOne - puc );
+    if( 0 == m_pucRing[( uiOne - 1 ) & m_uiMask] && 0 == m_pucRing[( uiOne - 2 ) & m_uiMask] )
+    {
+      return uiOne - 2;
+    }
+    uiOne += min( 3u, uiEnd - uiOne );
+  }
+  return uiEnd;
+}
+
+
+Void ReadBitstreamStream::xCopyFromRing( UChar* puc, UInt uiPos, UInt uiSize ) const
+{
+  UInt uiOffset = uiPos & m_uiMask;
+  UInt uiFirst  = min( uiSize, m_uiRingSize - uiOffset );
+  ::memcpy( puc,           m_pucRing + uiOffset, uiFirst );
+  ::memcpy( puc + uiFirst, m_pucRing,            uiSize - uiFirst );
+}
+
+
+Void ReadBitstreamStream::xRelease( UInt uiPos )
+{
+  ROFVS( uiPos != m_uiTail );
+
+  m_iStreamPos += uiPos - m_uiTail;
+  MEMORY_BARRIER();
+  m_uiTail      = uiPos;
+  xWakeUp( m_bProducerWaiting );
+}
+
+
+Void ReadBitstreamStream::xWaitForData( UInt uiHead, UInt uiMarker )
+{
+  //===== the flag is set before the last check, append() sets the head before it reads the flag =====
+  SYNC->lock();
+  m_bConsumerWaiting = true;
+  MEMORY_BARRIER();
+  while( m_uiHead == uiHead && m_uiMarker == uiMarker && ! m_bEndOfStream )
+  {
+    SYNC->sleep();
+  }
+  m_bConsumerWaiting = false;
+  SYNC->unlock();
+}
+
+
+Void ReadBitstreamStream::xWakeUp( volatile Bool& rbWaiting )
+{
+  MEMORY_BARRIER();
+  ROFVS( rbWaiting );
+
+  SYNC->lock();
+  SYNC->wakeAll();
+  SYNC->unlock();
+}
+
+
+UChar* ReadBitstreamStream::xGetBuffer( UInt uiSize )
+{
+  //===== reuse a released buffer that is large enough, else replace one of them =====
+  for( UInt uiBuffer = 0; uiBuffer < m_cFreeBuffer.size(); uiBuffer++ )
+  {
+    UChar* puc = m_cFreeBuffer[uiBuffer];
+    if( m_cBufferSize[puc] >= uiSize )
+    {
+      m_cFreeBuffer[uiBuffer] = m_cFreeBuffer.back();
+      m_cFreeBuffer.pop_back();
+      return puc;
+    }
+  }
+  if( ! m_cFreeBuffer.empty() )
+  {
+    m_cBufferSize.erase( m_cFreeBuffer.back() );
+    delete [] m_cFreeBuffer.back();
+    m_cFreeBuffer.pop_back();
+  }
+
+  UInt   uiAlloc  = ( uiSize + 4095 ) & ~4095u;
+  UChar* puc      = new UChar[uiAlloc];
+  ROTRS( NULL == puc, NULL );
+  m_cBufferSize[puc] = uiAlloc;
+  return puc;
+}
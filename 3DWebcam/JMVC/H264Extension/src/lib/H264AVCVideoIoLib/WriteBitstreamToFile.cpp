@@ -96,3 +96,14 @@ WriteBitstreamToFile::writePacket( Void* pBuffer, UInt uiLength )
   }
   return Err::m_nOK;
 }
+
+ErrVal
+WriteBitstreamToFile::writeNalUnit( BinDataAccessor* pcStartCode, BinDataAccessor* pcNalUnit )
+{
+  ROF( pcStartCode );
+  ROF( pcNalUnit );
+  ROTRS( 0 == pcStartCode->size() + pcNalUnit->size(), Err::m_nOK );
+
+  RNOK( m_cFile.write( pcStartCode->data(), pcStartCode->size(), pcNalUnit->data(), pcNalUnit->size() ) );
+  return Err::m_nOK;
+}
@@ -167,6 +167,7 @@ ErrVal WriteYuvToFile::xInitMVC( const std::string& rcFileName, UInt *vcOrder,
   UInt view_id;
 
   m_cFileMVC = new LargeFile[uiNumOfViews];
+  m_cFileNameMVC.clear();
 
   UInt pos = cFileName.rfind(".");
   cFileName.erase(pos);
@@ -180,12 +181,9 @@ ErrVal WriteYuvToFile::xInitMVC( const std::string& rcFileName, UInt *vcOrder,
     cFileName = cTemp;
     cFileName.append(t);
     cFileName.append(".yuv");
-    
-    if( Err::m_nOK != m_cFileMVC[i].open( cFileName, LargeFile::OM_WRITEONLY ) )
-    { 
-      std::cerr << "failed to open YUV output file " << cFileName.data() << std::endl;
-      return Err::m_nERR;
-    }
+
+    //===== the file is created by the first frame, a view that is not decoded (-tv, -op) gets no file =====
+    m_cFileNameMVC.push_back( cFileName );
   }
   
   m_bFileInitDone = true;
@@ -249,6 +247,14 @@ ErrVal WriteYuvToFile::xWriteFrame( const UChar *pLum,
   UInt    y;
   const UChar*  pucSrc;
 
+  ROT( ViewCnt >= m_cFileNameMVC.size() );
+  if( ! m_cFileMVC[ViewCnt].is_open() &&
+      Err::m_nOK != m_cFileMVC[ViewCnt].open( m_cFileNameMVC[ViewCnt], LargeFile::OM_WRITEONLY ) )
+  {
+    std::cerr << "failed to open YUV output file " << m_cFileNameMVC[ViewCnt].data() << std::endl;
+    return Err::m_nERR;
+  }
+
   pucSrc = pLum;
   for( y = 0; y < uiHeight; y++ )
   {
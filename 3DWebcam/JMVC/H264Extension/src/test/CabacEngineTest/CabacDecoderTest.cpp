@@ -0,0 +1,293 @@
+#include "H264AVCDecoderLib.h"
+#include "CabacEngineTest.h"
+#include "H264AVCCommonLib/CabacTables.h"
+#include "BitReadBuffer.h"
+#include "CabaDecoder.h"
+
+
+//===== the library engine, its constructor is protected =====
+class TestCabaDecoder : public CabaDecoder
+{
+public:
+  TestCabaDecoder() {}
+  virtual ~TestCabaDecoder() {}
+};
+
+
+//===== the engine as it was before the windowed value register: one bit at a time =====
+class RefCabaDecoder
+{
+public:
+  RefCabaDecoder( BitReadBuffer* pcBitReadBuffer )
+  : m_pcBitReadBuffer ( pcBitReadBuffer )
+  , m_uiRange         ( 0 )
+  , m_uiValue         ( 0 )
+  , m_uiWord          ( 0 )
+  , m_uiBitsLeft      ( 0 )
+  {
+  }
+
+  ErrVal start()
+  {
+    m_uiRange     = HALF-2;
+    m_uiValue     = 0;
+    m_uiWord      = 0;
+    m_uiBitsLeft  = 0;
+
+    RNOK( m_pcBitReadBuffer->flush( m_pcBitReadBuffer->getBitsUntilByteAligned() ) );
+    m_pcBitReadBuffer->setModeCabac();
+    while( ! m_pcBitReadBuffer->isWordAligned() && ( 8 > m_uiBitsLeft ) )
+    {
+      UInt uiByte;
+      RNOK( m_pcBitReadBuffer->get( uiByte, 8 ) );
+      m_uiWord     <<= 8;
+      m_uiWord      += uiByte;
+      m_uiBitsLeft  += 8;
+    }
+    m_uiWord <<= 8-m_uiBitsLeft;
+
+    for( UInt n = 0; n < B_BITS-1; n++ )
+    {
+      xReadBit( m_uiValue );
+    }
+    return Err::m_nOK;
+  }
+
+  ErrVal finish() { return Err::m_nOK; }
+
+  ErrVal getSymbol( UInt& ruiSymbol, CabacContextModel& rcCCModel )
+  {
+    UInt uiRange  = m_uiRange;
+    UInt uiValue  = m_uiValue;
+    UInt uiLPS    = g_aucLPSTable64x4[rcCCModel.getState()][(uiRange>>6) & 0x03];
+
+    uiRange -= uiLPS;
+    if( uiValue < uiRange )
+    {
+      ruiSymbol = rcCCModel.getMps();
+      rcCCModel.setState( g_aucACNextStateMPS64[ rcCCModel.getState() ] );
+    }
+    else
+    {
+      uiValue  -= uiRange;
+      uiRange   = uiLPS;
+      ruiSymbol = 1 - rcCCModel.getMps();
+      if( ! rcCCModel.getState() )
+      {
+        rcCCModel.toggleMps();
+      }
+      rcCCModel.setState( g_aucACNextStateLPS64[ rcCCModel.getState() ] );
+    }
+    while( uiRange < QUARTER )
+    {
+      uiRange += uiRange;
+      xReadBit( uiValue );
+    }
+    m_uiRange = uiRange;
+    m_uiValue = uiValue;
+    return Err::m_nOK;
+  }
+
+  ErrVal getEpSymbol( UInt& ruiSymbol )
+  {
+    xReadBit( m_uiValue );
+    ruiSymbol = ( m_uiValue >= m_uiRange ? 1 : 0 );
+    if( ruiSymbol )
+    {
+      m_uiValue -= m_uiRange;
+    }
+    return Err::m_nOK;
+  }
+
+  ErrVal getTerminateBufferBit( UInt& ruiBit )
+  {
+    UInt uiRange = m_uiRange-2;
+    UInt uiValue = m_uiValue;
+    ruiBit       = ( uiValue >= uiRange ? 1 : 0 );
+    ROTRS( ruiBit, Err::m_nOK );
+
+    while( uiRange < QUARTER )
+    {
+      uiRange += uiRange;
+      xReadBit( uiValue );
+    }
+    m_uiRange = uiRange;
+    m_uiValue = uiValue;
+    return Err::m_nOK;
+  }
+
+  ErrVal getEpExGolomb( UInt& ruiSymbol, UInt uiCount )
+  {
+    UInt uiSymbol = 0;
+    UInt uiBit    = 1;
+    while( uiBit )
+    {
+      RNOK( getEpSymbol( uiBit ) );
+      uiSymbol += uiBit << uiCount++;
+    }
+    uiCount--;
+    while( uiCount-- )
+    {
+      RNOK( getEpSymbol( uiBit ) );
+      uiSymbol += uiBit << uiCount;
+    }
+    ruiSymbol = uiSymbol;
+    return Err::m_nOK;
+  }
+
+  ErrVal getExGolombLevel( UInt& ruiSymbol, CabacContextModel& rcCCModel )
+  {
+    UInt uiSymbol;
+    UInt uiCount = 0;
+    do
+    {
+      RNOK( getSymbol( uiSymbol, rcCCModel ) );
+      uiCount++;
+    }
+    while( uiSymbol && ( uiCount != 13 ) );
+    ruiSymbol = uiCount-1;
+    if( uiSymbol )
+    {
+      RNOK( getEpExGolomb( uiSymbol, 0 ) );
+      ruiSymbol += uiSymbol+1;
+    }
+    return Err::m_nOK;
+  }
+
+  ErrVal getExGolombMvd( UInt& ruiSymbol, CabacContextModel* pcCCModel, UInt uiMaxBin )
+  {
+    UInt uiSymbol;
+    RNOK( getSymbol( ruiSymbol, pcCCModel[0] ) );
+    ROTRS( 0 == ruiSymbol, Err::m_nOK );
+    RNOK( getSymbol( uiSymbol, pcCCModel[1] ) );
+    ruiSymbol = 1;
+    ROTRS( 0 == uiSymbol, Err::m_nOK );
+
+    pcCCModel    += 2;
+    UInt uiCount  = 2;
+    do
+    {
+      if( uiMaxBin == uiCount )
+      {
+        pcCCModel++;
+      }
+      RNOK( getSymbol( uiSymbol, *pcCCModel ) );
+      uiCount++;
+    }
+    while( uiSymbol && ( uiCount != 8 ) );
+    ruiSymbol = uiCount-1;
+    if( uiSymbol )
+    {
+      RNOK( getEpExGolomb( uiSymbol, 3 ) );
+      ruiSymbol += uiSymbol+1;
+    }
+    return Err::m_nOK;
+  }
+
+private:
+  Void xReadBit( UInt& ruiValue )
+  {
+    if( 0 == m_uiBitsLeft-- )
+    {
+      m_pcBitReadBuffer->get( m_uiWord, 8 );
+      m_uiBitsLeft = 7;
+    }
+    ruiValue  += ruiValue + ( ( m_uiWord >> 7 ) & 1 );
+    m_uiWord <<= 1;
+  }
+
+  BitReadBuffer*  m_pcBitReadBuffer;
+  UInt            m_uiRange;
+  UInt            m_uiValue;
+  UInt            m_uiWord;
+  UInt            m_uiBitsLeft;
+};
+
+
+template< class Decoder >
+static ErrVal xDecodeBins( Decoder& rcDecoder, BitReadBuffer* pcBitReadBuffer, const CabacBinList& rcBins, UInt uiSeed, UInt& ruiFailedBin )
+{
+  CabacContextModel acCCModel[NUM_TEST_CONTEXTS];
+  initContextModels( acCCModel, uiSeed );
+
+  ruiFailedBin = 0;
+  RNOK( rcDecoder.start() );
+  for( UInt n = 0; n < rcBins.size(); n++ )
+  {
+    const CabacBin& rcBin   = rcBins[n];
+    UInt            uiValue = 0;
+    switch( rcBin.eType )
+    {
+    case BIN_CONTEXT:         RNOK( rcDecoder.getSymbol       ( uiValue, acCCModel[rcBin.uiContext] ) );     break;
+    case BIN_BYPASS:          RNOK( rcDecoder.getEpSymbol     ( uiValue ) );                                 break;
+    case BIN_EP_EXGOLOMB:     RNOK( rcDecoder.getEpExGolomb   ( uiValue, rcBin.uiParam ) );                  break;
+    case BIN_EXGOLOMB_MVD:    RNOK( rcDecoder.getExGolombMvd  ( uiValue, &acCCModel[rcBin.uiContext], 3 ) ); break;
+    case BIN_EXGOLOMB_LEVEL:  RNOK( rcDecoder.getExGolombLevel( uiValue, acCCModel[rcBin.uiContext] ) );     break;
+    case BIN_TERMINATING:     RNOK( rcDecoder.getTerminateBufferBit( uiValue ) );                            break;
+    case BIN_PCM:
+      {
+        UInt uiBit = 0;
+        RNOK( rcDecoder.getTerminateBufferBit( uiBit ) );
+        if( uiBit != 1 )
+        {
+          ruiFailedBin = n + 1;
+          return Err::m_nOK;
+        }
+        RNOK( rcDecoder.finish() );
+        for( UInt uiByte = 0; uiByte < rcBin.uiParam; uiByte++ )
+        {
+          UInt uiSample = 0;
+          RNOK( pcBitReadBuffer->get( uiSample, 8 ) );
+          if( uiSample != getPCMSample( rcBin, uiByte ) )
+          {
+            ruiFailedBin = n + 1;
+            return Err::m_nOK;
+          }
+        }
+        RNOK( rcDecoder.start() );
+        uiValue = rcBin.uiValue;
+      }
+      break;
+    }
+    if( uiValue != rcBin.uiValue )
+    {
+      ruiFailedBin = n + 1;
+      return Err::m_nOK;
+    }
+  }
+
+  UInt uiEndOfSlice = 0;
+  RNOK( rcDecoder.getTerminateBufferBit( uiEndOfSlice ) );
+  if( uiEndOfSlice != 1 )
+  {
+    ruiFailedBin = (UInt)rcBins.size() + 1;
+  }
+  return Err::m_nOK;
+}
+
+
+ErrVal decodeBins( const CabacBinList& rcBins, UInt uiHeaderBits, UInt uiSeed, Bool bReference, const CabacStream& rcStream, UInt& ruiFailedBin )
+{
+  std::vector<UInt32> cBuffer( rcStream.cBuffer );
+  BitReadBuffer*      pcBitReadBuffer = NULL;
+  UInt                uiHeader        = 0;
+  RNOK( BitReadBuffer::create( pcBitReadBuffer ) );
+  RNOK( pcBitReadBuffer->initPacket( &cBuffer[0], rcStream.uiBits ) );
+  RNOK( pcBitReadBuffer->get( uiHeader, uiHeaderBits ) );
+
+  if( bReference )
+  {
+    RefCabaDecoder cDecoder( pcBitReadBuffer );
+    RNOK( xDecodeBins( cDecoder, pcBitReadBuffer, rcBins, uiSeed, ruiFailedBin ) );
+  }
+  else
+  {
+    TestCabaDecoder cDecoder;
+    RNOK( cDecoder.init( pcBitReadBuffer ) );
+    RNOK( xDecodeBins( cDecoder, pcBitReadBuffer, rcBins, uiSeed, ruiFailedBin ) );
+    RNOK( cDecoder.uninit() );
+  }
+
+  RNOK( pcBitReadBuffer->destroy() );
+  return Err::m_nOK;
+}
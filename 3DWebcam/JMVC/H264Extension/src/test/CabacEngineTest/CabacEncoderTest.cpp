@@ -0,0 +1,299 @@
+#include "H264AVCEncoderLib.h"
+#include "CabacEngineTest.h"
+#include "H264AVCCommonLib/CabacTables.h"
+#include "BitWriteBuffer.h"
+#include "CabaEncoder.h"
+
+
+//===== the library engine, its constructor is protected =====
+class TestCabaEncoder : public CabaEncoder
+{
+public:
+  TestCabaEncoder() {}
+  virtual ~TestCabaEncoder() {}
+};
+
+
+//===== the engine as it was before the byte-wise renormalization: one bit at a time, outstanding bits are counted =====
+class RefCabaEncoder
+{
+public:
+  RefCabaEncoder( BitWriteBuffer* pcBitWriteBuffer )
+  : m_pcBitWriteBuffer( pcBitWriteBuffer )
+  , m_uiRange         ( 0 )
+  , m_uiLow           ( 0 )
+  , m_uiByte          ( 0 )
+  , m_uiBitsLeft      ( 0 )
+  , m_uiBitsToFollow  ( 0 )
+  {
+  }
+
+  ErrVal start()
+  {
+    m_uiRange         = HALF-2;
+    m_uiLow           = 0;
+    m_uiBitsToFollow  = 0;
+    m_uiByte          = 0;
+    m_uiBitsLeft      = 9;
+    return m_pcBitWriteBuffer->writeAlignOne();
+  }
+
+  ErrVal finish()
+  {
+    RNOK( xWriteBitAndBitsToFollow( (m_uiLow >> (B_BITS-1)) & 1 ) );
+    RNOK( xWriteBit(                (m_uiLow >> (B_BITS-2)) & 1 ) );
+    return m_pcBitWriteBuffer->write( m_uiByte, 8 - m_uiBitsLeft );
+  }
+
+  UInt getWrittenBits() { return m_pcBitWriteBuffer->getNumberOfWrittenBits() + 8 + m_uiBitsToFollow - m_uiBitsLeft + 1; }
+
+  ErrVal writeSymbol( UInt uiSymbol, CabacContextModel& rcCCModel )
+  {
+    UInt uiLow    = m_uiLow;
+    UInt uiRange  = m_uiRange;
+    UInt uiLPS    = g_aucLPSTable64x4[rcCCModel.getState()][(uiRange>>6) & 3];
+
+    rcCCModel.incrementCount();
+    uiRange -= uiLPS;
+    if( uiSymbol != rcCCModel.getMps() )
+    {
+      uiLow   += uiRange;
+      uiRange  = uiLPS;
+      if( ! rcCCModel.getState() )
+      {
+        rcCCModel.toggleMps();
+      }
+      rcCCModel.setState( g_aucACNextStateLPS64[rcCCModel.getState()] );
+    }
+    else
+    {
+      rcCCModel.setState( g_aucACNextStateMPS64[rcCCModel.getState()] );
+    }
+    return xRenorm( uiLow, uiRange );
+  }
+
+  ErrVal writeEPSymbol( UInt uiSymbol )
+  {
+    UInt uiLow = m_uiLow<<1;
+    if( uiSymbol != 0 )
+    {
+      uiLow += m_uiRange;
+    }
+    if( uiLow >= ONE )
+    {
+      RNOK( xWriteBitAndBitsToFollow( 1 ) );
+      uiLow -= ONE;
+    }
+    else if( uiLow < HALF )
+    {
+      RNOK( xWriteBitAndBitsToFollow( 0 ) );
+    }
+    else
+    {
+      m_uiBitsToFollow++;
+      uiLow -= HALF;
+    }
+    m_uiLow = uiLow;
+    return Err::m_nOK;
+  }
+
+  ErrVal writeTerminatingBit( UInt uiBit )
+  {
+    UInt uiRange = m_uiRange - 2;
+    UInt uiLow   = m_uiLow;
+    if( uiBit )
+    {
+      uiLow   += uiRange;
+      uiRange  = 2;
+    }
+    return xRenorm( uiLow, uiRange );
+  }
+
+  ErrVal writeEpExGolomb( UInt uiSymbol, UInt uiCount )
+  {
+    while( uiSymbol >= (UInt)(1<<uiCount) )
+    {
+      RNOK( writeEPSymbol( 1 ) );
+      uiSymbol -= 1<<uiCount;
+      uiCount  ++;
+    }
+    RNOK( writeEPSymbol( 0 ) );
+    while( uiCount-- )
+    {
+      RNOK( writeEPSymbol( (uiSymbol>>uiCount) & 1 ) );
+    }
+    return Err::m_nOK;
+  }
+
+  ErrVal writeExGolombLevel( UInt uiSymbol, CabacContextModel& rcCCModel )
+  {
+    if( ! uiSymbol )
+    {
+      return writeSymbol( 0, rcCCModel );
+    }
+    RNOK( writeSymbol( 1, rcCCModel ) );
+    UInt uiCount = 0;
+    Bool bNoExGo = ( uiSymbol < 13 );
+    while( --uiSymbol && ++uiCount < 13 )
+    {
+      RNOK( writeSymbol( 1, rcCCModel ) );
+    }
+    return ( bNoExGo ? writeSymbol( 0, rcCCModel ) : writeEpExGolomb( uiSymbol, 0 ) );
+  }
+
+  ErrVal writeExGolombMvd( UInt uiSymbol, CabacContextModel* pcCCModel, UInt uiMaxBin )
+  {
+    if( ! uiSymbol )
+    {
+      return writeSymbol( 0, *pcCCModel );
+    }
+    RNOK( writeSymbol( 1, *pcCCModel ) );
+    Bool bNoExGo = ( uiSymbol < 8 );
+    UInt uiCount = 1;
+    pcCCModel++;
+    while( --uiSymbol && ++uiCount <= 8 )
+    {
+      RNOK( writeSymbol( 1, *pcCCModel ) );
+      if( uiCount == 2 )
+      {
+        pcCCModel++;
+      }
+      if( uiCount == uiMaxBin )
+      {
+        pcCCModel++;
+      }
+    }
+    return ( bNoExGo ? writeSymbol( 0, *pcCCModel ) : writeEpExGolomb( uiSymbol, 3 ) );
+  }
+
+private:
+  ErrVal xWriteBit( UInt uiBit )
+  {
+    m_uiByte += m_uiByte + uiBit;
+    if( ! --m_uiBitsLeft )
+    {
+      const UInt uiByte = m_uiByte;
+      m_uiBitsLeft      = 8;
+      m_uiByte          = 0;
+      return m_pcBitWriteBuffer->write( uiByte, 8 );
+    }
+    return Err::m_nOK;
+  }
+
+  ErrVal xWriteBitAndBitsToFollow( UInt uiBit )
+  {
+    RNOK( xWriteBit( uiBit ) );
+    for( ; m_uiBitsToFollow > 0; m_uiBitsToFollow-- )
+    {
+      RNOK( xWriteBit( 1 - uiBit ) );
+    }
+    return Err::m_nOK;
+  }
+
+  ErrVal xRenorm( UInt uiLow, UInt uiRange )
+  {
+    while( uiRange < QUARTER )
+    {
+      if( uiLow >= HALF )
+      {
+        RNOK( xWriteBitAndBitsToFollow( 1 ) );
+        uiLow -= HALF;
+      }
+      else if( uiLow < QUARTER )
+      {
+        RNOK( xWriteBitAndBitsToFollow( 0 ) );
+      }
+      else
+      {
+        m_uiBitsToFollow++;
+        uiLow -= QUARTER;
+      }
+      uiLow   <<= 1;
+      uiRange <<= 1;
+    }
+    m_uiLow   = uiLow;
+    m_uiRange = uiRange;
+    return Err::m_nOK;
+  }
+
+  BitWriteBuffer* m_pcBitWriteBuffer;
+  UInt            m_uiRange;
+  UInt            m_uiLow;
+  UInt            m_uiByte;
+  UInt            m_uiBitsLeft;
+  UInt            m_uiBitsToFollow;
+};
+
+
+template< class Encoder >
+static ErrVal xEncodeBins( Encoder& rcEncoder, BitWriteBuffer* pcBitWriteBuffer, const CabacBinList& rcBins, UInt uiSeed, std::vector<UInt>& rcWrittenBits )
+{
+  CabacContextModel acCCModel[NUM_TEST_CONTEXTS];
+  initContextModels( acCCModel, uiSeed );
+
+  RNOK( rcEncoder.start() );
+  for( UInt n = 0; n < rcBins.size(); n++ )
+  {
+    const CabacBin& rcBin = rcBins[n];
+    switch( rcBin.eType )
+    {
+    case BIN_CONTEXT:         RNOK( rcEncoder.writeSymbol       ( rcBin.uiValue, acCCModel[rcBin.uiContext] ) );     break;
+    case BIN_BYPASS:          RNOK( rcEncoder.writeEPSymbol     ( rcBin.uiValue ) );                                 break;
+    case BIN_EP_EXGOLOMB:     RNOK( rcEncoder.writeEpExGolomb   ( rcBin.uiValue, rcBin.uiParam ) );                  break;
+    case BIN_EXGOLOMB_MVD:    RNOK( rcEncoder.writeExGolombMvd  ( rcBin.uiValue, &acCCModel[rcBin.uiContext], 3 ) ); break;
+    case BIN_EXGOLOMB_LEVEL:  RNOK( rcEncoder.writeExGolombLevel( rcBin.uiValue, acCCModel[rcBin.uiContext] ) );     break;
+    case BIN_TERMINATING:     RNOK( rcEncoder.writeTerminatingBit( 0 ) );                                            break;
+    case BIN_PCM:
+      {
+        RNOK( rcEncoder.writeTerminatingBit( 1 ) );
+        RNOK( rcEncoder.finish() );
+        RNOK( pcBitWriteBuffer->write( 1 ) );
+        RNOK( pcBitWriteBuffer->writeAlignZero() );
+        for( UInt uiByte = 0; uiByte < rcBin.uiParam; uiByte++ )
+        {
+          RNOK( pcBitWriteBuffer->write( getPCMSample( rcBin, uiByte ), 8 ) );
+        }
+        RNOK( rcEncoder.start() );
+      }
+      break;
+    }
+    rcWrittenBits.push_back( rcEncoder.getWrittenBits() );
+  }
+  RNOK( rcEncoder.writeTerminatingBit( 1 ) );
+  RNOK( rcEncoder.finish() );
+  return Err::m_nOK;
+}
+
+
+ErrVal encodeBins( const CabacBinList& rcBins, UInt uiHeader, UInt uiHeaderBits, UInt uiSeed, Bool bReference, CabacStream& rcStream )
+{
+  BitWriteBuffer* pcBitWriteBuffer = NULL;
+  RNOK( BitWriteBuffer::create( pcBitWriteBuffer ) );
+  RNOK( pcBitWriteBuffer->init() );
+
+  rcStream.cBuffer.assign( 1 << 16, 0 );
+  rcStream.cWrittenBits.clear();
+  RNOK( pcBitWriteBuffer->initPacket( &rcStream.cBuffer[0], 4 << 16 ) );
+  RNOK( pcBitWriteBuffer->write( uiHeader, uiHeaderBits ) );
+
+  if( bReference )
+  {
+    RefCabaEncoder cEncoder( pcBitWriteBuffer );
+    RNOK( xEncodeBins( cEncoder, pcBitWriteBuffer, rcBins, uiSeed, rcStream.cWrittenBits ) );
+  }
+  else
+  {
+    TestCabaEncoder cEncoder;
+    RNOK( cEncoder.init( pcBitWriteBuffer ) );
+    RNOK( xEncodeBins( cEncoder, pcBitWriteBuffer, rcBins, uiSeed, rcStream.cWrittenBits ) );
+    RNOK( cEncoder.uninit() );
+  }
+
+  //===== rbsp trailing bits =====
+  RNOK( pcBitWriteBuffer->write( 1 ) );
+  RNOK( pcBitWriteBuffer->writeAlignZero() );
+  rcStream.uiBits = pcBitWriteBuffer->getNumberOfWrittenBits();
+  RNOK( pcBitWriteBuffer->flushBuffer() );
+  RNOK( pcBitWriteBuffer->destroy() );
+  return Err::m_nOK;
+}
@@ -0,0 +1,115 @@
+#include <cstdio>
+#include <cstdlib>
+#include "CabacEngineTest.h"
+
+
+static UInt g_uiRandom = 1;
+
+Void setRandomSeed( UInt uiSeed )
+{
+  g_uiRandom = uiSeed;
+}
+
+UInt getRandom()
+{
+  g_uiRandom = g_uiRandom * 1103515245 + 12345;
+  return g_uiRandom >> 8;
+}
+
+
+Void initContextModels( CabacContextModel* pcCCModel, UInt uiSeed )
+{
+  UInt uiRandom = g_uiRandom;
+  setRandomSeed( uiSeed );
+  for( UInt n = 0; n < NUM_TEST_CONTEXTS; n++ )
+  {
+    Short asCtxInit[2] = { (Short)( (Int)( getRandom() % 60 ) - 30 ), (Short)( getRandom() % 127 ) };
+    pcCCModel[n].init( asCtxInit, (Int)( getRandom() % 52 ) );
+  }
+  g_uiRandom = uiRandom;
+}
+
+
+UInt getPCMSample( const CabacBin& rcBin, UInt uiByte )
+{
+  return ( rcBin.uiValue * 7 + uiByte * 13 ) & 0xff;
+}
+
+
+static Void xCreateBins( CabacBinList& rcBins, Bool bWithPCM )
+{
+  UInt uiNumBins  = getRandom() % 3000 + 1;
+  UInt uiSkew     = getRandom() % 100;   // probability of a 1 of the context coded bins, in percent
+
+  rcBins.clear();
+  for( UInt n = 0; n < uiNumBins; n++ )
+  {
+    CabacBin  cBin;
+    UInt      uiType = getRandom() % 100;
+    cBin.uiContext   = getRandom() % ( NUM_TEST_CONTEXTS - 3 );
+    cBin.uiParam     = 0;
+
+    if     ( uiType < 60 )  { cBin.eType = BIN_CONTEXT;         cBin.uiValue = ( getRandom() % 100 < uiSkew ? 1 : 0 ); }
+    else if( uiType < 72 )  { cBin.eType = BIN_BYPASS;          cBin.uiValue = getRandom() & 1; }
+    else if( uiType < 80 )  { cBin.eType = BIN_EP_EXGOLOMB;     cBin.uiParam = ( getRandom() & 1 ) ? 3 : 0;
+                                                                cBin.uiValue = getRandom() % ( 1 << ( getRandom() % 17 ) ); }
+    else if( uiType < 88 )  { cBin.eType = BIN_EXGOLOMB_MVD;    cBin.uiValue = getRandom() % ( 1 << ( getRandom() % 12 ) ); }
+    else if( uiType < 95 )  { cBin.eType = BIN_EXGOLOMB_LEVEL;  cBin.uiValue = getRandom() % ( 1 << ( getRandom() % 15 ) ); }
+    else if( uiType < 99 || ! bWithPCM )
+                            { cBin.eType = BIN_TERMINATING;     cBin.uiValue = 0; }
+    else                    { cBin.eType = BIN_PCM;             cBin.uiValue = getRandom() & 0xff;
+                                                                cBin.uiParam = getRandom() % 5; }
+    rcBins.push_back( cBin );
+  }
+}
+
+
+int
+main( int argc, char** argv )
+{
+  UInt uiStreams = ( argc > 1 ? (UInt)atoi( argv[1] ) : 3000 );
+  UInt uiFailed  = 0;
+
+  printf( "CABAC engine test: %d random bin streams\n\n", uiStreams );
+
+  for( UInt uiStream = 0; uiStream < uiStreams && uiFailed < 10; uiStream++ )
+  {
+    CabacBinList  cBins;
+    CabacStream   cReference;
+    CabacStream   cStream;
+    UInt          uiSeed = uiStream * 7919 + 1;
+
+    //===== a slice header of any length in front, every third stream has I_PCM macroblocks =====
+    setRandomSeed( uiSeed );
+    xCreateBins( cBins, ( uiStream % 3 ) == 0 );
+    UInt uiHeaderBits = getRandom() % 20 + 1;
+    UInt uiHeader     = getRandom() & ( ( 1 << uiHeaderBits ) - 1 );
+
+    RNOKRS( encodeBins( cBins, uiHeader, uiHeaderBits, uiSeed, true,  cReference ), 2 );
+    RNOKRS( encodeBins( cBins, uiHeader, uiHeaderBits, uiSeed, false, cStream    ), 2 );
+
+    //===== the engine writes the same bits and counts them the same way =====
+    Bool bSame = ( cStream.uiBits == cReference.uiBits && cStream.cWrittenBits == cReference.cWrittenBits );
+    for( UInt n = 0; bSame && n < ( cStream.uiBits + 31 ) / 32; n++ )
+    {
+      bSame = ( cStream.cBuffer[n] == cReference.cBuffer[n] );
+    }
+
+    //===== and both decoders get the bins back =====
+    UInt uiFailedReference = 0;
+    UInt uiFailedBin       = 0;
+    RNOKRS( decodeBins( cBins, uiHeaderBits, uiSeed, true,  cStream, uiFailedReference ), 2 );
+    RNOKRS( decodeBins( cBins, uiHeaderBits, uiSeed, false, cStream, uiFailedBin       ), 2 );
+
+    if( ! bSame || uiFailedReference || uiFailedBin )
+    {
+      printf( "stream %d (%d bins): %s, %d instead of %d bits, decoding failed at bin %d (reference decoder: %d)\n",
+              uiStream, (UInt)cBins.size(), bSame ? "same bits" : "DIFFERENT BITS", cStream.uiBits, cReference.uiBits,
+              uiFailedBin, uiFailedReference );
+      uiFailed++;
+    }
+  }
+
+  printf( "\n%s\n", uiFailed ? "CABAC engine test FAILED" : "CABAC engine test passed" );
+  return uiFailed ? 1 : 0;
+}
@@ -0,0 +1,60 @@
+#ifndef __CABACENGINETEST_H_8C2F4A17_5E3B_4D90_B1A6_7F0E29C4D583
+#define __CABACENGINETEST_H_8C2F4A17_5E3B_4D90_B1A6_7F0E29C4D583
+
+
+#include "H264AVCCommonLib.h"
+#include "H264AVCCommonLib/CabacContextModel.h"
+#include <vector>
+
+using namespace h264;
+
+
+#define NUM_TEST_CONTEXTS 32
+
+
+//===== the bins of a random stream, coded with the functions the slice writers and parsers use =====
+enum CabacBinType
+{
+  BIN_CONTEXT,          // writeSymbol / getSymbol
+  BIN_BYPASS,           // writeEPSymbol / getEpSymbol
+  BIN_EP_EXGOLOMB,      // writeEpExGolomb / getEpExGolomb, uiParam is k
+  BIN_EXGOLOMB_MVD,     // writeExGolombMvd / getExGolombMvd
+  BIN_EXGOLOMB_LEVEL,   // writeExGolombLevel / getExGolombLevel
+  BIN_TERMINATING,      // end_of_slice_flag equal to 0
+  BIN_PCM               // I_PCM: terminating bin, finish, uiParam bytes of samples, restart
+};
+
+struct CabacBin
+{
+  CabacBinType  eType;
+  UInt          uiValue;
+  UInt          uiContext;
+  UInt          uiParam;
+};
+
+typedef std::vector<CabacBin> CabacBinList;
+
+struct CabacStream
+{
+  std::vector<UInt32> cBuffer;
+  UInt                uiBits;
+  std::vector<UInt>   cWrittenBits;   // getWrittenBits() after each bin
+};
+
+
+//===== random numbers, reproducible from run to run =====
+Void  setRandomSeed     ( UInt uiSeed );
+UInt  getRandom         ();
+
+Void  initContextModels ( CabacContextModel* pcCCModel, UInt uiSeed );
+UInt  getPCMSample      ( const CabacBin& rcBin, UInt uiByte );
+
+
+//===== bReference selects the bit-wise engine the library used before, a header of uiHeaderBits precedes the slice data =====
+ErrVal encodeBins( const CabacBinList& rcBins, UInt uiHeader, UInt uiHeaderBits, UInt uiSeed, Bool bReference, CabacStream& rcStream );
+
+//===== ruiFailedBin is 0 when all bins are decoded correctly, else the number of the first wrong bin plus 1 =====
+ErrVal decodeBins( const CabacBinList& rcBins, UInt uiHeaderBits, UInt uiSeed, Bool bReference, const CabacStream& rcStream, UInt& ruiFailedBin );
+
+
+#endif //__CABACENGINETEST_H_8C2F4A17_5E3B_4D90_B1A6_7F0E29C4D583
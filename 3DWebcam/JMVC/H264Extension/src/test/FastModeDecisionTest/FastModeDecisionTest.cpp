@@ -0,0 +1,349 @@
+#include <cstdio>
+#include <cstdlib>
+#include <cmath>
+#include <ctime>
+#include <string>
+#include <vector>
+#include "H264AVCEncoderLibTest.h"
+#include "H264AVCEncoderTest.h"
+
+
+#define WIDTH         176
+#define HEIGHT        144
+#define FRAME_RATE    25.0
+#define NUM_QPS       4
+#define NUM_LEVELS    3     // FastModeDecision 0, 1, 2
+#define TEXTURE_SIZE  512
+
+static const UInt   g_auiQp         [NUM_QPS]     = { 22, 27, 32, 37 };
+static const Double g_adMaxBDRate   [NUM_LEVELS]  = { 0.0, 1.0, 3.0 };  // percent, the loss a level may cost
+
+
+//===== one rate point: kbit/s, luma PSNR and encoding time =====
+typedef struct
+{
+  Double  dKbps;
+  Double  dPSNR;
+  Double  dSeconds;
+} RatePoint;
+
+
+//===== synthetic test sequences =====
+static UInt xRandom( UInt& ruiSeed )
+{
+  ruiSeed = ruiSeed * 1103515245 + 12345;
+  return ( ruiSeed >> 16 ) & 0x7fff;
+}
+
+static Double xLattice( Int iX, Int iY, UInt uiOctave )
+{
+  UInt uiHash = (UInt)iX * 73856093u ^ (UInt)iY * 19349663u ^ uiOctave * 83492791u;
+  uiHash ^= uiHash << 13;
+  uiHash ^= uiHash >> 17;
+  uiHash ^= uiHash << 5;
+  return ( uiHash & 0xffff ) / 65535.0;
+}
+
+static Double xValueNoise( Double dX, Double dY, UInt uiOctave )
+{
+  Int    iX  = (Int)floor( dX );
+  Int    iY  = (Int)floor( dY );
+  Double dFX = dX - iX;
+  Double dFY = dY - iY;
+  dFX        = dFX * dFX * ( 3 - 2 * dFX );
+  dFY        = dFY * dFY * ( 3 - 2 * dFY );
+  Double dA  = xLattice( iX, iY,     uiOctave ), dB = xLattice( iX + 1, iY,     uiOctave );
+  Double dC  = xLattice( iX, iY + 1, uiOctave ), dD = xLattice( iX + 1, iY + 1, uiOctave );
+  return dA + ( dB - dA ) * dFX + ( dC - dA ) * dFY + ( dA - dB - dC + dD ) * dFX * dFY;
+}
+
+// fractal noise with a few hard edges, so that the macroblocks have a mix of flat, textured and edge content
+static Void xCreateTexture( std::vector<Double>& rcTexture )
+{
+  rcTexture.resize( TEXTURE_SIZE * TEXTURE_SIZE );
+  for( Int y = 0; y < TEXTURE_SIZE; y++ )
+  for( Int x = 0; x < TEXTURE_SIZE; x++ )
+  {
+    Double dSum = 0, dAmp = 1, dFreq = 1 / 64.0, dNorm = 0;
+    for( UInt uiOctave = 0; uiOctave < 6; uiOctave++, dAmp *= 0.55, dFreq *= 2 )
+    {
+      dSum  += dAmp * xValueNoise( x * dFreq, y * dFreq, uiOctave );
+      dNorm += dAmp;
+    }
+    Double dBand = floor( xValueNoise( x / 96.0, y / 96.0, 9 ) * 4 ) / 4;
+    rcTexture[y * TEXTURE_SIZE + x] = 255 * ( 0.55 * dSum / dNorm + 0.45 * dBand );
+  }
+}
+
+static Double xSample( const std::vector<Double>& rcTexture, Double dX, Double dY )
+{
+  Int    iX  = (Int)floor( dX ), iY = (Int)floor( dY );
+  Double dFX = dX - iX,          dFY = dY - iY;
+  Int    iX0 = iX & ( TEXTURE_SIZE - 1 ), iX1 = ( iX + 1 ) & ( TEXTURE_SIZE - 1 );
+  Int    iY0 = iY & ( TEXTURE_SIZE - 1 ), iY1 = ( iY + 1 ) & ( TEXTURE_SIZE - 1 );
+  return rcTexture[iY0 * TEXTURE_SIZE + iX0] * ( 1 - dFX ) * ( 1 - dFY ) + rcTexture[iY0 * TEXTURE_SIZE + iX1] * dFX * ( 1 - dFY )
+       + rcTexture[iY1 * TEXTURE_SIZE + iX0] * ( 1 - dFX ) * dFY         + rcTexture[iY1 * TEXTURE_SIZE + iX1] * dFX * dFY;
+}
+
+// bPan: camera pan with an object crossing the picture, otherwise a nearly static background with a swaying object
+static ErrVal xWriteSequence( const std::string& rcFilename, Bool bPan, UInt uiNumFrames )
+{
+  std::vector<Double> cTexture;
+  std::vector<UChar>  cPicture( WIDTH * HEIGHT * 3 / 2 );
+  UInt                uiSeed  = 1;
+  FILE*               pFile   = ::fopen( rcFilename.c_str(), "wb" );
+  ROF( pFile );
+  xCreateTexture( cTexture );
+
+  for( UInt uiFrame = 0; uiFrame < uiNumFrames; uiFrame++ )
+  {
+    Double dPanX    = ( bPan ? uiFrame * 1.37 : 2 * sin( uiFrame * 0.2 ) );
+    Double dPanY    = ( bPan ? uiFrame * 0.41 : 0 );
+    Double dObjX    = WIDTH  / 2 + ( bPan ? -2.1 * uiFrame : 20 * sin( uiFrame * 0.15 ) );
+    Double dObjY    = HEIGHT / 2 + ( bPan ?  0.7 * uiFrame :  8 * cos( uiFrame * 0.23 ) );
+    Double dRadius  = HEIGHT / 5.0;
+    UChar* pucLum   = &cPicture[0];
+    UChar* pucCb    = pucLum + WIDTH * HEIGHT;
+    UChar* pucCr    = pucCb  + WIDTH * HEIGHT / 4;
+
+    for( Int y = 0; y < HEIGHT; y++ )
+    for( Int x = 0; x < WIDTH;  x++ )
+    {
+      Double dX   = x - dObjX;
+      Double dY   = y - dObjY;
+      Double dPel = ( dX * dX + dY * dY * 1.4 < dRadius * dRadius
+                    ? 40 + 0.8 * xSample( cTexture, x * 1.3 + 200 - uiFrame * 0.8, y * 1.3 + 300 + uiFrame * 0.3 )
+                    :             xSample( cTexture, x + dPanX, y + dPanY ) );
+      dPel       += ( xRandom( uiSeed ) % 7 ) - 3.0;
+      pucLum[y * WIDTH + x] = (UChar)( dPel < 0 ? 0 : dPel > 255 ? 255 : dPel );
+    }
+    for( Int y = 0; y < HEIGHT / 2; y++ )
+    for( Int x = 0; x < WIDTH  / 2; x++ )
+    {
+      Int iLum = ( pucLum[2 * y * WIDTH + 2 * x] + pucLum[2 * y * WIDTH + 2 * x + 1] + pucLum[( 2 * y + 1 ) * WIDTH + 2 * x] + pucLum[( 2 * y + 1 ) * WIDTH + 2 * x + 1] ) / 4;
+      pucCb[y * WIDTH / 2 + x] = (UChar)( 128 + ( iLum - 128 ) / 6 );
+      pucCr[y * WIDTH / 2 + x] = (UChar)( 128 - ( iLum - 128 ) / 8 );
+    }
+    ::fwrite( &cPicture[0], 1, cPicture.size(), pFile );
+  }
+  ::fclose( pFile );
+  return Err::m_nOK;
+}
+
+
+//===== encoding of view 0 =====
+static ErrVal xWriteConfig( const std::string& rcConfigFile, UInt uiNumFrames, UInt uiQp, UInt uiLevel )
+{
+  FILE* pFile = ::fopen( rcConfigFile.c_str(), "w" );
+  ROF( pFile );
+
+  ::fprintf( pFile, "InputFile               FastModeDecisionTest_in\n"
+                    "OutputFile              FastModeDecisionTest_out\n"
+                    "ReconFile               FastModeDecisionTest_rec\n"
+                    "SourceWidth             %d\n"
+                    "SourceHeight            %d\n"
+                    "FrameRate               %.1f\n"
+                    "FramesToBeEncoded       %d\n"
+                    "SymbolMode              1\n"
+                    "FRExt                   1\n"
+                    "BasisQP                 %d\n"
+                    "GOPSize                 4\n"
+                    "IntraPeriod             12\n"
+                    "NumberReferenceFrames   2\n"
+                    "InterPredPicsFirst      1\n"
+                    "DeltaLayer0Quant        0\n"
+                    "DeltaLayer1Quant        3\n"
+                    "DeltaLayer2Quant        4\n"
+                    "SearchMode              4\n"
+                    "SearchFuncFullPel       3\n"
+                    "SearchFuncSubPel        2\n"
+                    "SearchRange             32\n"
+                    "BiPredIter              4\n"
+                    "IterSearchRange         8\n"
+                    "FastModeDecision        %d\n"
+                    "NumViewsMinusOne        0\n"
+                    "ViewOrder               0\n"
+                    "View_ID                 0\n"
+                    "Fwd_NumAnchorRefs       0\n"
+                    "Bwd_NumAnchorRefs       0\n"
+                    "Fwd_NumNonAnchorRefs    0\n"
+                    "Bwd_NumNonAnchorRefs    0\n",
+                    WIDTH, HEIGHT, FRAME_RATE, uiNumFrames, uiQp, uiLevel );
+  ::fclose( pFile );
+  return Err::m_nOK;
+}
+
+static Double xGetFileSize( const std::string& rcFilename )
+{
+  FILE* pFile = ::fopen( rcFilename.c_str(), "rb" );
+  if( ! pFile )
+  {
+    return 0;
+  }
+  ::fseek( pFile, 0, SEEK_END );
+  Double dSize = (Double)::ftell( pFile );
+  ::fclose( pFile );
+  return dSize;
+}
+
+static Double xGetLumaPSNR( const std::string& rcOrgFilename, const std::string& rcRecFilename, UInt uiNumFrames )
+{
+  FILE*               pOrg    = ::fopen( rcOrgFilename.c_str(), "rb" );
+  FILE*               pRec    = ::fopen( rcRecFilename.c_str(), "rb" );
+  std::vector<UChar>  cOrg( WIDTH * HEIGHT * 3 / 2 );
+  std::vector<UChar>  cRec( WIDTH * HEIGHT * 3 / 2 );
+  Double              dSum    = 0;
+  UInt                uiRead  = 0;
+
+  for( ; pOrg && pRec && uiRead < uiNumFrames; uiRead++ )
+  {
+    if( ::fread( &cOrg[0], 1, cOrg.size(), pOrg ) != cOrg.size() ||
+        ::fread( &cRec[0], 1, cRec.size(), pRec ) != cRec.size() )
+    {
+      break;
+    }
+    Double dSSD = 0;
+    for( UInt n = 0; n < WIDTH * HEIGHT; n++ )
+    {
+      Int iDiff = cOrg[n] - cRec[n];
+      dSSD     += iDiff * iDiff;
+    }
+    dSum += ( dSSD ? 10 * log10( 255.0 * 255.0 * WIDTH * HEIGHT / dSSD ) : 99.99 );
+  }
+  if( pOrg ) ::fclose( pOrg );
+  if( pRec ) ::fclose( pRec );
+  return ( uiRead == uiNumFrames ? dSum / uiNumFrames : 0 );
+}
+
+static ErrVal xEncode( UInt uiNumFrames, UInt uiQp, UInt uiLevel, RatePoint& rcPoint )
+{
+  const std::string cConfigFile( "FastModeDecisionTest.cfg" );
+  RNOK( xWriteConfig( cConfigFile, uiNumFrames, uiQp, uiLevel ) );
+
+  Char                acName  []  = "FastModeDecisionTest";
+  Char                acOption[]  = "-vf";
+  Char                acView  []  = "0";
+  Char*               apcArgv [5] = { acName, acOption, (Char*)cConfigFile.c_str(), acView, NULL };
+  H264AVCEncoderTest* pcEncoder   = NULL;
+
+  std::clock_t cStart = std::clock();
+  RNOK( H264AVCEncoderTest::create( pcEncoder ) );
+  RNOK( pcEncoder->init( 4, apcArgv ) );
+  RNOK( pcEncoder->go() );
+  RNOK( pcEncoder->destroy() );
+  rcPoint.dSeconds = (Double)( std::clock() - cStart ) / CLOCKS_PER_SEC;
+
+  rcPoint.dKbps    = xGetFileSize( "FastModeDecisionTest_out_0.264" ) * 8 * FRAME_RATE / uiNumFrames / 1000.0;
+  rcPoint.dPSNR    = xGetLumaPSNR( "FastModeDecisionTest_in_0.yuv", "FastModeDecisionTest_rec_0.yuv", uiNumFrames );
+  ::remove( cConfigFile.c_str() );
+  ::remove( "FastModeDecisionTest_out_0.264" );
+  ::remove( "FastModeDecisionTest_rec_0.yuv" );
+
+  ROF( rcPoint.dKbps > 0 && rcPoint.dPSNR > 0 );
+  return Err::m_nOK;
+}
+
+
+//===== Bjontegaard delta rate: cubic fits of log rate over PSNR, averaged over the common PSNR interval =====
+static Void xFitCubic( const RatePoint* pcPoints, Double* pdCoeff )
+{
+  Double aadMatrix[4][5];
+  for( UInt i = 0; i < 4; i++ )
+  {
+    for( UInt k = 0; k < 4; k++ )
+    {
+      aadMatrix[i][k] = pow( pcPoints[i].dPSNR, (Double)k );
+    }
+    aadMatrix[i][4] = log( pcPoints[i].dKbps );
+  }
+  for( UInt c = 0; c < 4; c++ )
+  {
+    UInt uiPivot = c;
+    for( UInt r = c + 1; r < 4; r++ )
+    {
+      uiPivot = ( fabs( aadMatrix[r][c] ) > fabs( aadMatrix[uiPivot][c] ) ? r : uiPivot );
+    }
+    for( UInt k = 0; k < 5; k++ )
+    {
+      std::swap( aadMatrix[c][k], aadMatrix[uiPivot][k] );
+    }
+    for( UInt r = 0; r < 4; r++ )
+    {
+      Double dFactor = ( r == c ? 0 : aadMatrix[r][c] / aadMatrix[c][c] );
+      for( UInt k = c; k < 5; k++ )
+      {
+        aadMatrix[r][k] -= dFactor * aadMatrix[c][k];
+      }
+    }
+  }
+  for( UInt k = 0; k < 4; k++ )
+  {
+    pdCoeff[k] = aadMatrix[k][4] / aadMatrix[k][k];
+  }
+}
+
+static Double xIntegrate( const Double* pdCoeff, Double dLow, Double dHigh )
+{
+  Double dSum = 0;
+  for( UInt k = 0; k < 4; k++ )
+  {
+    dSum += pdCoeff[k] * ( pow( dHigh, k + 1.0 ) - pow( dLow, k + 1.0 ) ) / ( k + 1 );
+  }
+  return dSum;
+}
+
+static Double xGetBDRate( const RatePoint* pcAnchor, const RatePoint* pcTest )
+{
+  //===== the QPs are ascending, so the first point has the highest PSNR =====
+  Double adAnchor[4], adTest[4];
+  Double dLow  = max( pcAnchor[NUM_QPS - 1].dPSNR, pcTest[NUM_QPS - 1].dPSNR );
+  Double dHigh = min( pcAnchor[0          ].dPSNR, pcTest[0          ].dPSNR );
+  xFitCubic( pcAnchor, adAnchor );
+  xFitCubic( pcTest,   adTest   );
+  Double dDiff = ( xIntegrate( adTest, dLow, dHigh ) - xIntegrate( adAnchor, dLow, dHigh ) ) / ( dHigh - dLow );
+  return ( exp( dDiff ) - 1 ) * 100;
+}
+
+
+int
+main( int argc, char** argv )
+{
+  UInt        uiNumFrames = ( argc > 1 ? (UInt)atoi( argv[1] ) : 30 );
+  UInt        uiFailed    = 0;
+  const Char* apcName[2]  = { "pan", "talk" };
+  RatePoint   aacPoint[NUM_LEVELS][NUM_QPS];
+
+  for( UInt uiSeq = 0; uiSeq < 2; uiSeq++ )
+  {
+    RNOKRS( xWriteSequence( "FastModeDecisionTest_in_0.yuv", uiSeq == 0, uiNumFrames ), 2 );
+    for( UInt uiLevel = 0; uiLevel < NUM_LEVELS; uiLevel++ )
+    for( UInt uiQp    = 0; uiQp    < NUM_QPS;    uiQp++    )
+    {
+      RNOKRS( xEncode( uiNumFrames, g_auiQp[uiQp], uiLevel, aacPoint[uiLevel][uiQp] ), 2 );
+    }
+    ::remove( "FastModeDecisionTest_in_0.yuv" );
+
+    //===== every level against the full mode decision =====
+    printf( "\n%s, %d frames %dx%d\n", apcName[uiSeq], uiNumFrames, WIDTH, HEIGHT );
+    for( UInt uiLevel = 0; uiLevel < NUM_LEVELS; uiLevel++ )
+    {
+      Double dTime = 0, dAnchorTime = 0;
+      for( UInt uiQp = 0; uiQp < NUM_QPS; uiQp++ )
+      {
+        dTime       += aacPoint[uiLevel][uiQp].dSeconds;
+        dAnchorTime += aacPoint[0      ][uiQp].dSeconds;
+        printf( "  FastModeDecision %d  QP %d: %8.2f kbit/s  %7.4f dB  %6.2f s\n", uiLevel, g_auiQp[uiQp],
+                aacPoint[uiLevel][uiQp].dKbps, aacPoint[uiLevel][uiQp].dPSNR, aacPoint[uiLevel][uiQp].dSeconds );
+      }
+      Double dSpeedUp = dAnchorTime / max( dTime, 1e-6 );
+      Double dBDRate  = xGetBDRate( aacPoint[0], aacPoint[uiLevel] );
+      Bool   bOk      = ( dBDRate <= g_adMaxBDRate[uiLevel] && ( uiLevel == 0 || dSpeedUp > 1.0 ) );
+      printf( "  FastModeDecision %d: speed-up %5.2fx  BD-rate %+6.2f %% (at most %+.2f %%) %s\n\n",
+              uiLevel, dSpeedUp, dBDRate, g_adMaxBDRate[uiLevel], bOk ? "ok" : "FAILED" );
+      uiFailed += ( bOk ? 0 : 1 );
+    }
+  }
+
+  printf( "%s\n", uiFailed ? "fast mode decision test FAILED" : "fast mode decision test passed" );
+  return uiFailed ? 1 : 0;
+}
@@ -0,0 +1,151 @@
+#if defined( WIN32 )
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <winsock2.h>
+# pragma comment( lib, "ws2_32.lib" )
+# define SHUT_RDWR  SD_BOTH
+# define close      closesocket
+typedef int socklen_t;
+#else
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <unistd.h>
+#endif
+
+#include <cstdio>
+#include "H264AVCDecoderLibTest.h"
+#include "BitstreamReceiver.h"
+
+
+BitstreamReceiver::BitstreamReceiver() :
+  m_pcReadBitstreamStream ( NULL ),
+  m_iListenSocket         ( -1 ),
+  m_iSocket               ( -1 )
+{
+}
+
+
+BitstreamReceiver::~BitstreamReceiver()
+{
+}
+
+
+ErrVal BitstreamReceiver::create( BitstreamReceiver*& rpcBitstreamReceiver )
+{
+  rpcBitstreamReceiver = new BitstreamReceiver;
+  ROT( NULL == rpcBitstreamReceiver );
+  return Err::m_nOK;
+}
+
+
+ErrVal BitstreamReceiver::destroy()
+{
+  RNOK( uninit() );
+
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal BitstreamReceiver::init( ReadBitstreamStream* pcReadBitstreamStream, UInt uiPort )
+{
+  ROF( pcReadBitstreamStream );
+  ROT( 0 == uiPort || uiPort > 0xffff );
+
+#if defined( WIN32 )
+  WSADATA cWsaData;
+  ROT( WSAStartup( MAKEWORD( 2, 2 ), &cWsaData ) );
+#endif
+
+  m_pcReadBitstreamStream = pcReadBitstreamStream;
+  m_iListenSocket         = (Int)::socket( AF_INET, SOCK_STREAM, 0 );
+  ROT( m_iListenSocket < 0 );
+
+  int iReuse = 1;
+  ::setsockopt( m_iListenSocket, SOL_SOCKET, SO_REUSEADDR, (const char*)&iReuse, sizeof( iReuse ) );
+
+  sockaddr_in cAddress;
+  ::memset( &cAddress, 0, sizeof( cAddress ) );
+  cAddress.sin_family       = AF_INET;
+  cAddress.sin_addr.s_addr  = htonl( INADDR_ANY );
+  cAddress.sin_port         = htons( (unsigned short)uiPort );
+
+  if( ::bind  ( m_iListenSocket, (sockaddr*)&cAddress, sizeof( cAddress ) ) ||
+      ::listen( m_iListenSocket, 1 ) )
+  {
+    fprintf( stderr, "cannot listen on port %d\n", uiPort );
+    return Err::m_nERR;
+  }
+  printf( "waiting for the bitstream on port %d\n", uiPort );
+  return Err::m_nOK;
+}
+
+
+ErrVal BitstreamReceiver::uninit()
+{
+  if( m_iListenSocket >= 0 )
+  {
+    ::close( m_iListenSocket );
+    m_iListenSocket = -1;
+#if defined( WIN32 )
+    WSACleanup();
+#endif
+  }
+  m_pcReadBitstreamStream = NULL;
+  return Err::m_nOK;
+}
+
+
+ErrVal BitstreamReceiver::receive()
+{
+  ROF( m_pcReadBitstreamStream );
+
+  sockaddr_in cAddress;
+  socklen_t   iAddressSize  = sizeof( cAddress );
+  Int         iSocket       = (Int)::accept( m_iListenSocket, (sockaddr*)&cAddress, &iAddressSize );
+  m_iSocket = iSocket;
+  if( iSocket < 0 )
+  {
+    m_pcReadBitstreamStream->endStream();
+    return Err::m_nERR;
+  }
+
+  //===== append what has been received so far, the decoder extracts the complete NAL units =====
+  ErrVal nRet = Err::m_nOK;
+  UChar  aucBuffer[0x10000];
+  while( true )
+  {
+    Int iSize = (Int)::recv( iSocket, (char*)aucBuffer, sizeof( aucBuffer ), 0 );
+    if( iSize <= 0 )
+    {
+      nRet = ( iSize < 0 ? Err::m_nERR : Err::m_nOK );
+      break;
+    }
+    if( Err::m_nOK != m_pcReadBitstreamStream->append( aucBuffer, (UInt)iSize ) )
+    {
+      nRet = Err::m_nERR;
+      break;
+    }
+  }
+
+  m_iSocket = -1;
+  ::close( iSocket );
+  m_pcReadBitstreamStream->endStream();
+  return nRet;
+}
+
+
+Void BitstreamReceiver::abort()
+{
+  ROFVS( m_pcReadBitstreamStream );
+
+  m_pcReadBitstreamStream->endStream();
+  if( m_iSocket >= 0 )
+  {
+    ::shutdown( m_iSocket, SHUT_RDWR );
+  }
+  if( m_iListenSocket >= 0 )
+  {
+    ::shutdown( m_iListenSocket, SHUT_RDWR );
+  }
+}
@@ -0,0 +1,43 @@
+#if !defined(AFX_BITSTREAMRECEIVER_H__2E7B9C14_5D60_4A8F_B3E1_94C0F7A2D358__INCLUDED_)
+#define AFX_BITSTREAMRECEIVER_H__2E7B9C14_5D60_4A8F_B3E1_94C0F7A2D358__INCLUDED_
+
+#if _MSC_VER > 1000
+#pragma once
+#endif // _MSC_VER > 1000
+
+
+#include "ReadBitstreamStream.h"
+
+
+// Receives the byte stream of one TCP connection and appends it to a
+// ReadBitstreamStream while the decoder runs on another thread. TCP does
+// not keep the boundaries of what the sender wrote, so a NAL unit is
+// decoded once the start code of the next one has been received. Any TCP
+// client can feed it, e.g. "nc localhost <port> < stream.264".
+class BitstreamReceiver
+{
+protected:
+  BitstreamReceiver();
+  virtual ~BitstreamReceiver();
+
+public:
+  static ErrVal create  ( BitstreamReceiver*& rpcBitstreamReceiver );
+  ErrVal        destroy ();
+
+  // listens on the port, the connection is accepted by receive()
+  ErrVal        init    ( ReadBitstreamStream* pcReadBitstreamStream, UInt uiPort );
+  ErrVal        uninit  ();
+
+  // accepts one connection and appends its bytes until the sender closes it, the stream is ended in any case
+  ErrVal        receive ();
+  // makes a receive() on another thread return, e.g. when the decoder failed
+  Void          abort   ();
+
+protected:
+  ReadBitstreamStream*  m_pcReadBitstreamStream;
+  Int                   m_iListenSocket;
+  volatile Int          m_iSocket;
+};
+
+
+#endif // !defined(AFX_BITSTREAMRECEIVER_H__2E7B9C14_5D60_4A8F_B3E1_94C0F7A2D358__INCLUDED_)
@@ -22,9 +22,54 @@ ErrVal DecoderParameter::init(int argc, char** argv)
 //  Char* pcCom;
 
   
+  //===== optional last arguments -hp: picture buffers backed by huge pages, -pd: pipelined decoding, -pv: parallel views, =====
+  //===== -tv <ViewId>[,<ViewId>...]: target views, -op <OpId>: target operation point                                     =====
+  bHugePages     = false;
+  bPipelined     = false;
+  bParallelViews = false;
+  uiTargetOpId   = MSYS_UINT_MAX;
+  cTargetViewIdList.clear();
+  for( ; argc > 1; argc-- )
+  {
+    if( 0 == strcmp( argv[argc-1], "-hp" ) )
+      bHugePages = true;
+    else if( 0 == strcmp( argv[argc-1], "-pd" ) )
+      bPipelined = true;
+    else if( 0 == strcmp( argv[argc-1], "-pv" ) )
+      bParallelViews = true;
+    else if( 0 == strcmp( argv[argc-1], "-op" ) || 0 == strcmp( argv[argc-1], "-tv" ) )
+    {
+      RNOKS ( xPrintUsage(argv) ); // the value is missing
+    }
+    else if( argc > 2 && 0 == strcmp( argv[argc-2], "-op" ) )
+    {
+      Char* pcEnd  = NULL;
+      uiTargetOpId = (UInt)strtoul( argv[argc-1], &pcEnd, 10 );
+      if( pcEnd == argv[argc-1] || *pcEnd != '\0' )
+        RNOKS ( xPrintUsage(argv) );
+      argc--;
+    }
+    else if( argc > 2 && 0 == strcmp( argv[argc-2], "-tv" ) )
+    {
+      for( const Char* pcView = argv[argc-1]; pcView; pcView = ::strchr( pcView, ',' ) )
+      {
+        pcView += ( *pcView == ',' );
+        cTargetViewIdList.push_back( (UInt)atoi( pcView ) );
+      }
+      argc--;
+    }
+    else
+      break;
+  }
+
   if (argc <4 || argc>5)
     RNOKS ( xPrintUsage(argv) );
+  if( uiTargetOpId != MSYS_UINT_MAX && ! cTargetViewIdList.empty() )
+    RNOKS ( xPrintUsage(argv) ); // -tv and -op exclude each other
   cBitstreamFile = argv[1]; // input bitstream
+  uiStreamPort   = ( equals( argv[1], "tcp:", 4 ) ? atoi( argv[1] + 4 ) : 0 );
+  if( equals( argv[1], "tcp:", 4 ) && 0 == uiStreamPort )
+    RNOKS ( xPrintUsage(argv) );
   cYuvFile       = argv[2]; // decoded output file
 
   uiNumOfViews   = atoi (argv[3]);
@@ -44,6 +89,11 @@ ErrVal DecoderParameter::init(int argc, char** argv)
 
 ErrVal DecoderParameter::xPrintUsage(char **argv)
 {
-	printf("usage: %s <BitstreamFile> <YuvOutputFile> <NumOfViews>  [<maxPodDiff>] \n\n", argv[0] );
+	printf("usage: %s <BitstreamFile> <YuvOutputFile> <NumOfViews>  [<maxPodDiff>] [-hp] [-pd] [-pv] [-tv <ViewId>[,<ViewId>...] | -op <OpId>]\n", argv[0] );
+	printf("       -pd parses, reconstructs and deblocks the frames on three threads\n" );
+	printf("       -pv reconstructs the views on one thread each (parallel decoding info SEI)\n" );
+	printf("       -tv decodes the target views and the views they reference, the slices of the other views are dropped\n" );
+	printf("       -op decodes the target views of the operation point of the view scalability info SEI\n" );
+	printf("       <BitstreamFile> tcp:<port> decodes the bitstream sent to the TCP port while it is received\n\n" );
 	RERRS();
 }
@@ -34,6 +34,12 @@ public:
   UInt				 uiErrorConceal;
 
   UInt         uiNumOfViews;
+  Bool         bHugePages;   // picture buffers backed by huge pages (-hp)
+  Bool         bPipelined;   // parsing, reconstruction and deblocking on three threads (-pd)
+  Bool         bParallelViews; // reconstruction of the views on one thread each (-pv)
+  UInt         uiStreamPort; // bitstream received on this TCP port (tcp:<port> as bitstream file), 0: read from the file
+  std::vector<UInt> cTargetViewIdList; // target views (-tv), empty: all views are decoded
+  UInt         uiTargetOpId; // target operation point (-op), MSYS_UINT_MAX: none
   UInt getNumOfViews() { return uiNumOfViews;}
 
 
@@ -1,6 +1,7 @@
 #include <cstdio>
 #include "H264AVCDecoderLibTest.h"
 #include "H264AVCDecoderTest.h"
+#include "BitstreamReceiver.h"
 
 
 int
@@ -19,15 +20,52 @@ main( int argc, char** argv)
 
   RNOKS( WriteYuvToFile::createMVC( pcWriteYuv, cParameter.cYuvFile, cParameter.uiNumOfViews ) );
 
-  ReadBitstreamFile *pcReadBitstreamFile;
-  RNOKS( ReadBitstreamFile::create( pcReadBitstreamFile ) ); 
-  RNOKS( pcReadBitstreamFile->init( cParameter.cBitstreamFile ) );  
+  ReadBitstreamIf     *pcReadBitstream        = NULL;
+  ReadBitstreamStream *pcReadBitstreamStream  = NULL;
+  BitstreamReceiver   *pcBitstreamReceiver    = NULL;
+  if( cParameter.uiStreamPort )
+  {
+    //===== the bitstream is decoded while it is received on the port =====
+    RNOKS( ReadBitstreamStream::create( pcReadBitstreamStream ) );
+    RNOKS( pcReadBitstreamStream->init( 1 << 22 ) );
+    RNOKS( BitstreamReceiver::create( pcBitstreamReceiver ) );
+    RNOKRS( pcBitstreamReceiver->init( pcReadBitstreamStream, cParameter.uiStreamPort ), -1 );
+    pcReadBitstream = pcReadBitstreamStream;
+  }
+  else
+  {
+    ReadBitstreamFile *pcReadBitstreamFile;
+    RNOKS( ReadBitstreamFile::create( pcReadBitstreamFile ) ); 
+    RNOKS( pcReadBitstreamFile->init( cParameter.cBitstreamFile ) );  
+    pcReadBitstream = pcReadBitstreamFile;
+  }
 //TMM_EC }}
 	for( UInt n = 0; n < nCount; n++ )
   {
     RNOKR( H264AVCDecoderTest::create   ( pcH264AVCDecoderTest ), -3 );
-    RNOKR( pcH264AVCDecoderTest->init   ( &cParameter, (WriteYuvToFile*)pcWriteYuv, pcReadBitstreamFile ),          -4 );
-    RNOKR( pcH264AVCDecoderTest->go     (),                       -5 );
+    RNOKR( pcH264AVCDecoderTest->init   ( &cParameter, (WriteYuvToFile*)pcWriteYuv, pcReadBitstream ),          -4 );
+    if( pcBitstreamReceiver )
+    {
+      //===== one thread receives, the other one decodes =====
+      ErrVal nDecoderResult = Err::m_nOK;
+#pragma omp parallel sections num_threads( 2 )
+      {
+#pragma omp section
+        {
+          pcBitstreamReceiver->receive();
+        }
+#pragma omp section
+        {
+          nDecoderResult = pcH264AVCDecoderTest->go();
+          pcBitstreamReceiver->abort();
+        }
+      }
+      RNOKR( nDecoderResult,                                      -5 );
+    }
+    else
+    {
+      RNOKR( pcH264AVCDecoderTest->go   (),                       -5 );
+    }
     RNOKR( pcH264AVCDecoderTest->destroy(),                       -6 );
   }
 //TMM_EC {{
@@ -36,10 +74,15 @@ main( int argc, char** argv)
     RNOK( pcWriteYuv->destroy() );  
   }
 
-  if( NULL != pcReadBitstreamFile )     
+  if( NULL != pcBitstreamReceiver )
+  {
+    RNOK( pcBitstreamReceiver->destroy() );
+  }
+
+  if( NULL != pcReadBitstream )     
   {
-    RNOK( pcReadBitstreamFile->uninit() );  
-    RNOK( pcReadBitstreamFile->destroy() );  
+    RNOK( pcReadBitstream->uninit() );  
+    RNOK( pcReadBitstream->destroy() );  
   }
 //TMM_EC }}
   return 0;
@@ -9,8 +9,7 @@ H264AVCDecoderTest::H264AVCDecoderTest() :
 //TMM_EC  m_pcReadBitstream( NULL ),
 //TMM_EC  m_pcWriteYuv( NULL ),
   m_pcParameter( NULL ),
-  m_cActivePicBufferList( ),
-  m_cUnusedPicBufferList( )
+  m_pcPicBufferPool( NULL )
 {
 }
 
@@ -28,7 +27,7 @@ ErrVal H264AVCDecoderTest::create( H264AVCDecoderTest*& rpcH264AVCDecoderTest )
 }
 
 
-ErrVal H264AVCDecoderTest::init( DecoderParameter *pcDecoderParameter, WriteYuvToFile *pcWriterYuv, ReadBitstreamFile *pcReadBitstreamFile ) //TMM_EC
+ErrVal H264AVCDecoderTest::init( DecoderParameter *pcDecoderParameter, WriteYuvToFile *pcWriterYuv, ReadBitstreamIf *pcReadBitstream ) //TMM_EC
 {
   ROT( NULL == pcDecoderParameter );
 
@@ -42,12 +41,26 @@ ErrVal H264AVCDecoderTest::init( DecoderParameter *pcDecoderParameter, WriteYuvT
   RNOKS( pcReadBitstreamFile->init( m_pcParameter->cBitstreamFile ) );  
 //*///
 	m_pcWriteYuv	=	pcWriterYuv;
-  m_pcReadBitstream = (ReadBitstreamIf*)pcReadBitstreamFile;
+  m_pcReadBitstream = pcReadBitstream;
 
   RNOK( h264::CreaterH264AVCDecoder::create( m_pcH264AVCDecoder ) );
 	m_pcH264AVCDecoder->setec( m_pcParameter->uiErrorConceal);
+  m_pcH264AVCDecoder->setPipelined( m_pcParameter->bPipelined );
+  if( m_pcParameter->bParallelViews )
+  {
+    m_pcH264AVCDecoder->setParallelViews( m_pcParameter->getNumOfViews() );
+  }
+  if( ! m_pcParameter->cTargetViewIdList.empty() )
+  {
+    m_pcH264AVCDecoder->setTargetViews( (UInt)m_pcParameter->cTargetViewIdList.size(), &m_pcParameter->cTargetViewIdList[0] );
+  }
+  if( m_pcParameter->uiTargetOpId != MSYS_UINT_MAX )
+  {
+    m_pcH264AVCDecoder->setTargetOperationPoint( m_pcParameter->uiTargetOpId );
+  }
 
 	RNOK( h264::CreaterH264AVCDecoder::create( m_pcH264AVCDecoderSuffix ) );  //JVT-S036 
+  RNOK( PicBufferPool::create( m_pcPicBufferPool ) );
   return Err::m_nOK;
 }
 
@@ -81,19 +94,10 @@ ErrVal H264AVCDecoderTest::destroy()
   }
 */
 
-//  AOF( m_cActivePicBufferList.empty() );
-  
-  //===== delete picture buffer =====
-  PicBufferList::iterator iter;
-  for( iter = m_cUnusedPicBufferList.begin(); iter != m_cUnusedPicBufferList.end(); iter++ )
+  //===== delete picture buffers =====
+  if( NULL != m_pcPicBufferPool )
   {
-    delete (*iter)->getBuffer();
-    delete (*iter);
-  }
-  for( iter = m_cActivePicBufferList.begin(); iter != m_cActivePicBufferList.end(); iter++ )
-  {
-    delete (*iter)->getBuffer();
-    delete (*iter);
+    RNOK( m_pcPicBufferPool->destroy() );
   }
 
   delete this;
@@ -103,46 +107,47 @@ ErrVal H264AVCDecoderTest::destroy()
 
 ErrVal H264AVCDecoderTest::xGetNewPicBuffer ( PicBuffer*& rpcPicBuffer, UInt uiSize )
 {
-  if( m_cUnusedPicBufferList.empty() )
+  //===== the buffers are allocated with the first slice, when the DPB size of the SPS is known =====
+  if( ! m_pcPicBufferPool->isInitDone() )
   {
-    rpcPicBuffer = new PicBuffer( new UChar[ uiSize ] );
+    UInt uiCapacity = max( 1, m_pcH264AVCDecoder->getMaxEtrDPB() ) * 4 + 2;
+    if( m_pcParameter->bParallelViews )
+    {
+      //----- pictures that wait for the view workers keep their buffers, and so do the pictures they reference -----
+      uiCapacity   += 2 * MAX_PENDING_VIEW_PICTURES;
+    }
+    RNOK( m_pcPicBufferPool->init( uiCapacity, uiSize, m_pcParameter->bHugePages ) );
   }
-  else
+  ROT( uiSize > m_pcPicBufferPool->getBufferSize() );
+
+  //===== every slice gets a buffer, the oldest buffers of the other slices may not have been returned yet =====
+  if( m_pcPicBufferPool->getNumAcquired() == m_pcPicBufferPool->getCapacity() )
   {
-    rpcPicBuffer = m_cUnusedPicBufferList.popFront();
+    m_pcPicBufferPool->reclaim( m_pcPicBufferPool->getCapacity() - 1 );
   }
-
-  m_cActivePicBufferList.push_back( rpcPicBuffer );
+  RNOK( m_pcPicBufferPool->acquire( rpcPicBuffer ) );
   return Err::m_nOK;
 }
 
 
 ErrVal H264AVCDecoderTest::xRemovePicBuffer( PicBufferList& rcPicBufferUnusedList )
 {
+  ROTRS( ! m_pcPicBufferPool->isInitDone(), Err::m_nOK );
+
   while( ! rcPicBufferUnusedList.empty() )
   {
     PicBuffer* pcBuffer = rcPicBufferUnusedList.popFront();
 
     if( NULL != pcBuffer )
     {
-      PicBufferList::iterator  begin = m_cActivePicBufferList.begin();
-      PicBufferList::iterator  end   = m_cActivePicBufferList.end  ();
-      PicBufferList::iterator  iter  = std::find( begin, end, pcBuffer );
-    
       AOT( pcBuffer->isUsed() )
-      m_cUnusedPicBufferList.push_back( pcBuffer );
-	  if (iter!=end)
-	      m_cActivePicBufferList.erase    (  iter );
+      RNOK( m_pcPicBufferPool->release( pcBuffer ) );
     }
   }
 
   // hwsun, fix meomory for field coding
-  for(int i = (m_cActivePicBufferList.size() - m_pcH264AVCDecoder->getMaxEtrDPB() * 4); i > 0; i--)
-  {
-    PicBuffer* pcBuffer = m_cActivePicBufferList.popFront();    
-    if( NULL != pcBuffer )
-      m_cUnusedPicBufferList.push_back( pcBuffer );
-  }
+  // (every slice gets a buffer, so with several slices per picture the oldest buffers may still be in use)
+  m_pcPicBufferPool->reclaim( m_pcH264AVCDecoder->getMaxEtrDPB() * 4 + ( m_pcParameter->bParallelViews ? 2 * MAX_PENDING_VIEW_PICTURES : 0 ) );
 
   return Err::m_nOK;
 }
@@ -247,8 +252,12 @@ ErrVal H264AVCDecoderTest::go()
       // Dong: Skip unknown NAL units
       if( bSkip )
       {
-        printf("Unknown NAL unit type: %d\n", uiNalUnitType);
+        //----- coded slice extensions are only skipped when their view is not decoded -----
+        if( uiNalUnitType != 20 && uiNalUnitType != 21 )
+          printf("Unknown NAL unit type: %d\n", uiNalUnitType);
         uiTotalLength -= (auiEndPos[uiFragNb] - auiStartPos[uiFragNb]);
+        RNOK( m_pcReadBitstream->releasePacket( pcBinDataTmp[uiFragNb] ) );
+        pcBinDataTmp[uiFragNb] = NULL;
       }
       else if(!bStart)
       {
@@ -257,7 +266,16 @@ ErrVal H264AVCDecoderTest::go()
       }
       else
       {
-        if(pcBinDataTmp[0]->size() != 0)
+        if(pcBinDataTmp[0]->size() != 0 && uiFragNb == 0)
+        {
+          //----- a NAL unit in one piece is decoded from the extracted packet, the escapes are skipped by the parser -----
+          pcBinData       = pcBinDataTmp[0];
+          pcBinDataTmp[0] = NULL;
+          cBinDataAccessor.set( pcBinData->data() + auiStartPos[0], uiTotalLength );
+          if(uiNalUnitType != 6) //JVT-T054
+          m_pcH264AVCDecoder->decreaseNumOfNALInAU();
+        }
+        else if(pcBinDataTmp[0]->size() != 0)
         {
           pcBinData = new BinData;
           pcBinData->set( new UChar[uiTotalLength], uiTotalLength );
@@ -277,6 +295,9 @@ ErrVal H264AVCDecoderTest::go()
           }
           
           pcBinData->setMemAccessor( cBinDataAccessor );
+        }
+        if(pcBinData)
+        {
           bToDecode = false;
           if((uiTotalLength != 0) && (!bDiscardable || bFragmented))
           {
@@ -445,6 +466,10 @@ ErrVal H264AVCDecoderTest::go()
     }
   }
   printf("\n %d frames decoded\n", uiFrame );
+  if( m_pcPicBufferPool->isInitDone() )
+  {
+    m_pcPicBufferPool->printStatistics( " decoder" );
+  }
 
   delete [] pcLastFrame; // HS: decoder robustness
   
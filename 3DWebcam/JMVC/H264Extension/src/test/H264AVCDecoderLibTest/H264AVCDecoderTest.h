@@ -3,7 +3,9 @@
 
 
 #include "ReadBitstreamFile.h"
+#include "ReadBitstreamStream.h"
 #include "WriteYuvToFile.h"
+#include "PicBufferPool.h"
 
 #define MAX_REFERENCE_FRAMES 15
 #define MAX_B_FRAMES         15
@@ -22,7 +24,7 @@ protected:
 
 public:
   static ErrVal create( H264AVCDecoderTest*& rpcH264AVCDecoderTest );
-  ErrVal init( DecoderParameter *pcDecoderParameter, WriteYuvToFile *pcWriteYuv, ReadBitstreamFile *pcReadBitstreamFile );//TMM_EC
+  ErrVal init( DecoderParameter *pcDecoderParameter, WriteYuvToFile *pcWriteYuv, ReadBitstreamIf *pcReadBitstream );//TMM_EC
   ErrVal go();
   ErrVal destroy();
   ErrVal setec( UInt uiErrorConceal);//TMM_EC
@@ -41,8 +43,7 @@ protected:
   WriteYuvIf*				  m_pcWriteSnapShot;   //SEI LSJ
   DecoderParameter*           m_pcParameter;
 	
-  PicBufferList               m_cActivePicBufferList;
-  PicBufferList               m_cUnusedPicBufferList;
+  PicBufferPool*              m_pcPicBufferPool;
 };
 
 #endif //__H264AVCDECODERTEST_H_D65BE9B4_A8DA_11D3_AFE7_005004464B79
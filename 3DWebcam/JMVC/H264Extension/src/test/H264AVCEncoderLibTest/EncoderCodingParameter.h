@@ -104,6 +104,9 @@ public:
   ErrVal        init      ( Int     argc,
                             Char**  argv,
                             std::string&               rcBitstreamFile );
+  ErrVal        initFromFile( const std::string&         rcConfigFile,
+                              UInt                       uiViewId,
+                              std::string&               rcBitstreamFile );
 
   Void          printHelp ();
   Void printHelpMVC(Int argc, Char**  argv);
@@ -126,6 +129,7 @@ protected:
   ErrVal  xReadFromFile      ( std::string&            rcFilename,
                                UInt                    uiViewId,
                                std::string&            rcBitstreamFile );
+  ErrVal  xInitPdsInitialDelays();  // JVT-W080, the delays of the parallel decoding info SEI of all views
   //original xReadFromFile, xReadFromFile2 and xReadFromFile3 are deleted
 
 
@@ -159,6 +163,23 @@ ErrVal EncoderCodingParameter::destroy()
 }
 
 
+// equivalent to "-vf rcConfigFile uiViewId" on the command line
+ErrVal EncoderCodingParameter::initFromFile( const std::string& rcConfigFile,
+                                             UInt               uiViewId,
+                                             std::string&       rcBitstreamFile )
+{
+  std::string cFilename = rcConfigFile;
+
+  rcBitstreamFile = "";
+
+  RNOKS( xReadFromFile( cFilename, uiViewId, rcBitstreamFile ) );
+  RNOKS( xInitPdsInitialDelays() ); //JVT-W080
+  RNOKS( check() );
+
+  return Err::m_nOK;
+}
+
+
 ErrVal EncoderCodingParameter::init( Int     argc,
                                      Char**  argv,
                                      std::string& rcBitstreamFile  )
@@ -475,7 +496,17 @@ ErrVal EncoderCodingParameter::init( Int     argc,
     return Err::m_nERR;
   }
 
+  RNOKS( xInitPdsInitialDelays() ); //JVT-W080
+
+  RNOKS( check() );
+  
+  return Err::m_nOK;
+}
+
+
 //JVT-W080
+ErrVal EncoderCodingParameter::xInitPdsInitialDelays()
+{
 	if( m_uiMVCmode && m_uiPdsEnable )
 	{
 		m_uiPdsBlockSize = m_uiFrameWidth/16;
@@ -500,12 +531,10 @@ ErrVal EncoderCodingParameter::init( Int     argc,
 			}
 		}
 	}
-//~JVT-W080
 
-  RNOKS( check() );
-  
   return Err::m_nOK;
 }
+//~JVT-W080
 
 
 Void EncoderCodingParameter::printHelpMVC(Int     argc,
@@ -623,6 +652,7 @@ EncoderCodingParameter::xReadFromFile  ( std::string&    rcFilename,
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("FramesToBeEncoded",       &m_uiTotalFrames,                                      1 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("GOPSize",                 &m_uiGOPSize,                                          1 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("IntraPeriod",             &m_uiIntraPeriod,                                      MSYS_UINT_MAX );
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("LowDelay",                &m_uiLowDelay,                                         0 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("NumberReferenceFrames",   &m_uiNumRefFrames,                                     1 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("BaseLayerMode",           &m_uiBaseLayerMode,                                    3 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("InterPredPicsFirst",      &m_uiInterPredPicsFirst ,                              1 ); // JVT-V043
@@ -630,6 +660,9 @@ EncoderCodingParameter::xReadFromFile  ( std::string&    rcFilename,
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("SearchRange",             &(m_cMotionVectorSearchParams.m_uiSearchRange),        96);
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("BiPredIter",              &(m_cMotionVectorSearchParams.m_uiNumMaxIter),         4 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("IterSearchRange",         &(m_cMotionVectorSearchParams.m_uiIterSearchRange),    8 );
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("DisparitySearchRows",     &(m_cMotionVectorSearchParams.m_uiDisparitySearchRows), 0 );
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("PyramidSearch",           &(m_cMotionVectorSearchParams.m_uiPyramidSearch),      0 );
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("PyramidSearchRange",      &(m_cMotionVectorSearchParams.m_uiPyramidSearchRange), 64);
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("LoopFilterDisable",       &(m_cLoopFilterParams.m_uiFilterIdc),                  0 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineInt ("LoopFilterAlphaC0Offset", (Int*)&(m_cLoopFilterParams.m_iAlphaOffset),           0 );
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineInt ("LoopFilterBetaOffset",    (Int*)&(m_cLoopFilterParams.m_iBetaOffset),            0 );
@@ -685,6 +718,20 @@ EncoderCodingParameter::xReadFromFile  ( std::string&    rcFilename,
     m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("PAff",   &m_uiPAff,                            0 );
 //~JVT-W080
   m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("DPBConformanceCheck",             &m_uiDPBConformanceCheck,                                       0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("SIMD",                            &m_uiSIMD,                                                      h264::SIMD_ALL);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("SIMDSelfCheck",                   &m_uiSIMDSelfCheck,                                             0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("WavefrontThreads",                &m_uiWavefrontThreads,                                          1);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("SliceMode",                       &m_uiSliceMode,                                                 0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("SliceArgument",                   &m_uiSliceArgument,                                            50);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("SliceThreads",                    &m_uiSliceThreads,                                              1);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("RateControl",                     &m_uiRateControl,                                               0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineDbl ("Bitrate",                         &m_dBitrate,                                                    0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineDbl ("MaxBitrate",                      &m_dMaxBitrate,                                                 0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineDbl ("VBVBufferSize",                   &m_dVBVBufferSize,                                              0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("BaseViewBitrateShare",            &m_uiBaseViewBitrateShare,                                     60);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("RateControlSliceQp",              &m_uiRateControlSliceQp,                                        0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("FastModeDecision",                &m_uiFastModeDecision,                                          0);
+  m_pEncoderLines[uiParLnCount++] = new EncoderConfigLineUInt("PicBufferHugePages",              &m_uiPicBufferHugePages,                                        0);
   m_CurrentViewId = uiViewId; 
   m_bAVCFlag      = false;
   if ( uiViewId == m_uiBaseViewId ) m_bAVCFlag = true;
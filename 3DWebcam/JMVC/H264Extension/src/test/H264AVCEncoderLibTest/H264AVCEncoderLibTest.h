@@ -4,6 +4,7 @@
 
 #include "H264AVCEncoderLib.h"
 #include "CreaterH264AVCEncoder.h"
+#include "MultiviewReferenceStore.h"
 #include "H264AVCVideoIoLib.h"
 
 
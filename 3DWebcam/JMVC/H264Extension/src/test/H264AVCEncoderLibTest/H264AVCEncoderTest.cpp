@@ -6,8 +6,14 @@
 
 H264AVCEncoderTest::H264AVCEncoderTest() :
   m_pcH264AVCEncoder        ( NULL ),
+  m_pcMultiviewReferenceStore( NULL ),
   m_pcWriteBitstreamToFile  ( NULL ),
-  m_pcEncoderCodingParameter( NULL )
+  m_pcEncoderCodingParameter( NULL ),
+  m_pfNalUnitCallback       ( NULL ),
+  m_pvNalUnitCallbackData   ( NULL ),
+  m_uiSessionFrames         ( 0 ),
+  m_uiSessionBytes          ( 0 ),
+  m_uiWrittenBytes          ( 0 )
 {
   ::memset( m_apcReadYuv,   0x00, MAX_LAYERS*sizeof(Void*) );
   ::memset( m_apcWriteYuv,  0x00, MAX_LAYERS*sizeof(Void*) );
@@ -18,6 +24,8 @@ H264AVCEncoderTest::H264AVCEncoderTest() :
   ::memset( m_auiWidth,     0x00, MAX_LAYERS*sizeof(UInt) );
   ::memset( m_auiStride,    0x00, MAX_LAYERS*sizeof(UInt) );
   ::memset( m_aauiCropping, 0x00, MAX_LAYERS*sizeof(UInt)*4);
+  ::memset( m_auiPicSize,   0x00, MAX_LAYERS*sizeof(UInt) );
+  ::memset( m_apcPicBufferPool, 0x00, MAX_LAYERS*sizeof(PicBufferPool*) );
 }
 
 
@@ -48,8 +56,60 @@ ErrVal H264AVCEncoderTest::init( Int    argc,
     m_pcEncoderCodingParameter->printHelpMVC(argc, argv);
     return -3;
   }
-  m_cEncoderIoParameter.nResult = -1;
 
+  return xInitIo();
+}
+
+
+ErrVal H264AVCEncoderTest::initView( const std::string&              rcConfigFile,
+                                     UInt                            uiViewId,
+                                     h264::MultiviewReferenceStore*  pcStore )
+{
+  ROF( pcStore );
+
+  //===== create and read encoder parameters =====
+  RNOK( EncoderCodingParameter::create( m_pcEncoderCodingParameter ) );
+  RNOKS( m_pcEncoderCodingParameter->initFromFile( rcConfigFile, uiViewId, m_cEncoderIoParameter.cBitstreamFilename ) );
+  ROF( m_pcEncoderCodingParameter->getMVCmode() );
+
+  m_pcMultiviewReferenceStore = pcStore;
+
+  return xInitIo();
+}
+
+
+ErrVal H264AVCEncoderTest::getViewCodingOrder( const std::string& rcConfigFile,
+                                               std::vector<UInt>& rcViewIdList )
+{
+  EncoderCodingParameter* pcEncoderCodingParameter = NULL;
+  std::string             cBitstreamFilename;
+
+  RNOK( EncoderCodingParameter::create( pcEncoderCodingParameter ) );
+  ErrVal nRet = pcEncoderCodingParameter->initFromFile( rcConfigFile, 0, cBitstreamFilename );
+  if( Err::m_nOK == nRet && pcEncoderCodingParameter->getMVCmode() )
+  {
+    UInt  uiNumViews  = pcEncoderCodingParameter->SpsMVC.getNumViewMinus1() + 1;
+    UInt* puiOrder    = pcEncoderCodingParameter->SpsMVC.getViewCodingOrder();
+
+    rcViewIdList.clear();
+    for( UInt ui = 0; ui < uiNumViews; ui++ )
+    {
+      rcViewIdList.push_back( puiOrder ? puiOrder[ui] : ui );
+    }
+  }
+  else if( Err::m_nOK == nRet )
+  {
+    nRet = Err::m_nERR;
+  }
+  RNOK( pcEncoderCodingParameter->destroy() );
+
+  return nRet;
+}
+
+
+ErrVal H264AVCEncoderTest::xInitIo()
+{
+  m_cEncoderIoParameter.nResult = -1;
 
   //===== init instances for reading and writing yuv data =====
   UInt uiNumberOfLayers = m_pcEncoderCodingParameter->getMVCmode() ? 1 : m_pcEncoderCodingParameter->getNumberOfLayers();
@@ -174,19 +234,11 @@ H264AVCEncoderTest::destroy()
 
   for( UInt uiLayer = 0; uiLayer < MAX_LAYERS; uiLayer++ )
   {
-    AOF( m_acActivePicBufferList[uiLayer].empty() );
-    
-    //===== delete picture buffer =====
-    PicBufferList::iterator iter;
-    for( iter = m_acUnusedPicBufferList[uiLayer].begin(); iter != m_acUnusedPicBufferList[uiLayer].end(); iter++ )
+    //===== delete picture buffers =====
+    if( m_apcPicBufferPool[uiLayer] )
     {
-      delete (*iter)->getBuffer();
-      delete (*iter);
-    }
-    for( iter = m_acActivePicBufferList[uiLayer].begin(); iter != m_acActivePicBufferList[uiLayer].end(); iter++ )
-    {
-      delete (*iter)->getBuffer();
-      delete (*iter);
+      AOF( m_apcPicBufferPool[uiLayer]->getNumAcquired() == 0 );
+      RNOK( m_apcPicBufferPool[uiLayer]->destroy() );
     }
   }
 
@@ -200,16 +252,10 @@ H264AVCEncoderTest::xGetNewPicBuffer ( PicBuffer*&  rpcPicBuffer,
                                        UInt         uiLayer,
                                        UInt         uiSize )
 {
-  if( m_acUnusedPicBufferList[uiLayer].empty() )
-  {
-    rpcPicBuffer = new PicBuffer( new UChar[ uiSize ] );
-  }
-  else
-  {
-    rpcPicBuffer = m_acUnusedPicBufferList[uiLayer].popFront();
-  }
+  ROF( m_apcPicBufferPool[uiLayer] );
+  ROT( uiSize > m_apcPicBufferPool[uiLayer]->getBufferSize() );
 
-  m_acActivePicBufferList[uiLayer].push_back( rpcPicBuffer );
+  RNOK( m_apcPicBufferPool[uiLayer]->acquire( rpcPicBuffer ) );
 
   return Err::m_nOK;
 }
@@ -225,15 +271,8 @@ H264AVCEncoderTest::xRemovePicBuffer( PicBufferList&  rcPicBufferUnusedList,
 
     if( NULL != pcBuffer )
     {
-      PicBufferList::iterator begin = m_acActivePicBufferList[uiLayer].begin();
-      PicBufferList::iterator end   = m_acActivePicBufferList[uiLayer].end  ();
-      PicBufferList::iterator iter  = std::find( begin, end, pcBuffer );
-
-      ROT( iter == end ); // there is something wrong if the address is not in the active list
-
-      AOT_DBG( (*iter)->isUsed() );
-      m_acUnusedPicBufferList[uiLayer].push_back( *iter );
-      m_acActivePicBufferList[uiLayer].erase    (  iter );
+      AOT_DBG( pcBuffer->isUsed() );
+      RNOK( m_apcPicBufferPool[uiLayer]->release( pcBuffer ) );
     }
   }
   return Err::m_nOK;
@@ -248,6 +287,10 @@ H264AVCEncoderTest::xWrite( PicBufferList&  rcPicBufferList,
   {
     PicBuffer* pcBuffer = rcPicBufferList.popFront();
 
+    if( ! m_apcWriteYuv[uiLayer] )
+    {
+      continue;
+    }
     Pel* pcBuf = pcBuffer->getBuffer();
     RNOK( m_apcWriteYuv[uiLayer]->writeFrame( pcBuf + m_auiLumOffset[uiLayer], 
                                               pcBuf + m_auiCbOffset [uiLayer],
@@ -269,17 +312,33 @@ H264AVCEncoderTest::xRelease( PicBufferList&  rcPicBufferList,
 }
 
 
+ErrVal
+H264AVCEncoderTest::xWritePacket( ExtBinDataAccessor* pcExtBinDataAccessor,
+                                  UInt&               ruiBytes )
+{
+  if( m_pfNalUnitCallback )
+  {
+    m_pfNalUnitCallback( m_pvNalUnitCallbackData, pcExtBinDataAccessor->data(), pcExtBinDataAccessor->size() );
+  }
+  else
+  {
+    BinDataAccessor cStartCode;
+    m_cBinDataStartCode.setMemAccessor( cStartCode );
+    RNOK( m_pcWriteBitstreamToFile->writeNalUnit( &cStartCode, pcExtBinDataAccessor ) );
+  }
+  ruiBytes += pcExtBinDataAccessor->size() + 4;
+  return Err::m_nOK;
+}
+
+
 ErrVal
 H264AVCEncoderTest::xWrite( ExtBinDataAccessorList& rcList,
                             UInt&                   ruiBytesInFrame )
 {
   while( rcList.size() )
   {
-    ruiBytesInFrame += rcList.front()->size() + 4;
-    RNOK( m_pcWriteBitstreamToFile->writePacket( &m_cBinDataStartCode ) );
-    RNOK( m_pcWriteBitstreamToFile->writePacket( rcList.front() ) );
-    delete[] rcList.front()->data();
-    delete   rcList.front();
+    RNOK( xWritePacket( rcList.front(), ruiBytesInFrame ) );
+    RNOK( m_pcH264AVCEncoder->releaseNalUnit( rcList.front() ) );
     rcList.pop_front();
   }
   return Err::m_nOK;
@@ -291,8 +350,7 @@ H264AVCEncoderTest::xRelease( ExtBinDataAccessorList& rcList )
 {
   while( rcList.size() )
   {
-    delete[] rcList.front()->data();
-    delete   rcList.front();
+    RNOK( m_pcH264AVCEncoder->releaseNalUnit( rcList.front() ) );
     rcList.pop_front();
   }
   return Err::m_nOK;
@@ -300,27 +358,9 @@ H264AVCEncoderTest::xRelease( ExtBinDataAccessorList& rcList )
 
 
 ErrVal
-H264AVCEncoderTest::go()
+H264AVCEncoderTest::xWriteHeader( UInt& ruiWrittenBytes )
 {
-  UInt                    uiWrittenBytes          = 0;
-  const UInt              uiMaxFrame              = m_pcEncoderCodingParameter->getTotalFrames();
-  UInt                    uiNumLayers             = ( m_pcEncoderCodingParameter->getMVCmode() ? 1 : m_pcEncoderCodingParameter->getNumberOfLayers() );
-  UInt                    uiFrame;
-  UInt                    uiLayer;
-  UInt                    auiMbX                  [MAX_LAYERS];
-  UInt                    auiMbY                  [MAX_LAYERS];
-  UInt                    auiPicSize              [MAX_LAYERS];
-  PicBuffer*              apcOriginalPicBuffer    [MAX_LAYERS];//original pic
-  PicBuffer*              apcReconstructPicBuffer [MAX_LAYERS];//rec pic
-  PicBufferList           acPicBufferOutputList   [MAX_LAYERS];
-  PicBufferList           acPicBufferUnusedList   [MAX_LAYERS];
-  ExtBinDataAccessorList  cOutExtBinDataAccessorList;
-  Bool                    bMoreSets;
-
-  
-  //===== initialization =====
-  RNOK( m_pcH264AVCEncoder->init( m_pcEncoderCodingParameter ) ); 
-
+  Bool  bMoreSets;
 
   //===== write parameter sets =====
   for( bMoreSets = true; bMoreSets;  )
@@ -336,10 +376,7 @@ H264AVCEncoderTest::go()
     RNOK( m_pcH264AVCEncoder      ->writeParameterSets( &cExtBinDataAccessor, bMoreSets) );
 		if( m_pcH264AVCEncoder->getScalableSeiMessage() )
 		{		
-    RNOK( m_pcWriteBitstreamToFile->writePacket       ( &m_cBinDataStartCode ) );
-    RNOK( m_pcWriteBitstreamToFile->writePacket       ( &cExtBinDataAccessor ) );
-    
-    uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+    RNOK( xWritePacket( &cExtBinDataAccessor, ruiWrittenBytes ) );
 		}
     cBinData.reset();
   }
@@ -356,7 +393,7 @@ H264AVCEncoderTest::go()
     ExtBinDataAccessor cExtBinDataAccessor;
     cBinData.setMemAccessor( cExtBinDataAccessor );
 
-		const UInt uiSPSId = 0; //currently only one SPS with SPSId = 0
+		const UInt uiSPSId = 1; //the subset SPS that carries the view dependencies
 		UInt uiNumView       = m_pcEncoderCodingParameter->SpsMVC.getNumViewMinus1()+1;
 		UInt* num_refs_list0_anc = new UInt [uiNumView];
 		UInt* num_refs_list1_anc = new UInt [uiNumView];
@@ -407,9 +444,7 @@ H264AVCEncoderTest::go()
 		num_refs_list1_nonanc = NULL;
 	  if( m_pcEncoderCodingParameter->getCurentViewId() == m_pcEncoderCodingParameter->SpsMVC.m_uiViewCodingOrder[0] )
 		{
-			RNOK( m_pcWriteBitstreamToFile->writePacket       ( &m_cBinDataStartCode ) );
-			RNOK( m_pcWriteBitstreamToFile->writePacket       ( &cExtBinDataAccessor ) );
-			uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+			RNOK( xWritePacket( &cExtBinDataAccessor, ruiWrittenBytes ) );
 		}
 
 		cBinData.reset();
@@ -426,9 +461,7 @@ H264AVCEncoderTest::go()
       ExtBinDataAccessor cExtBinDataAccessor;
       cBinData.setMemAccessor( cExtBinDataAccessor );
 	  RNOK( m_pcH264AVCEncoder ->writeMultiviewSceneInfoSEIMessage( &cExtBinDataAccessor ) );
-	  RNOK( m_pcWriteBitstreamToFile->writePacket( &m_cBinDataStartCode ) );
-	  RNOK( m_pcWriteBitstreamToFile->writePacket( &cExtBinDataAccessor ) );
-	  uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+	  RNOK( xWritePacket( &cExtBinDataAccessor, ruiWrittenBytes ) );
 	  cBinData.reset();
   }
   if( m_pcEncoderCodingParameter->getMultiviewAcquisitionInfoSEIEnable() ) // SEI JVT-W060
@@ -441,9 +474,7 @@ H264AVCEncoderTest::go()
       ExtBinDataAccessor cExtBinDataAccessor;
       cBinData.setMemAccessor( cExtBinDataAccessor );
 	  RNOK( m_pcH264AVCEncoder ->writeMultiviewAcquisitionInfoSEIMessage( &cExtBinDataAccessor ) );
-	  RNOK( m_pcWriteBitstreamToFile->writePacket( &m_cBinDataStartCode ) );
-	  RNOK( m_pcWriteBitstreamToFile->writePacket( &cExtBinDataAccessor ) );
-	  uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+	  RNOK( xWritePacket( &cExtBinDataAccessor, ruiWrittenBytes ) );
 	  cBinData.reset();
   }
   if( m_pcEncoderCodingParameter->getNestingSEIEnable() && m_pcEncoderCodingParameter->getSnapshotEnable() 
@@ -457,15 +488,23 @@ H264AVCEncoderTest::go()
       ExtBinDataAccessor cExtBinDataAccessor;
       cBinData.setMemAccessor( cExtBinDataAccessor );
 	  RNOK( m_pcH264AVCEncoder ->writeNestingSEIMessage( &cExtBinDataAccessor ) );
-	  RNOK( m_pcWriteBitstreamToFile->writePacket( &m_cBinDataStartCode ) );
-	  RNOK( m_pcWriteBitstreamToFile->writePacket( &cExtBinDataAccessor ) );
-	  uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+	  RNOK( xWritePacket( &cExtBinDataAccessor, ruiWrittenBytes ) );
 	  cBinData.reset();
   }
 //SEI }
 
-  //===== determine parameters for required frame buffers =====
-  for( uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCEncoderTest::xInitPicBufferLayout()
+{
+  UInt  uiNumLayers = ( m_pcEncoderCodingParameter->getMVCmode() ? 1 : m_pcEncoderCodingParameter->getNumberOfLayers() );
+  UInt  auiMbX      [MAX_LAYERS];
+  UInt  auiMbY      [MAX_LAYERS];
+
+  for( UInt uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
   {
     //auiMbX        [uiLayer] = m_pcEncoderCodingParameter->getLayerParameters( uiLayer ).getFrameWidth () >> 4;
     //auiMbY        [uiLayer] = m_pcEncoderCodingParameter->getLayerParameters( uiLayer ).getFrameHeight() >> 4;
@@ -475,65 +514,151 @@ H264AVCEncoderTest::go()
     m_aauiCropping[uiLayer][1]     = m_pcEncoderCodingParameter->getLayerParameters( uiLayer ).getHorPadding      ();
     m_aauiCropping[uiLayer][2]     = 0;
     m_aauiCropping[uiLayer][3]     = m_pcEncoderCodingParameter->getLayerParameters( uiLayer ).getVerPadding      ();
-    m_apcWriteYuv[uiLayer]->setCrop(m_aauiCropping[uiLayer]);
+    if( m_apcWriteYuv[uiLayer] )
+    {
+      m_apcWriteYuv[uiLayer]->setCrop(m_aauiCropping[uiLayer]);
+    }
 
     UInt  uiSize            = ((auiMbY[uiLayer]<<4)+2*YUV_Y_MARGIN)*((auiMbX[uiLayer]<<4)+2*YUV_X_MARGIN);
-    auiPicSize    [uiLayer] = ((auiMbX[uiLayer]<<4)+2*YUV_X_MARGIN)*((auiMbY[uiLayer]<<4)+2*YUV_Y_MARGIN)*3/2;
+    m_auiPicSize  [uiLayer] = ((auiMbX[uiLayer]<<4)+2*YUV_X_MARGIN)*((auiMbY[uiLayer]<<4)+2*YUV_Y_MARGIN)*3/2;
     m_auiLumOffset[uiLayer] = ((auiMbX[uiLayer]<<4)+2*YUV_X_MARGIN)* YUV_Y_MARGIN   + YUV_X_MARGIN;  
     m_auiCbOffset [uiLayer] = ((auiMbX[uiLayer]<<3)+  YUV_X_MARGIN)* YUV_Y_MARGIN/2 + YUV_X_MARGIN/2 + uiSize; 
     m_auiCrOffset [uiLayer] = ((auiMbX[uiLayer]<<3)+  YUV_X_MARGIN)* YUV_Y_MARGIN/2 + YUV_X_MARGIN/2 + 5*uiSize/4;
     m_auiHeight   [uiLayer] =   auiMbY[uiLayer]<<4;
     m_auiWidth    [uiLayer] =   auiMbX[uiLayer]<<4;
     m_auiStride   [uiLayer] =  (auiMbX[uiLayer]<<4)+ 2*YUV_X_MARGIN;
+
+    //===== picture buffers: the originals held by the decoded picture buffer of the encoder, =====
+    //===== and original and reconstruction of every picture of a GOP and of its key picture  =====
+    UInt  uiNumPicBuffers   = m_pcH264AVCEncoder->getMaxFramesInDPB() + 2 * ( m_pcEncoderCodingParameter->getGOPSize() + 1 );
+    if( NULL == m_apcPicBufferPool[uiLayer] )
+    {
+      RNOK( PicBufferPool::create( m_apcPicBufferPool[uiLayer] ) );
+    }
+    if( m_apcPicBufferPool[uiLayer]->isInitDone() )
+    {
+      RNOK( m_apcPicBufferPool[uiLayer]->uninit() );
+    }
+    RNOK( m_apcPicBufferPool[uiLayer]->init( uiNumPicBuffers, m_auiPicSize[uiLayer],
+                                             m_pcEncoderCodingParameter->getPicBufferHugePages() != 0 ) );
   }
 
-  //===== loop over frames =====
-  for( uiFrame = 0; uiFrame < uiMaxFrame; uiFrame++ )
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCEncoderTest::go()
+{
+  RNOK( goStart() );
+
+  for( UInt uiFrame = 0; uiFrame < getNumFrames(); uiFrame++ )
   {
-    //===== get picture buffers and read original pictures =====
-    for( uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
+    RNOK( goFrame( uiFrame ) );
+  }
+
+  return goFinish();
+}
+
+
+ErrVal
+H264AVCEncoderTest::goStart()
+{
+  m_uiWrittenBytes = 0;
+
+  //===== initialization =====
+  RNOK( m_pcH264AVCEncoder->init( m_pcEncoderCodingParameter, m_pcMultiviewReferenceStore ) ); 
+
+
+  //===== write parameter sets and SEI messages =====
+  RNOK( xWriteHeader( m_uiWrittenBytes ) );
+
+  //===== determine parameters for required frame buffers =====
+  RNOK( xInitPicBufferLayout() );
+
+  return Err::m_nOK;
+}
+
+
+UInt
+H264AVCEncoderTest::getNumFrames() const
+{
+  return m_pcEncoderCodingParameter->getTotalFrames();
+}
+
+
+ErrVal
+H264AVCEncoderTest::goFrame( UInt uiFrame )
+{
+  UInt                    uiNumLayers             = ( m_pcEncoderCodingParameter->getMVCmode() ? 1 : m_pcEncoderCodingParameter->getNumberOfLayers() );
+  UInt                    uiLayer;
+  PicBuffer*              apcOriginalPicBuffer    [MAX_LAYERS];//original pic
+  PicBuffer*              apcReconstructPicBuffer [MAX_LAYERS];//rec pic
+  PicBufferList           acPicBufferOutputList   [MAX_LAYERS];
+  PicBufferList           acPicBufferUnusedList   [MAX_LAYERS];
+  ExtBinDataAccessorList  cOutExtBinDataAccessorList;
+
+  //===== the views of a multiview encoding may have different numbers of frames =====
+  ROTRS( uiFrame >= getNumFrames(), Err::m_nOK );
+
+  //===== get picture buffers and read original pictures =====
+  for( uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
+  {
+    UInt  uiSkip = ( 1 << m_pcEncoderCodingParameter->getLayerParameters( uiLayer ).getTemporalResolution() );
+
+    if( uiFrame % uiSkip == 0 )
     {
-      UInt  uiSkip = ( 1 << m_pcEncoderCodingParameter->getLayerParameters( uiLayer ).getTemporalResolution() );
-
-      if( uiFrame % uiSkip == 0 )
-      {
-        RNOK( xGetNewPicBuffer( apcReconstructPicBuffer [uiLayer], uiLayer, auiPicSize[uiLayer] ) );
-        RNOK( xGetNewPicBuffer( apcOriginalPicBuffer    [uiLayer], uiLayer, auiPicSize[uiLayer] ) );
-
-        RNOK( m_apcReadYuv[uiLayer]->readFrame( *apcOriginalPicBuffer[uiLayer] + m_auiLumOffset[uiLayer],
-                                                *apcOriginalPicBuffer[uiLayer] + m_auiCbOffset [uiLayer],
-                                                *apcOriginalPicBuffer[uiLayer] + m_auiCrOffset [uiLayer],
-                                                m_auiHeight [uiLayer],
-                                                m_auiWidth  [uiLayer],
-                                                m_auiStride [uiLayer] ) );
-      }
-      else
-      {
-        apcReconstructPicBuffer [uiLayer] = 0;
-        apcOriginalPicBuffer    [uiLayer] = 0;
-      }
+      RNOK( xGetNewPicBuffer( apcReconstructPicBuffer [uiLayer], uiLayer, m_auiPicSize[uiLayer] ) );
+      RNOK( xGetNewPicBuffer( apcOriginalPicBuffer    [uiLayer], uiLayer, m_auiPicSize[uiLayer] ) );
+
+      RNOK( m_apcReadYuv[uiLayer]->readFrame( *apcOriginalPicBuffer[uiLayer] + m_auiLumOffset[uiLayer],
+                                              *apcOriginalPicBuffer[uiLayer] + m_auiCbOffset [uiLayer],
+                                              *apcOriginalPicBuffer[uiLayer] + m_auiCrOffset [uiLayer],
+                                              m_auiHeight [uiLayer],
+                                              m_auiWidth  [uiLayer],
+                                              m_auiStride [uiLayer] ) );
     }
-
-    //===== call encoder =====
-    RNOK( m_pcH264AVCEncoder->process( cOutExtBinDataAccessorList,
-                                       apcOriginalPicBuffer,
-                                       apcReconstructPicBuffer,
-                                       acPicBufferOutputList,
-                                       acPicBufferUnusedList ) );
-
-    //===== write and release NAL unit buffers =====
-    UInt  uiBytesUsed = 0;
-    RNOK( xWrite  ( cOutExtBinDataAccessorList, uiBytesUsed ) );
-    uiWrittenBytes   += uiBytesUsed;
-    
-    //===== write and release reconstructed pictures =====
-    for( uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
+    else
     {
-      RNOK( xWrite  ( acPicBufferOutputList[uiLayer], uiLayer ) );
-      RNOK( xRelease( acPicBufferUnusedList[uiLayer], uiLayer ) );
+      apcReconstructPicBuffer [uiLayer] = 0;
+      apcOriginalPicBuffer    [uiLayer] = 0;
     }
   }
 
+  //===== call encoder =====
+  RNOK( m_pcH264AVCEncoder->process( cOutExtBinDataAccessorList,
+                                     apcOriginalPicBuffer,
+                                     apcReconstructPicBuffer,
+                                     acPicBufferOutputList,
+                                     acPicBufferUnusedList ) );
+
+  //===== write and release NAL unit buffers =====
+  UInt  uiBytesUsed = 0;
+  RNOK( xWrite  ( cOutExtBinDataAccessorList, uiBytesUsed ) );
+  m_uiWrittenBytes += uiBytesUsed;
+  
+  //===== write and release reconstructed pictures =====
+  for( uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
+  {
+    RNOK( xWrite  ( acPicBufferOutputList[uiLayer], uiLayer ) );
+    RNOK( xRelease( acPicBufferUnusedList[uiLayer], uiLayer ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCEncoderTest::goFinish()
+{
+  const UInt              uiMaxFrame              = getNumFrames();
+  UInt                    uiNumLayers             = ( m_pcEncoderCodingParameter->getMVCmode() ? 1 : m_pcEncoderCodingParameter->getNumberOfLayers() );
+  UInt                    uiLayer;
+  PicBufferList           acPicBufferOutputList   [MAX_LAYERS];
+  PicBufferList           acPicBufferUnusedList   [MAX_LAYERS];
+  ExtBinDataAccessorList  cOutExtBinDataAccessorList;
+  Bool                    bMoreSets;
+
   //===== finish encoding =====
   UInt  uiNumCodedFrames = 0;
   Double  dHighestLayerOutputRate = 0.0;
@@ -545,18 +670,20 @@ H264AVCEncoderTest::go()
 
 
   //===== write and release NAL unit buffers =====
-  RNOK( xWrite  ( cOutExtBinDataAccessorList, uiWrittenBytes ) );
+  RNOK( xWrite  ( cOutExtBinDataAccessorList, m_uiWrittenBytes ) );
 
   //===== write and release reconstructed pictures =====
   for( uiLayer = 0; uiLayer < uiNumLayers; uiLayer++ )
   {
     RNOK( xWrite  ( acPicBufferOutputList[uiLayer], uiLayer ) );
     RNOK( xRelease( acPicBufferUnusedList[uiLayer], uiLayer ) );
+    m_apcPicBufferPool[uiLayer]->printStatistics( "   " );
   }
+  printf( "\n" );
 
 
   //===== set parameters and output summary =====
-  m_cEncoderIoParameter.nFrames = uiFrame;
+  m_cEncoderIoParameter.nFrames = uiMaxFrame;
   m_cEncoderIoParameter.nResult = 0;
 
   if( ! m_pcEncoderCodingParameter->getMVCmode() )
@@ -572,7 +699,7 @@ H264AVCEncoderTest::go()
 		RNOK( m_pcH264AVCEncoder      ->writeParameterSets( &cExtBinDataAccessor, bMoreSets) );
 		RNOK( m_pcWriteBitstreamToFile->writePacket       ( &m_cBinDataStartCode ) );
 		RNOK( m_pcWriteBitstreamToFile->writePacket       ( &cExtBinDataAccessor ) );
-		uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+		m_uiWrittenBytes += 4 + cExtBinDataAccessor.size();
 		cBinData.reset();
 	}
 //SEI {
@@ -589,7 +716,7 @@ H264AVCEncoderTest::go()
      RNOK( m_pcH264AVCEncoder->writeViewScalInfoSEIMessage( &cExtBinDataAccessor ) );
      RNOK( m_pcWriteBitstreamToFile->writePacket       ( &m_cBinDataStartCode ) );
      RNOK( m_pcWriteBitstreamToFile->writePacket       ( &cExtBinDataAccessor ) );
-     uiWrittenBytes += 4 + cExtBinDataAccessor.size();
+     m_uiWrittenBytes += 4 + cExtBinDataAccessor.size();
      cBinData.reset();
 
   }
@@ -707,3 +834,177 @@ H264AVCEncoderTest::ViewScalableDealing()
 }
 
 //SEI }
+
+
+ErrVal
+H264AVCEncoderTest::initSession( const std::string& rcConfigFile,
+                                 UInt               uiViewId,
+                                 NalUnitCallback    pfNalUnitCallback,
+                                 Void*              pvUserData,
+                                 h264::MultiviewReferenceStore* pcStore )
+{
+  ROF( pfNalUnitCallback );
+
+  //===== create and read encoder parameters =====
+  RNOK( EncoderCodingParameter::create( m_pcEncoderCodingParameter ) );
+  RNOKS( m_pcEncoderCodingParameter->initFromFile( rcConfigFile, uiViewId, m_cEncoderIoParameter.cBitstreamFilename ) );
+  ROF( m_pcEncoderCodingParameter->getMVCmode() );
+  m_cEncoderIoParameter.nResult = -1;
+
+  //===== a session runs until finishSession(), FramesToBeEncoded of the configuration does not apply =====
+  m_pcEncoderCodingParameter->setTotalFrames( MSYS_UINT_MAX );
+
+  m_pfNalUnitCallback     = pfNalUnitCallback;
+  m_pvNalUnitCallbackData = pvUserData;
+  m_uiSessionFrames       = 0;
+  m_uiSessionBytes        = 0;
+
+  //===== without a reference store the reconstruction is the inter-view reference of the other views =====
+  m_pcMultiviewReferenceStore = pcStore;
+  if( ! m_pcMultiviewReferenceStore )
+  {
+    RNOKS( WriteYuvToFile::create( m_apcWriteYuv[0], m_pcEncoderCodingParameter->getLayerParameters( 0 ).getOutputFilename() ) );
+  }
+
+  //===== create and initialize encoder instance =====
+  RNOK( h264::CreaterH264AVCEncoder::create( m_pcH264AVCEncoder ) );
+  m_pcEncoderCodingParameter->setExtendedPriorityId( true );
+  RNOK( m_pcH264AVCEncoder->init( m_pcEncoderCodingParameter, m_pcMultiviewReferenceStore ) );
+
+  RNOK( xWriteHeader( m_uiSessionBytes ) );
+  RNOK( xInitPicBufferLayout() );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCEncoderTest::encodeFrame( const UChar* pucLum,
+                                 const UChar* pucCb,
+                                 const UChar* pucCr,
+                                 UInt         uiLumStride,
+                                 UInt         uiChromaStride )
+{
+  ROF( m_pfNalUnitCallback );
+  ROTRS( m_uiSessionFrames >= m_pcEncoderCodingParameter->getTotalFrames(), Err::m_nERR );
+
+  PicBuffer*              apcOriginalPicBuffer    [MAX_LAYERS];
+  PicBuffer*              apcReconstructPicBuffer [MAX_LAYERS];
+  PicBufferList           acPicBufferOutputList   [MAX_LAYERS];
+  PicBufferList           acPicBufferUnusedList   [MAX_LAYERS];
+  ExtBinDataAccessorList  cOutExtBinDataAccessorList;
+
+  //===== the encoder does not use a separate reconstruction buffer =====
+  ::memset( apcOriginalPicBuffer,    0x00, MAX_LAYERS*sizeof(PicBuffer*) );
+  ::memset( apcReconstructPicBuffer, 0x00, MAX_LAYERS*sizeof(PicBuffer*) );
+
+  RNOK( xGetNewPicBuffer( apcOriginalPicBuffer[0], 0, m_auiPicSize[0] ) );
+  RNOK( xCopyFrame      ( apcOriginalPicBuffer[0], pucLum, pucCb, pucCr, uiLumStride, uiChromaStride ) );
+
+  RNOK( m_pcH264AVCEncoder->process( cOutExtBinDataAccessorList,
+                                     apcOriginalPicBuffer,
+                                     apcReconstructPicBuffer,
+                                     acPicBufferOutputList,
+                                     acPicBufferUnusedList ) );
+  m_uiSessionFrames++;
+
+  //===== pass the NAL units of all completed access units, write and release pictures =====
+  RNOK( xWrite  ( cOutExtBinDataAccessorList, m_uiSessionBytes ) );
+  RNOK( xWrite  ( acPicBufferOutputList[0], 0 ) );
+  RNOK( xRelease( acPicBufferUnusedList[0], 0 ) );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCEncoderTest::finishSession()
+{
+  ROF( m_pfNalUnitCallback );
+
+  PicBufferList           acPicBufferOutputList   [MAX_LAYERS];
+  PicBufferList           acPicBufferUnusedList   [MAX_LAYERS];
+  ExtBinDataAccessorList  cOutExtBinDataAccessorList;
+  UInt                    uiNumCodedFrames        = 0;
+  Double                  dHighestLayerOutputRate = 0.0;
+
+  //===== the last GOP is shortened to the pictures that were actually received =====
+  RNOK( m_pcH264AVCEncoder->flush ( cOutExtBinDataAccessorList,
+                                    acPicBufferOutputList,
+                                    acPicBufferUnusedList,
+                                    m_uiSessionFrames ) );
+  RNOK( m_pcH264AVCEncoder->finish( cOutExtBinDataAccessorList,
+                                    acPicBufferOutputList,
+                                    acPicBufferUnusedList,
+                                    uiNumCodedFrames,
+                                    dHighestLayerOutputRate ) );
+
+  RNOK( xWrite  ( cOutExtBinDataAccessorList, m_uiSessionBytes ) );
+  RNOK( xWrite  ( acPicBufferOutputList[0], 0 ) );
+  RNOK( xRelease( acPicBufferUnusedList[0], 0 ) );
+
+  m_cEncoderIoParameter.nFrames = m_uiSessionFrames;
+  m_cEncoderIoParameter.nResult = 0;
+
+  return Err::m_nOK;
+}
+
+
+UInt
+H264AVCEncoderTest::getSourceWidth() const
+{
+  return m_pcEncoderCodingParameter->getLayerParameters( 0 ).getFrameWidth();
+}
+
+
+UInt
+H264AVCEncoderTest::getSourceHeight() const
+{
+  return m_pcEncoderCodingParameter->getLayerParameters( 0 ).getFrameHeight();
+}
+
+
+ErrVal
+H264AVCEncoderTest::xCopyFrame( PicBuffer*   pcPicBuffer,
+                                const UChar* pucLum,
+                                const UChar* pucCb,
+                                const UChar* pucCr,
+                                UInt         uiLumStride,
+                                UInt         uiChromaStride )
+{
+  const UChar*  apucSrc     [3] = { pucLum, pucCb, pucCr };
+  UInt          auiOffset   [3] = { m_auiLumOffset[0], m_auiCbOffset[0], m_auiCrOffset[0] };
+  UInt          auiSrcStride[3] = { uiLumStride, uiChromaStride, uiChromaStride };
+
+  ROF( pucLum && pucCb && pucCr );
+
+  //===== same layout as ReadYuvFile::readFrame, padding is cleared =====
+  for( UInt uiComp = 0; uiComp < 3; uiComp++ )
+  {
+    UInt          uiShift     = ( uiComp ? 1 : 0 );
+    UInt          uiPicWidth  = getSourceWidth () >> uiShift;
+    UInt          uiPicHeight = getSourceHeight() >> uiShift;
+    UInt          uiBufWidth  = m_auiWidth [0]   >> uiShift;
+    UInt          uiBufHeight = m_auiHeight[0]   >> uiShift;
+    UInt          uiBufStride = m_auiStride[0]   >> uiShift;
+    const UChar*  pucSrc      = apucSrc[uiComp];
+    UChar*        pucDest     = pcPicBuffer->getBuffer() + auiOffset[uiComp];
+
+    ROT( uiBufWidth < uiPicWidth || uiBufHeight < uiPicHeight );
+
+    for( UInt y = 0; y < uiPicHeight; y++ )
+    {
+      ::memcpy( pucDest, pucSrc, uiPicWidth );
+      ::memset( pucDest + uiPicWidth, 0, uiBufWidth - uiPicWidth );
+      pucSrc  += auiSrcStride[uiComp];
+      pucDest += uiBufStride;
+    }
+    for( UInt y = uiPicHeight; y < uiBufHeight; y++ )
+    {
+      ::memset( pucDest, 0, uiBufWidth );
+      pucDest += uiBufStride;
+    }
+  }
+
+  return Err::m_nOK;
+}
@@ -3,16 +3,22 @@
 
 #include <algorithm>
 #include <list>
+#include <vector>
 
 #include "WriteBitstreamToFile.h"
 #include "ReadYuvFile.h"
 #include "WriteYuvToFile.h"
+#include "PicBufferPool.h"
 
 
 
 class EncoderCodingParameter;
 
 
+// receives one NAL unit (without start code) of a live encoding session
+typedef Void (*NalUnitCallback)( Void* pvUserData, const UChar* pucData, UInt uiSize );
+
+
 
 typedef struct
 {
@@ -36,18 +42,61 @@ public:
   
   ErrVal init     ( Int     argc,
                     Char**  argv );
+  // one view of a single-process multiview encoding, inter-view references are taken from pcStore
+  ErrVal initView ( const std::string&            rcConfigFile,
+                    UInt                          uiViewId,
+                    h264::MultiviewReferenceStore* pcStore );
   ErrVal go       ();
   ErrVal destroy  ();
+
+  //===== the steps of go(): a multiview encoding runs the views frame by frame when a view cannot get a thread of its own =====
+  ErrVal goStart  ();
+  ErrVal goFrame  ( UInt uiFrame );
+  ErrVal goFinish ();
+  UInt   getNumFrames() const;
   ErrVal ScalableDealing ();
   ErrVal ViewScalableDealing ();//SEI LSJ
 
+  //===== live encoding: pictures are pushed by the caller, NAL units are passed to a callback =====
+  ErrVal initSession    ( const std::string&  rcConfigFile,
+                          UInt                uiViewId,
+                          NalUnitCallback     pfNalUnitCallback,
+                          Void*               pvUserData,
+                          h264::MultiviewReferenceStore* pcStore = NULL );
+  ErrVal encodeFrame    ( const UChar*        pucLum,
+                          const UChar*        pucCb,
+                          const UChar*        pucCr,
+                          UInt                uiLumStride,
+                          UInt                uiChromaStride );
+  ErrVal finishSession  ();
+
+  UInt   getSourceWidth () const;
+  UInt   getSourceHeight() const;
+  const std::string& getBitstreamFilename() const { return m_cEncoderIoParameter.cBitstreamFilename; }
+
+  // views of the configuration file in coding order (ViewOrder)
+  static ErrVal getViewCodingOrder( const std::string& rcConfigFile,
+                                    std::vector<UInt>& rcViewIdList );
+
 protected:
+  ErrVal  xInitIo         ();
+  ErrVal  xWriteHeader    ( UInt&                   ruiWrittenBytes );
+  ErrVal  xInitPicBufferLayout();
+  ErrVal  xCopyFrame      ( PicBuffer*              pcPicBuffer,
+                            const UChar*            pucLum,
+                            const UChar*            pucCb,
+                            const UChar*            pucCr,
+                            UInt                    uiLumStride,
+                            UInt                    uiChromaStride );
+
   ErrVal  xGetNewPicBuffer( PicBuffer*&             rpcPicBuffer,
                             UInt                    uiLayer,
                             UInt                    uiSize );
   ErrVal  xRemovePicBuffer( PicBufferList&          rcPicBufferUnusedList,
                             UInt                    uiLayer );
 
+  ErrVal  xWritePacket    ( ExtBinDataAccessor*     pcExtBinDataAccessor,
+                            UInt&                   ruiBytes );
   ErrVal  xWrite          ( ExtBinDataAccessorList& rcList,
                             UInt&                   ruiBytesInFrame );
   ErrVal  xRelease        ( ExtBinDataAccessorList& rcList );
@@ -61,12 +110,12 @@ protected:
   EncoderIoParameter            m_cEncoderIoParameter;
   EncoderCodingParameter*       m_pcEncoderCodingParameter;
   h264::CreaterH264AVCEncoder*  m_pcH264AVCEncoder;
+  h264::MultiviewReferenceStore* m_pcMultiviewReferenceStore;
   WriteBitstreamToFile*         m_pcWriteBitstreamToFile;
   WriteYuvIf*                   m_apcWriteYuv           [MAX_LAYERS];
   ReadYuvFile*                  m_apcReadYuv            [MAX_LAYERS];
 
-  PicBufferList                 m_acActivePicBufferList [MAX_LAYERS];
-  PicBufferList                 m_acUnusedPicBufferList [MAX_LAYERS];
+  PicBufferPool*                m_apcPicBufferPool      [MAX_LAYERS];
   UInt                          m_auiLumOffset          [MAX_LAYERS];
   UInt                          m_auiCbOffset           [MAX_LAYERS];
   UInt                          m_auiCrOffset           [MAX_LAYERS];
@@ -74,6 +123,13 @@ protected:
   UInt                          m_auiWidth              [MAX_LAYERS];
   UInt                          m_auiStride             [MAX_LAYERS];
   UInt                          m_aauiCropping          [MAX_LAYERS][4];
+  UInt                          m_auiPicSize            [MAX_LAYERS];
+
+  NalUnitCallback               m_pfNalUnitCallback;
+  Void*                         m_pvNalUnitCallbackData;
+  UInt                          m_uiSessionFrames;
+  UInt                          m_uiSessionBytes;
+  UInt                          m_uiWrittenBytes;       // bytes of the bitstream file written by go()
 
   UChar                         m_aucStartCodeBuffer[5];
   BinData                       m_cBinDataStartCode;
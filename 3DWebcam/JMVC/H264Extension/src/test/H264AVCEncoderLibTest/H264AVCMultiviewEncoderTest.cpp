@@ -0,0 +1,249 @@
+#include <cstdio>
+#include <omp.h>
+#include "H264AVCEncoderLibTest.h"
+#include "H264AVCMultiviewEncoderTest.h"
+
+
+H264AVCMultiviewEncoderTest::H264AVCMultiviewEncoderTest() :
+  m_pcMultiviewReferenceStore ( NULL ),
+  m_pfNalUnitCallback         ( NULL ),
+  m_pvNalUnitCallbackData     ( NULL )
+{
+}
+
+
+H264AVCMultiviewEncoderTest::~H264AVCMultiviewEncoderTest()
+{
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::create( H264AVCMultiviewEncoderTest*& rpcH264AVCMultiviewEncoderTest )
+{
+  rpcH264AVCMultiviewEncoderTest = new H264AVCMultiviewEncoderTest;
+
+  ROT( NULL == rpcH264AVCMultiviewEncoderTest );
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::init( const std::string& rcConfigFile )
+{
+  RNOK( xCreateViews( rcConfigFile ) );
+
+  for( UInt uiIndex = 0; uiIndex < m_cViewEncoderList.size(); uiIndex++ )
+  {
+    RNOK( m_cViewEncoderList[uiIndex]->initView( rcConfigFile, m_cViewIdList[uiIndex], m_pcMultiviewReferenceStore ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::go()
+{
+  Bool bOneThreadPerView = true;
+  RNOK( xRunViews( VIEW_GO, NULL, NULL, NULL, 0, 0, 0, &bOneThreadPerView ) );
+  ROTRS( bOneThreadPerView, Err::m_nOK );
+
+  //===== without a thread per view, the views are run frame by frame in coding order as in a session =====
+  UInt uiNumFrames = 0;
+  for( UInt uiIndex = 0; uiIndex < m_cViewEncoderList.size(); uiIndex++ )
+  {
+    uiNumFrames = max( uiNumFrames, m_cViewEncoderList[uiIndex]->getNumFrames() );
+  }
+
+  RNOK( xRunViews( VIEW_GO_START ) );
+  for( UInt uiFrame = 0; uiFrame < uiNumFrames; uiFrame++ )
+  {
+    RNOK( xRunViews( VIEW_GO_FRAME, NULL, NULL, NULL, 0, 0, uiFrame ) );
+  }
+  return xRunViews( VIEW_GO_FINISH );
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::destroy()
+{
+  //===== the encoders borrow from the store, destroy them first =====
+  for( UInt uiIndex = 0; uiIndex < m_cViewEncoderList.size(); uiIndex++ )
+  {
+    RNOK( m_cViewEncoderList[uiIndex]->destroy() );
+  }
+  m_cViewEncoderList.clear();
+
+  if( m_pcMultiviewReferenceStore )
+  {
+    RNOK( m_pcMultiviewReferenceStore->destroy() );
+  }
+
+  delete this;
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::initSession( const std::string&        rcConfigFile,
+                                          MultiviewNalUnitCallback  pfNalUnitCallback,
+                                          Void*                     pvUserData )
+{
+  ROF( pfNalUnitCallback );
+
+  m_pfNalUnitCallback     = pfNalUnitCallback;
+  m_pvNalUnitCallbackData = pvUserData;
+
+  RNOK( xCreateViews( rcConfigFile ) );
+
+  //===== the sinks are referenced by the view encoders, the list must not grow afterwards =====
+  m_cViewNalUnitSinkList.resize( m_cViewIdList.size() );
+  for( UInt uiIndex = 0; uiIndex < m_cViewEncoderList.size(); uiIndex++ )
+  {
+    m_cViewNalUnitSinkList[uiIndex].pcOwner  = this;
+    m_cViewNalUnitSinkList[uiIndex].uiViewId = m_cViewIdList[uiIndex];
+
+    RNOK( m_cViewEncoderList[uiIndex]->initSession( rcConfigFile,
+                                                    m_cViewIdList[uiIndex],
+                                                    xNalUnitCallback,
+                                                    &m_cViewNalUnitSinkList[uiIndex],
+                                                    m_pcMultiviewReferenceStore ) );
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::encodeFrames( const UChar* const*  papucLum,
+                                           const UChar* const*  papucCb,
+                                           const UChar* const*  papucCr,
+                                           UInt                 uiLumStride,
+                                           UInt                 uiChromaStride )
+{
+  ROF( m_pfNalUnitCallback );
+  ROF( papucLum && papucCb && papucCr );
+
+  return xRunViews( VIEW_ENCODE_FRAME, papucLum, papucCb, papucCr, uiLumStride, uiChromaStride );
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::finishSession()
+{
+  ROF( m_pfNalUnitCallback );
+
+  return xRunViews( VIEW_FINISH_SESSION );
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::xCreateViews( const std::string& rcConfigFile )
+{
+  ROF( m_cViewEncoderList.empty() );
+
+  RNOK( H264AVCEncoderTest::getViewCodingOrder( rcConfigFile, m_cViewIdList ) );
+  ROT ( m_cViewIdList.empty() );
+
+  RNOK( h264::MultiviewReferenceStore::create( m_pcMultiviewReferenceStore ) );
+
+  for( UInt uiIndex = 0; uiIndex < m_cViewIdList.size(); uiIndex++ )
+  {
+    H264AVCEncoderTest* pcViewEncoder = NULL;
+    RNOK( H264AVCEncoderTest::create( pcViewEncoder ) );
+    m_cViewEncoderList.push_back( pcViewEncoder );
+  }
+
+  return Err::m_nOK;
+}
+
+
+ErrVal
+H264AVCMultiviewEncoderTest::xRunViews( ViewTask            eTask,
+                                        const UChar* const* papucLum,
+                                        const UChar* const* papucCb,
+                                        const UChar* const* papucCr,
+                                        UInt                uiLumStride,
+                                        UInt                uiChromaStride,
+                                        UInt                uiFrame,
+                                        Bool*               pbOneThreadPerView )
+{
+  Int                 iNumViews = (Int)m_cViewEncoderList.size();
+  std::vector<ErrVal> cResult( iNumViews, Err::m_nOK );
+  Bool                bRun      = true;
+
+#pragma omp parallel num_threads( iNumViews )
+  {
+    //===== a whole sequence (VIEW_GO) needs a thread per view: a view waits for free buffers until the views that =====
+    //===== use its pictures have removed them, with fewer threads (thread limit, dynamic or nested team) these =====
+    //===== views would never start. The actual team size is only known inside the region. =====
+#pragma omp single
+    {
+      if( pbOneThreadPerView )
+      {
+        *pbOneThreadPerView = ( omp_get_num_threads() == iNumViews );
+        bRun                = *pbOneThreadPerView;
+      }
+    }
+
+    //===== views are picked up in coding order, a view only waits for views that were picked up before =====
+    if( bRun )
+    {
+#pragma omp for schedule( dynamic, 1 )
+      for( Int iIndex = 0; iIndex < iNumViews; iIndex++ )
+      {
+        H264AVCEncoderTest* pcViewEncoder = m_cViewEncoderList[iIndex];
+        UInt                uiViewId      = m_cViewIdList     [iIndex];
+
+        switch( eTask )
+        {
+        case VIEW_GO:
+          cResult[iIndex] = pcViewEncoder->go();
+          break;
+        case VIEW_GO_START:
+          cResult[iIndex] = pcViewEncoder->goStart();
+          break;
+        case VIEW_GO_FRAME:
+          cResult[iIndex] = pcViewEncoder->goFrame( uiFrame );
+          break;
+        case VIEW_GO_FINISH:
+          cResult[iIndex] = pcViewEncoder->goFinish();
+          break;
+        case VIEW_ENCODE_FRAME:
+          cResult[iIndex] = pcViewEncoder->encodeFrame( papucLum[uiViewId], papucCb[uiViewId], papucCr[uiViewId], uiLumStride, uiChromaStride );
+          break;
+        case VIEW_FINISH_SESSION:
+          cResult[iIndex] = pcViewEncoder->finishSession();
+          break;
+        }
+
+        //===== do not leave the dependent views waiting for pictures that never come =====
+        if( Err::m_nOK != cResult[iIndex] )
+        {
+          fprintf( stderr, "\nencoding of view %d failed\n", uiViewId );
+          m_pcMultiviewReferenceStore->abort();
+        }
+      }
+    }
+  }
+
+  for( Int iIndex = 0; iIndex < iNumViews; iIndex++ )
+  {
+    RNOK( cResult[iIndex] );
+  }
+
+  return Err::m_nOK;
+}
+
+
+Void
+H264AVCMultiviewEncoderTest::xNalUnitCallback( Void*        pvUserData,
+                                               const UChar* pucData,
+                                               UInt         uiSize )
+{
+  ViewNalUnitSink*              pcSink  = (ViewNalUnitSink*)pvUserData;
+  H264AVCMultiviewEncoderTest*  pcOwner = pcSink->pcOwner;
+
+  pcOwner->m_pfNalUnitCallback( pcOwner->m_pvNalUnitCallbackData, pcSink->uiViewId, pucData, uiSize );
+}
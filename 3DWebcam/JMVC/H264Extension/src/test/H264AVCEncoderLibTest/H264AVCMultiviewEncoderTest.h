@@ -0,0 +1,95 @@
+#ifndef __H264AVCMULTIVIEWENCODERTEST_H_5C0E7A12_9D4B_4F63_B1A8_3E62D0F9C471
+#define __H264AVCMULTIVIEWENCODERTEST_H_5C0E7A12_9D4B_4F63_B1A8_3E62D0F9C471
+
+#include <vector>
+
+#include "H264AVCEncoderTest.h"
+
+
+
+// receives one NAL unit (without start code) of view uiViewId of a live multiview encoding session,
+// called by the thread that encodes this view
+typedef Void (*MultiviewNalUnitCallback)( Void* pvUserData, UInt uiViewId, const UChar* pucData, UInt uiSize );
+
+
+
+// Encodes all views of a configuration file in one process. Every view has
+// its own H264AVCEncoderTest instance, the views are run by separate threads
+// in coding order (ViewOrder). A view only waits for the inter-view reference
+// pictures it actually uses, which are handed over by a MultiviewReferenceStore.
+// When OpenMP gives fewer threads than views, go() runs the views frame by
+// frame instead of each view through its whole sequence.
+class H264AVCMultiviewEncoderTest
+{
+private:
+  H264AVCMultiviewEncoderTest();
+  virtual ~H264AVCMultiviewEncoderTest();
+
+public:
+  static ErrVal create( H264AVCMultiviewEncoderTest*& rpcH264AVCMultiviewEncoderTest );
+
+  ErrVal init     ( const std::string&        rcConfigFile );
+  ErrVal go       ();
+  ErrVal destroy  ();
+
+  //===== live encoding: the picture arrays are indexed by view_id =====
+  ErrVal initSession    ( const std::string&        rcConfigFile,
+                          MultiviewNalUnitCallback  pfNalUnitCallback,
+                          Void*                     pvUserData );
+  ErrVal encodeFrames   ( const UChar* const*       papucLum,
+                          const UChar* const*       papucCb,
+                          const UChar* const*       papucCr,
+                          UInt                      uiLumStride,
+                          UInt                      uiChromaStride );
+  ErrVal finishSession  ();
+
+  UInt   getNumViews    ()                const { return (UInt)m_cViewIdList.size(); }
+  UInt   getViewId      ( UInt uiIndex )  const { return m_cViewIdList[uiIndex]; }
+  UInt   getSourceWidth ()                const { return m_cViewEncoderList[0]->getSourceWidth (); }
+  UInt   getSourceHeight()                const { return m_cViewEncoderList[0]->getSourceHeight(); }
+  const std::string& getBitstreamFilename( UInt uiIndex ) const { return m_cViewEncoderList[uiIndex]->getBitstreamFilename(); }
+
+protected:
+  enum ViewTask
+  {
+    VIEW_GO,              // the whole sequence, only with a thread per view
+    VIEW_GO_START,        // the steps of VIEW_GO, for one frame of every view at a time
+    VIEW_GO_FRAME,
+    VIEW_GO_FINISH,
+    VIEW_ENCODE_FRAME,
+    VIEW_FINISH_SESSION
+  };
+
+  typedef struct
+  {
+    H264AVCMultiviewEncoderTest*  pcOwner;
+    UInt                          uiViewId;
+  } ViewNalUnitSink;
+
+  ErrVal  xCreateViews    ( const std::string&        rcConfigFile );
+  ErrVal  xRunViews       ( ViewTask                  eTask,
+                            const UChar* const*       papucLum        = NULL,
+                            const UChar* const*       papucCb         = NULL,
+                            const UChar* const*       papucCr         = NULL,
+                            UInt                      uiLumStride     = 0,
+                            UInt                      uiChromaStride  = 0,
+                            UInt                      uiFrame         = 0,
+                            Bool*                     pbOneThreadPerView = NULL );
+  static Void xNalUnitCallback( Void*                 pvUserData,
+                                const UChar*          pucData,
+                                UInt                  uiSize );
+
+protected:
+  std::vector<UInt>                 m_cViewIdList;        // coding order
+  std::vector<H264AVCEncoderTest*>  m_cViewEncoderList;
+  std::vector<ViewNalUnitSink>      m_cViewNalUnitSinkList;
+  h264::MultiviewReferenceStore*    m_pcMultiviewReferenceStore;
+
+  MultiviewNalUnitCallback          m_pfNalUnitCallback;
+  Void*                             m_pvNalUnitCallbackData;
+};
+
+
+
+
+#endif //__H264AVCMULTIVIEWENCODERTEST_H_5C0E7A12_9D4B_4F63_B1A8_3E62D0F9C471
@@ -115,7 +115,7 @@ Assembler::xWriteViewScalSEIToBuffer(h264::SEI::ViewScalabilityInfoSei *pcViewSc
 	MVCScalableModifyCode cMVCScalableModifyCode;
 	MVCScalableTestCode cMVCScalableTestCode;
 	RNOK( cMVCScalableTestCode.init() );
-	RNOK( cMVCScalableModifyCode.init( (ULong*) pulStreamPacket ) );
+	RNOK( cMVCScalableModifyCode.init( (UInt32*) pulStreamPacket ) );
 	RNOK( cMVCScalableTestCode.SEICode( pcViewScalSei, &cMVCScalableTestCode ) );
 	UInt uiBits = cMVCScalableTestCode.getNumberOfWrittenBits();
 	UInt uiSize = (uiBits+7)/8;
@@ -398,14 +398,20 @@ Assembler::xAnalyse()
     {
       bKeep          =  true;
 
-      m_uiTempViewDecOrder++;
-      
-      if( m_uiTempViewDecOrder==m_uiNumViews ) 
+      //----- the slices of a picture stay together -----
+      Bool bNextSlice = false;
+      RNOK( xIsNextSliceOfPicture( uiProcessingView, bNextSlice ) );
+      if( ! bNextSlice )
       {
-        bNewAUStart          = true;
-        m_uiTempViewDecOrder = 0;
+        m_uiTempViewDecOrder++;
+
+        if( m_uiTempViewDecOrder==m_uiNumViews ) 
+        {
+          bNewAUStart          = true;
+          m_uiTempViewDecOrder = 0;
+        }
+        else bNewAUStart = false;
       }
-      else bNewAUStart = false;
     }
     else 
     {
@@ -433,6 +439,47 @@ Assembler::xAnalyse()
   return Err::m_nOK;
 }
 
+ErrVal
+Assembler::xIsNextSliceOfPicture( UInt uiView, Bool& rbNextSlice )
+{
+  rbNextSlice = false;
+
+  Int iPos;
+  RNOK( m_ppcReadBitstream[uiView]->getPosition( iPos ) );
+
+  //===== look at the next slice of the view (after its prefix NAL unit, if any) =====
+  Bool bEOS = false;
+  while( ! bEOS )
+  {
+    BinData* pcBinData = 0;
+    RNOK( m_ppcReadBitstream[uiView]->extractPacket( pcBinData, bEOS ) );
+    if( bEOS || ! pcBinData || ! pcBinData->size() )
+    {
+      RNOK( m_ppcReadBitstream[uiView]->releasePacket( pcBinData ) );
+      break;
+    }
+
+    NalUnitType eNalUnitType = NalUnitType( pcBinData->data()[0] & 0x1F );
+    if( NAL_UNIT_CODED_SLICE_PREFIX == eNalUnitType )
+    {
+      RNOK( m_ppcReadBitstream[uiView]->releasePacket( pcBinData ) );
+      continue;
+    }
+    if( NAL_UNIT_CODED_SLICE == eNalUnitType || NAL_UNIT_CODED_SLICE_IDR == eNalUnitType || NAL_UNIT_CODED_SLICE_SCALABLE == eNalUnitType || NAL_UNIT_CODED_SLICE_IDR_SCALABLE == eNalUnitType )
+    {
+      //----- first_mb_in_slice follows the NAL unit header; ue(v) of 0 is a single 1 bit -----
+      UInt uiHeaderBytes = ( NAL_UNIT_CODED_SLICE_SCALABLE == eNalUnitType || NAL_UNIT_CODED_SLICE_IDR_SCALABLE == eNalUnitType ? 4 : 1 );
+      rbNextSlice        = ( pcBinData->size() > uiHeaderBytes && ( pcBinData->data()[uiHeaderBytes] & 0x80 ) == 0 );
+    }
+    RNOK( m_ppcReadBitstream[uiView]->releasePacket( pcBinData ) );
+    break;
+  }
+
+  RNOK( m_ppcReadBitstream[uiView]->setPosition( iPos ) );
+  return Err::m_nOK;
+}
+
+
 ErrVal
 Assembler::go()
 {
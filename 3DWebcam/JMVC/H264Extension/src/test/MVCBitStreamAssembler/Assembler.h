@@ -48,6 +48,7 @@ public:
 
 protected:
   ErrVal        xAnalyse            () ;
+  ErrVal        xIsNextSliceOfPicture( UInt uiView, Bool& rbNextSlice );
   
   ErrVal        xWriteViewScalSEIToBuffer( h264::SEI::ViewScalabilityInfoSei* pcScalableSei, BinData* pcBinData ); //SEI LSJ
 protected:
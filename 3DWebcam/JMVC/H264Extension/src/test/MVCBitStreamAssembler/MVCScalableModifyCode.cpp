@@ -27,7 +27,7 @@ MVCScalableModifyCode::Destroy()
 }
 
 ErrVal
-MVCScalableModifyCode::init( ULong* pulStream )
+MVCScalableModifyCode::init( UInt32* pulStream )
 {
 	ROT( pulStream == NULL );
 	m_pulStreamPacket = pulStream;
@@ -27,7 +27,7 @@ public:
 public:
 	//static ErrVal Create( ScalableModifyCode* pcScalableModifyCode );
 	ErrVal Destroy( Void );
-	ErrVal init( ULong* pulStream );
+	ErrVal init( UInt32* pulStream );
 	ErrVal WriteUVLC( UInt uiValue );
 	ErrVal WriteFlag( Bool bFlag );
 	ErrVal WriteCode( UInt uiValue, UInt uiLength );
@@ -41,7 +41,7 @@ public:
 	ErrVal ConvertRBSPToPayload( UChar* m_pucBuffer, UChar pucStreamPacket[], UInt& uiBits, UInt uiHeaderBytes );
    
 protected:
-	ULong  xSwap( ULong ul )
+	UInt32 xSwap( UInt32 ul )
 	{
 		// heiko.schwarz@hhi.fhg.de: support for BSD systems as proposed by Steffen Kamp [kamp@ient.rwth-aachen.de]
 #ifdef MSYS_BIG_ENDIAN
@@ -59,13 +59,13 @@ protected:
 	}
 
 	BinData *m_pcBinData;
-	ULong *m_pulStreamPacket;
+	UInt32 *m_pulStreamPacket;  // 32-bit words, also where long has 64 bits
 	UInt m_uiBitCounter;
 	UInt m_uiPosCounter;
 	UInt m_uiDWordsLeft;
 	UInt m_uiBitsWritten;
 	UInt m_iValidBits;
-	ULong m_ulCurrentBits;
+	UInt32 m_ulCurrentBits;
 	UInt m_uiCoeffCost;
 };
 
@@ -120,7 +120,7 @@ Extractor::xWriteViewScalSEIToBuffer(h264::SEI::ViewScalabilityInfoSei *pcViewSc
 	MVCScalableModifyCode cMVCScalableModifyCode;
 	MVCScalableTestCode cMVCScalableTestCode;
 	RNOK( cMVCScalableTestCode.init() );
-	RNOK( cMVCScalableModifyCode.init( (ULong*) pulStreamPacket ) );
+	RNOK( cMVCScalableModifyCode.init( (UInt32*) pulStreamPacket ) );
 	RNOK( cMVCScalableTestCode.SEICode( pcViewScalSei, &cMVCScalableTestCode ) );
 	UInt uiBits = cMVCScalableTestCode.getNumberOfWrittenBits();
 	UInt uiSize = (uiBits+7)/8;
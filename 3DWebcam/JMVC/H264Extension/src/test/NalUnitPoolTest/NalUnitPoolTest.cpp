@@ -0,0 +1,130 @@
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include "H264AVCEncoderLib.h"
+#include "NalUnitPool.h"
+
+using namespace h264;
+
+
+//===== every heap allocation of the process is counted =====
+static UInt g_uiNumHeapAllocations = 0;
+
+void* operator new( size_t uiSize )
+{
+  g_uiNumHeapAllocations++;
+  void* pv = malloc( uiSize ? uiSize : 1 );
+  if( NULL == pv )
+  {
+    throw std::bad_alloc();
+  }
+  return pv;
+}
+
+void* operator new[]( size_t uiSize )
+{
+  return operator new( uiSize );
+}
+
+void operator delete( void* pv ) throw()
+{
+  free( pv );
+}
+
+void operator delete[]( void* pv ) throw()
+{
+  free( pv );
+}
+
+
+#define NUM_VIEWS       2
+#define GOP_SIZE        8
+#define MAX_SLICES      4
+#define MAX_NAL_UNITS   ( NUM_VIEWS * MAX_SLICES )
+
+
+static UInt g_uiRandom = 1;
+
+static UInt xGetRandom()
+{
+  g_uiRandom = g_uiRandom * 1103515245 + 12345;
+  return g_uiRandom >> 8;
+}
+
+
+//===== the slice sizes of a hierarchical GOP: an anchor picture, then B pictures of decreasing size =====
+static UInt xGetSliceSize( UInt uiFrame, UInt uiView )
+{
+  UInt uiTemporalLevel  = ( uiFrame % GOP_SIZE == 0 ? 0 : uiFrame % 4 == 0 ? 1 : uiFrame % 2 == 0 ? 2 : 3 );
+  UInt uiSizeLog2       = 13 - uiTemporalLevel - ( uiView ? 1 : 0 );
+
+  //===== any size of the size class, the class is the same in every GOP =====
+  return ( 1 << uiSizeLog2 ) + 1 + xGetRandom() % ( 1 << uiSizeLog2 );
+}
+
+
+int
+main( int argc, char** argv )
+{
+  UInt uiNumFrames  = ( argc > 1 ? (UInt)atoi( argv[1] ) : 200 );
+  UInt uiFailed     = 0;
+
+  printf( "NAL unit pool test: %d frames of %d views\n\n", uiNumFrames, NUM_VIEWS );
+
+  static UChar  aucPayload[1 << 14];
+  for( UInt n = 0; n < sizeof( aucPayload ); n++ )
+  {
+    aucPayload[n] = (UChar)xGetRandom();
+  }
+
+  NalUnitPool*        pcNalUnitPool = NULL;
+  ExtBinDataAccessor* aapcPending[2][MAX_NAL_UNITS];
+  UInt                auiNumPending[2] = { 0, 0 };
+  RNOKRS( NalUnitPool::create( pcNalUnitPool ), 2 );
+
+  for( UInt uiFrame = 0; uiFrame < uiNumFrames; uiFrame++ )
+  {
+    UInt uiAllocationsBefore  = g_uiNumHeapAllocations;
+    UInt uiPoolBefore         = pcNalUnitPool->getNumAllocations();
+    UInt uiCurr               = uiFrame & 1;
+
+    //===== the encoder hands out the NAL units of an access unit, one to four slices per view =====
+    auiNumPending[uiCurr] = 0;
+    for( UInt uiView = 0; uiView < NUM_VIEWS; uiView++ )
+    {
+      UInt uiNumSlices = 1 + ( uiFrame / GOP_SIZE + uiView ) % MAX_SLICES;
+      for( UInt uiSlice = 0; uiSlice < uiNumSlices; uiSlice++ )
+      {
+        BinDataAccessor cSource( aucPayload, xGetSliceSize( uiFrame, uiView ) );
+        RNOKRS( pcNalUnitPool->getNalUnit( aapcPending[uiCurr][auiNumPending[uiCurr]++], cSource ), 2 );
+      }
+    }
+
+    //===== the application writes an access unit when the next one is coded, and returns its NAL units =====
+    for( UInt n = 0; n < auiNumPending[1-uiCurr]; n++ )
+    {
+      RNOKRS( pcNalUnitPool->releaseNalUnit( aapcPending[1-uiCurr][n] ), 2 );
+    }
+    auiNumPending[1-uiCurr] = 0;
+
+    //===== the number of slices changes every GOP, after MAX_SLICES GOPs the free lists cover every access unit =====
+    UInt uiAllocations = g_uiNumHeapAllocations - uiAllocationsBefore;
+    if( uiFrame >= MAX_SLICES * GOP_SIZE && uiAllocations )
+    {
+      printf( "frame %d: %d heap allocations (%d by the pool)\n", uiFrame, uiAllocations,
+              pcNalUnitPool->getNumAllocations() - uiPoolBefore );
+      uiFailed++;
+    }
+  }
+
+  printf( "pool: %d allocations, %d reuses\n", pcNalUnitPool->getNumAllocations(), pcNalUnitPool->getNumReuses() );
+
+  for( UInt n = 0; n < auiNumPending[( uiNumFrames - 1 ) & 1]; n++ )
+  {
+    RNOKRS( pcNalUnitPool->releaseNalUnit( aapcPending[( uiNumFrames - 1 ) & 1][n] ), 2 );
+  }
+  RNOKRS( pcNalUnitPool->destroy(), 2 );
+
+  printf( "\n%s\n", uiFailed ? "NAL unit pool test FAILED" : "NAL unit pool test passed (no heap allocation in steady state)" );
+  return uiFailed ? 1 : 0;
+}
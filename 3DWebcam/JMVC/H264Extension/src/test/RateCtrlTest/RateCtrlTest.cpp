@@ -0,0 +1,213 @@
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "H264AVCEncoderLibTest.h"
+#include "H264AVCEncoderTest.h"
+#include "H264AVCMultiviewEncoderTest.h"
+
+
+#define WIDTH         176
+#define HEIGHT        144
+#define FRAME_RATE    25.0
+#define NUM_VIEWS     2
+#define DISPARITY     6
+#define BASE_SHARE    60    // BaseViewBitrateShare
+
+
+//===== the bits of one view, collected by the NAL unit callback (called by the thread of the view) =====
+typedef struct
+{
+  UInt                uiTotalBits;
+  UInt                uiPrefixBits;
+  std::vector<UInt>   cPictureBits;
+} ViewBits;
+
+
+static Void xNalUnitCallback( Void* pvUserData, UInt uiViewId, const UChar* pucData, UInt uiSize )
+{
+  ViewBits& rcView  = ( (ViewBits*)pvUserData )[uiViewId];
+  UInt      uiType  = pucData[0] & 0x1f;
+  UInt      uiBits  = 8 * ( uiSize + 4 ); // with the start code, as in the bitstream file
+
+  rcView.uiTotalBits += uiBits;
+
+  //===== one slice per picture, a prefix NAL unit belongs to the slice that follows it =====
+  if( uiType == 14 )
+  {
+    rcView.uiPrefixBits += uiBits;
+  }
+  else if( uiType == 1 || uiType == 5 || uiType == 20 )
+  {
+    rcView.cPictureBits.push_back( rcView.uiPrefixBits + uiBits );
+    rcView.uiPrefixBits = 0;
+  }
+}
+
+
+//===== a textured background panning slowly, two blocks moving over it and some noise; the second view is shifted =====
+static Void xCreatePicture( UChar* pucLum, UChar* pucCb, UChar* pucCr, UInt uiFrame, UInt uiView, UInt& ruiRandom )
+{
+  for( Int y = 0; y < HEIGHT; y++ )
+  for( Int x = 0; x < WIDTH;  x++ )
+  {
+    Int iX    = x + (Int)uiFrame + (Int)uiView * DISPARITY;
+    Int iPel  = 64 + ( ( iX * 3 + y * 2 ) & 0x7f ) + ( ( ( iX >> 3 ) ^ ( y >> 3 ) ) & 1 ) * 24;
+    Int iBlk1 = (Int)( uiFrame * 2 ) % WIDTH;
+    Int iBlk2 = (Int)( uiFrame * 3 ) % HEIGHT;
+    if( x + (Int)uiView * DISPARITY >= iBlk1 && x + (Int)uiView * DISPARITY < iBlk1 + 32 && y >= 40 && y < 72 )
+    {
+      iPel = 220 - ( ( x ^ y ) & 0x1f );
+    }
+    if( y >= iBlk2 && y < iBlk2 + 24 && x >= 100 && x < 140 )
+    {
+      iPel = 30 + ( ( x * y ) & 0x3f );
+    }
+    ruiRandom = ruiRandom * 1103515245 + 12345;
+    iPel     += (Int)( ( ruiRandom >> 16 ) % 9 ) - 4;
+    pucLum[y * WIDTH + x] = (UChar)( iPel < 0 ? 0 : iPel > 255 ? 255 : iPel );
+  }
+  for( Int y = 0; y < HEIGHT / 2; y++ )
+  for( Int x = 0; x < WIDTH  / 2; x++ )
+  {
+    pucCb[y * WIDTH / 2 + x] = (UChar)( 128 + ( ( x + (Int)uiFrame ) & 0x1f ) - 16 );
+    pucCr[y * WIDTH / 2 + x] = (UChar)( 128 - ( ( y + (Int)uiFrame ) & 0x1f ) + 16 );
+  }
+}
+
+
+static ErrVal xWriteConfig( const std::string& rcConfigFile, UInt uiRateControl, Double dBitrate, Double dMaxBitrate )
+{
+  FILE* pFile = ::fopen( rcConfigFile.c_str(), "w" );
+  ROF( pFile );
+
+  ::fprintf( pFile, "OutputFile              RateCtrlTest\n"
+                    "ReconFile               RateCtrlTest_rec\n"
+                    "SourceWidth             %d\n"
+                    "SourceHeight            %d\n"
+                    "FrameRate               %.1f\n"
+                    "SymbolMode              1\n"
+                    "FRExt                   1\n"
+                    "BasisQP                 32\n"
+                    "GOPSize                 4\n"
+                    "IntraPeriod             12\n"
+                    "NumberReferenceFrames   2\n"
+                    "InterPredPicsFirst      1\n"
+                    "DeltaLayer0Quant        0\n"
+                    "DeltaLayer1Quant        3\n"
+                    "DeltaLayer2Quant        4\n"
+                    "SearchMode              4\n"
+                    "SearchFuncFullPel       3\n"
+                    "SearchFuncSubPel        2\n"
+                    "SearchRange             32\n"
+                    "BiPredIter              4\n"
+                    "IterSearchRange         8\n"
+                    "RateControl             %d\n"
+                    "Bitrate                 %.1f\n"
+                    "MaxBitrate              %.1f\n"
+                    "BaseViewBitrateShare    %d\n"
+                    "NumViewsMinusOne        1\n"
+                    "ViewOrder               0-1\n"
+                    "View_ID                 0\n"
+                    "Fwd_NumAnchorRefs       0\n"
+                    "Bwd_NumAnchorRefs       0\n"
+                    "Fwd_NumNonAnchorRefs    0\n"
+                    "Bwd_NumNonAnchorRefs    0\n"
+                    "View_ID                 1\n"
+                    "Fwd_NumAnchorRefs       1\n"
+                    "Bwd_NumAnchorRefs       0\n"
+                    "Fwd_NumNonAnchorRefs    1\n"
+                    "Bwd_NumNonAnchorRefs    0\n"
+                    "Fwd_AnchorRefs          0 0\n"
+                    "Fwd_NonAnchorRefs       0 0\n",
+                    WIDTH, HEIGHT, FRAME_RATE, uiRateControl, dBitrate, dMaxBitrate, BASE_SHARE );
+  ::fclose( pFile );
+  return Err::m_nOK;
+}
+
+
+//===== encodes uiNumFrames synthetic pictures of both views, returns 1 when a view misses its bit rate or its VBV size =====
+static ErrVal xTestRate( UInt uiRateControl, Double dBitrate, Double dMaxBitrate, UInt uiNumFrames, UInt& ruiFailed )
+{
+  const std::string cConfigFile( "RateCtrlTest.cfg" );
+  RNOK( xWriteConfig( cConfigFile, uiRateControl, dBitrate, dMaxBitrate ) );
+
+  H264AVCMultiviewEncoderTest*  pcEncoder = NULL;
+  ViewBits                      acView[NUM_VIEWS];
+  for( UInt uiView = 0; uiView < NUM_VIEWS; uiView++ )
+  {
+    acView[uiView].uiTotalBits  = 0;
+    acView[uiView].uiPrefixBits = 0;
+  }
+  RNOK( H264AVCMultiviewEncoderTest::create( pcEncoder ) );
+  RNOK( pcEncoder->initSession( cConfigFile, xNalUnitCallback, acView ) );
+
+  std::vector<UChar>  cPicture( NUM_VIEWS * WIDTH * HEIGHT * 3 / 2 );
+  const UChar*        apucLum[NUM_VIEWS];
+  const UChar*        apucCb [NUM_VIEWS];
+  const UChar*        apucCr [NUM_VIEWS];
+  UInt                uiRandom = 1;
+  for( UInt uiFrame = 0; uiFrame < uiNumFrames; uiFrame++ )
+  {
+    for( UInt uiView = 0; uiView < NUM_VIEWS; uiView++ )
+    {
+      UChar* pucLum   = &cPicture[uiView * WIDTH * HEIGHT * 3 / 2];
+      apucLum[uiView] = pucLum;
+      apucCb [uiView] = pucLum + WIDTH * HEIGHT;
+      apucCr [uiView] = pucLum + WIDTH * HEIGHT * 5 / 4;
+      xCreatePicture( pucLum, pucLum + WIDTH * HEIGHT, pucLum + WIDTH * HEIGHT * 5 / 4, uiFrame, uiView, uiRandom );
+    }
+    RNOK( pcEncoder->encodeFrames( apucLum, apucCb, apucCr, WIDTH, WIDTH / 2 ) );
+  }
+  RNOK( pcEncoder->finishSession() );
+  RNOK( pcEncoder->destroy() );
+  ::remove( cConfigFile.c_str() );
+
+  //===== every view within 10% of its share, no picture larger than the VBV buffer (half a second at the drain rate) =====
+  Double dDrainRate = ( uiRateControl == 2 && dMaxBitrate > dBitrate ? dMaxBitrate : dBitrate );
+  Double dTotal     = 0;
+  for( UInt uiView = 0; uiView < NUM_VIEWS; uiView++ )
+  {
+    Double  dShare    = ( uiView ? 100 - BASE_SHARE : BASE_SHARE ) / 100.0;
+    Double  dTarget   = dShare * dBitrate;
+    Double  dVBVSize  = 0.5 * dShare * dDrainRate * 1000.0;
+    UInt    uiNumPics = (UInt)acView[uiView].cPictureBits.size();
+    UInt    uiMaxBits = 0;
+    for( UInt n = 0; n < uiNumPics; n++ )
+    {
+      uiMaxBits = max( uiMaxBits, acView[uiView].cPictureBits[n] );
+    }
+    Double  dKbps     = acView[uiView].uiTotalBits * FRAME_RATE / max( 1u, uiNumPics ) / 1000.0;
+    Bool    bOk       = ( uiNumPics == uiNumFrames && dKbps >= 0.9 * dTarget && dKbps <= 1.1 * dTarget && uiMaxBits <= dVBVSize );
+    dTotal           += dKbps;
+
+    printf( "  view %d: %6.1f kbit/s (target %6.1f), largest picture %6d bits (VBV %6.0f) %s\n",
+            uiView, dKbps, dTarget, uiMaxBits, dVBVSize, bOk ? "ok" : "FAILED" );
+    ruiFailed += ( bOk ? 0 : 1 );
+  }
+  printf( "  total : %6.1f kbit/s (target %6.1f)\n\n", dTotal, dBitrate );
+
+  return Err::m_nOK;
+}
+
+
+int
+main( int argc, char** argv )
+{
+  UInt uiNumFrames  = ( argc > 1 ? (UInt)atoi( argv[1] ) : 100 );
+  UInt uiFailed     = 0;
+
+  //===== mode, bit rate and maximum bit rate in kbit/s =====
+  const UInt    auiMode       [3] = { 1,    1,     2     };
+  const Double  adBitrate     [3] = { 90.0, 240.0, 160.0 };
+  const Double  adMaxBitrate  [3] = { 0.0,  0.0,   240.0 };
+
+  for( UInt uiTest = 0; uiTest < 3; uiTest++ )
+  {
+    printf( "RateControl %d, Bitrate %.0f, MaxBitrate %.0f, %d frames\n", auiMode[uiTest], adBitrate[uiTest], adMaxBitrate[uiTest], uiNumFrames );
+    RNOKRS( xTestRate( auiMode[uiTest], adBitrate[uiTest], adMaxBitrate[uiTest], uiNumFrames, uiFailed ), 2 );
+  }
+
+  printf( "%s\n", uiFailed ? "rate control test FAILED" : "rate control test passed" );
+  return uiFailed ? 1 : 0;
+}
@@ -0,0 +1,311 @@
+#if defined( WIN32 )
+# define WIN32_LEAN_AND_MEAN
+# define NOMINMAX
+# include <winsock2.h>
+# include <windows.h>
+# pragma comment( lib, "ws2_32.lib" )
+# define close      closesocket
+#else
+# include <sys/socket.h>
+# include <netinet/in.h>
+# include <arpa/inet.h>
+# include <unistd.h>
+#endif
+
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+#include "H264AVCDecoderLibTest.h"
+#include "H264AVCDecoderTest.h"
+#include "BitstreamReceiver.h"
+
+
+static UInt g_uiRandom = 1;
+
+static UInt xGetRandom()
+{
+  g_uiRandom = g_uiRandom * 1103515245 + 12345;
+  return g_uiRandom >> 8;
+}
+
+
+static Void xSleep( UInt uiMilliseconds )
+{
+#if defined( WIN32 )
+  ::Sleep( uiMilliseconds );
+#else
+  ::usleep( uiMilliseconds * 1000 );
+#endif
+}
+
+
+static ErrVal xReadFile( const std::string& rcFileName, std::vector<UChar>& rcData )
+{
+  rcData.clear();
+  FILE* pFile = ::fopen( rcFileName.c_str(), "rb" );
+  ROFRS( pFile, Err::m_nERR );
+
+  UChar  aucBuffer[0x10000];
+  size_t uiSize;
+  while( ( uiSize = ::fread( aucBuffer, 1, sizeof( aucBuffer ), pFile ) ) > 0 )
+  {
+    rcData.insert( rcData.end(), aucBuffer, aucBuffer + uiSize );
+  }
+  ::fclose( pFile );
+  return Err::m_nOK;
+}
+
+
+static std::string xGetYuvFile( const std::string& rcYuvFile, UInt uiView )
+{
+  char acView[16];
+  sprintf( acView, "_%d.yuv", uiView );
+  return rcYuvFile.substr( 0, rcYuvFile.rfind( "." ) ) + acView;
+}
+
+
+static UInt xGetMaxNalUnitSize( const std::vector<UChar>& rcStream )
+{
+  UInt uiMaxSize = 0;
+  UInt uiStart   = 0;
+  for( UInt uiPos = 2; uiPos <= rcStream.size(); uiPos++ )
+  {
+    if( uiPos == rcStream.size() || ( rcStream[uiPos] == 1 && rcStream[uiPos-1] == 0 && rcStream[uiPos-2] == 0 ) )
+    {
+      uiMaxSize = max( uiMaxSize, uiPos - uiStart );
+      uiStart   = uiPos;
+    }
+  }
+  return uiMaxSize;
+}
+
+
+//===== decodes the bitstream as the decoder application does, a stream is ended when the decoder stops reading =====
+static ErrVal xDecode( ReadBitstreamIf* pcReadBitstream, ReadBitstreamStream* pcReadBitstreamStream, const std::string& rcYuvFile, UInt uiNumViews )
+{
+  char acName[]   = "ReadBitstreamStreamTest";
+  char acStream[] = "stream";
+  char acViews[16];
+  std::vector<char> cYuvFile( rcYuvFile.begin(), rcYuvFile.end() );
+  cYuvFile.push_back( 0 );
+  sprintf( acViews, "%d", uiNumViews );
+  char* apcArgv[] = { acName, acStream, &cYuvFile[0], acViews };
+
+  DecoderParameter    cParameter;
+  WriteYuvIf*         pcWriteYuv            = NULL;
+  H264AVCDecoderTest* pcH264AVCDecoderTest  = NULL;
+  ErrVal              nRet                  = Err::m_nERR;
+
+  if( Err::m_nOK == cParameter.init( 4, apcArgv ) &&
+      Err::m_nOK == WriteYuvToFile::createMVC( pcWriteYuv, cParameter.cYuvFile, cParameter.uiNumOfViews ) &&
+      Err::m_nOK == H264AVCDecoderTest::create( pcH264AVCDecoderTest ) &&
+      Err::m_nOK == pcH264AVCDecoderTest->init( &cParameter, (WriteYuvToFile*)pcWriteYuv, pcReadBitstream ) )
+  {
+    nRet = pcH264AVCDecoderTest->go();
+  }
+  if( pcReadBitstreamStream )
+  {
+    pcReadBitstreamStream->endStream();
+  }
+  if( pcH264AVCDecoderTest )
+  {
+    RNOK( pcH264AVCDecoderTest->destroy() );
+  }
+  if( pcWriteYuv )
+  {
+    RNOK( pcWriteYuv->destroy() );
+  }
+  return nRet;
+}
+
+
+//===== appends the bitstream like the client: packets of complete NAL units, in pieces as far as the ring has room =====
+static ErrVal xFeedRing( ReadBitstreamStream* pcReadBitstreamStream, const std::vector<UChar>& rcStream )
+{
+  UInt uiPos = 0;
+  while( uiPos < rcStream.size() )
+  {
+    //===== the packet ends before a start code, after 1 to 4 NAL units =====
+    UInt uiEnd      = uiPos + 4;
+    UInt uiNumNalUs = 1 + xGetRandom() % 4;
+    for( ; uiEnd < rcStream.size(); uiEnd++ )
+    {
+      if( rcStream[uiEnd] == 1 && rcStream[uiEnd-1] == 0 && rcStream[uiEnd-2] == 0 && 0 == --uiNumNalUs )
+      {
+        break;
+      }
+    }
+    uiEnd = ( uiEnd < rcStream.size() ? uiEnd - ( rcStream[uiEnd-3] == 0 ? 3 : 2 ) : (UInt)rcStream.size() );
+
+    while( uiPos < uiEnd )
+    {
+      UInt uiAppended = 0;
+      UInt uiSize     = 1 + xGetRandom() % 3000;
+      RNOK( pcReadBitstreamStream->tryAppend( &rcStream[uiPos], min( uiEnd - uiPos, uiSize ), uiAppended ) );
+      uiPos += uiAppended;
+      if( 0 == uiAppended )
+      {
+        xSleep( 1 );
+      }
+    }
+    pcReadBitstreamStream->endAccessUnit();
+  }
+  pcReadBitstreamStream->endStream();
+  return Err::m_nOK;
+}
+
+
+//===== sends the bitstream to the receiver in pieces of any size =====
+static ErrVal xFeedSocket( UInt uiPort, const std::vector<UChar>& rcStream )
+{
+  Int iSocket = (Int)::socket( AF_INET, SOCK_STREAM, 0 );
+  ROT( iSocket < 0 );
+
+  sockaddr_in cAddress;
+  ::memset( &cAddress, 0, sizeof( cAddress ) );
+  cAddress.sin_family       = AF_INET;
+  cAddress.sin_addr.s_addr  = inet_addr( "127.0.0.1" );
+  cAddress.sin_port         = htons( (unsigned short)uiPort );
+
+  ErrVal nRet = Err::m_nERR;
+  if( 0 == ::connect( iSocket, (sockaddr*)&cAddress, sizeof( cAddress ) ) )
+  {
+    nRet = Err::m_nOK;
+    for( UInt uiPos = 0; uiPos < rcStream.size(); )
+    {
+      UInt uiSize = 1 + xGetRandom() % 5000;
+      Int  iSize  = (Int)::send( iSocket, (const char*)&rcStream[uiPos], min( (UInt)rcStream.size() - uiPos, uiSize ), 0 );
+      if( iSize <= 0 )
+      {
+        nRet = Err::m_nERR;
+        break;
+      }
+      uiPos += (UInt)iSize;
+      if( xGetRandom() % 4 == 0 )
+      {
+        xSleep( 1 );
+      }
+    }
+  }
+  ::close( iSocket );
+  return nRet;
+}
+
+
+//===== the decoded views must be the same as those of the file =====
+static UInt xCompare( const std::string& rcYuvFile, const std::string& rcRefYuvFile, UInt uiNumViews )
+{
+  UInt uiFailed = 0;
+  for( UInt uiView = 0; uiView < uiNumViews; uiView++ )
+  {
+    std::vector<UChar> cDecoded, cReference;
+    if( Err::m_nOK != xReadFile( xGetYuvFile( rcYuvFile,    uiView ), cDecoded   ) ||
+        Err::m_nOK != xReadFile( xGetYuvFile( rcRefYuvFile, uiView ), cReference ) ||
+        cReference.empty() || cDecoded != cReference )
+    {
+      printf( "  view %d: %d bytes decoded, %d bytes expected  FAILED\n", uiView, (UInt)cDecoded.size(), (UInt)cReference.size() );
+      uiFailed++;
+    }
+  }
+  return uiFailed;
+}
+
+
+int
+main( int argc, char** argv )
+{
+  if( argc < 3 || argc > 4 )
+  {
+    printf( "usage: %s <BitstreamFile> <NumOfViews> [<port>]\n", argv[0] );
+    return 2;
+  }
+  std::string cBitstreamFile  = argv[1];
+  UInt        uiNumViews      = (UInt)atoi( argv[2] );
+  UInt        uiPort          = ( argc > 3 ? (UInt)atoi( argv[3] ) : 12264 );
+  UInt        uiFailed        = 0;
+
+  std::vector<UChar> cStream;
+  RNOKRS( xReadFile( cBitstreamFile, cStream ), 2 );
+
+  printf( "ReadBitstreamStream test: %s, %d bytes, %d views\n\n", cBitstreamFile.c_str(), (UInt)cStream.size(), uiNumViews );
+
+  //===== reference: the bitstream file =====
+  ReadBitstreamFile* pcReadBitstreamFile = NULL;
+  RNOKRS( ReadBitstreamFile::create( pcReadBitstreamFile ), 1 );
+  RNOKRS( pcReadBitstreamFile->init( cBitstreamFile ), 1 );
+  RNOKRS( xDecode( pcReadBitstreamFile, NULL, "ReadBitstreamStreamTest_file.yuv", uiNumViews ), 1 );
+  RNOK  ( pcReadBitstreamFile->uninit() );
+  RNOK  ( pcReadBitstreamFile->destroy() );
+
+  //===== the ring fed by another thread without waiting, the ring holds two of the largest NAL units only =====
+  {
+    ReadBitstreamStream* pcReadBitstreamStream = NULL;
+    ErrVal               nDecoderResult        = Err::m_nOK;
+    ErrVal               nFeederResult         = Err::m_nOK;
+    RNOKRS( ReadBitstreamStream::create( pcReadBitstreamStream ), 1 );
+    RNOKRS( pcReadBitstreamStream->init( 2 * xGetMaxNalUnitSize( cStream ) ), 1 );
+#pragma omp parallel sections num_threads( 2 )
+    {
+#pragma omp section
+      {
+        nFeederResult = xFeedRing( pcReadBitstreamStream, cStream );
+      }
+#pragma omp section
+      {
+        nDecoderResult = xDecode( pcReadBitstreamStream, pcReadBitstreamStream, "ReadBitstreamStreamTest_ring.yuv", uiNumViews );
+      }
+    }
+    RNOK( pcReadBitstreamStream->uninit() );
+    RNOK( pcReadBitstreamStream->destroy() );
+
+    UInt uiViewsFailed = xCompare( "ReadBitstreamStreamTest_ring.yuv", "ReadBitstreamStreamTest_file.yuv", uiNumViews );
+    Bool bOk           = ( Err::m_nOK == nDecoderResult && Err::m_nOK == nFeederResult && 0 == uiViewsFailed );
+    printf( "ring,     tryAppend  %s\n", bOk ? "ok" : "FAILED" );
+    uiFailed += ( bOk ? 0 : 1 );
+  }
+
+  //===== a local feeder sending to the receiver on the loopback interface =====
+  {
+    ReadBitstreamStream* pcReadBitstreamStream = NULL;
+    BitstreamReceiver*   pcBitstreamReceiver   = NULL;
+    ErrVal               nDecoderResult        = Err::m_nOK;
+    ErrVal               nReceiverResult       = Err::m_nOK;
+    ErrVal               nFeederResult         = Err::m_nOK;
+    RNOKRS( ReadBitstreamStream::create( pcReadBitstreamStream ), 1 );
+    RNOKRS( pcReadBitstreamStream->init( 4 * xGetMaxNalUnitSize( cStream ) ), 1 );
+    RNOKRS( BitstreamReceiver::create( pcBitstreamReceiver ), 1 );
+    RNOKRS( pcBitstreamReceiver->init( pcReadBitstreamStream, uiPort ), 1 );
+#pragma omp parallel sections num_threads( 3 )
+    {
+#pragma omp section
+      {
+        nFeederResult = xFeedSocket( uiPort, cStream );
+        if( Err::m_nOK != nFeederResult )
+        {
+          pcBitstreamReceiver->abort();
+        }
+      }
+#pragma omp section
+      {
+        nReceiverResult = pcBitstreamReceiver->receive();
+      }
+#pragma omp section
+      {
+        nDecoderResult = xDecode( pcReadBitstreamStream, NULL, "ReadBitstreamStreamTest_tcp.yuv", uiNumViews );
+        pcBitstreamReceiver->abort();
+      }
+    }
+    RNOK( pcBitstreamReceiver->destroy() );
+    RNOK( pcReadBitstreamStream->uninit() );
+    RNOK( pcReadBitstreamStream->destroy() );
+
+    UInt uiViewsFailed = xCompare( "ReadBitstreamStreamTest_tcp.yuv", "ReadBitstreamStreamTest_file.yuv", uiNumViews );
+    Bool bOk           = ( Err::m_nOK == nDecoderResult && Err::m_nOK == nReceiverResult && Err::m_nOK == nFeederResult && 0 == uiViewsFailed );
+    printf( "loopback, port %5d  %s\n", uiPort, bOk ? "ok" : "FAILED" );
+    uiFailed += ( bOk ? 0 : 1 );
+  }
+
+  printf( "\n%s\n", uiFailed ? "FAILED" : "passed" );
+  return ( uiFailed ? 1 : 0 );
+}
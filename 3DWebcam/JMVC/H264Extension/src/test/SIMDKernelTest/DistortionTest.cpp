@@ -0,0 +1,92 @@
+#include <cstdio>
+#include "SIMDKernelTest.h"
+#include "Distortion.h"
+
+
+#define SEARCH_STRIDE   48
+#define SEARCH_SIZE     ( 17 * SEARCH_STRIDE )
+#define ORG_SIZE        ( 16 * MB_BUFFER_WIDTH )
+
+
+UInt testDistortion( UInt uiSIMDFlags, UInt uiTrials )
+{
+  const Char* apcDFunc[4] = { "SAD", "SSD", "HADAMARD", "YUV_SAD" };
+
+  XDistortion* pcSIMD   = NULL;
+  XDistortion* pcScalar = NULL;
+  ROTRS( XDistortion::create( pcSIMD   ) != Err::m_nOK, 1 );
+  ROTRS( XDistortion::create( pcScalar ) != Err::m_nOK, 1 );
+  ROTRS( pcSIMD  ->init( uiSIMDFlags ) != Err::m_nOK, 1 );
+  ROTRS( pcScalar->init( SIMD_NONE   ) != Err::m_nOK, 1 );
+
+  XPel aYOrg[ORG_SIZE], aUOrg[ORG_SIZE], aVOrg[ORG_SIZE];
+  XPel aYFix[ORG_SIZE], aUFix[ORG_SIZE], aVFix[ORG_SIZE];
+  XPel aYSrc[SEARCH_SIZE], aUSrc[SEARCH_SIZE], aVSrc[SEARCH_SIZE];
+  UInt uiFailures = 0;
+
+  for( UInt uiBi = 0; uiBi < 2; uiBi++ )
+  for( UInt uiDF = 0; uiDF < 4; uiDF++ )
+  for( UInt uiBM = 1; uiBM < 12; uiBM++ )
+  {
+    XDistSearchStruct cSIMD;
+    XDistSearchStruct cScalar;
+    pcSIMD  ->getDistStruct( uiBM, (DFunc)uiDF, uiBi != 0, cSIMD   );
+    pcScalar->getDistStruct( uiBM, (DFunc)uiDF, uiBi != 0, cScalar );
+    if( NULL == cScalar.Func || cSIMD.Func == cScalar.Func )
+    {
+      continue;
+    }
+
+    for( UInt uiTrial = 0; uiTrial < uiTrials; uiTrial++ )
+    {
+      fillRandom( aYOrg, ORG_SIZE,    uiTrial );
+      fillRandom( aUOrg, ORG_SIZE,    uiTrial );
+      fillRandom( aVOrg, ORG_SIZE,    uiTrial );
+      fillRandom( aYFix, ORG_SIZE,    uiTrial );
+      fillRandom( aUFix, ORG_SIZE,    uiTrial );
+      fillRandom( aVFix, ORG_SIZE,    uiTrial );
+      fillRandom( aYSrc, SEARCH_SIZE, uiTrial );
+      fillRandom( aUSrc, SEARCH_SIZE, uiTrial );
+      fillRandom( aVSrc, SEARCH_SIZE, uiTrial );
+
+      //===== the search position is not aligned, as in the motion search =====
+      Int iOffset         = (Int)( getRandom() % SEARCH_STRIDE / 2 );
+      cSIMD.pYOrg         = aYOrg;
+      cSIMD.pUOrg         = aUOrg;
+      cSIMD.pVOrg         = aVOrg;
+      cSIMD.pYFix         = aYFix;
+      cSIMD.pUFix         = aUFix;
+      cSIMD.pVFix         = aVFix;
+      cSIMD.pYSearch      = aYSrc + iOffset;
+      cSIMD.pUSearch      = aUSrc + iOffset;
+      cSIMD.pVSearch      = aVSrc + iOffset;
+      cSIMD.iYStride      = SEARCH_STRIDE;
+      cSIMD.iCStride      = SEARCH_STRIDE;
+      cScalar.pYOrg       = cSIMD.pYOrg;
+      cScalar.pUOrg       = cSIMD.pUOrg;
+      cScalar.pVOrg       = cSIMD.pVOrg;
+      cScalar.pYFix       = cSIMD.pYFix;
+      cScalar.pUFix       = cSIMD.pUFix;
+      cScalar.pVFix       = cSIMD.pVFix;
+      cScalar.pYSearch    = cSIMD.pYSearch;
+      cScalar.pUSearch    = cSIMD.pUSearch;
+      cScalar.pVSearch    = cSIMD.pVSearch;
+      cScalar.iYStride    = cSIMD.iYStride;
+      cScalar.iCStride    = cSIMD.iCStride;
+
+      UInt uiSIMD   = cSIMD  .Func( &cSIMD   );
+      UInt uiScalar = cScalar.Func( &cScalar );
+      if( uiSIMD != uiScalar )
+      {
+        printf( "  %s%s %dx%d: %d instead of %d (trial %d)\n", uiBi ? "Bi" : "", apcDFunc[uiDF],
+                pcScalar->getBlockWidth( uiBM ), pcScalar->getBlockHeight( uiBM ), uiSIMD, uiScalar, uiTrial );
+        uiFailures++;
+        break;
+      }
+    }
+  }
+
+  pcSIMD  ->destroy();
+  pcScalar->destroy();
+  return uiFailures;
+}
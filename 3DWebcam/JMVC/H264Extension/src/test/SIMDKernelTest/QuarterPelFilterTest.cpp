@@ -0,0 +1,92 @@
+#include <cstdio>
+#include "SIMDKernelTest.h"
+#include "H264AVCCommonLib/QuarterPelFilter.h"
+
+
+#define SRC_STRIDE    64
+#define SRC_SIZE      ( ( 16 + 6 ) * SRC_STRIDE )
+#define DES_STRIDE    32
+
+
+//===== gives the test access to the kernel tables and to the scalar prediction =====
+class QuarterPelFilterTest : public QuarterPelFilter
+{
+public:
+  QuarterPelFilterTest() {}
+  virtual ~QuarterPelFilterTest() {}
+
+  PredLumaFunc  getPredLumaFunc ( Int iSizeX, Int iDx, Int iDy ) { return m_aafpPredLumaFunc [ xGetSizeIdx( iSizeX ) ][ ( iDy << 2 ) + iDx ]; }
+  XPredLumaFunc getXPredLumaFunc( Int iSizeX, Int iDx, Int iDy ) { return m_aafpXPredLumaFunc[ xGetSizeIdx( iSizeX ) ][ ( iDy << 2 ) + iDx ]; }
+
+  Void predLuma( Pel*  pDes, Pel*  pSrc, Int iDx, Int iDy, Int iSizeY, Int iSizeX ) { xPredLuma( pDes, pSrc, DES_STRIDE, SRC_STRIDE, iDx, iDy, iSizeY, iSizeX ); }
+  Void predLuma( XPel* pDes, XPel* pSrc, Int iDx, Int iDy, Int iSizeY, Int iSizeX ) { xPredLuma( pDes, pSrc, DES_STRIDE, SRC_STRIDE, iDx, iDy, iSizeY, iSizeX ); }
+};
+
+
+template< class T, class F >
+static UInt xTestPredLuma( QuarterPelFilterTest* pcFilter, F fpPredLuma, Int iDx, Int iDy, Int iSizeY, Int iSizeX, UInt uiTrials )
+{
+  XPel aRandom[SRC_SIZE];
+  T    aSrc   [SRC_SIZE];
+  T    aSIMD  [16 * DES_STRIDE];
+  T    aScalar[16 * DES_STRIDE];
+
+  for( UInt uiTrial = 0; uiTrial < uiTrials; uiTrial++ )
+  {
+    fillRandom( aRandom, SRC_SIZE, uiTrial );
+    for( UInt n = 0; n < SRC_SIZE; n++ )
+    {
+      aSrc[n] = (T)aRandom[n];
+    }
+
+    //===== the 6 tap filter reads 2 samples before and 3 after the block, at any alignment =====
+    T* pSrc = aSrc + 2 * SRC_STRIDE + 2 + getRandom() % ( SRC_STRIDE - 16 - 5 );
+    fpPredLuma     ( aSIMD,   pSrc, DES_STRIDE, SRC_STRIDE, iDx, iDy, iSizeY );
+    pcFilter->predLuma( aScalar, pSrc, iDx, iDy, iSizeY, iSizeX );
+
+    for( Int y = 0; y < iSizeY; y++ )
+    for( Int x = 0; x < iSizeX; x++ )
+    {
+      if( aSIMD[y * DES_STRIDE + x] != aScalar[y * DES_STRIDE + x] )
+      {
+        printf( "  %s %dx%d dx %d dy %d: %d instead of %d at (%d,%d) (trial %d)\n", sizeof( T ) == 1 ? "Pel " : "XPel",
+                iSizeX, iSizeY, iDx, iDy, aSIMD[y * DES_STRIDE + x], aScalar[y * DES_STRIDE + x], x, y, uiTrial );
+        return 1;
+      }
+    }
+  }
+  return 0;
+}
+
+
+UInt testQuarterPelFilter( UInt uiSIMDFlags, UInt uiTrials )
+{
+  const Int aiSize[7][2] = { { 16, 16 }, { 16, 8 }, { 8, 16 }, { 8, 8 }, { 8, 4 }, { 4, 8 }, { 4, 4 } };
+
+  QuarterPelFilterTest cFilter;
+  ROTRS( cFilter.init( uiSIMDFlags ) != Err::m_nOK, 1 );
+
+  UInt uiFailures = 0;
+  for( UInt uiSize = 0; uiSize < 7; uiSize++ )
+  for( Int  iPos   = 0; iPos   < 16;  iPos++   )
+  {
+    Int iSizeX = aiSize[uiSize][0];
+    Int iSizeY = aiSize[uiSize][1];
+    Int iDx    = iPos & 3;
+    Int iDy    = iPos >> 2;
+
+    PredLumaFunc  fpPredLuma  = cFilter.getPredLumaFunc ( iSizeX, iDx, iDy );
+    XPredLumaFunc fpXPredLuma = cFilter.getXPredLumaFunc( iSizeX, iDx, iDy );
+    if( NULL != fpPredLuma )
+    {
+      uiFailures += xTestPredLuma<Pel >( &cFilter, fpPredLuma,  iDx, iDy, iSizeY, iSizeX, uiTrials );
+    }
+    if( NULL != fpXPredLuma )
+    {
+      uiFailures += xTestPredLuma<XPel>( &cFilter, fpXPredLuma, iDx, iDy, iSizeY, iSizeX, uiTrials );
+    }
+  }
+
+  cFilter.uninit();
+  return uiFailures;
+}
@@ -0,0 +1,65 @@
+#include <cstdio>
+#include <cstdlib>
+#include "SIMDKernelTest.h"
+
+
+static UInt g_uiRandom = 1;
+
+Void setRandomSeed( UInt uiSeed )
+{
+  g_uiRandom = uiSeed;
+}
+
+UInt getRandom()
+{
+  g_uiRandom = g_uiRandom * 1103515245 + 12345;
+  return g_uiRandom >> 8;
+}
+
+Void fillRandom( XPel* pPel, UInt uiSize, UInt uiTrial )
+{
+  //===== every fourth trial uses the extreme sample values, where the sums are the largest =====
+  Bool bExtreme = ( uiTrial % 4 ) == 3;
+  for( UInt n = 0; n < uiSize; n++ )
+  {
+    pPel[n] = (XPel)( bExtreme ? ( getRandom() & 1 ) * 255 : getRandom() & 0xff );
+  }
+}
+
+
+int
+main( int argc, char** argv )
+{
+  UInt uiTrials = ( argc > 1 ? (UInt)atoi( argv[1] ) : 1000 );
+  UInt uiCpu    = CpuInfo::getSIMDFlags();
+  UInt uiFailed = 0;
+
+  printf( "SIMD kernel test (processor: sse2 %d, ssse3 %d, avx2 %d)\n\n",
+          ( uiCpu & SIMD_SSE2 ) ? 1 : 0, ( uiCpu & SIMD_SSSE3 ) ? 1 : 0, ( uiCpu & SIMD_AVX2 ) ? 1 : 0 );
+
+  //===== each instruction set level on its own, the higher levels replace only some of the kernels =====
+  const UInt  auiLevel  [3] = { SIMD_SSE2, SIMD_SSE2 | SIMD_SSSE3, SIMD_ALL };
+  const Char* apcLevel  [3] = { "sse2", "ssse3", "avx2" };
+  UInt        uiPrevious    = SIMD_NONE;
+
+  for( UInt uiLevel = 0; uiLevel < 3; uiLevel++ )
+  {
+    UInt uiSIMDFlags = auiLevel[uiLevel] & uiCpu;
+    if( uiSIMDFlags == uiPrevious )
+    {
+      printf( "%-6s not supported, skipped\n", apcLevel[uiLevel] );
+      continue;
+    }
+    uiPrevious = uiSIMDFlags;
+
+    setRandomSeed( 1 + uiLevel );
+    UInt uiDistortion = testDistortion( uiSIMDFlags, uiTrials );
+    printf( "%-6s distortion         %s\n", apcLevel[uiLevel], uiDistortion ? "FAILED" : "ok" );
+    UInt uiQuarterPel = testQuarterPelFilter( uiSIMDFlags, uiTrials );
+    printf( "%-6s quarter pel filter %s\n", apcLevel[uiLevel], uiQuarterPel ? "FAILED" : "ok" );
+    uiFailed += uiDistortion + uiQuarterPel;
+  }
+
+  printf( "\n%s\n", uiFailed ? "SIMD kernel test FAILED" : "SIMD kernel test passed" );
+  return uiFailed ? 1 : 0;
+}
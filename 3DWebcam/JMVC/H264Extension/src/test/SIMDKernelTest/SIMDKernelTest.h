@@ -0,0 +1,22 @@
+#ifndef __SIMDKERNELTEST_H_3E1A7C52_9B4D_4F0E_A6C8_2D5B7F19E043
+#define __SIMDKERNELTEST_H_3E1A7C52_9B4D_4F0E_A6C8_2D5B7F19E043
+
+
+#include "H264AVCEncoderLib.h"
+#include "H264AVCCommonLib/CpuInfo.h"
+
+using namespace h264;
+
+
+//===== each test compares the kernels selected by uiSIMDFlags with the scalar kernels on random data =====
+UInt testDistortion      ( UInt uiSIMDFlags, UInt uiTrials );
+UInt testQuarterPelFilter( UInt uiSIMDFlags, UInt uiTrials );
+
+
+//===== random sample values, reproducible from run to run =====
+Void  setRandomSeed( UInt uiSeed );
+UInt  getRandom    ();
+Void  fillRandom   ( XPel* pPel, UInt uiSize, UInt uiTrial );
+
+
+#endif //__SIMDKERNELTEST_H_3E1A7C52_9B4D_4F0E_A6C8_2D5B7F19E043
@@ -96,13 +96,8 @@ void MyCameraWindow::timerEvent(QTimerEvent*) {
 	else if(handler->isEncoding()) {	// If it is encoding
 		frame_cnt++;
 		
-		// Write the video file(s)
+		// Give the frame to the encoder, it is encoded until "Stop" is pressed
 		handler->saveFrame();
-		
-		// Test if we have saved 15 frames, and stop the encoding if it is the case
-		if(frame_cnt == 15 && handler->getFrameNb() < 20) {
-			stopEncoding();
-		}
 	}
 }
 
@@ -139,6 +134,12 @@ void MyCameraWindow::startRecording(QString file) {
 }
 
 void MyCameraWindow::stopRecording() {
+	// The "Stop" button also ends the encoding
+	if(handler->isEncoding()) {
+		stopEncoding();
+		return;
+	}
+
 	start->setEnabled(true);
 	stop->setEnabled(false);
 	encode->setEnabled(true);
@@ -158,12 +159,18 @@ void MyCameraWindow::stopRecording() {
 
 void MyCameraWindow::startEncoding() {
 	start->setEnabled(false);
-	stop->setEnabled(false);
+	stop->setEnabled(true);
 	encode->setEnabled(false);
 	menuOpt->setEnabled(false);
 
 	handler->startEncoding();
 	
+	if(!handler->isEncoding()) {
+		stopEncoding();
+		statBar->showMessage("Cannot start the encoder");
+		return;
+	}
+
 	statBar->showMessage("Encoding...");
 }
 
@@ -325,7 +332,7 @@ void MyCameraWindow::initExternButtonsWindow() {
 	QObject::connect(stop, SIGNAL(clicked()), this, SLOT(stopRecording()));
 
 	encode = new QPushButton("Encode");
-	encode->setToolTip("Encode 15 frames");
+	encode->setToolTip("Encode until Stop is pressed");
 	encode->setSizePolicy(QSizePolicy::Fixed, QSizePolicy::Fixed);
 	QObject::connect(encode, SIGNAL(clicked()), this, SLOT(startEncoding()));
 
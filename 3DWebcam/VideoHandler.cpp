@@ -26,7 +26,13 @@ VideoHandler::VideoHandler(vector<VideoThread*> const& cams) :
 	cameras(cams),
 	recording(false),
 	encoding(false),
-	framesNb(0)
+	framesNb(0),
+	encoder(NULL),
+	encoderThread(NULL),
+	frameSize(0),
+	stopRequested(false),
+	encodingFailed(false),
+	framesDropped(0)
 {
 }
 
@@ -35,6 +41,11 @@ VideoHandler::~VideoHandler() {
 	for(int i(0) ; i < (int)writers.size() ; i++) {
 		cvReleaseVideoWriter(&writers[i]);
 	}
+
+	// Close the encoder session
+	if(encoding) {
+		stopEncoding();
+	}
 }
 
 void VideoHandler::startRecording(vector<QString> const& files) {
@@ -76,63 +87,225 @@ void VideoHandler::startEncoding() {
 		QDir().mkdir("video_qp32");
 	}
 
-	int isColor = 1;
-	int fps     = 25;
-	
-	// Create a writer for each video thread
-	for(int i(0) ; i < (int)cameras.size() ; i++) {
-		char str[23];
-		sprintf(str, "video_qp32/video_%d.yuv", i);
-		writers.push_back(cvCreateVideoWriter(str, CV_FOURCC('I','Y','U','V'), fps, cvSize(WIDTH,HEIGHT), isColor));
+	// Each view is taken from the camera at the index of its view id
+	std::vector<UInt> viewIds;
+	if(H264AVCEncoderTest::getViewCodingOrder("config.cfg", viewIds) != Err::m_nOK) {
+		cout << "Cannot read the views of config.cfg" << endl;
+		return;
+	}
+	unsigned int maxViewId = 0;
+	for(int i(0) ; i < (int)viewIds.size() ; i++) {
+		if((int)viewIds[i] >= getNbCam()) {
+			cout << "No camera for the view " << viewIds[i] << " of config.cfg" << endl;
+			return;
+		}
+		maxViewId = max(maxViewId, (unsigned int)viewIds[i]);
+	}
+	bitstreams.assign(maxViewId+1, (FILE*)NULL);
+
+	// Open an encoder session for all the views,
+	// the NAL units are given to writeNalUnit
+	H264AVCMultiviewEncoderTest::create(encoder);
+	if(encoder->initSession("config.cfg", writeNalUnit, this) != Err::m_nOK) {
+		cout << "Cannot open the encoder session with config.cfg" << endl;
+		encoder->destroy();
+		encoder = NULL;
+		closeBitstreams();
+		return;
+	}
+
+	// The frames of the cameras are resized to WIDTH x HEIGHT,
+	// the configuration must encode frames of the same size
+	if((int)encoder->getSourceWidth() != WIDTH || (int)encoder->getSourceHeight() != HEIGHT) {
+		cout << "config.cfg encodes " << encoder->getSourceWidth() << "x" << encoder->getSourceHeight()
+			 << " frames, the cameras give " << WIDTH << "x" << HEIGHT << " frames" << endl;
+		encoder->destroy();
+		encoder = NULL;
+		closeBitstreams();
+		return;
 	}
-	
+
+	// The frame buffers are allocated once, the GUI thread fills the free ones
+	// and the encoder thread gives them back once their frames are encoded
+	frameSize = WIDTH*HEIGHT*3/2;
+	frames.assign(ENCODER_QUEUE_SIZE, vector<unsigned char>((maxViewId+1)*frameSize));
+	freeFrames.clear();
+	queuedFrames.clear();
+	for(int i(0) ; i < ENCODER_QUEUE_SIZE ; i++) {
+		freeFrames.enqueue(i);
+	}
+	stopRequested  = false;
+	encodingFailed = false;
+	framesDropped  = 0;
+
+	// Launch the encoder thread, it owns the session until it returns
+	encoderThread = new sf::Thread(&VideoHandler::encode, this);
+	encoderThread->Launch();
+
 	framesNb = 0;
 	encoding = true;
 }
 
 void VideoHandler::stopEncoding() {
-	// Launch the encoding thread
-	Thread* t = new Thread((Thread::FuncType)encode);
-	t->Launch();
-
-	// Free the writers
-	for(int i(0) ; i < (int)writers.size() ; i++) {
-		cvReleaseVideoWriter(&writers[i]);
+	if(!encoding) {
+		return;
 	}
 
-	writers.clear();
+	// The encoder thread encodes the queued frames and
+	// the ones still waiting for their GOP, then closes the session
+	queueMutex.lock();
+	stopRequested = true;
+	queueChanged.wakeAll();
+	queueMutex.unlock();
+
+	encoderThread->Wait();
+	delete encoderThread;
+	encoderThread = NULL;
+	encoder = NULL;
+
+	closeBitstreams();
+
+	if(framesDropped > 0) {
+		cout << framesDropped << " frames dropped, the encoder was too slow" << endl;
+	}
 
 	encoding = false;
 }
 
+void VideoHandler::closeBitstreams() {
+	for(int i(0) ; i < (int)bitstreams.size() ; i++) {
+		if(bitstreams[i]) {
+			fclose(bitstreams[i]);
+		}
+	}
+
+	bitstreams.clear();
+}
+
 void VideoHandler::saveFrame() {
-	// Write frames in the files with the writers
-	for(int i = 0 ; i < (int)cameras.size() ; i++) {
-		// getFrame(i) grabs a frame from the VideoThread with the index "i" in the "cameras" vector
-		cvWriteFrame(writers[i], getFrame(i));
+	if(encoding) {
+		// The encoding of a frame has failed in the encoder thread
+		queueMutex.lock();
+		bool failed = encodingFailed;
+		queueMutex.unlock();
+		if(failed) {
+			cout << "Encoding of a frame failed, the encoding is stopped" << endl;
+			stopEncoding();
+			return;
+		}
+
+		// Take a free frame buffer, the GUI thread never waits for the encoder:
+		// if all the buffers are queued, the frame is dropped
+		queueMutex.lock();
+		if(freeFrames.isEmpty()) {
+			queueMutex.unlock();
+			framesDropped++;
+			return;
+		}
+		int index = freeFrames.dequeue();
+		queueMutex.unlock();
+
+		// Convert the frame of each view into the buffer
+		for(int i(0) ; i < (int)encoder->getNumViews() ; i++) {
+			unsigned int viewId = encoder->getViewId(i);
+			unsigned char* l = &frames[index][viewId*frameSize];
+			unsigned char* u = l + WIDTH*HEIGHT;
+			unsigned char* v = u + WIDTH*HEIGHT/4;
+
+			// A camera without a frame of the encoded size yet is waited for
+			if(!bgr2yuv420(cameras[viewId]->GetFrame(), l, u, v, WIDTH, HEIGHT)) {
+				queueMutex.lock();
+				freeFrames.enqueue(index);
+				queueMutex.unlock();
+				return;
+			}
+		}
+
+		// Queue the frame for the encoder thread
+		queueMutex.lock();
+		queuedFrames.enqueue(index);
+		queueChanged.wakeAll();
+		queueMutex.unlock();
+	}
+	else {
+		// Write frames in the files with the writers
+		for(int i = 0 ; i < (int)cameras.size() ; i++) {
+			// getFrame(i) grabs a frame from the VideoThread with the index "i" in the "cameras" vector
+			cvWriteFrame(writers[i], getFrame(i));
+		}
 	}
 
 	framesNb++;
 }
 
-void* encode(void* data) {
-	int argc = 4;
-	char** argv = (char**)malloc(sizeof(char*)*argc);
-	argv[0] = "H264AVCEncoderLibTestStatic.exe";
-	argv[1] = "-vf";
-	argv[2] = "config.cfg";
-	argv[3] = "0";
+void VideoHandler::encode(void* data) {
+	VideoHandler* handler = (VideoHandler*)data;
+	H264AVCMultiviewEncoderTest* encoder = handler->encoder;
+	int numViewIds = (int)handler->bitstreams.size();
+	vector<const unsigned char*> lum(numViewIds, (const unsigned char*)NULL);
+	vector<const unsigned char*> cb (numViewIds, (const unsigned char*)NULL);
+	vector<const unsigned char*> cr (numViewIds, (const unsigned char*)NULL);
+	bool failed = false;
+
+	for(;;) {
+		// Wait for a frame, or for the end of the encoding once all the frames are encoded
+		handler->queueMutex.lock();
+		while(handler->queuedFrames.isEmpty() && !handler->stopRequested) {
+			handler->queueChanged.wait(&handler->queueMutex);
+		}
+		if(handler->queuedFrames.isEmpty()) {
+			handler->queueMutex.unlock();
+			break;
+		}
+		int index = handler->queuedFrames.head();
+		handler->queueMutex.unlock();
+
+		// Encode the frames of all the views together,
+		// after an error the frames are only given back until the encoding is stopped
+		if(!failed) {
+			for(int i(0) ; i < (int)encoder->getNumViews() ; i++) {
+				unsigned int viewId = encoder->getViewId(i);
+				lum[viewId] = &handler->frames[index][viewId*handler->frameSize];
+				cb[viewId]  = lum[viewId] + WIDTH*HEIGHT;
+				cr[viewId]  = cb[viewId]  + WIDTH*HEIGHT/4;
+			}
+			failed = encoder->encodeFrames(&lum[0], &cb[0], &cr[0], WIDTH, WIDTH/2) != Err::m_nOK;
+		}
 
-	H264AVCEncoderTest*         pcH264AVCEncoderTest = NULL;
-	H264AVCEncoderTest::create( pcH264AVCEncoderTest );
+		// Give the buffer back to the GUI thread
+		handler->queueMutex.lock();
+		handler->queuedFrames.dequeue();
+		handler->freeFrames.enqueue(index);
+		handler->encodingFailed = failed;
+		handler->queueMutex.unlock();
+	}
 
-	pcH264AVCEncoderTest->init(argc, argv);
-	pcH264AVCEncoderTest->go();
-	pcH264AVCEncoderTest->destroy();
+	// Encode the frames still waiting for their GOP and close the session
+	if(!failed) {
+		encoder->finishSession();
+	}
+	encoder->destroy();
+}
 
-	free(argv);
+void VideoHandler::writeNalUnit(void* data, unsigned int viewId, const unsigned char* nal, unsigned int size) {
+	static const unsigned char startCode[4] = { 0, 0, 0, 1 };
+	VideoHandler* handler = (VideoHandler*)data;
+	FILE*& bitstream = handler->bitstreams[viewId];
+
+	// The bitstream file of a view is known once its configuration has been read
+	if(bitstream == NULL) {
+		for(int i(0) ; i < (int)handler->encoder->getNumViews() ; i++) {
+			if(handler->encoder->getViewId(i) == viewId) {
+				bitstream = fopen(handler->encoder->getBitstreamFilename(i).c_str(), "wb");
+			}
+		}
+		if(bitstream == NULL) {
+			return;
+		}
+	}
 
-	return NULL;
+	fwrite(startCode, 1, 4, bitstream);
+	fwrite(nal, 1, size, bitstream);
 }
 
 void VideoHandler::useCali(bool b) {
@@ -21,12 +21,23 @@
 #include <omp.h>
 
 #include "VideoThread.h"
+#include "SFML/Thread.hpp"
 #include "JMVC/H264Extension/src/test/H264AVCEncoderLibTest/H264AVCEncoderLibTest.h"
 #include "JMVC/H264Extension/src/test/H264AVCEncoderLibTest/H264AVCEncoderTest.h"
+#include "JMVC/H264Extension/src/test/H264AVCEncoderLibTest/H264AVCMultiviewEncoderTest.h"
 #include "H264AVCCommonLib/CommonBuffers.h"
 //-------------------------------------------------------------------
 
 
+//-------------------------------------------------------------------
+// Global constants
+//-------------------------------------------------------------------
+// Number of frames that can wait for the encoder thread,
+// a frame captured while they are all waiting is dropped
+#define ENCODER_QUEUE_SIZE	4
+//-------------------------------------------------------------------
+
+
 class VideoHandler
 {
 	// Public functions
@@ -44,7 +55,8 @@ class VideoHandler
 		void startEncoding();
 		void stopEncoding();
 
-		// Write a frame in a file thanks to a writer
+		// Write a frame in a file thanks to a writer,
+		// or queue it for the encoder thread
 		void saveFrame();
 
 		// Change the VideoThreads' mode
@@ -76,19 +88,63 @@ class VideoHandler
 
 		// True if the handler is encoding
 		bool	encoding;
-};
 
-/**
- *	Encoding thread
- *
- *	As this function is used as a thread,
- *	it is not declared as a function of the class VideoHandler.
- *
- *	To use this function, do :
- *
- *	Thread* t = new Thread((Thread::FuncType)encode);
- *	t->Launch();
- */
-void* encode(void* data);
+		// The encoder session of all the views, alive between startEncoding and stopEncoding
+		H264AVCMultiviewEncoderTest*	encoder;
+
+		// The thread that encodes the queued frames
+		sf::Thread*	encoderThread;
+
+		// The files in which the NAL units are written, indexed by view id
+		vector<FILE*>	bitstreams;
+
+		// The frame buffers: each one holds a planar YUV 4:2:0 frame of every view,
+		// the frame of a view is at the index of its view id times frameSize
+		vector< vector<unsigned char> >	frames;
+		int		frameSize;
+
+		// The buffers that are free, and the ones queued for the encoder thread (in capture order).
+		// They are protected by queueMutex, queueChanged is signaled when a frame is queued
+		// or when the encoding is stopped
+		QQueue<int>		freeFrames;
+		QQueue<int>		queuedFrames;
+		QMutex			queueMutex;
+		QWaitCondition	queueChanged;
+
+		// True once stopEncoding has been called, the encoder thread
+		// then encodes the queued frames and closes the session
+		bool	stopRequested;
+
+		// True if the encoder thread has stopped on an error
+		bool	encodingFailed;
+
+		// The number of frames dropped because the queue was full
+		int		framesDropped;
+
+	// Private functions
+	private:
+		/**
+		 *	NAL unit callback of the encoder session
+		 *
+		 *	Each NAL unit is written with a start code in the
+		 *	bitstream file of its view as soon as it is coded.
+		 *	The views are encoded in parallel, each view only
+		 *	writes in its own file.
+		 */
+		static void writeNalUnit(void* data, unsigned int viewId, const unsigned char* nal, unsigned int size);
+
+		/**
+		 *	Encoder thread
+		 *
+		 *	Encodes the queued frames until the encoding is stopped,
+		 *	then encodes the frames still waiting for their GOP and
+		 *	closes the encoder session. After an error the frames
+		 *	are dropped until the encoding is stopped.
+		 */
+		static void encode(void* data);
+
+		// Close the bitstream files of the views
+		void closeBitstreams();
+};
 
 #endif // VIDEOHANDLER_H